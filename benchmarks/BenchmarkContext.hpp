@@ -0,0 +1,73 @@
+#ifndef VULKAN_RAII_BENCHMARKS_BENCHMARK_CONTEXT_HPP
+#define VULKAN_RAII_BENCHMARKS_BENCHMARK_CONTEXT_HPP
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "core/instance.hpp"
+#include "core/PhysicalDevice.hpp"
+#include "core/Device.hpp"
+#include "core/Queue.hpp"
+#include "resources/VmaAllocator.hpp"
+#include "rendering/CommandPool.hpp"
+
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+
+namespace VulkanEngine::RAII::Benchmarks {
+
+// Headless device shared by every benchmark of the process (no surface, no validation
+// layers, so the numbers are the wrapper and driver cost only)
+struct BenchmarkContext {
+    Instance instance;
+    PhysicalDevice physicalDevice;
+    Device device;
+    VmaAllocator allocator;
+    uint32_t queueFamily;
+    Queue queue;
+    CommandPool commandPool;
+
+    BenchmarkContext()
+        : instance("VulkanRAIIWrapperBenchmarks"),
+        physicalDevice(instance),
+        device(physicalDevice),
+        allocator(instance, physicalDevice, device),
+        queueFamily(device.GetQueueFamilyIndices().graphicsFamily_.value()),
+        queue(device.GetGraphicsQueue(), queueFamily, QueueType::GRAPHICS, device.SupportsSynchronization2(), &device.GetDispatch()),
+        commandPool(device, queueFamily)
+    {
+    }
+};
+
+// Created on first use; null with the reason in error when no Vulkan device is usable
+inline BenchmarkContext* GetContext(std::string* error = nullptr)
+{
+    static std::optional<std::string> failure;
+    static std::unique_ptr<BenchmarkContext> context = []() -> std::unique_ptr<BenchmarkContext> {
+        try {
+            return std::make_unique<BenchmarkContext>();
+        } catch (const std::exception& e) {
+            failure = e.what();
+            return nullptr;
+        }
+    }();
+    if (error && failure) {
+        *error = *failure;
+    }
+    return context.get();
+}
+
+} // namespace VulkanEngine::RAII::Benchmarks
+
+// Fetch the shared context or skip the test case when there is no Vulkan device
+#define VULKAN_RAII_BENCHMARK_CONTEXT(name) \
+    std::string name##_error; \
+    ::VulkanEngine::RAII::Benchmarks::BenchmarkContext* name##_ptr = ::VulkanEngine::RAII::Benchmarks::GetContext(&name##_error); \
+    if (!name##_ptr) { \
+        SKIP("No usable Vulkan device: " << name##_error); \
+    } \
+    ::VulkanEngine::RAII::Benchmarks::BenchmarkContext& name = *name##_ptr
+
+#endif // VULKAN_RAII_BENCHMARKS_BENCHMARK_CONTEXT_HPP
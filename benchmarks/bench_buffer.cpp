@@ -0,0 +1,53 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "BenchmarkContext.hpp"
+#include "resources/Buffer.hpp"
+#include <utility>
+
+using namespace VulkanEngine::RAII;
+
+namespace {
+constexpr VkDeviceSize BUFFER_SIZE = 64 * 1024;
+constexpr VkBufferUsageFlags BUFFER_USAGE = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+} // namespace
+
+TEST_CASE("Buffer construction and destruction", "[benchmark][buffer]") {
+    VULKAN_RAII_BENCHMARK_CONTEXT(context);
+
+    BENCHMARK("VMA device local") {
+        const Buffer buffer(context.allocator, BUFFER_SIZE, BUFFER_USAGE, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+        return buffer.GetHandle();
+    };
+
+    BENCHMARK("VMA host visible, persistently mapped") {
+        const Buffer buffer(context.allocator, BUFFER_SIZE, BUFFER_USAGE, VMA_MEMORY_USAGE_AUTO,
+                            VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+        return buffer.GetHandle();
+    };
+
+    BENCHMARK("Raw vkAllocateMemory device local") {
+        const Buffer buffer(context.device, BUFFER_SIZE, BUFFER_USAGE, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        return buffer.GetHandle();
+    };
+
+    BENCHMARK("VMA device local, named") {
+        const Buffer buffer(context.allocator, BUFFER_SIZE, BUFFER_USAGE, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, 0, "Benchmark buffer");
+        return buffer.GetHandle();
+    };
+}
+
+TEST_CASE("Buffer move", "[benchmark][buffer]") {
+    VULKAN_RAII_BENCHMARK_CONTEXT(context);
+
+    Buffer buffer(context.allocator, BUFFER_SIZE, BUFFER_USAGE, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+    const VkBuffer handle = buffer.GetHandle();
+
+    // A move construction and a move assignment back, the cost containers pay on growth
+    BENCHMARK("Move construct and assign back") {
+        Buffer moved(std::move(buffer));
+        buffer = std::move(moved);
+        return buffer.GetHandle();
+    };
+
+    REQUIRE(buffer.GetHandle() == handle);
+}
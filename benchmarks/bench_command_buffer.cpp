@@ -0,0 +1,71 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "BenchmarkContext.hpp"
+#include "rendering/CommandBuffer.hpp"
+#include "resources/Buffer.hpp"
+#include <array>
+
+using namespace VulkanEngine::RAII;
+
+namespace {
+constexpr uint32_t DRAW_COUNT = 1000;
+} // namespace
+
+// Recording cost only: the streams are never submitted, so no render pass or pipeline
+// is bound (drivers record them without validation)
+TEST_CASE("CommandBuffer draw stream recording", "[benchmark][command_buffer]") {
+    VULKAN_RAII_BENCHMARK_CONTEXT(context);
+
+    const Buffer vertex_buffer(context.allocator, 64 * 1024, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                               VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+    const std::array<VkBuffer, 1> buffers{vertex_buffer.GetHandle()};
+    const std::array<VkDeviceSize, 1> offsets{0};
+    CommandBuffer command_buffer(context.commandPool);
+
+    BENCHMARK("1000 bind + draw through CommandBuffer") {
+        command_buffer.Reset();
+        command_buffer.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+        for (uint32_t i = 0; i < DRAW_COUNT; ++i) {
+            command_buffer.BindVertexBuffers(0, buffers, offsets);
+            command_buffer.Draw(3, 1, i * 3, 0);
+        }
+        command_buffer.End();
+        return command_buffer.GetHandle();
+    };
+
+    BENCHMARK("1000 bind + indexed draw through CommandBuffer") {
+        command_buffer.Reset();
+        command_buffer.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+        command_buffer.BindIndexBuffer(vertex_buffer.GetHandle(), 0, VK_INDEX_TYPE_UINT32);
+        for (uint32_t i = 0; i < DRAW_COUNT; ++i) {
+            command_buffer.BindVertexBuffers(0, buffers, offsets);
+            command_buffer.DrawIndexed(3, 1, i * 3, 0, 0);
+        }
+        command_buffer.End();
+        return command_buffer.GetHandle();
+    };
+
+    // Baseline for the wrapper overhead
+    BENCHMARK("1000 bind + draw through raw vkCmd*") {
+        const VkCommandBuffer handle = command_buffer.GetHandle();
+        vkResetCommandBuffer(handle, 0);
+        VkCommandBufferBeginInfo begin_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+        begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(handle, &begin_info);
+        for (uint32_t i = 0; i < DRAW_COUNT; ++i) {
+            vkCmdBindVertexBuffers(handle, 0, 1, buffers.data(), offsets.data());
+            vkCmdDraw(handle, 3, 1, i * 3, 0);
+        }
+        vkEndCommandBuffer(handle);
+        return handle;
+    };
+}
+
+TEST_CASE("CommandBuffer allocation", "[benchmark][command_buffer]") {
+    VULKAN_RAII_BENCHMARK_CONTEXT(context);
+
+    BENCHMARK("Allocate and free a primary command buffer") {
+        const CommandBuffer command_buffer(context.commandPool);
+        return command_buffer.GetHandle();
+    };
+}
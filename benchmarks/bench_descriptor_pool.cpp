@@ -0,0 +1,58 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "BenchmarkContext.hpp"
+#include "resources/Buffer.hpp"
+#include "resources/DescriptorPool.hpp"
+#include "resources/DescriptorSetLayout.hpp"
+#include <array>
+#include <vector>
+
+using namespace VulkanEngine::RAII;
+
+namespace {
+constexpr uint32_t SET_COUNT = 64;
+} // namespace
+
+TEST_CASE("DescriptorPool allocate and update", "[benchmark][descriptor_pool]") {
+    VULKAN_RAII_BENCHMARK_CONTEXT(context);
+
+    const DescriptorSetLayout layout(context.device,
+                                     std::vector<DescriptorSetLayoutBinding>{{0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_ALL}});
+    DescriptorPool pool(context.device, SET_COUNT, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, SET_COUNT);
+    const Buffer uniform_buffer(context.allocator, 256 * SET_COUNT, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+
+    std::array<VkDescriptorSetLayout, SET_COUNT> layouts{};
+    layouts.fill(layout.GetHandle());
+    std::array<VkDescriptorSet, SET_COUNT> sets{};
+    std::array<VkDescriptorBufferInfo, SET_COUNT> buffer_infos{};
+    std::array<VkWriteDescriptorSet, SET_COUNT> writes{};
+
+    BENCHMARK("Allocate 64 sets and reset") {
+        pool.AllocateDescriptorSets(layouts, sets);
+        pool.Reset();
+        return sets[0];
+    };
+
+    BENCHMARK("Allocate 64 sets one by one and reset") {
+        for (VkDescriptorSet& set : sets) {
+            set = pool.AllocateDescriptorSet(layout.GetHandle());
+        }
+        pool.Reset();
+        return sets[0];
+    };
+
+    pool.AllocateDescriptorSets(layouts, sets);
+    for (uint32_t i = 0; i < SET_COUNT; ++i) {
+        buffer_infos[i] = {uniform_buffer.GetHandle(), 256 * static_cast<VkDeviceSize>(i), 256};
+        writes[i] = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+        writes[i].dstSet = sets[i];
+        writes[i].descriptorCount = 1;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        writes[i].pBufferInfo = &buffer_infos[i];
+    }
+
+    BENCHMARK("Update 64 sets in one call") {
+        pool.UpdateDescriptorSets(writes);
+        return sets[0];
+    };
+}
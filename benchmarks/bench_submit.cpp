@@ -0,0 +1,52 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "BenchmarkContext.hpp"
+#include "rendering/CommandBuffer.hpp"
+#include "sync/Fence.hpp"
+#include <span>
+
+using namespace VulkanEngine::RAII;
+
+TEST_CASE("Queue submit and fence round trip", "[benchmark][queue][fence]") {
+    VULKAN_RAII_BENCHMARK_CONTEXT(context);
+
+    CommandBuffer command_buffer(context.commandPool);
+    command_buffer.Begin();
+    command_buffer.End();
+    const Fence fence(context.device);
+
+    // Submission plus the wait for an empty command buffer: the floor of a synchronous upload
+    BENCHMARK("Submit empty command buffer, wait and reset fence") {
+        const VkResult result = context.queue.Submit(command_buffer.GetHandle(), VK_NULL_HANDLE,
+                                                     VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_NULL_HANDLE, fence.GetHandle());
+        (void)fence.Wait();
+        (void)fence.Reset();
+        return result;
+    };
+
+    BENCHMARK("Submit without command buffers, wait and reset fence") {
+        const VkResult result = context.queue.Submit(std::span<const VkCommandBuffer>{}, {}, {}, {}, fence.GetHandle());
+        (void)fence.Wait();
+        (void)fence.Reset();
+        return result;
+    };
+}
+
+TEST_CASE("Fence wait and reset", "[benchmark][fence]") {
+    VULKAN_RAII_BENCHMARK_CONTEXT(context);
+
+    const Fence fence(context.device, VK_FENCE_CREATE_SIGNALED_BIT);
+
+    BENCHMARK("Wait on a signaled fence") {
+        return fence.Wait();
+    };
+
+    BENCHMARK("Fence status query") {
+        return fence.GetStatus();
+    };
+
+    BENCHMARK("Create and destroy a fence") {
+        const Fence temporary(context.device);
+        return temporary.GetHandle();
+    };
+}
@@ -0,0 +1,401 @@
+// GPU throughput report: host->device upload bandwidth per host-visible memory type,
+// device->device copy throughput per queue, submit-to-signal latency and empty
+// dispatch cost. The report goes to stdout as JSON (default) or CSV, progress to stderr.
+//
+//   VulkanRAIIWrapperGpuBenchmark [--format json|csv] [--size-mb N] [--iterations N]
+#include "core/instance.hpp"
+#include "core/PhysicalDevice.hpp"
+#include "core/Device.hpp"
+#include "core/Queue.hpp"
+#include "rendering/CommandBuffer.hpp"
+#include "rendering/CommandPool.hpp"
+#include "rendering/Pipeline.hpp"
+#include "rendering/QueryPool.hpp"
+#include "resources/Buffer.hpp"
+#include "resources/PipelineLayout.hpp"
+#include "resources/Shader.hpp"
+#include "resources/VmaAllocator.hpp"
+#include "sync/Fence.hpp"
+#include "utils/DebugUtils.hpp"
+#include "utils/MemoryUtils.hpp"
+#include "utils/Timer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace VulkanEngine::RAII;
+
+namespace {
+
+constexpr uint32_t LATENCY_SAMPLES = 200;
+constexpr uint32_t DISPATCH_COUNT = 1000;
+constexpr double BYTES_PER_GB = 1'000'000'000.0;
+
+// void main() {} with local_size 1x1x1
+constexpr std::array<uint32_t, 35> EMPTY_COMPUTE_SPIRV{
+    0x07230203, 0x00010000, 0x00000000, 0x00000006, 0x00000000,
+    0x00020011, 0x00000001, // OpCapability Shader
+    0x0003000e, 0x00000000, 0x00000001, // OpMemoryModel Logical GLSL450
+    0x0005000f, 0x00000005, 0x00000004, 0x6e69616d, 0x00000000, // OpEntryPoint GLCompute %4 "main"
+    0x00060010, 0x00000004, 0x00000011, 0x00000001, 0x00000001, 0x00000001, // OpExecutionMode %4 LocalSize 1 1 1
+    0x00020013, 0x00000002, // %2 = OpTypeVoid
+    0x00030021, 0x00000003, 0x00000002, // %3 = OpTypeFunction %2
+    0x00050036, 0x00000002, 0x00000004, 0x00000000, 0x00000003, // %4 = OpFunction %2 None %3
+    0x000200f8, 0x00000005, // %5 = OpLabel
+    0x000100fd, // OpReturn
+    0x00010038 // OpFunctionEnd
+};
+
+struct Options {
+    bool csv{false};
+    VkDeviceSize sizeBytes{64ULL * 1024 * 1024};
+    uint32_t iterations{8};
+};
+
+struct Result {
+    std::string benchmark;
+    std::string target;
+    double value;
+    std::string unit;
+};
+
+struct QueueTarget {
+    const char* name;
+    QueueType type;
+    uint32_t family;
+    VkQueue queue;
+    uint32_t timestampValidBits;
+    bool supportsCompute;
+};
+
+// Buffer bound to memory of an explicit type, which the Buffer constructors do not select
+struct RawBuffer {
+    VkDevice device{VK_NULL_HANDLE};
+    VkBuffer buffer{VK_NULL_HANDLE};
+    VkDeviceMemory memory{VK_NULL_HANDLE};
+    void* mapped{nullptr};
+
+    RawBuffer() = default;
+    RawBuffer(const RawBuffer&) = delete;
+    RawBuffer& operator=(const RawBuffer&) = delete;
+    RawBuffer(RawBuffer&&) = delete;
+    RawBuffer& operator=(RawBuffer&&) = delete;
+
+    ~RawBuffer()
+    {
+        if (mapped) {
+            vkUnmapMemory(device, memory);
+        }
+        if (buffer != VK_NULL_HANDLE) {
+            vkDestroyBuffer(device, buffer, nullptr);
+        }
+        if (memory != VK_NULL_HANDLE) {
+            vkFreeMemory(device, memory, nullptr);
+        }
+    }
+};
+
+std::optional<Options> ParseOptions(int argc, char** argv)
+{
+    Options options{};
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--format" && has_value) {
+            const std::string_view format = argv[++i];
+            if (format != "json" && format != "csv") {
+                return std::nullopt;
+            }
+            options.csv = format == "csv";
+        } else if (arg == "--size-mb" && has_value) {
+            options.sizeBytes = std::max<VkDeviceSize>(1, std::stoull(argv[++i])) * 1024 * 1024;
+        } else if (arg == "--iterations" && has_value) {
+            options.iterations = std::max(1U, static_cast<uint32_t>(std::stoul(argv[++i])));
+        } else {
+            return std::nullopt;
+        }
+    }
+    return options;
+}
+
+std::string JsonEscape(std::string_view text)
+{
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped.push_back('\\');
+        }
+        escaped.push_back(static_cast<unsigned char>(c) < 0x20 ? ' ' : c);
+    }
+    return escaped;
+}
+
+std::vector<QueueTarget> GetQueueTargets(const PhysicalDevice& physical_device, const Device& device)
+{
+    const QueueFamilyIndices& indices = device.GetQueueFamilyIndices();
+    const std::vector<VkQueueFamilyProperties> families = physical_device.GetQueueFamilyProperties();
+    auto make_target = [&](const char* name, QueueType type, uint32_t family, VkQueue queue) {
+        return QueueTarget{name, type, family, queue, families[family].timestampValidBits,
+                           (families[family].queueFlags & VK_QUEUE_COMPUTE_BIT) != 0};
+    };
+    return {
+        make_target("graphics", QueueType::GRAPHICS, indices.graphicsFamily_.value(), device.GetGraphicsQueue()),
+        make_target("compute", QueueType::COMPUTE, indices.computeFamily_.value(), device.GetComputeQueue()),
+        make_target("transfer", QueueType::TRANSFER, indices.transferFamily_.value(), device.GetTransferQueue())
+    };
+}
+
+// Record through record between two timestamps, submit, wait and return the GPU time
+// in milliseconds (the CPU round trip when the family has no timestamps)
+double RunTimed(const Device& device, const QueueTarget& target, float timestamp_period,
+                const std::function<void(const CommandBuffer&)>& record)
+{
+    const CommandPool pool(device, target.family, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+    const CommandBuffer command_buffer(pool);
+    const Fence fence(device);
+    const Queue queue(target.queue, target.family, target.type);
+    std::optional<QueryPool> queries;
+    if (target.timestampValidBits > 0) {
+        queries.emplace(device, VK_QUERY_TYPE_TIMESTAMP, 2);
+    }
+
+    command_buffer.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    if (queries) {
+        command_buffer.ResetQueryPool(*queries, 0, 2);
+        command_buffer.WriteTimestamp(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, *queries, 0);
+    }
+    record(command_buffer);
+    if (queries) {
+        command_buffer.WriteTimestamp(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, *queries, 1);
+    }
+    command_buffer.End();
+
+    const uint64_t start_ns = Utils::Timer::NowNanoseconds();
+    Utils::ErrorUtils::CheckResult(queue.Submit(command_buffer.GetHandle(), VK_NULL_HANDLE, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                                VK_NULL_HANDLE, fence.GetHandle()),
+                                   "benchmark submit");
+    Utils::ErrorUtils::CheckResult(fence.Wait(), "benchmark fence wait");
+    const uint64_t cpu_ns = Utils::Timer::NowNanoseconds() - start_ns;
+    if (!queries) {
+        return static_cast<double>(cpu_ns) / 1'000'000.0;
+    }
+
+    std::array<uint64_t, 2> timestamps{};
+    Utils::ErrorUtils::CheckResult(queries->GetResults(0, 2, timestamps, VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT),
+                                   "benchmark timestamp readback");
+    const uint64_t mask = target.timestampValidBits >= 64 ? ~0ULL : (1ULL << target.timestampValidBits) - 1;
+    const uint64_t ticks = (timestamps[1] - timestamps[0]) & mask;
+    return static_cast<double>(ticks) * timestamp_period / 1'000'000.0;
+}
+
+void MeasureUploads(const PhysicalDevice& physical_device, const Device& device, const VmaAllocator& allocator,
+                    const QueueTarget& transfer, float timestamp_period, const Options& options,
+                    std::vector<Result>& results)
+{
+    const VkPhysicalDeviceMemoryProperties& memory = physical_device.GetMemoryProperties();
+    const Buffer destination(allocator, options.sizeBytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+    const std::vector<uint8_t> source(options.sizeBytes, 0xA5);
+
+    for (uint32_t type = 0; type < memory.memoryTypeCount; ++type) {
+        if (!Utils::MemoryUtils::IsMemoryTypeHostVisible(physical_device.GetMemoryTypeTable(), type)) {
+            continue;
+        }
+        const VkDeviceSize heap_size = memory.memoryHeaps[memory.memoryTypes[type].heapIndex].size;
+        if (heap_size < options.sizeBytes * 2) {
+            std::cerr << "Skipping memory type " << type << ": heap too small\n";
+            continue;
+        }
+
+        RawBuffer staging;
+        staging.device = device.GetHandle();
+        VkBufferCreateInfo buffer_info{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+        buffer_info.size = options.sizeBytes;
+        buffer_info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        Utils::ErrorUtils::CheckResult(vkCreateBuffer(staging.device, &buffer_info, nullptr, &staging.buffer), "staging buffer creation");
+        VkMemoryRequirements requirements{};
+        vkGetBufferMemoryRequirements(staging.device, staging.buffer, &requirements);
+        if ((requirements.memoryTypeBits & (1U << type)) == 0) {
+            continue;
+        }
+        VkMemoryAllocateInfo allocate_info{VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+        allocate_info.allocationSize = requirements.size;
+        allocate_info.memoryTypeIndex = type;
+        if (vkAllocateMemory(staging.device, &allocate_info, nullptr, &staging.memory) != VK_SUCCESS) {
+            std::cerr << "Skipping memory type " << type << ": allocation failed\n";
+            continue;
+        }
+        Utils::ErrorUtils::CheckResult(vkBindBufferMemory(staging.device, staging.buffer, staging.memory, 0), "staging bind");
+        Utils::ErrorUtils::CheckResult(vkMapMemory(staging.device, staging.memory, 0, VK_WHOLE_SIZE, 0, &staging.mapped), "staging map");
+
+        const std::string target = "memory type " + std::to_string(type) + " (" +
+                                   Utils::StringUtils::MemoryPropertyFlagsToString(Utils::MemoryUtils::GetMemoryTypeProperties(physical_device.GetMemoryTypeTable(), type)) + ")";
+        const bool coherent = Utils::MemoryUtils::IsMemoryTypeHostCoherent(physical_device.GetMemoryTypeTable(), type);
+        std::cerr << "Upload: " << target << '\n';
+
+        // Host writes into the mapping, including the flush non-coherent memory needs
+        const uint64_t start_ns = Utils::Timer::NowNanoseconds();
+        for (uint32_t i = 0; i < options.iterations; ++i) {
+            std::memcpy(staging.mapped, source.data(), source.size());
+            if (!coherent) {
+                VkMappedMemoryRange range{VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE};
+                range.memory = staging.memory;
+                range.size = VK_WHOLE_SIZE;
+                vkFlushMappedMemoryRanges(staging.device, 1, &range);
+            }
+        }
+        const double host_seconds = static_cast<double>(Utils::Timer::NowNanoseconds() - start_ns) / 1'000'000'000.0;
+        const double bytes = static_cast<double>(options.sizeBytes) * options.iterations;
+        results.push_back({"host_write", target, bytes / BYTES_PER_GB / host_seconds, "GB/s"});
+
+        // GPU reads of the staging memory into device local memory on the transfer queue
+        const VkBufferCopy region{0, 0, options.sizeBytes};
+        const double gpu_ms = RunTimed(device, transfer, timestamp_period, [&](const CommandBuffer& command_buffer) {
+            for (uint32_t i = 0; i < options.iterations; ++i) {
+                command_buffer.CopyBuffer(staging.buffer, destination.GetHandle(), std::span<const VkBufferCopy>(&region, 1));
+            }
+        });
+        results.push_back({"upload_copy", target, bytes / BYTES_PER_GB / (gpu_ms / 1000.0), "GB/s"});
+    }
+}
+
+void MeasureCopies(const Device& device, const VmaAllocator& allocator, const std::vector<QueueTarget>& queues,
+                   float timestamp_period, const Options& options, std::vector<Result>& results)
+{
+    // Exclusive buffers used from several families without ownership transfers: the
+    // contents are undefined afterwards, which the benchmark does not care about
+    constexpr VkBufferUsageFlags USAGE = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    const Buffer source(allocator, options.sizeBytes, USAGE, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+    const Buffer destination(allocator, options.sizeBytes, USAGE, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+    const VkBufferCopy region{0, 0, options.sizeBytes};
+
+    for (const QueueTarget& queue : queues) {
+        std::cerr << "Device copy: " << queue.name << " queue\n";
+        const double gpu_ms = RunTimed(device, queue, timestamp_period, [&](const CommandBuffer& command_buffer) {
+            for (uint32_t i = 0; i < options.iterations; ++i) {
+                command_buffer.CopyBuffer(source.GetHandle(), destination.GetHandle(), std::span<const VkBufferCopy>(&region, 1));
+            }
+        });
+        const double bytes = static_cast<double>(options.sizeBytes) * options.iterations;
+        results.push_back({"device_copy", queue.name, bytes / BYTES_PER_GB / (gpu_ms / 1000.0), "GB/s"});
+    }
+}
+
+void MeasureSubmitLatency(const Device& device, const std::vector<QueueTarget>& queues, std::vector<Result>& results)
+{
+    for (const QueueTarget& target : queues) {
+        std::cerr << "Submit latency: " << target.name << " queue\n";
+        const CommandPool pool(device, target.family);
+        CommandBuffer command_buffer(pool);
+        command_buffer.Begin();
+        command_buffer.End();
+        const Fence fence(device);
+        const Queue queue(target.queue, target.family, target.type);
+
+        std::vector<double> samples_us;
+        samples_us.reserve(LATENCY_SAMPLES);
+        for (uint32_t i = 0; i < LATENCY_SAMPLES; ++i) {
+            const uint64_t start_ns = Utils::Timer::NowNanoseconds();
+            Utils::ErrorUtils::CheckResult(queue.Submit(command_buffer.GetHandle(), VK_NULL_HANDLE, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                                        VK_NULL_HANDLE, fence.GetHandle()),
+                                           "latency submit");
+            Utils::ErrorUtils::CheckResult(fence.Wait(), "latency fence wait");
+            samples_us.push_back(static_cast<double>(Utils::Timer::NowNanoseconds() - start_ns) / 1000.0);
+            Utils::ErrorUtils::CheckResult(fence.Reset(), "latency fence reset");
+        }
+        std::sort(samples_us.begin(), samples_us.end());
+        results.push_back({"submit_to_signal_p50", target.name, samples_us[samples_us.size() / 2], "us"});
+        results.push_back({"submit_to_signal_p95", target.name, samples_us[(samples_us.size() * 95) / 100], "us"});
+    }
+}
+
+void MeasureDispatch(const Device& device, const std::vector<QueueTarget>& queues, float timestamp_period,
+                     std::vector<Result>& results)
+{
+    const Shader shader(device, EMPTY_COMPUTE_SPIRV.data(), EMPTY_COMPUTE_SPIRV.size(), false);
+    const PipelineLayout layout(device);
+    const Pipeline pipeline(device, layout.GetHandle(), PipelineShaderStage{VK_SHADER_STAGE_COMPUTE_BIT, shader.GetHandle()});
+
+    for (const QueueTarget& queue : queues) {
+        if (!queue.supportsCompute) {
+            continue;
+        }
+        std::cerr << "Empty dispatch: " << queue.name << " queue\n";
+        const double gpu_ms = RunTimed(device, queue, timestamp_period, [&](const CommandBuffer& command_buffer) {
+            command_buffer.BindPipeline(VK_PIPELINE_BIND_POINT_COMPUTE, pipeline.GetHandle());
+            for (uint32_t i = 0; i < DISPATCH_COUNT; ++i) {
+                command_buffer.Dispatch(1, 1, 1);
+            }
+        });
+        results.push_back({"empty_dispatch", queue.name, gpu_ms * 1'000'000.0 / DISPATCH_COUNT, "ns"});
+    }
+}
+
+void WriteReport(const VkPhysicalDeviceProperties& properties, const std::vector<Result>& results, bool csv)
+{
+    if (csv) {
+        std::cout << "benchmark,target,value,unit\n";
+        for (const Result& result : results) {
+            std::cout << result.benchmark << ",\"" << result.target << "\"," << result.value << ',' << result.unit << '\n';
+        }
+        return;
+    }
+    std::cout << "{\n"
+              << "  \"device\": \"" << JsonEscape(properties.deviceName) << "\",\n"
+              << "  \"vendorId\": " << properties.vendorID << ",\n"
+              << "  \"deviceId\": " << properties.deviceID << ",\n"
+              << "  \"driverVersion\": " << properties.driverVersion << ",\n"
+              << "  \"apiVersion\": \"" << VK_API_VERSION_MAJOR(properties.apiVersion) << '.'
+              << VK_API_VERSION_MINOR(properties.apiVersion) << '.' << VK_API_VERSION_PATCH(properties.apiVersion) << "\",\n"
+              << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        std::cout << "    {\"benchmark\": \"" << result.benchmark << "\", \"target\": \"" << JsonEscape(result.target)
+                  << "\", \"value\": " << result.value << ", \"unit\": \"" << result.unit << "\"}"
+                  << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    std::cout << "  ]\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const std::optional<Options> options = ParseOptions(argc, argv);
+    if (!options) {
+        std::cerr << "Usage: " << argv[0] << " [--format json|csv] [--size-mb N] [--iterations N]\n";
+        return 2;
+    }
+
+    try {
+        const Instance instance("VulkanRAIIWrapperGpuBenchmark");
+        const PhysicalDevice physical_device(instance);
+        const Device device(physical_device);
+        const VmaAllocator allocator(instance, physical_device, device);
+        const VkPhysicalDeviceProperties properties = physical_device.GetProperties();
+        const std::vector<QueueTarget> queues = GetQueueTargets(physical_device, device);
+        std::cerr << "Device: " << properties.deviceName << '\n';
+
+        std::vector<Result> results;
+        MeasureUploads(physical_device, device, allocator, queues[2], properties.limits.timestampPeriod, *options, results);
+        MeasureCopies(device, allocator, queues, properties.limits.timestampPeriod, *options, results);
+        MeasureSubmitLatency(device, queues, results);
+        MeasureDispatch(device, queues, properties.limits.timestampPeriod, results);
+        WriteReport(properties, results, options->csv);
+    } catch (const std::exception& e) {
+        std::cerr << "GPU benchmark failed: " << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
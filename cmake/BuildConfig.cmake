@@ -35,3 +35,11 @@ elseif(CMAKE_CXX_COMPILER_ID MATCHES "MSVC")
     set(CMAKE_CXX_FLAGS_RELWITHDEBINFO "/MD /O2 /Zi /DNDEBUG")
     set(CMAKE_CXX_FLAGS_MINSIZEREL "/MD /O1 /DNDEBUG")
 endif()
+
+# Optional Tracy instrumentation of the RAII layer (CPU zones, Vulkan GPU zones, device
+# memory events). Off by default; with it off the instrumentation compiles to nothing
+option(VULKAN_RAII_ENABLE_TRACY "Instrument the RAII wrapper with Tracy profiler zones" OFF)
+
+# Vulkan object names and command buffer labels (VK_EXT_debug_utils) are compiled out of
+# Release and MinSizeRel builds; turn this on to keep them there too (e.g. for captures)
+option(VULKAN_RAII_FORCE_DEBUG_NAMES "Keep debug object names and labels in release configurations" OFF)
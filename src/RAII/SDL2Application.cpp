@@ -5,12 +5,16 @@
 #include "core/Device.hpp"
 #include "presentation/Surface.hpp"
 #include "presentation/Swapchain.hpp"
+#include "rendering/GpuProfiler.hpp"
+#include "rendering/PipelineCache.hpp"
 #include "rendering/RenderPass.hpp"
 #include "rendering/Renderer.hpp"
+#include "resources/VmaAllocator.hpp"
 #include "utils/SDLUtils.hpp"
 #include "utils/Constants.hpp"
 #include "utils/Timer.hpp"
 #include "utils/CapabilityUtils.hpp"
+#include "utils/PerfCounters.hpp"
 
 // #include <SDL3/SDL_error.h>
 #include <SDL3/SDL_events.h>
@@ -18,18 +22,26 @@
 #include <SDL3/SDL_video.h>
 #include <SDL3/SDL_error.h>
 #include <SDL3/SDL_hints.h>
+#include <SDL3/SDL_keyboard.h>
 
+#include <array>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
 #include <exception>
+#include <future>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <stdexcept>
 #include <utility>
 #include <vector>
-#include <queue>
 #include <sstream>
 #include <string_view>
 #include <algorithm>
+#include <limits>
 #include <string>
 #include <cstddef> // for std::size_t
 
@@ -90,22 +102,118 @@ uint32_t EnsureWindowFlags(uint32_t flags) {
     return (flags | SDL_WINDOW_VULKAN);
 }
 
+// Fixed set of frame packets passed from the main thread to the render thread in
+// order. Stop wakes both sides; waits then return nullptr
+class FramePacketRing {
+public:
+    explicit FramePacketRing(uint32_t packet_count) : packets_(packet_count) {
+        for (FramePacket& packet : packets_) {
+            free_.push_back(&packet);
+        }
+    }
+
+    FramePacket* AcquireFree() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        freeAvailable_.wait(lock, [this]() { return stopped_ || !free_.empty(); });
+        return stopped_ ? nullptr : Pop(free_);
+    }
+
+    void Publish(FramePacket* packet) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ready_.push_back(packet);
+        }
+        readyAvailable_.notify_one();
+    }
+
+    FramePacket* AcquireReady() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        readyAvailable_.wait(lock, [this]() { return stopped_ || !ready_.empty(); });
+        return stopped_ ? nullptr : Pop(ready_);
+    }
+
+    void Release(FramePacket* packet) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            free_.push_back(packet);
+        }
+        freeAvailable_.notify_one();
+    }
+
+    // The first error is kept for the main thread to rethrow
+    void Stop(std::exception_ptr error = nullptr) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped_ = true;
+            if (error && !error_) {
+                error_ = error;
+            }
+        }
+        freeAvailable_.notify_all();
+        readyAvailable_.notify_all();
+    }
+
+    [[nodiscard]] std::exception_ptr GetError() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return error_;
+    }
+
+private:
+    static FramePacket* Pop(std::deque<FramePacket*>& packets) {
+        FramePacket* packet = packets.front();
+        packets.pop_front();
+        return packet;
+    }
+
+    std::vector<FramePacket> packets_;
+    std::deque<FramePacket*> free_;
+    std::deque<FramePacket*> ready_; // Oldest first
+    std::mutex mutex_;
+    std::condition_variable freeAvailable_;
+    std::condition_variable readyAvailable_;
+    bool stopped_{false};
+    std::exception_ptr error_;
+};
+
 } // namespace
 
 SDLApplication::SDLApplication(SDLApplicationConfig config)
-    : config_(std::move(config)) {}
+    : config_(std::move(config)),
+      frameTimeStats_(config_.frame_time_sample_count),
+      cpuTimeStats_(config_.frame_time_sample_count),
+      gpuTimeStats_(config_.frame_time_sample_count),
+      fenceWaitStats_(config_.frame_time_sample_count),
+      acquireWaitStats_(config_.frame_time_sample_count) {}
 
 SDLApplication::~SDLApplication() {
     ShutdownInternal(false);
 }
 
+// The background worker records into other; it has to finish before its members move,
+// so the first member's initializer waits for it
 SDLApplication::SDLApplication(SDLApplication&& other) noexcept
-    : config_(std::move(other.config_)),
+    : config_(std::move(FinishedBackgroundInit(other).config_)),
       initialized_(other.initialized_),
-      running_(other.running_),
+      running_(other.running_.load()),
       lastTime_(other.lastTime_),
       deltaTime_(other.deltaTime_),
       frameCount_(other.frameCount_),
+      nextFrameDeadline_(other.nextFrameDeadline_),
+      frameTimeStats_(std::move(other.frameTimeStats_)),
+      cpuTimeStats_(std::move(other.cpuTimeStats_)),
+      gpuTimeStats_(std::move(other.gpuTimeStats_)),
+      fenceWaitStats_(std::move(other.fenceWaitStats_)),
+      acquireWaitStats_(std::move(other.acquireWaitStats_)),
+      gpuResolvedFrames_(other.gpuResolvedFrames_),
+      perfCapture_(std::move(other.perfCapture_)),
+      perfCaptureAllocator_(other.perfCaptureAllocator_),
+      startupTimer_(other.startupTimer_),
+      startupPhases_(std::move(other.startupPhases_)),
+      initializeMs_(other.initializeMs_),
+      firstFrameMs_(other.firstFrameMs_.load()),
+      backgroundInitMs_(other.backgroundInitMs_.load()),
+      backgroundInitComplete_(other.backgroundInitComplete_.load()),
+      loaderCapabilities_(std::move(other.loaderCapabilities_)),
       sdlContext_(std::move(other.sdlContext_)),
       window_(std::move(other.window_)),
       instance_(std::move(other.instance_)),
@@ -114,24 +222,45 @@ SDLApplication::SDLApplication(SDLApplication&& other) noexcept
       surface_(std::move(other.surface_)),
       swapchain_(std::move(other.swapchain_)),
       renderPass_(std::move(other.renderPass_)),
-      renderer_(std::move(other.renderer_)) {
+      renderer_(std::move(other.renderer_)),
+      pipelineCache_(std::move(other.pipelineCache_)),
+      latencyTracker_(std::move(other.latencyTracker_)) {
     other.initialized_ = false;
     other.running_ = false;
     other.lastTime_ = 0;
     other.deltaTime_ = 0.0;
     other.frameCount_ = 0;
+    other.nextFrameDeadline_ = 0;
 }
 
 SDLApplication& SDLApplication::operator=(SDLApplication&& other) noexcept {
     if (this != &other) {
         Shutdown();
+        other.WaitForBackgroundInit();
 
         config_ = std::move(other.config_);
         initialized_ = other.initialized_;
-        running_ = other.running_;
+        running_ = other.running_.load();
         lastTime_ = other.lastTime_;
         deltaTime_ = other.deltaTime_;
         frameCount_ = other.frameCount_;
+        nextFrameDeadline_ = other.nextFrameDeadline_;
+        frameTimeStats_ = std::move(other.frameTimeStats_);
+        cpuTimeStats_ = std::move(other.cpuTimeStats_);
+        gpuTimeStats_ = std::move(other.gpuTimeStats_);
+        fenceWaitStats_ = std::move(other.fenceWaitStats_);
+        acquireWaitStats_ = std::move(other.acquireWaitStats_);
+        gpuResolvedFrames_ = other.gpuResolvedFrames_;
+        perfCapture_ = std::move(other.perfCapture_);
+        perfCaptureAllocator_ = other.perfCaptureAllocator_;
+
+        startupTimer_ = other.startupTimer_;
+        startupPhases_ = std::move(other.startupPhases_);
+        initializeMs_ = other.initializeMs_;
+        firstFrameMs_ = other.firstFrameMs_.load();
+        backgroundInitMs_ = other.backgroundInitMs_.load();
+        backgroundInitComplete_ = other.backgroundInitComplete_.load();
+        loaderCapabilities_ = std::move(other.loaderCapabilities_);
 
         sdlContext_ = std::move(other.sdlContext_);
         window_ = std::move(other.window_);
@@ -142,6 +271,8 @@ SDLApplication& SDLApplication::operator=(SDLApplication&& other) noexcept {
         swapchain_ = std::move(other.swapchain_);
         renderPass_ = std::move(other.renderPass_);
         renderer_ = std::move(other.renderer_);
+        pipelineCache_ = std::move(other.pipelineCache_);
+        latencyTracker_ = std::move(other.latencyTracker_);
 
         other.initialized_ = false;
         other.running_ = false;
@@ -157,48 +288,46 @@ bool SDLApplication::Initialize() {
         return true;
     }
 
-    try {
-        if (!Utils::SDLUtils::InitializeSdlForVulkan()) {
-            std::cerr << "Failed to initialize SDL for Vulkan" << '\n' << std::flush;
-            return false;
-        }
-
-        std::cout << "linked SDL Version: " << Utils::SDLUtils::GetSdlVersionString(true) << '\n';
-        std::cout << "compiled SDL Version: " << Utils::SDLUtils::GetSdlVersionString(false) << '\n';
+    startupTimer_.Reset();
+    startupTimer_.Start();
+    {
+        std::lock_guard<std::mutex> lock(startupMutex_);
+        startupPhases_.clear();
+        initializeMs_ = 0.0;
+    }
+    firstFrameMs_ = 0.0;
+    backgroundInitMs_ = 0.0;
+    backgroundInitComplete_ = false;
 
-        sdlContext_ = std::make_unique<Utils::SDLContext>(SDL_INIT_VIDEO);
-        if (!sdlContext_ || !sdlContext_->IsValid()) {
-            std::cerr << "Failed to initialize SDL context" << '\n';
-            return false;
+    try {
+        // The loader scans its ICD and layer manifests here, which needs neither SDL nor a window
+        const bool parallel = config_.startup.parallel;
+        loaderCapabilities_ = std::async(parallel ? std::launch::async : std::launch::deferred, [this, parallel] {
+            const double start_ms = startupTimer_.ElapsedMilliseconds();
+            LoaderCapabilities capabilities{Utils::EnumerateInstanceExtensionNames(), Utils::EnumerateInstanceLayerNames()};
+            RecordStartupPhase("LoaderEnumeration", start_ms, parallel);
+            return capabilities;
+        });
+
+        // Headless runs never touch SDL video
+        if (!config_.headless.enabled) {
+            const double start_ms = startupTimer_.ElapsedMilliseconds();
+            if (!InitializeWindow()) {
+                return false;
+            }
+            RecordStartupPhase("Window", start_ms);
         }
 
-        // Ensure Wayland mode scaling behaves as desired; must be set before creating the window.
-        // This is a no-op on non-Wayland platforms.
-        bool result = SDL_SetHint(SDL_HINT_VIDEO_WAYLAND_MODE_SCALING, "none");
-        if(result == false) {
-            std::cerr << "Failed to set SDL hint for Wayland mode scaling" << '\n' << SDL_GetError() << '\n';
-        }
-        else
-        {
-            std::cout << "Successfully set SDL hint for Wayland mode scaling" << '\n' << std::flush;
-        }
-
-        uint32_t flags = EnsureWindowFlags(config_.windowFlags);
-        window_ = std::make_unique<Utils::SDLWindow>(config_.windowTitle.c_str(),
-                                                     config_.windowX,
-                                                     config_.windowY,
-                                                     config_.windowWidth,
-                                                     config_.windowHeight,
-                                                     flags);
-        if (!window_ || !window_->IsValid()) {
-            std::cerr << "Failed to create SDL window" << '\n' << std::flush;
+        if (!CreateVulkanObjects()) {
             return false;
         }
 
-        if (!CreateVulkanObjects()) {
-            return false;
+        latencyTracker_ = std::make_unique<Utils::LatencyTracker>(config_.frame_time_sample_count);
+        if (renderer_) {
+            renderer_->SetLatencyTracker(latencyTracker_.get());
         }
 
+        const double on_initialize_start_ms = startupTimer_.ElapsedMilliseconds();
         if (!OnInitialize()) {
             return false;
         }
@@ -206,6 +335,7 @@ bool SDLApplication::Initialize() {
         if (config_.initCallback) {
             config_.initCallback();
         }
+        RecordStartupPhase("OnInitialize", on_initialize_start_ms);
 
         lastTime_ = Utils::SDLUtils::GetPerformanceCounter();
         deltaTime_ = 0.0;
@@ -213,6 +343,14 @@ bool SDLApplication::Initialize() {
 
         initialized_ = true;
         running_ = true;
+        if (config_.perfCapture.startOnLaunch) {
+            StartPerfCapture();
+        }
+        {
+            std::lock_guard<std::mutex> lock(startupMutex_);
+            initializeMs_ = startupTimer_.ElapsedMilliseconds();
+        }
+        StartBackgroundInit();
 
         std::flush(std::cout);
 
@@ -224,20 +362,136 @@ bool SDLApplication::Initialize() {
     }
 }
 
+SDLApplication::LoaderCapabilities SDLApplication::TakeLoaderCapabilities() {
+    if (loaderCapabilities_.valid()) {
+        return loaderCapabilities_.get();
+    }
+    return {Utils::EnumerateInstanceExtensionNames(), Utils::EnumerateInstanceLayerNames()};
+}
+
+void SDLApplication::StartBackgroundInit() {
+    if (!config_.backgroundInitCallback) {
+        backgroundInitComplete_ = true;
+        return;
+    }
+
+    const bool parallel = config_.startup.parallel;
+    auto task = [this, parallel, callback = config_.backgroundInitCallback] {
+        const double start_ms = startupTimer_.ElapsedMilliseconds();
+        try {
+            callback();
+        } catch (const std::exception& ex) {
+            std::cerr << "SDLApplication background initialization failed: " << ex.what() << '\n' << std::flush;
+            running_ = false;
+        }
+        RecordStartupPhase("BackgroundInit", start_ms, parallel);
+        backgroundInitMs_ = startupTimer_.ElapsedMilliseconds();
+        backgroundInitComplete_ = true;
+    };
+    if (parallel) {
+        backgroundInitThread_ = std::thread(std::move(task));
+    } else {
+        task();
+    }
+}
+
+void SDLApplication::WaitForBackgroundInit() {
+    if (backgroundInitThread_.joinable()) {
+        backgroundInitThread_.join();
+    }
+}
+
+SDLApplication& SDLApplication::FinishedBackgroundInit(SDLApplication& other) {
+    other.WaitForBackgroundInit();
+    return other;
+}
+
+void SDLApplication::RecordStartupPhase(const char* name, double start_ms, bool background) {
+    const double end_ms = startupTimer_.ElapsedMilliseconds();
+    std::lock_guard<std::mutex> lock(startupMutex_);
+    startupPhases_.push_back({name, start_ms, end_ms - start_ms, background});
+}
+
+SDLApplication::StartupReport SDLApplication::GetStartupReport() const {
+    StartupReport report;
+    {
+        std::lock_guard<std::mutex> lock(startupMutex_);
+        report.phases = startupPhases_;
+        report.initializeMs = initializeMs_;
+    }
+    report.firstFrameMs = firstFrameMs_;
+    report.backgroundInitMs = backgroundInitMs_;
+    std::sort(report.phases.begin(), report.phases.end(),
+              [](const StartupPhase& a, const StartupPhase& b) { return a.startMs < b.startMs; });
+    return report;
+}
+
+bool SDLApplication::InitializeWindow() {
+    if (!Utils::SDLUtils::InitializeSdlForVulkan()) {
+        std::cerr << "Failed to initialize SDL for Vulkan" << '\n' << std::flush;
+        return false;
+    }
+
+    std::cout << "linked SDL Version: " << Utils::SDLUtils::GetSdlVersionString(true) << '\n';
+    std::cout << "compiled SDL Version: " << Utils::SDLUtils::GetSdlVersionString(false) << '\n';
+
+    sdlContext_ = std::make_unique<Utils::SDLContext>(SDL_INIT_VIDEO);
+    if (!sdlContext_ || !sdlContext_->IsValid()) {
+        std::cerr << "Failed to initialize SDL context" << '\n';
+        return false;
+    }
+
+    // Ensure Wayland mode scaling behaves as desired; must be set before creating the window.
+    // This is a no-op on non-Wayland platforms.
+    bool result = SDL_SetHint(SDL_HINT_VIDEO_WAYLAND_MODE_SCALING, "none");
+    if(result == false) {
+        std::cerr << "Failed to set SDL hint for Wayland mode scaling" << '\n' << SDL_GetError() << '\n';
+    }
+    else
+    {
+        std::cout << "Successfully set SDL hint for Wayland mode scaling" << '\n' << std::flush;
+    }
+
+    uint32_t flags = EnsureWindowFlags(config_.windowFlags);
+    window_ = std::make_unique<Utils::SDLWindow>(config_.windowTitle.c_str(),
+                                                 config_.windowX,
+                                                 config_.windowY,
+                                                 config_.windowWidth,
+                                                 config_.windowHeight,
+                                                 flags);
+    if (!window_ || !window_->IsValid()) {
+        std::cerr << "Failed to create SDL window" << '\n' << std::flush;
+        return false;
+    }
+
+    return true;
+}
+
 void SDLApplication::Run() {
     if (!initialized_ && !Initialize()) {
         return;
     }
 
+    if (config_.threadedRendering.enabled) {
+        RunThreaded();
+        return;
+    }
+
     Utils::Timer frame_timer;
     while (running_) {
+        // Pace before polling so the frame works with the freshest input
+        WaitForFrameDeadline();
 
-        ProcessEvents();
+        if (!config_.headless.enabled) {
+            ProcessEvents();
+        }
         if (!running_) {
             break;
         }
+        const auto input_sampled = std::chrono::steady_clock::now();
 
         UpdateTiming();
+        const auto simulation_start = std::chrono::steady_clock::now();
 
         /* if (renderer_ && renderer_->needs_swapchain_recreation()) {
             if (!recreate_swapchain()) {
@@ -248,7 +502,6 @@ void SDLApplication::Run() {
         if (config_.updateCallback) {
             config_.updateCallback(deltaTime_);
         }
-        //std::cout << "current frame time sum: " << current_frame_sum_ << '\n' << std::flush;
         OnUpdate(deltaTime_);
 
         if (renderer_) {
@@ -256,6 +509,7 @@ void SDLApplication::Run() {
             {
                 continue;
             }
+            MarkFrameStart(input_sampled, simulation_start);
 
             if (config_.renderCallback) {
                 config_.renderCallback();
@@ -264,6 +518,7 @@ void SDLApplication::Run() {
             OnRender();
 
             renderer_->EndFrame();
+            RecordRendererTimes();
         } else {
             if (config_.renderCallback) {
                 config_.renderCallback();
@@ -272,21 +527,226 @@ void SDLApplication::Run() {
         }
 
         ++frameCount_;
+        if (config_.headless.frameLimit != 0 && frameCount_ >= config_.headless.frameLimit) {
+            running_ = false;
+        }
 
-        frame_timer.Stop();
-        double frame_time = frame_timer.ElapsedSeconds();
-        // Reset and start the frame timer at the beginning of each frame. we do it here instead of the start to capture the time taken by event processing and looping as well.
-        // Note: reset() clears accumulated time but does not start the timer.
-        frame_timer.Reset();
-        frame_timer.Start();
+        RecordFrameTime(frame_timer);
+    }
+}
 
-        frame_times_.push(frame_time);
-        current_frame_sum_ += frame_time;
-        if ((uint16_t)frame_times_.size() > config_.frame_time_sample_count) {
-            current_frame_sum_ -= frame_times_.front();
-            frame_times_.pop();
+void SDLApplication::RunThreaded() {
+    FramePacketRing ring(std::max(2U, config_.threadedRendering.packetCount));
+    std::thread render_thread([this, &ring]() {
+        try {
+            while (FramePacket* packet = ring.AcquireReady()) {
+                RenderFramePacket(*packet);
+                ring.Release(packet);
+            }
+        } catch (...) {
+            ring.Stop(std::current_exception());
         }
+    });
+    renderThreadActive_ = true;
+
+    try {
+        Utils::Timer frame_timer;
+        while (running_) {
+            WaitForFrameDeadline();
+
+            if (!config_.headless.enabled) {
+                ProcessEvents();
+            }
+            if (!running_) {
+                break;
+            }
+            const auto input_sampled = std::chrono::steady_clock::now();
+
+            UpdateTiming();
+            const auto simulation_start = std::chrono::steady_clock::now();
+            if (config_.updateCallback) {
+                config_.updateCallback(deltaTime_);
+            }
+            OnUpdate(deltaTime_);
+
+            // Blocks while the render thread still holds every packet; null once it stopped
+            FramePacket* packet = ring.AcquireFree();
+            if (packet == nullptr) {
+                break;
+            }
+            packet->frameIndex = frameCount_;
+            packet->deltaTime = deltaTime_;
+            packet->inputSampledTime = input_sampled;
+            packet->simulationStartTime = simulation_start;
+            if (config_.buildPacketCallback) {
+                config_.buildPacketCallback(*packet);
+            }
+            OnBuildFramePacket(*packet);
+            ring.Publish(packet);
+
+            ++frameCount_;
+            if (config_.headless.frameLimit != 0 && frameCount_ >= config_.headless.frameLimit) {
+                running_ = false;
+            }
+
+            RecordFrameTime(frame_timer);
+        }
+    } catch (...) {
+        ring.Stop(std::current_exception());
+    }
+
+    // Packets still queued are dropped; the frame being rendered finishes first
+    ring.Stop();
+    render_thread.join();
+    renderThreadActive_ = false;
+    resizePending_ = false;
+    if (std::exception_ptr error = ring.GetError()) {
+        running_ = false;
+        std::rethrow_exception(error);
+    }
+}
+
+void SDLApplication::RenderFramePacket(const FramePacket& packet) {
+    // Resizes seen by the main thread since the last frame
+    if (resizePending_.exchange(false) && swapchain_) {
+        swapchain_->MarkForRecreation();
+    }
+
+    if (renderer_) {
+        if (!renderer_->BeginFrame()) {
+            return;
+        }
+        MarkFrameStart(packet.inputSampledTime, packet.simulationStartTime);
+    }
+    if (config_.renderPacketCallback) {
+        config_.renderPacketCallback(packet);
+    } else if (config_.renderCallback) {
+        config_.renderCallback();
+    }
+    OnRenderFramePacket(packet);
+    if (renderer_) {
+        renderer_->EndFrame();
+        RecordRendererTimes();
+    }
+}
+
+void SDLApplication::MarkFrameStart(std::chrono::steady_clock::time_point input_sampled,
+                                    std::chrono::steady_clock::time_point simulation_start) {
+    // Frame ids are only known once BeginFrame succeeded
+    if (!latencyTracker_) {
+        return;
     }
+    const uint64_t frame_id = renderer_->GetFrameTimelineValue();
+    latencyTracker_->Mark(frame_id, Utils::LatencyTracker::Marker::INPUT_SAMPLED, input_sampled);
+    latencyTracker_->Mark(frame_id, Utils::LatencyTracker::Marker::SIMULATION_START, simulation_start);
+}
+
+void SDLApplication::RecordFrameTime(Utils::Timer& frame_timer) {
+    frame_timer.Stop();
+    double frame_time = frame_timer.ElapsedSeconds();
+    // Reset and start the frame timer at the beginning of each frame. we do it here instead of the start to capture the time taken by event processing and looping as well.
+    // Note: reset() clears accumulated time but does not start the timer.
+    frame_timer.Reset();
+    frame_timer.Start();
+
+    std::lock_guard<std::mutex> lock(frameStatsMutex_);
+    frameTimeStats_.Add(frame_time * 1'000.0);
+}
+
+void SDLApplication::RecordRendererTimes() {
+    if (firstFrameMs_.load(std::memory_order_relaxed) == 0.0) {
+        firstFrameMs_ = startupTimer_.ElapsedMilliseconds();
+    }
+    const Renderer::FrameTimings& timings = renderer_->GetLastFrameTimings();
+    std::lock_guard<std::mutex> lock(frameStatsMutex_);
+    cpuTimeStats_.Add(timings.cpuMs);
+    fenceWaitStats_.Add(timings.gpuWaitMs);
+    acquireWaitStats_.Add(timings.acquireMs);
+    // GPU times arrive frames in flight later, once per resolved frame
+    const GpuProfiler* profiler = renderer_->GetGpuProfiler();
+    if (profiler && profiler->GetResolvedFrameCount() != gpuResolvedFrames_) {
+        gpuResolvedFrames_ = profiler->GetResolvedFrameCount();
+        gpuTimeStats_.Add(profiler->GetZoneMs(Renderer::GPU_FRAME_ZONE));
+    }
+    if (perfCapture_) {
+        RecordPerfCaptureFrame();
+    }
+}
+
+void SDLApplication::RecordPerfCaptureFrame() {
+    Utils::PerfCapture::Frame frame{};
+    frame.frameIndex = perfCapture_->GetRecordedCount();
+    frame.frameMs = frameTimeStats_.GetLastMs();
+    frame.cpuMs = cpuTimeStats_.GetLastMs();
+    frame.gpuMs = gpuTimeStats_.GetLastMs();
+    frame.counters = Utils::PerfCounters::ReadAndReset();
+    if (perfCaptureAllocator_) {
+        std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets{};
+        perfCaptureAllocator_->GetHeapBudgets(budgets.data());
+        for (const VmaBudget& budget : budgets) {
+            frame.vmaUsageBytes += budget.usage;
+            frame.vmaBudgetBytes += budget.budget;
+        }
+    }
+    if (perfCapture_->Record(frame)) {
+        FinishPerfCapture();
+    }
+}
+
+void SDLApplication::FinishPerfCapture() {
+    Utils::PerfCounters::SetEnabled(false);
+    if (perfCapture_->Save()) {
+        std::cout << "Performance capture of " << perfCapture_->GetRecordedCount() << " frames written to "
+                  << perfCapture_->GetPath() << '\n' << std::flush;
+    } else {
+        std::cerr << "Failed to write performance capture to " << perfCapture_->GetPath() << '\n' << std::flush;
+    }
+    perfCapture_.reset();
+}
+
+void SDLApplication::StartPerfCapture() {
+    std::lock_guard<std::mutex> lock(frameStatsMutex_);
+    perfCapture_ = std::make_unique<Utils::PerfCapture>(config_.perfCapture.path, config_.perfCapture.frameCount,
+                                                        config_.perfCapture.format);
+    // The first captured frame only holds work recorded after this point
+    Utils::PerfCounters::ReadAndReset();
+    Utils::PerfCounters::SetEnabled(true);
+}
+
+void SDLApplication::StopPerfCapture() {
+    std::lock_guard<std::mutex> lock(frameStatsMutex_);
+    if (perfCapture_) {
+        FinishPerfCapture();
+    }
+}
+
+bool SDLApplication::IsPerfCaptureActive() const {
+    std::lock_guard<std::mutex> lock(frameStatsMutex_);
+    return perfCapture_ != nullptr;
+}
+
+double SDLApplication::GetAverageFrameTime() const {
+    std::lock_guard<std::mutex> lock(frameStatsMutex_);
+    return frameTimeStats_.GetAverageMs() / 1'000.0;
+}
+
+SDLApplication::FrameTimeReport SDLApplication::GetFrameTimeReport() const {
+    std::lock_guard<std::mutex> lock(frameStatsMutex_);
+    FrameTimeReport report;
+    report.frame = frameTimeStats_.GetSummary();
+    report.cpu = cpuTimeStats_.GetSummary();
+    report.gpu = gpuTimeStats_.GetSummary();
+    report.fenceWait = fenceWaitStats_.GetSummary();
+    report.acquireWait = acquireWaitStats_.GetSummary();
+    report.frameHistogram = frameTimeStats_.GetHistogram();
+
+    const double frame_ms = report.frame.p50Ms;
+    if (frame_ms > 0.0 && report.fenceWait.p50Ms >= 0.25 * frame_ms) {
+        report.bound = FrameBound::GPU;
+    } else if (frame_ms > 0.0 && report.acquireWait.p50Ms >= 0.25 * frame_ms) {
+        report.bound = FrameBound::PRESENT;
+    }
+    return report;
 }
 
 void SDLApplication::Shutdown() {
@@ -299,6 +759,7 @@ void SDLApplication::ShutdownInternal(bool call_callbacks) {
     }
 
     running_ = false;
+    WaitForBackgroundInit();
 
     if (call_callbacks) {
         // Only invoke overridable hooks when the most-derived type is still alive.
@@ -324,6 +785,11 @@ void SDLApplication::GetWindowSize(int* width, int* height) const {
 void SDLApplication::GetDrawableSize(int* width, int* height) const {
     if (window_) {
         window_->GetDrawableSize(width, height);
+    } else if (swapchain_ && swapchain_->IsHeadless()) {
+        // Headless: the offscreen images are the drawable
+        const VkExtent2D extent = swapchain_->GetExtent();
+        *width = static_cast<int>(extent.width);
+        *height = static_cast<int>(extent.height);
     }
 }
 
@@ -351,13 +817,18 @@ void SDLApplication::UpdateConfig(const SDLApplicationConfig& new_config) {
 }
 
 bool SDLApplication::CreateVulkanObjects() {
+    const bool headless = config_.headless.enabled;
     SDL_Window* window = GetWindow();
-    if (!window) {
+    if (!window && !headless) {
         throw std::runtime_error("Window must be created before Vulkan objects");
     }
 
     std::vector<Utils::NamedCapabilityRequest> instance_extension_requests;
-    std::vector<const char*> sdl_extensions = Utils::SDLUtils::GetRequiredInstanceExtensions();
+    // Headless instances need no surface extensions
+    std::vector<const char*> sdl_extensions;
+    if (!headless) {
+        sdl_extensions = Utils::SDLUtils::GetRequiredInstanceExtensions();
+    }
     instance_extension_requests.reserve(sdl_extensions.size() + config_.instanceExtensions.size() + 1);
     for (const char* extension : sdl_extensions) {
         if (extension) {
@@ -380,9 +851,9 @@ bool SDLApplication::CreateVulkanObjects() {
                                                                    : Utils::CapabilityRequirement::OPTIONAL});
     }
 
-    std::vector<std::string> available_instance_extensions = Utils::EnumerateInstanceExtensionNames();
+    LoaderCapabilities loader_capabilities = TakeLoaderCapabilities();
     Utils::NamedCapabilityResolution instance_resolution =
-        Utils::ResolveNamedCapabilities(instance_extension_requests, available_instance_extensions);
+        Utils::ResolveNamedCapabilities(instance_extension_requests, loader_capabilities.instanceExtensions);
     if (!instance_resolution.missingRequired.empty()) {
         std::ostringstream oss;
         oss << "Missing required instance extensions: " << JoinNames(instance_resolution.missingRequired);
@@ -390,9 +861,8 @@ bool SDLApplication::CreateVulkanObjects() {
     }
     LogOptionalCapabilities(instance_resolution.missingOptional, "instance extensions");
 
-    std::vector<std::string> available_layers = Utils::EnumerateInstanceLayerNames();
     Utils::NamedCapabilityResolution layer_resolution =
-        Utils::ResolveNamedCapabilities(validation_requests, available_layers);
+        Utils::ResolveNamedCapabilities(validation_requests, loader_capabilities.layers);
     if (!layer_resolution.missingRequired.empty()) {
         std::ostringstream oss;
         oss << "Missing required validation layers: " << JoinNames(layer_resolution.missingRequired);
@@ -407,22 +877,37 @@ bool SDLApplication::CreateVulkanObjects() {
     app_info.pApplicationName = config_.windowTitle.c_str();
     app_info.applicationVersion = DEFAULT_APPLICATION_VERSION;
 
+    double phase_start_ms = startupTimer_.ElapsedMilliseconds();
     instance_ = std::make_unique<Instance>(app_info.pApplicationName,
                                             app_info.applicationVersion,
                                             enabled_instance_extension_names,
                                             enabled_validation_layer_names);
+    RecordStartupPhase("Instance", phase_start_ms);
 
-    surface_ = std::make_unique<Surface>(*instance_, window);
+    DeviceSelectionPolicy device_selection = config_.deviceSelection;
+    device_selection.extensions.insert(device_selection.extensions.end(),
+                                       config_.deviceExtensions.begin(),
+                                       config_.deviceExtensions.end());
+    Utils::MergeDeviceFeatures(device_selection.requiredFeatures, config_.requiredDeviceFeatures);
 
-    physicalDevice_ = std::make_unique<PhysicalDevice>(*instance_, surface_->GetHandle());
+    phase_start_ms = startupTimer_.ElapsedMilliseconds();
+    if (headless) {
+        physicalDevice_ = std::make_unique<PhysicalDevice>(*instance_, device_selection);
+    } else {
+        surface_ = std::make_unique<Surface>(*instance_, window);
+        physicalDevice_ = std::make_unique<PhysicalDevice>(*instance_, device_selection, surface_->GetHandle());
+    }
+    RecordStartupPhase(headless ? "PhysicalDevice" : "SurfaceAndPhysicalDevice", phase_start_ms);
 
     std::vector<Utils::NamedCapabilityRequest> device_extension_requests;
     device_extension_requests.reserve(1 + config_.deviceExtensions.size());
-    device_extension_requests.push_back({Constants::SWAPCHAIN_EXTENSION, Utils::CapabilityRequirement::REQUIRED});
+    if (!headless) {
+        device_extension_requests.push_back({Constants::SWAPCHAIN_EXTENSION, Utils::CapabilityRequirement::REQUIRED});
+    }
     device_extension_requests.insert(device_extension_requests.end(),
                                      config_.deviceExtensions.begin(),
                                      config_.deviceExtensions.end());
-    std::vector<VkExtensionProperties> device_extension_properties = physicalDevice_->GetAvailableExtensions();
+    const std::vector<VkExtensionProperties>& device_extension_properties = physicalDevice_->GetAvailableExtensions();
     std::vector<std::string> available_device_extensions;
     available_device_extensions.reserve(device_extension_properties.size());
     for (const VkExtensionProperties& prop : device_extension_properties) {
@@ -453,10 +938,25 @@ bool SDLApplication::CreateVulkanObjects() {
     VkPhysicalDeviceFeatures enabled_features = feature_resolution.enabled;
     std::vector<const char*> enabled_device_extension_names = ToCStrVector(device_extension_resolution.enabled);
 
+    phase_start_ms = startupTimer_.ElapsedMilliseconds();
     device_ = std::make_unique<Device>(*physicalDevice_,
                                        enabled_device_extension_names,
                                        enabled_features,
                                        enabled_validation_layer_names);
+    RecordStartupPhase("Device", phase_start_ms);
+
+    // Reading and validating the cache file only needs the device, so it overlaps the swapchain
+    std::future<std::unique_ptr<PipelineCache>> pipeline_cache_load;
+    if (!config_.startup.pipelineCachePath.empty()) {
+        const bool parallel = config_.startup.parallel;
+        pipeline_cache_load = std::async(parallel ? std::launch::async : std::launch::deferred,
+                                         [this, parallel, path = config_.startup.pipelineCachePath] {
+            const double start_ms = startupTimer_.ElapsedMilliseconds();
+            auto cache = std::make_unique<PipelineCache>(*device_, path);
+            RecordStartupPhase("PipelineCacheLoad", start_ms, parallel);
+            return cache;
+        });
+    }
 
     resolvedSampleCount_ = config_.renderSurface.sampleCount;
     resolvedColorLoadOp_ = config_.renderSurface.colorLoadOp;
@@ -483,19 +983,37 @@ bool SDLApplication::CreateVulkanObjects() {
         }
     }
 
-    VkPresentModeKHR present_mode = ChoosePresentMode(config_.enableVSync);
-    VkSurfaceFormatKHR preferred_format{VK_FORMAT_B8G8R8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR};
-
-    swapchain_ = std::make_unique<Swapchain>(*device_,
-                                             *surface_,
-                                             window,
-                                             present_mode,
-                                             preferred_format,
-                                             config_.renderSurface.minImageCount);
+    phase_start_ms = startupTimer_.ElapsedMilliseconds();
+    if (headless) {
+        swapchain_ = std::make_unique<Swapchain>(*device_,
+                                                 static_cast<uint32_t>(std::max(1, config_.windowWidth)),
+                                                 static_cast<uint32_t>(std::max(1, config_.windowHeight)),
+                                                 config_.headless.format,
+                                                 std::max(1u, config_.headless.imageCount));
+    } else {
+        VkPresentModeKHR present_mode = ChoosePresentMode(config_.enableVSync);
+        VkSurfaceFormatKHR preferred_format{VK_FORMAT_B8G8R8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR};
+
+        swapchain_ = std::make_unique<Swapchain>(*device_,
+                                                 *surface_,
+                                                 window,
+                                                 present_mode,
+                                                 preferred_format,
+                                                 config_.renderSurface.minImageCount);
+    }
+    RecordStartupPhase("Swapchain", phase_start_ms);
 
+    phase_start_ms = startupTimer_.ElapsedMilliseconds();
     CreateRenderPass();
+    RecordStartupPhase("RenderPass", phase_start_ms);
 
+    phase_start_ms = startupTimer_.ElapsedMilliseconds();
     renderer_ = std::make_unique<Renderer>(*device_, *swapchain_, *renderPass_, config_.maxFramesInFlight);
+    RecordStartupPhase("Renderer", phase_start_ms);
+
+    if (pipeline_cache_load.valid()) {
+        pipelineCache_ = pipeline_cache_load.get();
+    }
 
     return true;
 }
@@ -524,7 +1042,8 @@ void SDLApplication::CreateRenderPass() {
                                                resolvedDepthFormat_,
                                                resolvedSampleCount_,
                                                resolvedColorLoadOp_,
-                                               resolvedDepthLoadOp_);
+                                               resolvedDepthLoadOp_,
+                                               swapchain_->GetPresentLayout());
 }
 
 void SDLApplication::ApplyRendererAttachments(std::vector<std::vector<VkImageView>> attachments) {
@@ -540,7 +1059,10 @@ void SDLApplication::SetRenderPass(std::unique_ptr<RenderPass> render_pass) {
 }
 
 void SDLApplication::HandleWindowResize() {
-    if (swapchain_) {
+    if (renderThreadActive_) {
+        // The render thread owns the swapchain while it runs
+        resizePending_ = true;
+    } else if (swapchain_) {
         swapchain_->MarkForRecreation();
     }
 }
@@ -570,6 +1092,15 @@ void SDLApplication::ProcessEvents() {
                     running_ = false;
                 }
                 break;
+            case SDL_EVENT_KEY_DOWN:
+                if (config_.perfCapture.hotkey != 0 && event.key.key == config_.perfCapture.hotkey && !event.key.repeat) {
+                    if (IsPerfCaptureActive()) {
+                        StopPerfCapture();
+                    } else {
+                        StartPerfCapture();
+                    }
+                }
+                break;
             case SDL_EVENT_WINDOW_RESIZED:
             case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED:
                 HandleWindowResize();
@@ -588,6 +1119,42 @@ void SDLApplication::ProcessEvents() {
     }
 }
 
+void SDLApplication::WaitForFrameDeadline() {
+    const SDLApplicationConfig::FramePacingConfig& pacing = config_.framePacing;
+    const uint64_t frequency = Utils::SDLUtils::GetPerformanceFrequency();
+    if (pacing.targetFrameRate <= 0.0 || frequency == 0) {
+        nextFrameDeadline_ = 0;
+        return;
+    }
+
+    using Mode = SDLApplicationConfig::FramePacingMode;
+    const auto period = static_cast<uint64_t>(static_cast<double>(frequency) / pacing.targetFrameRate);
+    uint64_t spin_ticks = 0;
+    if (pacing.mode == Mode::SPIN) {
+        spin_ticks = std::numeric_limits<uint64_t>::max();
+    } else if (pacing.mode == Mode::HYBRID) {
+        spin_ticks = static_cast<uint64_t>(std::max(0.0, pacing.spinThresholdMs) * static_cast<double>(frequency) / 1'000.0);
+    }
+
+    uint64_t now = Utils::SDLUtils::GetPerformanceCounter();
+    while (nextFrameDeadline_ != 0 && now < nextFrameDeadline_) {
+        const uint64_t remaining = nextFrameDeadline_ - now;
+        if (remaining > spin_ticks) {
+            // Sleep off everything above the spin margin, which absorbs the OS overshoot
+            const double sleep_seconds = static_cast<double>(remaining - spin_ticks) / static_cast<double>(frequency);
+            Utils::SDLUtils::DelayNanoseconds(static_cast<uint64_t>(sleep_seconds * 1'000'000'000.0));
+        }
+        now = Utils::SDLUtils::GetPerformanceCounter();
+    }
+
+    // Advance by whole periods so single overshoots do not lower the average rate
+    if (nextFrameDeadline_ == 0 || now - nextFrameDeadline_ > period) {
+        nextFrameDeadline_ = now + period;
+    } else {
+        nextFrameDeadline_ += period;
+    }
+}
+
 void SDLApplication::UpdateTiming() {
     uint64_t current_time = Utils::SDLUtils::GetPerformanceCounter();
     uint64_t frequency = Utils::SDLUtils::GetPerformanceFrequency();
@@ -637,6 +1204,8 @@ void SDLApplication::UpdateTiming() {
 } */
 
 void SDLApplication::Cleanup() {
+    WaitForBackgroundInit();
+    StopPerfCapture();
     if (device_) {
         try
         {
@@ -649,6 +1218,12 @@ void SDLApplication::Cleanup() {
     }
 
     renderer_.reset();
+    if (pipelineCache_ && !pipelineCache_->Save(config_.startup.pipelineCachePath)) {
+        std::cerr << "Warning: Failed to save the pipeline cache to " << config_.startup.pipelineCachePath << '\n' << std::flush;
+    }
+    pipelineCache_.reset();
+    loaderCapabilities_ = {}; // Blocks until an enumeration still running on its worker is done
+    latencyTracker_.reset();
     renderPass_.reset();
     swapchain_.reset();
     surface_.reset();
@@ -2,13 +2,24 @@
 #define VULKAN_RAII_SDL2_APPLICATION_HPP
 
 #include <volk.h>
+#include <any>
+#include <atomic>
+#include <chrono>
 #include <string>
 #include <memory>
 #include <functional>
 #include <cstdint>
-#include <queue>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
 
+#include "core/PhysicalDevice.hpp"
 #include "utils/CapabilityUtils.hpp"
+#include "utils/FrameStats.hpp"
+#include "utils/LatencyTracker.hpp"
+#include "utils/PerfCapture.hpp"
+#include "utils/Timer.hpp"
 
 // Forward declare SDL types
 struct SDL_Window;
@@ -19,18 +30,30 @@ namespace VulkanEngine::RAII {
 
 // Forward declarations
 class Instance;
-class PhysicalDevice;
 class Device;
 class Surface;
 class Swapchain;
 class RenderPass;
 class Renderer;
+class PipelineCache;
+class VmaAllocator;
 
 namespace Utils {
 class SDLContext;
 class SDLWindow;
 }
 
+// What the main thread hands the render thread for one frame in threaded rendering.
+// Packets are reused round-robin, so data keeps whatever the previous frame using the
+// packet left in it
+struct FramePacket {
+    uint64_t frameIndex{0};
+    double deltaTime{0.0};
+    std::chrono::steady_clock::time_point inputSampledTime{}; // Latency markers, stamped by Run()
+    std::chrono::steady_clock::time_point simulationStartTime{};
+    std::any data; // Simulation snapshot the render side draws from
+};
+
 // Configuration structure for SDL Vulkan application
 struct SDLApplicationConfig {
     struct DepthBufferConfig {
@@ -39,6 +62,68 @@ struct SDLApplicationConfig {
         VkAttachmentLoadOp loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
     };
 
+    // How Run() waits out the rest of a capped frame
+    enum class FramePacingMode {
+        SLEEP,  // Lowest power; overshoots by the OS timer granularity
+        HYBRID, // Sleep until spinThresholdMs before the deadline, then spin
+        SPIN    // Most accurate; keeps a core busy
+    };
+
+    // Frame limiter. Frames start on a fixed schedule of 1 / targetFrameRate, and the
+    // wait happens before events are polled, so input is sampled as late as possible.
+    // A frame that runs more than one period late restarts the schedule instead of
+    // letting the following frames burst to catch up
+    struct FramePacingConfig {
+        double targetFrameRate = 0.0; // 0: uncapped
+        FramePacingMode mode = FramePacingMode::HYBRID;
+        double spinThresholdMs = 1.0; // HYBRID only: margin left for spinning
+    };
+
+    // Headless mode for servers, CI and compute jobs: SDL video is never initialised and
+    // there is no window, surface or VK_KHR_swapchain. Frames render into a ring of
+    // windowWidth x windowHeight offscreen images (the headless Swapchain) through the
+    // same Renderer; read them back with Renderer::SetFrameReadback
+    struct HeadlessConfig {
+        bool enabled = false;
+        VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
+        uint32_t imageCount = 3;
+        uint64_t frameLimit = 0; // Run() stops after this many frames (0: until RequestExit)
+    };
+
+    // Threaded rendering: events, update callbacks and packet building stay on the thread
+    // calling Run(), while a render thread runs BeginFrame, the render callbacks and
+    // EndFrame for each packet, so update and rendering overlap. The main thread runs
+    // at most packetCount - 1 frames ahead and blocks when every packet is in use.
+    // Resizes are forwarded to the render thread, which recreates the swapchain; event
+    // and resize callbacks run on the main thread and must not touch Vulkan objects
+    struct ThreadedRenderingConfig {
+        bool enabled = false;
+        uint32_t packetCount = 2; // 2: double-buffered, 3: triple-buffered
+    };
+
+    // Performance capture: frameCount frames of timings, PerfCounters and VMA usage
+    // written to path (see SDLApplication::StartPerfCapture). hotkey is an SDL_Keycode
+    // (e.g. SDLK_F9) toggling a capture, 0 for none
+    struct PerfCaptureConfig {
+        bool startOnLaunch = false;
+        uint32_t frameCount = 600;
+        std::string path = "perf_capture.csv";
+        Utils::PerfCapture::Format format = Utils::PerfCapture::Format::CSV;
+        uint32_t hotkey = 0;
+    };
+
+    // Startup orchestration. With parallel set, the loader's instance extension and layer
+    // enumeration runs on a worker while the calling thread brings up SDL and the window,
+    // and the pipeline cache file loads on a worker while the swapchain, render pass and
+    // renderer are created. backgroundInitCallback then runs on a worker thread once
+    // Initialize returns, so Run() presents frames while heavy pipelines compile (e.g.
+    // through PipelineBatchBuilder); check IsBackgroundInitComplete() before using what
+    // it creates. Without parallel every phase runs in order on the calling thread
+    struct StartupConfig {
+        bool parallel = true;
+        std::string pipelineCachePath; // Loaded into GetPipelineCache() and saved on shutdown; empty: no cache
+    };
+
     struct RenderSurfaceConfig {
         VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT;
         VkAttachmentLoadOp colorLoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
@@ -56,12 +141,18 @@ struct SDLApplicationConfig {
     bool enableValidation = true;
     bool enableVSync = true;
     uint32_t maxFramesInFlight = 3;
+    FramePacingConfig framePacing{};
+    HeadlessConfig headless{};
+    ThreadedRenderingConfig threadedRendering{};
+    PerfCaptureConfig perfCapture{};
+    StartupConfig startup{};
 
     std::vector<Utils::NamedCapabilityRequest> validationLayers = {}; // Custom validation layers (if empty, default ones will be used)
     std::vector<Utils::NamedCapabilityRequest> instanceExtensions = {}; // Additional instance extensions to enable
     std::vector<Utils::NamedCapabilityRequest> deviceExtensions = {}; // Additional device extensions to enable
     VkPhysicalDeviceFeatures requiredDeviceFeatures = {}; // Required physical device features
     VkPhysicalDeviceFeatures optionalDeviceFeatures = {}; // Optional physical device features
+    DeviceSelectionPolicy deviceSelection{}; // deviceExtensions and requiredDeviceFeatures are added to its requirements
 
     RenderSurfaceConfig renderSurface{};
     std::function<std::unique_ptr<RenderPass>(const Device&, const Swapchain&, const RenderSurfaceConfig&, VkFormat)>
@@ -70,12 +161,15 @@ struct SDLApplicationConfig {
     // Optional application callbacks
     std::function<void(double delta_time)> updateCallback;
     std::function<void()> renderCallback;
+    std::function<void(FramePacket&)> buildPacketCallback; // Threaded rendering: main thread, after update
+    std::function<void(const FramePacket&)> renderPacketCallback; // Threaded rendering: replaces renderCallback
     std::function<void(const SDL_Event&)> eventCallback;
     std::function<void()> initCallback;
+    std::function<void()> backgroundInitCallback; // Worker thread, see StartupConfig; throwing requests exit
     std::function<void()> cleanupCallback;
     std::function<void(int width, int height)> resizeCallback;
 
-    uint16_t frame_time_sample_count = 120; // number of frames to average for frame time calculation
+    uint16_t frame_time_sample_count = 120; // number of frames kept for frame time statistics
 };
 
 // High-level SDL + Vulkan application class
@@ -115,12 +209,15 @@ public:
     [[nodiscard]] Swapchain* GetSwapchain() const { return swapchain_.get(); }
     [[nodiscard]] RenderPass* GetRenderPass() const { return renderPass_.get(); }
     [[nodiscard]] Renderer* GetRenderer() const { return renderer_.get(); }
+    [[nodiscard]] PipelineCache* GetPipelineCache() const { return pipelineCache_.get(); } // Null without startup.pipelineCachePath
 
     // Read-only access to configuration (for derived classes/utilities)
     [[nodiscard]] const SDLApplicationConfig& GetConfig() const { return config_; }
 
-    // Access to SDL objects
+    // Access to SDL objects (no window in headless mode)
     [[nodiscard]] SDL_Window* GetWindow() const;
+    [[nodiscard]] bool IsHeadless() const { return config_.headless.enabled; }
+    [[nodiscard]] bool IsThreadedRendering() const { return config_.threadedRendering.enabled; }
 
     // Window management
     void GetWindowSize(int* width, int* height) const;
@@ -131,7 +228,73 @@ public:
     [[nodiscard]] double GetDeltaTime() const { return deltaTime_; }
     [[nodiscard]] double GetLastFps() const { return 1.0 / deltaTime_; } // return the fps extrapolated from a single frame via delta time.
     [[nodiscard]] uint64_t GetFrameCount() const { return frameCount_; }
-    [[nodiscard]] inline double GetAverageFrameTime() const { return current_frame_sum_ / static_cast<double>(frame_times_.size()); }; // average frame time over last 120 frames in seconds
+    [[nodiscard]] double GetAverageFrameTime() const; // average frame time over the last frame_time_sample_count frames in seconds
+
+    // What limits the frame rate, judged from the median frame: GPU when BeginFrame
+    // waits on the GPU for a quarter of the frame or more, PRESENT when acquiring the
+    // swapchain image does, CPU otherwise
+    enum class FrameBound {
+        CPU,
+        GPU,
+        PRESENT
+    };
+
+    // Distribution of each frame time component over the last frame_time_sample_count
+    // frames. frame is the whole loop iteration (main thread); cpu, fenceWait and
+    // acquireWait come from the renderer (Renderer::GetLastFrameTimings); gpu needs a
+    // GpuProfiler attached to the renderer and is empty otherwise
+    struct FrameTimeReport {
+        Utils::FrameStats::Summary frame;
+        Utils::FrameStats::Summary cpu;
+        Utils::FrameStats::Summary gpu;
+        Utils::FrameStats::Summary fenceWait;
+        Utils::FrameStats::Summary acquireWait;
+        Utils::FrameStats::Histogram frameHistogram{};
+        FrameBound bound{FrameBound::CPU};
+    };
+    [[nodiscard]] FrameTimeReport GetFrameTimeReport() const;
+
+    // Input-to-present (and, with a display time source, input-to-display) latency over
+    // the last frame_time_sample_count completed frames. Run() stamps input sampling and
+    // simulation start, the Renderer the rest (see Renderer::SetLatencyTracker)
+    [[nodiscard]] Utils::LatencyTracker::Stats GetLatencyStats() const {
+        return latencyTracker_ ? latencyTracker_->GetStats() : Utils::LatencyTracker::Stats{};
+    }
+    [[nodiscard]] Utils::LatencyTracker* GetLatencyTracker() const { return latencyTracker_.get(); }
+
+    // Record the next perfCapture.frameCount frames; the file is written when they are in
+    // or on StopPerfCapture (partial). Starting while a capture runs restarts it. Enables
+    // Utils::PerfCounters for the duration
+    void StartPerfCapture();
+    void StopPerfCapture();
+    [[nodiscard]] bool IsPerfCaptureActive() const;
+
+    // One timed step of Initialize, in milliseconds since Initialize was entered.
+    // background phases ran on a worker thread alongside the others
+    struct StartupPhase {
+        std::string name;
+        double startMs{0.0};
+        double durationMs{0.0};
+        bool background{false};
+    };
+
+    struct StartupReport {
+        std::vector<StartupPhase> phases; // Sorted by start
+        double initializeMs{0.0}; // Until Initialize returned
+        double firstFrameMs{0.0}; // Until the first frame was submitted for presentation, 0 before
+        double backgroundInitMs{0.0}; // Until backgroundInitCallback finished, 0 while it runs or without one
+    };
+    [[nodiscard]] StartupReport GetStartupReport() const;
+
+    // Whether backgroundInitCallback has finished (true without one)
+    [[nodiscard]] bool IsBackgroundInitComplete() const { return backgroundInitComplete_; }
+    void WaitForBackgroundInit();
+
+    // Allocator whose heap usage and budgets captures record (the application owns it)
+    void SetPerfCaptureAllocator(const VmaAllocator* allocator) { perfCaptureAllocator_ = allocator; }
+
+    // Change the frame cap at runtime (0: uncapped); the schedule restarts on the next frame
+    void SetTargetFrameRate(double frame_rate) { config_.framePacing.targetFrameRate = frame_rate; nextFrameDeadline_ = 0; }
 
     // Update configuration (some changes require restart)
     void UpdateConfig(const SDLApplicationConfig& new_config);
@@ -141,6 +304,8 @@ protected:
     virtual bool OnInitialize() { return true; }
     virtual void OnUpdate(double delta_time) {}
     virtual void OnRender() {}
+    virtual void OnBuildFramePacket(FramePacket& packet) {}
+    virtual void OnRenderFramePacket(const FramePacket& packet) { OnRender(); } // Render thread
     virtual void OnEvent(const SDL_Event& event) {}
     virtual void OnResize(int width, int height) {}
     virtual void OnShutdown() {}
@@ -156,18 +321,47 @@ protected:
     [[nodiscard]] VkSampleCountFlagBits GetSampleCount() const { return resolvedSampleCount_; }
 
 private:
+    // What Initialize enumerates from the loader while the window is created
+    struct LoaderCapabilities {
+        std::vector<std::string> instanceExtensions;
+        std::vector<std::string> layers;
+    };
+
     SDLApplicationConfig config_;
     bool initialized_{false};
-    bool running_{false};
+    std::atomic<bool> running_{false}; // RequestExit may come from the render thread
     
     // Timing
     uint64_t lastTime_{0};
     double deltaTime_{0.0};
     uint64_t frameCount_{0};
-
-    // a queue to hold the last 120 frame times for averaging
-    std::queue<double> frame_times_;
-    double current_frame_sum_{0.0};
+    uint64_t nextFrameDeadline_{0}; // Performance counter value the next capped frame starts at (0: none)
+
+    // Threaded rendering (only while RunThreaded is active)
+    bool renderThreadActive_{false};
+    std::atomic<bool> resizePending_{false}; // Set by the main thread, consumed by the render thread
+
+    // Frame time statistics in milliseconds; the renderer side is written by the render thread when threaded
+    mutable std::mutex frameStatsMutex_;
+    Utils::FrameStats frameTimeStats_;
+    Utils::FrameStats cpuTimeStats_;
+    Utils::FrameStats gpuTimeStats_;
+    Utils::FrameStats fenceWaitStats_;
+    Utils::FrameStats acquireWaitStats_;
+    uint64_t gpuResolvedFrames_{0}; // GpuProfiler::GetResolvedFrameCount() last sampled
+    std::unique_ptr<Utils::PerfCapture> perfCapture_; // Guarded by frameStatsMutex_, null when no capture runs
+    const VmaAllocator* perfCaptureAllocator_{nullptr};
+
+    // Startup; worker threads append phases too
+    mutable std::mutex startupMutex_;
+    Utils::Timer startupTimer_; // Started when Initialize is entered
+    std::vector<StartupPhase> startupPhases_; // Guarded by startupMutex_
+    double initializeMs_{0.0}; // Guarded by startupMutex_
+    std::atomic<double> firstFrameMs_{0.0};
+    std::atomic<double> backgroundInitMs_{0.0};
+    std::atomic<bool> backgroundInitComplete_{false};
+    std::thread backgroundInitThread_;
+    std::future<LoaderCapabilities> loaderCapabilities_; // Consumed by CreateVulkanObjects
     
     // SDL objects
     std::unique_ptr<Utils::SDLContext> sdlContext_;
@@ -181,10 +375,26 @@ private:
     std::unique_ptr<Swapchain> swapchain_;
     std::unique_ptr<RenderPass> renderPass_;
     std::unique_ptr<Renderer> renderer_;
+    std::unique_ptr<PipelineCache> pipelineCache_;
+    std::unique_ptr<Utils::LatencyTracker> latencyTracker_;
     
     // Internal methods
+    bool InitializeWindow();
+    LoaderCapabilities TakeLoaderCapabilities();
+    void StartBackgroundInit();
+    // Joins other's background worker and returns other; used before any of its members move
+    static SDLApplication& FinishedBackgroundInit(SDLApplication& other);
+    void RecordStartupPhase(const char* name, double start_ms, bool background = false);
+    void RunThreaded();
+    void RenderFramePacket(const FramePacket& packet);
+    void MarkFrameStart(std::chrono::steady_clock::time_point input_sampled, std::chrono::steady_clock::time_point simulation_start);
+    void RecordFrameTime(Utils::Timer& frame_timer);
+    void RecordRendererTimes();
+    void RecordPerfCaptureFrame(); // frameStatsMutex_ held
+    void FinishPerfCapture(); // frameStatsMutex_ held
     void ProcessEvents();
     void UpdateTiming();
+    void WaitForFrameDeadline();
     // bool recreate_swapchain();
     void Cleanup();
     void ShutdownInternal(bool call_callbacks);
@@ -9,6 +9,7 @@
 #include "core/PhysicalDevice.hpp"
 #include "core/Device.hpp"
 #include "core/Queue.hpp"
+#include "core/SubmitBatch.hpp"
 #include "core/DebugMessenger.hpp"
 
 // Presentation
@@ -18,32 +19,79 @@
 // Rendering
 #include "rendering/CommandPool.hpp"
 #include "rendering/CommandBuffer.hpp"
+#include "rendering/FrameCommandAllocator.hpp"
 #include "rendering/RenderPass.hpp"
 #include "rendering/Framebuffer.hpp"
 #include "rendering/PipelineStructs.hpp"
 #include "rendering/Pipeline.hpp"
+#include "rendering/PipelineCache.hpp"
+#include "rendering/PipelineBatchBuilder.hpp"
+#include "rendering/PipelineRegistry.hpp"
+#include "rendering/PipelineStatistics.hpp"
+#include "rendering/PipelineLibraryLinker.hpp"
 #include "rendering/Renderer.hpp"
+#include "rendering/QueryPool.hpp"
+#include "rendering/GpuProfiler.hpp"
+#include "rendering/RenderGraph.hpp"
+#include "rendering/IndirectDrawCuller.hpp"
+#include "rendering/RecordedBundle.hpp"
+#include "rendering/IndirectCommandsLayout.hpp"
+#include "rendering/IndirectExecutionSet.hpp"
 
 // Resources
 #include "resources/Buffer.hpp"
 #include "resources/Image.hpp"
 #include "resources/Shader.hpp"
 #include "resources/Sampler.hpp"
+#include "resources/SamplerCache.hpp"
 #include "resources/VmaAllocator.hpp"
 #include "resources/DescriptorSetLayout.hpp"
+#include "resources/DescriptorUpdateTemplate.hpp"
 #include "resources/DescriptorPool.hpp"
+#include "resources/DescriptorAllocator.hpp"
+#include "resources/DescriptorBufferAllocator.hpp"
+#include "resources/FrameDescriptorAllocator.hpp"
+#include "resources/DescriptorSetCache.hpp"
+#include "resources/BindlessTable.hpp"
 #include "resources/PipelineLayout.hpp"
+#include "resources/UploadManager.hpp"
+#include "resources/FrameRingBuffer.hpp"
+#include "resources/MemoryPool.hpp"
+#include "resources/TransientAllocator.hpp"
+#include "resources/BufferCopyBatch.hpp"
+#include "resources/ReadbackManager.hpp"
+#include "resources/MemoryBudgetManager.hpp"
+#include "resources/DefragmentationScheduler.hpp"
+#include "resources/MemoryStatistics.hpp"
+#include "resources/SparseResidencyManager.hpp"
+#include "resources/ShaderLayoutCache.hpp"
+#include "resources/ShaderLibrary.hpp"
+#include "resources/ShaderObject.hpp"
+#include "resources/PreprocessBuffer.hpp"
 
 // Synchronization
 #include "sync/Semaphore.hpp"
 #include "sync/Fence.hpp"
 #include "sync/Event.hpp"
+#include "sync/EventPool.hpp"
+#include "sync/ResourceState.hpp"
+#include "sync/BarrierBatcher.hpp"
 
 // Types
 #include "types/QueueFamilyIndices.hpp"
 
 // Utilities
 #include "utils/VulkanUtils.hpp"
+#include "utils/SyncUtils.hpp"
+#include "utils/SmallVector.hpp"
+#include "utils/FrameStats.hpp"
+#include "utils/LatencyTracker.hpp"
+#include "utils/Profiler.hpp"
+#include "utils/TracyUtils.hpp"
+#include "utils/PerfCounters.hpp"
+#include "utils/PerfCapture.hpp"
+#include "utils/HostAllocator.hpp"
+#include "utils/DeviceDispatch.hpp"
 
 // SDL2 Integration
 #include "SDL2Application.hpp"
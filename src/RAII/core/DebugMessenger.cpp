@@ -1,7 +1,8 @@
 #include "DebugMessenger.hpp"
 
 #include "instance.hpp"
-#include <iostream>
+#include "../utils/DebugLog.hpp"
+#include "../utils/HostAllocator.hpp"
 #include <stdexcept>
 
 namespace VulkanEngine::RAII {
@@ -15,7 +16,7 @@ DebugMessenger::DebugMessenger(const Instance& instance,
 
 DebugMessenger::~DebugMessenger() {
     if (debugMessenger_ != VK_NULL_HANDLE) {
-        vkDestroyDebugUtilsMessengerEXT(instance_, debugMessenger_, nullptr);
+        vkDestroyDebugUtilsMessengerEXT(instance_, debugMessenger_, Utils::HostAllocator::For(VK_OBJECT_TYPE_DEBUG_UTILS_MESSENGER_EXT));
         debugMessenger_ = VK_NULL_HANDLE;
     }
 }
@@ -29,7 +30,7 @@ DebugMessenger::DebugMessenger(DebugMessenger&& other) noexcept
 DebugMessenger& DebugMessenger::operator=(DebugMessenger&& other) noexcept {
     if (this != &other) {
         if (debugMessenger_ != VK_NULL_HANDLE) {
-            vkDestroyDebugUtilsMessengerEXT(instance_, debugMessenger_, nullptr);
+            vkDestroyDebugUtilsMessengerEXT(instance_, debugMessenger_, Utils::HostAllocator::For(VK_OBJECT_TYPE_DEBUG_UTILS_MESSENGER_EXT));
         }
         debugMessenger_ = other.debugMessenger_;
         instance_ = other.instance_;
@@ -44,9 +45,10 @@ VKAPI_ATTR VkBool32 VKAPI_CALL DebugMessenger::DebugCallback(
     VkDebugUtilsMessageTypeFlagsEXT message_type,
     const VkDebugUtilsMessengerCallbackDataEXT* p_callback_data,
     void* /*pUserData*/) {
-    std::cerr << "[Vulkan Validation] " << p_callback_data->pMessage << '\n';
-    (void)message_severity;
-    (void)message_type;
+    // Formatting and printing happen on the logger thread, off the driver call
+    if (p_callback_data != nullptr) {
+        Utils::DebugLog::Instance().Post(message_severity, message_type, *p_callback_data);
+    }
     return VK_FALSE;
 }
 
@@ -65,7 +67,7 @@ void DebugMessenger::CreateDebugMessenger(const Instance& instance,
                                           VkDebugUtilsMessageSeverityFlagsEXT message_severity,
                                           VkDebugUtilsMessageTypeFlagsEXT message_type) {
     auto create_info = GetCreateInfo(message_severity, message_type);
-    VkResult result = vkCreateDebugUtilsMessengerEXT(instance.GetHandle(), &create_info, nullptr, &debugMessenger_);
+    VkResult result = vkCreateDebugUtilsMessengerEXT(instance.GetHandle(), &create_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_DEBUG_UTILS_MESSENGER_EXT), &debugMessenger_);
     if (result != VK_SUCCESS) {
         throw std::runtime_error("Failed to create debug messenger");
     }
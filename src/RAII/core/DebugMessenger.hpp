@@ -41,7 +41,8 @@ public:
     // Check if the debug messenger is valid
     [[nodiscard]] bool IsValid() const { return debugMessenger_ != VK_NULL_HANDLE; }
 
-    // Static debug callback function
+    // Static debug callback function; hands messages to Utils::DebugLog, which prints them
+    // on its own thread
     static VKAPI_ATTR VkBool32 VKAPI_CALL DebugCallback(
         VkDebugUtilsMessageSeverityFlagBitsEXT message_severity,
         VkDebugUtilsMessageTypeFlagsEXT message_type,
@@ -0,0 +1,52 @@
+#include "DeferredDestructionQueue.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+namespace VulkanEngine::RAII {
+
+DeferredDestructionQueue::~DeferredDestructionQueue() {
+    DestroyAll();
+}
+
+void DeferredDestructionQueue::Push(uint64_t value, std::unique_ptr<HolderBase> holder) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Deferring at the recording value appends; explicit earlier values are rare
+    auto position = entries_.end();
+    if (!entries_.empty() && entries_.back().value > value) {
+        position = std::upper_bound(entries_.begin(), entries_.end(), value, [](uint64_t v, const Entry& entry) {
+            return v < entry.value;
+        });
+    }
+    entries_.insert(position, Entry{value, std::move(holder)});
+}
+
+size_t DeferredDestructionQueue::Collect(uint64_t completed_value) {
+    // Destructors run outside the lock; they may defer further objects
+    std::vector<Entry> retired;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        while (!entries_.empty() && entries_.front().value <= completed_value) {
+            retired.push_back(std::move(entries_.front()));
+            entries_.pop_front();
+        }
+    }
+    return retired.size();
+}
+
+size_t DeferredDestructionQueue::DestroyAll() {
+    std::deque<Entry> retired;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        retired.swap(entries_);
+    }
+    return retired.size();
+}
+
+size_t DeferredDestructionQueue::GetPendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+} // namespace VulkanEngine::RAII
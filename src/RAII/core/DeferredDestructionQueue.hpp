@@ -0,0 +1,84 @@
+#ifndef VULKAN_RAII_CORE_DEFERRED_DESTRUCTION_QUEUE_HPP
+#define VULKAN_RAII_CORE_DEFERRED_DESTRUCTION_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+namespace VulkanEngine::RAII {
+
+// Keeps objects the GPU may still be using (Buffer, Image, Pipeline, DescriptorPool, ...)
+// alive until the work that used them has retired, then destroys them in bulk, so dropping
+// a resource mid-stream never idles the device. Values are frame timeline values
+// (Renderer::GetFrameTimelineValue): Renderer::BeginFrame sets the recording value and
+// collects what the completed frames released, Device::WaitIdle and the Device destructor
+// destroy everything. Without a Renderer, drive SetRecordingValue and Collect with any
+// monotonically increasing counter of completed submissions. Thread-safe
+class DeferredDestructionQueue {
+public:
+    DeferredDestructionQueue() = default;
+
+    // Destructor destroys whatever is still pending; the device must be idle
+    ~DeferredDestructionQueue();
+
+    // Delete copy and move. Device hands out references to its queue.
+    DeferredDestructionQueue(const DeferredDestructionQueue&) = delete;
+    DeferredDestructionQueue& operator=(const DeferredDestructionQueue&) = delete;
+    DeferredDestructionQueue(DeferredDestructionQueue&&) = delete;
+    DeferredDestructionQueue& operator=(DeferredDestructionQueue&&) = delete;
+
+    // Destroy object once the work being recorded now (GetRecordingValue) has completed.
+    // Ownership moves in: Defer(std::move(buffer)) or Defer(std::move(unique_ptr))
+    template <typename T>
+    void Defer(T&& object) { Defer(std::forward<T>(object), GetRecordingValue()); }
+
+    // Destroy object once retire_value has completed
+    template <typename T>
+    void Defer(T&& object, uint64_t retire_value) {
+        static_assert(!std::is_lvalue_reference_v<T>, "Move the object into the queue");
+        Push(retire_value, std::make_unique<Holder<std::decay_t<T>>>(std::move(object)));
+    }
+
+    // Value the work now being recorded signals on completion
+    void SetRecordingValue(uint64_t value) { recordingValue_.store(value, std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t GetRecordingValue() const { return recordingValue_.load(std::memory_order_relaxed); }
+
+    // Destroy the objects whose value is at most completed_value; returns how many
+    size_t Collect(uint64_t completed_value);
+
+    // Destroy every pending object; the GPU must be done with all of them
+    size_t DestroyAll();
+
+    [[nodiscard]] size_t GetPendingCount() const;
+
+private:
+    struct HolderBase {
+        virtual ~HolderBase() = default;
+    };
+
+    template <typename T>
+    struct Holder final : HolderBase {
+        explicit Holder(T&& held) : object(std::move(held)) {}
+        T object;
+    };
+
+    struct Entry {
+        uint64_t value{0};
+        std::unique_ptr<HolderBase> holder;
+    };
+
+    mutable std::mutex mutex_;
+    std::deque<Entry> entries_; // Ordered by value
+    std::atomic<uint64_t> recordingValue_{1}; // Frame values start at 1
+
+    void Push(uint64_t value, std::unique_ptr<HolderBase> holder);
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_CORE_DEFERRED_DESTRUCTION_QUEUE_HPP
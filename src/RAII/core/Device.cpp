@@ -3,26 +3,63 @@
 #include "PhysicalDevice.hpp"
 
 #include "../rendering/CommandPool.hpp"
+#include "../utils/PerfCounters.hpp"
+#include "../utils/HostAllocator.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <string>
+#include <unordered_set>
 #include <vector>
 #include <volk.h>
 #include <stdexcept>
-#include <set>
+#include <map>
+#include <optional>
 #include <cassert>
 #include <memory> // Added for std::make_unique
+#include <mutex>
 #include <utility> // Added for std::move
 
 
 namespace VulkanEngine::RAII {
 
+namespace {
+std::mutex& GlobalDispatchMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+uint32_t& LiveDeviceCount() {
+    static uint32_t count = 0;
+    return count;
+}
+
+// The global vk* pointers skip the loader when bound to a device with volkLoadDevice,
+// but then only work for that device. The first device gets them; a second one puts
+// them back to the loader trampolines (volkLoadInstance), which dispatch for any device
+void AcquireGlobalDispatch(VkDevice device) {
+    std::lock_guard lock(GlobalDispatchMutex());
+    if (LiveDeviceCount()++ == 0) {
+        volkLoadDevice(device);
+    } else {
+        volkLoadInstance(volkGetLoadedInstance());
+    }
+}
+
+void ReleaseGlobalDispatch() {
+    std::lock_guard lock(GlobalDispatchMutex());
+    --LiveDeviceCount();
+}
+} // namespace
+
 Device::Device(const PhysicalDevice& physical_device,
                const std::vector<const char*>& required_extensions,
                const VkPhysicalDeviceFeatures& required_features,
-               const std::vector<const char*>& validation_layers)
+               const std::vector<const char*>& validation_layers,
+               const DeviceQueueConfig& queue_config)
     : physicalDevice_(physical_device) {
     queueFamilyIndices_ = physicalDevice_.FindQueueFamilies();
-    CreateLogicalDevice(required_extensions, required_features, validation_layers);
+    CreateLogicalDevice(required_extensions, required_features, validation_layers, queue_config);
     // Create the transient/resettable command pool using graphics queue family
     if (!queueFamilyIndices_.graphicsFamily_.has_value()) {
         throw std::runtime_error("Graphics queue family not available for command pool creation");
@@ -38,9 +75,11 @@ Device::~Device() {
         // Ensure all work is complete before tearing down dependent resources
         vkDeviceWaitIdle(device_);
         // Destroy resources that depend on the device first
+        deferredDestruction_->DestroyAll();
         singleUseCommandPool_.reset();
         // Destroy the logical device
-        vkDestroyDevice(device_, nullptr);
+        vkDestroyDevice(device_, Utils::HostAllocator::For(VK_OBJECT_TYPE_DEVICE));
+        ReleaseGlobalDispatch();
         // Invalidate the handle
         device_ = VK_NULL_HANDLE;
     }
@@ -50,7 +89,21 @@ Device::Device(Device&& other) noexcept
     : device_(other.device_),
       physicalDevice_(other.physicalDevice_),
       queueFamilyIndices_(other.queueFamilyIndices_),
-      singleUseCommandPool_(std::move(other.singleUseCommandPool_)) {
+      deviceGroupSize_(other.deviceGroupSize_),
+      timelineSemaphoresEnabled_(other.timelineSemaphoresEnabled_),
+      descriptorIndexingEnabled_(other.descriptorIndexingEnabled_),
+      bufferDeviceAddressEnabled_(other.bufferDeviceAddressEnabled_),
+      hostQueryResetEnabled_(other.hostQueryResetEnabled_),
+      enabledFeatures_(other.enabledFeatures_),
+      enabledExtensions_(std::move(other.enabledExtensions_)),
+      extensionFeatures_(other.extensionFeatures_),
+      hostImageCopyDstLayouts_(std::move(other.hostImageCopyDstLayouts_)),
+      fragmentShadingRateProperties_(other.fragmentShadingRateProperties_),
+      dispatch_(std::move(other.dispatch_)),
+      roleQueueIndices_(std::move(other.roleQueueIndices_)),
+      queueMutexes_(std::move(other.queueMutexes_)),
+      singleUseCommandPool_(std::move(other.singleUseCommandPool_)),
+      deferredDestruction_(std::move(other.deferredDestruction_)) {
     other.device_ = VK_NULL_HANDLE;
 }
 
@@ -61,24 +114,42 @@ Device& Device::operator=(Device&& other) noexcept {
             // Make sure any in-flight work is finished before destruction
             vkDeviceWaitIdle(device_);
             // Destroy resources tied to the current device before destroying the device itself
+            deferredDestruction_->DestroyAll();
             singleUseCommandPool_.reset();
-            vkDestroyDevice(device_, nullptr);
+            vkDestroyDevice(device_, Utils::HostAllocator::For(VK_OBJECT_TYPE_DEVICE));
+            ReleaseGlobalDispatch();
         }
         device_ = other.device_;
         queueFamilyIndices_ = other.queueFamilyIndices_;
+        deviceGroupSize_ = other.deviceGroupSize_;
+        timelineSemaphoresEnabled_ = other.timelineSemaphoresEnabled_;
+        descriptorIndexingEnabled_ = other.descriptorIndexingEnabled_;
+        bufferDeviceAddressEnabled_ = other.bufferDeviceAddressEnabled_;
+        hostQueryResetEnabled_ = other.hostQueryResetEnabled_;
+        enabledFeatures_ = other.enabledFeatures_;
+        enabledExtensions_ = std::move(other.enabledExtensions_);
+        extensionFeatures_ = other.extensionFeatures_;
+        hostImageCopyDstLayouts_ = std::move(other.hostImageCopyDstLayouts_);
+        fragmentShadingRateProperties_ = other.fragmentShadingRateProperties_;
+        dispatch_ = std::move(other.dispatch_);
+        roleQueueIndices_ = std::move(other.roleQueueIndices_);
+        queueMutexes_ = std::move(other.queueMutexes_);
         singleUseCommandPool_ = std::move(other.singleUseCommandPool_);
+        deferredDestruction_ = std::move(other.deferredDestruction_);
         other.device_ = VK_NULL_HANDLE;
     }
     return *this;
 }
 
 void Device::WaitIdle() const {
-    vkDeviceWaitIdle(device_);
+    dispatch_->vkDeviceWaitIdle(device_);
+    // Nothing can be in use any more
+    deferredDestruction_->DestroyAll();
 }
 
 VkQueue Device::GetQueue(uint32_t queue_family_index, uint32_t queue_index) const {
     VkQueue queue = VK_NULL_HANDLE;
-    vkGetDeviceQueue(device_, queue_family_index, queue_index, &queue);
+    dispatch_->vkGetDeviceQueue(device_, queue_family_index, queue_index, &queue);
     return queue;
 }
 
@@ -86,28 +157,33 @@ VkQueue Device::GetGraphicsQueue() const {
     if (!queueFamilyIndices_.graphicsFamily_.has_value()) {
         throw std::runtime_error("Graphics queue family not available");
     }
-    return GetQueue(queueFamilyIndices_.graphicsFamily_.value());
+    return GetQueue(queueFamilyIndices_.graphicsFamily_.value(), GetQueueIndices(QueueType::GRAPHICS).front());
 }
 
 VkQueue Device::GetPresentQueue() const {
     if (!queueFamilyIndices_.presentFamily_.has_value()) {
         throw std::runtime_error("Present queue family not available");
     }
-    return GetQueue(queueFamilyIndices_.presentFamily_.value());
+    return GetQueue(queueFamilyIndices_.presentFamily_.value(), GetQueueIndices(QueueType::PRESENT).front());
 }
 
 VkQueue Device::GetComputeQueue() const {
     if (!queueFamilyIndices_.computeFamily_.has_value()) {
         return GetGraphicsQueue();
     }
-    return GetQueue(queueFamilyIndices_.computeFamily_.value());
+    return GetQueue(queueFamilyIndices_.computeFamily_.value(), GetQueueIndices(QueueType::COMPUTE).front());
 }
 
 VkQueue Device::GetTransferQueue() const {
     if (!queueFamilyIndices_.transferFamily_.has_value()) {
         return GetGraphicsQueue();
     }
-    return GetQueue(queueFamilyIndices_.transferFamily_.value());
+    return GetQueue(queueFamilyIndices_.transferFamily_.value(), GetQueueIndices(QueueType::TRANSFER).front());
+}
+
+std::shared_ptr<std::mutex> Device::GetQueueMutex(VkQueue queue) const {
+    const auto it = queueMutexes_.find(queue);
+    return it != queueMutexes_.end() ? it->second : nullptr;
 }
 
 uint32_t Device::FindMemoryType(uint32_t type_filter, VkMemoryPropertyFlags properties) const {
@@ -124,7 +200,7 @@ VkResult Device::CreateBuffer(VkDeviceSize size,
     buffer_info.usage = usage;
     buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-    VkResult result = vkCreateBuffer(device_, &buffer_info, nullptr, &buffer);
+    VkResult result = vkCreateBuffer(device_, &buffer_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_BUFFER), &buffer);
     if (result != VK_SUCCESS) {
         return result;
     }
@@ -136,9 +212,15 @@ VkResult Device::CreateBuffer(VkDeviceSize size,
     alloc_info.allocationSize = mem_requirements.size;
     alloc_info.memoryTypeIndex = FindMemoryType(mem_requirements.memoryTypeBits, properties);
 
-    result = vkAllocateMemory(device_, &alloc_info, nullptr, &buffer_memory);
+    VkMemoryAllocateFlagsInfo flags_info{VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO};
+    if ((usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) != 0) {
+        flags_info.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+        alloc_info.pNext = &flags_info;
+    }
+
+    result = vkAllocateMemory(device_, &alloc_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_DEVICE_MEMORY), &buffer_memory);
     if (result != VK_SUCCESS) {
-        vkDestroyBuffer(device_, buffer, nullptr);
+        vkDestroyBuffer(device_, buffer, Utils::HostAllocator::For(VK_OBJECT_TYPE_BUFFER));
         buffer = VK_NULL_HANDLE;
         return result;
     }
@@ -169,7 +251,7 @@ VkResult Device::CreateImage(uint32_t width,
     image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
     image_info.samples = VK_SAMPLE_COUNT_1_BIT;
 
-    VkResult result = vkCreateImage(device_, &image_info, nullptr, &image);
+    VkResult result = vkCreateImage(device_, &image_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_IMAGE), &image);
     if (result != VK_SUCCESS) {
         return result;
     }
@@ -181,9 +263,9 @@ VkResult Device::CreateImage(uint32_t width,
     alloc_info.allocationSize = mem_requirements.size;
     alloc_info.memoryTypeIndex = FindMemoryType(mem_requirements.memoryTypeBits, properties);
 
-    result = vkAllocateMemory(device_, &alloc_info, nullptr, &image_memory);
+    result = vkAllocateMemory(device_, &alloc_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_DEVICE_MEMORY), &image_memory);
     if (result != VK_SUCCESS) {
-        vkDestroyImage(device_, image, nullptr);
+        vkDestroyImage(device_, image, Utils::HostAllocator::For(VK_OBJECT_TYPE_IMAGE));
         image = VK_NULL_HANDLE;
         return result;
     }
@@ -211,8 +293,16 @@ void Device::EndSingleTimeCommands(VkCommandBuffer command_buffer,
     submit_info.commandBufferCount = 1;
     submit_info.pCommandBuffers = &command_buffer;
 
-    vkQueueSubmit(submit_queue, 1, &submit_info, VK_NULL_HANDLE);
-    vkQueueWaitIdle(submit_queue);
+    {
+        const std::shared_ptr<std::mutex> queue_mutex = GetQueueMutex(submit_queue);
+        std::unique_lock<std::mutex> lock;
+        if (queue_mutex) {
+            lock = std::unique_lock<std::mutex>(*queue_mutex);
+        }
+        Utils::PerfCounters::AddSubmits();
+        dispatch_->vkQueueSubmit(submit_queue, 1, &submit_info, VK_NULL_HANDLE);
+        dispatch_->vkQueueWaitIdle(submit_queue);
+    }
 
     singleUseCommandPool_->FreeCommandBuffer(command_buffer);
 }
@@ -220,21 +310,7 @@ void Device::EndSingleTimeCommands(VkCommandBuffer command_buffer,
 VkFormat Device::FindSupportedFormat(const std::vector<VkFormat>& candidates,
                                      VkImageTiling tiling,
                                      VkFormatFeatureFlags features) const {
-    for (VkFormat format : candidates) {
-        VkFormatProperties props;
-        vkGetPhysicalDeviceFormatProperties(physicalDevice_.GetHandle(), format, &props);
-
-        if (tiling == VK_IMAGE_TILING_LINEAR &&
-            (props.linearTilingFeatures & features) == features) {
-            return format;
-        }
-        if (tiling == VK_IMAGE_TILING_OPTIMAL &&
-            (props.optimalTilingFeatures & features) == features) {
-            return format;
-        }
-    }
-
-    throw std::runtime_error("Failed to find supported format");
+    return Utils::FormatUtils::FindSupportedFormat(physicalDevice_.GetFormatTable(), candidates, tiling, features);
 }
 
 VkFormat Device::FindDepthFormat() const {
@@ -250,38 +326,348 @@ bool Device::HasStencilComponent(VkFormat format) const {
 
 void Device::CreateLogicalDevice(const std::vector<const char*>& required_extensions,
                                  const VkPhysicalDeviceFeatures& required_features,
-                                 const std::vector<const char*>& validation_layers) {
-    auto queue_create_infos = CreateQueueCreateInfos(queueFamilyIndices_);
+                                 const std::vector<const char*>& validation_layers,
+                                 const DeviceQueueConfig& queue_config) {
+    std::vector<std::vector<float>> queue_priorities;
+    auto queue_create_infos = CreateQueueCreateInfos(queueFamilyIndices_, queue_config, queue_priorities);
     VkPhysicalDeviceFeatures enabled_features = required_features;
     enabled_features.samplerAnisotropy = VK_TRUE;
 
+    // Timeline semaphores are core in Vulkan 1.2 but still have to be enabled explicitly
+    const VkPhysicalDeviceVulkan12Features& supported_vulkan12 = physicalDevice_.GetVulkan12Features();
+    const VkPhysicalDeviceDescriptorIndexingFeatures& supported_indexing = physicalDevice_.GetDescriptorIndexingFeatures();
+    VkPhysicalDeviceTimelineSemaphoreFeatures timeline_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES};
+    timeline_features.timelineSemaphore = supported_vulkan12.timelineSemaphore;
+
+    // Descriptor indexing (core in Vulkan 1.2) backs BindlessTable; only the bits it uses are enabled
+    VkPhysicalDeviceDescriptorIndexingFeatures indexing_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES};
+    indexing_features.runtimeDescriptorArray = supported_indexing.runtimeDescriptorArray;
+    indexing_features.descriptorBindingPartiallyBound = supported_indexing.descriptorBindingPartiallyBound;
+    indexing_features.descriptorBindingVariableDescriptorCount = supported_indexing.descriptorBindingVariableDescriptorCount;
+    indexing_features.descriptorBindingUpdateUnusedWhilePending = supported_indexing.descriptorBindingUpdateUnusedWhilePending;
+    indexing_features.descriptorBindingSampledImageUpdateAfterBind = supported_indexing.descriptorBindingSampledImageUpdateAfterBind;
+    indexing_features.descriptorBindingStorageImageUpdateAfterBind = supported_indexing.descriptorBindingStorageImageUpdateAfterBind;
+    indexing_features.descriptorBindingStorageBufferUpdateAfterBind = supported_indexing.descriptorBindingStorageBufferUpdateAfterBind;
+    indexing_features.shaderSampledImageArrayNonUniformIndexing = supported_indexing.shaderSampledImageArrayNonUniformIndexing;
+    indexing_features.shaderStorageImageArrayNonUniformIndexing = supported_indexing.shaderStorageImageArrayNonUniformIndexing;
+    indexing_features.shaderStorageBufferArrayNonUniformIndexing = supported_indexing.shaderStorageBufferArrayNonUniformIndexing;
+    timeline_features.pNext = &indexing_features;
+
+    // Buffer device addresses (core in Vulkan 1.2) back descriptor buffers and Buffer::GetDeviceAddress
+    VkPhysicalDeviceBufferDeviceAddressFeatures address_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES};
+    address_features.bufferDeviceAddress = supported_vulkan12.bufferDeviceAddress;
+    indexing_features.pNext = &address_features;
+
+    // Host query resets (core in Vulkan 1.2) let GpuProfiler recycle queries outside command buffers
+    VkPhysicalDeviceHostQueryResetFeatures host_query_reset_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_QUERY_RESET_FEATURES};
+    host_query_reset_features.hostQueryReset = supported_vulkan12.hostQueryReset;
+    address_features.pNext = &host_query_reset_features;
+
+    // Pull in extensions that requested ones depend on
+    std::vector<const char*> extensions = required_extensions;
+    std::vector<std::string> extension_names(extensions.begin(), extensions.end());
+    auto has_extension = [&extension_names](const char* name) {
+        return std::find(extension_names.begin(), extension_names.end(), name) != extension_names.end();
+    };
+    auto add_dependency = [&](const char* requested, const char* dependency) {
+        if (has_extension(requested) && !has_extension(dependency)) {
+            extensions.push_back(dependency);
+            extension_names.emplace_back(dependency);
+        }
+    };
+    add_dependency(VK_EXT_DEVICE_GENERATED_COMMANDS_EXTENSION_NAME, VK_KHR_MAINTENANCE_5_EXTENSION_NAME);
+    add_dependency(VK_KHR_MAINTENANCE_5_EXTENSION_NAME, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+    add_dependency(VK_KHR_PRESENT_WAIT_EXTENSION_NAME, VK_KHR_PRESENT_ID_EXTENSION_NAME);
+    add_dependency(VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME, VK_KHR_COPY_COMMANDS_2_EXTENSION_NAME);
+    add_dependency(VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME, VK_KHR_FORMAT_FEATURE_FLAGS_2_EXTENSION_NAME);
+    add_dependency(VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME, VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME);
+    add_dependency(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME, VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+    add_dependency(VK_EXT_SHADER_OBJECT_EXTENSION_NAME, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+    add_dependency(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+    add_dependency(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME, VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME);
+    add_dependency(VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME, VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME);
+    add_dependency(VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME, VK_KHR_MULTIVIEW_EXTENSION_NAME);
+    add_dependency(VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME, VK_KHR_MAINTENANCE_2_EXTENSION_NAME);
+
+    // Extension features are enabled whenever the device supports them
+    extensionFeatures_ = Utils::ResolveDeviceExtensionFeatures(physicalDevice_.GetHandle(), extension_names);
+    if (address_features.bufferDeviceAddress != VK_TRUE) {
+        // Descriptor buffers are bound by device address, as are generated command streams
+        extensionFeatures_.descriptorBuffer = false;
+        extensionFeatures_.deviceGeneratedCommands = false;
+        extensionFeatures_.dynamicGeneratedPipelineLayout = false;
+    }
+    void* feature_chain = &timeline_features;
+
+    VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT library_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT};
+    if (extensionFeatures_.graphicsPipelineLibrary) {
+        library_features.graphicsPipelineLibrary = VK_TRUE;
+        library_features.pNext = feature_chain;
+        feature_chain = &library_features;
+    }
+
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamic_rendering_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR};
+    if (extensionFeatures_.dynamicRendering) {
+        dynamic_rendering_features.dynamicRendering = VK_TRUE;
+        dynamic_rendering_features.pNext = feature_chain;
+        feature_chain = &dynamic_rendering_features;
+    }
+
+    const Utils::DeviceExtensionFeatures& ext = extensionFeatures_;
+    VkPhysicalDeviceExtendedDynamicStateFeaturesEXT dynamic_state_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT};
+    if (ext.extendedDynamicState) {
+        dynamic_state_features.extendedDynamicState = VK_TRUE;
+        dynamic_state_features.pNext = feature_chain;
+        feature_chain = &dynamic_state_features;
+    }
+
+    VkPhysicalDeviceExtendedDynamicState2FeaturesEXT dynamic_state2_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_2_FEATURES_EXT};
+    if (ext.extendedDynamicState2) {
+        dynamic_state2_features.extendedDynamicState2 = VK_TRUE;
+        dynamic_state2_features.extendedDynamicState2LogicOp = ext.extendedDynamicState2LogicOp ? VK_TRUE : VK_FALSE;
+        dynamic_state2_features.extendedDynamicState2PatchControlPoints = ext.extendedDynamicState2PatchControlPoints ? VK_TRUE : VK_FALSE;
+        dynamic_state2_features.pNext = feature_chain;
+        feature_chain = &dynamic_state2_features;
+    }
+
+    VkPhysicalDeviceExtendedDynamicState3FeaturesEXT dynamic_state3_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT};
+    dynamic_state3_features.extendedDynamicState3PolygonMode = ext.extendedDynamicState3PolygonMode ? VK_TRUE : VK_FALSE;
+    dynamic_state3_features.extendedDynamicState3DepthClampEnable = ext.extendedDynamicState3DepthClampEnable ? VK_TRUE : VK_FALSE;
+    dynamic_state3_features.extendedDynamicState3RasterizationSamples = ext.extendedDynamicState3RasterizationSamples ? VK_TRUE : VK_FALSE;
+    dynamic_state3_features.extendedDynamicState3AlphaToCoverageEnable = ext.extendedDynamicState3AlphaToCoverageEnable ? VK_TRUE : VK_FALSE;
+    dynamic_state3_features.extendedDynamicState3LogicOpEnable = ext.extendedDynamicState3LogicOpEnable ? VK_TRUE : VK_FALSE;
+    dynamic_state3_features.extendedDynamicState3ColorBlendEnable = ext.extendedDynamicState3ColorBlendEnable ? VK_TRUE : VK_FALSE;
+    dynamic_state3_features.extendedDynamicState3ColorBlendEquation = ext.extendedDynamicState3ColorBlendEquation ? VK_TRUE : VK_FALSE;
+    dynamic_state3_features.extendedDynamicState3ColorWriteMask = ext.extendedDynamicState3ColorWriteMask ? VK_TRUE : VK_FALSE;
+    if (has_extension(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME)) {
+        dynamic_state3_features.pNext = feature_chain;
+        feature_chain = &dynamic_state3_features;
+    }
+
+    VkPhysicalDeviceShaderObjectFeaturesEXT shader_object_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_FEATURES_EXT};
+    if (ext.shaderObject) {
+        shader_object_features.shaderObject = VK_TRUE;
+        shader_object_features.pNext = feature_chain;
+        feature_chain = &shader_object_features;
+    }
+
+    VkPhysicalDevicePipelineExecutablePropertiesFeaturesKHR executable_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_EXECUTABLE_PROPERTIES_FEATURES_KHR};
+    if (ext.pipelineExecutableInfo) {
+        executable_features.pipelineExecutableInfo = VK_TRUE;
+        executable_features.pNext = feature_chain;
+        feature_chain = &executable_features;
+    }
+
+    VkPhysicalDeviceDescriptorBufferFeaturesEXT descriptor_buffer_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT};
+    if (ext.descriptorBuffer) {
+        descriptor_buffer_features.descriptorBuffer = VK_TRUE;
+        descriptor_buffer_features.pNext = feature_chain;
+        feature_chain = &descriptor_buffer_features;
+    }
+
+    VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR};
+    if (ext.synchronization2) {
+        synchronization2_features.synchronization2 = VK_TRUE;
+        synchronization2_features.pNext = feature_chain;
+        feature_chain = &synchronization2_features;
+    }
+
+    VkPhysicalDeviceMultiDrawFeaturesEXT multi_draw_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTI_DRAW_FEATURES_EXT};
+    if (ext.multiDraw) {
+        multi_draw_features.multiDraw = VK_TRUE;
+        multi_draw_features.pNext = feature_chain;
+        feature_chain = &multi_draw_features;
+    }
+
+    VkPhysicalDeviceMaintenance5FeaturesKHR maintenance5_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MAINTENANCE_5_FEATURES_KHR};
+    if (ext.maintenance5) {
+        maintenance5_features.maintenance5 = VK_TRUE;
+        maintenance5_features.pNext = feature_chain;
+        feature_chain = &maintenance5_features;
+    }
+
+    VkPhysicalDeviceDeviceGeneratedCommandsFeaturesEXT generated_commands_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DEVICE_GENERATED_COMMANDS_FEATURES_EXT};
+    if (ext.deviceGeneratedCommands) {
+        generated_commands_features.deviceGeneratedCommands = VK_TRUE;
+        generated_commands_features.dynamicGeneratedPipelineLayout = ext.dynamicGeneratedPipelineLayout ? VK_TRUE : VK_FALSE;
+        generated_commands_features.pNext = feature_chain;
+        feature_chain = &generated_commands_features;
+    }
+
+    VkPhysicalDevicePresentIdFeaturesKHR present_id_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR};
+    if (ext.presentId) {
+        present_id_features.presentId = VK_TRUE;
+        present_id_features.pNext = feature_chain;
+        feature_chain = &present_id_features;
+    }
+
+    VkPhysicalDevicePresentWaitFeaturesKHR present_wait_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR};
+    if (ext.presentWait) {
+        present_wait_features.presentWait = VK_TRUE;
+        present_wait_features.pNext = feature_chain;
+        feature_chain = &present_wait_features;
+    }
+
+    VkPhysicalDeviceSwapchainMaintenance1FeaturesEXT swapchain_maintenance1_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SWAPCHAIN_MAINTENANCE_1_FEATURES_EXT};
+    if (ext.swapchainMaintenance1) {
+        swapchain_maintenance1_features.swapchainMaintenance1 = VK_TRUE;
+        swapchain_maintenance1_features.pNext = feature_chain;
+        feature_chain = &swapchain_maintenance1_features;
+    }
+
+    VkPhysicalDeviceHostImageCopyFeaturesEXT host_image_copy_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT};
+    if (ext.hostImageCopy) {
+        host_image_copy_features.hostImageCopy = VK_TRUE;
+        host_image_copy_features.pNext = feature_chain;
+        feature_chain = &host_image_copy_features;
+        QueryHostImageCopyLayouts();
+    }
+
+    VkPhysicalDeviceConditionalRenderingFeaturesEXT conditional_rendering_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_CONDITIONAL_RENDERING_FEATURES_EXT};
+    if (ext.conditionalRendering) {
+        conditional_rendering_features.conditionalRendering = VK_TRUE;
+        conditional_rendering_features.pNext = feature_chain;
+        feature_chain = &conditional_rendering_features;
+    }
+
+    VkPhysicalDeviceFragmentShadingRateFeaturesKHR fragment_shading_rate_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_FEATURES_KHR};
+    if (ext.pipelineFragmentShadingRate || ext.primitiveFragmentShadingRate || ext.attachmentFragmentShadingRate) {
+        fragment_shading_rate_features.pipelineFragmentShadingRate = ext.pipelineFragmentShadingRate ? VK_TRUE : VK_FALSE;
+        fragment_shading_rate_features.primitiveFragmentShadingRate = ext.primitiveFragmentShadingRate ? VK_TRUE : VK_FALSE;
+        fragment_shading_rate_features.attachmentFragmentShadingRate = ext.attachmentFragmentShadingRate ? VK_TRUE : VK_FALSE;
+        fragment_shading_rate_features.pNext = feature_chain;
+        feature_chain = &fragment_shading_rate_features;
+
+        VkPhysicalDeviceProperties2 properties2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2};
+        properties2.pNext = &fragmentShadingRateProperties_;
+        vkGetPhysicalDeviceProperties2(physicalDevice_.GetHandle(), &properties2);
+        fragmentShadingRateProperties_.pNext = nullptr;
+    }
+
+    // One logical device across the GPUs of a device group (core in Vulkan 1.1)
+    const std::vector<VkPhysicalDevice>& device_group = physicalDevice_.GetDeviceGroup();
+    VkDeviceGroupDeviceCreateInfo group_info{VK_STRUCTURE_TYPE_DEVICE_GROUP_DEVICE_CREATE_INFO};
+    if (device_group.size() > 1) {
+        group_info.physicalDeviceCount = static_cast<uint32_t>(device_group.size());
+        group_info.pPhysicalDevices = device_group.data();
+        group_info.pNext = feature_chain;
+        feature_chain = &group_info;
+    }
+
     VkDeviceCreateInfo create_info{VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+    create_info.pNext = feature_chain;
     create_info.queueCreateInfoCount = static_cast<uint32_t>(queue_create_infos.size());
     create_info.pQueueCreateInfos = queue_create_infos.data();
     create_info.pEnabledFeatures = &enabled_features;
-    create_info.enabledExtensionCount = static_cast<uint32_t>(required_extensions.size());
-    create_info.ppEnabledExtensionNames = required_extensions.empty() ? nullptr : required_extensions.data();
+    create_info.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+    create_info.ppEnabledExtensionNames = extensions.empty() ? nullptr : extensions.data();
     create_info.enabledLayerCount = static_cast<uint32_t>(validation_layers.size());
     create_info.ppEnabledLayerNames = validation_layers.empty() ? nullptr : validation_layers.data();
 
-    if (vkCreateDevice(physicalDevice_.GetHandle(), &create_info, nullptr, &device_) != VK_SUCCESS) {
+    if (vkCreateDevice(physicalDevice_.GetHandle(), &create_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_DEVICE), &device_) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create logical device");
     }
 
-    volkLoadDevice(device_);
+    deviceGroupSize_ = std::max<uint32_t>(1, group_info.physicalDeviceCount);
+    timelineSemaphoresEnabled_ = timeline_features.timelineSemaphore == VK_TRUE;
+    bufferDeviceAddressEnabled_ = address_features.bufferDeviceAddress == VK_TRUE;
+    hostQueryResetEnabled_ = host_query_reset_features.hostQueryReset == VK_TRUE;
+    enabledFeatures_ = enabled_features;
+    descriptorIndexingEnabled_ = indexing_features.runtimeDescriptorArray == VK_TRUE &&
+                                 indexing_features.descriptorBindingPartiallyBound == VK_TRUE &&
+                                 indexing_features.descriptorBindingVariableDescriptorCount == VK_TRUE &&
+                                 indexing_features.descriptorBindingUpdateUnusedWhilePending == VK_TRUE &&
+                                 indexing_features.descriptorBindingSampledImageUpdateAfterBind == VK_TRUE &&
+                                 indexing_features.descriptorBindingStorageImageUpdateAfterBind == VK_TRUE &&
+                                 indexing_features.descriptorBindingStorageBufferUpdateAfterBind == VK_TRUE;
+    enabledExtensions_ = std::unordered_set<std::string>(extension_names.begin(), extension_names.end());
+    dispatch_ = std::make_unique<VolkDeviceTable>();
+    volkLoadDeviceTable(dispatch_.get(), device_);
+    AcquireGlobalDispatch(device_);
+
+    for (const VkDeviceQueueCreateInfo& queue_info : queue_create_infos) {
+        for (uint32_t index = 0; index < queue_info.queueCount; ++index) {
+            queueMutexes_.emplace(GetQueue(queue_info.queueFamilyIndex, index), std::make_shared<std::mutex>());
+        }
+    }
 }
 
-std::vector<VkDeviceQueueCreateInfo> Device::CreateQueueCreateInfos(const QueueFamilyIndices& indices) const {
-    std::set<uint32_t> unique_families = indices.GetUniqueIndices();
-    float queue_priority = 1.0f;
-    std::vector<VkDeviceQueueCreateInfo> infos;
-    infos.reserve(unique_families.size());
+void Device::QueryHostImageCopyLayouts() {
+    // First call reports the counts, second fills the destination layouts
+    VkPhysicalDeviceHostImageCopyPropertiesEXT host_copy_properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_PROPERTIES_EXT};
+    VkPhysicalDeviceProperties2 properties2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2};
+    properties2.pNext = &host_copy_properties;
+    vkGetPhysicalDeviceProperties2(physicalDevice_.GetHandle(), &properties2);
+
+    hostImageCopyDstLayouts_.resize(host_copy_properties.copyDstLayoutCount);
+    host_copy_properties.copySrcLayoutCount = 0;
+    host_copy_properties.pCopyDstLayouts = hostImageCopyDstLayouts_.data();
+    vkGetPhysicalDeviceProperties2(physicalDevice_.GetHandle(), &properties2);
+    hostImageCopyDstLayouts_.resize(host_copy_properties.copyDstLayoutCount);
+}
+
+std::vector<VkDeviceQueueCreateInfo> Device::CreateQueueCreateInfos(const QueueFamilyIndices& indices,
+                                                                    const DeviceQueueConfig& queue_config,
+                                                                    std::vector<std::vector<float>>& priorities) {
+    const std::vector<VkQueueFamilyProperties>& family_properties = physicalDevice_.GetQueueFamilyProperties();
+    std::map<uint32_t, std::vector<float>> family_priorities; // One entry per requested queue
+
+    auto assign = [&](QueueType type, const std::optional<uint32_t>& family, const QueueRequest& request) {
+        std::vector<uint32_t>& role_indices = roleQueueIndices_[static_cast<size_t>(type)];
+        role_indices.clear();
+        if (!family.has_value()) {
+            return;
+        }
+        std::vector<float>& requested = family_priorities[family.value()];
+        for (uint32_t i = 0; i < std::max(request.count, 1u); ++i) {
+            role_indices.push_back(static_cast<uint32_t>(requested.size()));
+            float priority = 1.0f;
+            if (!request.priorities.empty()) {
+                priority = request.priorities[std::min<size_t>(i, request.priorities.size() - 1)];
+            }
+            requested.push_back(std::clamp(priority, 0.0f, 1.0f));
+        }
+    };
+    assign(QueueType::GRAPHICS, indices.graphicsFamily_, queue_config.graphics);
+    assign(QueueType::COMPUTE, indices.computeFamily_, queue_config.compute);
+    assign(QueueType::TRANSFER, indices.transferFamily_, queue_config.transfer);
+
+    std::vector<uint32_t>& present_indices = roleQueueIndices_[static_cast<size_t>(QueueType::PRESENT)];
+    present_indices.clear();
+    if (indices.presentFamily_.has_value()) {
+        std::vector<float>& requested = family_priorities[indices.presentFamily_.value()];
+        if (requested.empty()) {
+            requested.push_back(1.0f);
+        }
+        present_indices.push_back(0);
+    }
 
-    for (uint32_t family : unique_families) {
+    // Families with fewer queues than requested hand out what they have round robin
+    std::map<uint32_t, uint32_t> created_counts;
+    for (auto& [family, requested] : family_priorities) {
+        const uint32_t available = family < family_properties.size() ? family_properties[family].queueCount : 1u;
+        const uint32_t created = std::clamp(static_cast<uint32_t>(requested.size()), 1u, std::max(available, 1u));
+        requested.resize(created);
+        created_counts[family] = created;
+    }
+    const std::optional<uint32_t> role_families[] = {indices.graphicsFamily_, indices.presentFamily_,
+                                                      indices.computeFamily_, indices.transferFamily_};
+    for (size_t role = 0; role < roleQueueIndices_.size(); ++role) {
+        for (uint32_t& index : roleQueueIndices_[role]) {
+            index %= created_counts[role_families[role].value()];
+        }
+    }
+
+    std::vector<VkDeviceQueueCreateInfo> infos;
+    infos.reserve(family_priorities.size());
+    priorities.clear();
+    priorities.reserve(family_priorities.size());
+    for (auto& [family, requested] : family_priorities) {
+        priorities.push_back(std::move(requested));
         VkDeviceQueueCreateInfo queue_info{VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO};
         queue_info.queueFamilyIndex = family;
-        queue_info.queueCount = 1;
-        queue_info.pQueuePriorities = &queue_priority;
+        queue_info.queueCount = static_cast<uint32_t>(priorities.back().size());
+        queue_info.pQueuePriorities = priorities.back().data();
         infos.push_back(queue_info);
     }
 
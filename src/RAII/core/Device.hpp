@@ -3,25 +3,48 @@
 
 #include <volk.h>
 #include <vector>
+#include <array>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 
+#include "DeferredDestructionQueue.hpp"
+#include "Queue.hpp"
 #include "../types/QueueFamilyIndices.hpp" // Include the header that defines QueueFamilyIndices
 #include "../rendering/CommandPool.hpp"
+#include "../utils/CapabilityUtils.hpp"
 
 
 namespace VulkanEngine::RAII {
 
 class PhysicalDevice; // Forward declaration
 
+// Queues Device creates for one role. Missing priorities repeat the last one (1.0 when empty)
+struct QueueRequest {
+    uint32_t count{1};
+    std::vector<float> priorities{};
+};
+
+// Queues per role, so worker threads can submit in parallel instead of contending on one
+// queue (see QueueManager). Roles sharing a family get distinct queues of it while the
+// family has enough; beyond that the role's queues wrap around and are shared
+struct DeviceQueueConfig {
+    QueueRequest graphics{};
+    QueueRequest compute{};
+    QueueRequest transfer{};
+};
+
 class Device {
 public:
     // Constructor that creates a logical device from a physical device
     Device(const PhysicalDevice& physical_device,
            const std::vector<const char*>& required_extensions = {},
            const VkPhysicalDeviceFeatures& required_features = {},
-           const std::vector<const char*>& validation_layers = {});
+           const std::vector<const char*>& validation_layers = {},
+           const DeviceQueueConfig& queue_config = {});
 
     // Destructor
     ~Device();
@@ -48,9 +71,24 @@ public:
     // Get queue family indices
     [[nodiscard]]const QueueFamilyIndices& GetQueueFamilyIndices() const { return queueFamilyIndices_; }
 
-    // Wait for device to be idle
+    // Device-level entry points of this device (volkLoadDeviceTable). CommandBuffer, Queue
+    // and the sync helpers call through it, straight into the driver. The global vk*
+    // pointers are bound to the first device only while it is the sole live one and go
+    // through the loader otherwise, so several devices can share a process. The table
+    // keeps its address when the Device is moved
+    [[nodiscard]]const VolkDeviceTable& GetDispatch() const { return *dispatch_; }
+
+    // Wait for device to be idle; also destroys everything deferred with DeferDestroy
     void WaitIdle() const;
 
+    // Destroy object (moved in) once the frame being recorded has retired instead of
+    // right away while the GPU may still read it: DeferDestroy(std::move(old_buffer))
+    template <typename T>
+    void DeferDestroy(T&& object) const { deferredDestruction_->Defer(std::forward<T>(object)); }
+
+    // Renderer advances and collects the queue each frame; see DeferredDestructionQueue
+    [[nodiscard]] DeferredDestructionQueue& GetDeferredDestruction() const { return *deferredDestruction_; }
+
     // Get a queue from a specific family
     [[nodiscard]]VkQueue GetQueue(uint32_t queue_family_index, uint32_t queue_index = 0) const;
 
@@ -66,6 +104,17 @@ public:
     // Get transfer queue (if available)
     [[nodiscard]]VkQueue GetTransferQueue() const;
 
+    // Indices (within the role's family) of the queues created for a role, in request order;
+    // empty when the role has no family. Present always uses queue 0 of its family
+    [[nodiscard]]const std::vector<uint32_t>& GetQueueIndices(QueueType type) const {
+        return roleQueueIndices_[static_cast<size_t>(type)];
+    }
+
+    // vkQueueSubmit, vkQueuePresentKHR and vkQueueWaitIdle need the queue externally
+    // synchronized. Every created queue gets one mutex, shared by all Queue wrappers of it
+    // (QueueManager) and the single time command submits; null for foreign queues
+    [[nodiscard]]std::shared_ptr<std::mutex> GetQueueMutex(VkQueue queue) const;
+
     // Memory allocation helpers
     [[nodiscard]]uint32_t FindMemoryType(uint32_t type_filter, VkMemoryPropertyFlags properties) const;
 
@@ -115,20 +164,130 @@ public:
 
     [[nodiscard]]bool HasStencilComponent(VkFormat format) const;
 
+    // Number of GPUs the device spans (PhysicalDevice::GetDeviceGroup; 1 without a group)
+    [[nodiscard]]uint32_t GetDeviceGroupSize() const { return deviceGroupSize_; }
+
+    // Device mask addressing every GPU of the group (vkCmdSetDeviceMask, VkDeviceGroupSubmitInfo)
+    [[nodiscard]]uint32_t GetDeviceMask() const { return (1u << deviceGroupSize_) - 1u; }
+
+    // Check whether timeline semaphores were enabled on this device (Vulkan 1.2 core feature)
+    [[nodiscard]]bool SupportsTimelineSemaphores() const { return timelineSemaphoresEnabled_; }
+
+    // Check whether the descriptor indexing features BindlessTable needs were enabled (Vulkan 1.2 core)
+    [[nodiscard]]bool SupportsDescriptorIndexing() const { return descriptorIndexingEnabled_; }
+
+    // Check whether buffer device addresses were enabled (Vulkan 1.2 core feature)
+    [[nodiscard]]bool SupportsBufferDeviceAddress() const { return bufferDeviceAddressEnabled_; }
+
+    // Core features the device was created with
+    [[nodiscard]]const VkPhysicalDeviceFeatures& GetEnabledFeatures() const { return enabledFeatures_; }
+
+    // Check whether queries can be reset from the host (QueryPool::Reset, Vulkan 1.2 core feature)
+    [[nodiscard]]bool SupportsHostQueryReset() const { return hostQueryResetEnabled_; }
+
+    // Check whether a device extension was enabled (including ones added as dependencies)
+    [[nodiscard]]bool IsExtensionEnabled(const std::string& extension_name) const { return enabledExtensions_.contains(extension_name); }
+
+    // Extension features that were negotiated and enabled on this device
+    [[nodiscard]]const Utils::DeviceExtensionFeatures& GetExtensionFeatures() const { return extensionFeatures_; }
+
+    // Check whether VK_EXT_graphics_pipeline_library can be used (see PipelineLibraryLinker)
+    [[nodiscard]]bool SupportsGraphicsPipelineLibrary() const { return extensionFeatures_.graphicsPipelineLibrary; }
+
+    // Check whether VK_KHR_dynamic_rendering can be used (render pass-less pipelines and Renderer mode)
+    [[nodiscard]]bool SupportsDynamicRendering() const { return extensionFeatures_.dynamicRendering; }
+
+    // Check whether VK_EXT_shader_object can be used (see ShaderObject)
+    [[nodiscard]]bool SupportsShaderObject() const { return extensionFeatures_.shaderObject; }
+
+    // Check whether VK_EXT_descriptor_buffer can be used (see DescriptorBufferAllocator)
+    [[nodiscard]]bool SupportsDescriptorBuffer() const { return extensionFeatures_.descriptorBuffer; }
+
+    // Check whether VK_KHR_push_descriptor can be used (see DescriptorSetLayout::CreatePerDraw)
+    [[nodiscard]]bool SupportsPushDescriptor() const { return extensionFeatures_.pushDescriptor; }
+
+    // Check whether VK_KHR_synchronization2 can be used; without it the *2 barrier and
+    // submit paths are translated to the legacy calls (see Utils::SyncUtils)
+    [[nodiscard]]bool SupportsSynchronization2() const { return extensionFeatures_.synchronization2; }
+
+    // Check whether VK_KHR_draw_indirect_count can be used (CommandBuffer::Draw*IndirectCount)
+    [[nodiscard]]bool SupportsDrawIndirectCount() const { return extensionFeatures_.drawIndirectCount; }
+
+    // Check whether VK_EXT_multi_draw can be used (CommandBuffer::DrawMulti*)
+    [[nodiscard]]bool SupportsMultiDraw() const { return extensionFeatures_.multiDraw; }
+
+    // Check whether VK_EXT_device_generated_commands can be used (IndirectCommandsLayout,
+    // IndirectExecutionSet, CommandBuffer::ExecuteGeneratedCommands)
+    [[nodiscard]]bool SupportsDeviceGeneratedCommands() const { return extensionFeatures_.deviceGeneratedCommands; }
+
+    // Check whether VK_KHR_present_id and VK_KHR_present_wait can be used (Swapchain::WaitForPresent)
+    [[nodiscard]]bool SupportsPresentWait() const { return extensionFeatures_.presentWait; }
+
+    // Check whether VK_EXT_swapchain_maintenance1 can be used (present fences). The instance
+    // must enable VK_EXT_surface_maintenance1 for it
+    [[nodiscard]]bool SupportsSwapchainMaintenance1() const { return extensionFeatures_.swapchainMaintenance1; }
+
+    // Check whether VK_KHR_incremental_present can be used (damage rectangles in Swapchain::Present)
+    [[nodiscard]]bool SupportsIncrementalPresent() const { return extensionFeatures_.incrementalPresent; }
+
+    // Check whether VK_GOOGLE_display_timing can be used (Swapchain::GetPastPresentationTimings)
+    [[nodiscard]]bool SupportsDisplayTiming() const { return extensionFeatures_.displayTiming; }
+
+    // Check whether VK_EXT_host_image_copy can be used (Image::CopyFromMemory)
+    [[nodiscard]]bool SupportsHostImageCopy() const { return extensionFeatures_.hostImageCopy; }
+
+    // Layouts an image may be in while the host copies into it; empty without host image copies
+    [[nodiscard]]const std::vector<VkImageLayout>& GetHostImageCopyDstLayouts() const { return hostImageCopyDstLayouts_; }
+
+    // Check whether VK_EXT_conditional_rendering can be used (CommandBuffer::BeginConditionalRendering)
+    [[nodiscard]]bool SupportsConditionalRendering() const { return extensionFeatures_.conditionalRendering; }
+
+    // Check which VK_KHR_fragment_shading_rate sources can be used: the pipeline's
+    // (PipelineFragmentShadingRate, CommandBuffer::SetFragmentShadingRate), the primitive's
+    // (the PrimitiveShadingRateKHR built-in) and an attachment's (ShadingRateGenerator)
+    [[nodiscard]]bool SupportsPipelineFragmentShadingRate() const { return extensionFeatures_.pipelineFragmentShadingRate; }
+    [[nodiscard]]bool SupportsPrimitiveFragmentShadingRate() const { return extensionFeatures_.primitiveFragmentShadingRate; }
+    [[nodiscard]]bool SupportsAttachmentFragmentShadingRate() const { return extensionFeatures_.attachmentFragmentShadingRate; }
+
+    // Shading rate attachment texel sizes and combiner support; zeroed without the extension
+    [[nodiscard]]const VkPhysicalDeviceFragmentShadingRatePropertiesKHR& GetFragmentShadingRateProperties() const {
+        return fragmentShadingRateProperties_;
+    }
+
 private:
     VkDevice device_{VK_NULL_HANDLE};
     const PhysicalDevice& physicalDevice_;
     QueueFamilyIndices queueFamilyIndices_;
+    uint32_t deviceGroupSize_{1};
+    bool timelineSemaphoresEnabled_{false};
+    bool descriptorIndexingEnabled_{false};
+    bool bufferDeviceAddressEnabled_{false};
+    bool hostQueryResetEnabled_{false};
+    VkPhysicalDeviceFeatures enabledFeatures_{};
+    std::unordered_set<std::string> enabledExtensions_;
+    Utils::DeviceExtensionFeatures extensionFeatures_{};
+    std::vector<VkImageLayout> hostImageCopyDstLayouts_;
+    VkPhysicalDeviceFragmentShadingRatePropertiesKHR fragmentShadingRateProperties_{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_PROPERTIES_KHR};
+    std::unique_ptr<VolkDeviceTable> dispatch_;
+    std::array<std::vector<uint32_t>, 4> roleQueueIndices_{}; // By QueueType
+    std::unordered_map<VkQueue, std::shared_ptr<std::mutex>> queueMutexes_;
     // Transient/resettable command pool for one-off submissions
     std::unique_ptr<CommandPool> singleUseCommandPool_{};
+    // Heap allocated so references survive moving the Device
+    std::unique_ptr<DeferredDestructionQueue> deferredDestruction_{std::make_unique<DeferredDestructionQueue>()};
 
     // Helper methods
     void CreateLogicalDevice(const std::vector<const char*>& required_extensions,
                            const VkPhysicalDeviceFeatures& required_features,
-                           const std::vector<const char*>& validation_layers);
+                           const std::vector<const char*>& validation_layers,
+                           const DeviceQueueConfig& queue_config);
+    void QueryHostImageCopyLayouts();
 
+    // Also fills roleQueueIndices_; priorities backs the returned pQueuePriorities
     [[nodiscard]]std::vector<VkDeviceQueueCreateInfo> CreateQueueCreateInfos(
-        const QueueFamilyIndices& indices) const;
+        const QueueFamilyIndices& indices,
+        const DeviceQueueConfig& queue_config,
+        std::vector<std::vector<float>>& priorities);
 };
 
 } // namespace VulkanEngine::RAII
@@ -1,5 +1,7 @@
 #include "instance.hpp"
 
+#include "../utils/HostAllocator.hpp"
+
 #include <cstdint>
 #include <stdexcept>
 #include <string>
@@ -49,21 +51,22 @@ Instance::Instance(const std::string& application_name,
 
 Instance::~Instance() {
     if (instance_ != VK_NULL_HANDLE) {
-        vkDestroyInstance(instance_, nullptr);
+        vkDestroyInstance(instance_, Utils::HostAllocator::For(VK_OBJECT_TYPE_INSTANCE));
         instance_ = VK_NULL_HANDLE;
     }
 }
 
-Instance::Instance(Instance&& other) noexcept : instance_(other.instance_) {
+Instance::Instance(Instance&& other) noexcept : instance_(other.instance_), apiVersion_(other.apiVersion_) {
     other.instance_ = VK_NULL_HANDLE;
 }
 
 Instance& Instance::operator=(Instance&& other) noexcept {
     if (this != &other) {
         if (instance_ != VK_NULL_HANDLE) {
-            vkDestroyInstance(instance_, nullptr);
+            vkDestroyInstance(instance_, Utils::HostAllocator::For(VK_OBJECT_TYPE_INSTANCE));
         }
         instance_ = other.instance_;
+        apiVersion_ = other.apiVersion_;
         other.instance_ = VK_NULL_HANDLE;
     }
     return *this;
@@ -94,10 +97,11 @@ void Instance::CreateInstance(const std::string& application_name,
     create_info.enabledLayerCount = static_cast<uint32_t>(validation_layers.size());
     create_info.ppEnabledLayerNames = validation_layers.empty() ? nullptr : validation_layers.data();
 
-    VkResult result = vkCreateInstance(&create_info, nullptr, &instance_);
+    VkResult result = vkCreateInstance(&create_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_INSTANCE), &instance_);
     if (result != VK_SUCCESS) {
         throw std::runtime_error("Failed to create Vulkan instance");
     }
+    apiVersion_ = api_version;
 }
 
 bool Instance::CheckValidationLayerSupport(const std::vector<const char*>& validation_layers) {
@@ -2,113 +2,205 @@
 
 #include "instance.hpp"
 #include "types/QueueFamilyIndices.hpp"
+#include "../utils/Constants.hpp"
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <sstream>
 #include <stdexcept>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <utility>
 
 
 namespace VulkanEngine::RAII {
 
-PhysicalDevice::PhysicalDevice(const Instance& instance, VkSurfaceKHR surface)
-    : instance_(instance.GetHandle()) {
-    auto devices = EnumeratePhysicalDevices(instance);
-    if (devices.empty()) {
-        throw std::runtime_error("No Vulkan physical devices found");
+namespace {
+constexpr VkDeviceSize GIB = VkDeviceSize{1} << 30;
+
+bool IsPreferredType(VkPhysicalDeviceType type, DeviceSelectionPolicy::TypePreference preference) {
+    switch (preference) {
+        case DeviceSelectionPolicy::TypePreference::DISCRETE:
+            return type == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU;
+        case DeviceSelectionPolicy::TypePreference::INTEGRATED:
+            return type == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU;
+        case DeviceSelectionPolicy::TypePreference::ANY:
+            return false;
     }
+    return false;
+}
 
-    PhysicalDevice selected = SelectBestDevice(devices, surface);
-    if (!selected.IsValid()) {
-        throw std::runtime_error("Failed to select a suitable physical device");
+std::string JoinNames(const std::vector<std::string>& names) {
+    std::string joined;
+    for (const std::string& name : names) {
+        if (!joined.empty()) {
+            joined += ", ";
+        }
+        joined += name;
     }
+    return joined;
+}
+} // namespace
 
-    *this = selected;
+PhysicalDevice::PhysicalDevice(const Instance& instance, VkSurfaceKHR surface)
+    : PhysicalDevice(instance, DeviceSelectionPolicy{}, surface) {
+}
+
+PhysicalDevice::PhysicalDevice(const Instance& instance, const DeviceSelectionPolicy& policy, VkSurfaceKHR surface)
+    : instance_(instance.GetHandle()) {
+    SelectDevice(instance, policy, surface);
 }
 
 PhysicalDevice::PhysicalDevice(VkPhysicalDevice physical_device, const Instance& instance)
-    : physicalDevice_(physical_device), instance_(instance.GetHandle()) {}
+    : physicalDevice_(physical_device), instance_(instance.GetHandle()) {
+    if (physicalDevice_ != VK_NULL_HANDLE) {
+        QueryCapabilities(instance.GetApiVersion());
+    }
+}
 
-PhysicalDevice::PhysicalDevice(PhysicalDevice&& other) noexcept
-    : physicalDevice_(other.physicalDevice_), instance_(other.instance_) {
-    other.physicalDevice_ = VK_NULL_HANDLE;
-    other.instance_ = VK_NULL_HANDLE;
+PhysicalDevice::PhysicalDevice(PhysicalDevice&& other) noexcept {
+    *this = std::move(other);
 }
 
 PhysicalDevice& PhysicalDevice::operator=(PhysicalDevice&& other) noexcept {
     if (this != &other) {
         physicalDevice_ = other.physicalDevice_;
         instance_ = other.instance_;
+        apiVersion_ = other.apiVersion_;
+        properties_ = other.properties_;
+        vulkan11Properties_ = other.vulkan11Properties_;
+        vulkan12Properties_ = other.vulkan12Properties_;
+        vulkan13Properties_ = other.vulkan13Properties_;
+        subgroupProperties_ = other.subgroupProperties_;
+        descriptorIndexingProperties_ = other.descriptorIndexingProperties_;
+        idProperties_ = other.idProperties_;
+        features_ = other.features_;
+        vulkan11Features_ = other.vulkan11Features_;
+        vulkan12Features_ = other.vulkan12Features_;
+        vulkan13Features_ = other.vulkan13Features_;
+        descriptorIndexingFeatures_ = other.descriptorIndexingFeatures_;
+        memoryProperties_ = other.memoryProperties_;
+        memoryTypeTable_ = other.memoryTypeTable_;
+        formatTable_ = other.formatTable_;
+        queueFamilyProperties_ = std::move(other.queueFamilyProperties_);
+        availableExtensions_ = std::move(other.availableExtensions_);
+        deviceGroup_ = std::move(other.deviceGroup_);
         other.physicalDevice_ = VK_NULL_HANDLE;
         other.instance_ = VK_NULL_HANDLE;
     }
     return *this;
 }
 
-VkPhysicalDeviceProperties PhysicalDevice::GetProperties() const {
-    VkPhysicalDeviceProperties properties{};
-    vkGetPhysicalDeviceProperties(physicalDevice_, &properties);
-    return properties;
-}
-
-VkPhysicalDeviceFeatures PhysicalDevice::GetFeatures() const {
-    VkPhysicalDeviceFeatures features{};
-    vkGetPhysicalDeviceFeatures(physicalDevice_, &features);
-    return features;
-}
+void PhysicalDevice::QueryCapabilities(uint32_t instance_api_version) {
+    vkGetPhysicalDeviceProperties(physicalDevice_, &properties_);
+    apiVersion_ = std::min(properties_.apiVersion, instance_api_version);
 
-VkPhysicalDeviceMemoryProperties PhysicalDevice::GetMemoryProperties() const {
-    VkPhysicalDeviceMemoryProperties memory_properties{};
-    vkGetPhysicalDeviceMemoryProperties(physicalDevice_, &memory_properties);
-    return memory_properties;
-}
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice_, &memoryProperties_);
+    memoryTypeTable_ = Utils::MemoryTypeTable(memoryProperties_);
 
-std::vector<VkQueueFamilyProperties> PhysicalDevice::GetQueueFamilyProperties() const {
     uint32_t queue_family_count = 0;
     vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice_, &queue_family_count, nullptr);
-
-    std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
+    queueFamilyProperties_.resize(queue_family_count);
     if (queue_family_count > 0) {
-        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice_, &queue_family_count, queue_families.data());
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice_, &queue_family_count, queueFamilyProperties_.data());
+    }
+
+    uint32_t extension_count = 0;
+    vkEnumerateDeviceExtensionProperties(physicalDevice_, nullptr, &extension_count, nullptr);
+    availableExtensions_.resize(extension_count);
+    if (extension_count > 0) {
+        vkEnumerateDeviceExtensionProperties(physicalDevice_, nullptr, &extension_count, availableExtensions_.data());
     }
-    return queue_families;
+    formatTable_ = Utils::FormatTable(physicalDevice_, apiVersion_, availableExtensions_);
+
+    if (apiVersion_ < VK_API_VERSION_1_1 || !vkGetPhysicalDeviceProperties2 || !vkGetPhysicalDeviceFeatures2) {
+        vkGetPhysicalDeviceFeatures(physicalDevice_, &features_);
+        return;
+    }
+
+    const bool core_1_2 = apiVersion_ >= VK_API_VERSION_1_2;
+    const bool core_1_3 = apiVersion_ >= VK_API_VERSION_1_3;
+    const bool descriptor_indexing = core_1_2 || std::any_of(availableExtensions_.begin(), availableExtensions_.end(),
+        [](const VkExtensionProperties& extension) {
+            return std::string_view(extension.extensionName) == VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME;
+        });
+
+    VkPhysicalDeviceProperties2 properties2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2};
+    VkPhysicalDeviceFeatures2 features2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+    void** next_properties = &properties2.pNext;
+    void** next_features = &features2.pNext;
+    auto append = [](void**& next, auto& structure, bool condition) {
+        if (condition) {
+            *next = &structure;
+            next = &structure.pNext;
+        }
+    };
+    append(next_properties, subgroupProperties_, true);
+    append(next_properties, descriptorIndexingProperties_, descriptor_indexing);
+    append(next_properties, idProperties_, true);
+    append(next_properties, vulkan11Properties_, core_1_2);
+    append(next_properties, vulkan12Properties_, core_1_2);
+    append(next_properties, vulkan13Properties_, core_1_3);
+    append(next_features, descriptorIndexingFeatures_, descriptor_indexing);
+    append(next_features, vulkan11Features_, core_1_2);
+    append(next_features, vulkan12Features_, core_1_2);
+    append(next_features, vulkan13Features_, core_1_3);
+    vkGetPhysicalDeviceProperties2(physicalDevice_, &properties2);
+    vkGetPhysicalDeviceFeatures2(physicalDevice_, &features2);
+    features_ = features2.features;
+
+    // The chains pointed into this object; copies must not carry them along
+    subgroupProperties_.pNext = nullptr;
+    descriptorIndexingProperties_.pNext = nullptr;
+    idProperties_.pNext = nullptr;
+    vulkan11Properties_.pNext = nullptr;
+    vulkan12Properties_.pNext = nullptr;
+    vulkan13Properties_.pNext = nullptr;
+    descriptorIndexingFeatures_.pNext = nullptr;
+    vulkan11Features_.pNext = nullptr;
+    vulkan12Features_.pNext = nullptr;
+    vulkan13Features_.pNext = nullptr;
 }
 
 QueueFamilyIndices PhysicalDevice::FindQueueFamilies(VkSurfaceKHR surface) const {
     QueueFamilyIndices indices;
-    uint32_t queue_family_count = 0;
-    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice_, &queue_family_count, nullptr);
-
-    std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
-    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice_, &queue_family_count, queue_families.data());
+    const auto queue_family_count = static_cast<uint32_t>(queueFamilyProperties_.size());
+    const std::vector<VkQueueFamilyProperties>& queue_families = queueFamilyProperties_;
 
+    // Transfer ranks: 2 = DMA only (no graphics or compute, the copy engine), 1 = no graphics
+    int transfer_rank = 0;
     for (uint32_t i = 0; i < queue_family_count; ++i) {
         const auto& queue_family = queue_families[i];
+        if (queue_family.queueCount == 0) {
+            continue;
+        }
 
-        if (queue_family.queueCount > 0 && (queue_family.queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+        if (!indices.graphicsFamily_.has_value() && (queue_family.queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
             indices.graphicsFamily_ = i;
         }
 
-        if (queue_family.queueCount > 0 && (queue_family.queueFlags & VK_QUEUE_COMPUTE_BIT)) {
+        if (!indices.computeFamily_.has_value() && (queue_family.queueFlags & VK_QUEUE_COMPUTE_BIT)) {
             indices.computeFamily_ = i;
         }
 
-        if (queue_family.queueCount > 0 && (queue_family.queueFlags & VK_QUEUE_TRANSFER_BIT) &&
-            !(queue_family.queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
-            indices.transferFamily_ = i;
+        if ((queue_family.queueFlags & VK_QUEUE_TRANSFER_BIT) && !(queue_family.queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+            const int rank = (queue_family.queueFlags & VK_QUEUE_COMPUTE_BIT) ? 1 : 2;
+            if (rank > transfer_rank) {
+                indices.transferFamily_ = i;
+                transfer_rank = rank;
+            }
         }
 
         if (surface != VK_NULL_HANDLE) {
             VkBool32 present_support = VK_FALSE;
             vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice_, i, surface, &present_support);
-            if (queue_family.queueCount > 0 && present_support) {
+            // Prefer presenting from the graphics family so no ownership transfer is needed
+            if (present_support && (!indices.presentFamily_.has_value() || indices.graphicsFamily_ == i)) {
                 indices.presentFamily_ = i;
             }
         }
-
-        if (indices.IsComplete()) {
-            break;
-        }
     }
 
     if (!indices.presentFamily_.has_value() && indices.graphicsFamily_.has_value()) {
@@ -130,14 +222,8 @@ QueueFamilyIndices PhysicalDevice::FindQueueFamilies(VkSurfaceKHR surface) const
 }
 
 bool PhysicalDevice::CheckDeviceExtensionSupport(const std::vector<const char*>& required_extensions) const {
-    uint32_t extension_count = 0;
-    vkEnumerateDeviceExtensionProperties(physicalDevice_, nullptr, &extension_count, nullptr);
-
-    std::vector<VkExtensionProperties> available_extensions(extension_count);
-    vkEnumerateDeviceExtensionProperties(physicalDevice_, nullptr, &extension_count, available_extensions.data());
-
     std::vector<const char*> missing = required_extensions;
-    for (const VkExtensionProperties& extension : available_extensions) {
+    for (const VkExtensionProperties& extension : availableExtensions_) {
         std::vector<const char*>::iterator it = std::remove_if(missing.begin(), missing.end(), [&](const char* name) -> bool { // NOLINT
             return std::string(name) == extension.extensionName;
         });
@@ -150,15 +236,6 @@ bool PhysicalDevice::CheckDeviceExtensionSupport(const std::vector<const char*>&
     return missing.empty();
 }
 
-std::vector<VkExtensionProperties> PhysicalDevice::GetAvailableExtensions() const {
-    uint32_t extension_count = 0;
-    vkEnumerateDeviceExtensionProperties(physicalDevice_, nullptr, &extension_count, nullptr);
-
-    std::vector<VkExtensionProperties> extensions(extension_count);
-    vkEnumerateDeviceExtensionProperties(physicalDevice_, nullptr, &extension_count, extensions.data());
-    return extensions;
-}
-
 SwapChainSupportDetails PhysicalDevice::QuerySwapChainSupport(VkSurfaceKHR surface) const {
     SwapChainSupportDetails details{};
     vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice_, surface, &details.capabilities);
@@ -192,9 +269,7 @@ bool PhysicalDevice::IsDeviceSuitable(VkSurfaceKHR surface,
         swap_chain_adequate = !swapchain_support.formats.empty() && !swapchain_support.presentModes.empty();
     }
 
-    VkPhysicalDeviceFeatures supported_features = GetFeatures();
-
-    return indices.IsComplete() && extensions_supported && swap_chain_adequate && supported_features.samplerAnisotropy;
+    return indices.IsComplete() && extensions_supported && swap_chain_adequate && features_.samplerAnisotropy;
 }
 
 std::vector<PhysicalDevice> PhysicalDevice::EnumeratePhysicalDevices(const Instance& instance) {
@@ -217,64 +292,211 @@ std::vector<PhysicalDevice> PhysicalDevice::EnumeratePhysicalDevices(const Insta
 }
 
 uint32_t PhysicalDevice::FindMemoryType(uint32_t type_filter, VkMemoryPropertyFlags properties) const {
-    VkPhysicalDeviceMemoryProperties mem_properties{};
-    vkGetPhysicalDeviceMemoryProperties(physicalDevice_, &mem_properties);
+    return Utils::MemoryUtils::FindMemoryType(memoryTypeTable_, type_filter, properties);
+}
+
+std::vector<VkPhysicalDeviceGroupProperties> PhysicalDevice::EnumerateDeviceGroups(const Instance& instance) {
+    uint32_t group_count = 0;
+    vkEnumeratePhysicalDeviceGroups(instance.GetHandle(), &group_count, nullptr);
 
-    for (uint32_t i = 0; i < mem_properties.memoryTypeCount; ++i) {
-        if ((type_filter & (1u << i)) && (mem_properties.memoryTypes[i].propertyFlags & properties) == properties) {
-            return i;
+    std::vector<VkPhysicalDeviceGroupProperties> groups(group_count, {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GROUP_PROPERTIES});
+    if (group_count > 0) {
+        vkEnumeratePhysicalDeviceGroups(instance.GetHandle(), &group_count, groups.data());
+        groups.resize(group_count);
+    }
+    return groups;
+}
+
+std::array<uint8_t, VK_UUID_SIZE> PhysicalDevice::GetDeviceUuid() const {
+    std::array<uint8_t, VK_UUID_SIZE> uuid{};
+    std::memcpy(uuid.data(), idProperties_.deviceUUID, VK_UUID_SIZE);
+    return uuid;
+}
+
+VkDeviceSize PhysicalDevice::GetDeviceLocalMemorySize() const {
+    VkDeviceSize total = 0;
+    for (uint32_t i = 0; i < memoryProperties_.memoryHeapCount; ++i) {
+        if (memoryProperties_.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+            total += memoryProperties_.memoryHeaps[i].size;
         }
     }
+    return total;
+}
 
-    throw std::runtime_error("Failed to find suitable memory type");
+bool PhysicalDevice::HasDedicatedTransferQueue() const {
+    return std::any_of(queueFamilyProperties_.begin(), queueFamilyProperties_.end(), [](const VkQueueFamilyProperties& family) {
+        return family.queueCount > 0 && (family.queueFlags & VK_QUEUE_TRANSFER_BIT) &&
+               !(family.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT));
+    });
 }
 
-int PhysicalDevice::GetDeviceScore() const {
+bool PhysicalDevice::HasAsyncComputeQueue() const {
+    return std::any_of(queueFamilyProperties_.begin(), queueFamilyProperties_.end(), [](const VkQueueFamilyProperties& family) {
+        return family.queueCount > 0 && (family.queueFlags & VK_QUEUE_COMPUTE_BIT) && !(family.queueFlags & VK_QUEUE_GRAPHICS_BIT);
+    });
+}
+
+DeviceEvaluation PhysicalDevice::Evaluate(const DeviceSelectionPolicy& policy, VkSurfaceKHR surface) const {
+    DeviceEvaluation evaluation;
+    auto reject = [&evaluation](std::string reason) {
+        evaluation.rejection = std::move(reason);
+        return evaluation;
+    };
+
+    if (physicalDevice_ == VK_NULL_HANDLE) {
+        return reject("invalid device");
+    }
+    if (policy.deviceUuid.has_value() && *policy.deviceUuid != GetDeviceUuid()) {
+        return reject("not the requested device UUID");
+    }
+    if (apiVersion_ < policy.minApiVersion) {
+        std::ostringstream oss;
+        oss << "Vulkan " << VK_API_VERSION_MAJOR(apiVersion_) << '.' << VK_API_VERSION_MINOR(apiVersion_)
+            << " is below the required " << VK_API_VERSION_MAJOR(policy.minApiVersion) << '.'
+            << VK_API_VERSION_MINOR(policy.minApiVersion);
+        return reject(oss.str());
+    }
+
+    const VkDeviceSize device_local_bytes = GetDeviceLocalMemorySize();
+    if (device_local_bytes < policy.minDeviceLocalBytes) {
+        std::ostringstream oss;
+        oss << (device_local_bytes >> 20) << " MiB of device-local memory, " << (policy.minDeviceLocalBytes >> 20)
+            << " MiB required";
+        return reject(oss.str());
+    }
+
+    const bool dedicated_transfer = HasDedicatedTransferQueue();
+    const bool async_compute = HasAsyncComputeQueue();
+    if (policy.requireDedicatedTransferQueue && !dedicated_transfer) {
+        return reject("no dedicated transfer queue");
+    }
+    if (policy.requireAsyncComputeQueue && !async_compute) {
+        return reject("no async compute queue");
+    }
+
+    if (!FindQueueFamilies(surface).IsComplete()) {
+        return reject(surface != VK_NULL_HANDLE ? "no graphics queue that can present to the surface" : "no graphics queue");
+    }
+
+    std::vector<Utils::NamedCapabilityRequest> extension_requests;
+    extension_requests.reserve(policy.extensions.size() + 1);
+    if (surface != VK_NULL_HANDLE) {
+        extension_requests.push_back({Constants::SWAPCHAIN_EXTENSION, Utils::CapabilityRequirement::REQUIRED});
+    }
+    extension_requests.insert(extension_requests.end(), policy.extensions.begin(), policy.extensions.end());
+    std::vector<std::string> available_extensions;
+    available_extensions.reserve(availableExtensions_.size());
+    for (const VkExtensionProperties& extension : availableExtensions_) {
+        available_extensions.emplace_back(extension.extensionName);
+    }
+    Utils::NamedCapabilityResolution extensions = Utils::ResolveNamedCapabilities(extension_requests, available_extensions);
+    if (!extensions.missingRequired.empty()) {
+        return reject("missing extensions " + JoinNames(extensions.missingRequired));
+    }
+
+    Utils::FeatureResolution features = Utils::ResolveDeviceFeatures(features_, policy.requiredFeatures, policy.preferredFeatures);
+    if (!features.missingRequired.empty()) {
+        return reject("missing features " + JoinNames(features.missingRequired));
+    }
+
+    if (surface != VK_NULL_HANDLE) {
+        SwapChainSupportDetails swapchain_support = QuerySwapChainSupport(surface);
+        if (swapchain_support.formats.empty() || swapchain_support.presentModes.empty()) {
+            return reject("no surface formats or present modes");
+        }
+    }
+
+    const DeviceSelectionPolicy::Weights& weights = policy.weights;
     int score = 0;
-    VkPhysicalDeviceProperties properties = GetProperties();
-    VkPhysicalDeviceFeatures features = GetFeatures();
+    if (IsPreferredType(properties_.deviceType, policy.typePreference)) {
+        score += weights.preferredType;
+    }
+    score += static_cast<int>(device_local_bytes / GIB) * weights.perDeviceLocalGiB;
+
+    // Resolving against no support lists every preferred (and not required) bit as missing
+    const size_t preferred_feature_count =
+        Utils::ResolveDeviceFeatures({}, policy.requiredFeatures, policy.preferredFeatures).missingOptional.size();
+    score += static_cast<int>(preferred_feature_count - features.missingOptional.size()) * weights.preferredFeature;
+
+    size_t optional_extension_count = 0;
+    for (const Utils::NamedCapabilityRequest& request : extension_requests) {
+        if (request.requirement == Utils::CapabilityRequirement::OPTIONAL &&
+            std::find(extensions.enabled.begin(), extensions.enabled.end(), request.name) != extensions.enabled.end()) {
+            ++optional_extension_count;
+        }
+    }
+    score += static_cast<int>(optional_extension_count) * weights.optionalExtension;
 
-    if (properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) {
-        score += 1000;
+    if (dedicated_transfer) {
+        score += weights.dedicatedTransferQueue;
+    }
+    if (async_compute) {
+        score += weights.asyncComputeQueue;
     }
-    if (features.multiDrawIndirect) {
-        score += 200;
+    if (weights.maxImageDimension2DDivisor > 0) {
+        score += static_cast<int>(properties_.limits.maxImageDimension2D) / weights.maxImageDimension2DDivisor;
     }
 
-    score += static_cast<int>(properties.limits.maxImageDimension2D) / 4;
+    evaluation.suitable = true;
+    evaluation.score = std::max(score, 1);
+    return evaluation;
+}
 
-    if (!features.geometryShader) {
-        score = 0;
+std::vector<DeviceEvaluation> PhysicalDevice::EvaluateDevices(const std::vector<PhysicalDevice>& devices,
+                                                              const DeviceSelectionPolicy& policy,
+                                                              VkSurfaceKHR surface) {
+    std::vector<DeviceEvaluation> evaluations;
+    evaluations.reserve(devices.size());
+    for (const PhysicalDevice& device : devices) {
+        evaluations.push_back(device.Evaluate(policy, surface));
     }
+    return evaluations;
+}
 
-    return score;
+int PhysicalDevice::GetDeviceScore() const {
+    DeviceEvaluation evaluation = Evaluate(DeviceSelectionPolicy{});
+    return evaluation.suitable ? evaluation.score : 0;
 }
 
-PhysicalDevice PhysicalDevice::SelectBestDevice(const std::vector<PhysicalDevice>& devices,
-                                               VkSurfaceKHR surface) {
-    PhysicalDevice best;
-    int best_score = -1;
+void PhysicalDevice::SelectDevice(const Instance& instance, const DeviceSelectionPolicy& policy, VkSurfaceKHR surface) {
+    std::vector<PhysicalDevice> devices = EnumeratePhysicalDevices(instance);
+    if (devices.empty()) {
+        throw std::runtime_error("No Vulkan physical devices found");
+    }
 
-    for (const auto& device : devices) {
-        int score = device.GetDeviceScore();
-        if (score <= 0) {
-            continue;
+    std::vector<DeviceEvaluation> evaluations = EvaluateDevices(devices, policy, surface);
+    size_t best = devices.size();
+    for (size_t i = 0; i < devices.size(); ++i) {
+        if (evaluations[i].suitable && (best == devices.size() || evaluations[i].score > evaluations[best].score)) {
+            best = i;
         }
+    }
 
-        if (surface != VK_NULL_HANDLE) {
-            auto swapchain_support = device.QuerySwapChainSupport(surface);
-            if (swapchain_support.formats.empty() || swapchain_support.presentModes.empty()) {
-                continue;
-            }
+    if (best == devices.size()) {
+        std::ostringstream oss;
+        oss << "Failed to select a suitable physical device";
+        for (size_t i = 0; i < devices.size(); ++i) {
+            oss << (i == 0 ? ": " : "; ") << devices[i].GetProperties().deviceName << " (" << evaluations[i].rejection << ')';
         }
+        throw std::runtime_error(oss.str());
+    }
+
+    *this = std::move(devices[best]);
 
-        if (score > best_score) {
-            best_score = score;
-            best = device;
+    if (!policy.useDeviceGroup) {
+        return;
+    }
+    for (const VkPhysicalDeviceGroupProperties& group : EnumerateDeviceGroups(instance)) {
+        const VkPhysicalDevice* members_end = group.physicalDevices + group.physicalDeviceCount;
+        if (group.physicalDeviceCount < 2 || std::find(group.physicalDevices, members_end, physicalDevice_) == members_end) {
+            continue;
         }
+        deviceGroup_.push_back(physicalDevice_);
+        std::copy_if(group.physicalDevices, members_end, std::back_inserter(deviceGroup_), [this](VkPhysicalDevice member) {
+            return member != physicalDevice_;
+        });
+        break;
     }
-
-    return best;
 }
 
 } // namespace VulkanEngine::RAII
@@ -2,10 +2,17 @@
 #define VULKAN_RAII_CORE_PHYSICAL_DEVICE_HPP
 
 #include <volk.h>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
 #include <vector>
 #include <set>
 
 #include "types/QueueFamilyIndices.hpp" // Include the header that defines QueueFamilyIndices
+#include "utils/CapabilityUtils.hpp"
+#include "utils/FormatUtils.hpp"
+#include "utils/MemoryUtils.hpp"
 
 
 namespace VulkanEngine::RAII {
@@ -18,11 +25,71 @@ struct SwapChainSupportDetails {
     std::vector<VkPresentModeKHR> presentModes;
 };
 
+// What PhysicalDevice(instance, policy, surface) selects by. A device is suitable when it
+// meets every requirement; the suitable device with the highest score wins. The defaults
+// pick the device the plain constructor always picked: discrete GPUs first, geometry
+// shaders and anisotropic filtering required
+struct DeviceSelectionPolicy {
+    enum class TypePreference : std::uint8_t {
+        DISCRETE,
+        INTEGRATED,
+        ANY
+    };
+
+    // Score contributions; set one to 0 to ignore that property
+    struct Weights {
+        int preferredType = 1000;
+        int perDeviceLocalGiB = 50; // Per GiB in device-local heaps
+        int preferredFeature = 200; // Per supported preferredFeatures bit
+        int optionalExtension = 100; // Per available optional extension
+        int dedicatedTransferQueue = 100;
+        int asyncComputeQueue = 100;
+        int maxImageDimension2DDivisor = 4; // Adds maxImageDimension2D / divisor
+    };
+
+    // Selects exactly this device (VkPhysicalDeviceIDProperties::deviceUUID, e.g. from a
+    // config file or GetDeviceUuid() of an earlier run) and fails if it is missing or unsuitable
+    std::optional<std::array<uint8_t, VK_UUID_SIZE>> deviceUuid;
+    TypePreference typePreference = TypePreference::DISCRETE;
+    Weights weights{};
+
+    uint32_t minApiVersion = VK_API_VERSION_1_0;
+    VkDeviceSize minDeviceLocalBytes = 0;
+    bool requireDedicatedTransferQueue = false; // A transfer family without graphics or compute
+    bool requireAsyncComputeQueue = false; // A compute family without graphics
+
+    // VK_KHR_swapchain is added as required when selecting for a surface
+    std::vector<Utils::NamedCapabilityRequest> extensions;
+    VkPhysicalDeviceFeatures requiredFeatures{.geometryShader = VK_TRUE, .samplerAnisotropy = VK_TRUE};
+    VkPhysicalDeviceFeatures preferredFeatures{.multiDrawIndirect = VK_TRUE};
+
+    // Select the whole device group of the chosen device (vkEnumeratePhysicalDeviceGroups,
+    // core since Vulkan 1.1) so Device creates one logical device across all of its GPUs
+    // for split-frame or alternate-frame rendering
+    bool useDeviceGroup = false;
+};
+
+struct DeviceEvaluation {
+    bool suitable{false};
+    int score{0};
+    std::string rejection; // First requirement the device failed; empty when suitable
+};
+
+// Properties, features, memory properties, queue families and extensions are queried
+// once when the PhysicalDevice is constructed and returned from the cache afterwards.
+// The Vulkan 1.1/1.2/1.3 structures are filled up to the version both the instance
+// and the device support and left zeroed above it; subgroup and descriptor indexing
+// properties come through their own structures, which are also valid on Vulkan 1.1
+// devices exposing the extensions. Cached structures have a null pNext
 class PhysicalDevice {
 public:
     // Constructor that selects the best physical device from available devices
     explicit PhysicalDevice(const Instance& instance, VkSurfaceKHR surface = VK_NULL_HANDLE);
 
+    // Constructor that selects the best physical device according to policy. Throws with
+    // every device's rejection reason when none is suitable
+    PhysicalDevice(const Instance& instance, const DeviceSelectionPolicy& policy, VkSurfaceKHR surface = VK_NULL_HANDLE);
+
     // Constructor that wraps an existing VkPhysicalDevice
     PhysicalDevice(VkPhysicalDevice physical_device, const Instance& instance);
 
@@ -46,25 +113,61 @@ public:
     [[nodiscard]] bool IsValid() const { return physicalDevice_ != VK_NULL_HANDLE; }
 
     // Get device properties
-    [[nodiscard]] VkPhysicalDeviceProperties GetProperties() const;
+    [[nodiscard]] const VkPhysicalDeviceProperties& GetProperties() const { return properties_; }
+    [[nodiscard]] const VkPhysicalDeviceLimits& GetLimits() const { return properties_.limits; }
+    [[nodiscard]] const VkPhysicalDeviceVulkan11Properties& GetVulkan11Properties() const { return vulkan11Properties_; }
+    [[nodiscard]] const VkPhysicalDeviceVulkan12Properties& GetVulkan12Properties() const { return vulkan12Properties_; }
+    [[nodiscard]] const VkPhysicalDeviceVulkan13Properties& GetVulkan13Properties() const { return vulkan13Properties_; }
+    [[nodiscard]] const VkPhysicalDeviceSubgroupProperties& GetSubgroupProperties() const { return subgroupProperties_; }
+    [[nodiscard]] const VkPhysicalDeviceDescriptorIndexingProperties& GetDescriptorIndexingProperties() const {
+        return descriptorIndexingProperties_;
+    }
 
     // Get device features
-    [[nodiscard]] VkPhysicalDeviceFeatures GetFeatures() const;
+    [[nodiscard]] const VkPhysicalDeviceFeatures& GetFeatures() const { return features_; }
+    [[nodiscard]] const VkPhysicalDeviceVulkan11Features& GetVulkan11Features() const { return vulkan11Features_; }
+    [[nodiscard]] const VkPhysicalDeviceVulkan12Features& GetVulkan12Features() const { return vulkan12Features_; }
+    [[nodiscard]] const VkPhysicalDeviceVulkan13Features& GetVulkan13Features() const { return vulkan13Features_; }
+    [[nodiscard]] const VkPhysicalDeviceDescriptorIndexingFeatures& GetDescriptorIndexingFeatures() const {
+        return descriptorIndexingFeatures_;
+    }
+
+    // Identifiers that stay the same for this device across processes and APIs
+    [[nodiscard]] const VkPhysicalDeviceIDProperties& GetIDProperties() const { return idProperties_; }
+    [[nodiscard]] std::array<uint8_t, VK_UUID_SIZE> GetDeviceUuid() const;
+
+    // Lower of the instance's and the device's Vulkan version
+    [[nodiscard]] uint32_t GetApiVersion() const { return apiVersion_; }
 
     // Get device memory properties
-    [[nodiscard]] VkPhysicalDeviceMemoryProperties GetMemoryProperties() const;
+    [[nodiscard]] const VkPhysicalDeviceMemoryProperties& GetMemoryProperties() const { return memoryProperties_; }
+    [[nodiscard]] const Utils::MemoryTypeTable& GetMemoryTypeTable() const { return memoryTypeTable_; }
+
+    // Format features of every format, queried once at construction
+    [[nodiscard]] const Utils::FormatTable& GetFormatTable() const { return formatTable_; }
+
+    // Total size of the heaps with VK_MEMORY_HEAP_DEVICE_LOCAL_BIT
+    [[nodiscard]] VkDeviceSize GetDeviceLocalMemorySize() const;
 
     // Get queue family properties
-    [[nodiscard]] std::vector<VkQueueFamilyProperties> GetQueueFamilyProperties() const;
+    [[nodiscard]] const std::vector<VkQueueFamilyProperties>& GetQueueFamilyProperties() const { return queueFamilyProperties_; }
 
-    // Find queue families
+    // Find queue families. The transfer family prefers a DMA-only family (transfer without
+    // graphics or compute), then one without graphics, then falls back to graphics; present
+    // prefers the graphics family
     QueueFamilyIndices FindQueueFamilies(VkSurfaceKHR surface = VK_NULL_HANDLE) const;
 
+    // Check for a transfer-only family (copies that overlap graphics and compute work)
+    [[nodiscard]] bool HasDedicatedTransferQueue() const;
+
+    // Check for a compute family without graphics (compute that overlaps rendering)
+    [[nodiscard]] bool HasAsyncComputeQueue() const;
+
     // Check device extension support
     [[nodiscard]] bool CheckDeviceExtensionSupport(const std::vector<const char*>& required_extensions) const;
 
     // Get available device extensions
-    [[nodiscard]] std::vector<VkExtensionProperties> GetAvailableExtensions() const;
+    [[nodiscard]] const std::vector<VkExtensionProperties>& GetAvailableExtensions() const { return availableExtensions_; }
 
     // Query swap chain support
     SwapChainSupportDetails QuerySwapChainSupport(VkSurfaceKHR surface) const;
@@ -76,19 +179,54 @@ public:
     // Get all physical devices from instance
     static std::vector<PhysicalDevice> EnumeratePhysicalDevices(const Instance& instance);
 
+    // Get the device groups of the instance; single GPUs form a group of one
+    static std::vector<VkPhysicalDeviceGroupProperties> EnumerateDeviceGroups(const Instance& instance);
+
+    // Check the device against policy and score it
+    [[nodiscard]] DeviceEvaluation Evaluate(const DeviceSelectionPolicy& policy, VkSurfaceKHR surface = VK_NULL_HANDLE) const;
+
+    // Evaluate(policy, surface) of every device, in the order of devices
+    static std::vector<DeviceEvaluation> EvaluateDevices(const std::vector<PhysicalDevice>& devices,
+                                                         const DeviceSelectionPolicy& policy,
+                                                         VkSurfaceKHR surface = VK_NULL_HANDLE);
+
+    // Devices the logical device spans when selected with useDeviceGroup and the device
+    // is part of a group of more than one GPU; this device first. Empty otherwise
+    [[nodiscard]] const std::vector<VkPhysicalDevice>& GetDeviceGroup() const { return deviceGroup_; }
+
     // Find memory type index
     [[nodiscard]] uint32_t FindMemoryType(uint32_t type_filter, VkMemoryPropertyFlags properties) const;
 
-    // Get device score for device selection
+    // Get device score for device selection (Evaluate with the default policy; 0 if unsuitable)
     [[nodiscard]] int GetDeviceScore() const;
 
 private:
     VkPhysicalDevice physicalDevice_{VK_NULL_HANDLE};
     VkInstance instance_{VK_NULL_HANDLE}; // Reference to instance
+    uint32_t apiVersion_{0};
+
+    VkPhysicalDeviceProperties properties_{};
+    VkPhysicalDeviceVulkan11Properties vulkan11Properties_{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_PROPERTIES};
+    VkPhysicalDeviceVulkan12Properties vulkan12Properties_{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES};
+    VkPhysicalDeviceVulkan13Properties vulkan13Properties_{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_PROPERTIES};
+    VkPhysicalDeviceSubgroupProperties subgroupProperties_{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES};
+    VkPhysicalDeviceDescriptorIndexingProperties descriptorIndexingProperties_{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES};
+    VkPhysicalDeviceIDProperties idProperties_{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES};
+    VkPhysicalDeviceFeatures features_{};
+    VkPhysicalDeviceVulkan11Features vulkan11Features_{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES};
+    VkPhysicalDeviceVulkan12Features vulkan12Features_{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+    VkPhysicalDeviceVulkan13Features vulkan13Features_{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES};
+    VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures_{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES};
+    VkPhysicalDeviceMemoryProperties memoryProperties_{};
+    Utils::MemoryTypeTable memoryTypeTable_;
+    Utils::FormatTable formatTable_;
+    std::vector<VkQueueFamilyProperties> queueFamilyProperties_;
+    std::vector<VkExtensionProperties> availableExtensions_;
+    std::vector<VkPhysicalDevice> deviceGroup_;
 
     // Helper methods
-    static PhysicalDevice SelectBestDevice(const std::vector<PhysicalDevice>& devices, 
-                                         VkSurfaceKHR surface);
+    void QueryCapabilities(uint32_t instance_api_version);
+    void SelectDevice(const Instance& instance, const DeviceSelectionPolicy& policy, VkSurfaceKHR surface);
 };
 
 } // namespace VulkanEngine::RAII
@@ -3,15 +3,25 @@
 #include "Device.hpp"
 #include "PhysicalDevice.hpp"
 #include "types/QueueFamilyIndices.hpp"
+#include "../utils/DeviceDispatch.hpp"
+#include "../utils/PerfCounters.hpp"
+#include "../utils/Profiler.hpp"
+#include "../utils/SyncUtils.hpp"
 
 #include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <stdexcept>
 #include <vector>
 
 namespace VulkanEngine::RAII {
 
-Queue::Queue(VkQueue queue, uint32_t family_index, QueueType type)
-    : queue_(queue), familyIndex_(family_index), type_(type) {
+Queue::Queue(VkQueue queue, uint32_t family_index, QueueType type, bool synchronization2,
+             const VolkDeviceTable* dispatch, std::shared_ptr<std::mutex> submit_mutex)
+    : queue_(queue), familyIndex_(family_index), type_(type), synchronization2_(synchronization2), dispatch_(dispatch),
+      submitMutex_(submit_mutex ? std::move(submit_mutex) : std::make_shared<std::mutex>()) {
     switch (type) {
         case QueueType::GRAPHICS:
             capabilities_ = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT;
@@ -32,7 +42,10 @@ Queue::Queue(Queue&& other) noexcept
     : queue_(other.queue_),
       familyIndex_(other.familyIndex_),
       type_(other.type_),
-      capabilities_(other.capabilities_) {
+      capabilities_(other.capabilities_),
+      synchronization2_(other.synchronization2_),
+      dispatch_(other.dispatch_),
+      submitMutex_(std::move(other.submitMutex_)) {
     other.queue_ = VK_NULL_HANDLE;
     other.capabilities_ = 0;
 }
@@ -43,23 +56,29 @@ Queue& Queue::operator=(Queue&& other) noexcept {
         familyIndex_ = other.familyIndex_;
         type_ = other.type_;
         capabilities_ = other.capabilities_;
+        synchronization2_ = other.synchronization2_;
+        dispatch_ = other.dispatch_;
+        submitMutex_ = std::move(other.submitMutex_);
         other.queue_ = VK_NULL_HANDLE;
         other.capabilities_ = 0;
     }
     return *this;
 }
 
-VkResult Queue::Submit(const std::vector<VkCommandBuffer>& command_buffers,
-                       const std::vector<VkSemaphore>& wait_semaphores,
-                       const std::vector<VkPipelineStageFlags>& wait_stages,
-                       const std::vector<VkSemaphore>& signal_semaphores,
+VkResult Queue::Submit(std::span<const VkCommandBuffer> command_buffers,
+                       std::span<const VkSemaphore> wait_semaphores,
+                       std::span<const VkPipelineStageFlags> wait_stages,
+                       std::span<const VkSemaphore> signal_semaphores,
                        VkFence fence) const {
+    VULKAN_RAII_PROFILE_SCOPE("Queue::Submit");
     if (wait_semaphores.size() != wait_stages.size()) {
         throw std::runtime_error("Wait semaphores and stage masks size mismatch");
     }
 
     VkSubmitInfo submit_info = CreateSubmitInfo(command_buffers, wait_semaphores, wait_stages, signal_semaphores);
-    return vkQueueSubmit(queue_, 1, &submit_info, fence);
+    const std::unique_lock<std::mutex> lock = LockSubmission();
+    Utils::PerfCounters::AddSubmits();
+    return VULKAN_RAII_DEVICE_FN(dispatch_, vkQueueSubmit)(queue_, 1, &submit_info, fence);
 }
 
 VkResult Queue::Submit(VkCommandBuffer command_buffer,
@@ -67,56 +86,61 @@ VkResult Queue::Submit(VkCommandBuffer command_buffer,
                        VkPipelineStageFlags wait_stage,
                        VkSemaphore signal_semaphore,
                        VkFence fence) const {
-    std::vector<VkCommandBuffer> command_buffers{command_buffer};
-    std::vector<VkSemaphore> wait_semaphores;
-    std::vector<VkPipelineStageFlags> wait_stages;
-    std::vector<VkSemaphore> signal_semaphores;
-
-    if (wait_semaphore != VK_NULL_HANDLE) {
-        wait_semaphores.push_back(wait_semaphore);
-        wait_stages.push_back(wait_stage);
-    }
-    if (signal_semaphore != VK_NULL_HANDLE) {
-        signal_semaphores.push_back(signal_semaphore);
-    }
+    const size_t wait_count = wait_semaphore != VK_NULL_HANDLE ? 1 : 0;
+    const size_t signal_count = signal_semaphore != VK_NULL_HANDLE ? 1 : 0;
+    return Submit(std::span<const VkCommandBuffer>(&command_buffer, 1),
+                  std::span<const VkSemaphore>(&wait_semaphore, wait_count),
+                  std::span<const VkPipelineStageFlags>(&wait_stage, wait_count),
+                  std::span<const VkSemaphore>(&signal_semaphore, signal_count),
+                  fence);
+}
+
+VkResult Queue::Submit2(std::span<const VkSubmitInfo2KHR> submits, VkFence fence) const {
+    const std::unique_lock<std::mutex> lock = LockSubmission();
+    return Utils::SyncUtils::QueueSubmit2(queue_, submits, fence, synchronization2_, dispatch_);
+}
 
-    return Submit(command_buffers, wait_semaphores, wait_stages, signal_semaphores, fence);
+VkResult Queue::Submit2(const VkSubmitInfo2KHR& submit, VkFence fence) const {
+    return Submit2(std::span<const VkSubmitInfo2KHR>(&submit, 1), fence);
 }
 
-VkResult Queue::Present(const std::vector<VkSwapchainKHR>& swap_chains,
-                        const std::vector<uint32_t>& image_indices,
-                        const std::vector<VkSemaphore>& wait_semaphores) const {
+VkResult Queue::Present(std::span<const VkSwapchainKHR> swap_chains,
+                        std::span<const uint32_t> image_indices,
+                        std::span<const VkSemaphore> wait_semaphores) const {
     if (swap_chains.size() != image_indices.size()) {
         throw std::runtime_error("Swapchain and image index size mismatch");
     }
 
     VkPresentInfoKHR present_info = CreatePresentInfo(swap_chains, image_indices, wait_semaphores);
-    return vkQueuePresentKHR(queue_, &present_info);
+    const std::unique_lock<std::mutex> lock = LockSubmission();
+    return VULKAN_RAII_DEVICE_FN(dispatch_, vkQueuePresentKHR)(queue_, &present_info);
 }
 
 VkResult Queue::Present(VkSwapchainKHR swap_chain,
                         uint32_t image_index,
                         VkSemaphore wait_semaphore) const {
-    std::vector<VkSwapchainKHR> swap_chains{swap_chain};
-    std::vector<uint32_t> image_indices{image_index};
-    std::vector<VkSemaphore> wait_semaphores;
-    if (wait_semaphore != VK_NULL_HANDLE) {
-        wait_semaphores.push_back(wait_semaphore);
-    }
-    return Present(swap_chains, image_indices, wait_semaphores);
+    return Present(std::span<const VkSwapchainKHR>(&swap_chain, 1),
+                   std::span<const uint32_t>(&image_index, 1),
+                   std::span<const VkSemaphore>(&wait_semaphore, wait_semaphore != VK_NULL_HANDLE ? 1 : 0));
 }
 
 VkResult Queue::WaitIdle() const {
-    return vkQueueWaitIdle(queue_);
+    const std::unique_lock<std::mutex> lock = LockSubmission();
+    return VULKAN_RAII_DEVICE_FN(dispatch_, vkQueueWaitIdle)(queue_);
 }
 
-VkResult Queue::BindSparse(const std::vector<VkBindSparseInfo>& bind_info,
+VkResult Queue::BindSparse(std::span<const VkBindSparseInfo> bind_info,
                            VkFence fence) const {
-    return vkQueueBindSparse(queue_, static_cast<uint32_t>(bind_info.size()), bind_info.data(), fence);
+    const std::unique_lock<std::mutex> lock = LockSubmission();
+    return VULKAN_RAII_DEVICE_FN(dispatch_, vkQueueBindSparse)(queue_, static_cast<uint32_t>(bind_info.size()), bind_info.empty() ? nullptr : bind_info.data(), fence);
+}
+
+VkResult Queue::BindSparse(const VkBindSparseInfo& bind_info, VkFence fence) const {
+    return BindSparse(std::span<const VkBindSparseInfo>(&bind_info, 1), fence);
 }
 
 VkQueueFlags Queue::GetQueueCapabilities(const Device& device, uint32_t queue_family_index) {
-    auto properties = device.GetPhysicalDevice().GetQueueFamilyProperties();
+    const auto& properties = device.GetPhysicalDevice().GetQueueFamilyProperties();
     if (queue_family_index >= properties.size()) {
         return 0;
     }
@@ -135,10 +159,17 @@ bool Queue::SupportsTransfer() const {
     return (capabilities_ & VK_QUEUE_TRANSFER_BIT) != 0;
 }
 
-VkSubmitInfo Queue::CreateSubmitInfo(const std::vector<VkCommandBuffer>& command_buffers,
-                                     const std::vector<VkSemaphore>& wait_semaphores,
-                                     const std::vector<VkPipelineStageFlags>& wait_stages,
-                                     const std::vector<VkSemaphore>& signal_semaphores) const {
+std::unique_lock<std::mutex> Queue::LockSubmission() const {
+    if (!submitMutex_) {
+        return {};
+    }
+    return std::unique_lock<std::mutex>(*submitMutex_);
+}
+
+VkSubmitInfo Queue::CreateSubmitInfo(std::span<const VkCommandBuffer> command_buffers,
+                                     std::span<const VkSemaphore> wait_semaphores,
+                                     std::span<const VkPipelineStageFlags> wait_stages,
+                                     std::span<const VkSemaphore> signal_semaphores) const {
     VkSubmitInfo submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO};
     submit_info.commandBufferCount = static_cast<uint32_t>(command_buffers.size());
     submit_info.pCommandBuffers = command_buffers.data();
@@ -153,9 +184,9 @@ VkSubmitInfo Queue::CreateSubmitInfo(const std::vector<VkCommandBuffer>& command
     return submit_info;
 }
 
-VkPresentInfoKHR Queue::CreatePresentInfo(const std::vector<VkSwapchainKHR>& swap_chains,
-                                          const std::vector<uint32_t>& image_indices,
-                                          const std::vector<VkSemaphore>& wait_semaphores) const {
+VkPresentInfoKHR Queue::CreatePresentInfo(std::span<const VkSwapchainKHR> swap_chains,
+                                          std::span<const uint32_t> image_indices,
+                                          std::span<const VkSemaphore> wait_semaphores) const {
     VkPresentInfoKHR present_info{VK_STRUCTURE_TYPE_PRESENT_INFO_KHR};
     present_info.waitSemaphoreCount = static_cast<uint32_t>(wait_semaphores.size());
     present_info.pWaitSemaphores = wait_semaphores.empty() ? nullptr : wait_semaphores.data();
@@ -170,27 +201,38 @@ QueueManager::QueueManager(const Device& device) {
     InitializeQueues(device);
 }
 
-void QueueManager::InitializeQueues(const Device& device) {
-    QueueFamilyIndices indices = device.GetQueueFamilyIndices();
-    if (indices.graphicsFamily_.has_value()) {
-        VkQueue queue = device.GetGraphicsQueue();
-        graphicsQueue_ = Queue(queue, indices.graphicsFamily_.value(), QueueType::GRAPHICS);
-    }
-
-    if (indices.presentFamily_.has_value()) {
-        VkQueue queue = device.GetPresentQueue();
-        presentQueue_ = Queue(queue, indices.presentFamily_.value(), QueueType::PRESENT);
+const Queue& QueueManager::GetQueueForWorker(QueueType type, uint32_t worker_index) const {
+    static const Queue INVALID{};
+    const std::vector<Queue>& queues = GetQueues(type);
+    if (queues.empty()) {
+        return INVALID;
     }
+    return queues[worker_index % queues.size()];
+}
 
-    if (indices.computeFamily_.has_value()) {
-        VkQueue queue = device.GetComputeQueue();
-        computeQueue_ = Queue(queue, indices.computeFamily_.value(), QueueType::COMPUTE);
+void QueueManager::InitializeQueues(const Device& device) {
+    const QueueFamilyIndices& indices = device.GetQueueFamilyIndices();
+    const std::optional<uint32_t> families[] = {indices.graphicsFamily_, indices.presentFamily_,
+                                                indices.computeFamily_, indices.transferFamily_};
+    for (size_t role = 0; role < queues_.size(); ++role) {
+        const auto type = static_cast<QueueType>(role);
+        std::vector<Queue>& queues = queues_[role];
+        queues.clear();
+        if (!families[role].has_value()) {
+            continue;
+        }
+        for (uint32_t index : device.GetQueueIndices(type)) {
+            VkQueue queue = device.GetQueue(families[role].value(), index);
+            queues.emplace_back(queue, families[role].value(), type,
+                                device.SupportsSynchronization2(), &device.GetDispatch(), device.GetQueueMutex(queue));
+        }
     }
 
-    if (indices.transferFamily_.has_value()) {
-        VkQueue queue = device.GetTransferQueue();
-        transferQueue_ = Queue(queue, indices.transferFamily_.value(), QueueType::TRANSFER);
-    }
+    auto first = [this](QueueType type) { return GetQueues(type).empty() ? Queue{} : GetQueues(type).front(); };
+    graphicsQueue_ = first(QueueType::GRAPHICS);
+    presentQueue_ = first(QueueType::PRESENT);
+    computeQueue_ = first(QueueType::COMPUTE);
+    transferQueue_ = first(QueueType::TRANSFER);
 }
 
 } // namespace VulkanEngine::RAII
@@ -2,6 +2,10 @@
 #define VULKAN_RAII_CORE_QUEUE_HPP
 
 #include <volk.h>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <vector>
 
 
@@ -19,7 +23,12 @@ enum class QueueType {
 class Queue {
 public:
     // Constructor that wraps a VkQueue retrieved from a device
-    Queue(VkQueue queue, uint32_t family_index, QueueType type);
+    // synchronization2 selects vkQueueSubmit2KHR for Submit2 (Device::SupportsSynchronization2);
+    // submits and presents go through dispatch (Device::GetDispatch) when given. Submits,
+    // presents and waits lock submit_mutex (Device::GetQueueMutex), which every wrapper of
+    // the same VkQueue must share; a fresh one is made when none is given
+    Queue(VkQueue queue, uint32_t family_index, QueueType type, bool synchronization2 = false,
+          const VolkDeviceTable* dispatch = nullptr, std::shared_ptr<std::mutex> submit_mutex = nullptr);
 
     // Default constructor
     Queue() = default;
@@ -46,11 +55,12 @@ public:
     // Get queue type
     [[nodiscard]] QueueType GetType() const { return type_; }
 
-    // Submit command buffers to the queue
-    VkResult Submit(const std::vector<VkCommandBuffer>& command_buffers,
-                   const std::vector<VkSemaphore>& wait_semaphores = {},
-                   const std::vector<VkPipelineStageFlags>& wait_stages = {},
-                   const std::vector<VkSemaphore>& signal_semaphores = {},
+    // Submit command buffers to the queue (vectors and arrays convert to the spans;
+    // nothing is copied, so batch several submissions with SubmitBatch instead)
+    VkResult Submit(std::span<const VkCommandBuffer> command_buffers,
+                   std::span<const VkSemaphore> wait_semaphores = {},
+                   std::span<const VkPipelineStageFlags> wait_stages = {},
+                   std::span<const VkSemaphore> signal_semaphores = {},
                    VkFence fence = VK_NULL_HANDLE) const;
 
     // Submit a single command buffer
@@ -60,10 +70,16 @@ public:
                    VkSemaphore signal_semaphore = VK_NULL_HANDLE,
                    VkFence fence = VK_NULL_HANDLE) const;
 
+    // Submit with synchronization2 structures; translated to vkQueueSubmit when
+    // the device lacks VK_KHR_synchronization2 (see Utils::SyncUtils)
+    VkResult Submit2(std::span<const VkSubmitInfo2KHR> submits, VkFence fence = VK_NULL_HANDLE) const;
+
+    VkResult Submit2(const VkSubmitInfo2KHR& submit, VkFence fence = VK_NULL_HANDLE) const;
+
     // Present swap chain images (only valid for present queues)
-    [[nodiscard]] VkResult Present(const std::vector<VkSwapchainKHR>& swap_chains,
-                    const std::vector<uint32_t>& image_indices,
-                    const std::vector<VkSemaphore>& wait_semaphores = {}) const;
+    [[nodiscard]] VkResult Present(std::span<const VkSwapchainKHR> swap_chains,
+                    std::span<const uint32_t> image_indices,
+                    std::span<const VkSemaphore> wait_semaphores = {}) const;
 
     // Present single swap chain image
     VkResult Present(VkSwapchainKHR swap_chain,
@@ -74,9 +90,11 @@ public:
     [[nodiscard]] VkResult WaitIdle() const;
 
     // Bind sparse buffer memory
-    VkResult BindSparse(const std::vector<VkBindSparseInfo>& bind_info,
+    VkResult BindSparse(std::span<const VkBindSparseInfo> bind_info,
                        VkFence fence = VK_NULL_HANDLE) const;
 
+    VkResult BindSparse(const VkBindSparseInfo& bind_info, VkFence fence = VK_NULL_HANDLE) const;
+
     // Get queue capabilities based on family properties
     static VkQueueFlags GetQueueCapabilities(const Device& device, uint32_t queue_family_index);
 
@@ -85,21 +103,27 @@ public:
     [[nodiscard]] bool SupportsCompute() const;
     [[nodiscard]] bool SupportsTransfer() const;
 
+    // Hold the queue's submit mutex, e.g. around a raw vkQueueSubmit on GetHandle()
+    [[nodiscard]] std::unique_lock<std::mutex> LockSubmission() const;
+
 private:
     VkQueue queue_{VK_NULL_HANDLE};
     uint32_t familyIndex_{0};
     QueueType type_{QueueType::GRAPHICS};
     VkQueueFlags capabilities_{0}; // Cached queue capabilities
+    bool synchronization2_{false};
+    const VolkDeviceTable* dispatch_{nullptr};
+    std::shared_ptr<std::mutex> submitMutex_;
 
     // Helper methods
-    [[nodiscard]] VkSubmitInfo CreateSubmitInfo(const std::vector<VkCommandBuffer>& command_buffers,
-                                 const std::vector<VkSemaphore>& wait_semaphores,
-                                 const std::vector<VkPipelineStageFlags>& wait_stages,
-                                 const std::vector<VkSemaphore>& signal_semaphores) const;
-
-    [[nodiscard]] VkPresentInfoKHR CreatePresentInfo(const std::vector<VkSwapchainKHR>& swap_chains,
-                                      const std::vector<uint32_t>& image_indices,
-                                      const std::vector<VkSemaphore>& wait_semaphores) const;
+    [[nodiscard]] VkSubmitInfo CreateSubmitInfo(std::span<const VkCommandBuffer> command_buffers,
+                                 std::span<const VkSemaphore> wait_semaphores,
+                                 std::span<const VkPipelineStageFlags> wait_stages,
+                                 std::span<const VkSemaphore> signal_semaphores) const;
+
+    [[nodiscard]] VkPresentInfoKHR CreatePresentInfo(std::span<const VkSwapchainKHR> swap_chains,
+                                      std::span<const uint32_t> image_indices,
+                                      std::span<const VkSemaphore> wait_semaphores) const;
 };
 
 // Queue manager class to handle multiple queues
@@ -119,11 +143,27 @@ public:
     [[nodiscard]] bool HasComputeQueue() const { return computeQueue_.IsValid(); }
     [[nodiscard]] bool HasTransferQueue() const { return transferQueue_.IsValid(); }
 
+    // All queues Device created for a role (DeviceQueueConfig); the getters above return the first
+    [[nodiscard]] const std::vector<Queue>& GetQueues(QueueType type) const { return queues_[static_cast<size_t>(type)]; }
+    [[nodiscard]] uint32_t GetQueueCount(QueueType type) const { return static_cast<uint32_t>(GetQueues(type).size()); }
+
+    // Queue for a worker thread: worker_index picks round robin among the role's queues, so
+    // up to GetQueueCount workers submit without contending. Invalid when the role has none
+    [[nodiscard]] const Queue& GetQueueForWorker(QueueType type, uint32_t worker_index) const;
+
+    // True when transfers run on a family other than graphics, so exclusive resources
+    // handed between the two need Buffer/Image::ReleaseOwnership and AcquireOwnership
+    // (UploadManager and TextureStreamer record both halves themselves)
+    [[nodiscard]] bool HasDedicatedTransferQueue() const {
+        return HasTransferQueue() && HasGraphicsQueue() && transferQueue_.GetFamilyIndex() != graphicsQueue_.GetFamilyIndex();
+    }
+
 private:
     Queue graphicsQueue_;
     Queue presentQueue_;
     Queue computeQueue_;
     Queue transferQueue_;
+    std::array<std::vector<Queue>, 4> queues_{}; // By QueueType
 
     void InitializeQueues(const Device& device);
 };
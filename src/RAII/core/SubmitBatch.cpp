@@ -0,0 +1,99 @@
+#include "SubmitBatch.hpp"
+
+#include "Queue.hpp"
+#include "../utils/SyncUtils.hpp"
+
+#include <cstdint>
+#include <span>
+
+
+namespace VulkanEngine::RAII {
+
+SubmitBatch::SubmitBatch(const Queue& queue)
+    : queue_(&queue)
+{
+}
+
+SubmitBatch& SubmitBatch::NewSubmit()
+{
+    Submit submit{};
+    submit.firstWait = static_cast<uint32_t>(waits_.size());
+    submit.firstCommandBuffer = static_cast<uint32_t>(commandBuffers_.size());
+    submit.firstSignal = static_cast<uint32_t>(signals_.size());
+    submits_.push_back(submit);
+    return *this;
+}
+
+SubmitBatch& SubmitBatch::Wait(VkSemaphore semaphore, VkPipelineStageFlags2KHR stages, uint64_t value)
+{
+    Submit& submit = CurrentSubmit();
+    waits_.push_back(Utils::SyncUtils::CreateSemaphoreSubmitInfo(semaphore, stages, value));
+    ++submit.waitCount;
+    return *this;
+}
+
+SubmitBatch& SubmitBatch::AddCommandBuffer(VkCommandBuffer command_buffer)
+{
+    Submit& submit = CurrentSubmit();
+    VkCommandBufferSubmitInfoKHR info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO_KHR};
+    info.commandBuffer = command_buffer;
+    commandBuffers_.push_back(info);
+    ++submit.commandBufferCount;
+    return *this;
+}
+
+SubmitBatch& SubmitBatch::AddCommandBuffers(std::span<const VkCommandBuffer> command_buffers)
+{
+    for (VkCommandBuffer command_buffer : command_buffers) {
+        AddCommandBuffer(command_buffer);
+    }
+    return *this;
+}
+
+SubmitBatch& SubmitBatch::Signal(VkSemaphore semaphore, VkPipelineStageFlags2KHR stages, uint64_t value)
+{
+    Submit& submit = CurrentSubmit();
+    signals_.push_back(Utils::SyncUtils::CreateSemaphoreSubmitInfo(semaphore, stages, value));
+    ++submit.signalCount;
+    return *this;
+}
+
+VkResult SubmitBatch::Flush(VkFence fence)
+{
+    // The flat arrays are complete, so pointers into them stay valid for the call
+    submitInfos_.resize(submits_.size());
+    for (std::size_t i = 0; i < submits_.size(); ++i) {
+        const Submit& submit = submits_[i];
+        VkSubmitInfo2KHR& info = submitInfos_[i];
+        info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2_KHR;
+        info.waitSemaphoreInfoCount = submit.waitCount;
+        info.pWaitSemaphoreInfos = waits_.data() + submit.firstWait;
+        info.commandBufferInfoCount = submit.commandBufferCount;
+        info.pCommandBufferInfos = commandBuffers_.data() + submit.firstCommandBuffer;
+        info.signalSemaphoreInfoCount = submit.signalCount;
+        info.pSignalSemaphoreInfos = signals_.data() + submit.firstSignal;
+    }
+
+    const VkResult result = queue_->Submit2(submitInfos_.AsSpan(), fence);
+    Clear();
+    return result;
+}
+
+void SubmitBatch::Clear()
+{
+    submits_.clear();
+    waits_.clear();
+    commandBuffers_.clear();
+    signals_.clear();
+    submitInfos_.clear();
+}
+
+SubmitBatch::Submit& SubmitBatch::CurrentSubmit()
+{
+    if (submits_.empty()) {
+        NewSubmit();
+    }
+    return submits_[submits_.size() - 1];
+}
+
+} // namespace VulkanEngine::RAII
@@ -0,0 +1,74 @@
+#ifndef VULKAN_RAII_CORE_SUBMIT_BATCH_HPP
+#define VULKAN_RAII_CORE_SUBMIT_BATCH_HPP
+
+#include <volk.h>
+#include <cstdint>
+#include <span>
+
+#include "../utils/SmallVector.hpp"
+
+namespace VulkanEngine::RAII {
+
+class Queue; // Forward declaration
+
+// Builder for several logical submissions to one queue that reach the driver as a
+// single vkQueueSubmit2KHR (or vkQueueSubmit, see Queue::Submit2) call. Waits,
+// command buffers and signals are kept in inline storage, so a typical frame's
+// worth of submissions does not allocate; a batch kept alive across frames reuses
+// whatever it spilled to the heap. Submissions keep their order, and the fence
+// given to Flush() signals once all of them have completed.
+class SubmitBatch {
+public:
+    explicit SubmitBatch(const Queue& queue);
+
+    // Start a new submission; later waits, command buffers and signals belong to it.
+    // The first Wait/AddCommandBuffer/Signal of an empty batch starts one implicitly
+    SubmitBatch& NewSubmit();
+
+    // Wait on semaphore before stages of the current submission (value for timeline semaphores)
+    SubmitBatch& Wait(VkSemaphore semaphore, VkPipelineStageFlags2KHR stages, uint64_t value = 0);
+
+    SubmitBatch& AddCommandBuffer(VkCommandBuffer command_buffer);
+    SubmitBatch& AddCommandBuffers(std::span<const VkCommandBuffer> command_buffers);
+
+    // Signal semaphore once stages of the current submission complete
+    SubmitBatch& Signal(VkSemaphore semaphore,
+                        VkPipelineStageFlags2KHR stages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR,
+                        uint64_t value = 0);
+
+    // Submit everything in one call and empty the batch (also when the submit fails)
+    VkResult Flush(VkFence fence = VK_NULL_HANDLE);
+
+    // Drop the recorded submissions without submitting them
+    void Clear();
+
+    [[nodiscard]] uint32_t GetSubmitCount() const { return static_cast<uint32_t>(submits_.size()); }
+    [[nodiscard]] bool IsEmpty() const { return submits_.empty(); }
+
+private:
+    static constexpr std::size_t INLINE_SUBMITS = 8;
+    static constexpr std::size_t INLINE_ENTRIES = 16;
+
+    // Slices of the flat arrays below; pointers are only taken in Flush()
+    struct Submit {
+        uint32_t firstWait{0};
+        uint32_t waitCount{0};
+        uint32_t firstCommandBuffer{0};
+        uint32_t commandBufferCount{0};
+        uint32_t firstSignal{0};
+        uint32_t signalCount{0};
+    };
+
+    const Queue* queue_{nullptr};
+    Utils::SmallVector<Submit, INLINE_SUBMITS> submits_;
+    Utils::SmallVector<VkSemaphoreSubmitInfoKHR, INLINE_ENTRIES> waits_;
+    Utils::SmallVector<VkCommandBufferSubmitInfoKHR, INLINE_ENTRIES> commandBuffers_;
+    Utils::SmallVector<VkSemaphoreSubmitInfoKHR, INLINE_ENTRIES> signals_;
+    Utils::SmallVector<VkSubmitInfo2KHR, INLINE_SUBMITS> submitInfos_;
+
+    Submit& CurrentSubmit();
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_CORE_SUBMIT_BATCH_HPP
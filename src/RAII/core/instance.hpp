@@ -36,6 +36,9 @@ public:
     // Check if the instance is valid
     [[nodiscard]] bool IsValid() const { return instance_ != VK_NULL_HANDLE; }
 
+    // Vulkan version the instance was created for (VkApplicationInfo::apiVersion)
+    [[nodiscard]] uint32_t GetApiVersion() const { return apiVersion_; }
+
     // Get available extensions
     static std::vector<VkExtensionProperties> GetAvailableExtensions();
 
@@ -50,6 +53,7 @@ public:
 
 private:
     VkInstance instance_{VK_NULL_HANDLE};
+    uint32_t apiVersion_{0};
 
     // Helper methods
     void CreateInstance(const std::string& application_name,
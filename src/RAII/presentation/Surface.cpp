@@ -1,6 +1,7 @@
 #include "Surface.hpp"
 
 #include "../core/instance.hpp"
+#include "../utils/HostAllocator.hpp"
 #include <SDL3/SDL_vulkan.h>
 #include <SDL3/SDL_video.h>
 #include <cstdint>
@@ -105,7 +106,7 @@ bool Surface::IsVulkanSupported() {
 }
 
 void Surface::CreateSurfaceFromSdl(SDL_Window* window) {
-    if (!SDL_Vulkan_CreateSurface(window, reinterpret_cast<VkInstance>(instance_), nullptr, &surface_)) {
+    if (!SDL_Vulkan_CreateSurface(window, reinterpret_cast<VkInstance>(instance_), Utils::HostAllocator::For(VK_OBJECT_TYPE_SURFACE_KHR), &surface_)) {
         throw std::runtime_error("Failed to create Vulkan surface from SDL window");
     }
 }
@@ -116,7 +117,7 @@ void Surface::CreateSurface(void* /*windowHandle*/, void* /*platformHandle*/) {
 
 void Surface::Cleanup() {
     if (surface_ != VK_NULL_HANDLE && instance_ != VK_NULL_HANDLE) {
-        vkDestroySurfaceKHR(instance_, surface_, nullptr);
+        vkDestroySurfaceKHR(instance_, surface_, Utils::HostAllocator::For(VK_OBJECT_TYPE_SURFACE_KHR));
         surface_ = VK_NULL_HANDLE;
     }
 }
@@ -3,13 +3,18 @@
 #include "../core/Device.hpp"
 #include "../core/PhysicalDevice.hpp"
 #include "Surface.hpp"
+#include "../resources/Image.hpp"
+#include "../utils/Profiler.hpp"
 #include "types/QueueFamilyIndices.hpp"
+#include "../utils/HostAllocator.hpp"
 
 #include <SDL3/SDL_video.h>
 // #include <SDL3/SDL_vulkan.h>
 #include <algorithm>
 #include <cstdint>
 #include <limits>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <utility>
 #include <vector>
@@ -18,6 +23,62 @@
 
 namespace VulkanEngine::RAII {
 
+RetiredSwapchain::RetiredSwapchain(VkDevice device,
+                                   VkSwapchainKHR swapchain,
+                                   std::vector<VkImageView> image_views,
+                                   std::vector<std::unique_ptr<Image>> offscreen_images)
+    : device_(device),
+    swapchain_(swapchain),
+    imageViews_(std::move(image_views)),
+    offscreenImages_(std::move(offscreen_images)) {}
+
+RetiredSwapchain::~RetiredSwapchain() {
+    Cleanup();
+}
+
+RetiredSwapchain::RetiredSwapchain(RetiredSwapchain&& other) noexcept
+    : device_(other.device_),
+    swapchain_(other.swapchain_),
+    imageViews_(std::move(other.imageViews_)),
+    offscreenImages_(std::move(other.offscreenImages_))
+{
+    other.device_ = VK_NULL_HANDLE;
+    other.swapchain_ = VK_NULL_HANDLE;
+    other.imageViews_.clear();
+    other.offscreenImages_.clear();
+}
+
+RetiredSwapchain& RetiredSwapchain::operator=(RetiredSwapchain&& other) noexcept {
+    if (this != &other) {
+        Cleanup();
+        device_ = other.device_;
+        swapchain_ = other.swapchain_;
+        imageViews_ = std::move(other.imageViews_);
+        offscreenImages_ = std::move(other.offscreenImages_);
+        other.device_ = VK_NULL_HANDLE;
+        other.swapchain_ = VK_NULL_HANDLE;
+        other.imageViews_.clear();
+        other.offscreenImages_.clear();
+    }
+    return *this;
+}
+
+void RetiredSwapchain::Cleanup() {
+    for (VkImageView view : imageViews_) {
+        if (view != VK_NULL_HANDLE) {
+            vkDestroyImageView(device_, view, Utils::HostAllocator::For(VK_OBJECT_TYPE_IMAGE_VIEW));
+        }
+    }
+    imageViews_.clear();
+    offscreenImages_.clear();
+
+    if (swapchain_ != VK_NULL_HANDLE) {
+        vkDestroySwapchainKHR(device_, swapchain_, Utils::HostAllocator::For(VK_OBJECT_TYPE_SWAPCHAIN_KHR));
+        swapchain_ = VK_NULL_HANDLE;
+    }
+    device_ = VK_NULL_HANDLE;
+}
+
 Swapchain::Swapchain(const Device& device,
                      const Surface& surface,
                      SDL_Window* window,
@@ -61,6 +122,28 @@ Swapchain::Swapchain(const Device& device,
     CreateImageViews();
 }
 
+Swapchain::Swapchain(const Device& device,
+                     uint32_t width,
+                     uint32_t height,
+                     VkFormat format,
+                     uint32_t image_count,
+                     VkImageUsageFlags usage)
+    : device_(device.GetHandle()),
+    deviceRef_(&device),
+    imageFormat_(format),
+    presentMode_(VK_PRESENT_MODE_IMMEDIATE_KHR),
+    minImageCount_(image_count),
+    surfaceFormat_{format, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR},
+    headless_(true),
+    offscreenUsage_(usage | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT)
+{
+    if (width == 0 || height == 0 || image_count == 0) {
+        throw std::invalid_argument("Headless swapchain requires a non-zero extent and image count");
+    }
+    CreateOffscreenImages(width, height);
+    CreateImageViews();
+}
+
 Swapchain::~Swapchain() {
     Cleanup();
 }
@@ -77,7 +160,12 @@ Swapchain::Swapchain(Swapchain&& other) noexcept
     presentMode_(other.presentMode_),
     minImageCount_(other.minImageCount_),
     surfaceFormat_(other.surfaceFormat_),
-    needsRecreate_(other.needsRecreate_)
+    needsRecreate_(other.needsRecreate_),
+    headless_(other.headless_),
+    offscreenUsage_(other.offscreenUsage_),
+    offscreenImages_(std::move(other.offscreenImages_)),
+    nextOffscreenImage_(other.nextOffscreenImage_),
+    lastPresentedImage_(other.lastPresentedImage_)
 {
     other.swapchain_ = VK_NULL_HANDLE;
     other.device_ = VK_NULL_HANDLE;
@@ -88,6 +176,8 @@ Swapchain::Swapchain(Swapchain&& other) noexcept
     other.extent_ = {0, 0};
     other.minImageCount_ = 0;
     other.needsRecreate_ = false;
+    other.headless_ = false;
+    other.offscreenImages_.clear();
 }
 
 Swapchain& Swapchain::operator=(Swapchain&& other) noexcept {
@@ -105,6 +195,11 @@ Swapchain& Swapchain::operator=(Swapchain&& other) noexcept {
         surfaceFormat_ = other.surfaceFormat_;
         minImageCount_ = other.minImageCount_;
         needsRecreate_ = other.needsRecreate_;
+        headless_ = other.headless_;
+        offscreenUsage_ = other.offscreenUsage_;
+        offscreenImages_ = std::move(other.offscreenImages_);
+        nextOffscreenImage_ = other.nextOffscreenImage_;
+        lastPresentedImage_ = other.lastPresentedImage_;
 
         other.swapchain_ = VK_NULL_HANDLE;
         other.device_ = VK_NULL_HANDLE;
@@ -115,11 +210,22 @@ Swapchain& Swapchain::operator=(Swapchain&& other) noexcept {
         other.extent_ = {0, 0};
         other.minImageCount_ = 0;
         other.needsRecreate_ = false;
+        other.headless_ = false;
+        other.offscreenImages_.clear();
     }
     return *this;
 }
 
 std::vector<VkImage> Swapchain::GetImages() const {
+    if (headless_) {
+        std::vector<VkImage> images;
+        images.reserve(offscreenImages_.size());
+        for (const auto& image : offscreenImages_) {
+            images.push_back(image->GetHandle());
+        }
+        return images;
+    }
+
     uint32_t image_count = 0;
     vkGetSwapchainImagesKHR(device_, swapchain_, &image_count, nullptr);
     std::vector<VkImage> images(image_count);
@@ -129,12 +235,82 @@ std::vector<VkImage> Swapchain::GetImages() const {
     return images;
 }
 
+const Image& Swapchain::GetOffscreenImage(uint32_t index) const {
+    if (!headless_) {
+        throw std::logic_error("Only headless swapchains own offscreen images");
+    }
+    if (index >= offscreenImages_.size()) {
+        throw std::out_of_range("Offscreen image index out of range");
+    }
+    return *offscreenImages_[index];
+}
+
 VkResult Swapchain::AcquireNextImage(uint64_t timeout, VkSemaphore semaphore, VkFence fence, uint32_t& image_index) const {
+    VULKAN_RAII_PROFILE_SCOPE("Swapchain::AcquireNextImage");
+    if (headless_) {
+        if (semaphore != VK_NULL_HANDLE || fence != VK_NULL_HANDLE) {
+            throw std::invalid_argument("Headless swapchains cannot signal an acquire semaphore or fence");
+        }
+        // Round robin: the image was last handed out GetImageCount() acquires ago
+        image_index = nextOffscreenImage_;
+        nextOffscreenImage_ = (nextOffscreenImage_ + 1) % GetImageCount();
+        return VK_SUCCESS;
+    }
     return vkAcquireNextImageKHR(device_, swapchain_, timeout, semaphore, fence, &image_index);
 }
 
-VkResult Swapchain::Present(const std::vector<VkSemaphore>& wait_semaphores, uint32_t image_index, VkQueue present_queue) const {
+VkResult Swapchain::Present(const std::vector<VkSemaphore>& wait_semaphores,
+                            uint32_t image_index,
+                            VkQueue present_queue,
+                            uint64_t present_id,
+                            VkFence present_fence,
+                            std::span<const VkRectLayerKHR> damage) const {
+    VULKAN_RAII_PROFILE_SCOPE("Swapchain::Present");
+    if (headless_) {
+        if (!wait_semaphores.empty() || present_fence != VK_NULL_HANDLE) {
+            throw std::invalid_argument("Headless swapchains do not wait on semaphores or signal present fences");
+        }
+        lastPresentedImage_ = image_index;
+        return VK_SUCCESS;
+    }
+
     VkPresentInfoKHR present_info{VK_STRUCTURE_TYPE_PRESENT_INFO_KHR};
+    VkPresentIdKHR present_id_info{VK_STRUCTURE_TYPE_PRESENT_ID_KHR};
+    if (present_id != 0 && SupportsPresentWait()) {
+        present_id_info.swapchainCount = 1;
+        present_id_info.pPresentIds = &present_id;
+        present_id_info.pNext = present_info.pNext;
+        present_info.pNext = &present_id_info;
+    }
+    VkSwapchainPresentFenceInfoEXT present_fence_info{VK_STRUCTURE_TYPE_SWAPCHAIN_PRESENT_FENCE_INFO_EXT};
+    if (present_fence != VK_NULL_HANDLE) {
+        if (deviceRef_ == nullptr || !deviceRef_->SupportsSwapchainMaintenance1()) {
+            throw std::runtime_error("Present fences require VK_EXT_swapchain_maintenance1");
+        }
+        present_fence_info.swapchainCount = 1;
+        present_fence_info.pFences = &present_fence;
+        present_fence_info.pNext = present_info.pNext;
+        present_info.pNext = &present_fence_info;
+    }
+    VkPresentTimeGOOGLE present_time{};
+    VkPresentTimesInfoGOOGLE present_times{VK_STRUCTURE_TYPE_PRESENT_TIMES_INFO_GOOGLE};
+    if (present_id != 0 && SupportsDisplayTiming()) {
+        present_time.presentID = static_cast<uint32_t>(present_id);
+        present_times.swapchainCount = 1;
+        present_times.pTimes = &present_time;
+        present_times.pNext = present_info.pNext;
+        present_info.pNext = &present_times;
+    }
+    VkPresentRegionKHR present_region{};
+    VkPresentRegionsKHR present_regions{VK_STRUCTURE_TYPE_PRESENT_REGIONS_KHR};
+    if (!damage.empty() && SupportsIncrementalPresent()) {
+        present_region.rectangleCount = static_cast<uint32_t>(damage.size());
+        present_region.pRectangles = damage.data();
+        present_regions.swapchainCount = 1;
+        present_regions.pRegions = &present_region;
+        present_regions.pNext = present_info.pNext;
+        present_info.pNext = &present_regions;
+    }
     present_info.waitSemaphoreCount = static_cast<uint32_t>(wait_semaphores.size());
     present_info.pWaitSemaphores = wait_semaphores.empty() ? nullptr : wait_semaphores.data();
     present_info.swapchainCount = 1;
@@ -142,10 +318,76 @@ VkResult Swapchain::Present(const std::vector<VkSemaphore>& wait_semaphores, uin
     present_info.pImageIndices = &image_index;
     present_info.pResults = nullptr;
 
+    const std::shared_ptr<std::mutex> queue_mutex = deviceRef_ ? deviceRef_->GetQueueMutex(present_queue) : nullptr;
+    std::unique_lock<std::mutex> lock;
+    if (queue_mutex) {
+        lock = std::unique_lock<std::mutex>(*queue_mutex);
+    }
     return vkQueuePresentKHR(present_queue, &present_info);
 }
 
-void Swapchain::Recreate(SDL_Window* window) {
+VkResult Swapchain::WaitForPresent(uint64_t present_id, uint64_t timeout) const {
+    if (!SupportsPresentWait()) {
+        throw std::runtime_error("Present wait is not enabled on this device");
+    }
+    return vkWaitForPresentKHR(device_, swapchain_, present_id, timeout);
+}
+
+bool Swapchain::SupportsPresentWait() const {
+    return !headless_ && deviceRef_ != nullptr && deviceRef_->SupportsPresentWait();
+}
+
+bool Swapchain::SupportsIncrementalPresent() const {
+    return !headless_ && deviceRef_ != nullptr && deviceRef_->SupportsIncrementalPresent();
+}
+
+std::vector<VkPastPresentationTimingGOOGLE> Swapchain::GetPastPresentationTimings() const {
+    if (!SupportsDisplayTiming()) {
+        throw std::runtime_error("Display timing is not enabled on this device");
+    }
+    uint32_t count = 0;
+    VkResult result = vkGetPastPresentationTimingGOOGLE(device_, swapchain_, &count, nullptr);
+    std::vector<VkPastPresentationTimingGOOGLE> timings(count);
+    if (result == VK_SUCCESS && count > 0) {
+        result = vkGetPastPresentationTimingGOOGLE(device_, swapchain_, &count, timings.data());
+        timings.resize(count);
+    }
+    if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+        return {};
+    }
+    if (result != VK_SUCCESS && result != VK_INCOMPLETE) {
+        throw std::runtime_error("Failed to query past presentation timings");
+    }
+    return timings;
+}
+
+bool Swapchain::SupportsDisplayTiming() const {
+    return !headless_ && deviceRef_ != nullptr && deviceRef_->SupportsDisplayTiming();
+}
+
+VkPresentModeKHR Swapchain::GetPresentModeForLatency(LatencyMode mode) {
+    switch (mode) {
+        case LatencyMode::THROUGHPUT:
+            return VK_PRESENT_MODE_MAILBOX_KHR;
+        case LatencyMode::LOWEST_LATENCY:
+            return VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+        case LatencyMode::BALANCED:
+        default:
+            return VK_PRESENT_MODE_FIFO_KHR;
+    }
+}
+
+void Swapchain::SetPreferredPresentMode(VkPresentModeKHR present_mode) {
+    if (present_mode != presentMode_) {
+        presentMode_ = present_mode;
+        needsRecreate_ = true;
+    }
+}
+
+RetiredSwapchain Swapchain::Recreate(SDL_Window* window) {
+    if (headless_ && window == nullptr) {
+        return Recreate(extent_.width, extent_.height);
+    }
     int width = 0;
     int height = 0;
     if(window_ == nullptr && window == nullptr) {
@@ -153,21 +395,37 @@ void Swapchain::Recreate(SDL_Window* window) {
     }
     SDL_GetWindowSizeInPixels(window ? window : window_, &width, &height);
     if (width <= 0 || height <= 0) {
-        return;
+        return {};
     }
-    Recreate(static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+    RetiredSwapchain retired = Recreate(static_cast<uint32_t>(width), static_cast<uint32_t>(height));
     
     if(window)
     {
         window_ = window;
     }
+    return retired;
 }
 
-void Swapchain::Recreate(uint32_t width, uint32_t height) {
-    Cleanup();
+RetiredSwapchain Swapchain::Recreate(uint32_t width, uint32_t height) {
+    if (headless_) {
+        std::vector<std::unique_ptr<Image>> old_images = std::move(offscreenImages_);
+        offscreenImages_.clear();
+        CreateOffscreenImages(width, height);
+        RetiredSwapchain retired(device_, VK_NULL_HANDLE, std::move(imageViews_), std::move(old_images));
+        imageViews_.clear();
+        CreateImageViews();
+        needsRecreate_ = false;
+        return retired;
+    }
+
+    // The current swapchain is handed to the new one as oldSwapchain and only retired
+    const VkSwapchainKHR old_swapchain = swapchain_;
     CreateSwapchain(width, height);
+    RetiredSwapchain retired(device_, old_swapchain, std::move(imageViews_));
+    imageViews_.clear();
     CreateImageViews();
     needsRecreate_ = false;
+    return retired;
 }
 
 SwapchainSupportDetails Swapchain::QuerySwapchainSupport(VkPhysicalDevice physical_device) const {
@@ -208,9 +466,12 @@ VkPresentModeKHR Swapchain::ChooseSwapPresentMode(const std::vector<VkPresentMod
             return mode;
         }
     }
-    for (auto mode : available_present_modes) {
-        if (mode == VK_PRESENT_MODE_MAILBOX_KHR) {
-            return mode;
+    // Only an unthrottled preference falls back to MAILBOX; a vsynced one keeps vsync
+    if (presentMode_ == VK_PRESENT_MODE_IMMEDIATE_KHR || presentMode_ == VK_PRESENT_MODE_MAILBOX_KHR) {
+        for (auto mode : available_present_modes) {
+            if (mode == VK_PRESENT_MODE_MAILBOX_KHR) {
+                return mode;
+            }
         }
     }
     return VK_PRESENT_MODE_FIFO_KHR;
@@ -289,13 +550,11 @@ void Swapchain::CreateSwapchain(uint32_t width, uint32_t height) {
     create_info.oldSwapchain = swapchain_;
 
     VkSwapchainKHR new_swapchain = VK_NULL_HANDLE;
-    if (vkCreateSwapchainKHR(device_, &create_info, nullptr, &new_swapchain) != VK_SUCCESS) {
+    if (vkCreateSwapchainKHR(device_, &create_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_SWAPCHAIN_KHR), &new_swapchain) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create swapchain");
     }
 
-    if (new_swapchain != VK_NULL_HANDLE) {
-        vkDestroySwapchainKHR(device_, swapchain_, nullptr);
-    }
+    // The previous swapchain (if any) is retired, not destroyed; see Recreate
     swapchain_ = new_swapchain;
     imageFormat_ = surface_format.format;
     extent_ = extent;
@@ -303,13 +562,28 @@ void Swapchain::CreateSwapchain(uint32_t width, uint32_t height) {
     surfaceFormat_ = surface_format;
 }
 
-void Swapchain::CreateImageViews() {
-    uint32_t image_count = 0;
-    vkGetSwapchainImagesKHR(device_, swapchain_, &image_count, nullptr);
-    std::vector<VkImage> images(image_count);
-    if (image_count > 0) {
-        vkGetSwapchainImagesKHR(device_, swapchain_, &image_count, images.data());
+void Swapchain::CreateOffscreenImages(uint32_t width, uint32_t height) {
+    offscreenImages_.reserve(minImageCount_);
+    for (uint32_t i = 0; i < minImageCount_; ++i) {
+        offscreenImages_.push_back(std::make_unique<Image>(*deviceRef_,
+                                                           width,
+                                                           height,
+                                                           1,
+                                                           1,
+                                                           1,
+                                                           imageFormat_,
+                                                           VK_IMAGE_TYPE_2D,
+                                                           VK_IMAGE_TILING_OPTIMAL,
+                                                           offscreenUsage_));
     }
+    extent_ = {width, height};
+    nextOffscreenImage_ = 0;
+    lastPresentedImage_ = UINT32_MAX;
+}
+
+void Swapchain::CreateImageViews() {
+    const std::vector<VkImage> images = GetImages();
+    const auto image_count = static_cast<uint32_t>(images.size());
 
     imageViews_.resize(image_count);
     for (uint32_t i = 0; i < image_count; ++i) {
@@ -327,7 +601,7 @@ void Swapchain::CreateImageViews() {
         view_info.subresourceRange.baseArrayLayer = 0;
         view_info.subresourceRange.layerCount = 1;
 
-        if (vkCreateImageView(device_, &view_info, nullptr, &imageViews_[i]) != VK_SUCCESS) {
+        if (vkCreateImageView(device_, &view_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_IMAGE_VIEW), &imageViews_[i]) != VK_SUCCESS) {
             throw std::runtime_error("Failed to create swapchain image views");
         }
     }
@@ -336,15 +610,16 @@ void Swapchain::CreateImageViews() {
 void Swapchain::Cleanup() {
     for (VkImageView view : imageViews_) {
         if (view != VK_NULL_HANDLE) {
-            vkDestroyImageView(device_, view, nullptr);
+            vkDestroyImageView(device_, view, Utils::HostAllocator::For(VK_OBJECT_TYPE_IMAGE_VIEW));
         }
     }
     imageViews_.clear();
 
     if (swapchain_ != VK_NULL_HANDLE) {
-        vkDestroySwapchainKHR(device_, swapchain_, nullptr);
+        vkDestroySwapchainKHR(device_, swapchain_, Utils::HostAllocator::For(VK_OBJECT_TYPE_SWAPCHAIN_KHR));
         swapchain_ = VK_NULL_HANDLE;
     }
+    offscreenImages_.clear();
 }
 
 } // namespace VulkanEngine::RAII
@@ -2,6 +2,9 @@
 #define VULKAN_RAII_PRESENTATION_SWAPCHAIN_HPP
 
 #include <volk.h>
+#include <cstdint>
+#include <memory>
+#include <span>
 #include <vector>
 
 // Forward declare SDL types
@@ -12,6 +15,7 @@ namespace VulkanEngine::RAII {
 
 class Device; // Forward declaration
 class Surface; // Forward declaration
+class Image; // Forward declaration
 
 struct SwapchainSupportDetails {
     VkSurfaceCapabilitiesKHR capabilities;
@@ -19,8 +23,58 @@ struct SwapchainSupportDetails {
     std::vector<VkPresentModeKHR> presentModes;
 };
 
+// A swapchain replaced by Swapchain::Recreate, with its image views. The new swapchain
+// was created from it (oldSwapchain), so it can no longer acquire, but presents already
+// queued still complete. Destroying it destroys the views and the handle, so keep it
+// until the GPU and the presentation engine are done with its images. A headless
+// swapchain retires its offscreen images instead of a handle
+class RetiredSwapchain {
+public:
+    RetiredSwapchain() = default;
+    RetiredSwapchain(VkDevice device,
+                     VkSwapchainKHR swapchain,
+                     std::vector<VkImageView> image_views,
+                     std::vector<std::unique_ptr<Image>> offscreen_images = {});
+
+    // Destructor
+    ~RetiredSwapchain();
+
+    // Move constructor and assignment
+    RetiredSwapchain(RetiredSwapchain&& other) noexcept;
+    RetiredSwapchain& operator=(RetiredSwapchain&& other) noexcept;
+
+    // Delete copy constructor and assignment. this ensures unique ownership of the VkSwapchainKHR by only allowing moving.
+    RetiredSwapchain(const RetiredSwapchain&) = delete;
+    RetiredSwapchain& operator=(const RetiredSwapchain&) = delete;
+
+    [[nodiscard]] bool IsValid() const { return swapchain_ != VK_NULL_HANDLE || !imageViews_.empty(); }
+
+private:
+    VkDevice device_{VK_NULL_HANDLE};
+    VkSwapchainKHR swapchain_{VK_NULL_HANDLE};
+    std::vector<VkImageView> imageViews_;
+    std::vector<std::unique_ptr<Image>> offscreenImages_;
+
+    void Cleanup();
+};
+
 class Swapchain {
 public:
+    // Present mode preference by what matters most:
+    //  THROUGHPUT     - MAILBOX: render unthrottled, the newest frame is shown at vblank
+    //  BALANCED       - FIFO: vsync, no tearing, frames queue up to the image count
+    //  LOWEST_LATENCY - FIFO_RELAXED: vsync, but a late frame is shown at once (may tear);
+    //                   meant to be paired with present-wait pacing (Renderer::SetLatencyMode)
+    // Unsupported modes fall back to FIFO, which is always available
+    enum class LatencyMode {
+        THROUGHPUT,
+        BALANCED,
+        LOWEST_LATENCY
+    };
+
+    // Present mode requested for mode
+    static VkPresentModeKHR GetPresentModeForLatency(LatencyMode mode);
+
     // SDL2-specific constructor that automatically gets window size
     Swapchain(const Device& device, 
               const Surface& surface,
@@ -38,6 +92,18 @@ public:
               VkSurfaceFormatKHR preferred_format = {VK_FORMAT_B8G8R8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR},
               uint32_t min_image_count = 0);
 
+    // Headless constructor: a ring of image_count offscreen color images stands in for
+    // the presentable images, so a Renderer drives it with the same BeginFrame/EndFrame.
+    // Needs no surface and no VK_KHR_swapchain. Acquire hands the images out round robin
+    // without signalling anything, and Present only records the index. Images end a
+    // frame in TRANSFER_SRC_OPTIMAL (GetPresentLayout()); usage is added to color attachment
+    Swapchain(const Device& device,
+              uint32_t width,
+              uint32_t height,
+              VkFormat format = VK_FORMAT_R8G8B8A8_UNORM,
+              uint32_t image_count = 3,
+              VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+
     // Destructor
     ~Swapchain();
 
@@ -55,7 +121,22 @@ public:
     operator VkSwapchainKHR() const { return swapchain_; }
 
     // Check if the swapchain is valid
-    [[nodiscard]] bool IsValid() const { return swapchain_ != VK_NULL_HANDLE; }
+    [[nodiscard]] bool IsValid() const { return swapchain_ != VK_NULL_HANDLE || (headless_ && !imageViews_.empty()); }
+
+    // Check whether this is an offscreen ring (headless constructor)
+    [[nodiscard]] bool IsHeadless() const { return headless_; }
+
+    // Headless only: the offscreen image at index, e.g. to read it back
+    [[nodiscard]] const Image& GetOffscreenImage(uint32_t index) const;
+
+    // Headless only: index given to the last Present (UINT32_MAX before the first)
+    [[nodiscard]] uint32_t GetLastPresentedImageIndex() const { return lastPresentedImage_; }
+
+    // Layout images must be in when presented: PRESENT_SRC_KHR, or TRANSFER_SRC_OPTIMAL
+    // for headless rings, ready to be copied out
+    [[nodiscard]] VkImageLayout GetPresentLayout() const {
+        return headless_ ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    }
 
     // Get swapchain images
     [[nodiscard]] std::vector<VkImage> GetImages() const;
@@ -75,13 +156,51 @@ public:
     // Acquire next image
     VkResult AcquireNextImage(uint64_t timeout, VkSemaphore semaphore, VkFence fence, uint32_t& image_index) const;
 
-    // Present image
-    VkResult Present(const std::vector<VkSemaphore>& wait_semaphores, uint32_t image_index, VkQueue present_queue) const;
-
-    // SDL2-specific recreate method that gets size from window
-    void Recreate(SDL_Window* window = nullptr);
-
-    void Recreate(uint32_t width, uint32_t height);
+    // Present image. A non-zero present_id tags the present for WaitForPresent (needs
+    // Device::SupportsPresentWait(); ids must increase per swapchain) and, truncated to
+    // 32 bits, for GetPastPresentationTimings (needs Device::SupportsDisplayTiming())
+    // present_fence is signalled once the presentation engine is done with the present's
+    // wait semaphores and image (needs Device::SupportsSwapchainMaintenance1())
+    // damage lists the rectangles that changed since the image's previous present; it
+    // is a hint the presentation engine may ignore, and is dropped without
+    // VK_KHR_incremental_present. Empty damage means the whole image changed
+    VkResult Present(const std::vector<VkSemaphore>& wait_semaphores,
+                     uint32_t image_index,
+                     VkQueue present_queue,
+                     uint64_t present_id = 0,
+                     VkFence present_fence = VK_NULL_HANDLE,
+                     std::span<const VkRectLayerKHR> damage = {}) const;
+
+    // Check whether Present can pass damage rectangles on (VK_KHR_incremental_present)
+    [[nodiscard]] bool SupportsIncrementalPresent() const;
+
+    // VK_GOOGLE_display_timing: when presents given an id were actually displayed, for
+    // presents not reported before. Times are in the presentation engine's clock
+    // (CLOCK_MONOTONIC, i.e. std::chrono::steady_clock, on the platforms exposing it).
+    // Empty once the swapchain is out of date
+    [[nodiscard]] std::vector<VkPastPresentationTimingGOOGLE> GetPastPresentationTimings() const;
+    [[nodiscard]] bool SupportsDisplayTiming() const;
+
+    // Wait until the present tagged present_id (or a later one) is shown (VK_KHR_present_wait)
+    [[nodiscard]] VkResult WaitForPresent(uint64_t present_id, uint64_t timeout) const;
+
+    // Check whether presents can be tagged and waited on
+    [[nodiscard]] bool SupportsPresentWait() const;
+
+    // Present mode in use
+    [[nodiscard]] VkPresentModeKHR GetPresentMode() const { return presentMode_; }
+
+    // Change the preferred present mode; takes effect at the next Recreate() (marks for recreation)
+    void SetPreferredPresentMode(VkPresentModeKHR present_mode);
+    void SetLatencyMode(LatencyMode mode) { SetPreferredPresentMode(GetPresentModeForLatency(mode)); }
+
+    // SDL2-specific recreate method that gets size from window (returns an empty
+    // RetiredSwapchain when the window has no area and nothing was recreated)
+    RetiredSwapchain Recreate(SDL_Window* window = nullptr);
+
+    // Create the new swapchain from the current one without waiting for the device. The
+    // old swapchain is returned; dropping it at once is only safe when the device is idle
+    RetiredSwapchain Recreate(uint32_t width, uint32_t height);
 
     // Check if recreate is needed (e.g., window was resized)
     [[nodiscard]] bool NeedsRecreate() const { return needsRecreate_; }
@@ -104,8 +223,16 @@ private:
     VkSurfaceFormatKHR surfaceFormat_{VK_FORMAT_UNDEFINED, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR};
     bool needsRecreate_{false};
 
+    // Headless ring (see the headless constructor)
+    bool headless_{false};
+    VkImageUsageFlags offscreenUsage_{0};
+    std::vector<std::unique_ptr<Image>> offscreenImages_;
+    mutable uint32_t nextOffscreenImage_{0};
+    mutable uint32_t lastPresentedImage_{UINT32_MAX};
+
     // Helper methods
     void CreateSwapchain(uint32_t width, uint32_t height);
+    void CreateOffscreenImages(uint32_t width, uint32_t height);
     void CreateImageViews();
     void Cleanup();
     
@@ -1,11 +1,20 @@
 #include "CommandBuffer.hpp"
 
 #include "CommandPool.hpp"
+#include "GpuProfiler.hpp"
+#include "QueryPool.hpp"
 #include "RAII/rendering/Renderer.hpp"
+#include "../resources/Buffer.hpp"
+#include "../resources/ShaderObject.hpp"
+#include "../sync/BarrierBatcher.hpp"
+#include "../utils/PerfCounters.hpp"
+#include "../utils/SyncUtils.hpp"
 
 #include <cstdint>
 #include <stdexcept>
 #include <cassert>
+#include <memory>
+#include <utility>
 #include <span> // for std::span
 
 
@@ -15,11 +24,15 @@ CommandBuffer::CommandBuffer(VkCommandBuffer command_buffer, const CommandPool&
         : commandBuffer_(command_buffer),
         commandPool_(command_pool.GetHandle()),
         device_(command_pool.GetDevice()),
+        dispatch_(command_pool.GetDispatch()),
+        synchronization2_(command_pool.SupportsSynchronization2()),
         ownsCommandBuffer_(false) {}
 
 CommandBuffer::CommandBuffer(const CommandPool& command_pool, VkCommandBufferLevel level)
     : commandPool_(command_pool.GetHandle()),
     device_(command_pool.GetDevice()),
+    dispatch_(command_pool.GetDispatch()),
+    synchronization2_(command_pool.SupportsSynchronization2()),
     ownsCommandBuffer_(true)
 {
     VkCommandBufferAllocateInfo alloc_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
@@ -27,7 +40,7 @@ CommandBuffer::CommandBuffer(const CommandPool& command_pool, VkCommandBufferLev
     alloc_info.level = level;
     alloc_info.commandBufferCount = 1;
 
-    if (vkAllocateCommandBuffers(device_, &alloc_info, &commandBuffer_) != VK_SUCCESS) {
+    if (dispatch_->vkAllocateCommandBuffers(device_, &alloc_info, &commandBuffer_) != VK_SUCCESS) {
         throw std::runtime_error("Failed to allocate command buffer");
     }
 }
@@ -40,8 +53,14 @@ CommandBuffer::CommandBuffer(CommandBuffer&& other) noexcept
     : commandBuffer_(other.commandBuffer_),
     commandPool_(other.commandPool_),
     device_(other.device_),
-    ownsCommandBuffer_(other.ownsCommandBuffer_)
+    dispatch_(other.dispatch_),
+    synchronization2_(other.synchronization2_),
+    ownsCommandBuffer_(other.ownsCommandBuffer_),
+    barrierBatcher_(std::move(other.barrierBatcher_)),
+    profiler_(other.profiler_),
+    profilerQueue_(other.profilerQueue_)
 {
+    other.profiler_ = nullptr;
     other.commandBuffer_ = VK_NULL_HANDLE;
     other.commandPool_ = VK_NULL_HANDLE;
     other.device_ = VK_NULL_HANDLE;
@@ -54,7 +73,13 @@ CommandBuffer& CommandBuffer::operator=(CommandBuffer&& other) noexcept {
         commandBuffer_ = other.commandBuffer_;
         commandPool_ = other.commandPool_;
         device_ = other.device_;
+        dispatch_ = other.dispatch_;
+        synchronization2_ = other.synchronization2_;
         ownsCommandBuffer_ = other.ownsCommandBuffer_;
+        barrierBatcher_ = std::move(other.barrierBatcher_);
+        profiler_ = other.profiler_;
+        profilerQueue_ = other.profilerQueue_;
+        other.profiler_ = nullptr;
         other.commandBuffer_ = VK_NULL_HANDLE;
         other.commandPool_ = VK_NULL_HANDLE;
         other.device_ = VK_NULL_HANDLE;
@@ -69,23 +94,82 @@ void CommandBuffer::Begin(VkCommandBufferUsageFlags flags,
     begin_info.flags = flags;
     begin_info.pInheritanceInfo = inheritance_info;
 
-    if (vkBeginCommandBuffer(commandBuffer_, &begin_info) != VK_SUCCESS) {
+    if (barrierBatcher_) {
+        barrierBatcher_->Clear();
+    }
+    if (dispatch_->vkBeginCommandBuffer(commandBuffer_, &begin_info) != VK_SUCCESS) {
         throw std::runtime_error("Failed to begin recording command buffer");
     }
 }
 
 void CommandBuffer::End() const {
-    if (vkEndCommandBuffer(commandBuffer_) != VK_SUCCESS) {
+    FlushBarriers();
+    if (dispatch_->vkEndCommandBuffer(commandBuffer_) != VK_SUCCESS) {
         throw std::runtime_error("Failed to record command buffer");
     }
 }
 
+void CommandBuffer::CopyQueryPoolResults(const QueryPool& query_pool,
+                                         uint32_t first_query,
+                                         uint32_t query_count,
+                                         const Buffer& dst_buffer,
+                                         VkDeviceSize dst_offset,
+                                         VkDeviceSize stride,
+                                         VkQueryResultFlags flags) const {
+    if (first_query + query_count > query_pool.GetQueryCount()) {
+        throw std::out_of_range("Query range out of range");
+    }
+    const VkDeviceSize copy_stride = stride != 0 ? stride : query_pool.GetResultStride(flags);
+    if (query_count > 0 && dst_offset + copy_stride * (query_count - 1) + query_pool.GetResultStride(flags) > dst_buffer.GetSize()) {
+        throw std::out_of_range("Query results do not fit the destination buffer");
+    }
+    FlushBarriers();
+    dispatch_->vkCmdCopyQueryPoolResults(commandBuffer_, query_pool, first_query, query_count, dst_buffer.GetHandle(), dst_offset, copy_stride, flags);
+}
+
+void CommandBuffer::BeginConditionalRendering(const Buffer& buffer, VkDeviceSize offset, bool inverted) const {
+    if (offset % sizeof(uint32_t) != 0 || offset + sizeof(uint32_t) > buffer.GetSize()) {
+        throw std::out_of_range("Conditional rendering predicate must be an aligned uint32 inside the buffer");
+    }
+    VkConditionalRenderingBeginInfoEXT begin_info{VK_STRUCTURE_TYPE_CONDITIONAL_RENDERING_BEGIN_INFO_EXT};
+    begin_info.buffer = buffer.GetHandle();
+    begin_info.offset = offset;
+    begin_info.flags = inverted ? VK_CONDITIONAL_RENDERING_INVERTED_BIT_EXT : 0;
+    dispatch_->vkCmdBeginConditionalRenderingEXT(commandBuffer_, &begin_info);
+}
+
+void CommandBuffer::BeginZone(std::string_view name) const {
+    if (profiler_) {
+        profiler_->BeginZone(commandBuffer_, profilerQueue_, name);
+    }
+}
+
+void CommandBuffer::EndZone() const {
+    if (profiler_) {
+        profiler_->EndZone(commandBuffer_, profilerQueue_);
+    }
+}
+
 void CommandBuffer::Reset(VkCommandBufferResetFlags flags) const {
-    vkResetCommandBuffer(commandBuffer_, flags);
+    if (barrierBatcher_) {
+        barrierBatcher_->Clear();
+    }
+    dispatch_->vkResetCommandBuffer(commandBuffer_, flags);
 }
 
 void CommandBuffer::BindPipeline(VkPipelineBindPoint bind_point, VkPipeline pipeline) const {
-    vkCmdBindPipeline(commandBuffer_, bind_point, pipeline);
+    Utils::PerfCounters::AddPipelineBinds();
+    dispatch_->vkCmdBindPipeline(commandBuffer_, bind_point, pipeline);
+}
+
+void CommandBuffer::BindShaders(std::span<const VkShaderStageFlagBits> stages, std::span<const VkShaderEXT> shaders) const {
+    assert(stages.size() == shaders.size());
+    Utils::PerfCounters::AddPipelineBinds();
+    dispatch_->vkCmdBindShadersEXT(commandBuffer_, static_cast<uint32_t>(stages.size()), stages.data(), shaders.data());
+}
+
+void CommandBuffer::BindShaders(const ShaderObject& shader_object) const {
+    BindShaders(shader_object.GetStages(), shader_object.GetHandles());
 }
 
 void CommandBuffer::BindDescriptorSets(VkPipelineBindPoint bind_point,
@@ -93,14 +177,60 @@ void CommandBuffer::BindDescriptorSets(VkPipelineBindPoint bind_point,
                                        uint32_t first_set,
                                        std::span<const VkDescriptorSet> descriptor_sets,
                                        std::span<const uint32_t> dynamic_offsets) const {
-    vkCmdBindDescriptorSets(commandBuffer_,
-                            bind_point,
-                            layout,
-                            first_set,
-                            static_cast<uint32_t>(descriptor_sets.size()),
-                            descriptor_sets.empty() ? nullptr : descriptor_sets.data(),
-                            static_cast<uint32_t>(dynamic_offsets.size()),
-                            dynamic_offsets.empty() ? nullptr : dynamic_offsets.data());
+    dispatch_->vkCmdBindDescriptorSets(commandBuffer_,
+                                       bind_point,
+                                       layout,
+                                       first_set,
+                                       static_cast<uint32_t>(descriptor_sets.size()),
+                                       descriptor_sets.empty() ? nullptr : descriptor_sets.data(),
+                                       static_cast<uint32_t>(dynamic_offsets.size()),
+                                       dynamic_offsets.empty() ? nullptr : dynamic_offsets.data());
+}
+
+void CommandBuffer::PushDescriptorSet(VkPipelineBindPoint bind_point,
+                                      VkPipelineLayout layout,
+                                      uint32_t set,
+                                      std::span<const VkWriteDescriptorSet> writes) const {
+    if (Utils::PerfCounters::IsEnabled()) {
+        uint64_t descriptor_count = 0;
+        for (const VkWriteDescriptorSet& write : writes) {
+            descriptor_count += write.descriptorCount;
+        }
+        Utils::PerfCounters::AddDescriptorUpdates(descriptor_count);
+    }
+    dispatch_->vkCmdPushDescriptorSetKHR(commandBuffer_,
+                                         bind_point,
+                                         layout,
+                                         set,
+                                         static_cast<uint32_t>(writes.size()),
+                                         writes.empty() ? nullptr : writes.data());
+}
+
+void CommandBuffer::PushDescriptorSetWithTemplate(VkDescriptorUpdateTemplate update_template,
+                                                  VkPipelineLayout layout,
+                                                  uint32_t set,
+                                                  const void* data) const {
+    dispatch_->vkCmdPushDescriptorSetWithTemplateKHR(commandBuffer_, update_template, layout, set, data);
+}
+
+void CommandBuffer::BindDescriptorBuffers(std::span<const VkDescriptorBufferBindingInfoEXT> buffers) const {
+    dispatch_->vkCmdBindDescriptorBuffersEXT(commandBuffer_, static_cast<uint32_t>(buffers.size()), buffers.data());
+}
+
+void CommandBuffer::SetDescriptorBufferOffsets(VkPipelineBindPoint bind_point,
+                                               VkPipelineLayout layout,
+                                               uint32_t first_set,
+                                               std::span<const uint32_t> buffer_indices,
+                                               std::span<const VkDeviceSize> offsets) const {
+    // One buffer index and offset per set
+    assert(buffer_indices.size() == offsets.size());
+    dispatch_->vkCmdSetDescriptorBufferOffsetsEXT(commandBuffer_,
+                                                  bind_point,
+                                                  layout,
+                                                  first_set,
+                                                  static_cast<uint32_t>(offsets.size()),
+                                                  buffer_indices.data(),
+                                                  offsets.data());
 }
 
 void CommandBuffer::BindVertexBuffers(uint32_t first_binding,
@@ -108,22 +238,24 @@ void CommandBuffer::BindVertexBuffers(uint32_t first_binding,
                                       std::span<const VkDeviceSize> offsets) const {
     // offsets must be at least as long as buffers when binding multiple buffers
     assert(offsets.size() >= buffers.size() || buffers.empty());
-    vkCmdBindVertexBuffers(commandBuffer_,
-                           first_binding,
-                           static_cast<uint32_t>(buffers.size()),
-                           buffers.empty() ? nullptr : buffers.data(),
-                           offsets.empty() ? nullptr : offsets.data());
+    dispatch_->vkCmdBindVertexBuffers(commandBuffer_,
+                                      first_binding,
+                                      static_cast<uint32_t>(buffers.size()),
+                                      buffers.empty() ? nullptr : buffers.data(),
+                                      offsets.empty() ? nullptr : offsets.data());
 }
 
 void CommandBuffer::BindIndexBuffer(VkBuffer buffer, VkDeviceSize offset, VkIndexType index_type) const {
-    vkCmdBindIndexBuffer(commandBuffer_, buffer, offset, index_type);
+    dispatch_->vkCmdBindIndexBuffer(commandBuffer_, buffer, offset, index_type);
 }
 
 void CommandBuffer::Draw(uint32_t vertex_count,
                          uint32_t instance_count,
                          uint32_t first_vertex,
                          uint32_t first_instance) const {
-    vkCmdDraw(commandBuffer_, vertex_count, instance_count, first_vertex, first_instance);
+    FlushBarriers();
+    Utils::PerfCounters::AddDraws();
+    dispatch_->vkCmdDraw(commandBuffer_, vertex_count, instance_count, first_vertex, first_instance);
 }
 
 void CommandBuffer::DrawIndexed(uint32_t index_count,
@@ -131,30 +263,115 @@ void CommandBuffer::DrawIndexed(uint32_t index_count,
                                 uint32_t first_index,
                                 int32_t vertex_offset,
                                 uint32_t first_instance) const {
-    vkCmdDrawIndexed(commandBuffer_, index_count, instance_count, first_index, vertex_offset, first_instance);
+    FlushBarriers();
+    Utils::PerfCounters::AddDraws();
+    dispatch_->vkCmdDrawIndexed(commandBuffer_, index_count, instance_count, first_index, vertex_offset, first_instance);
 }
 
 void CommandBuffer::Dispatch(uint32_t group_count_x,
                              uint32_t group_count_y,
                              uint32_t group_count_z) const {
-    vkCmdDispatch(commandBuffer_, group_count_x, group_count_y, group_count_z);
+    FlushBarriers();
+    Utils::PerfCounters::AddDispatches();
+    dispatch_->vkCmdDispatch(commandBuffer_, group_count_x, group_count_y, group_count_z);
 }
 
 void CommandBuffer::DispatchIndirect(VkBuffer buffer,
                                      VkDeviceSize offset) const {
-    vkCmdDispatchIndirect(commandBuffer_, buffer, offset);
+    FlushBarriers();
+    Utils::PerfCounters::AddDispatches();
+    dispatch_->vkCmdDispatchIndirect(commandBuffer_, buffer, offset);
 }
 
 void CommandBuffer::DrawIndexedIndirect(VkBuffer buffer,
                                           VkDeviceSize offset,
                                           uint32_t draw_count,
                                           uint32_t stride) const {
-    vkCmdDrawIndexedIndirect(commandBuffer_, buffer, offset, draw_count, stride);
+    FlushBarriers();
+    Utils::PerfCounters::AddDraws(draw_count);
+    dispatch_->vkCmdDrawIndexedIndirect(commandBuffer_, buffer, offset, draw_count, stride);
+}
+
+void CommandBuffer::DrawIndirect(VkBuffer buffer,
+                                 VkDeviceSize offset,
+                                 uint32_t draw_count,
+                                 uint32_t stride) const {
+    FlushBarriers();
+    Utils::PerfCounters::AddDraws(draw_count);
+    dispatch_->vkCmdDrawIndirect(commandBuffer_, buffer, offset, draw_count, stride);
+}
+
+void CommandBuffer::DrawIndirectCount(VkBuffer buffer,
+                                      VkDeviceSize offset,
+                                      VkBuffer count_buffer,
+                                      VkDeviceSize count_buffer_offset,
+                                      uint32_t max_draw_count,
+                                      uint32_t stride) const {
+    FlushBarriers();
+    Utils::PerfCounters::AddDraws();
+    dispatch_->vkCmdDrawIndirectCountKHR(commandBuffer_, buffer, offset, count_buffer, count_buffer_offset, max_draw_count, stride);
+}
+
+void CommandBuffer::DrawIndexedIndirectCount(VkBuffer buffer,
+                                             VkDeviceSize offset,
+                                             VkBuffer count_buffer,
+                                             VkDeviceSize count_buffer_offset,
+                                             uint32_t max_draw_count,
+                                             uint32_t stride) const {
+    FlushBarriers();
+    Utils::PerfCounters::AddDraws();
+    dispatch_->vkCmdDrawIndexedIndirectCountKHR(commandBuffer_, buffer, offset, count_buffer, count_buffer_offset, max_draw_count, stride);
+}
+
+void CommandBuffer::DrawMulti(std::span<const VkMultiDrawInfoEXT> draws,
+                              uint32_t instance_count,
+                              uint32_t first_instance) const {
+    if (draws.empty()) {
+        return;
+    }
+    FlushBarriers();
+    Utils::PerfCounters::AddDraws(draws.size());
+    dispatch_->vkCmdDrawMultiEXT(commandBuffer_,
+                                 static_cast<uint32_t>(draws.size()),
+                                 draws.data(),
+                                 instance_count,
+                                 first_instance,
+                                 sizeof(VkMultiDrawInfoEXT));
+}
+
+void CommandBuffer::DrawMultiIndexed(std::span<const VkMultiDrawIndexedInfoEXT> draws,
+                                     uint32_t instance_count,
+                                     uint32_t first_instance,
+                                     const int32_t* vertex_offset) const {
+    if (draws.empty()) {
+        return;
+    }
+    FlushBarriers();
+    Utils::PerfCounters::AddDraws(draws.size());
+    dispatch_->vkCmdDrawMultiIndexedEXT(commandBuffer_,
+                                        static_cast<uint32_t>(draws.size()),
+                                        draws.data(),
+                                        instance_count,
+                                        first_instance,
+                                        sizeof(VkMultiDrawIndexedInfoEXT),
+                                        vertex_offset);
+}
+
+void CommandBuffer::ExecuteGeneratedCommands(const VkGeneratedCommandsInfoEXT& info, bool is_preprocessed) const {
+    FlushBarriers();
+    dispatch_->vkCmdExecuteGeneratedCommandsEXT(commandBuffer_, is_preprocessed ? VK_TRUE : VK_FALSE, &info);
+}
+
+void CommandBuffer::PreprocessGeneratedCommands(const VkGeneratedCommandsInfoEXT& info,
+                                                VkCommandBuffer state_command_buffer) const {
+    FlushBarriers();
+    dispatch_->vkCmdPreprocessGeneratedCommandsEXT(commandBuffer_, &info, state_command_buffer);
 }
 
 void CommandBuffer::BeginRenderPass(const VkRenderPassBeginInfo& render_pass_begin,
                                     VkSubpassContents contents) const {
-    vkCmdBeginRenderPass(commandBuffer_, &render_pass_begin, contents);
+    FlushBarriers();
+    dispatch_->vkCmdBeginRenderPass(commandBuffer_, &render_pass_begin, contents);
 }
 
 void CommandBuffer::BeginRenderPass(VkRenderPass render_pass,
@@ -162,6 +379,7 @@ void CommandBuffer::BeginRenderPass(VkRenderPass render_pass,
                                       VkFramebuffer framebuffer,
                                       const VkClearValue& clear_value,
                                       VkSubpassContents contents) const {
+    FlushBarriers();
     VkRenderPassBeginInfo begin_info{VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
     begin_info.renderPass = render_pass;
     begin_info.framebuffer = framebuffer;
@@ -169,13 +387,14 @@ void CommandBuffer::BeginRenderPass(VkRenderPass render_pass,
     begin_info.renderArea.extent = extent;
     begin_info.clearValueCount = 1;
     begin_info.pClearValues = &clear_value;
-    vkCmdBeginRenderPass(commandBuffer_, &begin_info, contents);
+    dispatch_->vkCmdBeginRenderPass(commandBuffer_, &begin_info, contents);
 }
 void CommandBuffer::BeginRenderPass(VkRenderPass render_pass,
                                       const VkExtent2D extent,
                                       VkFramebuffer framebuffer,
                                       std::span<const VkClearValue> clear_values,
                                       VkSubpassContents contents) const {
+    FlushBarriers();
     VkRenderPassBeginInfo begin_info{VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
     begin_info.renderPass = render_pass;
     begin_info.framebuffer = framebuffer;
@@ -183,15 +402,51 @@ void CommandBuffer::BeginRenderPass(VkRenderPass render_pass,
     begin_info.renderArea.extent = extent;
     begin_info.clearValueCount = static_cast<uint32_t>(clear_values.size());
     begin_info.pClearValues = clear_values.empty() ? nullptr : clear_values.data();
-    vkCmdBeginRenderPass(commandBuffer_, &begin_info, contents);
+    dispatch_->vkCmdBeginRenderPass(commandBuffer_, &begin_info, contents);
 }
 
 void CommandBuffer::EndRenderPass() const {
-    vkCmdEndRenderPass(commandBuffer_);
+    dispatch_->vkCmdEndRenderPass(commandBuffer_);
 }
 
 void CommandBuffer::NextSubpass(VkSubpassContents contents) const {
-    vkCmdNextSubpass(commandBuffer_, contents);
+    dispatch_->vkCmdNextSubpass(commandBuffer_, contents);
+}
+
+void CommandBuffer::BeginRendering(const VkRect2D& render_area,
+                                   std::span<const VkRenderingAttachmentInfoKHR> color_attachments,
+                                   const VkRenderingAttachmentInfoKHR* depth_attachment,
+                                   const VkRenderingAttachmentInfoKHR* stencil_attachment,
+                                   VkRenderingFlagsKHR flags,
+                                   const VkRenderingFragmentShadingRateAttachmentInfoKHR* shading_rate_attachment) const {
+    FlushBarriers();
+    VkRenderingInfoKHR rendering_info{VK_STRUCTURE_TYPE_RENDERING_INFO_KHR};
+    rendering_info.pNext = shading_rate_attachment;
+    rendering_info.flags = flags;
+    rendering_info.renderArea = render_area;
+    rendering_info.layerCount = 1;
+    rendering_info.colorAttachmentCount = static_cast<uint32_t>(color_attachments.size());
+    rendering_info.pColorAttachments = color_attachments.empty() ? nullptr : color_attachments.data();
+    rendering_info.pDepthAttachment = depth_attachment;
+    rendering_info.pStencilAttachment = stencil_attachment;
+    dispatch_->vkCmdBeginRenderingKHR(commandBuffer_, &rendering_info);
+}
+
+void CommandBuffer::BeginRendering(const VkRenderingInfoKHR& rendering_info) const {
+    FlushBarriers();
+    dispatch_->vkCmdBeginRenderingKHR(commandBuffer_, &rendering_info);
+}
+
+void CommandBuffer::EndRendering() const {
+    dispatch_->vkCmdEndRenderingKHR(commandBuffer_);
+}
+
+void CommandBuffer::ExecuteCommands(std::span<const VkCommandBuffer> command_buffers) const {
+    FlushBarriers();
+    if (command_buffers.empty()) {
+        return;
+    }
+    dispatch_->vkCmdExecuteCommands(commandBuffer_, static_cast<uint32_t>(command_buffers.size()), command_buffers.data());
 }
 
 void CommandBuffer::PipelineBarrier(VkPipelineStageFlags src_stage_mask,
@@ -200,24 +455,115 @@ void CommandBuffer::PipelineBarrier(VkPipelineStageFlags src_stage_mask,
                                     std::span<const VkMemoryBarrier> memory_barriers,
                                     std::span<const VkBufferMemoryBarrier> buffer_memory_barriers,
                                     std::span<const VkImageMemoryBarrier> image_memory_barriers) const {
-    vkCmdPipelineBarrier(commandBuffer_,
-                         src_stage_mask,
-                         dst_stage_mask,
-                         dependency_flags,
-                         static_cast<uint32_t>(memory_barriers.size()),
-                         memory_barriers.empty() ? nullptr : memory_barriers.data(),
-                         static_cast<uint32_t>(buffer_memory_barriers.size()),
-                         buffer_memory_barriers.empty() ? nullptr : buffer_memory_barriers.data(),
-                         static_cast<uint32_t>(image_memory_barriers.size()),
-                         image_memory_barriers.empty() ? nullptr : image_memory_barriers.data());
+    dispatch_->vkCmdPipelineBarrier(commandBuffer_,
+                                    src_stage_mask,
+                                    dst_stage_mask,
+                                    dependency_flags,
+                                    static_cast<uint32_t>(memory_barriers.size()),
+                                    memory_barriers.empty() ? nullptr : memory_barriers.data(),
+                                    static_cast<uint32_t>(buffer_memory_barriers.size()),
+                                    buffer_memory_barriers.empty() ? nullptr : buffer_memory_barriers.data(),
+                                    static_cast<uint32_t>(image_memory_barriers.size()),
+                                    image_memory_barriers.empty() ? nullptr : image_memory_barriers.data());
+}
+
+void CommandBuffer::RequireImage(Image& image, const ResourceAccess& access) {
+    GetOrCreateBarrierBatcher().Require(image, access);
+}
+
+void CommandBuffer::RequireImage(Image& image, const ResourceAccess& access, const VkImageSubresourceRange& range) {
+    GetOrCreateBarrierBatcher().Require(image, access, range);
+}
+
+void CommandBuffer::RequireBuffer(Buffer& buffer, VkPipelineStageFlags2KHR stages, VkAccessFlags2KHR access) {
+    GetOrCreateBarrierBatcher().Require(buffer, stages, access);
+}
+
+void CommandBuffer::FlushBarriers() const {
+    if (barrierBatcher_) {
+        barrierBatcher_->Flush();
+    }
+}
+
+void CommandBuffer::SignalSplitBarrier(VkEvent event) {
+    GetOrCreateBarrierBatcher().FlushSplit(event);
+}
+
+void CommandBuffer::WaitSplitBarriers(std::span<const VkEvent> events) {
+    GetOrCreateBarrierBatcher().WaitSplit(events);
+}
+
+void CommandBuffer::SetEvent(VkEvent event, VkPipelineStageFlags stage_mask) const {
+    dispatch_->vkCmdSetEvent(commandBuffer_, event, stage_mask);
+}
+
+void CommandBuffer::SetEvent2(VkEvent event, const VkDependencyInfoKHR& dependency_info) const {
+    Utils::SyncUtils::CmdSetEvent2(commandBuffer_, event, dependency_info, synchronization2_, dispatch_);
+}
+
+void CommandBuffer::ResetEvent(VkEvent event, VkPipelineStageFlags2KHR stages) const {
+    Utils::SyncUtils::CmdResetEvent2(commandBuffer_, event, stages, synchronization2_, dispatch_);
+}
+
+void CommandBuffer::WaitEvents(std::span<const VkEvent> events,
+                               VkPipelineStageFlags src_stage_mask,
+                               VkPipelineStageFlags dst_stage_mask,
+                               std::span<const VkMemoryBarrier> memory_barriers,
+                               std::span<const VkBufferMemoryBarrier> buffer_memory_barriers,
+                               std::span<const VkImageMemoryBarrier> image_memory_barriers) const {
+    dispatch_->vkCmdWaitEvents(commandBuffer_,
+                               static_cast<uint32_t>(events.size()),
+                               events.data(),
+                               src_stage_mask,
+                               dst_stage_mask,
+                               static_cast<uint32_t>(memory_barriers.size()),
+                               memory_barriers.empty() ? nullptr : memory_barriers.data(),
+                               static_cast<uint32_t>(buffer_memory_barriers.size()),
+                               buffer_memory_barriers.empty() ? nullptr : buffer_memory_barriers.data(),
+                               static_cast<uint32_t>(image_memory_barriers.size()),
+                               image_memory_barriers.empty() ? nullptr : image_memory_barriers.data());
+}
+
+void CommandBuffer::WaitEvents2(std::span<const VkEvent> events, std::span<const VkDependencyInfoKHR> dependency_infos) const {
+    if (events.size() != dependency_infos.size()) {
+        throw std::invalid_argument("WaitEvents2 requires one dependency info per event");
+    }
+    Utils::SyncUtils::CmdWaitEvents2(commandBuffer_, events, dependency_infos, synchronization2_, dispatch_);
+}
+
+BarrierBatcher& CommandBuffer::GetOrCreateBarrierBatcher() {
+    if (!barrierBatcher_) {
+        barrierBatcher_ = std::make_unique<BarrierBatcher>(commandBuffer_, synchronization2_, dispatch_);
+    }
+    return *barrierBatcher_;
+}
+
+void CommandBuffer::PipelineBarrier2(const VkDependencyInfoKHR& dependency_info) const {
+    Utils::SyncUtils::CmdPipelineBarrier2(commandBuffer_, dependency_info, synchronization2_, dispatch_);
+}
+
+void CommandBuffer::PipelineBarrier2(std::span<const VkMemoryBarrier2KHR> memory_barriers,
+                                     std::span<const VkBufferMemoryBarrier2KHR> buffer_memory_barriers,
+                                     std::span<const VkImageMemoryBarrier2KHR> image_memory_barriers,
+                                     VkDependencyFlags dependency_flags) const {
+    VkDependencyInfoKHR dependency_info{VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR};
+    dependency_info.dependencyFlags = dependency_flags;
+    dependency_info.memoryBarrierCount = static_cast<uint32_t>(memory_barriers.size());
+    dependency_info.pMemoryBarriers = memory_barriers.empty() ? nullptr : memory_barriers.data();
+    dependency_info.bufferMemoryBarrierCount = static_cast<uint32_t>(buffer_memory_barriers.size());
+    dependency_info.pBufferMemoryBarriers = buffer_memory_barriers.empty() ? nullptr : buffer_memory_barriers.data();
+    dependency_info.imageMemoryBarrierCount = static_cast<uint32_t>(image_memory_barriers.size());
+    dependency_info.pImageMemoryBarriers = image_memory_barriers.empty() ? nullptr : image_memory_barriers.data();
+    PipelineBarrier2(dependency_info);
 }
 
 void CommandBuffer::CopyBuffer(VkBuffer src_buffer, VkBuffer dst_buffer, std::span<const VkBufferCopy> regions) const {
-    vkCmdCopyBuffer(commandBuffer_,
-                    src_buffer,
-                    dst_buffer,
-                    static_cast<uint32_t>(regions.size()),
-                    regions.empty() ? nullptr : regions.data());
+    FlushBarriers();
+    dispatch_->vkCmdCopyBuffer(commandBuffer_,
+                               src_buffer,
+                               dst_buffer,
+                               static_cast<uint32_t>(regions.size()),
+                               regions.empty() ? nullptr : regions.data());
 }
 
 void CommandBuffer::CopyImage(VkImage src_image,
@@ -225,25 +571,32 @@ void CommandBuffer::CopyImage(VkImage src_image,
                               VkImage dst_image,
                               VkImageLayout dst_image_layout,
                               std::span<const VkImageCopy> regions) const {
-    vkCmdCopyImage(commandBuffer_,
-                   src_image,
-                   src_image_layout,
-                   dst_image,
-                   dst_image_layout,
-                   static_cast<uint32_t>(regions.size()),
-                   regions.empty() ? nullptr : regions.data());
+    FlushBarriers();
+    dispatch_->vkCmdCopyImage(commandBuffer_,
+                              src_image,
+                              src_image_layout,
+                              dst_image,
+                              dst_image_layout,
+                              static_cast<uint32_t>(regions.size()),
+                              regions.empty() ? nullptr : regions.data());
 }
 
 void CommandBuffer::CopyBufferToImage(VkBuffer src_buffer,
                                       VkImage dst_image,
                                       VkImageLayout dst_image_layout,
                                       std::span<const VkBufferImageCopy> regions) const {
-    vkCmdCopyBufferToImage(commandBuffer_,
-                           src_buffer,
-                           dst_image,
-                           dst_image_layout,
-                           static_cast<uint32_t>(regions.size()),
-                           regions.empty() ? nullptr : regions.data());
+    FlushBarriers();
+    dispatch_->vkCmdCopyBufferToImage(commandBuffer_,
+                                      src_buffer,
+                                      dst_image,
+                                      dst_image_layout,
+                                      static_cast<uint32_t>(regions.size()),
+                                      regions.empty() ? nullptr : regions.data());
+}
+
+void CommandBuffer::FillBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, uint32_t data) const {
+    FlushBarriers();
+    dispatch_->vkCmdFillBuffer(commandBuffer_, buffer, offset, size, data);
 }
 
 void CommandBuffer::PushConstants(VkPipelineLayout layout,
@@ -251,13 +604,13 @@ void CommandBuffer::PushConstants(VkPipelineLayout layout,
                                   uint32_t offset,
                                   uint32_t size,
                                   const void* values) const {
-    vkCmdPushConstants(commandBuffer_, layout, stage_flags, offset, size, values);
+    dispatch_->vkCmdPushConstants(commandBuffer_, layout, stage_flags, offset, size, values);
 }
 
 void CommandBuffer::Cleanup() {
     // Only free if this wrapper actually owns the command buffer
     if (ownsCommandBuffer_ && commandBuffer_ != VK_NULL_HANDLE) {
-        vkFreeCommandBuffers(device_, commandPool_, 1, &commandBuffer_);
+        dispatch_->vkFreeCommandBuffers(device_, commandPool_, 1, &commandBuffer_);
     }
     commandBuffer_ = VK_NULL_HANDLE;
     device_ = VK_NULL_HANDLE;
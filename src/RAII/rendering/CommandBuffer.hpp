@@ -2,7 +2,13 @@
 #define VULKAN_RAII_RENDERING_COMMAND_BUFFER_HPP
 
 #include <volk.h>
+#include <array>
+#include <memory>
 #include <span>
+#include <string_view>
+
+#include "../core/Queue.hpp"
+#include "../utils/DebugUtils.hpp"
 
 
 namespace VulkanEngine::RAII {
@@ -14,6 +20,13 @@ class RenderPass;
     
 class CommandPool; // Forward declaration
 class Device; // Forward declaration
+class ShaderObject; // Forward declaration
+class Image; // Forward declaration
+class Buffer; // Forward declaration
+class BarrierBatcher; // Forward declaration
+class GpuProfiler; // Forward declaration
+class QueryPool; // Forward declaration
+struct ResourceAccess; // Forward declaration
 
 class CommandBuffer {
 public:
@@ -43,6 +56,9 @@ public:
     // Check if the command buffer is valid
     [[nodiscard]] bool IsValid() const { return commandBuffer_ != VK_NULL_HANDLE; }
 
+    // Entry points commands are recorded through (Device::GetDispatch of the pool's device)
+    [[nodiscard]] const VolkDeviceTable* GetDispatch() const { return dispatch_; }
+
     // Begin recording commands
     void Begin(VkCommandBufferUsageFlags flags = 0, 
                const VkCommandBufferInheritanceInfo* inheritance_info = nullptr) const;
@@ -56,6 +72,10 @@ public:
     // Bind pipeline
     void BindPipeline(VkPipelineBindPoint bind_point, VkPipeline pipeline) const;
 
+    // Bind shader objects (VK_EXT_shader_object). A VK_NULL_HANDLE shader unbinds its stage
+    void BindShaders(std::span<const VkShaderStageFlagBits> stages, std::span<const VkShaderEXT> shaders) const;
+    void BindShaders(const ShaderObject& shader_object) const;
+
     // Bind descriptor sets
     void BindDescriptorSets(VkPipelineBindPoint bind_point,
                            VkPipelineLayout layout,
@@ -63,6 +83,25 @@ public:
                            std::span<const VkDescriptorSet> descriptor_sets,
                            std::span<const uint32_t> dynamic_offsets = {}) const;
 
+    // Push descriptors straight into the command buffer (VK_KHR_push_descriptor); the
+    // set's layout must have been created with PUSH_DESCRIPTOR_BIT_KHR. dstSet is ignored
+    void PushDescriptorSet(VkPipelineBindPoint bind_point,
+                           VkPipelineLayout layout,
+                           uint32_t set,
+                           std::span<const VkWriteDescriptorSet> writes) const;
+    void PushDescriptorSetWithTemplate(VkDescriptorUpdateTemplate update_template,
+                                       VkPipelineLayout layout,
+                                       uint32_t set,
+                                       const void* data) const;
+
+    // Bind descriptor buffers (VK_EXT_descriptor_buffer); sets then point into them by offset
+    void BindDescriptorBuffers(std::span<const VkDescriptorBufferBindingInfoEXT> buffers) const;
+    void SetDescriptorBufferOffsets(VkPipelineBindPoint bind_point,
+                                    VkPipelineLayout layout,
+                                    uint32_t first_set,
+                                    std::span<const uint32_t> buffer_indices,
+                                    std::span<const VkDeviceSize> offsets) const;
+
     // Bind vertex buffers
     void BindVertexBuffers(uint32_t first_binding,
                           std::span<const VkBuffer> buffers,
@@ -92,6 +131,48 @@ public:
                                uint32_t draw_count,
                                uint32_t stride) const;
 
+    void DrawIndirect(VkBuffer buffer,
+                      VkDeviceSize offset,
+                      uint32_t draw_count,
+                      uint32_t stride) const;
+
+    // Same, with the draw count read from count_buffer at execution time and clamped
+    // to max_draw_count (VK_KHR_draw_indirect_count, see Device::SupportsDrawIndirectCount)
+    void DrawIndirectCount(VkBuffer buffer,
+                           VkDeviceSize offset,
+                           VkBuffer count_buffer,
+                           VkDeviceSize count_buffer_offset,
+                           uint32_t max_draw_count,
+                           uint32_t stride) const;
+
+    void DrawIndexedIndirectCount(VkBuffer buffer,
+                                  VkDeviceSize offset,
+                                  VkBuffer count_buffer,
+                                  VkDeviceSize count_buffer_offset,
+                                  uint32_t max_draw_count,
+                                  uint32_t stride) const;
+
+    // Several draws sharing all state in one command (VK_EXT_multi_draw, see Device::SupportsMultiDraw).
+    // vertex_offset overrides every draw's offset when given
+    void DrawMulti(std::span<const VkMultiDrawInfoEXT> draws,
+                   uint32_t instance_count = 1,
+                   uint32_t first_instance = 0) const;
+
+    void DrawMultiIndexed(std::span<const VkMultiDrawIndexedInfoEXT> draws,
+                          uint32_t instance_count = 1,
+                          uint32_t first_instance = 0,
+                          const int32_t* vertex_offset = nullptr) const;
+
+    // Execute a command stream written by the GPU (VK_EXT_device_generated_commands, see
+    // IndirectCommandsLayout). Without is_preprocessed the preprocessing happens inline;
+    // otherwise PreprocessGeneratedCommands must have run on the same info, with the
+    // preprocess buffer made visible at COMMAND_PREPROCESS_READ
+    void ExecuteGeneratedCommands(const VkGeneratedCommandsInfoEXT& info, bool is_preprocessed = false) const;
+
+    // Preprocess info ahead of execution; state_command_buffer must have the state bound
+    // that the later ExecuteGeneratedCommands will run with
+    void PreprocessGeneratedCommands(const VkGeneratedCommandsInfoEXT& info, VkCommandBuffer state_command_buffer) const;
+
     // Render pass commands
     // Standard: single clear value (most common). Builds VkRenderPassBeginInfo internally and calls vkCmdBeginRenderPass
     void BeginRenderPass(VkRenderPass render_pass,
@@ -115,6 +196,25 @@ public:
 
     void NextSubpass(VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE) const;
 
+    // Dynamic rendering commands (VK_KHR_dynamic_rendering, see Device::SupportsDynamicRendering)
+    // Standard: color attachments plus optional depth/stencil over render_area, and an
+    // optional shading rate attachment (RenderPass::CreateShadingRateAttachment)
+    void BeginRendering(const VkRect2D& render_area,
+                        std::span<const VkRenderingAttachmentInfoKHR> color_attachments,
+                        const VkRenderingAttachmentInfoKHR* depth_attachment = nullptr,
+                        const VkRenderingAttachmentInfoKHR* stencil_attachment = nullptr,
+                        VkRenderingFlagsKHR flags = 0,
+                        const VkRenderingFragmentShadingRateAttachmentInfoKHR* shading_rate_attachment = nullptr) const;
+
+    // Advanced: directly pass a fully constructed VkRenderingInfoKHR
+    void BeginRendering(const VkRenderingInfoKHR& rendering_info) const;
+
+    void EndRendering() const;
+
+    // Execute secondary command buffers (inside a render pass begun with
+    // SECONDARY_COMMAND_BUFFERS contents, or outside any render pass)
+    void ExecuteCommands(std::span<const VkCommandBuffer> command_buffers) const;
+
     // Memory barriers
     void PipelineBarrier(VkPipelineStageFlags src_stage_mask,
                         VkPipelineStageFlags dst_stage_mask,
@@ -123,6 +223,50 @@ public:
                         std::span<const VkBufferMemoryBarrier> buffer_memory_barriers = {},
                         std::span<const VkImageMemoryBarrier> image_memory_barriers = {}) const;
 
+    // Synchronization2 barriers; translated to vkCmdPipelineBarrier when the device lacks
+    // VK_KHR_synchronization2 (see Utils::SyncUtils)
+    void PipelineBarrier2(const VkDependencyInfoKHR& dependency_info) const;
+
+    void PipelineBarrier2(std::span<const VkMemoryBarrier2KHR> memory_barriers,
+                          std::span<const VkBufferMemoryBarrier2KHR> buffer_memory_barriers = {},
+                          std::span<const VkImageMemoryBarrier2KHR> image_memory_barriers = {},
+                          VkDependencyFlags dependency_flags = 0) const;
+
+    // Event commands. SetEvent2/WaitEvents2 are translated like PipelineBarrier2; the
+    // dependency given to SetEvent2 must be the one later given to WaitEvents2 for that event
+    void SetEvent(VkEvent event, VkPipelineStageFlags stage_mask) const;
+    void SetEvent2(VkEvent event, const VkDependencyInfoKHR& dependency_info) const;
+    void ResetEvent(VkEvent event, VkPipelineStageFlags2KHR stages) const;
+
+    void WaitEvents(std::span<const VkEvent> events,
+                    VkPipelineStageFlags src_stage_mask,
+                    VkPipelineStageFlags dst_stage_mask,
+                    std::span<const VkMemoryBarrier> memory_barriers = {},
+                    std::span<const VkBufferMemoryBarrier> buffer_memory_barriers = {},
+                    std::span<const VkImageMemoryBarrier> image_memory_barriers = {}) const;
+
+    // dependency_infos holds one entry per event
+    void WaitEvents2(std::span<const VkEvent> events, std::span<const VkDependencyInfoKHR> dependency_infos) const;
+
+    // Automatic barriers (see BarrierBatcher): declare how the next command uses a resource
+    // and the barriers it needs against the tracked state are recorded as one batch right
+    // before the next draw, dispatch, copy or render pass begin. Redundant ones are dropped
+    void RequireImage(Image& image, const ResourceAccess& access);
+    void RequireImage(Image& image, const ResourceAccess& access, const VkImageSubresourceRange& range);
+    void RequireBuffer(Buffer& buffer, VkPipelineStageFlags2KHR stages, VkAccessFlags2KHR access);
+
+    // Record the pending required barriers now
+    void FlushBarriers() const;
+
+    // Split the pending required barriers (see BarrierBatcher::FlushSplit): call after the
+    // producer with the consumer's requirements made, then WaitSplitBarriers before the consumer.
+    // The event must be unsignaled, e.g. fresh from an EventPool
+    void SignalSplitBarrier(VkEvent event);
+    void WaitSplitBarriers(std::span<const VkEvent> events);
+
+    // Batcher behind Require*, nullptr until the first requirement
+    [[nodiscard]] const BarrierBatcher* GetBarrierBatcher() const { return barrierBatcher_.get(); }
+
     // Copy commands
     void CopyBuffer(VkBuffer src_buffer, VkBuffer dst_buffer, 
                    std::span<const VkBufferCopy> regions) const;
@@ -135,25 +279,183 @@ public:
                           VkImageLayout dst_image_layout,
                           std::span<const VkBufferImageCopy> regions) const;
 
+    // Fill size bytes (VK_WHOLE_SIZE for the rest) of a buffer with a repeated 32-bit value
+    void FillBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, uint32_t data) const;
+
     // Push constants
     void PushConstants(VkPipelineLayout layout, VkShaderStageFlags stage_flags,
                       uint32_t offset, uint32_t size, const void* values) const;
 
-    void SetViewport(const VkViewport& viewport) {vkCmdSetViewport(commandBuffer_, 0, 1, &viewport);} // single
+    void SetViewport(const VkViewport& viewport) {dispatch_->vkCmdSetViewport(commandBuffer_, 0, 1, &viewport);} // single
     void SetViewports(uint32_t first_viewport, std::span<const VkViewport> viewports) {
-        vkCmdSetViewport(commandBuffer_, first_viewport, static_cast<uint32_t>(viewports.size()), viewports.empty() ? nullptr : viewports.data());
+        dispatch_->vkCmdSetViewport(commandBuffer_, first_viewport, static_cast<uint32_t>(viewports.size()), viewports.empty() ? nullptr : viewports.data());
     }   // multiple
 
-    void SetScissor(const VkRect2D& scissor) {vkCmdSetScissor(commandBuffer_, 0, 1, &scissor);} // single
+    void SetScissor(const VkRect2D& scissor) {dispatch_->vkCmdSetScissor(commandBuffer_, 0, 1, &scissor);} // single
     void SetScissors(uint32_t first_scissor, std::span<const VkRect2D> scissors) {
-        vkCmdSetScissor(commandBuffer_, first_scissor, static_cast<uint32_t>(scissors.size()), scissors.empty() ? nullptr : scissors.data());
+        dispatch_->vkCmdSetScissor(commandBuffer_, first_scissor, static_cast<uint32_t>(scissors.size()), scissors.empty() ? nullptr : scissors.data());
     }   // multiple
 
+    // Core dynamic state
+    void SetLineWidth(float line_width) const { dispatch_->vkCmdSetLineWidth(commandBuffer_, line_width); }
+    void SetDepthBias(float constant_factor, float clamp, float slope_factor) const {
+        dispatch_->vkCmdSetDepthBias(commandBuffer_, constant_factor, clamp, slope_factor);
+    }
+    void SetBlendConstants(const float blend_constants[4]) const { dispatch_->vkCmdSetBlendConstants(commandBuffer_, blend_constants); }
+    void SetDepthBounds(float min_depth_bounds, float max_depth_bounds) const {
+        dispatch_->vkCmdSetDepthBounds(commandBuffer_, min_depth_bounds, max_depth_bounds);
+    }
+    void SetStencilCompareMask(VkStencilFaceFlags face_mask, uint32_t compare_mask) const {
+        dispatch_->vkCmdSetStencilCompareMask(commandBuffer_, face_mask, compare_mask);
+    }
+    void SetStencilWriteMask(VkStencilFaceFlags face_mask, uint32_t write_mask) const {
+        dispatch_->vkCmdSetStencilWriteMask(commandBuffer_, face_mask, write_mask);
+    }
+    void SetStencilReference(VkStencilFaceFlags face_mask, uint32_t reference) const {
+        dispatch_->vkCmdSetStencilReference(commandBuffer_, face_mask, reference);
+    }
+
+    // VK_EXT_extended_dynamic_state
+    void SetCullMode(VkCullModeFlags cull_mode) const { dispatch_->vkCmdSetCullModeEXT(commandBuffer_, cull_mode); }
+    void SetFrontFace(VkFrontFace front_face) const { dispatch_->vkCmdSetFrontFaceEXT(commandBuffer_, front_face); }
+    void SetPrimitiveTopology(VkPrimitiveTopology topology) const { dispatch_->vkCmdSetPrimitiveTopologyEXT(commandBuffer_, topology); }
+    void SetDepthTestEnable(bool enable) const { dispatch_->vkCmdSetDepthTestEnableEXT(commandBuffer_, enable ? VK_TRUE : VK_FALSE); }
+    void SetDepthWriteEnable(bool enable) const { dispatch_->vkCmdSetDepthWriteEnableEXT(commandBuffer_, enable ? VK_TRUE : VK_FALSE); }
+    void SetDepthCompareOp(VkCompareOp compare_op) const { dispatch_->vkCmdSetDepthCompareOpEXT(commandBuffer_, compare_op); }
+    void SetDepthBoundsTestEnable(bool enable) const { dispatch_->vkCmdSetDepthBoundsTestEnableEXT(commandBuffer_, enable ? VK_TRUE : VK_FALSE); }
+    void SetStencilTestEnable(bool enable) const { dispatch_->vkCmdSetStencilTestEnableEXT(commandBuffer_, enable ? VK_TRUE : VK_FALSE); }
+    void SetStencilOp(VkStencilFaceFlags face_mask, VkStencilOp fail_op, VkStencilOp pass_op,
+                      VkStencilOp depth_fail_op, VkCompareOp compare_op) const {
+        dispatch_->vkCmdSetStencilOpEXT(commandBuffer_, face_mask, fail_op, pass_op, depth_fail_op, compare_op);
+    }
+    void SetViewportWithCount(std::span<const VkViewport> viewports) const {
+        dispatch_->vkCmdSetViewportWithCountEXT(commandBuffer_, static_cast<uint32_t>(viewports.size()), viewports.data());
+    }
+    void SetScissorWithCount(std::span<const VkRect2D> scissors) const {
+        dispatch_->vkCmdSetScissorWithCountEXT(commandBuffer_, static_cast<uint32_t>(scissors.size()), scissors.data());
+    }
+
+    // VK_EXT_extended_dynamic_state2
+    void SetRasterizerDiscardEnable(bool enable) const { dispatch_->vkCmdSetRasterizerDiscardEnableEXT(commandBuffer_, enable ? VK_TRUE : VK_FALSE); }
+    void SetDepthBiasEnable(bool enable) const { dispatch_->vkCmdSetDepthBiasEnableEXT(commandBuffer_, enable ? VK_TRUE : VK_FALSE); }
+    void SetPrimitiveRestartEnable(bool enable) const { dispatch_->vkCmdSetPrimitiveRestartEnableEXT(commandBuffer_, enable ? VK_TRUE : VK_FALSE); }
+    void SetLogicOp(VkLogicOp logic_op) const { dispatch_->vkCmdSetLogicOpEXT(commandBuffer_, logic_op); }
+    void SetPatchControlPoints(uint32_t patch_control_points) const { dispatch_->vkCmdSetPatchControlPointsEXT(commandBuffer_, patch_control_points); }
+
+    // VK_EXT_extended_dynamic_state3
+    void SetPolygonMode(VkPolygonMode polygon_mode) const { dispatch_->vkCmdSetPolygonModeEXT(commandBuffer_, polygon_mode); }
+    void SetDepthClampEnable(bool enable) const { dispatch_->vkCmdSetDepthClampEnableEXT(commandBuffer_, enable ? VK_TRUE : VK_FALSE); }
+    void SetRasterizationSamples(VkSampleCountFlagBits samples) const { dispatch_->vkCmdSetRasterizationSamplesEXT(commandBuffer_, samples); }
+    void SetAlphaToCoverageEnable(bool enable) const { dispatch_->vkCmdSetAlphaToCoverageEnableEXT(commandBuffer_, enable ? VK_TRUE : VK_FALSE); }
+    void SetLogicOpEnable(bool enable) const { dispatch_->vkCmdSetLogicOpEnableEXT(commandBuffer_, enable ? VK_TRUE : VK_FALSE); }
+    void SetColorBlendEnable(uint32_t first_attachment, std::span<const VkBool32> enables) const {
+        dispatch_->vkCmdSetColorBlendEnableEXT(commandBuffer_, first_attachment, static_cast<uint32_t>(enables.size()), enables.empty() ? nullptr : enables.data());
+    }
+    void SetColorBlendEquation(uint32_t first_attachment, std::span<const VkColorBlendEquationEXT> equations) const {
+        dispatch_->vkCmdSetColorBlendEquationEXT(commandBuffer_, first_attachment, static_cast<uint32_t>(equations.size()), equations.empty() ? nullptr : equations.data());
+    }
+    void SetColorWriteMask(uint32_t first_attachment, std::span<const VkColorComponentFlags> write_masks) const {
+        dispatch_->vkCmdSetColorWriteMaskEXT(commandBuffer_, first_attachment, static_cast<uint32_t>(write_masks.size()), write_masks.empty() ? nullptr : write_masks.data());
+    }
+    void SetSampleMask(VkSampleCountFlagBits samples, std::span<const VkSampleMask> sample_mask) const {
+        dispatch_->vkCmdSetSampleMaskEXT(commandBuffer_, samples, sample_mask.data());
+    }
+
+    // VK_EXT_vertex_input_dynamic_state (always available with shader objects)
+    void SetVertexInput(std::span<const VkVertexInputBindingDescription2EXT> bindings,
+                        std::span<const VkVertexInputAttributeDescription2EXT> attributes) const {
+        dispatch_->vkCmdSetVertexInputEXT(commandBuffer_,
+                                          static_cast<uint32_t>(bindings.size()), bindings.empty() ? nullptr : bindings.data(),
+                                          static_cast<uint32_t>(attributes.size()), attributes.empty() ? nullptr : attributes.data());
+    }
+
+    // VK_KHR_fragment_shading_rate (VK_DYNAMIC_STATE_FRAGMENT_SHADING_RATE_KHR, see PipelineFragmentShadingRate)
+    void SetFragmentShadingRate(VkExtent2D fragment_size,
+                                VkFragmentShadingRateCombinerOpKHR primitive_combiner = VK_FRAGMENT_SHADING_RATE_COMBINER_OP_KEEP_KHR,
+                                VkFragmentShadingRateCombinerOpKHR attachment_combiner = VK_FRAGMENT_SHADING_RATE_COMBINER_OP_KEEP_KHR) const {
+        const VkFragmentShadingRateCombinerOpKHR combiner_ops[2] = {primitive_combiner, attachment_combiner};
+        dispatch_->vkCmdSetFragmentShadingRateKHR(commandBuffer_, &fragment_size, combiner_ops);
+    }
+
+    // Queries (QueryPool). Resets must be recorded outside render passes
+    void ResetQueryPool(VkQueryPool query_pool, uint32_t first_query, uint32_t query_count) const {
+        dispatch_->vkCmdResetQueryPool(commandBuffer_, query_pool, first_query, query_count);
+    }
+    void WriteTimestamp(VkPipelineStageFlagBits stage, VkQueryPool query_pool, uint32_t query) const {
+        dispatch_->vkCmdWriteTimestamp(commandBuffer_, stage, query_pool, query);
+    }
+    void BeginQuery(VkQueryPool query_pool, uint32_t query, VkQueryControlFlags flags = 0) const {
+        dispatch_->vkCmdBeginQuery(commandBuffer_, query_pool, query, flags);
+    }
+    void EndQuery(VkQueryPool query_pool, uint32_t query) const { dispatch_->vkCmdEndQuery(commandBuffer_, query_pool, query); }
+
+    // Copy query results into dst_buffer (a transfer write) for GPU-side consumption.
+    // stride 0 packs them (QueryPool::GetResultStride); without WAIT_BIT unavailable
+    // results are skipped, so add WITH_AVAILABILITY_BIT or PARTIAL_BIT to see them
+    void CopyQueryPoolResults(const QueryPool& query_pool,
+                              uint32_t first_query,
+                              uint32_t query_count,
+                              const Buffer& dst_buffer,
+                              VkDeviceSize dst_offset = 0,
+                              VkDeviceSize stride = 0,
+                              VkQueryResultFlags flags = VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT) const;
+
+    // Discard the draws and dispatches recorded until EndConditionalRendering when the
+    // uint32 at offset (a multiple of 4) of buffer is zero, or non-zero when inverted
+    // (VK_EXT_conditional_rendering, see Device::SupportsConditionalRendering). buffer needs
+    // CONDITIONAL_RENDERING usage; GPU writes to it (query copies, compute) must be made
+    // visible to the CONDITIONAL_RENDERING stage before the render pass, e.g. with RequireBuffer
+    void BeginConditionalRendering(const Buffer& buffer, VkDeviceSize offset = 0, bool inverted = false) const;
+    void EndConditionalRendering() const { dispatch_->vkCmdEndConditionalRenderingEXT(commandBuffer_); }
+
+    // GPU timing zones (see GpuProfiler) for a buffer submitted to queue. The Renderer
+    // attaches its own buffers; zones do nothing without a profiler
+    void AttachProfiler(GpuProfiler* profiler, QueueType queue = QueueType::GRAPHICS) { profiler_ = profiler; profilerQueue_ = queue; }
+    [[nodiscard]] GpuProfiler* GetProfiler() const { return profiler_; }
+    void BeginZone(std::string_view name) const;
+    void EndZone() const;
+
+    // Debug label regions (VK_EXT_debug_utils) shown by RenderDoc, Nsight and validation
+    // messages. Compiled out with VULKAN_RAII_DEBUG_NAMES=0, and skipped when the
+    // extension is not loaded. Regions must be closed in the command buffer they open in
+    void BeginLabel(const char* name, const std::array<float, 4>& color = {}) const { Utils::BeginCommandLabel(commandBuffer_, name, color); }
+    void EndLabel() const { Utils::EndCommandLabel(commandBuffer_); }
+    void InsertLabel(const char* name, const std::array<float, 4>& color = {}) const { Utils::InsertCommandLabel(commandBuffer_, name, color); }
+
+    // Label region closed when the scope ends
+    class LabelScope {
+    public:
+        LabelScope(const CommandBuffer& command_buffer, const char* name, const std::array<float, 4>& color = {})
+            : commandBuffer_(name ? command_buffer.GetHandle() : VK_NULL_HANDLE)
+        {
+            Utils::BeginCommandLabel(commandBuffer_, name, color);
+        }
+        ~LabelScope() { Utils::EndCommandLabel(commandBuffer_); }
+
+        LabelScope(const LabelScope&) = delete;
+        LabelScope& operator=(const LabelScope&) = delete;
+        LabelScope(LabelScope&&) = delete;
+        LabelScope& operator=(LabelScope&&) = delete;
+
+    private:
+        VkCommandBuffer commandBuffer_;
+    };
+
+    // auto label = command_buffer.ScopedLabel("Shadow pass");
+    [[nodiscard]] LabelScope ScopedLabel(const char* name, const std::array<float, 4>& color = {}) const { return {*this, name, color}; }
+
 private:
     VkCommandBuffer commandBuffer_{VK_NULL_HANDLE};
     VkCommandPool commandPool_{VK_NULL_HANDLE}; // Reference to command pool for cleanup
     VkDevice device_{VK_NULL_HANDLE}; // Device used for allocation/free
+    const VolkDeviceTable* dispatch_{nullptr}; // Taken from the pool's device; every command goes through it
+    bool synchronization2_{false}; // Taken from the pool's device
     bool ownsCommandBuffer_; // Whether we allocated this command buffer, dont set default since this is dependent on constructor used
+    std::unique_ptr<BarrierBatcher> barrierBatcher_; // Created on first Require*
+    GpuProfiler* profiler_{nullptr};
+    QueueType profilerQueue_{QueueType::GRAPHICS};
+
+    BarrierBatcher& GetOrCreateBarrierBatcher();
 
     // Helper methods
     void Cleanup();
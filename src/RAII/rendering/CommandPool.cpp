@@ -1,6 +1,7 @@
 #include "CommandPool.hpp"
 
 #include "../core/Device.hpp"
+#include "../utils/HostAllocator.hpp"
 #include <cstdint>
 #include <stdexcept>
 #include <vector>
@@ -10,7 +11,8 @@ namespace VulkanEngine::RAII {
 CommandPool::CommandPool(const Device& device,
                          uint32_t queue_family_index,
                          VkCommandPoolCreateFlags flags)
-    : device_(device.GetHandle()), queueFamilyIndex_(queue_family_index)
+    : device_(device.GetHandle()), dispatch_(&device.GetDispatch()), queueFamilyIndex_(queue_family_index),
+    synchronization2_(device.SupportsSynchronization2())
 {
     CreateCommandPool(flags);
 }
@@ -22,7 +24,9 @@ CommandPool::~CommandPool() {
 CommandPool::CommandPool(CommandPool&& other) noexcept
     : commandPool_(other.commandPool_),
     device_(other.device_),
-    queueFamilyIndex_(other.queueFamilyIndex_)
+    dispatch_(other.dispatch_),
+    queueFamilyIndex_(other.queueFamilyIndex_),
+    synchronization2_(other.synchronization2_)
 {
     other.commandPool_ = VK_NULL_HANDLE;
     other.device_ = VK_NULL_HANDLE;
@@ -34,7 +38,9 @@ CommandPool& CommandPool::operator=(CommandPool&& other) noexcept {
         Cleanup();
         commandPool_ = other.commandPool_;
         device_ = other.device_;
+        dispatch_ = other.dispatch_;
         queueFamilyIndex_ = other.queueFamilyIndex_;
+        synchronization2_ = other.synchronization2_;
         other.commandPool_ = VK_NULL_HANDLE;
         other.device_ = VK_NULL_HANDLE;
         other.queueFamilyIndex_ = 0;
@@ -50,7 +56,7 @@ std::vector<VkCommandBuffer> CommandPool::AllocateCommandBuffers(uint32_t count,
     alloc_info.commandBufferCount = count;
 
     std::vector<VkCommandBuffer> command_buffers(count);
-    if (vkAllocateCommandBuffers(device_, &alloc_info, command_buffers.data()) != VK_SUCCESS) {
+    if (dispatch_->vkAllocateCommandBuffers(device_, &alloc_info, command_buffers.data()) != VK_SUCCESS) {
         throw std::runtime_error("Failed to allocate command buffers");
     }
     return command_buffers;
@@ -63,23 +69,23 @@ VkCommandBuffer CommandPool::AllocateCommandBuffer(VkCommandBufferLevel level) c
 
 void CommandPool::FreeCommandBuffers(const std::vector<VkCommandBuffer>& command_buffers) const {
     if (!command_buffers.empty()) {
-        vkFreeCommandBuffers(device_, commandPool_, static_cast<uint32_t>(command_buffers.size()), command_buffers.data());
+        dispatch_->vkFreeCommandBuffers(device_, commandPool_, static_cast<uint32_t>(command_buffers.size()), command_buffers.data());
     }
 }
 
 void CommandPool::FreeCommandBuffer(VkCommandBuffer command_buffer) const {
     if (command_buffer != VK_NULL_HANDLE) {
-        vkFreeCommandBuffers(device_, commandPool_, 1, &command_buffer);
+        dispatch_->vkFreeCommandBuffers(device_, commandPool_, 1, &command_buffer);
     }
 }
 
 void CommandPool::Reset(VkCommandPoolResetFlags flags) const {
-    vkResetCommandPool(device_, commandPool_, flags);
+    dispatch_->vkResetCommandPool(device_, commandPool_, flags);
 }
 
 void CommandPool::Trim(VkCommandPoolTrimFlags flags) const {
     if (vkTrimCommandPool) {
-        vkTrimCommandPool(device_, commandPool_, flags);
+        dispatch_->vkTrimCommandPool(device_, commandPool_, flags);
     }
 }
 
@@ -88,14 +94,14 @@ void CommandPool::CreateCommandPool(VkCommandPoolCreateFlags flags) {
     pool_info.queueFamilyIndex = queueFamilyIndex_;
     pool_info.flags = flags;
 
-    if (vkCreateCommandPool(device_, &pool_info, nullptr, &commandPool_) != VK_SUCCESS) {
+    if (dispatch_->vkCreateCommandPool(device_, &pool_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_COMMAND_POOL), &commandPool_) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create command pool");
     }
 }
 
 void CommandPool::Cleanup() {
     if (commandPool_ != VK_NULL_HANDLE) {
-        vkDestroyCommandPool(device_, commandPool_, nullptr);
+        dispatch_->vkDestroyCommandPool(device_, commandPool_, Utils::HostAllocator::For(VK_OBJECT_TYPE_COMMAND_POOL));
         commandPool_ = VK_NULL_HANDLE;
     }
 }
@@ -34,6 +34,9 @@ public:
 
     [[nodiscard]] VkDevice GetDevice() const { return device_; }
 
+    // Entry points of the owning device (Device::GetDispatch)
+    [[nodiscard]] const VolkDeviceTable* GetDispatch() const { return dispatch_; }
+
     // Check if the command pool is valid
     [[nodiscard]] bool IsValid() const { return commandPool_ != VK_NULL_HANDLE; }
 
@@ -59,10 +62,15 @@ public:
     // Get queue family index
     [[nodiscard]] uint32_t GetQueueFamilyIndex() const { return queueFamilyIndex_; }
 
+    // Whether command buffers from this pool record barriers with vkCmdPipelineBarrier2KHR
+    [[nodiscard]] bool SupportsSynchronization2() const { return synchronization2_; }
+
 private:
     VkCommandPool commandPool_{VK_NULL_HANDLE};
     VkDevice device_{VK_NULL_HANDLE}; // Reference to device
+    const VolkDeviceTable* dispatch_{nullptr};
     uint32_t queueFamilyIndex_{0};
+    bool synchronization2_{false};
 
     // Helper methods
     void CreateCommandPool(VkCommandPoolCreateFlags flags);
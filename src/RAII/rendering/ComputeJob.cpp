@@ -0,0 +1,183 @@
+#include "ComputeJob.hpp"
+
+#include "CommandBuffer.hpp"
+#include "../core/Device.hpp"
+#include "../resources/Buffer.hpp"
+#include "../resources/Shader.hpp"
+#include "../resources/ShaderLayoutCache.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+
+namespace VulkanEngine::RAII {
+
+namespace {
+bool IsImageDescriptor(VkDescriptorType type)
+{
+    return type == VK_DESCRIPTOR_TYPE_SAMPLER ||
+           type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ||
+           type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE ||
+           type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE ||
+           type == VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+}
+
+uint32_t DivideRoundUp(uint32_t value, uint32_t divisor)
+{
+    return value / divisor + (value % divisor != 0 ? 1u : 0u);
+}
+} // namespace
+
+ComputeBinding ComputeBinding::FromBuffer(uint32_t binding, const Buffer& buffer, VkDeviceSize offset, VkDeviceSize range)
+{
+    ComputeBinding result{};
+    result.binding = binding;
+    result.buffer = {buffer.GetHandle(), offset, range};
+    return result;
+}
+
+ComputeBinding ComputeBinding::FromImage(uint32_t binding, VkImageView image_view, VkImageLayout layout, VkSampler sampler)
+{
+    ComputeBinding result{};
+    result.binding = binding;
+    result.image = {sampler, image_view, layout};
+    return result;
+}
+
+ComputeJob::ComputeJob(const Device& device,
+                       ShaderLayoutCache& layouts,
+                       const Shader& shader,
+                       const SpecializationConstants& specialization,
+                       std::array<uint32_t, 3> workgroup_size,
+                       VkPipelineCache pipeline_cache)
+{
+    const Shader::ReflectionInfo& reflection = shader.Reflect();
+    if (reflection.stage != VK_SHADER_STAGE_COMPUTE_BIT) {
+        throw std::invalid_argument("ComputeJob requires a compute shader");
+    }
+
+    workgroupSize_ = workgroup_size[0] != 0 ? workgroup_size : reflection.workgroupSize;
+    if (workgroupSize_[0] == 0) {
+        throw std::invalid_argument("Workgroup size of compute shader '" + reflection.entryPoint +
+                                    "' is not known; pass it to ComputeJob");
+    }
+    for (uint32_t& size : workgroupSize_) {
+        size = std::max(size, 1u);
+    }
+
+    ReflectedLayout reflected = layouts.GetLayout({&shader});
+    for (const auto& binding : reflected.reflection.descriptorBindings) {
+        if (binding.set != 0) {
+            continue;
+        }
+        if (binding.IsRuntimeArray()) {
+            throw std::invalid_argument("Push descriptor set 0 cannot hold the runtime array '" + binding.name + "'");
+        }
+        pushBindings_.push_back(binding.layoutBinding);
+    }
+    std::sort(pushBindings_.begin(), pushBindings_.end(),
+              [](const VkDescriptorSetLayoutBinding& a, const VkDescriptorSetLayoutBinding& b) { return a.binding < b.binding; });
+
+    if (!pushBindings_.empty()) {
+        if (!device.SupportsPushDescriptor()) {
+            throw std::runtime_error("ComputeJob requires VK_KHR_push_descriptor");
+        }
+        reflected.setLayouts[0] = layouts.GetSetLayout(pushBindings_, VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR);
+    }
+    pipelineLayout_ = layouts.GetPipelineLayout(reflected.setLayouts, reflected.reflection.pushConstantRanges);
+    for (const VkPushConstantRange& range : reflected.reflection.pushConstantRanges) {
+        pushConstantStages_ |= range.stageFlags;
+    }
+
+    PipelineShaderStage stage{VK_SHADER_STAGE_COMPUTE_BIT, shader.GetHandle()};
+    stage.entryPoint = reflection.entryPoint;
+    stage.specialization = specialization;
+    stage.codeHash = shader.GetCodeHash();
+    pipeline_ = std::make_unique<Pipeline>(device, pipelineLayout_->GetHandle(), stage, VK_NULL_HANDLE, -1, pipeline_cache);
+}
+
+ComputeJob::~ComputeJob() = default;
+
+ComputeJob::ComputeJob(ComputeJob&& other) noexcept = default;
+
+ComputeJob& ComputeJob::operator=(ComputeJob&& other) noexcept = default;
+
+VkPipelineLayout ComputeJob::GetPipelineLayout() const
+{
+    return pipelineLayout_->GetHandle();
+}
+
+void ComputeJob::Bind(const CommandBuffer& command_buffer) const
+{
+    command_buffer.BindPipeline(VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_->GetHandle());
+}
+
+void ComputeJob::PushBindings(const CommandBuffer& command_buffer, std::span<const ComputeBinding> bindings) const
+{
+    if (bindings.empty()) {
+        return;
+    }
+
+    std::vector<VkWriteDescriptorSet> writes;
+    writes.reserve(bindings.size());
+    for (const ComputeBinding& binding : bindings) {
+        auto declared = std::lower_bound(pushBindings_.begin(), pushBindings_.end(), binding.binding,
+                                         [](const VkDescriptorSetLayoutBinding& layout_binding, uint32_t value) {
+                                             return layout_binding.binding < value;
+                                         });
+        if (declared == pushBindings_.end() || declared->binding != binding.binding) {
+            throw std::invalid_argument("Compute shader declares no binding " + std::to_string(binding.binding) + " in set 0");
+        }
+
+        VkWriteDescriptorSet write{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+        write.dstBinding = binding.binding;
+        write.descriptorCount = 1;
+        write.descriptorType = declared->descriptorType;
+        if (IsImageDescriptor(declared->descriptorType)) {
+            write.pImageInfo = &binding.image;
+        } else {
+            write.pBufferInfo = &binding.buffer;
+        }
+        writes.push_back(write);
+    }
+    command_buffer.PushDescriptorSet(VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout_->GetHandle(), 0, writes);
+}
+
+void ComputeJob::PushConstantBytes(const CommandBuffer& command_buffer, uint32_t offset, uint32_t size, const void* data) const
+{
+    if (pushConstantStages_ == 0) {
+        throw std::logic_error("Compute shader declares no push constants");
+    }
+    command_buffer.PushConstants(pipelineLayout_->GetHandle(), pushConstantStages_, offset, size, data);
+}
+
+std::array<uint32_t, 3> ComputeJob::GetGroupCount(uint32_t global_x, uint32_t global_y, uint32_t global_z) const
+{
+    return {DivideRoundUp(global_x, workgroupSize_[0]),
+            DivideRoundUp(global_y, workgroupSize_[1]),
+            DivideRoundUp(global_z, workgroupSize_[2])};
+}
+
+void ComputeJob::Dispatch(const CommandBuffer& command_buffer, uint32_t global_x, uint32_t global_y, uint32_t global_z) const
+{
+    const std::array<uint32_t, 3> groups = GetGroupCount(global_x, global_y, global_z);
+    if (groups[0] == 0 || groups[1] == 0 || groups[2] == 0) {
+        return;
+    }
+    command_buffer.Dispatch(groups[0], groups[1], groups[2]);
+}
+
+void ComputeJob::Run(const CommandBuffer& command_buffer,
+                     std::span<const ComputeBinding> bindings,
+                     uint32_t global_x,
+                     uint32_t global_y,
+                     uint32_t global_z) const
+{
+    Bind(command_buffer);
+    PushBindings(command_buffer, bindings);
+    Dispatch(command_buffer, global_x, global_y, global_z);
+}
+
+} // namespace VulkanEngine::RAII
@@ -0,0 +1,115 @@
+#ifndef VULKAN_RAII_RENDERING_COMPUTE_JOB_HPP
+#define VULKAN_RAII_RENDERING_COMPUTE_JOB_HPP
+
+#include <volk.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "Pipeline.hpp"
+#include "PipelineStructs.hpp"
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+class Buffer; // Forward declaration
+class CommandBuffer; // Forward declaration
+class Shader; // Forward declaration
+class ShaderLayoutCache; // Forward declaration
+class DescriptorSetLayout; // Forward declaration
+class PipelineLayout; // Forward declaration
+
+// One resource pushed into set 0 of a ComputeJob. The descriptor type comes from
+// the shader's reflection, so only the binding and the resource are given
+struct ComputeBinding {
+    uint32_t binding{0};
+    VkDescriptorBufferInfo buffer{};
+    VkDescriptorImageInfo image{};
+
+    static ComputeBinding FromBuffer(uint32_t binding,
+                                     const Buffer& buffer,
+                                     VkDeviceSize offset = 0,
+                                     VkDeviceSize range = VK_WHOLE_SIZE);
+    static ComputeBinding FromImage(uint32_t binding,
+                                    VkImageView image_view,
+                                    VkImageLayout layout = VK_IMAGE_LAYOUT_GENERAL,
+                                    VkSampler sampler = VK_NULL_HANDLE);
+};
+
+// A compute shader ready to dispatch: the pipeline and layout come from its
+// reflection, set 0 becomes a push descriptor set (VK_KHR_push_descriptor) so
+// resources are bound per dispatch without pool allocations, and Dispatch()
+// takes the number of invocations and derives the group counts from the
+// workgroup size. Sets above 0 keep their reflected layouts and are bound by
+// the caller through GetPipelineLayout(). Throws std::runtime_error when the
+// device lacks push descriptors
+class ComputeJob {
+public:
+    // workgroup_size overrides the reflected one; needed when the shader sizes its
+    // workgroup with specialization constants (local_size_x_id), which reflection cannot resolve
+    ComputeJob(const Device& device,
+               ShaderLayoutCache& layouts,
+               const Shader& shader,
+               const SpecializationConstants& specialization = {},
+               std::array<uint32_t, 3> workgroup_size = {0, 0, 0},
+               VkPipelineCache pipeline_cache = VK_NULL_HANDLE);
+
+    // Destructor
+    ~ComputeJob();
+
+    // Move constructor and assignment
+    ComputeJob(ComputeJob&& other) noexcept;
+    ComputeJob& operator=(ComputeJob&& other) noexcept;
+
+    // Delete copy constructor and assignment. this ensures unique ownership of the pipeline.
+    ComputeJob(const ComputeJob&) = delete;
+    ComputeJob& operator=(const ComputeJob&) = delete;
+
+    // Bind the pipeline; resources and push constants stay valid across jobs sharing the layout
+    void Bind(const CommandBuffer& command_buffer) const;
+
+    // Push the resources of set 0. Every binding must be declared by the shader
+    void PushBindings(const CommandBuffer& command_buffer, std::span<const ComputeBinding> bindings) const;
+
+    template<typename T>
+    void PushConstants(const CommandBuffer& command_buffer, const T& constants, uint32_t offset = 0) const
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Push constants must be trivially copyable");
+        PushConstantBytes(command_buffer, offset, sizeof(T), &constants);
+    }
+
+    // Dispatch enough workgroups to cover global_x * global_y * global_z invocations;
+    // shaders bounds-check the invocations past the end. No-op for an empty grid
+    void Dispatch(const CommandBuffer& command_buffer, uint32_t global_x, uint32_t global_y = 1, uint32_t global_z = 1) const;
+
+    // Bind, push and dispatch in one call
+    void Run(const CommandBuffer& command_buffer,
+             std::span<const ComputeBinding> bindings,
+             uint32_t global_x,
+             uint32_t global_y = 1,
+             uint32_t global_z = 1) const;
+
+    // Workgroups Dispatch() launches for the given invocation counts
+    [[nodiscard]] std::array<uint32_t, 3> GetGroupCount(uint32_t global_x, uint32_t global_y = 1, uint32_t global_z = 1) const;
+
+    [[nodiscard]] const std::array<uint32_t, 3>& GetWorkgroupSize() const { return workgroupSize_; }
+    [[nodiscard]] const Pipeline& GetPipeline() const { return *pipeline_; }
+    [[nodiscard]] VkPipelineLayout GetPipelineLayout() const;
+
+private:
+    std::unique_ptr<Pipeline> pipeline_;
+    std::shared_ptr<const PipelineLayout> pipelineLayout_;
+    std::array<uint32_t, 3> workgroupSize_{1, 1, 1};
+    std::vector<VkDescriptorSetLayoutBinding> pushBindings_; // Set 0, sorted by binding
+    VkShaderStageFlags pushConstantStages_{0};
+
+    void PushConstantBytes(const CommandBuffer& command_buffer, uint32_t offset, uint32_t size, const void* data) const;
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RENDERING_COMPUTE_JOB_HPP
@@ -0,0 +1,386 @@
+#include "ComputePrimitives.hpp"
+
+#include "CommandBuffer.hpp"
+#include "../core/Device.hpp"
+#include "../core/PhysicalDevice.hpp"
+#include "../resources/Buffer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+
+namespace VulkanEngine::RAII {
+
+namespace {
+constexpr VkBufferUsageFlags SCRATCH_USAGE = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+constexpr VkBufferUsageFlags RESULT_USAGE = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                            VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                                            VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+                                            VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+
+uint32_t DivideRoundUp(uint32_t value, uint32_t divisor)
+{
+    return value / divisor + (value % divisor != 0 ? 1u : 0u);
+}
+
+std::unique_ptr<Buffer> CreateUintBuffer(const VmaAllocator& allocator, uint32_t count, VkBufferUsageFlags usage, const std::string& name)
+{
+    const VkDeviceSize size = static_cast<VkDeviceSize>(std::max(count, 1u)) * sizeof(uint32_t);
+    return std::make_unique<Buffer>(allocator, size, usage, VMA_MEMORY_USAGE_AUTO, 0, name.c_str());
+}
+
+// A buffer read and written by the same dispatch needs both accesses in one requirement
+void RequireStorage(CommandBuffer& command_buffer, Buffer& buffer, bool read, bool write)
+{
+    VkAccessFlags2KHR access = 0;
+    if (read) {
+        access |= VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR;
+    }
+    if (write) {
+        access |= VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR;
+    }
+    command_buffer.RequireBuffer(buffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, access);
+}
+
+void FillUint(CommandBuffer& command_buffer, Buffer& buffer, uint32_t value)
+{
+    command_buffer.RequireBuffer(buffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+    command_buffer.FillBuffer(buffer.GetHandle(), 0, sizeof(uint32_t), value);
+}
+
+// Element counts of every level of a hierarchical pass over count items, down to one workgroup
+std::vector<uint32_t> GetLevelCounts(const ParallelLaunchShape& shape, uint32_t count)
+{
+    std::vector<uint32_t> counts{count};
+    while (counts.back() > shape.GetItemsPerWorkgroup()) {
+        counts.push_back(shape.GetWorkgroupCount(counts.back()));
+    }
+    return counts;
+}
+
+void ValidateCapacity(const Device& device, const ParallelLaunchShape& shape, uint32_t max_count, const char* primitive)
+{
+    if (max_count == 0 || shape.workgroupSize == 0 || shape.itemsPerThread == 0) {
+        throw std::invalid_argument(std::string(primitive) + " needs a capacity and a non-empty launch shape");
+    }
+    if (shape.GetWorkgroupCount(max_count) > device.GetPhysicalDevice().GetLimits().maxComputeWorkGroupCount[0]) {
+        throw std::invalid_argument(std::string(primitive) + " capacity exceeds the device's workgroup count limit");
+    }
+}
+
+ComputeJob CreateJob(const Device& device, ShaderLayoutCache& layouts, const Shader& shader, const ParallelLaunchShape& shape)
+{
+    return ComputeJob(device, layouts, shader, shape.GetSpecialization(), {shape.workgroupSize, 1, 1});
+}
+
+void DispatchItems(const ComputeJob& job, const CommandBuffer& command_buffer, const ParallelLaunchShape& shape, uint32_t count)
+{
+    job.Dispatch(command_buffer, DivideRoundUp(count, shape.itemsPerThread));
+}
+} // namespace
+
+uint32_t ParallelLaunchShape::GetWorkgroupCount(uint32_t count) const
+{
+    return DivideRoundUp(count, GetItemsPerWorkgroup());
+}
+
+SpecializationConstants ParallelLaunchShape::GetSpecialization() const
+{
+    SpecializationConstants constants;
+    constants.Set(WORKGROUP_SIZE_CONSTANT_ID, workgroupSize)
+        .Set(ITEMS_PER_THREAD_CONSTANT_ID, itemsPerThread)
+        .Set(SUBGROUP_SIZE_CONSTANT_ID, subgroupSize)
+        .Set(SUBGROUP_ARITHMETIC_CONSTANT_ID, subgroupArithmetic)
+        .Set(SUBGROUP_BALLOT_CONSTANT_ID, subgroupBallot);
+    return constants;
+}
+
+ParallelLaunchShape ParallelLaunchShape::FromDevice(const PhysicalDevice& physical_device,
+                                                    uint32_t items_per_thread,
+                                                    uint32_t target_workgroup_size)
+{
+    const VkPhysicalDeviceSubgroupProperties& subgroup = physical_device.GetSubgroupProperties();
+    const VkPhysicalDeviceLimits& limits = physical_device.GetLimits();
+
+    ParallelLaunchShape shape{};
+    shape.subgroupSize = std::max(subgroup.subgroupSize, 1u);
+    shape.itemsPerThread = std::max(items_per_thread, 1u);
+
+    const bool compute_subgroups = (subgroup.supportedStages & VK_SHADER_STAGE_COMPUTE_BIT) != 0;
+    shape.subgroupArithmetic = compute_subgroups && (subgroup.supportedOperations & VK_SUBGROUP_FEATURE_ARITHMETIC_BIT) != 0;
+    shape.subgroupBallot = compute_subgroups && (subgroup.supportedOperations & VK_SUBGROUP_FEATURE_BALLOT_BIT) != 0;
+
+    // Whole subgroups, at most one subgroup's worth of them, within the device limits
+    const uint32_t device_limit = std::min(limits.maxComputeWorkGroupInvocations, limits.maxComputeWorkGroupSize[0]);
+    const uint32_t largest = std::min({target_workgroup_size, device_limit, shape.subgroupSize * shape.subgroupSize});
+    shape.workgroupSize = std::max(largest / shape.subgroupSize, 1u) * shape.subgroupSize;
+    if (shape.workgroupSize > device_limit) {
+        shape.workgroupSize = device_limit; // Subgroups wider than the workgroup limit
+    }
+    return shape;
+}
+
+PrefixSum::PrefixSum(const Device& device,
+                     const VmaAllocator& allocator,
+                     ShaderLayoutCache& layouts,
+                     const Shader& scan_shader,
+                     const Shader& add_shader,
+                     const ParallelLaunchShape& shape,
+                     uint32_t max_count)
+    : shape_(shape),
+    maxCount_(max_count),
+    scan_(CreateJob(device, layouts, scan_shader, shape)),
+    add_(CreateJob(device, layouts, add_shader, shape))
+{
+    ValidateCapacity(device, shape, max_count, "PrefixSum");
+
+    const std::vector<uint32_t> counts = GetLevelCounts(shape_, max_count);
+    for (size_t level = 1; level < counts.size(); ++level) {
+        const std::string suffix = std::to_string(level);
+        blockSums_.push_back(CreateUintBuffer(allocator, counts[level], SCRATCH_USAGE, "PrefixSum block sums " + suffix));
+        scannedBlockSums_.push_back(CreateUintBuffer(allocator, counts[level], SCRATCH_USAGE, "PrefixSum scanned block sums " + suffix));
+    }
+    total_ = CreateUintBuffer(allocator, 1, RESULT_USAGE, "PrefixSum total");
+}
+
+PrefixSum::~PrefixSum() = default;
+
+void PrefixSum::Record(CommandBuffer& command_buffer, Buffer& input, Buffer& output, uint32_t count)
+{
+    if (count > maxCount_) {
+        throw std::out_of_range("PrefixSum of " + std::to_string(count) + " values exceeds its capacity");
+    }
+    if (count == 0) {
+        FillUint(command_buffer, *total_, 0);
+        return;
+    }
+
+    // Scan every level, each writing the block sums the next one scans
+    const std::vector<uint32_t> counts = GetLevelCounts(shape_, count);
+    const size_t top = counts.size() - 1;
+    scan_.Bind(command_buffer);
+    for (size_t level = 0; level <= top; ++level) {
+        Buffer& in = level == 0 ? input : *blockSums_[level - 1];
+        Buffer& out = level == 0 ? output : *scannedBlockSums_[level - 1];
+        Buffer& sums = level == top ? *total_ : *blockSums_[level];
+        if (&in == &out) {
+            RequireStorage(command_buffer, in, true, true);
+        } else {
+            RequireStorage(command_buffer, in, true, false);
+            RequireStorage(command_buffer, out, false, true);
+        }
+        RequireStorage(command_buffer, sums, false, true);
+
+        const std::array<ComputeBinding, 3> bindings{ComputeBinding::FromBuffer(0, in),
+                                                     ComputeBinding::FromBuffer(1, out),
+                                                     ComputeBinding::FromBuffer(2, sums)};
+        scan_.PushBindings(command_buffer, bindings);
+        scan_.PushConstants(command_buffer, Constants{counts[level]});
+        DispatchItems(scan_, command_buffer, shape_, counts[level]);
+    }
+    if (top == 0) {
+        return;
+    }
+
+    // Add the scanned block sums back, from the coarsest level down
+    add_.Bind(command_buffer);
+    for (size_t level = top; level-- > 0;) {
+        Buffer& data = level == 0 ? output : *scannedBlockSums_[level - 1];
+        Buffer& offsets = *scannedBlockSums_[level];
+        RequireStorage(command_buffer, data, true, true);
+        RequireStorage(command_buffer, offsets, true, false);
+
+        const std::array<ComputeBinding, 2> bindings{ComputeBinding::FromBuffer(0, data),
+                                                     ComputeBinding::FromBuffer(1, offsets)};
+        add_.PushBindings(command_buffer, bindings);
+        add_.PushConstants(command_buffer, Constants{counts[level]});
+        DispatchItems(add_, command_buffer, shape_, counts[level]);
+    }
+}
+
+Reduction::Reduction(const Device& device,
+                     const VmaAllocator& allocator,
+                     ShaderLayoutCache& layouts,
+                     const Shader& reduce_shader,
+                     const ParallelLaunchShape& shape,
+                     uint32_t max_count)
+    : shape_(shape),
+    maxCount_(max_count),
+    reduce_(CreateJob(device, layouts, reduce_shader, shape))
+{
+    ValidateCapacity(device, shape, max_count, "Reduction");
+
+    const std::vector<uint32_t> counts = GetLevelCounts(shape_, max_count);
+    for (size_t level = 1; level < counts.size(); ++level) {
+        partials_.push_back(CreateUintBuffer(allocator, counts[level], SCRATCH_USAGE, "Reduction partials " + std::to_string(level)));
+    }
+    result_ = CreateUintBuffer(allocator, 1, RESULT_USAGE, "Reduction result");
+}
+
+Reduction::~Reduction() = default;
+
+void Reduction::Record(CommandBuffer& command_buffer, Buffer& input, uint32_t count, Operation operation)
+{
+    if (count > maxCount_) {
+        throw std::out_of_range("Reduction of " + std::to_string(count) + " values exceeds its capacity");
+    }
+    if (count == 0) {
+        FillUint(command_buffer, *result_, operation == Operation::MIN ? std::numeric_limits<uint32_t>::max() : 0u);
+        return;
+    }
+
+    const std::vector<uint32_t> counts = GetLevelCounts(shape_, count);
+    const size_t top = counts.size() - 1;
+    reduce_.Bind(command_buffer);
+    for (size_t level = 0; level <= top; ++level) {
+        Buffer& in = level == 0 ? input : *partials_[level - 1];
+        Buffer& out = level == top ? *result_ : *partials_[level];
+        RequireStorage(command_buffer, in, true, false);
+        RequireStorage(command_buffer, out, false, true);
+
+        const std::array<ComputeBinding, 2> bindings{ComputeBinding::FromBuffer(0, in),
+                                                     ComputeBinding::FromBuffer(1, out)};
+        reduce_.PushBindings(command_buffer, bindings);
+        reduce_.PushConstants(command_buffer, Constants{counts[level], static_cast<uint32_t>(operation)});
+        DispatchItems(reduce_, command_buffer, shape_, counts[level]);
+    }
+}
+
+StreamCompaction::StreamCompaction(const Device& device,
+                                   const VmaAllocator& allocator,
+                                   ShaderLayoutCache& layouts,
+                                   const Shader& scan_shader,
+                                   const Shader& add_shader,
+                                   const Shader& scatter_shader,
+                                   const ParallelLaunchShape& shape,
+                                   uint32_t max_count)
+    : prefixSum_(device, allocator, layouts, scan_shader, add_shader, shape, max_count),
+    scatter_(CreateJob(device, layouts, scatter_shader, shape)),
+    offsets_(CreateUintBuffer(allocator, max_count, SCRATCH_USAGE, "StreamCompaction offsets"))
+{
+}
+
+StreamCompaction::~StreamCompaction() = default;
+
+void StreamCompaction::Record(CommandBuffer& command_buffer, Buffer& input, Buffer& flags, Buffer& output, uint32_t count)
+{
+    prefixSum_.Record(command_buffer, flags, *offsets_, count);
+    if (count == 0) {
+        return;
+    }
+
+    RequireStorage(command_buffer, input, true, false);
+    RequireStorage(command_buffer, flags, true, false);
+    RequireStorage(command_buffer, *offsets_, true, false);
+    RequireStorage(command_buffer, output, false, true);
+
+    const std::array<ComputeBinding, 4> bindings{ComputeBinding::FromBuffer(0, input),
+                                                 ComputeBinding::FromBuffer(1, flags),
+                                                 ComputeBinding::FromBuffer(2, *offsets_),
+                                                 ComputeBinding::FromBuffer(3, output)};
+    scatter_.Bind(command_buffer);
+    scatter_.PushBindings(command_buffer, bindings);
+    scatter_.PushConstants(command_buffer, Constants{count});
+    DispatchItems(scatter_, command_buffer, prefixSum_.GetShape(), count);
+}
+
+RadixSort::RadixSort(const Device& device,
+                     const VmaAllocator& allocator,
+                     ShaderLayoutCache& layouts,
+                     const Shader& histogram_shader,
+                     const Shader& scan_shader,
+                     const Shader& add_shader,
+                     const Shader& scatter_shader,
+                     const ParallelLaunchShape& shape,
+                     uint32_t max_count)
+    : shape_(shape),
+    maxCount_(max_count),
+    histogram_(CreateJob(device, layouts, histogram_shader, shape)),
+    scatter_(CreateJob(device, layouts, scatter_shader, shape)),
+    prefixSum_(device, allocator, layouts, scan_shader, add_shader, shape, RADIX * shape.GetWorkgroupCount(max_count))
+{
+    ValidateCapacity(device, shape, max_count, "RadixSort");
+
+    histogramBuffer_ = CreateUintBuffer(allocator, RADIX * shape_.GetWorkgroupCount(max_count), SCRATCH_USAGE, "RadixSort histogram");
+    const VkBufferUsageFlags usage = SCRATCH_USAGE | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    scratchKeys_ = CreateUintBuffer(allocator, max_count, usage, "RadixSort scratch keys");
+    scratchValues_ = CreateUintBuffer(allocator, max_count, usage, "RadixSort scratch values");
+}
+
+RadixSort::~RadixSort() = default;
+
+void RadixSort::Record(CommandBuffer& command_buffer, Buffer& keys, Buffer* values, uint32_t count, uint32_t key_bits)
+{
+    if (count > maxCount_) {
+        throw std::out_of_range("RadixSort of " + std::to_string(count) + " keys exceeds its capacity");
+    }
+    if (key_bits == 0 || key_bits > 32) {
+        throw std::invalid_argument("RadixSort sorts by 1 to 32 key bits");
+    }
+    if (count < 2) {
+        return;
+    }
+
+    const uint32_t workgroup_count = shape_.GetWorkgroupCount(count);
+    const uint32_t pass_count = DivideRoundUp(key_bits, RADIX_BITS);
+    const uint32_t has_values = values != nullptr ? 1u : 0u;
+
+    Buffer* keys_in = &keys;
+    Buffer* keys_out = scratchKeys_.get();
+    // Without values the key buffers stand in for the unused bindings
+    Buffer* values_in = values != nullptr ? values : keys_in;
+    Buffer* values_out = values != nullptr ? scratchValues_.get() : keys_out;
+
+    for (uint32_t pass = 0; pass < pass_count; ++pass) {
+        const Constants constants{count, pass * RADIX_BITS, workgroup_count, has_values};
+
+        RequireStorage(command_buffer, *keys_in, true, false);
+        RequireStorage(command_buffer, *histogramBuffer_, false, true);
+        const std::array<ComputeBinding, 2> histogram_bindings{ComputeBinding::FromBuffer(0, *keys_in),
+                                                               ComputeBinding::FromBuffer(1, *histogramBuffer_)};
+        histogram_.Bind(command_buffer);
+        histogram_.PushBindings(command_buffer, histogram_bindings);
+        histogram_.PushConstants(command_buffer, constants);
+        DispatchItems(histogram_, command_buffer, shape_, count);
+
+        prefixSum_.Record(command_buffer, *histogramBuffer_, *histogramBuffer_, RADIX * workgroup_count);
+
+        RequireStorage(command_buffer, *keys_in, true, false);
+        RequireStorage(command_buffer, *keys_out, false, true);
+        if (values != nullptr) {
+            RequireStorage(command_buffer, *values_in, true, false);
+            RequireStorage(command_buffer, *values_out, false, true);
+        }
+        RequireStorage(command_buffer, *histogramBuffer_, true, false);
+        const std::array<ComputeBinding, 5> scatter_bindings{ComputeBinding::FromBuffer(0, *keys_in),
+                                                             ComputeBinding::FromBuffer(1, *keys_out),
+                                                             ComputeBinding::FromBuffer(2, *values_in),
+                                                             ComputeBinding::FromBuffer(3, *values_out),
+                                                             ComputeBinding::FromBuffer(4, *histogramBuffer_)};
+        scatter_.Bind(command_buffer);
+        scatter_.PushBindings(command_buffer, scatter_bindings);
+        scatter_.PushConstants(command_buffer, constants);
+        DispatchItems(scatter_, command_buffer, shape_, count);
+
+        std::swap(keys_in, keys_out);
+        std::swap(values_in, values_out);
+    }
+
+    // An odd number of passes leaves the sorted data in the scratch buffers
+    if (keys_in != &keys) {
+        const VkBufferCopy region{0, 0, static_cast<VkDeviceSize>(count) * sizeof(uint32_t)};
+        command_buffer.RequireBuffer(*keys_in, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_READ_BIT_KHR);
+        command_buffer.RequireBuffer(keys, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+        command_buffer.CopyBuffer(keys_in->GetHandle(), keys.GetHandle(), {&region, 1});
+        if (values != nullptr) {
+            command_buffer.RequireBuffer(*values_in, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_READ_BIT_KHR);
+            command_buffer.RequireBuffer(*values, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+            command_buffer.CopyBuffer(values_in->GetHandle(), values->GetHandle(), {&region, 1});
+        }
+    }
+}
+
+} // namespace VulkanEngine::RAII
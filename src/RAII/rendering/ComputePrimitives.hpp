@@ -0,0 +1,265 @@
+#ifndef VULKAN_RAII_RENDERING_COMPUTE_PRIMITIVES_HPP
+#define VULKAN_RAII_RENDERING_COMPUTE_PRIMITIVES_HPP
+
+#include <volk.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "ComputeJob.hpp"
+#include "PipelineStructs.hpp"
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+class PhysicalDevice; // Forward declaration
+class VmaAllocator; // Forward declaration
+class Buffer; // Forward declaration
+class CommandBuffer; // Forward declaration
+class Shader; // Forward declaration
+class ShaderLayoutCache; // Forward declaration
+
+// Workgroup shape shared by the parallel primitives, sized from the device's
+// subgroup properties: a whole number of subgroups, and no more subgroups than a
+// subgroup has invocations, so a workgroup reduces or scans in two subgroup steps.
+// Shaders receive it through specialization constants:
+//   constant_id 0  workgroup size (declare layout(local_size_x_id = 0) in;)
+//   constant_id 1  items per invocation
+//   constant_id 2  subgroup size
+//   constant_id 3  bool, subgroup arithmetic (subgroupAdd, subgroupExclusiveAdd) is available
+//   constant_id 4  bool, subgroup ballot (subgroupBallot, subgroupBallotBitCount) is available
+// Shaders without the subgroup operations must fall back to shared memory
+struct ParallelLaunchShape {
+    static constexpr uint32_t WORKGROUP_SIZE_CONSTANT_ID = 0;
+    static constexpr uint32_t ITEMS_PER_THREAD_CONSTANT_ID = 1;
+    static constexpr uint32_t SUBGROUP_SIZE_CONSTANT_ID = 2;
+    static constexpr uint32_t SUBGROUP_ARITHMETIC_CONSTANT_ID = 3;
+    static constexpr uint32_t SUBGROUP_BALLOT_CONSTANT_ID = 4;
+
+    uint32_t subgroupSize{32};
+    uint32_t workgroupSize{256};
+    uint32_t itemsPerThread{4};
+    bool subgroupArithmetic{false};
+    bool subgroupBallot{false};
+
+    [[nodiscard]] uint32_t GetItemsPerWorkgroup() const { return workgroupSize * itemsPerThread; }
+
+    // Workgroups covering count items
+    [[nodiscard]] uint32_t GetWorkgroupCount(uint32_t count) const;
+
+    [[nodiscard]] SpecializationConstants GetSpecialization() const;
+
+    // Shape for the device, with the workgroup as close to target_workgroup_size as its limits allow
+    static ParallelLaunchShape FromDevice(const PhysicalDevice& physical_device,
+                                          uint32_t items_per_thread = 4,
+                                          uint32_t target_workgroup_size = 256);
+};
+
+// Exclusive prefix sum of uint32 values. Each workgroup scans GetItemsPerWorkgroup()
+// items and writes its total to a block sum buffer; the block sums are scanned the
+// same way, level by level, and then added back to every block. The sum of all
+// values lands in GetTotalBuffer().
+// Shader contract, with the launch shape's specialization constants:
+//   scan   push Constants; set 0: binding 0 input, binding 1 output (may alias input,
+//          so load every item before storing), binding 2 block sums (one uint per workgroup)
+//   add    push Constants; set 0: binding 0 data, binding 1 scanned block sums;
+//          adds block sum [workgroup] to every item of the workgroup's block
+class PrefixSum {
+public:
+    struct Constants {
+        uint32_t count;
+    };
+
+    // Scratch for max_count values is allocated up front
+    PrefixSum(const Device& device,
+              const VmaAllocator& allocator,
+              ShaderLayoutCache& layouts,
+              const Shader& scan_shader,
+              const Shader& add_shader,
+              const ParallelLaunchShape& shape,
+              uint32_t max_count);
+
+    // Destructor
+    ~PrefixSum();
+
+    // Delete copy and move. recorded command buffers reference the owned scratch buffers.
+    PrefixSum(const PrefixSum&) = delete;
+    PrefixSum& operator=(const PrefixSum&) = delete;
+    PrefixSum(PrefixSum&&) = delete;
+    PrefixSum& operator=(PrefixSum&&) = delete;
+
+    // Record the scan of count values of input into output (which may be input)
+    void Record(CommandBuffer& command_buffer, Buffer& input, Buffer& output, uint32_t count);
+
+    // A uint holding the sum of the last recorded scan's values
+    [[nodiscard]] Buffer& GetTotalBuffer() const { return *total_; }
+    [[nodiscard]] uint32_t GetMaxCount() const { return maxCount_; }
+    [[nodiscard]] const ParallelLaunchShape& GetShape() const { return shape_; }
+
+private:
+    ParallelLaunchShape shape_;
+    uint32_t maxCount_{0};
+    ComputeJob scan_;
+    ComputeJob add_;
+    std::vector<std::unique_ptr<Buffer>> blockSums_; // Level l + 1 input
+    std::vector<std::unique_ptr<Buffer>> scannedBlockSums_; // Level l + 1 output
+    std::unique_ptr<Buffer> total_;
+};
+
+// Reduction of uint32 values to one, in as many passes as it takes to get the
+// per-workgroup partials down to a single workgroup.
+// Shader contract, with the launch shape's specialization constants:
+//   push Constants; set 0: binding 0 input, binding 1 output (one uint per workgroup)
+class Reduction {
+public:
+    enum class Operation : uint32_t {
+        SUM = 0,
+        MIN = 1,
+        MAX = 2
+    };
+
+    struct Constants {
+        uint32_t count;
+        uint32_t operation; // Operation
+    };
+
+    Reduction(const Device& device,
+              const VmaAllocator& allocator,
+              ShaderLayoutCache& layouts,
+              const Shader& reduce_shader,
+              const ParallelLaunchShape& shape,
+              uint32_t max_count);
+
+    // Destructor
+    ~Reduction();
+
+    // Delete copy and move. recorded command buffers reference the owned scratch buffers.
+    Reduction(const Reduction&) = delete;
+    Reduction& operator=(const Reduction&) = delete;
+    Reduction(Reduction&&) = delete;
+    Reduction& operator=(Reduction&&) = delete;
+
+    // Record the reduction of count values of input; an empty input yields the identity
+    void Record(CommandBuffer& command_buffer, Buffer& input, uint32_t count, Operation operation = Operation::SUM);
+
+    // A uint holding the last recorded result
+    [[nodiscard]] Buffer& GetResultBuffer() const { return *result_; }
+    [[nodiscard]] uint32_t GetMaxCount() const { return maxCount_; }
+
+private:
+    ParallelLaunchShape shape_;
+    uint32_t maxCount_{0};
+    ComputeJob reduce_;
+    std::vector<std::unique_ptr<Buffer>> partials_;
+    std::unique_ptr<Buffer> result_;
+};
+
+// Stream compaction: keeps the uint32 values whose flag is set, in order. The
+// caller writes one flag (0 or 1) per value, the flags are prefix summed into
+// output offsets and a scatter pass moves the kept values.
+// Shader contract, with the launch shape's specialization constants:
+//   scan, add  as PrefixSum
+//   scatter    push Constants; set 0: binding 0 input, binding 1 flags,
+//              binding 2 offsets, binding 3 output
+class StreamCompaction {
+public:
+    struct Constants {
+        uint32_t count;
+    };
+
+    StreamCompaction(const Device& device,
+                     const VmaAllocator& allocator,
+                     ShaderLayoutCache& layouts,
+                     const Shader& scan_shader,
+                     const Shader& add_shader,
+                     const Shader& scatter_shader,
+                     const ParallelLaunchShape& shape,
+                     uint32_t max_count);
+
+    // Destructor
+    ~StreamCompaction();
+
+    // Delete copy and move. recorded command buffers reference the owned scratch buffers.
+    StreamCompaction(const StreamCompaction&) = delete;
+    StreamCompaction& operator=(const StreamCompaction&) = delete;
+    StreamCompaction(StreamCompaction&&) = delete;
+    StreamCompaction& operator=(StreamCompaction&&) = delete;
+
+    // Record the compaction of count values of input into output (which holds up to count values)
+    void Record(CommandBuffer& command_buffer, Buffer& input, Buffer& flags, Buffer& output, uint32_t count);
+
+    // A uint holding how many values the last recorded compaction kept (usable as an indirect count)
+    [[nodiscard]] Buffer& GetCountBuffer() const { return prefixSum_.GetTotalBuffer(); }
+    [[nodiscard]] Buffer& GetOffsetBuffer() const { return *offsets_; }
+
+private:
+    PrefixSum prefixSum_;
+    ComputeJob scatter_;
+    std::unique_ptr<Buffer> offsets_;
+};
+
+// Least significant digit radix sort of uint32 keys with optional uint32 values,
+// RADIX_BITS per pass. Every pass counts digits per workgroup, prefix sums the
+// digit-major histogram into scatter offsets and scatters stably, ping-ponging
+// between the caller's buffers and internal ones; sorted data ends in the caller's.
+// Shader contract, with the launch shape's specialization constants:
+//   histogram  push Constants; set 0: binding 0 keys, binding 1 histogram, where workgroup w
+//              writes all RADIX counters to histogram[digit * workgroupCount + w]
+//   scan, add  as PrefixSum
+//   scatter    push Constants; set 0: binding 0 keys in, binding 1 keys out, binding 2 values in,
+//              binding 3 values out, binding 4 scanned histogram; an item goes to
+//              histogram[digit * workgroupCount + w] plus its rank among the workgroup's
+//              earlier items with the same digit. Values are moved only when hasValues is set
+class RadixSort {
+public:
+    static constexpr uint32_t RADIX_BITS = 8;
+    static constexpr uint32_t RADIX = 1u << RADIX_BITS;
+
+    struct Constants {
+        uint32_t count;
+        uint32_t shift; // Bit offset of the pass's digit
+        uint32_t workgroupCount;
+        uint32_t hasValues;
+    };
+
+    RadixSort(const Device& device,
+              const VmaAllocator& allocator,
+              ShaderLayoutCache& layouts,
+              const Shader& histogram_shader,
+              const Shader& scan_shader,
+              const Shader& add_shader,
+              const Shader& scatter_shader,
+              const ParallelLaunchShape& shape,
+              uint32_t max_count);
+
+    // Destructor
+    ~RadixSort();
+
+    // Delete copy and move. recorded command buffers reference the owned scratch buffers.
+    RadixSort(const RadixSort&) = delete;
+    RadixSort& operator=(const RadixSort&) = delete;
+    RadixSort(RadixSort&&) = delete;
+    RadixSort& operator=(RadixSort&&) = delete;
+
+    // Record the sort of count keys (and values when given) by their low key_bits bits.
+    // Keys that only use low bits sort in fewer passes; an odd pass count copies the
+    // result back, so keys and values then need TRANSFER_DST usage
+    void Record(CommandBuffer& command_buffer, Buffer& keys, Buffer* values, uint32_t count, uint32_t key_bits = 32);
+
+    [[nodiscard]] uint32_t GetMaxCount() const { return maxCount_; }
+
+private:
+    ParallelLaunchShape shape_;
+    uint32_t maxCount_{0};
+    ComputeJob histogram_;
+    ComputeJob scatter_;
+    PrefixSum prefixSum_;
+    std::unique_ptr<Buffer> histogramBuffer_;
+    std::unique_ptr<Buffer> scratchKeys_;
+    std::unique_ptr<Buffer> scratchValues_;
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RENDERING_COMPUTE_PRIMITIVES_HPP
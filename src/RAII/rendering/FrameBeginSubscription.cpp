@@ -0,0 +1,42 @@
+#include "FrameBeginSubscription.hpp"
+
+#include "Renderer.hpp"
+
+#include <utility>
+
+
+namespace VulkanEngine::RAII {
+
+FrameBeginSubscription::FrameBeginSubscription(Renderer& renderer, uint32_t callback_id)
+    : renderer_(&renderer),
+    callbackId_(callback_id) {}
+
+FrameBeginSubscription::~FrameBeginSubscription()
+{
+    Reset();
+}
+
+FrameBeginSubscription::FrameBeginSubscription(FrameBeginSubscription&& other) noexcept
+    : renderer_(std::exchange(other.renderer_, nullptr)),
+    callbackId_(std::exchange(other.callbackId_, 0)) {}
+
+FrameBeginSubscription& FrameBeginSubscription::operator=(FrameBeginSubscription&& other) noexcept
+{
+    if (this != &other) {
+        Reset();
+        renderer_ = std::exchange(other.renderer_, nullptr);
+        callbackId_ = std::exchange(other.callbackId_, 0);
+    }
+    return *this;
+}
+
+void FrameBeginSubscription::Reset()
+{
+    if (renderer_) {
+        renderer_->RemoveFrameBeginCallback(callbackId_);
+        renderer_ = nullptr;
+        callbackId_ = 0;
+    }
+}
+
+} // namespace VulkanEngine::RAII
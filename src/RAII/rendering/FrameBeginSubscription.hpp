@@ -0,0 +1,44 @@
+#ifndef VULKAN_RAII_RENDERING_FRAME_BEGIN_SUBSCRIPTION_HPP
+#define VULKAN_RAII_RENDERING_FRAME_BEGIN_SUBSCRIPTION_HPP
+
+#include <cstdint>
+
+namespace VulkanEngine::RAII {
+
+class Renderer; // Forward declaration
+
+// A frame-begin callback registered with Renderer::SubscribeFrameBegin. The callback
+// is removed when the subscription is reset or destroyed; the renderer must outlive it
+class FrameBeginSubscription {
+public:
+    FrameBeginSubscription() = default;
+
+    // Destructor
+    ~FrameBeginSubscription();
+
+    // Move constructor and assignment
+    FrameBeginSubscription(FrameBeginSubscription&& other) noexcept;
+    FrameBeginSubscription& operator=(FrameBeginSubscription&& other) noexcept;
+
+    // Delete copy constructor and assignment
+    FrameBeginSubscription(const FrameBeginSubscription&) = delete;
+    FrameBeginSubscription& operator=(const FrameBeginSubscription&) = delete;
+
+    // Remove the callback now
+    void Reset();
+
+    [[nodiscard]] bool IsActive() const { return renderer_ != nullptr; }
+    [[nodiscard]] Renderer* GetRenderer() const { return renderer_; }
+
+private:
+    friend class Renderer;
+
+    FrameBeginSubscription(Renderer& renderer, uint32_t callback_id);
+
+    Renderer* renderer_{nullptr};
+    uint32_t callbackId_{0};
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RENDERING_FRAME_BEGIN_SUBSCRIPTION_HPP
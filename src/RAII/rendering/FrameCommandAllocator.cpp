@@ -0,0 +1,84 @@
+#include "FrameCommandAllocator.hpp"
+
+#include "CommandBuffer.hpp"
+#include "CommandPool.hpp"
+#include "Renderer.hpp"
+#include "../core/Device.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+
+namespace VulkanEngine::RAII {
+
+FrameCommandAllocator::FrameCommandAllocator(const Device& device, uint32_t queue_family_index, uint32_t frame_count)
+    : device_(&device),
+    queueFamilyIndex_(queue_family_index),
+    frames_(std::max(1u, frame_count))
+{
+    for (Frame& frame : frames_) {
+        frame.pool = std::make_unique<CommandPool>(device, queue_family_index, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+    }
+}
+
+FrameCommandAllocator::~FrameCommandAllocator()
+{
+    Detach();
+}
+
+void FrameCommandAllocator::AttachToRenderer(Renderer& renderer)
+{
+    Detach();
+    if (renderer.GetMaxFramesInFlight() > frames_.size()) {
+        throw std::invalid_argument("FrameCommandAllocator has fewer frames than the renderer has frames in flight");
+    }
+    frameBeginSubscription_ = renderer.SubscribeFrameBegin([this](uint32_t frame_index) {
+        BeginFrame(frame_index);
+    });
+}
+
+void FrameCommandAllocator::Detach()
+{
+    frameBeginSubscription_.Reset();
+}
+
+void FrameCommandAllocator::BeginFrame(uint32_t frame_index)
+{
+    currentFrame_ = frame_index % static_cast<uint32_t>(frames_.size());
+    Frame& frame = frames_[currentFrame_];
+    if (frame.primary.used > 0 || frame.secondary.used > 0) {
+        frame.pool->Reset();
+    }
+    frame.primary.used = 0;
+    frame.secondary.used = 0;
+}
+
+CommandBuffer& FrameCommandAllocator::Allocate(VkCommandBufferLevel level)
+{
+    Frame& frame = frames_[currentFrame_];
+    LevelList& list = level == VK_COMMAND_BUFFER_LEVEL_SECONDARY ? frame.secondary : frame.primary;
+    if (list.used == list.buffers.size()) {
+        list.buffers.push_back(std::make_unique<CommandBuffer>(*frame.pool, level));
+    }
+    return *list.buffers[list.used++];
+}
+
+size_t FrameCommandAllocator::GetAllocatedCount() const
+{
+    const Frame& frame = frames_[currentFrame_];
+    return frame.primary.used + frame.secondary.used;
+}
+
+size_t FrameCommandAllocator::GetCommandBufferCount() const
+{
+    size_t count = 0;
+    for (const Frame& frame : frames_) {
+        count += frame.primary.buffers.size() + frame.secondary.buffers.size();
+    }
+    return count;
+}
+
+} // namespace VulkanEngine::RAII
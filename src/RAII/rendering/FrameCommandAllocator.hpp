@@ -0,0 +1,82 @@
+#ifndef VULKAN_RAII_RENDERING_FRAME_COMMAND_ALLOCATOR_HPP
+#define VULKAN_RAII_RENDERING_FRAME_COMMAND_ALLOCATOR_HPP
+
+#include <volk.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "FrameBeginSubscription.hpp"
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+class Renderer; // Forward declaration
+class CommandPool; // Forward declaration
+class CommandBuffer; // Forward declaration
+
+// Per-frame command buffer allocator with one transient CommandPool per frame in
+// flight. The pool of a frame is reset as a whole (vkResetCommandPool) when the
+// frame begins, and the command buffers allocated from it are kept on a free
+// list and handed out again, so the hot path never allocates, frees or resets
+// individual buffers. Pools do not need RESET_COMMAND_BUFFER_BIT.
+// Not thread-safe; use one allocator per recording thread.
+class FrameCommandAllocator {
+public:
+    // Constructor
+    FrameCommandAllocator(const Device& device, uint32_t queue_family_index, uint32_t frame_count);
+
+    // Destructor
+    ~FrameCommandAllocator();
+
+    // Delete copy and move. the attached renderer holds a callback referencing this object.
+    FrameCommandAllocator(const FrameCommandAllocator&) = delete;
+    FrameCommandAllocator& operator=(const FrameCommandAllocator&) = delete;
+    FrameCommandAllocator(FrameCommandAllocator&&) = delete;
+    FrameCommandAllocator& operator=(FrameCommandAllocator&&) = delete;
+
+    // Recycle frames automatically from Renderer::BeginFrame. The renderer must outlive
+    // this allocator or Detach() must be called first
+    void AttachToRenderer(Renderer& renderer);
+    void Detach();
+
+    // Reset the pool of frame_index and make it current (called by the attached renderer).
+    // Command buffers handed out for that frame return to the free list
+    void BeginFrame(uint32_t frame_index);
+
+    // Command buffer of the current frame in the initial state, ready for Begin()
+    [[nodiscard]] CommandBuffer& Allocate(VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+
+    // Command buffers handed out for the current frame, and owned across all frames
+    [[nodiscard]] size_t GetAllocatedCount() const;
+    [[nodiscard]] size_t GetCommandBufferCount() const;
+
+    [[nodiscard]] uint32_t GetQueueFamilyIndex() const { return queueFamilyIndex_; }
+    [[nodiscard]] uint32_t GetFrameCount() const { return static_cast<uint32_t>(frames_.size()); }
+    [[nodiscard]] uint32_t GetCurrentFrame() const { return currentFrame_; }
+
+private:
+    struct LevelList {
+        std::vector<std::unique_ptr<CommandBuffer>> buffers;
+        size_t used{0};
+    };
+
+    struct Frame {
+        std::unique_ptr<CommandPool> pool; // Declared first so buffers are freed before it
+        LevelList primary;
+        LevelList secondary;
+    };
+
+    const Device* device_{nullptr};
+    uint32_t queueFamilyIndex_{0};
+    std::vector<Frame> frames_;
+    uint32_t currentFrame_{0};
+
+    FrameBeginSubscription frameBeginSubscription_;
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RENDERING_FRAME_COMMAND_ALLOCATOR_HPP
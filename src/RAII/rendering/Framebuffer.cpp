@@ -2,6 +2,7 @@
 
 #include "RenderPass.hpp"
 #include "../core/Device.hpp"
+#include "../utils/HostAllocator.hpp"
 
 #include <cstdint>
 #include <stdexcept>
@@ -88,14 +89,14 @@ void Framebuffer::CreateFramebuffer() {
     framebuffer_info.height = height_;
     framebuffer_info.layers = layers_;
 
-    if (vkCreateFramebuffer(device_, &framebuffer_info, nullptr, &framebuffer_) != VK_SUCCESS) {
+    if (vkCreateFramebuffer(device_, &framebuffer_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_FRAMEBUFFER), &framebuffer_) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create framebuffer");
     }
 }
 
 void Framebuffer::Cleanup() {
     if (framebuffer_ != VK_NULL_HANDLE) {
-        vkDestroyFramebuffer(device_, framebuffer_, nullptr);
+        vkDestroyFramebuffer(device_, framebuffer_, Utils::HostAllocator::For(VK_OBJECT_TYPE_FRAMEBUFFER));
         framebuffer_ = VK_NULL_HANDLE;
     }
     device_ = VK_NULL_HANDLE;
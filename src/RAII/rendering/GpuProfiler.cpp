@@ -0,0 +1,262 @@
+#include "GpuProfiler.hpp"
+
+#include "QueryPool.hpp"
+#include "Renderer.hpp"
+#include "../core/Device.hpp"
+#include "../core/PhysicalDevice.hpp"
+#include "../utils/Timer.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+
+namespace VulkanEngine::RAII {
+
+namespace {
+
+constexpr size_t NO_ZONE = SIZE_MAX; // Open zone that was dropped (slot full or blocked)
+
+uint64_t GetValidMask(uint32_t valid_bits)
+{
+    if (valid_bits == 0) {
+        return 0;
+    }
+    return valid_bits >= 64 ? UINT64_MAX : (uint64_t{1} << valid_bits) - 1;
+}
+
+} // namespace
+
+GpuProfiler::GpuProfiler(const Device& device, uint32_t frames_in_flight, uint32_t max_zones_per_frame)
+    : dispatch_(&device.GetDispatch()),
+    maxQueries_(max_zones_per_frame * 2)
+{
+    if (frames_in_flight == 0 || max_zones_per_frame == 0) {
+        throw std::invalid_argument("GpuProfiler requires at least one frame slot and zone");
+    }
+    if (!device.SupportsHostQueryReset()) {
+        throw std::runtime_error("GpuProfiler requires host query reset support");
+    }
+
+    const PhysicalDevice& physical_device = device.GetPhysicalDevice();
+    timestampPeriodNs_ = physical_device.GetProperties().limits.timestampPeriod;
+    const std::vector<VkQueueFamilyProperties>& families = physical_device.GetQueueFamilyProperties();
+    const QueueFamilyIndices& indices = device.GetQueueFamilyIndices();
+    const uint32_t graphics_family = indices.graphicsFamily_.value_or(0);
+
+    const std::pair<QueueType, uint32_t> queue_families[] = {
+        {QueueType::GRAPHICS, graphics_family},
+        {QueueType::COMPUTE, indices.computeFamily_.value_or(graphics_family)},
+        {QueueType::TRANSFER, indices.transferFamily_.value_or(graphics_family)},
+    };
+    for (const auto& [queue, family] : queue_families) {
+        QueueState& state = GetQueueState(queue);
+        state.validMask = family < families.size() ? GetValidMask(families[family].timestampValidBits) : 0;
+        if (state.validMask == 0) {
+            continue;
+        }
+        state.slots.resize(frames_in_flight);
+        for (FrameSlot& slot : state.slots) {
+            slot.pool = std::make_unique<QueryPool>(device, VK_QUERY_TYPE_TIMESTAMP, maxQueries_);
+            slot.pool->Reset();
+        }
+    }
+}
+
+GpuProfiler::~GpuProfiler() {
+    Detach();
+}
+
+void GpuProfiler::AttachToRenderer(Renderer& renderer)
+{
+    Detach();
+    renderer_ = &renderer;
+    renderer.SetGpuProfiler(this);
+    frameBeginSubscription_ = renderer.SubscribeFrameBegin([this](uint32_t frame_index) {
+        BeginFrame(frame_index);
+    });
+}
+
+void GpuProfiler::Detach()
+{
+    frameBeginSubscription_.Reset();
+    if (renderer_) {
+        renderer_->SetGpuProfiler(nullptr);
+        renderer_ = nullptr;
+    }
+}
+
+void GpuProfiler::BeginFrame(uint32_t frame_index)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Zone> resolved;
+    bool any_resolved = false;
+    uint64_t resolved_submit_ns = 0;
+    const uint64_t now_ns = Utils::Timer::NowNanoseconds();
+    for (QueueState& state : queues_) {
+        if (state.slots.empty()) {
+            continue;
+        }
+        currentSlot_ = frame_index % static_cast<uint32_t>(state.slots.size());
+        state.openZones.clear();
+        FrameSlot& slot = state.slots[currentSlot_];
+        if (slot.usedQueries > 0) {
+            const QueueType queue = static_cast<QueueType>(&state - queues_.data());
+            if (!ResolveSlot(queue, slot, state.validMask, resolved)) {
+                // Resetting queries the GPU may still write is not allowed; try again next time
+                slot.blocked = true;
+                continue;
+            }
+            any_resolved = true;
+            resolved_submit_ns = slot.submitNs;
+            slot.pool->Reset(0, slot.usedQueries);
+        }
+        slot.zones.clear();
+        slot.usedQueries = 0;
+        slot.blocked = false;
+        slot.submitNs = now_ns;
+    }
+    if (any_resolved) {
+        results_ = std::move(resolved);
+        resultsSubmitNs_ = resolved_submit_ns;
+        resolvedFrames_++;
+    }
+}
+
+void GpuProfiler::BeginZone(VkCommandBuffer command_buffer, QueueType queue, std::string_view name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    QueueState& state = GetQueueState(queue);
+    if (state.slots.empty()) {
+        return;
+    }
+    FrameSlot& slot = state.slots[currentSlot_];
+    if (slot.blocked || slot.usedQueries + 2 > maxQueries_) {
+        state.openZones.push_back(NO_ZONE); // Keeps EndZone balanced
+        return;
+    }
+
+    PendingZone zone;
+    zone.name = name;
+    zone.beginQuery = slot.usedQueries;
+    zone.depth = static_cast<uint32_t>(state.openZones.size());
+    slot.usedQueries += 2; // The end query is reserved up front
+    dispatch_->vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, *slot.pool, zone.beginQuery);
+    state.openZones.push_back(slot.zones.size());
+    slot.zones.push_back(std::move(zone));
+}
+
+void GpuProfiler::EndZone(VkCommandBuffer command_buffer, QueueType queue)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    QueueState& state = GetQueueState(queue);
+    if (state.slots.empty()) {
+        return;
+    }
+    if (state.openZones.empty()) {
+        throw std::logic_error("GpuProfiler::EndZone without a matching BeginZone");
+    }
+    const size_t zone_index = state.openZones.back();
+    state.openZones.pop_back();
+    if (zone_index == NO_ZONE) {
+        return;
+    }
+    FrameSlot& slot = state.slots[currentSlot_];
+    PendingZone& zone = slot.zones[zone_index];
+    zone.endQuery = zone.beginQuery + 1;
+    dispatch_->vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, *slot.pool, zone.endQuery);
+}
+
+std::vector<GpuProfiler::Zone> GpuProfiler::GetResults() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return results_;
+}
+
+double GpuProfiler::GetZoneMs(std::string_view name) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    double total = 0.0;
+    for (const Zone& zone : results_) {
+        if (zone.name == name) {
+            total += zone.durationMs;
+        }
+    }
+    return total;
+}
+
+bool GpuProfiler::IsSupported(QueueType queue) const
+{
+    const size_t index = queue == QueueType::PRESENT ? static_cast<size_t>(QueueType::GRAPHICS) : static_cast<size_t>(queue);
+    return queues_[index].validMask != 0;
+}
+
+void GpuProfiler::MarkSubmit()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint64_t now_ns = Utils::Timer::NowNanoseconds();
+    for (QueueState& state : queues_) {
+        if (!state.slots.empty()) {
+            state.slots[currentSlot_].submitNs = now_ns;
+        }
+    }
+}
+
+uint64_t GpuProfiler::GetResultsSubmitNs() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return resultsSubmitNs_;
+}
+
+uint64_t GpuProfiler::GetResolvedFrameCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return resolvedFrames_;
+}
+
+GpuProfiler::QueueState& GpuProfiler::GetQueueState(QueueType queue)
+{
+    // Presents record nothing; treat the present queue as the graphics queue
+    const size_t index = queue == QueueType::PRESENT ? static_cast<size_t>(QueueType::GRAPHICS) : static_cast<size_t>(queue);
+    return queues_[index];
+}
+
+bool GpuProfiler::ResolveSlot(QueueType queue, const FrameSlot& slot, uint64_t valid_mask, std::vector<Zone>& results) const
+{
+    // (value, availability) pairs
+    std::vector<uint64_t> data(static_cast<size_t>(slot.usedQueries) * 2);
+    const VkResult result = slot.pool->GetResults(0, slot.usedQueries, data, VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    if (result != VK_SUCCESS && result != VK_NOT_READY) {
+        throw std::runtime_error("Failed to read GPU profiler timestamps");
+    }
+    auto available = [&data](uint32_t query) { return data[static_cast<size_t>(query) * 2 + 1] != 0; };
+    auto value = [&data, valid_mask](uint32_t query) { return data[static_cast<size_t>(query) * 2] & valid_mask; };
+
+    // Zones left open never wrote their end query; only their begin has to finish
+    uint64_t origin = UINT64_MAX;
+    for (const PendingZone& zone : slot.zones) {
+        if (!available(zone.beginQuery) || (zone.endQuery != UINT32_MAX && !available(zone.endQuery))) {
+            return false;
+        }
+        origin = std::min(origin, value(zone.beginQuery));
+    }
+
+    const double ms_per_tick = timestampPeriodNs_ / 1'000'000.0;
+    for (const PendingZone& zone : slot.zones) {
+        if (zone.endQuery == UINT32_MAX) {
+            continue;
+        }
+        Zone resolved;
+        resolved.name = zone.name;
+        resolved.queue = queue;
+        resolved.depth = zone.depth;
+        // Masked differences stay correct across counter wrap-around
+        resolved.startMs = static_cast<double>((value(zone.beginQuery) - origin) & valid_mask) * ms_per_tick;
+        resolved.durationMs = static_cast<double>((value(zone.endQuery) - value(zone.beginQuery)) & valid_mask) * ms_per_tick;
+        results.push_back(std::move(resolved));
+    }
+    return true;
+}
+
+} // namespace VulkanEngine::RAII
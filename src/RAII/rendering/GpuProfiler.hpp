@@ -0,0 +1,129 @@
+#ifndef VULKAN_RAII_RENDERING_GPU_PROFILER_HPP
+#define VULKAN_RAII_RENDERING_GPU_PROFILER_HPP
+
+#include <volk.h>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "FrameBeginSubscription.hpp"
+#include "../core/Queue.hpp"
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+class QueryPool; // Forward declaration
+class Renderer; // Forward declaration
+
+// Named GPU timing zones from timestamp queries, e.g.
+//     command_buffer.BeginZone("shadow"); ... command_buffer.EndZone();
+// Each queue type (graphics, compute, transfer) has its own timestamp pool per frame
+// in flight. A slot's results are read back without waiting when its frame index
+// begins again; zones whose queries are not available yet (work still running on
+// another queue) are skipped, and that slot records no new zones until they are.
+// Zones nest per queue; record one queue's zones from one thread at a time.
+class GpuProfiler {
+public:
+    struct Zone {
+        std::string name;
+        QueueType queue{QueueType::GRAPHICS};
+        uint32_t depth{0}; // Nesting level, 0 for top-level zones
+        double startMs{0.0}; // From the frame's first timestamp on the same queue
+        double durationMs{0.0};
+    };
+
+    // Constructor. frames_in_flight slots (usually Renderer::GetMaxFramesInFlight()),
+    // each with room for max_zones_per_frame zones per queue. Needs host query resets
+    explicit GpuProfiler(const Device& device, uint32_t frames_in_flight, uint32_t max_zones_per_frame = 256);
+
+    // Destructor
+    ~GpuProfiler();
+
+    // Delete copy and move. the attached renderer and command buffers keep pointers to this object.
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+    GpuProfiler(GpuProfiler&&) = delete;
+    GpuProfiler& operator=(GpuProfiler&&) = delete;
+
+    // Resolve and recycle a slot at its frame begin, and attach to the renderer's
+    // graphics and compute command buffers every frame. The renderer must outlive
+    // this profiler or Detach() must be called first
+    void AttachToRenderer(Renderer& renderer);
+    void Detach();
+
+    // Read back the slot of frame_index and reuse it for the frame starting now (done
+    // by the renderer once attached; call it per frame when driving submissions manually)
+    void BeginFrame(uint32_t frame_index);
+
+    // Write the zone's timestamps into command_buffer; queue is the queue type it is submitted to
+    void BeginZone(VkCommandBuffer command_buffer, QueueType queue, std::string_view name);
+    void EndZone(VkCommandBuffer command_buffer, QueueType queue);
+
+    // Zones of the most recently resolved frame, in begin order per queue
+    [[nodiscard]] std::vector<Zone> GetResults() const;
+
+    // Summed duration of the resolved zones called name (0 when absent)
+    [[nodiscard]] double GetZoneMs(std::string_view name) const;
+
+    // Check whether queue reports timestamps (timestampValidBits != 0)
+    [[nodiscard]] bool IsSupported(QueueType queue) const;
+
+    [[nodiscard]] uint64_t GetResolvedFrameCount() const;
+
+    // Stamp the CPU time the current frame's zones were submitted (Renderer::EndFrame
+    // does this). Resolved zones start from that time on the CPU timeline, as an
+    // approximation: GPU and CPU clocks are not calibrated against each other
+    void MarkSubmit();
+
+    // CPU submit time (Utils::Timer::NowNanoseconds()) of the frame GetResults() belongs to
+    [[nodiscard]] uint64_t GetResultsSubmitNs() const;
+
+private:
+    struct PendingZone {
+        std::string name;
+        uint32_t beginQuery{0};
+        uint32_t endQuery{UINT32_MAX}; // UINT32_MAX while open
+        uint32_t depth{0};
+    };
+
+    struct FrameSlot {
+        std::unique_ptr<QueryPool> pool;
+        std::vector<PendingZone> zones;
+        uint32_t usedQueries{0};
+        bool blocked{false}; // Previous queries still pending; no zones this frame
+        uint64_t submitNs{0}; // Frame begin until MarkSubmit
+    };
+
+    struct QueueState {
+        uint64_t validMask{0}; // 0: no timestamp support
+        std::vector<FrameSlot> slots;
+        std::vector<size_t> openZones; // Indices into the current slot's zones
+    };
+
+    static constexpr size_t QUEUE_TYPE_COUNT = 4; // Indexed by QueueType; PRESENT maps to GRAPHICS
+
+    const VolkDeviceTable* dispatch_{nullptr}; // Device::GetDispatch, for recording timestamps
+    uint32_t maxQueries_{0};
+    double timestampPeriodNs_{1.0};
+    uint32_t currentSlot_{0};
+    std::array<QueueState, QUEUE_TYPE_COUNT> queues_{};
+
+    mutable std::mutex mutex_;
+    std::vector<Zone> results_;
+    uint64_t resultsSubmitNs_{0};
+    uint64_t resolvedFrames_{0};
+
+    Renderer* renderer_{nullptr};
+    FrameBeginSubscription frameBeginSubscription_;
+
+    QueueState& GetQueueState(QueueType queue);
+    bool ResolveSlot(QueueType queue, const FrameSlot& slot, uint64_t valid_mask, std::vector<Zone>& results) const;
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RENDERING_GPU_PROFILER_HPP
@@ -0,0 +1,121 @@
+#include "IndirectCommandsLayout.hpp"
+
+#include "../core/Device.hpp"
+#include "../resources/PreprocessBuffer.hpp"
+#include "../utils/HostAllocator.hpp"
+
+#include <stdexcept>
+
+
+namespace VulkanEngine::RAII {
+
+IndirectCommandsLayout::IndirectCommandsLayout(const Device& device,
+                                               VkShaderStageFlags shader_stages,
+                                               uint32_t indirect_stride,
+                                               const std::vector<VkIndirectCommandsLayoutTokenEXT>& tokens,
+                                               VkPipelineLayout pipeline_layout,
+                                               VkIndirectCommandsLayoutUsageFlagsEXT usage)
+    : device_(device.GetHandle()),
+    shaderStages_(shader_stages),
+    stride_(indirect_stride)
+{
+    if (!device.SupportsDeviceGeneratedCommands()) {
+        throw std::runtime_error("Device-generated commands are not enabled on this device");
+    }
+    if (tokens.empty() || indirect_stride == 0) {
+        throw std::invalid_argument("IndirectCommandsLayout requires at least one token and a non-zero stride");
+    }
+
+    VkIndirectCommandsLayoutCreateInfoEXT create_info{VK_STRUCTURE_TYPE_INDIRECT_COMMANDS_LAYOUT_CREATE_INFO_EXT};
+    create_info.flags = usage;
+    create_info.shaderStages = shader_stages;
+    create_info.indirectStride = indirect_stride;
+    create_info.pipelineLayout = pipeline_layout;
+    create_info.tokenCount = static_cast<uint32_t>(tokens.size());
+    create_info.pTokens = tokens.data();
+
+    if (vkCreateIndirectCommandsLayoutEXT(device_, &create_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_INDIRECT_COMMANDS_LAYOUT_EXT), &layout_) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create indirect commands layout");
+    }
+}
+
+IndirectCommandsLayout::~IndirectCommandsLayout() {
+    Cleanup();
+}
+
+IndirectCommandsLayout::IndirectCommandsLayout(IndirectCommandsLayout&& other) noexcept
+    : layout_(other.layout_),
+    device_(other.device_),
+    shaderStages_(other.shaderStages_),
+    stride_(other.stride_)
+{
+    other.layout_ = VK_NULL_HANDLE;
+    other.device_ = VK_NULL_HANDLE;
+}
+
+IndirectCommandsLayout& IndirectCommandsLayout::operator=(IndirectCommandsLayout&& other) noexcept {
+    if (this != &other) {
+        Cleanup();
+        layout_ = other.layout_;
+        device_ = other.device_;
+        shaderStages_ = other.shaderStages_;
+        stride_ = other.stride_;
+        other.layout_ = VK_NULL_HANDLE;
+        other.device_ = VK_NULL_HANDLE;
+    }
+    return *this;
+}
+
+bool IndirectCommandsLayout::IsSupported(const Device& device)
+{
+    return device.SupportsDeviceGeneratedCommands();
+}
+
+VkMemoryRequirements IndirectCommandsLayout::GetPreprocessRequirements(VkIndirectExecutionSetEXT execution_set,
+                                                                       uint32_t max_sequence_count,
+                                                                       uint32_t max_draw_count,
+                                                                       const void* next) const
+{
+    VkGeneratedCommandsMemoryRequirementsInfoEXT info{VK_STRUCTURE_TYPE_GENERATED_COMMANDS_MEMORY_REQUIREMENTS_INFO_EXT};
+    info.pNext = next;
+    info.indirectExecutionSet = execution_set;
+    info.indirectCommandsLayout = layout_;
+    info.maxSequenceCount = max_sequence_count;
+    info.maxDrawCount = max_draw_count;
+
+    VkMemoryRequirements2 requirements{VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2};
+    vkGetGeneratedCommandsMemoryRequirementsEXT(device_, &info, &requirements);
+    return requirements.memoryRequirements;
+}
+
+VkGeneratedCommandsInfoEXT IndirectCommandsLayout::MakeGeneratedCommandsInfo(VkIndirectExecutionSetEXT execution_set,
+                                                                             VkDeviceAddress indirect_address,
+                                                                             uint32_t max_sequence_count,
+                                                                             const PreprocessBuffer& preprocess,
+                                                                             VkDeviceAddress sequence_count_address,
+                                                                             uint32_t max_draw_count) const
+{
+    VkGeneratedCommandsInfoEXT info{VK_STRUCTURE_TYPE_GENERATED_COMMANDS_INFO_EXT};
+    info.shaderStages = shaderStages_;
+    info.indirectExecutionSet = execution_set;
+    info.indirectCommandsLayout = layout_;
+    info.indirectAddress = indirect_address;
+    info.indirectAddressSize = static_cast<VkDeviceSize>(max_sequence_count) * stride_;
+    info.preprocessAddress = preprocess.GetDeviceAddress();
+    info.preprocessSize = preprocess.GetSize();
+    info.maxSequenceCount = max_sequence_count;
+    info.sequenceCountAddress = sequence_count_address;
+    info.maxDrawCount = max_draw_count;
+    return info;
+}
+
+void IndirectCommandsLayout::Cleanup()
+{
+    if (layout_ != VK_NULL_HANDLE) {
+        vkDestroyIndirectCommandsLayoutEXT(device_, layout_, Utils::HostAllocator::For(VK_OBJECT_TYPE_INDIRECT_COMMANDS_LAYOUT_EXT));
+        layout_ = VK_NULL_HANDLE;
+    }
+    device_ = VK_NULL_HANDLE;
+}
+
+} // namespace VulkanEngine::RAII
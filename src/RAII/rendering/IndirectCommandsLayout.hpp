@@ -0,0 +1,83 @@
+#ifndef VULKAN_RAII_RENDERING_INDIRECT_COMMANDS_LAYOUT_HPP
+#define VULKAN_RAII_RENDERING_INDIRECT_COMMANDS_LAYOUT_HPP
+
+#include <volk.h>
+#include <cstdint>
+#include <vector>
+
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+class PreprocessBuffer; // Forward declaration
+
+// Layout of one sequence of a device-generated command stream
+// (VK_EXT_device_generated_commands): the tokens a shader writes per sequence, e.g.
+// an execution-set index choosing the pipeline, push constants, and the draw or
+// dispatch arguments. The action token must come last. Token data pointers (such
+// as the execution set or push constant token info) only need to live until the
+// constructor returns.
+class IndirectCommandsLayout {
+public:
+    // Constructor. pipeline_layout is required for push constant and sequence index
+    // tokens unless the device supports dynamicGeneratedPipelineLayout
+    IndirectCommandsLayout(const Device& device,
+                           VkShaderStageFlags shader_stages,
+                           uint32_t indirect_stride,
+                           const std::vector<VkIndirectCommandsLayoutTokenEXT>& tokens,
+                           VkPipelineLayout pipeline_layout = VK_NULL_HANDLE,
+                           VkIndirectCommandsLayoutUsageFlagsEXT usage = 0);
+
+    // Destructor
+    ~IndirectCommandsLayout();
+
+    // Move constructor and assignment
+    IndirectCommandsLayout(IndirectCommandsLayout&& other) noexcept;
+    IndirectCommandsLayout& operator=(IndirectCommandsLayout&& other) noexcept;
+
+    // Delete copy constructor and assignment. this ensures unique ownership of the VkIndirectCommandsLayoutEXT by only allowing moving.
+    IndirectCommandsLayout(const IndirectCommandsLayout&) = delete;
+    IndirectCommandsLayout& operator=(const IndirectCommandsLayout&) = delete;
+
+    // Check whether the device enabled VK_EXT_device_generated_commands
+    static bool IsSupported(const Device& device);
+
+    [[nodiscard]] VkIndirectCommandsLayoutEXT GetHandle() const { return layout_; }
+
+    // Implicit conversion to VkIndirectCommandsLayoutEXT
+    operator VkIndirectCommandsLayoutEXT() const { return layout_; }
+
+    [[nodiscard]] bool IsValid() const { return layout_ != VK_NULL_HANDLE; }
+
+    [[nodiscard]] VkShaderStageFlags GetShaderStages() const { return shaderStages_; }
+    [[nodiscard]] uint32_t GetStride() const { return stride_; }
+
+    // Preprocess memory for up to max_sequence_count sequences (and max_draw_count draws
+    // for multi-draw count tokens). Without an execution set, next must carry the
+    // VkGeneratedCommandsPipelineInfoEXT or VkGeneratedCommandsShaderInfoEXT in use
+    [[nodiscard]] VkMemoryRequirements GetPreprocessRequirements(VkIndirectExecutionSetEXT execution_set,
+                                                                 uint32_t max_sequence_count,
+                                                                 uint32_t max_draw_count = 0,
+                                                                 const void* next = nullptr) const;
+
+    // Execute/preprocess info over a stream of indirect_address..+max_sequence_count*stride.
+    // With a sequence_count_address the GPU-written count (clamped to max_sequence_count) is used
+    [[nodiscard]] VkGeneratedCommandsInfoEXT MakeGeneratedCommandsInfo(VkIndirectExecutionSetEXT execution_set,
+                                                                       VkDeviceAddress indirect_address,
+                                                                       uint32_t max_sequence_count,
+                                                                       const PreprocessBuffer& preprocess,
+                                                                       VkDeviceAddress sequence_count_address = 0,
+                                                                       uint32_t max_draw_count = 0) const;
+
+private:
+    VkIndirectCommandsLayoutEXT layout_{VK_NULL_HANDLE};
+    VkDevice device_{VK_NULL_HANDLE}; // Reference to device
+    VkShaderStageFlags shaderStages_{0};
+    uint32_t stride_{0};
+
+    void Cleanup();
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RENDERING_INDIRECT_COMMANDS_LAYOUT_HPP
@@ -0,0 +1,162 @@
+#include "IndirectDrawCuller.hpp"
+
+#include "CommandBuffer.hpp"
+#include "Pipeline.hpp"
+#include "Renderer.hpp"
+#include "../core/Device.hpp"
+#include "../core/Queue.hpp"
+#include "../resources/Buffer.hpp"
+#include "../resources/Image.hpp"
+#include "../sync/ResourceState.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+
+namespace VulkanEngine::RAII {
+
+IndirectDrawCuller::IndirectDrawCuller(const Device& device,
+                                       const VmaAllocator& allocator,
+                                       uint32_t max_draw_count,
+                                       uint32_t frames_in_flight)
+    : maxDrawCount_(max_draw_count),
+    drawIndirectCount_(device.SupportsDrawIndirectCount())
+{
+    if (max_draw_count == 0 || frames_in_flight == 0) {
+        throw std::invalid_argument("IndirectDrawCuller needs at least one draw and one frame in flight");
+    }
+
+    const VkDeviceSize draw_size = static_cast<VkDeviceSize>(max_draw_count) * sizeof(VkDrawIndexedIndirectCommand);
+    const VkBufferUsageFlags usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                     VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                                     VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    drawBuffers_.reserve(frames_in_flight);
+    countBuffers_.reserve(frames_in_flight);
+    for (uint32_t i = 0; i < frames_in_flight; ++i) {
+        const std::string suffix = std::to_string(i);
+        drawBuffers_.push_back(std::make_unique<Buffer>(allocator, draw_size, usage, VMA_MEMORY_USAGE_AUTO, 0,
+                                                        ("IndirectDrawCuller draws " + suffix).c_str()));
+        countBuffers_.push_back(std::make_unique<Buffer>(allocator, sizeof(uint32_t), usage, VMA_MEMORY_USAGE_AUTO, 0,
+                                                         ("IndirectDrawCuller count " + suffix).c_str()));
+    }
+}
+
+IndirectDrawCuller::~IndirectDrawCuller() = default;
+
+void IndirectDrawCuller::Cull(CommandBuffer& command_buffer, uint32_t frame_index, const CullDispatch& dispatch)
+{
+    if (frame_index >= drawBuffers_.size()) {
+        throw std::out_of_range("IndirectDrawCuller frame index out of range");
+    }
+    if (dispatch.pipeline == nullptr || dispatch.layout == VK_NULL_HANDLE || dispatch.viewProjection == nullptr) {
+        throw std::invalid_argument("IndirectDrawCuller::Cull needs a pipeline, its layout and a view-projection matrix");
+    }
+    if (dispatch.instanceCount > maxDrawCount_ && !drawIndirectCount_) {
+        // Without a count every instance owns a slot
+        throw std::invalid_argument("More instances than draw slots");
+    }
+
+    Buffer& draws = *drawBuffers_[frame_index];
+    Buffer& count = *countBuffers_[frame_index];
+
+    // Reset what the shader appends to (or, with no count, every slot to an empty draw)
+    Buffer& cleared = drawIndirectCount_ ? count : draws;
+    command_buffer.RequireBuffer(cleared, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+    command_buffer.FillBuffer(cleared.GetHandle(), 0, VK_WHOLE_SIZE, 0);
+
+    if (dispatch.instances != nullptr) {
+        command_buffer.RequireBuffer(*dispatch.instances, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR);
+    }
+    command_buffer.RequireBuffer(draws, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR);
+    command_buffer.RequireBuffer(count,
+                                 VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+                                 VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR);
+
+    CullConstants constants{};
+    ExtractFrustumPlanes(dispatch.viewProjection, constants.frustumPlanes);
+    constants.instanceCount = dispatch.instanceCount;
+    constants.maxDrawCount = maxDrawCount_;
+    if (drawIndirectCount_) {
+        constants.flags |= CULL_FLAG_COMPACT;
+    }
+    if (dispatch.hiZ != nullptr) {
+        command_buffer.RequireImage(*dispatch.hiZ, ResourceAccess{VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+                                                                  VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR,
+                                                                  VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL});
+        constants.hiZWidth = dispatch.hiZ->GetWidth();
+        constants.hiZHeight = dispatch.hiZ->GetHeight();
+        constants.hiZMipLevels = dispatch.hiZ->GetMipLevels();
+        constants.flags |= CULL_FLAG_OCCLUSION;
+    }
+
+    command_buffer.BindPipeline(VK_PIPELINE_BIND_POINT_COMPUTE, dispatch.pipeline->GetHandle());
+    if (!dispatch.descriptorSets.empty()) {
+        command_buffer.BindDescriptorSets(VK_PIPELINE_BIND_POINT_COMPUTE, dispatch.layout, 0, dispatch.descriptorSets);
+    }
+    command_buffer.PushConstants(dispatch.layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullConstants), &constants);
+    command_buffer.Dispatch((dispatch.instanceCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+}
+
+void IndirectDrawCuller::Cull(Renderer& renderer, const CullDispatch& dispatch)
+{
+    const uint32_t frame_index = renderer.GetCurrentFrameIndex();
+    Cull(renderer.GetCurrentComputeCommandBuffer(), frame_index, dispatch);
+
+    // The previous contents are never read back, so only the compute-to-graphics direction transfers
+    const ResourceAccess written{VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR};
+    const ResourceAccess indirect{VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT_KHR};
+    renderer.TransferOwnership(*drawBuffers_[frame_index], QueueType::GRAPHICS, written, indirect);
+    if (drawIndirectCount_) {
+        renderer.TransferOwnership(*countBuffers_[frame_index], QueueType::GRAPHICS, written, indirect);
+    }
+}
+
+void IndirectDrawCuller::Draw(CommandBuffer& command_buffer, uint32_t frame_index) const
+{
+    if (frame_index >= drawBuffers_.size()) {
+        throw std::out_of_range("IndirectDrawCuller frame index out of range");
+    }
+
+    Buffer& draws = *drawBuffers_[frame_index];
+    command_buffer.RequireBuffer(draws, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT_KHR);
+    if (!drawIndirectCount_) {
+        command_buffer.DrawIndexedIndirect(draws.GetHandle(), 0, maxDrawCount_, sizeof(VkDrawIndexedIndirectCommand));
+        return;
+    }
+
+    Buffer& count = *countBuffers_[frame_index];
+    command_buffer.RequireBuffer(count, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT_KHR);
+    command_buffer.DrawIndexedIndirectCount(draws.GetHandle(),
+                                            0,
+                                            count.GetHandle(),
+                                            0,
+                                            maxDrawCount_,
+                                            sizeof(VkDrawIndexedIndirectCommand));
+}
+
+void IndirectDrawCuller::ExtractFrustumPlanes(const float view_projection[16], float planes[6][4])
+{
+    // Gribb-Hartmann on the rows of a column-major matrix; Vulkan clips depth to [0, w]
+    auto row = [view_projection](int r, int c) { return view_projection[c * 4 + r]; };
+    for (int c = 0; c < 4; ++c) {
+        planes[0][c] = row(3, c) + row(0, c); // Left
+        planes[1][c] = row(3, c) - row(0, c); // Right
+        planes[2][c] = row(3, c) + row(1, c); // Bottom
+        planes[3][c] = row(3, c) - row(1, c); // Top
+        planes[4][c] = row(2, c);             // Near
+        planes[5][c] = row(3, c) - row(2, c); // Far
+    }
+    for (int p = 0; p < 6; ++p) {
+        const float length = std::sqrt(planes[p][0] * planes[p][0] + planes[p][1] * planes[p][1] + planes[p][2] * planes[p][2]);
+        if (length > 0.0f) {
+            for (int c = 0; c < 4; ++c) {
+                planes[p][c] /= length;
+            }
+        }
+    }
+}
+
+} // namespace VulkanEngine::RAII
@@ -0,0 +1,118 @@
+#ifndef VULKAN_RAII_RENDERING_INDIRECT_DRAW_CULLER_HPP
+#define VULKAN_RAII_RENDERING_INDIRECT_DRAW_CULLER_HPP
+
+#include <volk.h>
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+class VmaAllocator; // Forward declaration
+class Buffer; // Forward declaration
+class Image; // Forward declaration
+class Pipeline; // Forward declaration
+class CommandBuffer; // Forward declaration
+class Renderer; // Forward declaration
+
+// GPU-driven draw path: a compute pass culls instances against the view frustum and
+// (optionally) a Hi-Z depth pyramid, appending a VkDrawIndexedIndirectCommand per
+// surviving instance to a per-frame draw buffer and counting them; Draw() then
+// issues one DrawIndexedIndirectCount for all of them.
+//
+// The culling shader is the application's. Its contract, with local_size_x = WORKGROUP_SIZE:
+//   push constants  CullConstants (std430)
+//   set 0           bound by the caller (CullDispatch::descriptorSets): the Instance
+//                   array, GetDrawBuffer(frame) for the commands, GetCountBuffer(frame)
+//                   (a uint at offset 0, atomically incremented) and the Hi-Z sampler,
+//                   plus whatever it needs to project bounds for the occlusion test.
+// Each command's firstInstance should carry Instance::instanceId so vertex shaders can
+// fetch per-instance data with gl_InstanceIndex.
+//
+// Without VK_KHR_draw_indirect_count the draw buffer is cleared instead of the count
+// and Draw() issues every slot, empty ones drawing zero instances (needs the
+// multiDrawIndirect feature), so the shader must then write commands in place.
+class IndirectDrawCuller {
+public:
+    static constexpr uint32_t WORKGROUP_SIZE = 64;
+    static constexpr uint32_t CULL_FLAG_OCCLUSION = 1u << 0; // CullConstants::flags: Hi-Z image is bound
+    static constexpr uint32_t CULL_FLAG_COMPACT = 1u << 1; // Append through the count; otherwise write slot = instance
+
+    // One input instance (std430, 32 bytes)
+    struct Instance {
+        float boundingSphere[4]; // World-space center and radius
+        uint32_t indexCount;
+        uint32_t firstIndex;
+        int32_t vertexOffset;
+        uint32_t instanceId;
+    };
+
+    // Push constants of the culling shader (128 bytes, the guaranteed minimum)
+    struct CullConstants {
+        float frustumPlanes[6][4]; // Inward-facing planes (xyz normal, w distance): left, right, bottom, top, near, far
+        uint32_t instanceCount;
+        uint32_t maxDrawCount;
+        uint32_t hiZWidth;
+        uint32_t hiZHeight;
+        uint32_t hiZMipLevels;
+        uint32_t flags;
+        uint32_t padding[2];
+    };
+
+    struct CullDispatch {
+        const Pipeline* pipeline{nullptr};
+        VkPipelineLayout layout{VK_NULL_HANDLE};
+        std::span<const VkDescriptorSet> descriptorSets; // Bound from set 0
+        Buffer* instances{nullptr}; // Tracked for the compute read when given
+        uint32_t instanceCount{0};
+        const float* viewProjection{nullptr}; // Column-major 4x4 with Vulkan's [0, 1] depth
+        Image* hiZ{nullptr}; // Depth pyramid (conservative max/min depth per texel); nullptr skips occlusion
+    };
+
+    // Creates frames_in_flight draw and count buffers holding up to max_draw_count commands
+    IndirectDrawCuller(const Device& device,
+                       const VmaAllocator& allocator,
+                       uint32_t max_draw_count,
+                       uint32_t frames_in_flight);
+
+    // Destructor
+    ~IndirectDrawCuller();
+
+    // Delete copy and move. descriptor sets written by the application point at the owned buffers.
+    IndirectDrawCuller(const IndirectDrawCuller&) = delete;
+    IndirectDrawCuller& operator=(const IndirectDrawCuller&) = delete;
+    IndirectDrawCuller(IndirectDrawCuller&&) = delete;
+    IndirectDrawCuller& operator=(IndirectDrawCuller&&) = delete;
+
+    // Record the culling pass of frame_index into a command buffer of a compute-capable queue
+    void Cull(CommandBuffer& command_buffer, uint32_t frame_index, const CullDispatch& dispatch);
+
+    // Record it into the renderer's compute command buffer for the current frame and
+    // hand the results to graphics (see Renderer::TransferOwnership). BEFORE_GEOMETRY,
+    // or Draw() after SplitGraphicsSubmission(); hi_z must already be usable on the compute family
+    void Cull(Renderer& renderer, const CullDispatch& dispatch);
+
+    // Draw everything frame_index's culling pass kept (pipeline, index and vertex buffers bound by the caller)
+    void Draw(CommandBuffer& command_buffer, uint32_t frame_index) const;
+
+    [[nodiscard]] Buffer& GetDrawBuffer(uint32_t frame_index) const { return *drawBuffers_[frame_index]; }
+    [[nodiscard]] Buffer& GetCountBuffer(uint32_t frame_index) const { return *countBuffers_[frame_index]; }
+    [[nodiscard]] uint32_t GetMaxDrawCount() const { return maxDrawCount_; }
+    [[nodiscard]] bool UsesDrawCount() const { return drawIndirectCount_; }
+
+    // Normalized frustum planes of a column-major view-projection matrix (Vulkan clip space)
+    static void ExtractFrustumPlanes(const float view_projection[16], float planes[6][4]);
+
+private:
+    uint32_t maxDrawCount_{0};
+    bool drawIndirectCount_{false};
+    std::vector<std::unique_ptr<Buffer>> drawBuffers_;
+    std::vector<std::unique_ptr<Buffer>> countBuffers_;
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RENDERING_INDIRECT_DRAW_CULLER_HPP
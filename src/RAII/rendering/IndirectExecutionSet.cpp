@@ -0,0 +1,124 @@
+#include "IndirectExecutionSet.hpp"
+
+#include "Pipeline.hpp"
+#include "../core/Device.hpp"
+#include "../utils/HostAllocator.hpp"
+
+#include <stdexcept>
+
+
+namespace VulkanEngine::RAII {
+
+IndirectExecutionSet::IndirectExecutionSet(const Device& device, const Pipeline& initial_pipeline, uint32_t max_pipeline_count)
+{
+    if (!initial_pipeline.IsValid() || !initial_pipeline.IsIndirectBindable() || max_pipeline_count == 0) {
+        throw std::invalid_argument("IndirectExecutionSet requires an indirect bindable pipeline and a non-zero capacity");
+    }
+
+    VkIndirectExecutionSetPipelineInfoEXT pipeline_info{VK_STRUCTURE_TYPE_INDIRECT_EXECUTION_SET_PIPELINE_INFO_EXT};
+    pipeline_info.initialPipeline = initial_pipeline.GetHandle();
+    pipeline_info.maxPipelineCount = max_pipeline_count;
+
+    VkIndirectExecutionSetCreateInfoEXT create_info{VK_STRUCTURE_TYPE_INDIRECT_EXECUTION_SET_CREATE_INFO_EXT};
+    create_info.type = VK_INDIRECT_EXECUTION_SET_INFO_TYPE_PIPELINES_EXT;
+    create_info.info.pPipelineInfo = &pipeline_info;
+    CreateExecutionSet(device, create_info);
+}
+
+IndirectExecutionSet::IndirectExecutionSet(const Device& device, const VkIndirectExecutionSetCreateInfoEXT& create_info)
+{
+    CreateExecutionSet(device, create_info);
+}
+
+IndirectExecutionSet::~IndirectExecutionSet() {
+    Cleanup();
+}
+
+IndirectExecutionSet::IndirectExecutionSet(IndirectExecutionSet&& other) noexcept
+    : executionSet_(other.executionSet_),
+    device_(other.device_),
+    type_(other.type_),
+    capacity_(other.capacity_)
+{
+    other.executionSet_ = VK_NULL_HANDLE;
+    other.device_ = VK_NULL_HANDLE;
+    other.capacity_ = 0;
+}
+
+IndirectExecutionSet& IndirectExecutionSet::operator=(IndirectExecutionSet&& other) noexcept {
+    if (this != &other) {
+        Cleanup();
+        executionSet_ = other.executionSet_;
+        device_ = other.device_;
+        type_ = other.type_;
+        capacity_ = other.capacity_;
+        other.executionSet_ = VK_NULL_HANDLE;
+        other.device_ = VK_NULL_HANDLE;
+        other.capacity_ = 0;
+    }
+    return *this;
+}
+
+void IndirectExecutionSet::SetPipeline(uint32_t index, const Pipeline& pipeline) const
+{
+    VkWriteIndirectExecutionSetPipelineEXT write{VK_STRUCTURE_TYPE_WRITE_INDIRECT_EXECUTION_SET_PIPELINE_EXT};
+    write.index = index;
+    write.pipeline = pipeline.GetHandle();
+    SetPipelines({&write, 1});
+}
+
+void IndirectExecutionSet::SetPipelines(std::span<const VkWriteIndirectExecutionSetPipelineEXT> writes) const
+{
+    if (type_ != VK_INDIRECT_EXECUTION_SET_INFO_TYPE_PIPELINES_EXT) {
+        throw std::logic_error("IndirectExecutionSet holds shader objects, not pipelines");
+    }
+    for (const auto& write : writes) {
+        if (write.index >= capacity_) {
+            throw std::out_of_range("IndirectExecutionSet pipeline index out of range");
+        }
+    }
+    if (!writes.empty()) {
+        vkUpdateIndirectExecutionSetPipelineEXT(device_, executionSet_, static_cast<uint32_t>(writes.size()), writes.data());
+    }
+}
+
+void IndirectExecutionSet::SetShaders(std::span<const VkWriteIndirectExecutionSetShaderEXT> writes) const
+{
+    if (type_ != VK_INDIRECT_EXECUTION_SET_INFO_TYPE_SHADER_OBJECTS_EXT) {
+        throw std::logic_error("IndirectExecutionSet holds pipelines, not shader objects");
+    }
+    for (const auto& write : writes) {
+        if (write.index >= capacity_) {
+            throw std::out_of_range("IndirectExecutionSet shader index out of range");
+        }
+    }
+    if (!writes.empty()) {
+        vkUpdateIndirectExecutionSetShaderEXT(device_, executionSet_, static_cast<uint32_t>(writes.size()), writes.data());
+    }
+}
+
+void IndirectExecutionSet::CreateExecutionSet(const Device& device, const VkIndirectExecutionSetCreateInfoEXT& create_info)
+{
+    if (!device.SupportsDeviceGeneratedCommands()) {
+        throw std::runtime_error("Device-generated commands are not enabled on this device");
+    }
+    device_ = device.GetHandle();
+    type_ = create_info.type;
+    capacity_ = type_ == VK_INDIRECT_EXECUTION_SET_INFO_TYPE_PIPELINES_EXT ? create_info.info.pPipelineInfo->maxPipelineCount
+                                                                           : create_info.info.pShaderInfo->maxShaderCount;
+
+    if (vkCreateIndirectExecutionSetEXT(device_, &create_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_INDIRECT_EXECUTION_SET_EXT), &executionSet_) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create indirect execution set");
+    }
+}
+
+void IndirectExecutionSet::Cleanup()
+{
+    if (executionSet_ != VK_NULL_HANDLE) {
+        vkDestroyIndirectExecutionSetEXT(device_, executionSet_, Utils::HostAllocator::For(VK_OBJECT_TYPE_INDIRECT_EXECUTION_SET_EXT));
+        executionSet_ = VK_NULL_HANDLE;
+    }
+    device_ = VK_NULL_HANDLE;
+}
+
+} // namespace VulkanEngine::RAII
@@ -0,0 +1,68 @@
+#ifndef VULKAN_RAII_RENDERING_INDIRECT_EXECUTION_SET_HPP
+#define VULKAN_RAII_RENDERING_INDIRECT_EXECUTION_SET_HPP
+
+#include <volk.h>
+#include <cstdint>
+#include <span>
+
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+class Pipeline; // Forward declaration
+
+// Table of pipelines (or shader objects) a device-generated command stream selects
+// from per sequence through an EXECUTION_SET token, so a culling shader can pick
+// each draw's material pipeline on the GPU. Entries must be created indirect
+// bindable (GraphicsPipelineDescription::indirectBindable) and compatible with the
+// initial pipeline. Updating an entry the GPU may still read is not allowed; write
+// only unused slots, or ones no submitted stream references any more.
+class IndirectExecutionSet {
+public:
+    // Constructor for a pipeline set; initial_pipeline fills slot 0
+    IndirectExecutionSet(const Device& device, const Pipeline& initial_pipeline, uint32_t max_pipeline_count);
+
+    // Constructor from a full create info (shader object sets)
+    IndirectExecutionSet(const Device& device, const VkIndirectExecutionSetCreateInfoEXT& create_info);
+
+    // Destructor
+    ~IndirectExecutionSet();
+
+    // Move constructor and assignment
+    IndirectExecutionSet(IndirectExecutionSet&& other) noexcept;
+    IndirectExecutionSet& operator=(IndirectExecutionSet&& other) noexcept;
+
+    // Delete copy constructor and assignment. this ensures unique ownership of the VkIndirectExecutionSetEXT by only allowing moving.
+    IndirectExecutionSet(const IndirectExecutionSet&) = delete;
+    IndirectExecutionSet& operator=(const IndirectExecutionSet&) = delete;
+
+    [[nodiscard]] VkIndirectExecutionSetEXT GetHandle() const { return executionSet_; }
+
+    // Implicit conversion to VkIndirectExecutionSetEXT
+    operator VkIndirectExecutionSetEXT() const { return executionSet_; }
+
+    [[nodiscard]] bool IsValid() const { return executionSet_ != VK_NULL_HANDLE; }
+
+    [[nodiscard]] VkIndirectExecutionSetInfoTypeEXT GetType() const { return type_; }
+    [[nodiscard]] uint32_t GetCapacity() const { return capacity_; }
+
+    // Write one pipeline slot
+    void SetPipeline(uint32_t index, const Pipeline& pipeline) const;
+
+    // Write several slots in one call
+    void SetPipelines(std::span<const VkWriteIndirectExecutionSetPipelineEXT> writes) const;
+    void SetShaders(std::span<const VkWriteIndirectExecutionSetShaderEXT> writes) const;
+
+private:
+    VkIndirectExecutionSetEXT executionSet_{VK_NULL_HANDLE};
+    VkDevice device_{VK_NULL_HANDLE}; // Reference to device
+    VkIndirectExecutionSetInfoTypeEXT type_{VK_INDIRECT_EXECUTION_SET_INFO_TYPE_PIPELINES_EXT};
+    uint32_t capacity_{0};
+
+    void CreateExecutionSet(const Device& device, const VkIndirectExecutionSetCreateInfoEXT& create_info);
+    void Cleanup();
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RENDERING_INDIRECT_EXECUTION_SET_HPP
@@ -0,0 +1,127 @@
+#include "OcclusionPredicates.hpp"
+
+#include "CommandBuffer.hpp"
+#include "QueryPool.hpp"
+#include "../core/Device.hpp"
+#include "../resources/Buffer.hpp"
+
+#include <stdexcept>
+#include <string>
+
+
+namespace VulkanEngine::RAII {
+
+OcclusionPredicates::OcclusionPredicates(const Device& device,
+                                         const VmaAllocator& allocator,
+                                         uint32_t object_count,
+                                         uint32_t frames_in_flight)
+    : objectCount_(object_count)
+{
+    if (!device.SupportsConditionalRendering()) {
+        throw std::runtime_error("OcclusionPredicates requires VK_EXT_conditional_rendering");
+    }
+    if (object_count == 0 || frames_in_flight == 0) {
+        throw std::invalid_argument("OcclusionPredicates needs at least one object and one frame in flight");
+    }
+
+    const VkDeviceSize size = static_cast<VkDeviceSize>(object_count) * sizeof(uint32_t);
+    const VkBufferUsageFlags usage = VK_BUFFER_USAGE_CONDITIONAL_RENDERING_BIT_EXT |
+                                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                     VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    queryPools_.reserve(frames_in_flight);
+    predicateBuffers_.reserve(frames_in_flight);
+    for (uint32_t i = 0; i < frames_in_flight; ++i) {
+        queryPools_.push_back(std::make_unique<QueryPool>(device, VK_QUERY_TYPE_OCCLUSION, object_count));
+        predicateBuffers_.push_back(std::make_unique<Buffer>(allocator, size, usage, VMA_MEMORY_USAGE_AUTO, 0,
+                                                             ("OcclusionPredicates " + std::to_string(i)).c_str()));
+    }
+    queried_.assign(frames_in_flight, std::vector<bool>(object_count, false));
+}
+
+OcclusionPredicates::~OcclusionPredicates() = default;
+
+void OcclusionPredicates::CheckIndices(uint32_t frame_index, uint32_t object) const
+{
+    if (frame_index >= queryPools_.size()) {
+        throw std::out_of_range("OcclusionPredicates frame index out of range");
+    }
+    if (object >= objectCount_) {
+        throw std::out_of_range("OcclusionPredicates object out of range");
+    }
+}
+
+void OcclusionPredicates::Reset(CommandBuffer& command_buffer, uint32_t frame_index)
+{
+    CheckIndices(frame_index, 0);
+    command_buffer.ResetQueryPool(queryPools_[frame_index]->GetHandle(), 0, objectCount_);
+    queried_[frame_index].assign(objectCount_, false);
+}
+
+void OcclusionPredicates::BeginQuery(const CommandBuffer& command_buffer, uint32_t frame_index, uint32_t object, bool precise)
+{
+    CheckIndices(frame_index, object);
+    command_buffer.BeginQuery(queryPools_[frame_index]->GetHandle(), object, precise ? VK_QUERY_CONTROL_PRECISE_BIT : 0);
+    queried_[frame_index][object] = true;
+}
+
+void OcclusionPredicates::EndQuery(const CommandBuffer& command_buffer, uint32_t frame_index, uint32_t object) const
+{
+    CheckIndices(frame_index, object);
+    command_buffer.EndQuery(queryPools_[frame_index]->GetHandle(), object);
+}
+
+void OcclusionPredicates::Resolve(CommandBuffer& command_buffer, uint32_t frame_index)
+{
+    CheckIndices(frame_index, 0);
+    Buffer& predicates = *predicateBuffers_[frame_index];
+    const std::vector<bool>& queried = queried_[frame_index];
+
+    // Unqueried objects default to visible
+    command_buffer.RequireBuffer(predicates, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+    command_buffer.FillBuffer(predicates.GetHandle(), 0, VK_WHOLE_SIZE, 1);
+    command_buffer.RequireBuffer(predicates, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+
+    // Copy each run of queried objects as 32-bit counts. WAIT_BIT only waits on the GPU,
+    // and only for queries that were actually issued, so it cannot stall forever
+    for (uint32_t first = 0; first < objectCount_;) {
+        if (!queried[first]) {
+            ++first;
+            continue;
+        }
+        uint32_t end = first + 1;
+        while (end < objectCount_ && queried[end]) {
+            ++end;
+        }
+        command_buffer.CopyQueryPoolResults(*queryPools_[frame_index],
+                                            first,
+                                            end - first,
+                                            predicates,
+                                            static_cast<VkDeviceSize>(first) * sizeof(uint32_t),
+                                            sizeof(uint32_t),
+                                            VK_QUERY_RESULT_WAIT_BIT);
+        first = end;
+    }
+
+    // Flushed by the next render pass begin
+    command_buffer.RequireBuffer(predicates,
+                                 VK_PIPELINE_STAGE_2_CONDITIONAL_RENDERING_BIT_EXT,
+                                 VK_ACCESS_2_CONDITIONAL_RENDERING_READ_BIT_EXT);
+}
+
+void OcclusionPredicates::BeginConditional(const CommandBuffer& command_buffer,
+                                           uint32_t frame_index,
+                                           uint32_t object,
+                                           bool inverted) const
+{
+    CheckIndices(frame_index, object);
+    command_buffer.BeginConditionalRendering(*predicateBuffers_[frame_index],
+                                             static_cast<VkDeviceSize>(object) * sizeof(uint32_t),
+                                             inverted);
+}
+
+void OcclusionPredicates::EndConditional(const CommandBuffer& command_buffer) const
+{
+    command_buffer.EndConditionalRendering();
+}
+
+} // namespace VulkanEngine::RAII
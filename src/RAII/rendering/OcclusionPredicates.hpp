@@ -0,0 +1,80 @@
+#ifndef VULKAN_RAII_RENDERING_OCCLUSION_PREDICATES_HPP
+#define VULKAN_RAII_RENDERING_OCCLUSION_PREDICATES_HPP
+
+#include <volk.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+class VmaAllocator; // Forward declaration
+class Buffer; // Forward declaration
+class QueryPool; // Forward declaration
+class CommandBuffer; // Forward declaration
+
+// Skips expensive per-object passes (decals, volumetric lights) for objects hidden in
+// this frame, with no CPU readback. Each object gets an occlusion query around a cheap
+// proxy draw (its bounding box, depth test on, writes off); Resolve copies the sample
+// counts into a predicate buffer on the GPU, and draws between BeginConditional and
+// EndConditional only run when the proxy passed any sample (VK_EXT_conditional_rendering).
+// Objects not queried in a frame keep a non-zero predicate, so they are drawn.
+// The predicate buffers have STORAGE usage, so compute passes can write predicates
+// instead; they then bracket draws with CommandBuffer::BeginConditionalRendering.
+// A frame in flight records the sequence:
+//   Reset                          outside a render pass
+//   BeginQuery/EndQuery            around the proxy draws, inside one
+//   Resolve                        outside a render pass
+//   BeginConditional/EndConditional around each object's draws
+class OcclusionPredicates {
+public:
+    // Creates frames_in_flight query pools and predicate buffers for object_count objects.
+    // Throws std::runtime_error without conditional rendering support
+    OcclusionPredicates(const Device& device,
+                        const VmaAllocator& allocator,
+                        uint32_t object_count,
+                        uint32_t frames_in_flight);
+
+    // Destructor
+    ~OcclusionPredicates();
+
+    // Delete copy and move. recorded command buffers reference the owned pools and buffers.
+    OcclusionPredicates(const OcclusionPredicates&) = delete;
+    OcclusionPredicates& operator=(const OcclusionPredicates&) = delete;
+    OcclusionPredicates(OcclusionPredicates&&) = delete;
+    OcclusionPredicates& operator=(OcclusionPredicates&&) = delete;
+
+    // Reset frame_index's queries and forget which objects were queried
+    void Reset(CommandBuffer& command_buffer, uint32_t frame_index);
+
+    // Bracket object's proxy draw. precise counts samples exactly (needs occlusionQueryPrecise);
+    // the predicate only tests for zero, so it is rarely worth it
+    void BeginQuery(const CommandBuffer& command_buffer, uint32_t frame_index, uint32_t object, bool precise = false);
+    void EndQuery(const CommandBuffer& command_buffer, uint32_t frame_index, uint32_t object) const;
+
+    // Write the predicates of frame_index: sample counts of queried objects, 1 for the others
+    void Resolve(CommandBuffer& command_buffer, uint32_t frame_index);
+
+    // Draws until EndConditional run only when object was visible (hidden when inverted)
+    void BeginConditional(const CommandBuffer& command_buffer, uint32_t frame_index, uint32_t object, bool inverted = false) const;
+    void EndConditional(const CommandBuffer& command_buffer) const;
+
+    // One uint32 per object, read by conditional rendering
+    [[nodiscard]] Buffer& GetPredicateBuffer(uint32_t frame_index) const { return *predicateBuffers_[frame_index]; }
+    [[nodiscard]] const QueryPool& GetQueryPool(uint32_t frame_index) const { return *queryPools_[frame_index]; }
+    [[nodiscard]] uint32_t GetObjectCount() const { return objectCount_; }
+
+private:
+    uint32_t objectCount_{0};
+    std::vector<std::unique_ptr<QueryPool>> queryPools_;
+    std::vector<std::unique_ptr<Buffer>> predicateBuffers_;
+    std::vector<std::vector<bool>> queried_; // By frame, then object
+
+    void CheckIndices(uint32_t frame_index, uint32_t object) const;
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RENDERING_OCCLUSION_PREDICATES_HPP
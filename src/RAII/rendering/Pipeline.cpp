@@ -1,11 +1,20 @@
 #include "Pipeline.hpp"
 
+#include "PipelineStatistics.hpp"
 #include "RenderPass.hpp"
 #include "../core/Device.hpp"
+#include "../utils/PipelineUtils.hpp"
+#include "../utils/Profiler.hpp"
 #include "rendering/PipelineStructs.hpp"
+#include "../utils/HostAllocator.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <iterator>
 #include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 
 
@@ -25,7 +34,7 @@ std::vector<VkPipelineShaderStageCreateInfo> BuildShaderStages(const std::vector
         stage_info.stage = stage.stage;
         stage_info.module = stage.module;
         stage_info.pName = stage.entryPoint.empty() ? "main" : stage.entryPoint.c_str();
-        stage_info.pSpecializationInfo = stage.specializationInfo;
+        stage_info.pSpecializationInfo = stage.GetSpecializationInfo();
         shader_stages.push_back(stage_info);
     }
     return shader_stages;
@@ -129,6 +138,17 @@ VkPipelineColorBlendStateCreateInfo BuildColorBlendState(const PipelineColorBlen
     return info;
 }
 
+VkPipelineRenderingCreateInfoKHR BuildRenderingInfo(const PipelineRendering& rendering)
+{
+    VkPipelineRenderingCreateInfoKHR info{VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR};
+    info.viewMask = rendering.viewMask;
+    info.colorAttachmentCount = static_cast<uint32_t>(rendering.colorAttachmentFormats.size());
+    info.pColorAttachmentFormats = rendering.colorAttachmentFormats.empty() ? nullptr : rendering.colorAttachmentFormats.data();
+    info.depthAttachmentFormat = rendering.depthAttachmentFormat;
+    info.stencilAttachmentFormat = rendering.stencilAttachmentFormat;
+    return info;
+}
+
 VkPipelineDynamicStateCreateInfo BuildDynamicState(const std::vector<VkDynamicState>& dynamic_states,
                                                    std::vector<VkDynamicState>& state_storage)
 {
@@ -138,6 +158,100 @@ VkPipelineDynamicStateCreateInfo BuildDynamicState(const std::vector<VkDynamicSt
     info.pDynamicStates = state_storage.empty() ? nullptr : state_storage.data();
     return info;
 }
+
+double StatisticValue(const VkPipelineExecutableStatisticKHR& statistic)
+{
+    switch (statistic.format) {
+    case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_BOOL32_KHR:
+        return statistic.value.b32 == VK_TRUE ? 1.0 : 0.0;
+    case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_INT64_KHR:
+        return static_cast<double>(statistic.value.i64);
+    case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_UINT64_KHR:
+        return static_cast<double>(statistic.value.u64);
+    default:
+        return statistic.value.f64;
+    }
+}
+
+std::vector<PipelineExecutableStats> QueryExecutableStatistics(VkDevice device, VkPipeline pipeline)
+{
+    std::vector<PipelineExecutableStats> executables;
+    VkPipelineInfoKHR pipeline_info{VK_STRUCTURE_TYPE_PIPELINE_INFO_KHR};
+    pipeline_info.pipeline = pipeline;
+
+    uint32_t executable_count = 0;
+    if (vkGetPipelineExecutablePropertiesKHR(device, &pipeline_info, &executable_count, nullptr) != VK_SUCCESS) {
+        return executables;
+    }
+    std::vector<VkPipelineExecutablePropertiesKHR> properties(
+        executable_count, VkPipelineExecutablePropertiesKHR{VK_STRUCTURE_TYPE_PIPELINE_EXECUTABLE_PROPERTIES_KHR});
+    if (executable_count == 0 ||
+        vkGetPipelineExecutablePropertiesKHR(device, &pipeline_info, &executable_count, properties.data()) != VK_SUCCESS) {
+        return executables;
+    }
+
+    executables.reserve(executable_count);
+    for (uint32_t i = 0; i < executable_count; ++i) {
+        PipelineExecutableStats executable{};
+        executable.name = properties[i].name;
+        executable.description = properties[i].description;
+        executable.stages = properties[i].stages;
+        executable.subgroupSize = properties[i].subgroupSize;
+
+        VkPipelineExecutableInfoKHR executable_info{VK_STRUCTURE_TYPE_PIPELINE_EXECUTABLE_INFO_KHR};
+        executable_info.pipeline = pipeline;
+        executable_info.executableIndex = i;
+        uint32_t statistic_count = 0;
+        if (vkGetPipelineExecutableStatisticsKHR(device, &executable_info, &statistic_count, nullptr) == VK_SUCCESS &&
+            statistic_count > 0) {
+            std::vector<VkPipelineExecutableStatisticKHR> statistics(
+                statistic_count, VkPipelineExecutableStatisticKHR{VK_STRUCTURE_TYPE_PIPELINE_EXECUTABLE_STATISTIC_KHR});
+            if (vkGetPipelineExecutableStatisticsKHR(device, &executable_info, &statistic_count, statistics.data()) == VK_SUCCESS) {
+                for (uint32_t j = 0; j < statistic_count; ++j) {
+                    executable.statistics.push_back({statistics[j].name, statistics[j].description, StatisticValue(statistics[j])});
+                }
+            }
+        }
+        executables.push_back(std::move(executable));
+    }
+    return executables;
+}
+
+// Depth/stencil state must be provided when tests are baked in, when any of it is
+// set at record time, or when the rendering info declares a depth/stencil attachment
+bool NeedsDepthStencilState(const PipelineDepthStencil& depth_stencil,
+                            const std::vector<VkDynamicState>& dynamic_states,
+                            const PipelineRendering* rendering)
+{
+    if (depth_stencil.depthTestEnable || depth_stencil.stencilTestEnable) {
+        return true;
+    }
+    if (rendering && (rendering->depthAttachmentFormat != VK_FORMAT_UNDEFINED ||
+                      rendering->stencilAttachmentFormat != VK_FORMAT_UNDEFINED)) {
+        return true;
+    }
+    constexpr VkDynamicState DEPTH_STENCIL_STATES[] = {
+        VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT,
+        VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT,
+        VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT,
+        VK_DYNAMIC_STATE_DEPTH_BOUNDS_TEST_ENABLE_EXT,
+        VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE_EXT,
+        VK_DYNAMIC_STATE_STENCIL_OP_EXT
+    };
+    return std::any_of(dynamic_states.begin(), dynamic_states.end(), [&](VkDynamicState state) {
+        return std::find(std::begin(DEPTH_STENCIL_STATES), std::end(DEPTH_STENCIL_STATES), state) != std::end(DEPTH_STENCIL_STATES);
+    });
+}
+
+// INDIRECT_BINDABLE only exists as a 64-bit flag, and the flags2 structure replaces
+// the legacy flags, so it has to carry all of them
+template <typename CreateInfo>
+void ChainIndirectBindable(CreateInfo& pipeline_info, VkPipelineCreateFlags2CreateInfoKHR& flags2)
+{
+    flags2.flags = static_cast<VkPipelineCreateFlags2KHR>(pipeline_info.flags) | VK_PIPELINE_CREATE_2_INDIRECT_BINDABLE_BIT_EXT;
+    flags2.pNext = pipeline_info.pNext;
+    pipeline_info.pNext = &flags2;
+}
 }
 
 Pipeline::Pipeline(const Device& device,
@@ -154,7 +268,8 @@ Pipeline::Pipeline(const Device& device,
                    const std::vector<VkDynamicState>& dynamic_states,
                    uint32_t subpass,
                    VkPipeline base_pipeline,
-                   int32_t base_pipeline_index)
+                   int32_t base_pipeline_index,
+                   VkPipelineCache pipeline_cache)
     : device_(device.GetHandle()),
     layout_(layout),
     type_(Type::GRAPHICS)
@@ -162,7 +277,9 @@ Pipeline::Pipeline(const Device& device,
     if (device == VK_NULL_HANDLE || layout == VK_NULL_HANDLE) {
         throw std::invalid_argument("Pipeline requires valid device and layout");
     }
-    CreateGraphicsPipeline(render_pass,
+    ConfigureStatistics(device);
+    CreateGraphicsPipeline(render_pass.GetHandle(),
+                           nullptr,
                            shader_stages,
                            vertex_input,
                            input_assembly,
@@ -174,7 +291,8 @@ Pipeline::Pipeline(const Device& device,
                            dynamic_states,
                            subpass,
                            base_pipeline,
-                           base_pipeline_index);
+                           base_pipeline_index,
+                           pipeline_cache);
 }
 
 Pipeline::Pipeline(const Device& device,
@@ -192,7 +310,8 @@ Pipeline::Pipeline(const Device& device,
                    const std::vector<VkDynamicState>& dynamic_states,
                    uint32_t subpass,
                    VkPipeline base_pipeline,
-                   int32_t base_pipeline_index)
+                   int32_t base_pipeline_index,
+                   VkPipelineCache pipeline_cache)
     : device_(device.GetHandle()),
     layout_(layout),
     type_(Type::GRAPHICS)
@@ -200,7 +319,9 @@ Pipeline::Pipeline(const Device& device,
     if (device == VK_NULL_HANDLE || layout == VK_NULL_HANDLE) {
         throw std::invalid_argument("Pipeline requires valid device and layout");
     }
-    CreateGraphicsPipelineWithTessellation(render_pass,
+    ConfigureStatistics(device);
+    CreateGraphicsPipelineWithTessellation(render_pass.GetHandle(),
+                                           nullptr,
                                            shader_stages,
                                            vertex_input,
                                            input_assembly,
@@ -213,14 +334,56 @@ Pipeline::Pipeline(const Device& device,
                                            dynamic_states,
                                            subpass,
                                            base_pipeline,
-                                           base_pipeline_index);
+                                           base_pipeline_index,
+                                           pipeline_cache);
+}
+
+Pipeline::Pipeline(const Device& device,
+                   const PipelineRendering& rendering,
+                   VkPipelineLayout layout,
+                   const std::vector<PipelineShaderStage>& shader_stages,
+                   const PipelineVertexInput& vertex_input,
+                   const PipelineInputAssembly& input_assembly,
+                   const PipelineViewport& viewport,
+                   const PipelineRasterization& rasterization,
+                   const PipelineMultisample& multisample,
+                   const PipelineDepthStencil& depth_stencil,
+                   const PipelineColorBlend& color_blend,
+                   const std::vector<VkDynamicState>& dynamic_states,
+                   VkPipeline base_pipeline,
+                   int32_t base_pipeline_index,
+                   VkPipelineCache pipeline_cache)
+    : device_(device.GetHandle()),
+    layout_(layout),
+    type_(Type::GRAPHICS)
+{
+    if (device == VK_NULL_HANDLE || layout == VK_NULL_HANDLE) {
+        throw std::invalid_argument("Pipeline requires valid device and layout");
+    }
+    ConfigureStatistics(device);
+    CreateGraphicsPipeline(VK_NULL_HANDLE,
+                           &rendering,
+                           shader_stages,
+                           vertex_input,
+                           input_assembly,
+                           viewport,
+                           rasterization,
+                           multisample,
+                           depth_stencil,
+                           color_blend,
+                           dynamic_states,
+                           0,
+                           base_pipeline,
+                           base_pipeline_index,
+                           pipeline_cache);
 }
 
 Pipeline::Pipeline(const Device& device,
                    VkPipelineLayout layout,
                    const PipelineShaderStage& compute_stage,
                    VkPipeline base_pipeline,
-                   int32_t base_pipeline_index)
+                   int32_t base_pipeline_index,
+                   VkPipelineCache pipeline_cache)
     : device_(device.GetHandle()),
     layout_(layout),
     type_(Type::COMPUTE)
@@ -228,7 +391,159 @@ Pipeline::Pipeline(const Device& device,
     if (device == VK_NULL_HANDLE || layout == VK_NULL_HANDLE) {
         throw std::invalid_argument("Pipeline requires valid device and layout");
     }
-    CreateComputePipeline(compute_stage, base_pipeline, base_pipeline_index);
+    ConfigureStatistics(device);
+    CreateComputePipeline(compute_stage, base_pipeline, base_pipeline_index, pipeline_cache);
+}
+
+Pipeline::Pipeline(const Device& device,
+                   const GraphicsPipelineDescription& description,
+                   VkPipelineCache pipeline_cache)
+    : device_(device.GetHandle()),
+    layout_(description.layout),
+    type_(Type::GRAPHICS)
+{
+    if (device == VK_NULL_HANDLE || description.layout == VK_NULL_HANDLE || !description.HasRenderTarget()) {
+        throw std::invalid_argument("Pipeline requires valid device, layout and render pass or rendering formats");
+    }
+    ConfigureStatistics(device, description.debugName);
+    createFlags_ = description.createFlags;
+    indirectBindable_ = description.indirectBindable;
+    fragmentShadingRate_ = description.fragmentShadingRate;
+    const VkRenderPass render_pass = description.renderPass ? description.renderPass->GetHandle() : VK_NULL_HANDLE;
+    const PipelineRendering* rendering = description.renderPass ? nullptr : &*description.rendering;
+    if (description.tessellation) {
+        CreateGraphicsPipelineWithTessellation(render_pass,
+                                               rendering,
+                                               description.shaderStages,
+                                               description.vertexInput,
+                                               description.inputAssembly,
+                                               *description.tessellation,
+                                               description.viewport,
+                                               description.rasterization,
+                                               description.multisample,
+                                               description.depthStencil,
+                                               description.colorBlend,
+                                               description.dynamicStates,
+                                               description.subpass,
+                                               VK_NULL_HANDLE,
+                                               -1,
+                                               pipeline_cache);
+    } else {
+        CreateGraphicsPipeline(render_pass,
+                               rendering,
+                               description.shaderStages,
+                               description.vertexInput,
+                               description.inputAssembly,
+                               description.viewport,
+                               description.rasterization,
+                               description.multisample,
+                               description.depthStencil,
+                               description.colorBlend,
+                               description.dynamicStates,
+                               description.subpass,
+                               VK_NULL_HANDLE,
+                               -1,
+                               pipeline_cache);
+    }
+    Utils::SetObjectName(device_, VK_OBJECT_TYPE_PIPELINE, pipeline_, debugName_.Get());
+}
+
+Pipeline::Pipeline(const Device& device,
+                   const ComputePipelineDescription& description,
+                   VkPipelineCache pipeline_cache)
+    : device_(device.GetHandle()),
+    layout_(description.layout),
+    type_(Type::COMPUTE)
+{
+    if (device == VK_NULL_HANDLE || description.layout == VK_NULL_HANDLE) {
+        throw std::invalid_argument("Pipeline requires valid device and layout");
+    }
+    ConfigureStatistics(device, description.debugName);
+    createFlags_ = description.createFlags;
+    indirectBindable_ = description.indirectBindable;
+    CreateComputePipeline(description.stage, VK_NULL_HANDLE, -1, pipeline_cache);
+    Utils::SetObjectName(device_, VK_OBJECT_TYPE_PIPELINE, pipeline_, debugName_.Get());
+}
+
+Pipeline::Pipeline(const Device& device,
+                   VkGraphicsPipelineLibraryFlagsEXT library_parts,
+                   const GraphicsPipelineDescription& description,
+                   VkPipelineCache pipeline_cache)
+    : device_(device.GetHandle()),
+    layout_(description.layout),
+    type_(Type::GRAPHICS),
+    libraryParts_(library_parts)
+{
+    constexpr VkGraphicsPipelineLibraryFlagsEXT LAYOUT_PARTS =
+        VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT | VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT;
+    if (device == VK_NULL_HANDLE || library_parts == 0) {
+        throw std::invalid_argument("Pipeline library requires a valid device and at least one state subset");
+    }
+    if ((library_parts & LAYOUT_PARTS) != 0 && description.layout == VK_NULL_HANDLE) {
+        throw std::invalid_argument("Shader pipeline libraries require a valid layout");
+    }
+    if (!device.SupportsGraphicsPipelineLibrary()) {
+        throw std::runtime_error("Graphics pipeline libraries are not enabled on this device");
+    }
+    ConfigureStatistics(device, description.debugName);
+    createFlags_ = description.createFlags;
+    if ((library_parts & LAYOUT_PARTS) != 0) {
+        fragmentShadingRate_ = description.fragmentShadingRate; // Pre-rasterization and fragment shader state
+    }
+    CreateGraphicsPipelineLibrary(description, library_parts, pipeline_cache);
+    Utils::SetObjectName(device_, VK_OBJECT_TYPE_PIPELINE, pipeline_, debugName_.Get());
+}
+
+Pipeline::Pipeline(const Device& device,
+                   VkPipelineLayout layout,
+                   const std::vector<VkPipeline>& libraries,
+                   bool link_time_optimize,
+                   VkPipelineCache pipeline_cache,
+                   VkPipelineCreateFlags create_flags)
+    : device_(device.GetHandle()),
+    layout_(layout),
+    type_(Type::GRAPHICS),
+    createFlags_(create_flags)
+{
+    if (device == VK_NULL_HANDLE || layout == VK_NULL_HANDLE || libraries.empty()) {
+        throw std::invalid_argument("Pipeline linking requires valid device, layout and libraries");
+    }
+    ConfigureStatistics(device);
+
+    VkPipelineLibraryCreateInfoKHR library_info{VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR};
+    library_info.libraryCount = static_cast<uint32_t>(libraries.size());
+    library_info.pLibraries = libraries.data();
+
+    VkGraphicsPipelineCreateInfo pipeline_info{VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
+    pipeline_info.pNext = &library_info;
+    pipeline_info.flags = link_time_optimize ? VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT : 0;
+    pipeline_info.layout = layout_;
+    pipeline_info.basePipelineIndex = -1;
+
+    if (CreateHandle(pipeline_info, pipeline_cache) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to link graphics pipeline libraries");
+    }
+}
+
+void Pipeline::SetDebugName(const char* name)
+{
+    if constexpr (!Utils::DEBUG_NAMES_ENABLED) {
+        return;
+    }
+    debugName_.Set(name);
+    Utils::SetObjectName(device_, VK_OBJECT_TYPE_PIPELINE, pipeline_, debugName_.Get());
+    if (recordFeedback_ && pipeline_ != VK_NULL_HANDLE) {
+        PipelineStatistics::Rename(pipeline_, debugName_.Get());
+    }
+}
+
+void Pipeline::MakeStateDynamic(const Device& device, GraphicsPipelineDescription& description)
+{
+    for (VkDynamicState state : Utils::PipelineUtils::GetAllDynamicStates(device.GetExtensionFeatures())) {
+        if (!description.HasDynamicState(state)) {
+            description.dynamicStates.push_back(state);
+        }
+    }
 }
 
 Pipeline::~Pipeline() {
@@ -239,12 +554,20 @@ Pipeline::Pipeline(Pipeline&& other) noexcept
     : pipeline_(other.pipeline_),
     device_(other.device_),
     layout_(other.layout_),
-    type_(other.type_)
+    type_(other.type_),
+    libraryParts_(other.libraryParts_),
+    createFlags_(other.createFlags_),
+    indirectBindable_(other.indirectBindable_),
+    fragmentShadingRate_(other.fragmentShadingRate_),
+    recordFeedback_(other.recordFeedback_),
+    captureExecutables_(other.captureExecutables_),
+    debugName_(std::move(other.debugName_))
 {
     other.pipeline_ = VK_NULL_HANDLE;
     other.device_ = VK_NULL_HANDLE;
     other.layout_ = VK_NULL_HANDLE;
     other.type_ = Type::GRAPHICS;
+    other.libraryParts_ = 0;
 }
 
 Pipeline& Pipeline::operator=(Pipeline&& other) noexcept {
@@ -254,15 +577,24 @@ Pipeline& Pipeline::operator=(Pipeline&& other) noexcept {
         device_ = other.device_;
         layout_ = other.layout_;
         type_ = other.type_;
+        libraryParts_ = other.libraryParts_;
+        createFlags_ = other.createFlags_;
+        indirectBindable_ = other.indirectBindable_;
+        fragmentShadingRate_ = other.fragmentShadingRate_;
+        recordFeedback_ = other.recordFeedback_;
+        captureExecutables_ = other.captureExecutables_;
+        debugName_ = std::move(other.debugName_);
         other.pipeline_ = VK_NULL_HANDLE;
         other.device_ = VK_NULL_HANDLE;
         other.layout_ = VK_NULL_HANDLE;
         other.type_ = Type::GRAPHICS;
+        other.libraryParts_ = 0;
     }
     return *this;
 }
 
-void Pipeline::CreateGraphicsPipeline(const RenderPass& render_pass,
+void Pipeline::CreateGraphicsPipeline(VkRenderPass render_pass,
+                                      const PipelineRendering* rendering,
                                       const std::vector<PipelineShaderStage>& shader_stages,
                                       const PipelineVertexInput& vertex_input,
                                       const PipelineInputAssembly& input_assembly,
@@ -274,7 +606,8 @@ void Pipeline::CreateGraphicsPipeline(const RenderPass& render_pass,
                                       const std::vector<VkDynamicState>& dynamic_states,
                                       uint32_t subpass,
                                       VkPipeline base_pipeline,
-                                      int32_t base_pipeline_index)
+                                      int32_t base_pipeline_index,
+                                      VkPipelineCache pipeline_cache)
 {
     std::vector<VkPipelineShaderStageCreateInfo> vk_shader_stages = BuildShaderStages(shader_stages);
 
@@ -300,7 +633,13 @@ void Pipeline::CreateGraphicsPipeline(const RenderPass& render_pass,
     std::vector<VkDynamicState> dynamic_state_storage;
     VkPipelineDynamicStateCreateInfo dynamic_state_info = BuildDynamicState(dynamic_states, dynamic_state_storage);
 
+    VkPipelineRenderingCreateInfoKHR rendering_info{VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR};
+    if (rendering) {
+        rendering_info = BuildRenderingInfo(*rendering);
+    }
+
     VkGraphicsPipelineCreateInfo pipeline_info{VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
+    pipeline_info.pNext = rendering ? &rendering_info : nullptr;
     pipeline_info.stageCount = static_cast<uint32_t>(vk_shader_stages.size());
     pipeline_info.pStages = vk_shader_stages.data();
     pipeline_info.pVertexInputState = &vertex_input_info;
@@ -308,21 +647,22 @@ void Pipeline::CreateGraphicsPipeline(const RenderPass& render_pass,
     pipeline_info.pViewportState = &viewport_info;
     pipeline_info.pRasterizationState = &rasterization_info;
     pipeline_info.pMultisampleState = &multisample_info;
-    pipeline_info.pDepthStencilState = depth_stencil_info.depthTestEnable || depth_stencil_info.stencilTestEnable ? &depth_stencil_info : nullptr;
+    pipeline_info.pDepthStencilState = NeedsDepthStencilState(depth_stencil, dynamic_states, rendering) ? &depth_stencil_info : nullptr;
     pipeline_info.pColorBlendState = &color_blend_info;
     pipeline_info.pDynamicState = dynamic_state_storage.empty() ? nullptr : &dynamic_state_info;
     pipeline_info.layout = layout_;
-    pipeline_info.renderPass = render_pass.GetHandle();
+    pipeline_info.renderPass = render_pass;
     pipeline_info.subpass = subpass;
     pipeline_info.basePipelineHandle = base_pipeline;
     pipeline_info.basePipelineIndex = base_pipeline_index;
 
-    if (vkCreateGraphicsPipelines(device_, VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &pipeline_) != VK_SUCCESS) {
+    if (CreateHandle(pipeline_info, pipeline_cache) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create graphics pipeline");
     }
 }
 
-void Pipeline::CreateGraphicsPipelineWithTessellation(const RenderPass& render_pass,
+void Pipeline::CreateGraphicsPipelineWithTessellation(VkRenderPass render_pass,
+                                                      const PipelineRendering* rendering,
                                                       const std::vector<PipelineShaderStage>& shader_stages,
                                                       const PipelineVertexInput& vertex_input,
                                                       const PipelineInputAssembly& input_assembly,
@@ -335,7 +675,8 @@ void Pipeline::CreateGraphicsPipelineWithTessellation(const RenderPass& render_p
                                                       const std::vector<VkDynamicState>& dynamic_states,
                                                       uint32_t subpass,
                                                       VkPipeline base_pipeline,
-                                                      int32_t base_pipeline_index)
+                                                      int32_t base_pipeline_index,
+                                                      VkPipelineCache pipeline_cache)
 {
     std::vector<VkPipelineShaderStageCreateInfo> vk_shader_stages = BuildShaderStages(shader_stages);
 
@@ -364,7 +705,13 @@ void Pipeline::CreateGraphicsPipelineWithTessellation(const RenderPass& render_p
     VkPipelineTessellationStateCreateInfo tessellation_info{VK_STRUCTURE_TYPE_PIPELINE_TESSELLATION_STATE_CREATE_INFO};
     tessellation_info.patchControlPoints = tessellation.patchControlPoints;
 
+    VkPipelineRenderingCreateInfoKHR rendering_info{VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR};
+    if (rendering) {
+        rendering_info = BuildRenderingInfo(*rendering);
+    }
+
     VkGraphicsPipelineCreateInfo pipeline_info{VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
+    pipeline_info.pNext = rendering ? &rendering_info : nullptr;
     pipeline_info.stageCount = static_cast<uint32_t>(vk_shader_stages.size());
     pipeline_info.pStages = vk_shader_stages.data();
     pipeline_info.pVertexInputState = &vertex_input_info;
@@ -373,23 +720,119 @@ void Pipeline::CreateGraphicsPipelineWithTessellation(const RenderPass& render_p
     pipeline_info.pViewportState = &viewport_info;
     pipeline_info.pRasterizationState = &rasterization_info;
     pipeline_info.pMultisampleState = &multisample_info;
-    pipeline_info.pDepthStencilState = depth_stencil_info.depthTestEnable || depth_stencil_info.stencilTestEnable ? &depth_stencil_info : nullptr;
+    pipeline_info.pDepthStencilState = NeedsDepthStencilState(depth_stencil, dynamic_states, rendering) ? &depth_stencil_info : nullptr;
     pipeline_info.pColorBlendState = &color_blend_info;
     pipeline_info.pDynamicState = dynamic_state_storage.empty() ? nullptr : &dynamic_state_info;
     pipeline_info.layout = layout_;
-    pipeline_info.renderPass = render_pass.GetHandle();
+    pipeline_info.renderPass = render_pass;
     pipeline_info.subpass = subpass;
     pipeline_info.basePipelineHandle = base_pipeline;
     pipeline_info.basePipelineIndex = base_pipeline_index;
 
-    if (vkCreateGraphicsPipelines(device_, VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &pipeline_) != VK_SUCCESS) {
+    if (CreateHandle(pipeline_info, pipeline_cache) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create tessellated graphics pipeline");
     }
 }
 
+void Pipeline::CreateGraphicsPipelineLibrary(const GraphicsPipelineDescription& description,
+                                             VkGraphicsPipelineLibraryFlagsEXT library_parts,
+                                             VkPipelineCache pipeline_cache)
+{
+    const bool vertex_input_part = (library_parts & VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT) != 0;
+    const bool pre_rasterization_part = (library_parts & VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT) != 0;
+    const bool fragment_shader_part = (library_parts & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT) != 0;
+    const bool fragment_output_part = (library_parts & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT) != 0;
+
+    // Each subset only takes the shader stages it owns
+    std::vector<PipelineShaderStage> part_stages;
+    for (const PipelineShaderStage& stage : description.shaderStages) {
+        const bool is_fragment = stage.stage == VK_SHADER_STAGE_FRAGMENT_BIT;
+        if ((is_fragment && fragment_shader_part) || (!is_fragment && pre_rasterization_part)) {
+            part_stages.push_back(stage);
+        }
+    }
+    std::vector<VkPipelineShaderStageCreateInfo> vk_shader_stages = BuildShaderStages(part_stages);
+
+    std::vector<VkVertexInputBindingDescription> binding_descriptions;
+    std::vector<VkVertexInputAttributeDescription> attribute_descriptions;
+    VkPipelineVertexInputStateCreateInfo vertex_input_info = BuildVertexInputState(description.vertexInput,
+                                                                                 binding_descriptions,
+                                                                                 attribute_descriptions);
+
+    VkPipelineInputAssemblyStateCreateInfo input_assembly_info = BuildInputAssemblyState(description.inputAssembly);
+
+    std::vector<VkViewport> viewports;
+    std::vector<VkRect2D> scissors;
+    VkPipelineViewportStateCreateInfo viewport_info = BuildViewportState(description.viewport, viewports, scissors);
+
+    VkPipelineRasterizationStateCreateInfo rasterization_info = BuildRasterizationState(description.rasterization);
+    VkPipelineMultisampleStateCreateInfo multisample_info = BuildMultisampleState(description.multisample);
+    VkPipelineDepthStencilStateCreateInfo depth_stencil_info = BuildDepthStencilState(description.depthStencil);
+
+    std::vector<VkPipelineColorBlendAttachmentState> color_attachments;
+    VkPipelineColorBlendStateCreateInfo color_blend_info = BuildColorBlendState(description.colorBlend, color_attachments);
+
+    std::vector<VkDynamicState> dynamic_state_storage;
+    VkPipelineDynamicStateCreateInfo dynamic_state_info = BuildDynamicState(description.dynamicStates, dynamic_state_storage);
+
+    VkPipelineTessellationStateCreateInfo tessellation_info{VK_STRUCTURE_TYPE_PIPELINE_TESSELLATION_STATE_CREATE_INFO};
+    tessellation_info.patchControlPoints = description.tessellation ? description.tessellation->patchControlPoints : 0;
+
+    // Formats come from the rendering info when there is no render pass
+    VkPipelineRenderingCreateInfoKHR rendering_info{VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR};
+    const bool use_rendering_info = description.renderPass == nullptr && description.rendering.has_value();
+    if (use_rendering_info) {
+        rendering_info = BuildRenderingInfo(*description.rendering);
+    }
+
+    VkGraphicsPipelineLibraryCreateInfoEXT library_info{VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT};
+    library_info.pNext = use_rendering_info ? &rendering_info : nullptr;
+    library_info.flags = library_parts;
+
+    VkGraphicsPipelineCreateInfo pipeline_info{VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
+    pipeline_info.pNext = &library_info;
+    // Retained so the libraries can also be linked with link-time optimization
+    pipeline_info.flags = VK_PIPELINE_CREATE_LIBRARY_BIT_KHR | VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+    pipeline_info.stageCount = static_cast<uint32_t>(vk_shader_stages.size());
+    pipeline_info.pStages = vk_shader_stages.empty() ? nullptr : vk_shader_stages.data();
+    pipeline_info.pDynamicState = dynamic_state_storage.empty() ? nullptr : &dynamic_state_info;
+    pipeline_info.basePipelineIndex = -1;
+    if (vertex_input_part) {
+        pipeline_info.pVertexInputState = &vertex_input_info;
+        pipeline_info.pInputAssemblyState = &input_assembly_info;
+    }
+    if (pre_rasterization_part) {
+        pipeline_info.pTessellationState = description.tessellation ? &tessellation_info : nullptr;
+        pipeline_info.pViewportState = &viewport_info;
+        pipeline_info.pRasterizationState = &rasterization_info;
+    }
+    if (fragment_shader_part) {
+        const PipelineRendering* rendering = use_rendering_info ? &*description.rendering : nullptr;
+        pipeline_info.pDepthStencilState = NeedsDepthStencilState(description.depthStencil, description.dynamicStates, rendering) ? &depth_stencil_info : nullptr;
+    }
+    if (fragment_shader_part || fragment_output_part) {
+        pipeline_info.pMultisampleState = &multisample_info;
+    }
+    if (fragment_output_part) {
+        pipeline_info.pColorBlendState = &color_blend_info;
+    }
+    if (pre_rasterization_part || fragment_shader_part) {
+        pipeline_info.layout = layout_;
+    }
+    if (pre_rasterization_part || fragment_shader_part || fragment_output_part) {
+        pipeline_info.renderPass = description.renderPass ? description.renderPass->GetHandle() : VK_NULL_HANDLE;
+        pipeline_info.subpass = description.subpass;
+    }
+
+    if (CreateHandle(pipeline_info, pipeline_cache) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create graphics pipeline library");
+    }
+}
+
 void Pipeline::CreateComputePipeline(const PipelineShaderStage& compute_stage,
                                      VkPipeline base_pipeline,
-                                     int32_t base_pipeline_index)
+                                     int32_t base_pipeline_index,
+                                     VkPipelineCache pipeline_cache)
 {
     if (compute_stage.module == VK_NULL_HANDLE || compute_stage.stage != VK_SHADER_STAGE_COMPUTE_BIT) {
         throw std::invalid_argument("Compute pipeline requires a compute shader stage");
@@ -399,7 +842,7 @@ void Pipeline::CreateComputePipeline(const PipelineShaderStage& compute_stage,
     stage_info.stage = compute_stage.stage;
     stage_info.module = compute_stage.module;
     stage_info.pName = compute_stage.entryPoint.empty() ? "main" : compute_stage.entryPoint.c_str();
-    stage_info.pSpecializationInfo = compute_stage.specializationInfo;
+    stage_info.pSpecializationInfo = compute_stage.GetSpecializationInfo();
 
     VkComputePipelineCreateInfo pipeline_info{VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO};
     pipeline_info.stage = stage_info;
@@ -407,15 +850,141 @@ void Pipeline::CreateComputePipeline(const PipelineShaderStage& compute_stage,
     pipeline_info.basePipelineHandle = base_pipeline;
     pipeline_info.basePipelineIndex = base_pipeline_index;
 
-    if (vkCreateComputePipelines(device_, VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &pipeline_) != VK_SUCCESS) {
+    if (CreateHandle(pipeline_info, pipeline_cache) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create compute pipeline");
     }
 }
 
+void Pipeline::ConfigureStatistics(const Device& device, const std::string& debug_name)
+{
+    const PipelineStatistics::Options options = PipelineStatistics::GetOptions();
+    const Utils::DeviceExtensionFeatures& features = device.GetExtensionFeatures();
+    recordFeedback_ = options.creationFeedback && features.pipelineCreationFeedback;
+    captureExecutables_ = recordFeedback_ && options.executableStatistics && features.pipelineExecutableInfo;
+    debugName_.Set(debug_name.c_str());
+}
+
+VkResult Pipeline::CreateHandle(VkGraphicsPipelineCreateInfo pipeline_info, VkPipelineCache pipeline_cache)
+{
+    VULKAN_RAII_PROFILE_SCOPE("Pipeline::CreateGraphics");
+    pipeline_info.flags |= createFlags_;
+    VkPipelineFragmentShadingRateStateCreateInfoKHR shading_rate_info{VK_STRUCTURE_TYPE_PIPELINE_FRAGMENT_SHADING_RATE_STATE_CREATE_INFO_KHR};
+    if (fragmentShadingRate_) {
+        shading_rate_info.fragmentSize = fragmentShadingRate_->fragmentSize;
+        shading_rate_info.combinerOps[0] = fragmentShadingRate_->combinerOps[0];
+        shading_rate_info.combinerOps[1] = fragmentShadingRate_->combinerOps[1];
+        shading_rate_info.pNext = pipeline_info.pNext;
+        pipeline_info.pNext = &shading_rate_info;
+    }
+    VkPipelineCreateFlags2CreateInfoKHR flags2{VK_STRUCTURE_TYPE_PIPELINE_CREATE_FLAGS_2_CREATE_INFO_KHR};
+    if (!recordFeedback_) {
+        if (indirectBindable_) {
+            ChainIndirectBindable(pipeline_info, flags2);
+        }
+        return vkCreateGraphicsPipelines(device_, pipeline_cache, 1, &pipeline_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_PIPELINE), &pipeline_);
+    }
+
+    VkPipelineCreationFeedbackEXT feedback{};
+    std::vector<VkPipelineCreationFeedbackEXT> stage_feedback(pipeline_info.stageCount);
+    VkPipelineCreationFeedbackCreateInfoEXT feedback_info{VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT};
+    feedback_info.pNext = pipeline_info.pNext;
+    feedback_info.pPipelineCreationFeedback = &feedback;
+    feedback_info.pipelineStageCreationFeedbackCount = static_cast<uint32_t>(stage_feedback.size());
+    feedback_info.pPipelineStageCreationFeedbacks = stage_feedback.empty() ? nullptr : stage_feedback.data();
+    pipeline_info.pNext = &feedback_info;
+
+    // Libraries are not executable, so there is nothing to report for them
+    const bool capture = captureExecutables_ && (pipeline_info.flags & VK_PIPELINE_CREATE_LIBRARY_BIT_KHR) == 0;
+    if (capture) {
+        pipeline_info.flags |= VK_PIPELINE_CREATE_CAPTURE_STATISTICS_BIT_KHR;
+    }
+    if (indirectBindable_) {
+        ChainIndirectBindable(pipeline_info, flags2);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const VkResult result = vkCreateGraphicsPipelines(device_, pipeline_cache, 1, &pipeline_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_PIPELINE), &pipeline_);
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    if (result == VK_SUCCESS) {
+        RecordStatistics(feedback, stage_feedback, pipeline_info.pStages, elapsed.count(), capture);
+    }
+    return result;
+}
+
+VkResult Pipeline::CreateHandle(VkComputePipelineCreateInfo pipeline_info, VkPipelineCache pipeline_cache)
+{
+    VULKAN_RAII_PROFILE_SCOPE("Pipeline::CreateCompute");
+    pipeline_info.flags |= createFlags_;
+    VkPipelineCreateFlags2CreateInfoKHR flags2{VK_STRUCTURE_TYPE_PIPELINE_CREATE_FLAGS_2_CREATE_INFO_KHR};
+    if (!recordFeedback_) {
+        if (indirectBindable_) {
+            ChainIndirectBindable(pipeline_info, flags2);
+        }
+        return vkCreateComputePipelines(device_, pipeline_cache, 1, &pipeline_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_PIPELINE), &pipeline_);
+    }
+
+    VkPipelineCreationFeedbackEXT feedback{};
+    std::vector<VkPipelineCreationFeedbackEXT> stage_feedback(1);
+    VkPipelineCreationFeedbackCreateInfoEXT feedback_info{VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT};
+    feedback_info.pNext = pipeline_info.pNext;
+    feedback_info.pPipelineCreationFeedback = &feedback;
+    feedback_info.pipelineStageCreationFeedbackCount = 1;
+    feedback_info.pPipelineStageCreationFeedbacks = stage_feedback.data();
+    pipeline_info.pNext = &feedback_info;
+    if (captureExecutables_) {
+        pipeline_info.flags |= VK_PIPELINE_CREATE_CAPTURE_STATISTICS_BIT_KHR;
+    }
+    if (indirectBindable_) {
+        ChainIndirectBindable(pipeline_info, flags2);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const VkResult result = vkCreateComputePipelines(device_, pipeline_cache, 1, &pipeline_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_PIPELINE), &pipeline_);
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    if (result == VK_SUCCESS) {
+        RecordStatistics(feedback, stage_feedback, &pipeline_info.stage, elapsed.count(), captureExecutables_);
+    }
+    return result;
+}
+
+void Pipeline::RecordStatistics(const VkPipelineCreationFeedbackEXT& feedback,
+                                const std::vector<VkPipelineCreationFeedbackEXT>& stage_feedback,
+                                const VkPipelineShaderStageCreateInfo* stages,
+                                double host_duration_ms,
+                                bool capture_executables) const
+{
+    constexpr double NANOSECONDS_PER_MS = 1000000.0;
+
+    PipelineCompileStats stats{};
+    stats.name = debugName_.Get();
+    stats.pipeline = pipeline_;
+    stats.feedbackValid = (feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT) != 0;
+    stats.cacheHit = stats.feedbackValid &&
+                     (feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT) != 0;
+    stats.durationMs = stats.feedbackValid ? static_cast<double>(feedback.duration) / NANOSECONDS_PER_MS : host_duration_ms;
+    for (size_t i = 0; i < stage_feedback.size(); ++i) {
+        if ((stage_feedback[i].flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT) == 0) {
+            continue;
+        }
+        PipelineStageCompileStats stage{};
+        stage.stage = stages[i].stage;
+        stage.durationMs = static_cast<double>(stage_feedback[i].duration) / NANOSECONDS_PER_MS;
+        stage.cacheHit = (stage_feedback[i].flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT) != 0;
+        stats.stages.push_back(stage);
+    }
+    if (capture_executables) {
+        stats.executables = QueryExecutableStatistics(device_, pipeline_);
+    }
+    PipelineStatistics::Record(std::move(stats));
+}
+
 void Pipeline::Cleanup()
 {
     if (pipeline_ != VK_NULL_HANDLE) {
-        vkDestroyPipeline(device_, pipeline_, nullptr);
+        if (recordFeedback_) {
+            PipelineStatistics::Forget(pipeline_);
+        }
+        vkDestroyPipeline(device_, pipeline_, Utils::HostAllocator::For(VK_OBJECT_TYPE_PIPELINE));
         pipeline_ = VK_NULL_HANDLE;
     }
     device_ = VK_NULL_HANDLE;
@@ -2,8 +2,11 @@
 #define VULKAN_RAII_RENDERING_PIPELINE_HPP
 
 #include <volk.h>
+#include <optional>
+#include <string>
 #include <vector>
 #include "PipelineStructs.hpp"
+#include "../utils/DebugUtils.hpp"
 
 
 namespace VulkanEngine::RAII {
@@ -28,7 +31,8 @@ public:
              const std::vector<VkDynamicState>& dynamic_states = {},
              uint32_t subpass = 0,
              VkPipeline base_pipeline = VK_NULL_HANDLE,
-             int32_t base_pipeline_index = -1);
+             int32_t base_pipeline_index = -1,
+             VkPipelineCache pipeline_cache = VK_NULL_HANDLE);
 
     // Constructor for graphics pipeline with tessellation
     Pipeline(const Device& device,
@@ -46,14 +50,62 @@ public:
              const std::vector<VkDynamicState>& dynamic_states = {},
              uint32_t subpass = 0,
              VkPipeline base_pipeline = VK_NULL_HANDLE,
-             int32_t base_pipeline_index = -1);
+             int32_t base_pipeline_index = -1,
+             VkPipelineCache pipeline_cache = VK_NULL_HANDLE);
+
+    // Constructor for graphics pipeline used with dynamic rendering instead of a render pass
+    Pipeline(const Device& device,
+             const PipelineRendering& rendering,
+             VkPipelineLayout layout,
+             const std::vector<PipelineShaderStage>& shader_stages,
+             const PipelineVertexInput& vertex_input,
+             const PipelineInputAssembly& input_assembly,
+             const PipelineViewport& viewport,
+             const PipelineRasterization& rasterization,
+             const PipelineMultisample& multisample,
+             const PipelineDepthStencil& depth_stencil,
+             const PipelineColorBlend& color_blend,
+             const std::vector<VkDynamicState>& dynamic_states = {},
+             VkPipeline base_pipeline = VK_NULL_HANDLE,
+             int32_t base_pipeline_index = -1,
+             VkPipelineCache pipeline_cache = VK_NULL_HANDLE);
 
     // Constructor for compute pipeline
     Pipeline(const Device& device,
              VkPipelineLayout layout,
              const PipelineShaderStage& compute_stage,
              VkPipeline base_pipeline = VK_NULL_HANDLE,
-             int32_t base_pipeline_index = -1);
+             int32_t base_pipeline_index = -1,
+             VkPipelineCache pipeline_cache = VK_NULL_HANDLE);
+
+    // Constructors from a complete description (see PipelineBatchBuilder, PipelineRegistry)
+    Pipeline(const Device& device,
+             const GraphicsPipelineDescription& description,
+             VkPipelineCache pipeline_cache = VK_NULL_HANDLE);
+    Pipeline(const Device& device,
+             const ComputePipelineDescription& description,
+             VkPipelineCache pipeline_cache = VK_NULL_HANDLE);
+
+    // Constructor for a graphics pipeline library (VK_EXT_graphics_pipeline_library)
+    // compiling only the library_parts state subsets of the description
+    Pipeline(const Device& device,
+             VkGraphicsPipelineLibraryFlagsEXT library_parts,
+             const GraphicsPipelineDescription& description,
+             VkPipelineCache pipeline_cache = VK_NULL_HANDLE);
+
+    // Constructor linking libraries that together hold all four state subsets.
+    // link_time_optimize gives code as fast as a monolithic pipeline at a much slower link
+    Pipeline(const Device& device,
+             VkPipelineLayout layout,
+             const std::vector<VkPipeline>& libraries,
+             bool link_time_optimize,
+             VkPipelineCache pipeline_cache = VK_NULL_HANDLE,
+             VkPipelineCreateFlags create_flags = 0);
+
+    // Mark every state the device can set at record time as dynamic, so descriptions
+    // that only differ in that state share one pipeline. The matching CommandBuffer
+    // setters must then be called before drawing
+    static void MakeStateDynamic(const Device& device, GraphicsPipelineDescription& description);
 
     // Destructor
     ~Pipeline();
@@ -81,11 +133,23 @@ public:
     [[nodiscard]] bool IsGraphicsPipeline() const { return type_ == Type::GRAPHICS; }
     [[nodiscard]] bool IsComputePipeline() const { return type_ == Type::COMPUTE; }
 
+    // Check whether an IndirectExecutionSet can select this pipeline
+    [[nodiscard]] bool IsIndirectBindable() const { return indirectBindable_; }
+
+    // Check whether this is a pipeline library (not bindable) and which state it holds
+    [[nodiscard]] bool IsLibrary() const { return libraryParts_ != 0; }
+    [[nodiscard]] VkGraphicsPipelineLibraryFlagsEXT GetLibraryParts() const { return libraryParts_; }
+
     // Get bind point
     [[nodiscard]] VkPipelineBindPoint GetBindPoint() const {
         return IsGraphicsPipeline() ? VK_PIPELINE_BIND_POINT_GRAPHICS : VK_PIPELINE_BIND_POINT_COMPUTE;
     }
 
+    // Debug name (for tools like RenderDoc and the PipelineStatistics reports); compiled out,
+    // together with description debug names, with VULKAN_RAII_DEBUG_NAMES=0
+    void SetDebugName(const char* name);
+    [[nodiscard]] const char* GetDebugName() const { return debugName_.Get(); }
+
 private:
     enum class Type {
         GRAPHICS,
@@ -96,9 +160,26 @@ private:
     VkDevice device_{VK_NULL_HANDLE}; // Reference to device
     VkPipelineLayout layout_{VK_NULL_HANDLE}; // Reference to layout
     Type type_; // Intentionally no default: all ctors must set this
+    VkGraphicsPipelineLibraryFlagsEXT libraryParts_{0};
+    VkPipelineCreateFlags createFlags_{0}; // Description createFlags, added to every create info
+    bool indirectBindable_{false}; // Description indirectBindable, chained as a 64-bit create flag
+    std::optional<PipelineFragmentShadingRate> fragmentShadingRate_; // Description state, chained to graphics create infos
+    bool recordFeedback_{false}; // PipelineStatistics creation feedback
+    bool captureExecutables_{false}; // PipelineStatistics executable statistics
+    [[no_unique_address]] Utils::DebugName debugName_; // Empty type when names are compiled out
 
     // Helper methods
-    void CreateGraphicsPipeline(const RenderPass& render_pass,
+    void ConfigureStatistics(const Device& device, const std::string& debug_name = {});
+    VkResult CreateHandle(VkGraphicsPipelineCreateInfo pipeline_info, VkPipelineCache pipeline_cache);
+    VkResult CreateHandle(VkComputePipelineCreateInfo pipeline_info, VkPipelineCache pipeline_cache);
+    void RecordStatistics(const VkPipelineCreationFeedbackEXT& feedback,
+                          const std::vector<VkPipelineCreationFeedbackEXT>& stage_feedback,
+                          const VkPipelineShaderStageCreateInfo* stages,
+                          double host_duration_ms,
+                          bool capture_executables) const;
+
+    void CreateGraphicsPipeline(VkRenderPass render_pass,
+                               const PipelineRendering* rendering,
                                const std::vector<PipelineShaderStage>& shader_stages,
                                const PipelineVertexInput& vertex_input,
                                const PipelineInputAssembly& input_assembly,
@@ -110,9 +191,11 @@ private:
                                const std::vector<VkDynamicState>& dynamic_states,
                                uint32_t subpass,
                                VkPipeline base_pipeline,
-                               int32_t base_pipeline_index);
+                               int32_t base_pipeline_index,
+                               VkPipelineCache pipeline_cache);
 
-    void CreateGraphicsPipelineWithTessellation(const RenderPass& render_pass,
+    void CreateGraphicsPipelineWithTessellation(VkRenderPass render_pass,
+                                               const PipelineRendering* rendering,
                                                const std::vector<PipelineShaderStage>& shader_stages,
                                                const PipelineVertexInput& vertex_input,
                                                const PipelineInputAssembly& input_assembly,
@@ -125,11 +208,17 @@ private:
                                                const std::vector<VkDynamicState>& dynamic_states,
                                                uint32_t subpass,
                                                VkPipeline base_pipeline,
-                                               int32_t base_pipeline_index);
+                                               int32_t base_pipeline_index,
+                                               VkPipelineCache pipeline_cache);
+
+    void CreateGraphicsPipelineLibrary(const GraphicsPipelineDescription& description,
+                                       VkGraphicsPipelineLibraryFlagsEXT library_parts,
+                                       VkPipelineCache pipeline_cache);
 
     void CreateComputePipeline(const PipelineShaderStage& compute_stage,
                               VkPipeline base_pipeline,
-                              int32_t base_pipeline_index);
+                              int32_t base_pipeline_index,
+                              VkPipelineCache pipeline_cache);
 
     void Cleanup();
 };
@@ -0,0 +1,133 @@
+#include "PipelineBatchBuilder.hpp"
+
+#include "../core/Device.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+namespace VulkanEngine::RAII {
+
+PipelineBatchBuilder::PipelineBatchBuilder(const Device& device, VkPipelineCache pipeline_cache, uint32_t thread_count)
+    : device_(&device),
+    pipelineCache_(pipeline_cache)
+{
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers_.reserve(thread_count);
+    for (uint32_t i = 0; i < thread_count; ++i) {
+        workers_.emplace_back([this]() { WorkerLoop(); });
+    }
+}
+
+PipelineBatchBuilder::~PipelineBatchBuilder()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    taskAvailable_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+std::future<Pipeline> PipelineBatchBuilder::Add(const GraphicsPipelineDescription& description)
+{
+    if (!description.HasRenderTarget()) {
+        throw std::invalid_argument("Graphics pipeline description requires a render pass or rendering formats");
+    }
+
+    // Copied so the caller's description may go away before the worker runs
+    return Enqueue(std::packaged_task<Pipeline()>([this, description]() {
+        return Pipeline(*device_, description, pipelineCache_);
+    }));
+}
+
+std::future<Pipeline> PipelineBatchBuilder::Add(const ComputePipelineDescription& description)
+{
+    return Enqueue(std::packaged_task<Pipeline()>([this, description]() {
+        return Pipeline(*device_, description, pipelineCache_);
+    }));
+}
+
+std::vector<Pipeline> PipelineBatchBuilder::Build(const std::vector<GraphicsPipelineDescription>& descriptions)
+{
+    std::vector<std::future<Pipeline>> futures;
+    futures.reserve(descriptions.size());
+    for (const GraphicsPipelineDescription& description : descriptions) {
+        futures.push_back(Add(description));
+    }
+
+    std::vector<Pipeline> pipelines;
+    pipelines.reserve(futures.size());
+    for (std::future<Pipeline>& future : futures) {
+        pipelines.push_back(future.get());
+    }
+    return pipelines;
+}
+
+std::vector<Pipeline> PipelineBatchBuilder::Build(const std::vector<ComputePipelineDescription>& descriptions)
+{
+    std::vector<std::future<Pipeline>> futures;
+    futures.reserve(descriptions.size());
+    for (const ComputePipelineDescription& description : descriptions) {
+        futures.push_back(Add(description));
+    }
+
+    std::vector<Pipeline> pipelines;
+    pipelines.reserve(futures.size());
+    for (std::future<Pipeline>& future : futures) {
+        pipelines.push_back(future.get());
+    }
+    return pipelines;
+}
+
+void PipelineBatchBuilder::Wait()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this]() { return pendingCount_ == 0; });
+}
+
+std::future<Pipeline> PipelineBatchBuilder::Enqueue(std::packaged_task<Pipeline()> task)
+{
+    std::future<Pipeline> future = task.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+        ++pendingCount_;
+    }
+    taskAvailable_.notify_one();
+    return future;
+}
+
+void PipelineBatchBuilder::WorkerLoop()
+{
+    for (;;) {
+        std::packaged_task<Pipeline()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            taskAvailable_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+                return; // Stopping and drained
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+
+        // Exceptions are stored in the future
+        task();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --pendingCount_;
+        }
+        idle_.notify_all();
+    }
+}
+
+} // namespace VulkanEngine::RAII
@@ -0,0 +1,74 @@
+#ifndef VULKAN_RAII_RENDERING_PIPELINE_BATCH_BUILDER_HPP
+#define VULKAN_RAII_RENDERING_PIPELINE_BATCH_BUILDER_HPP
+
+#include <volk.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Pipeline.hpp"
+#include "PipelineStructs.hpp"
+
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+
+// Compiles pipelines on a pool of worker threads. All workers share one
+// VkPipelineCache, which the driver synchronizes internally, so pipelines
+// compiled by one thread are cache hits for the others.
+// Render passes, layouts, shader modules and raw specializationInfo pointers in
+// a description must stay alive until its pipeline has been built.
+class PipelineBatchBuilder {
+public:
+    // Constructor. thread_count 0 uses one worker per hardware thread
+    explicit PipelineBatchBuilder(const Device& device,
+                                  VkPipelineCache pipeline_cache = VK_NULL_HANDLE,
+                                  uint32_t thread_count = 0);
+
+    // Destructor (finishes queued pipelines, then joins the workers)
+    ~PipelineBatchBuilder();
+
+    // Delete copy and move. the worker threads hold a reference to this object.
+    PipelineBatchBuilder(const PipelineBatchBuilder&) = delete;
+    PipelineBatchBuilder& operator=(const PipelineBatchBuilder&) = delete;
+    PipelineBatchBuilder(PipelineBatchBuilder&&) = delete;
+    PipelineBatchBuilder& operator=(PipelineBatchBuilder&&) = delete;
+
+    // Queue a pipeline; creation errors are rethrown by future::get()
+    std::future<Pipeline> Add(const GraphicsPipelineDescription& description);
+    std::future<Pipeline> Add(const ComputePipelineDescription& description);
+
+    // Compile a whole batch and return the pipelines in description order
+    std::vector<Pipeline> Build(const std::vector<GraphicsPipelineDescription>& descriptions);
+    std::vector<Pipeline> Build(const std::vector<ComputePipelineDescription>& descriptions);
+
+    // Block until every queued pipeline has been built
+    void Wait();
+
+    [[nodiscard]] uint32_t GetThreadCount() const { return static_cast<uint32_t>(workers_.size()); }
+
+private:
+    const Device* device_{nullptr};
+    VkPipelineCache pipelineCache_{VK_NULL_HANDLE};
+
+    std::vector<std::thread> workers_;
+    std::deque<std::packaged_task<Pipeline()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable taskAvailable_;
+    std::condition_variable idle_;
+    uint32_t pendingCount_{0};
+    bool stopping_{false};
+
+    std::future<Pipeline> Enqueue(std::packaged_task<Pipeline()> task);
+    void WorkerLoop();
+};
+
+} // namespace VulkanEngine::RAII
+
+
+#endif // VULKAN_RAII_RENDERING_PIPELINE_BATCH_BUILDER_HPP
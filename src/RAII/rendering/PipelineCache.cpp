@@ -0,0 +1,179 @@
+#include "PipelineCache.hpp"
+
+#include "../core/Device.hpp"
+#include "../core/PhysicalDevice.hpp"
+#include "../utils/HostAllocator.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+
+namespace VulkanEngine::RAII {
+
+namespace {
+std::vector<uint8_t> ReadFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return {};
+    }
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+} // namespace
+
+PipelineCache::PipelineCache(const Device& device)
+    : device_(device.GetHandle())
+{
+    CreatePipelineCache(device, {});
+}
+
+PipelineCache::PipelineCache(const Device& device, const std::string& path)
+    : device_(device.GetHandle())
+{
+    CreatePipelineCache(device, ReadFile(path));
+}
+
+PipelineCache::PipelineCache(const Device& device, const std::vector<uint8_t>& initial_data)
+    : device_(device.GetHandle())
+{
+    CreatePipelineCache(device, initial_data);
+}
+
+PipelineCache::~PipelineCache() {
+    Cleanup();
+}
+
+PipelineCache::PipelineCache(PipelineCache&& other) noexcept
+    : pipelineCache_(other.pipelineCache_),
+    device_(other.device_),
+    loaded_(other.loaded_)
+{
+    other.pipelineCache_ = VK_NULL_HANDLE;
+    other.device_ = VK_NULL_HANDLE;
+    other.loaded_ = false;
+}
+
+PipelineCache& PipelineCache::operator=(PipelineCache&& other) noexcept {
+    if (this != &other) {
+        Cleanup();
+        pipelineCache_ = other.pipelineCache_;
+        device_ = other.device_;
+        loaded_ = other.loaded_;
+        other.pipelineCache_ = VK_NULL_HANDLE;
+        other.device_ = VK_NULL_HANDLE;
+        other.loaded_ = false;
+    }
+    return *this;
+}
+
+std::vector<uint8_t> PipelineCache::GetData() const
+{
+    size_t size = 0;
+    if (vkGetPipelineCacheData(device_, pipelineCache_, &size, nullptr) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to get pipeline cache data size");
+    }
+    std::vector<uint8_t> data(size);
+    if (size > 0 && vkGetPipelineCacheData(device_, pipelineCache_, &size, data.data()) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to get pipeline cache data");
+    }
+    data.resize(size);
+    return data;
+}
+
+bool PipelineCache::Save(const std::string& path) const
+{
+    const std::vector<uint8_t> data = GetData();
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "[PipelineCache] Could not open " << temp_path << " for writing" << '\n';
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!file) {
+            std::cerr << "[PipelineCache] Failed to write " << temp_path << '\n';
+            return false;
+        }
+    }
+    // Replaces the old file in one step (rename on POSIX, MoveFileEx with REPLACE_EXISTING on Windows)
+    std::error_code error;
+    std::filesystem::rename(temp_path, path, error);
+    if (error) {
+        std::cerr << "[PipelineCache] Failed to move " << temp_path << " to " << path << ": " << error.message() << '\n';
+        std::filesystem::remove(temp_path, error);
+        return false;
+    }
+    return true;
+}
+
+void PipelineCache::Merge(const std::vector<VkPipelineCache>& source_caches) const
+{
+    if (source_caches.empty()) {
+        return;
+    }
+    if (vkMergePipelineCaches(device_, pipelineCache_, static_cast<uint32_t>(source_caches.size()),
+                              source_caches.data()) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to merge pipeline caches");
+    }
+}
+
+bool PipelineCache::IsCompatible(const PhysicalDevice& physical_device, const void* data, size_t size)
+{
+    VkPipelineCacheHeaderVersionOne header{};
+    if (data == nullptr || size < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    const VkPhysicalDeviceProperties& properties = physical_device.GetProperties();
+    return header.headerSize >= sizeof(header) &&
+        header.headerSize <= size &&
+        header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+        header.vendorID == properties.vendorID &&
+        header.deviceID == properties.deviceID &&
+        std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+void PipelineCache::CreatePipelineCache(const Device& device, const std::vector<uint8_t>& initial_data)
+{
+    loaded_ = !initial_data.empty() && IsCompatible(device.GetPhysicalDevice(), initial_data.data(), initial_data.size());
+    if (!initial_data.empty() && !loaded_) {
+        std::cerr << "[PipelineCache] Discarding cache data from a different driver or device" << '\n';
+    }
+
+    VkPipelineCacheCreateInfo create_info{VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
+    create_info.initialDataSize = loaded_ ? initial_data.size() : 0;
+    create_info.pInitialData = loaded_ ? initial_data.data() : nullptr;
+
+    VkResult result = vkCreatePipelineCache(device_, &create_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_PIPELINE_CACHE), &pipelineCache_);
+    if (result != VK_SUCCESS && loaded_) {
+        // The driver may still reject data it does not like; start cold instead
+        std::cerr << "[PipelineCache] Driver rejected cache data, starting with an empty cache" << '\n';
+        loaded_ = false;
+        create_info.initialDataSize = 0;
+        create_info.pInitialData = nullptr;
+        result = vkCreatePipelineCache(device_, &create_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_PIPELINE_CACHE), &pipelineCache_);
+    }
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create pipeline cache");
+    }
+}
+
+void PipelineCache::Cleanup()
+{
+    if (pipelineCache_ != VK_NULL_HANDLE) {
+        vkDestroyPipelineCache(device_, pipelineCache_, Utils::HostAllocator::For(VK_OBJECT_TYPE_PIPELINE_CACHE));
+        pipelineCache_ = VK_NULL_HANDLE;
+    }
+    device_ = VK_NULL_HANDLE;
+}
+
+} // namespace VulkanEngine::RAII
@@ -0,0 +1,78 @@
+#ifndef VULKAN_RAII_RENDERING_PIPELINE_CACHE_HPP
+#define VULKAN_RAII_RENDERING_PIPELINE_CACHE_HPP
+
+#include <volk.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+class PhysicalDevice; // Forward declaration
+
+// RAII wrapper around VkPipelineCache with on-disk persistence. Pass it to the
+// Pipeline constructors so warm starts reuse the driver's compiled pipelines.
+// A file written by a different driver or GPU is detected from the cache
+// header and ignored, starting with an empty cache instead.
+class PipelineCache {
+public:
+    // Constructor that creates an empty pipeline cache
+    explicit PipelineCache(const Device& device);
+
+    // Constructor that loads the cache from a file (empty if missing or incompatible)
+    PipelineCache(const Device& device, const std::string& path);
+
+    // Constructor that creates a pipeline cache from serialized data (empty if incompatible)
+    PipelineCache(const Device& device, const std::vector<uint8_t>& initial_data);
+
+    // Destructor
+    ~PipelineCache();
+
+    // Move constructor and assignment
+    PipelineCache(PipelineCache&& other) noexcept;
+    PipelineCache& operator=(PipelineCache&& other) noexcept;
+
+    // Delete copy constructor and assignment. this ensures unique ownership of the VkPipelineCache by only allowing moving.
+    PipelineCache(const PipelineCache&) = delete;
+    PipelineCache& operator=(const PipelineCache&) = delete;
+
+    [[nodiscard]] VkPipelineCache GetHandle() const { return pipelineCache_; }
+
+    // Implicit conversion to VkPipelineCache
+    operator VkPipelineCache() const { return pipelineCache_; }
+
+    // Check if the pipeline cache is valid
+    [[nodiscard]] bool IsValid() const { return pipelineCache_ != VK_NULL_HANDLE; }
+
+    // Check if the initial data was accepted (false for a cold start)
+    [[nodiscard]] bool WasLoaded() const { return loaded_; }
+
+    // Serialize the cache contents
+    [[nodiscard]] std::vector<uint8_t> GetData() const;
+
+    // Write the cache to a file (through a temporary file, so a crash never leaves a torn cache)
+    bool Save(const std::string& path) const; // NOLINT(modernize-use-nodiscard)
+
+    // Merge other caches into this one
+    void Merge(const std::vector<VkPipelineCache>& source_caches) const;
+
+    // Check that serialized data was produced by this driver and device
+    static bool IsCompatible(const PhysicalDevice& physical_device, const void* data, size_t size);
+
+private:
+    VkPipelineCache pipelineCache_{VK_NULL_HANDLE};
+    VkDevice device_{VK_NULL_HANDLE};
+    bool loaded_{false};
+
+    // Helper methods
+    void CreatePipelineCache(const Device& device, const std::vector<uint8_t>& initial_data);
+    void Cleanup();
+};
+
+} // namespace VulkanEngine::RAII
+
+
+#endif // VULKAN_RAII_RENDERING_PIPELINE_CACHE_HPP
@@ -0,0 +1,290 @@
+#include "PipelineLibraryLinker.hpp"
+
+#include "PipelineRegistry.hpp"
+#include "Renderer.hpp"
+#include "../core/Device.hpp"
+#include "../utils/Constants.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+namespace VulkanEngine::RAII {
+
+namespace {
+constexpr std::array<VkGraphicsPipelineLibraryFlagBitsEXT, 4> LIBRARY_PARTS = {
+    VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT,
+    VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT,
+    VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT,
+    VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT
+};
+
+// Copy of the state a library part is compiled from; everything else stays at
+// its default so that descriptions sharing the subset produce the same key
+GraphicsPipelineDescription ExtractPart(const GraphicsPipelineDescription& description,
+                                        VkGraphicsPipelineLibraryFlagBitsEXT part)
+{
+    GraphicsPipelineDescription subset{};
+    subset.dynamicStates = description.dynamicStates;
+    subset.createFlags = description.createFlags; // Libraries and the linked pipeline must agree
+    switch (part) {
+    case VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT:
+        subset.vertexInput = description.vertexInput;
+        subset.inputAssembly = description.inputAssembly;
+        break;
+    case VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT:
+        subset.renderPass = description.renderPass;
+        subset.rendering = description.rendering;
+        subset.subpass = description.subpass;
+        subset.layout = description.layout;
+        subset.layoutHash = description.layoutHash;
+        for (const PipelineShaderStage& stage : description.shaderStages) {
+            if (stage.stage != VK_SHADER_STAGE_FRAGMENT_BIT) {
+                subset.shaderStages.push_back(stage);
+            }
+        }
+        subset.tessellation = description.tessellation;
+        subset.viewport = description.viewport;
+        subset.rasterization = description.rasterization;
+        subset.fragmentShadingRate = description.fragmentShadingRate;
+        break;
+    case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT:
+        subset.renderPass = description.renderPass;
+        subset.rendering = description.rendering;
+        subset.subpass = description.subpass;
+        subset.layout = description.layout;
+        subset.layoutHash = description.layoutHash;
+        for (const PipelineShaderStage& stage : description.shaderStages) {
+            if (stage.stage == VK_SHADER_STAGE_FRAGMENT_BIT) {
+                subset.shaderStages.push_back(stage);
+            }
+        }
+        subset.multisample = description.multisample;
+        subset.depthStencil = description.depthStencil;
+        subset.fragmentShadingRate = description.fragmentShadingRate;
+        break;
+    default:
+        subset.renderPass = description.renderPass;
+        subset.rendering = description.rendering;
+        subset.subpass = description.subpass;
+        subset.multisample = description.multisample;
+        subset.colorBlend = description.colorBlend;
+        break;
+    }
+    return subset;
+}
+} // namespace
+
+PipelineLibraryLinker::PipelineLibraryLinker(const Device& device, VkPipelineCache pipeline_cache)
+    : device_(&device),
+    pipelineCache_(pipeline_cache),
+    useLibraries_(IsSupported(device))
+{
+    if (useLibraries_) {
+        optimizer_ = std::thread([this]() { OptimizerLoop(); });
+    }
+}
+
+PipelineLibraryLinker::~PipelineLibraryLinker()
+{
+    Detach();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        jobs_.clear();
+    }
+    jobAvailable_.notify_all();
+    if (optimizer_.joinable()) {
+        optimizer_.join();
+    }
+}
+
+bool PipelineLibraryLinker::IsSupported(const Device& device)
+{
+    return device.SupportsGraphicsPipelineLibrary();
+}
+
+void PipelineLibraryLinker::Precompile(const GraphicsPipelineDescription& description)
+{
+    if (!useLibraries_) {
+        // Nothing to split: warming up means building the whole pipeline
+        static_cast<void>(Get(description));
+        return;
+    }
+    if (!description.HasRenderTarget() || description.layout == VK_NULL_HANDLE) {
+        throw std::invalid_argument("Pipeline library precompilation requires a render target and layout");
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    static_cast<void>(GetLibrariesLocked(description));
+}
+
+VkPipeline PipelineLibraryLinker::Get(const GraphicsPipelineDescription& description)
+{
+    if (!description.HasRenderTarget() || description.layout == VK_NULL_HANDLE) {
+        throw std::invalid_argument("Graphics pipeline description requires a render target and layout");
+    }
+    StateKey key = PipelineRegistry::Serialize(description);
+
+    // Creation happens under the lock so concurrent first uses link once
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pipelines_.find(key);
+    if (it != pipelines_.end()) {
+        return it->second.pipeline->GetHandle();
+    }
+
+    LinkedEntry entry{};
+    if (!useLibraries_) {
+        entry.pipeline = std::make_unique<Pipeline>(*device_, description, pipelineCache_);
+        entry.isOptimized = true;
+        return pipelines_.emplace(std::move(key), std::move(entry)).first->second.pipeline->GetHandle();
+    }
+
+    std::vector<VkPipeline> libraries = GetLibrariesLocked(description);
+    entry.pipeline = std::make_unique<Pipeline>(*device_, description.layout, libraries, false, pipelineCache_, description.createFlags);
+    LinkedEntry& stored = pipelines_.emplace(std::move(key), std::move(entry)).first->second;
+
+    OptimizeJob job{};
+    job.entry = &stored;
+    job.layout = description.layout;
+    job.createFlags = description.createFlags;
+    job.libraries = std::move(libraries);
+    jobs_.push_back(std::move(job));
+    jobAvailable_.notify_one();
+    return stored.pipeline->GetHandle();
+}
+
+void PipelineLibraryLinker::Update()
+{
+    const uint64_t frames_in_flight = renderer_ ? renderer_->GetMaxFramesInFlight() : Constants::MAX_FRAMES_IN_FLIGHT;
+    std::vector<RetiredPipeline> released;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++frameCounter_;
+        for (LinkedEntry* entry : finished_) {
+            // Frames recorded before this one may still reference the fast link
+            RetiredPipeline retired{};
+            retired.pipeline = std::move(entry->pipeline);
+            retired.releaseFrame = frameCounter_ + frames_in_flight;
+            retired_.push_back(std::move(retired));
+            entry->pipeline = std::move(entry->optimized);
+            entry->isOptimized = true;
+        }
+        finished_.clear();
+
+        auto first_kept = std::stable_partition(retired_.begin(), retired_.end(), [this](const RetiredPipeline& retired) {
+            return retired.releaseFrame <= frameCounter_;
+        });
+        released.assign(std::make_move_iterator(retired_.begin()), std::make_move_iterator(first_kept));
+        retired_.erase(retired_.begin(), first_kept);
+    }
+    // Destroyed outside the lock
+    released.clear();
+}
+
+void PipelineLibraryLinker::AttachToRenderer(Renderer& renderer)
+{
+    Detach();
+    renderer_ = &renderer;
+    frameBeginSubscription_ = renderer.SubscribeFrameBegin([this](uint32_t /*frame_index*/) {
+        Update();
+    });
+}
+
+void PipelineLibraryLinker::Detach()
+{
+    frameBeginSubscription_.Reset();
+    renderer_ = nullptr;
+}
+
+void PipelineLibraryLinker::WaitForOptimizations()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this]() { return jobs_.empty() && !optimizing_; });
+}
+
+size_t PipelineLibraryLinker::GetLibraryCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return libraries_.size();
+}
+
+size_t PipelineLibraryLinker::GetPipelineCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pipelines_.size();
+}
+
+size_t PipelineLibraryLinker::GetOptimizedCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<size_t>(std::count_if(pipelines_.begin(), pipelines_.end(), [](const auto& entry) {
+        return entry.second.isOptimized;
+    }));
+}
+
+std::vector<VkPipeline> PipelineLibraryLinker::GetLibrariesLocked(const GraphicsPipelineDescription& description)
+{
+    std::vector<VkPipeline> libraries;
+    libraries.reserve(LIBRARY_PARTS.size());
+    for (VkGraphicsPipelineLibraryFlagBitsEXT part : LIBRARY_PARTS) {
+        const GraphicsPipelineDescription subset = ExtractPart(description, part);
+
+        // Tag the key with the part: an empty subset looks the same for every part
+        StateKey key(sizeof(part));
+        std::memcpy(key.data(), &part, sizeof(part));
+        const StateKey state = PipelineRegistry::Serialize(subset);
+        key.insert(key.end(), state.begin(), state.end());
+
+        auto it = libraries_.find(key);
+        if (it == libraries_.end()) {
+            it = libraries_.emplace(std::move(key), Pipeline(*device_, part, subset, pipelineCache_)).first;
+        }
+        libraries.push_back(it->second.GetHandle());
+    }
+    return libraries;
+}
+
+void PipelineLibraryLinker::OptimizerLoop()
+{
+    while (true) {
+        OptimizeJob job{};
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            jobAvailable_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+            optimizing_ = true;
+        }
+
+        std::unique_ptr<Pipeline> optimized;
+        try {
+            optimized = std::make_unique<Pipeline>(*device_, job.layout, job.libraries, true, pipelineCache_, job.createFlags);
+        } catch (const std::exception& e) {
+            // The fast-linked pipeline simply stays in use
+            std::cerr << "[PipelineLibraryLinker] Optimized link failed: " << e.what() << '\n';
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (optimized) {
+                job.entry->optimized = std::move(optimized);
+                finished_.push_back(job.entry);
+            }
+            optimizing_ = false;
+        }
+        idle_.notify_all();
+    }
+}
+
+} // namespace VulkanEngine::RAII
@@ -0,0 +1,125 @@
+#ifndef VULKAN_RAII_RENDERING_PIPELINE_LIBRARY_LINKER_HPP
+#define VULKAN_RAII_RENDERING_PIPELINE_LIBRARY_LINKER_HPP
+
+#include <volk.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "FrameBeginSubscription.hpp"
+#include "Pipeline.hpp"
+#include "PipelineStructs.hpp"
+
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+class Renderer; // Forward declaration
+
+// Builds graphics pipelines out of VK_EXT_graphics_pipeline_library parts so new
+// state combinations never stall a frame on a full compile. A description is
+// split into its four state subsets (vertex input, pre-rasterization shaders,
+// fragment shader, fragment output); each distinct subset is compiled into a
+// library once and shared by every pipeline using it. Get() fast-links the
+// libraries on first use and queues a link-time-optimized link on a background
+// thread; Update() swaps the optimized pipeline in and destroys the fast-linked
+// one once no frame in flight can still reference it.
+// Without library support on the device Get() creates monolithic pipelines.
+// Render passes, layouts and shader modules must outlive the linker.
+// Thread-safe.
+class PipelineLibraryLinker {
+public:
+    // Constructor
+    explicit PipelineLibraryLinker(const Device& device, VkPipelineCache pipeline_cache = VK_NULL_HANDLE);
+
+    // Destructor (abandons queued optimizations; no pipeline may still be in use)
+    ~PipelineLibraryLinker();
+
+    // Delete copy and move. the optimizer thread and attached renderer reference this object.
+    PipelineLibraryLinker(const PipelineLibraryLinker&) = delete;
+    PipelineLibraryLinker& operator=(const PipelineLibraryLinker&) = delete;
+    PipelineLibraryLinker(PipelineLibraryLinker&&) = delete;
+    PipelineLibraryLinker& operator=(PipelineLibraryLinker&&) = delete;
+
+    // Check whether the device enabled VK_EXT_graphics_pipeline_library
+    static bool IsSupported(const Device& device);
+    [[nodiscard]] bool UsesLibraries() const { return useLibraries_; }
+
+    // Compile the state subset libraries of a description ahead of its first draw
+    void Precompile(const GraphicsPipelineDescription& description);
+
+    // Executable pipeline for a description. Call again when recording each frame:
+    // the handle changes once the optimized link is swapped in
+    [[nodiscard]] VkPipeline Get(const GraphicsPipelineDescription& description);
+
+    // Swap in finished optimized pipelines and destroy replaced ones that can no
+    // longer be in flight. Call once per frame after the frame fence wait (automatic when attached)
+    void Update();
+
+    // Run Update() from Renderer::BeginFrame.
+    // The renderer must outlive this linker or Detach() must be called first
+    void AttachToRenderer(Renderer& renderer);
+    void Detach();
+
+    // Block until every queued optimized link has been compiled
+    void WaitForOptimizations();
+
+    [[nodiscard]] size_t GetLibraryCount() const;
+    [[nodiscard]] size_t GetPipelineCount() const;
+    [[nodiscard]] size_t GetOptimizedCount() const;
+
+private:
+    using StateKey = std::vector<uint8_t>;
+
+    struct LinkedEntry {
+        std::unique_ptr<Pipeline> pipeline;
+        std::unique_ptr<Pipeline> optimized; // Finished, waiting for Update()
+        bool isOptimized{false};
+    };
+
+    struct OptimizeJob {
+        LinkedEntry* entry{nullptr};
+        VkPipelineLayout layout{VK_NULL_HANDLE};
+        VkPipelineCreateFlags createFlags{0};
+        std::vector<VkPipeline> libraries;
+    };
+
+    struct RetiredPipeline {
+        std::unique_ptr<Pipeline> pipeline;
+        uint64_t releaseFrame{0};
+    };
+
+    const Device* device_{nullptr};
+    VkPipelineCache pipelineCache_{VK_NULL_HANDLE};
+    bool useLibraries_{false};
+
+    mutable std::mutex mutex_;
+    std::map<StateKey, Pipeline> libraries_;
+    std::map<StateKey, LinkedEntry> pipelines_;
+    std::vector<LinkedEntry*> finished_;
+    std::vector<RetiredPipeline> retired_;
+    uint64_t frameCounter_{0};
+
+    std::thread optimizer_;
+    std::deque<OptimizeJob> jobs_;
+    std::condition_variable jobAvailable_;
+    std::condition_variable idle_;
+    bool optimizing_{false};
+    bool stopping_{false};
+
+    Renderer* renderer_{nullptr};
+    FrameBeginSubscription frameBeginSubscription_;
+
+    std::vector<VkPipeline> GetLibrariesLocked(const GraphicsPipelineDescription& description);
+    void OptimizerLoop();
+};
+
+} // namespace VulkanEngine::RAII
+
+
+#endif // VULKAN_RAII_RENDERING_PIPELINE_LIBRARY_LINKER_HPP
@@ -0,0 +1,514 @@
+#include "PipelineRegistry.hpp"
+
+#include "RenderPass.hpp"
+#include "../core/Device.hpp"
+#include "../utils/HashUtils.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace VulkanEngine::RAII {
+
+namespace {
+// Appends state field by field so struct padding never reaches the key
+class StateWriter {
+public:
+    template<typename T>
+    void Write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const size_t offset = bytes_.size();
+        bytes_.resize(offset + sizeof(T));
+        std::memcpy(bytes_.data() + offset, &value, sizeof(T));
+    }
+
+    void WriteBytes(const void* data, size_t size)
+    {
+        Write(static_cast<uint64_t>(size));
+        if (size > 0) {
+            const size_t offset = bytes_.size();
+            bytes_.resize(offset + size);
+            std::memcpy(bytes_.data() + offset, data, size);
+        }
+    }
+
+    std::vector<uint8_t> Take() { return std::move(bytes_); }
+
+private:
+    std::vector<uint8_t> bytes_;
+};
+
+void WriteStage(StateWriter& writer, const PipelineShaderStage& stage)
+{
+    if (stage.codeHash == 0) {
+        throw std::invalid_argument("PipelineRegistry requires the code hash of every shader stage");
+    }
+    writer.Write(stage.stage);
+    writer.Write(stage.codeHash);
+    writer.WriteBytes(stage.entryPoint.data(), stage.entryPoint.size());
+    const VkSpecializationInfo* specialization = stage.GetSpecializationInfo();
+    writer.Write(static_cast<uint32_t>(specialization ? specialization->mapEntryCount : 0));
+    if (specialization) {
+        for (uint32_t i = 0; i < specialization->mapEntryCount; ++i) {
+            writer.Write(specialization->pMapEntries[i].constantID);
+            writer.Write(specialization->pMapEntries[i].offset);
+            writer.Write(static_cast<uint64_t>(specialization->pMapEntries[i].size));
+        }
+        writer.WriteBytes(specialization->pData, specialization->dataSize);
+    }
+}
+
+void WriteStencil(StateWriter& writer, const VkStencilOpState& state, const GraphicsPipelineDescription& description)
+{
+    if (!description.HasDynamicState(VK_DYNAMIC_STATE_STENCIL_OP_EXT)) {
+        writer.Write(state.failOp);
+        writer.Write(state.passOp);
+        writer.Write(state.depthFailOp);
+        writer.Write(state.compareOp);
+    }
+    if (!description.HasDynamicState(VK_DYNAMIC_STATE_STENCIL_COMPARE_MASK)) {
+        writer.Write(state.compareMask);
+    }
+    if (!description.HasDynamicState(VK_DYNAMIC_STATE_STENCIL_WRITE_MASK)) {
+        writer.Write(state.writeMask);
+    }
+    if (!description.HasDynamicState(VK_DYNAMIC_STATE_STENCIL_REFERENCE)) {
+        writer.Write(state.reference);
+    }
+}
+
+void WriteLayout(StateWriter& writer, VkPipelineLayout layout, uint64_t layout_hash)
+{
+    if (layout != VK_NULL_HANDLE && layout_hash == 0) {
+        throw std::invalid_argument("PipelineRegistry requires the layout hash of the pipeline layout");
+    }
+    writer.Write(layout_hash);
+}
+
+// Everything render pass compatibility depends on: pipelines built against one
+// pass may be used with any compatible pass, so layouts and load/store ops are left out
+void WriteRenderPass(StateWriter& writer, const RenderPass* render_pass)
+{
+    writer.Write(static_cast<uint32_t>(render_pass ? 1 : 0));
+    if (!render_pass) {
+        return;
+    }
+    const auto write_reference = [&writer](const VkAttachmentReference& reference) {
+        writer.Write(reference.attachment);
+    };
+    const auto write_references = [&](const std::vector<VkAttachmentReference>& references) {
+        writer.Write(static_cast<uint32_t>(references.size()));
+        for (const VkAttachmentReference& reference : references) {
+            write_reference(reference);
+        }
+    };
+
+    writer.Write(static_cast<uint32_t>(render_pass->GetAttachments().size()));
+    for (const AttachmentDescription& attachment : render_pass->GetAttachments()) {
+        writer.Write(attachment.format);
+        writer.Write(attachment.samples);
+        writer.Write(attachment.flags);
+    }
+    writer.Write(static_cast<uint32_t>(render_pass->GetSubpasses().size()));
+    for (const SubpassDescription& subpass : render_pass->GetSubpasses()) {
+        writer.Write(subpass.pipelineBindPoint);
+        writer.Write(subpass.flags);
+        write_references(subpass.inputAttachments);
+        write_references(subpass.colorAttachments);
+        write_references(subpass.resolveAttachments);
+        write_reference(subpass.depthStencilAttachment);
+        writer.Write(static_cast<uint32_t>(subpass.preserveAttachments.size()));
+        for (uint32_t attachment : subpass.preserveAttachments) {
+            writer.Write(attachment);
+        }
+        write_reference(subpass.shadingRateAttachment);
+        writer.Write(subpass.shadingRateTexelSize.width);
+        writer.Write(subpass.shadingRateTexelSize.height);
+    }
+    writer.Write(static_cast<uint32_t>(render_pass->GetDependencies().size()));
+    for (const SubpassDependency& dependency : render_pass->GetDependencies()) {
+        writer.Write(dependency.srcSubpass);
+        writer.Write(dependency.dstSubpass);
+        writer.Write(dependency.srcStageMask);
+        writer.Write(dependency.dstStageMask);
+        writer.Write(dependency.srcAccessMask);
+        writer.Write(dependency.dstAccessMask);
+        writer.Write(dependency.dependencyFlags);
+    }
+}
+
+// A dynamic topology may only vary within its class (points, lines, triangles, patches)
+uint32_t TopologyClass(VkPrimitiveTopology topology)
+{
+    switch (topology) {
+    case VK_PRIMITIVE_TOPOLOGY_POINT_LIST:
+        return 0;
+    case VK_PRIMITIVE_TOPOLOGY_LINE_LIST:
+    case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP:
+    case VK_PRIMITIVE_TOPOLOGY_LINE_LIST_WITH_ADJACENCY:
+    case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP_WITH_ADJACENCY:
+        return 1;
+    case VK_PRIMITIVE_TOPOLOGY_PATCH_LIST:
+        return 3;
+    default:
+        return 2;
+    }
+}
+
+// State set at record time is left out so descriptions that only differ in it
+// map to the same pipeline
+std::vector<uint8_t> SerializeState(const GraphicsPipelineDescription& description)
+{
+    const auto is_dynamic = [&description](VkDynamicState state) { return description.HasDynamicState(state); };
+
+    StateWriter writer;
+    writer.Write(VK_PIPELINE_BIND_POINT_GRAPHICS);
+    WriteRenderPass(writer, description.renderPass);
+    writer.Write(description.subpass);
+    WriteLayout(writer, description.layout, description.layoutHash);
+    writer.Write(description.createFlags);
+    writer.Write(description.indirectBindable);
+
+    // Sorted and deduplicated: declaration order does not change the pipeline
+    std::vector<VkDynamicState> dynamic_states = description.dynamicStates;
+    std::sort(dynamic_states.begin(), dynamic_states.end());
+    dynamic_states.erase(std::unique(dynamic_states.begin(), dynamic_states.end()), dynamic_states.end());
+    writer.Write(static_cast<uint32_t>(dynamic_states.size()));
+    for (VkDynamicState state : dynamic_states) {
+        writer.Write(state);
+    }
+
+    // Rendering formats only matter without a render pass
+    const bool use_rendering = description.renderPass == nullptr && description.rendering.has_value();
+    writer.Write(static_cast<uint32_t>(use_rendering ? 1 : 0));
+    if (use_rendering) {
+        writer.Write(description.rendering->viewMask);
+        writer.Write(static_cast<uint32_t>(description.rendering->colorAttachmentFormats.size()));
+        for (VkFormat format : description.rendering->colorAttachmentFormats) {
+            writer.Write(format);
+        }
+        writer.Write(description.rendering->depthAttachmentFormat);
+        writer.Write(description.rendering->stencilAttachmentFormat);
+    }
+
+    writer.Write(static_cast<uint32_t>(description.shaderStages.size()));
+    for (const PipelineShaderStage& stage : description.shaderStages) {
+        WriteStage(writer, stage);
+    }
+
+    writer.Write(static_cast<uint32_t>(description.vertexInput.bindingDescriptions.size()));
+    for (const VkVertexInputBindingDescription& binding : description.vertexInput.bindingDescriptions) {
+        writer.Write(binding.binding);
+        writer.Write(binding.stride);
+        writer.Write(binding.inputRate);
+    }
+    writer.Write(static_cast<uint32_t>(description.vertexInput.attributeDescriptions.size()));
+    for (const VkVertexInputAttributeDescription& attribute : description.vertexInput.attributeDescriptions) {
+        writer.Write(attribute.location);
+        writer.Write(attribute.binding);
+        writer.Write(attribute.format);
+        writer.Write(attribute.offset);
+    }
+
+    if (is_dynamic(VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY_EXT)) {
+        writer.Write(TopologyClass(description.inputAssembly.topology));
+    } else {
+        writer.Write(description.inputAssembly.topology);
+    }
+    if (!is_dynamic(VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE_EXT)) {
+        writer.Write(description.inputAssembly.primitiveRestartEnable);
+    }
+
+    writer.Write(static_cast<uint32_t>(description.tessellation ? 1 : 0));
+    if (description.tessellation && !is_dynamic(VK_DYNAMIC_STATE_PATCH_CONTROL_POINTS_EXT)) {
+        writer.Write(description.tessellation->patchControlPoints);
+    }
+
+    // The counts stay baked in even when the rectangles are dynamic
+    writer.Write(static_cast<uint32_t>(description.viewport.viewports.size()));
+    if (!is_dynamic(VK_DYNAMIC_STATE_VIEWPORT)) {
+        for (const VkViewport& viewport : description.viewport.viewports) {
+            writer.Write(viewport.x);
+            writer.Write(viewport.y);
+            writer.Write(viewport.width);
+            writer.Write(viewport.height);
+            writer.Write(viewport.minDepth);
+            writer.Write(viewport.maxDepth);
+        }
+    }
+    writer.Write(static_cast<uint32_t>(description.viewport.scissors.size()));
+    if (!is_dynamic(VK_DYNAMIC_STATE_SCISSOR)) {
+        for (const VkRect2D& scissor : description.viewport.scissors) {
+            writer.Write(scissor.offset.x);
+            writer.Write(scissor.offset.y);
+            writer.Write(scissor.extent.width);
+            writer.Write(scissor.extent.height);
+        }
+    }
+
+    const PipelineRasterization& rasterization = description.rasterization;
+    if (!is_dynamic(VK_DYNAMIC_STATE_DEPTH_CLAMP_ENABLE_EXT)) {
+        writer.Write(rasterization.depthClampEnable);
+    }
+    if (!is_dynamic(VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE_EXT)) {
+        writer.Write(rasterization.rasterizerDiscardEnable);
+    }
+    if (!is_dynamic(VK_DYNAMIC_STATE_POLYGON_MODE_EXT)) {
+        writer.Write(rasterization.polygonMode);
+    }
+    if (!is_dynamic(VK_DYNAMIC_STATE_CULL_MODE_EXT)) {
+        writer.Write(rasterization.cullMode);
+    }
+    if (!is_dynamic(VK_DYNAMIC_STATE_FRONT_FACE_EXT)) {
+        writer.Write(rasterization.frontFace);
+    }
+    if (!is_dynamic(VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE_EXT)) {
+        writer.Write(rasterization.depthBiasEnable);
+    }
+    if (!is_dynamic(VK_DYNAMIC_STATE_DEPTH_BIAS)) {
+        writer.Write(rasterization.depthBiasConstantFactor);
+        writer.Write(rasterization.depthBiasClamp);
+        writer.Write(rasterization.depthBiasSlopeFactor);
+    }
+    if (!is_dynamic(VK_DYNAMIC_STATE_LINE_WIDTH)) {
+        writer.Write(rasterization.lineWidth);
+    }
+
+    const PipelineMultisample& multisample = description.multisample;
+    if (!is_dynamic(VK_DYNAMIC_STATE_RASTERIZATION_SAMPLES_EXT)) {
+        writer.Write(multisample.rasterizationSamples);
+    }
+    writer.Write(multisample.sampleShadingEnable);
+    writer.Write(multisample.minSampleShading);
+    if (!is_dynamic(VK_DYNAMIC_STATE_ALPHA_TO_COVERAGE_ENABLE_EXT)) {
+        writer.Write(multisample.alphaToCoverageEnable);
+    }
+    writer.Write(multisample.alphaToOneEnable);
+    // One VkSampleMask word per 32 samples
+    const uint32_t mask_words = multisample.sampleMask ? (static_cast<uint32_t>(multisample.rasterizationSamples) + 31) / 32 : 0;
+    writer.WriteBytes(multisample.sampleMask, mask_words * sizeof(VkSampleMask));
+
+    writer.Write(static_cast<uint32_t>(description.fragmentShadingRate ? 1 : 0));
+    if (description.fragmentShadingRate && !is_dynamic(VK_DYNAMIC_STATE_FRAGMENT_SHADING_RATE_KHR)) {
+        writer.Write(description.fragmentShadingRate->fragmentSize.width);
+        writer.Write(description.fragmentShadingRate->fragmentSize.height);
+        writer.Write(description.fragmentShadingRate->combinerOps[0]);
+        writer.Write(description.fragmentShadingRate->combinerOps[1]);
+    }
+
+    const PipelineDepthStencil& depth_stencil = description.depthStencil;
+    if (!is_dynamic(VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT)) {
+        writer.Write(depth_stencil.depthTestEnable);
+    }
+    if (!is_dynamic(VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT)) {
+        writer.Write(depth_stencil.depthWriteEnable);
+    }
+    if (!is_dynamic(VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT)) {
+        writer.Write(depth_stencil.depthCompareOp);
+    }
+    if (!is_dynamic(VK_DYNAMIC_STATE_DEPTH_BOUNDS_TEST_ENABLE_EXT)) {
+        writer.Write(depth_stencil.depthBoundsTestEnable);
+    }
+    if (!is_dynamic(VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE_EXT)) {
+        writer.Write(depth_stencil.stencilTestEnable);
+    }
+    WriteStencil(writer, depth_stencil.front, description);
+    WriteStencil(writer, depth_stencil.back, description);
+    if (!is_dynamic(VK_DYNAMIC_STATE_DEPTH_BOUNDS)) {
+        writer.Write(depth_stencil.minDepthBounds);
+        writer.Write(depth_stencil.maxDepthBounds);
+    }
+
+    const PipelineColorBlend& color_blend = description.colorBlend;
+    if (!is_dynamic(VK_DYNAMIC_STATE_LOGIC_OP_ENABLE_EXT)) {
+        writer.Write(color_blend.logicOpEnable);
+    }
+    if (!is_dynamic(VK_DYNAMIC_STATE_LOGIC_OP_EXT)) {
+        writer.Write(color_blend.logicOp);
+    }
+    const bool dynamic_blend_enable = is_dynamic(VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT);
+    const bool dynamic_blend_equation = is_dynamic(VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT);
+    const bool dynamic_write_mask = is_dynamic(VK_DYNAMIC_STATE_COLOR_WRITE_MASK_EXT);
+    writer.Write(static_cast<uint32_t>(color_blend.attachments.size()));
+    for (const VkPipelineColorBlendAttachmentState& attachment : color_blend.attachments) {
+        if (!dynamic_blend_enable) {
+            writer.Write(attachment.blendEnable);
+        }
+        if (!dynamic_blend_equation) {
+            writer.Write(attachment.srcColorBlendFactor);
+            writer.Write(attachment.dstColorBlendFactor);
+            writer.Write(attachment.colorBlendOp);
+            writer.Write(attachment.srcAlphaBlendFactor);
+            writer.Write(attachment.dstAlphaBlendFactor);
+            writer.Write(attachment.alphaBlendOp);
+        }
+        if (!dynamic_write_mask) {
+            writer.Write(attachment.colorWriteMask);
+        }
+    }
+    if (!is_dynamic(VK_DYNAMIC_STATE_BLEND_CONSTANTS)) {
+        for (float constant : color_blend.blendConstants) {
+            writer.Write(constant);
+        }
+    }
+    return writer.Take();
+}
+
+std::vector<uint8_t> SerializeState(const ComputePipelineDescription& description)
+{
+    StateWriter writer;
+    writer.Write(VK_PIPELINE_BIND_POINT_COMPUTE);
+    WriteLayout(writer, description.layout, description.layoutHash);
+    writer.Write(description.createFlags);
+    writer.Write(description.indirectBindable);
+    WriteStage(writer, description.stage);
+    return writer.Take();
+}
+
+uint64_t HashBytes(const std::vector<uint8_t>& bytes)
+{
+    return Utils::HashFnv1a(bytes.data(), bytes.size());
+}
+} // namespace
+
+PipelineRegistry::PipelineRegistry(const Device& device, VkPipelineCache pipeline_cache)
+    : device_(&device),
+    pipelineCache_(pipeline_cache) {}
+
+SharedPipeline PipelineRegistry::Acquire(const GraphicsPipelineDescription& description)
+{
+    return AcquireImpl(description, SerializeState(description));
+}
+
+SharedPipeline PipelineRegistry::Acquire(const ComputePipelineDescription& description)
+{
+    return AcquireImpl(description, SerializeState(description));
+}
+
+void PipelineRegistry::Prune()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        const bool unused = it->second.pipeline.expired() && !it->second.compiling.valid();
+        it = unused ? entries_.erase(it) : std::next(it);
+    }
+}
+
+uint32_t PipelineRegistry::GetPipelineCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t count = 0;
+    for (const auto& entry : entries_) {
+        if (!entry.second.pipeline.expired()) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+uint64_t PipelineRegistry::GetHitCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hitCount_;
+}
+
+uint64_t PipelineRegistry::Hash(const GraphicsPipelineDescription& description)
+{
+    return HashBytes(SerializeState(description));
+}
+
+uint64_t PipelineRegistry::Hash(const ComputePipelineDescription& description)
+{
+    return HashBytes(SerializeState(description));
+}
+
+std::vector<uint8_t> PipelineRegistry::Serialize(const GraphicsPipelineDescription& description)
+{
+    return SerializeState(description);
+}
+
+std::vector<uint8_t> PipelineRegistry::Serialize(const ComputePipelineDescription& description)
+{
+    return SerializeState(description);
+}
+
+template<typename Description>
+SharedPipeline PipelineRegistry::AcquireImpl(const Description& description, std::vector<uint8_t> state)
+{
+    const uint64_t hash = HashBytes(state);
+
+    // Compiles run outside the lock; concurrent identical requests wait for the first
+    std::promise<std::shared_ptr<const Pipeline>> compiled;
+    uint32_t key = 0;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        Entry* entry = nullptr;
+        auto range = entries_.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second.state == state) { // Otherwise a hash collision
+                entry = &it->second;
+                break;
+            }
+        }
+        if (entry) {
+            if (std::shared_ptr<const Pipeline> pipeline = entry->pipeline.lock()) {
+                ++hitCount_;
+                return SharedPipeline{std::move(pipeline), entry->key};
+            }
+            if (entry->compiling.valid()) {
+                ++hitCount_;
+                const std::shared_future<std::shared_ptr<const Pipeline>> compiling = entry->compiling;
+                const uint32_t compiling_key = entry->key;
+                lock.unlock();
+                return SharedPipeline{compiling.get(), compiling_key};
+            }
+            // Expired: recreate in place and hand out a new key
+        } else {
+            Entry placeholder{};
+            placeholder.state = std::move(state);
+            entry = &entries_.emplace(hash, std::move(placeholder))->second;
+        }
+        entry->key = nextKey_++;
+        entry->compiling = compiled.get_future().share();
+        key = entry->key;
+    }
+
+    std::shared_ptr<const Pipeline> pipeline;
+    try {
+        pipeline = std::make_shared<const Pipeline>(*device_, description, pipelineCache_);
+    } catch (...) {
+        compiled.set_exception(std::current_exception());
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto range = entries_.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second.key == key) {
+                entries_.erase(it);
+                break;
+            }
+        }
+        throw;
+    }
+    compiled.set_value(pipeline);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto range = entries_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second.key == key) {
+            it->second.pipeline = pipeline;
+            it->second.compiling = {};
+            break;
+        }
+    }
+    return SharedPipeline{std::move(pipeline), key};
+}
+
+} // namespace VulkanEngine::RAII
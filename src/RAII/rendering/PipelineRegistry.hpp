@@ -0,0 +1,97 @@
+#ifndef VULKAN_RAII_RENDERING_PIPELINE_REGISTRY_HPP
+#define VULKAN_RAII_RENDERING_PIPELINE_REGISTRY_HPP
+
+#include <volk.h>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "Pipeline.hpp"
+#include "PipelineStructs.hpp"
+
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+
+// Shared reference to a registered pipeline. key is unique per distinct
+// pipeline state for the registry's lifetime, so draws can be sorted by it.
+struct SharedPipeline {
+    std::shared_ptr<const Pipeline> pipeline;
+    uint32_t key{0};
+
+    [[nodiscard]] VkPipeline GetHandle() const { return pipeline ? pipeline->GetHandle() : VK_NULL_HANDLE; }
+    const Pipeline* operator->() const { return pipeline.get(); }
+    explicit operator bool() const { return pipeline != nullptr; }
+};
+
+// Deduplicates pipelines by their full creation state. Every field of the
+// description is serialized into a canonical byte key: shaders by their code hash
+// (PipelineShaderStage::codeHash), layouts by the hash of their contents
+// (layoutHash), render passes by what compatibility depends on, specialization
+// constants by value. Handles never reach the key, so it is the same across runs
+// and a destroyed handle reused by the driver cannot return a stale pipeline.
+// Identical requests share one refcounted Pipeline, which is destroyed once the
+// last SharedPipeline referencing it goes away.
+// Thread-safe. Pipelines compile outside the lock, so different pipelines compile
+// in parallel; concurrent requests for one that is compiling wait for it.
+class PipelineRegistry {
+public:
+    // Constructor
+    explicit PipelineRegistry(const Device& device, VkPipelineCache pipeline_cache = VK_NULL_HANDLE);
+
+    // Delete copy and move. returned pipelines are tracked by this object.
+    PipelineRegistry(const PipelineRegistry&) = delete;
+    PipelineRegistry& operator=(const PipelineRegistry&) = delete;
+    PipelineRegistry(PipelineRegistry&&) = delete;
+    PipelineRegistry& operator=(PipelineRegistry&&) = delete;
+
+    // Get the pipeline for a description, creating it on first request. Throws
+    // std::invalid_argument when a stage lacks its codeHash or the layout its layoutHash
+    SharedPipeline Acquire(const GraphicsPipelineDescription& description);
+    SharedPipeline Acquire(const ComputePipelineDescription& description);
+
+    // Drop bookkeeping for pipelines nobody references any more
+    void Prune();
+
+    // Number of live registered pipelines
+    [[nodiscard]] uint32_t GetPipelineCount() const;
+
+    // Number of Acquire() calls answered without creating a pipeline
+    [[nodiscard]] uint64_t GetHitCount() const;
+
+    // Stable 64-bit hash of the creation state
+    static uint64_t Hash(const GraphicsPipelineDescription& description);
+    static uint64_t Hash(const ComputePipelineDescription& description);
+
+    // Canonical state bytes behind Hash(); equal bytes mean interchangeable pipelines
+    static std::vector<uint8_t> Serialize(const GraphicsPipelineDescription& description);
+    static std::vector<uint8_t> Serialize(const ComputePipelineDescription& description);
+
+private:
+    struct Entry {
+        std::vector<uint8_t> state;
+        std::weak_ptr<const Pipeline> pipeline;
+        std::shared_future<std::shared_ptr<const Pipeline>> compiling; // Valid while the first request compiles
+        uint32_t key{0};
+    };
+
+    const Device* device_{nullptr};
+    VkPipelineCache pipelineCache_{VK_NULL_HANDLE};
+
+    mutable std::mutex mutex_;
+    std::unordered_multimap<uint64_t, Entry> entries_;
+    uint32_t nextKey_{1};
+    uint64_t hitCount_{0};
+
+    template<typename Description>
+    SharedPipeline AcquireImpl(const Description& description, std::vector<uint8_t> state);
+};
+
+} // namespace VulkanEngine::RAII
+
+
+#endif // VULKAN_RAII_RENDERING_PIPELINE_REGISTRY_HPP
@@ -0,0 +1,179 @@
+#include "PipelineStatistics.hpp"
+
+#include "../utils/DebugUtils.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+namespace VulkanEngine::RAII {
+
+namespace {
+struct StatisticsRegistry {
+    std::mutex mutex;
+    PipelineStatistics::Options options;
+    std::unordered_map<VkPipeline, PipelineCompileStats> pipelines;
+};
+
+StatisticsRegistry& Registry()
+{
+    static StatisticsRegistry registry;
+    return registry;
+}
+
+std::string ToLower(std::string text)
+{
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    return text;
+}
+} // namespace
+
+const PipelineExecutableStatistic* PipelineExecutableStats::Find(const std::string& text) const
+{
+    const std::string needle = ToLower(text);
+    for (const PipelineExecutableStatistic& statistic : statistics) {
+        if (ToLower(statistic.name).find(needle) != std::string::npos) {
+            return &statistic;
+        }
+    }
+    return nullptr;
+}
+
+void PipelineStatistics::SetOptions(const Options& options)
+{
+    StatisticsRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.options = options;
+}
+
+PipelineStatistics::Options PipelineStatistics::GetOptions()
+{
+    StatisticsRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return registry.options;
+}
+
+void PipelineStatistics::Query(std::vector<PipelineCompileStats>& out)
+{
+    StatisticsRegistry& registry = Registry();
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        out.clear();
+        out.reserve(registry.pipelines.size());
+        for (const auto& entry : registry.pipelines) {
+            out.push_back(entry.second);
+        }
+    }
+    std::sort(out.begin(), out.end(), [](const PipelineCompileStats& a, const PipelineCompileStats& b) {
+        return a.durationMs > b.durationMs;
+    });
+}
+
+void PipelineStatistics::QueryNamed(std::vector<NamedPipelineStats>& out)
+{
+    std::unordered_map<std::string, NamedPipelineStats> named;
+    {
+        StatisticsRegistry& registry = Registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (const auto& entry : registry.pipelines) {
+            const PipelineCompileStats& stats = entry.second;
+            NamedPipelineStats& group = named[stats.name];
+            group.name = stats.name;
+            ++group.pipelineCount;
+            group.cacheHits += stats.cacheHit ? 1 : 0;
+            group.totalDurationMs += stats.durationMs;
+            group.maxDurationMs = std::max(group.maxDurationMs, stats.durationMs);
+        }
+    }
+
+    out.clear();
+    out.reserve(named.size());
+    for (auto& entry : named) {
+        out.push_back(std::move(entry.second));
+    }
+    std::sort(out.begin(), out.end(), [](const NamedPipelineStats& a, const NamedPipelineStats& b) {
+        return a.totalDurationMs > b.totalDurationMs;
+    });
+}
+
+double PipelineStatistics::GetCacheHitRate()
+{
+    StatisticsRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    uint32_t known = 0;
+    uint32_t hits = 0;
+    for (const auto& entry : registry.pipelines) {
+        if (entry.second.feedbackValid) {
+            ++known;
+            hits += entry.second.cacheHit ? 1 : 0;
+        }
+    }
+    return known == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(known);
+}
+
+void PipelineStatistics::Print(size_t max_pipelines)
+{
+    std::vector<PipelineCompileStats> pipelines;
+    Query(pipelines);
+
+    std::cout << "[PipelineStatistics] " << pipelines.size() << " pipelines, cache hit rate "
+              << GetCacheHitRate() * 100.0 << "%" << '\n';
+    for (size_t i = 0; i < pipelines.size() && i < max_pipelines; ++i) {
+        const PipelineCompileStats& stats = pipelines[i];
+        std::cout << "  " << (stats.name.empty() ? "<unnamed>" : stats.name) << ": " << stats.durationMs << " ms";
+        if (stats.feedbackValid) {
+            std::cout << (stats.cacheHit ? " (cache hit)" : " (cache miss)");
+        }
+        std::cout << '\n';
+        for (const PipelineExecutableStats& executable : stats.executables) {
+            std::cout << "    " << executable.name << " ["
+                      << Utils::StringUtils::ShaderStageFlagsToString(executable.stages) << "]" << '\n';
+            for (const PipelineExecutableStatistic& statistic : executable.statistics) {
+                std::cout << "      " << statistic.name << ": " << statistic.value << '\n';
+            }
+        }
+    }
+}
+
+void PipelineStatistics::Clear()
+{
+    StatisticsRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.pipelines.clear();
+}
+
+void PipelineStatistics::Record(PipelineCompileStats stats)
+{
+    StatisticsRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    const VkPipeline pipeline = stats.pipeline;
+    registry.pipelines[pipeline] = std::move(stats);
+}
+
+void PipelineStatistics::Rename(VkPipeline pipeline, const std::string& name)
+{
+    StatisticsRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto it = registry.pipelines.find(pipeline);
+    if (it != registry.pipelines.end()) {
+        it->second.name = name;
+    }
+}
+
+void PipelineStatistics::Forget(VkPipeline pipeline)
+{
+    StatisticsRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.pipelines.erase(pipeline);
+}
+
+} // namespace VulkanEngine::RAII
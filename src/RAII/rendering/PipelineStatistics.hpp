@@ -0,0 +1,98 @@
+#ifndef VULKAN_RAII_RENDERING_PIPELINE_STATISTICS_HPP
+#define VULKAN_RAII_RENDERING_PIPELINE_STATISTICS_HPP
+
+#include <volk.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace VulkanEngine::RAII {
+
+// One compiled stage as reported by VkPipelineCreationFeedback
+struct PipelineStageCompileStats {
+    VkShaderStageFlagBits stage{VK_SHADER_STAGE_VERTEX_BIT};
+    double durationMs{0.0};
+    bool cacheHit{false};
+};
+
+// One driver statistic (register count, spills, instruction count, ...). Names are driver specific
+struct PipelineExecutableStatistic {
+    std::string name;
+    std::string description;
+    double value{0.0};
+};
+
+// One executable of a pipeline (usually one per shader stage)
+struct PipelineExecutableStats {
+    std::string name;
+    std::string description;
+    VkShaderStageFlags stages{0};
+    uint32_t subgroupSize{0};
+    std::vector<PipelineExecutableStatistic> statistics;
+
+    // Statistic whose name contains the given text (case-insensitive), nullptr if none
+    [[nodiscard]] const PipelineExecutableStatistic* Find(const std::string& text) const;
+};
+
+// Compile report of one live pipeline
+struct PipelineCompileStats {
+    std::string name; // Pipeline debug name, empty when none was set
+    VkPipeline pipeline{VK_NULL_HANDLE};
+    double durationMs{0.0};
+    bool feedbackValid{false}; // False: durationMs is host-measured and cacheHit unknown
+    bool cacheHit{false};
+    std::vector<PipelineStageCompileStats> stages;
+    std::vector<PipelineExecutableStats> executables;
+};
+
+// Compile reports of all live pipelines sharing a debug name
+struct NamedPipelineStats {
+    std::string name;
+    uint32_t pipelineCount{0};
+    uint32_t cacheHits{0};
+    double totalDurationMs{0.0};
+    double maxDurationMs{0.0};
+};
+
+// Process-wide record of how long pipelines took to compile and whether the
+// pipeline cache served them. Recording is off by default; once enabled every
+// Pipeline created afterwards chains VkPipelineCreationFeedback and reports here.
+// Executable statistics (VK_KHR_pipeline_executable_properties) are a separate
+// debug flag as capturing them can slow compilation down.
+// Thread-safe.
+class PipelineStatistics {
+public:
+    struct Options {
+        bool creationFeedback{false};
+        bool executableStatistics{false}; // Needs pipelineExecutableInfo enabled on the device
+    };
+
+    static void SetOptions(const Options& options);
+    [[nodiscard]] static Options GetOptions();
+
+    // Reports of live pipelines, slowest compile first (fills out, reusing its storage)
+    static void Query(std::vector<PipelineCompileStats>& out);
+
+    // Reports grouped by debug name, largest total compile time first
+    static void QueryNamed(std::vector<NamedPipelineStats>& out);
+
+    // Share of recorded pipelines the pipeline cache served (0 when nothing was recorded)
+    [[nodiscard]] static double GetCacheHitRate();
+
+    // Print the slowest pipelines and their executable statistics to std::cout
+    static void Print(size_t max_pipelines = 16);
+
+    // Drop all reports
+    static void Clear();
+
+    // Bookkeeping used by Pipeline
+    static void Record(PipelineCompileStats stats);
+    static void Rename(VkPipeline pipeline, const std::string& name);
+    static void Forget(VkPipeline pipeline);
+};
+
+} // namespace VulkanEngine::RAII
+
+
+#endif // VULKAN_RAII_RENDERING_PIPELINE_STATISTICS_HPP
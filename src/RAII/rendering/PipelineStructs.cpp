@@ -1,7 +1,87 @@
 #include "PipelineStructs.hpp"
 #include <cstdint>
-
-
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+
+
+namespace VulkanEngine::RAII {
+
+SpecializationConstants::SpecializationConstants(const SpecializationConstants& other)
+    : entries_(other.entries_),
+    data_(other.data_)
+{
+    UpdateInfo();
+}
+
+SpecializationConstants& SpecializationConstants::operator=(const SpecializationConstants& other)
+{
+    if (this != &other) {
+        entries_ = other.entries_;
+        data_ = other.data_;
+        UpdateInfo();
+    }
+    return *this;
+}
+
+SpecializationConstants::SpecializationConstants(SpecializationConstants&& other) noexcept
+    : entries_(std::move(other.entries_)),
+    data_(std::move(other.data_))
+{
+    UpdateInfo();
+    other.Clear();
+}
+
+SpecializationConstants& SpecializationConstants::operator=(SpecializationConstants&& other) noexcept
+{
+    if (this != &other) {
+        entries_ = std::move(other.entries_);
+        data_ = std::move(other.data_);
+        UpdateInfo();
+        other.Clear();
+    }
+    return *this;
+}
+
+void SpecializationConstants::Clear()
+{
+    entries_.clear();
+    data_.clear();
+    UpdateInfo();
+}
+
+void SpecializationConstants::SetBytes(uint32_t constant_id, const void* value, size_t size)
+{
+    for (const VkSpecializationMapEntry& entry : entries_) {
+        if (entry.constantID == constant_id) {
+            if (entry.size != size) {
+                throw std::invalid_argument("Specialization constant " + std::to_string(constant_id) + " set with a different size");
+            }
+            std::memcpy(data_.data() + entry.offset, value, size);
+            return;
+        }
+    }
+
+    VkSpecializationMapEntry entry{};
+    entry.constantID = constant_id;
+    entry.offset = static_cast<uint32_t>(data_.size());
+    entry.size = size;
+    data_.resize(data_.size() + size);
+    std::memcpy(data_.data() + entry.offset, value, size);
+    entries_.push_back(entry);
+    UpdateInfo();
+}
+
+void SpecializationConstants::UpdateInfo()
+{
+    info_.mapEntryCount = static_cast<uint32_t>(entries_.size());
+    info_.pMapEntries = entries_.data();
+    info_.dataSize = data_.size();
+    info_.pData = data_.data();
+}
+
+} // namespace VulkanEngine::RAII
 
 namespace VulkanEngine::RAII::PipelineDefaults {
 
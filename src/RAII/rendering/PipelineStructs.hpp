@@ -2,17 +2,74 @@
 #define VULKAN_RAII_RENDERING_PIPELINE_STRUCTS_HPP
 
 #include <volk.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
 #include <vector>
 #include <string>
 
 
 namespace VulkanEngine::RAII {
 
+class RenderPass; // Forward declaration
+
+// Owns specialization constant values and their map entries. GetInfo() stays
+// valid (and follows copies and moves) for as long as the object lives.
+class SpecializationConstants {
+public:
+    SpecializationConstants() = default;
+    SpecializationConstants(const SpecializationConstants& other);
+    SpecializationConstants& operator=(const SpecializationConstants& other);
+    SpecializationConstants(SpecializationConstants&& other) noexcept;
+    SpecializationConstants& operator=(SpecializationConstants&& other) noexcept;
+    ~SpecializationConstants() = default;
+
+    // Set a constant (constant_id matches layout(constant_id = N) in the shader).
+    // bool is stored as VkBool32 as Vulkan requires
+    template<typename T>
+    SpecializationConstants& Set(uint32_t constant_id, const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Specialization constants must be trivially copyable");
+        if constexpr (std::is_same_v<T, bool>) {
+            const VkBool32 flag = value ? VK_TRUE : VK_FALSE;
+            SetBytes(constant_id, &flag, sizeof(flag));
+        } else {
+            SetBytes(constant_id, &value, sizeof(T));
+        }
+        return *this;
+    }
+
+    // Pointer for VkPipelineShaderStageCreateInfo (nullptr when no constant is set)
+    [[nodiscard]] const VkSpecializationInfo* GetInfo() const { return entries_.empty() ? nullptr : &info_; }
+
+    [[nodiscard]] bool IsEmpty() const { return entries_.empty(); }
+    [[nodiscard]] uint32_t GetCount() const { return static_cast<uint32_t>(entries_.size()); }
+
+    void Clear();
+
+private:
+    std::vector<VkSpecializationMapEntry> entries_;
+    std::vector<uint8_t> data_;
+    VkSpecializationInfo info_{};
+
+    void SetBytes(uint32_t constant_id, const void* value, size_t size);
+    void UpdateInfo();
+};
+
 struct PipelineShaderStage {
     VkShaderStageFlagBits stage;
     VkShaderModule module;
     std::string entryPoint = "main";
-    const VkSpecializationInfo* specializationInfo = nullptr;
+    const VkSpecializationInfo* specializationInfo = nullptr; // Ignored when specialization holds constants
+    SpecializationConstants specialization;
+    uint64_t codeHash = 0; // Shader::GetCodeHash() of module; how PipelineRegistry identifies the code
+
+    // The specialization info the stage is created with
+    [[nodiscard]] const VkSpecializationInfo* GetSpecializationInfo() const {
+        return specialization.IsEmpty() ? specializationInfo : specialization.GetInfo();
+    }
 };
 
 struct PipelineVertexInput {
@@ -52,6 +109,20 @@ struct PipelineMultisample {
     VkBool32 alphaToOneEnable = VK_FALSE;
 };
 
+// Pipeline fragment shading rate (VK_KHR_fragment_shading_rate, see
+// Device::SupportsPipelineFragmentShadingRate). combinerOps[0] merges this rate with
+// the primitive's, combinerOps[1] the result with the shading rate attachment's;
+// KEEP ignores the second operand, so use MAX (or REPLACE) to let an attachment coarsen
+// shading. VK_DYNAMIC_STATE_FRAGMENT_SHADING_RATE_KHR moves all of it to
+// CommandBuffer::SetFragmentShadingRate. With dynamic rendering, a pass with an
+// attachment also needs VK_PIPELINE_CREATE_RENDERING_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR
+// in the description's createFlags
+struct PipelineFragmentShadingRate {
+    VkExtent2D fragmentSize{1, 1};
+    std::array<VkFragmentShadingRateCombinerOpKHR, 2> combinerOps{VK_FRAGMENT_SHADING_RATE_COMBINER_OP_KEEP_KHR,
+                                                                   VK_FRAGMENT_SHADING_RATE_COMBINER_OP_KEEP_KHR};
+};
+
 struct PipelineDepthStencil {
     VkBool32 depthTestEnable = VK_TRUE;
     VkBool32 depthWriteEnable = VK_TRUE;
@@ -80,6 +151,52 @@ struct PipelineGeometry {
     // This struct exists for future extensibility
 };
 
+// Attachment formats for pipelines used with dynamic rendering (no RenderPass)
+struct PipelineRendering {
+    std::vector<VkFormat> colorAttachmentFormats;
+    VkFormat depthAttachmentFormat = VK_FORMAT_UNDEFINED;
+    VkFormat stencilAttachmentFormat = VK_FORMAT_UNDEFINED;
+    uint32_t viewMask = 0;
+};
+
+// Everything the graphics Pipeline constructors take, as one copyable value.
+// Either renderPass or rendering must be set; renderPass wins when both are
+struct GraphicsPipelineDescription {
+    const RenderPass* renderPass{nullptr};
+    std::optional<PipelineRendering> rendering;
+    VkPipelineLayout layout{VK_NULL_HANDLE};
+    uint64_t layoutHash{0}; // ShaderLayoutCache::HashLayout of layout; how PipelineRegistry identifies it
+    std::vector<PipelineShaderStage> shaderStages;
+    PipelineVertexInput vertexInput;
+    PipelineInputAssembly inputAssembly;
+    std::optional<PipelineTessellation> tessellation;
+    PipelineViewport viewport;
+    PipelineRasterization rasterization;
+    PipelineMultisample multisample;
+    PipelineDepthStencil depthStencil;
+    PipelineColorBlend colorBlend;
+    std::optional<PipelineFragmentShadingRate> fragmentShadingRate;
+    std::vector<VkDynamicState> dynamicStates;
+    uint32_t subpass{0};
+    VkPipelineCreateFlags createFlags{0}; // Added to the backend's own flags, e.g. DESCRIPTOR_BUFFER_BIT_EXT
+    bool indirectBindable{false}; // Selectable through an IndirectExecutionSet (VK_EXT_device_generated_commands)
+    std::string debugName; // Object name and PipelineStatistics key; not part of the state
+
+    [[nodiscard]] bool HasRenderTarget() const { return renderPass != nullptr || rendering.has_value(); }
+    [[nodiscard]] bool HasDynamicState(VkDynamicState state) const {
+        return std::find(dynamicStates.begin(), dynamicStates.end(), state) != dynamicStates.end();
+    }
+};
+
+struct ComputePipelineDescription {
+    VkPipelineLayout layout{VK_NULL_HANDLE};
+    uint64_t layoutHash{0}; // ShaderLayoutCache::HashLayout of layout; how PipelineRegistry identifies it
+    PipelineShaderStage stage{VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE};
+    VkPipelineCreateFlags createFlags{0}; // e.g. DESCRIPTOR_BUFFER_BIT_EXT
+    bool indirectBindable{false}; // Selectable through an IndirectExecutionSet (VK_EXT_device_generated_commands)
+    std::string debugName; // Object name and PipelineStatistics key; not part of the state
+};
+
 // Helper functions for creating common pipeline states
 namespace PipelineDefaults {
 
@@ -0,0 +1,145 @@
+#include "QueryPool.hpp"
+
+#include "../core/Device.hpp"
+#include "../utils/HostAllocator.hpp"
+
+#include <bit>
+#include <stdexcept>
+
+
+namespace VulkanEngine::RAII {
+
+QueryPool::QueryPool(const Device& device,
+                     VkQueryType type,
+                     uint32_t query_count,
+                     VkQueryPipelineStatisticFlags pipeline_statistics)
+    : device_(device.GetHandle()),
+    type_(type),
+    queryCount_(query_count),
+    pipelineStatistics_(type == VK_QUERY_TYPE_PIPELINE_STATISTICS ? pipeline_statistics : 0),
+    hostReset_(device.SupportsHostQueryReset())
+{
+    if (query_count == 0) {
+        throw std::invalid_argument("QueryPool requires a non-zero query count");
+    }
+    if (type == VK_QUERY_TYPE_PIPELINE_STATISTICS) {
+        if (pipeline_statistics == 0) {
+            throw std::invalid_argument("Pipeline statistics pools require at least one counter");
+        }
+        if (device.GetEnabledFeatures().pipelineStatisticsQuery != VK_TRUE) {
+            throw std::runtime_error("Pipeline statistics queries require the pipelineStatisticsQuery feature");
+        }
+    }
+
+    VkQueryPoolCreateInfo create_info{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+    create_info.queryType = type;
+    create_info.queryCount = query_count;
+    create_info.pipelineStatistics = pipelineStatistics_;
+
+    if (vkCreateQueryPool(device_, &create_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_QUERY_POOL), &queryPool_) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create query pool");
+    }
+}
+
+QueryPool::~QueryPool() {
+    Cleanup();
+}
+
+QueryPool::QueryPool(QueryPool&& other) noexcept
+    : queryPool_(other.queryPool_),
+    device_(other.device_),
+    type_(other.type_),
+    queryCount_(other.queryCount_),
+    pipelineStatistics_(other.pipelineStatistics_),
+    hostReset_(other.hostReset_)
+{
+    other.queryPool_ = VK_NULL_HANDLE;
+    other.device_ = VK_NULL_HANDLE;
+    other.queryCount_ = 0;
+}
+
+QueryPool& QueryPool::operator=(QueryPool&& other) noexcept {
+    if (this != &other) {
+        Cleanup();
+        queryPool_ = other.queryPool_;
+        device_ = other.device_;
+        type_ = other.type_;
+        queryCount_ = other.queryCount_;
+        pipelineStatistics_ = other.pipelineStatistics_;
+        hostReset_ = other.hostReset_;
+        other.queryPool_ = VK_NULL_HANDLE;
+        other.device_ = VK_NULL_HANDLE;
+        other.queryCount_ = 0;
+    }
+    return *this;
+}
+
+uint32_t QueryPool::GetValuesPerQuery() const
+{
+    return type_ == VK_QUERY_TYPE_PIPELINE_STATISTICS ? static_cast<uint32_t>(std::popcount(pipelineStatistics_)) : 1;
+}
+
+VkDeviceSize QueryPool::GetResultStride(VkQueryResultFlags flags) const
+{
+    const VkDeviceSize value_size = (flags & VK_QUERY_RESULT_64_BIT) != 0 ? sizeof(uint64_t) : sizeof(uint32_t);
+    const uint32_t values = GetValuesPerQuery() + ((flags & VK_QUERY_RESULT_WITH_AVAILABILITY_BIT) != 0 ? 1 : 0);
+    return value_size * values;
+}
+
+uint64_t QueryPool::GetStatistic(std::span<const uint64_t> query_values, VkQueryPipelineStatisticFlagBits counter) const
+{
+    if ((pipelineStatistics_ & counter) == 0) {
+        throw std::invalid_argument("Counter is not collected by this query pool");
+    }
+    // Values are ordered by counter bit, so the index is the number of lower bits collected
+    const auto index = static_cast<size_t>(std::popcount(pipelineStatistics_ & (static_cast<VkQueryPipelineStatisticFlags>(counter) - 1)));
+    if (index >= query_values.size()) {
+        throw std::out_of_range("Query values do not cover this counter");
+    }
+    return query_values[index];
+}
+
+void QueryPool::Reset(uint32_t first_query, uint32_t query_count) const
+{
+    if (!hostReset_) {
+        throw std::runtime_error("Host query reset is not enabled on this device");
+    }
+    if (first_query + query_count > queryCount_) {
+        throw std::out_of_range("QueryPool reset range out of range");
+    }
+    if (query_count > 0) {
+        vkResetQueryPool(device_, queryPool_, first_query, query_count);
+    }
+}
+
+VkResult QueryPool::GetResults(uint32_t first_query,
+                               uint32_t query_count,
+                               std::span<uint64_t> results,
+                               VkQueryResultFlags flags) const
+{
+    if (first_query + query_count > queryCount_) {
+        throw std::out_of_range("QueryPool result range out of range");
+    }
+    const uint32_t values = GetValuesPerQuery() + ((flags & VK_QUERY_RESULT_WITH_AVAILABILITY_BIT) != 0 ? 1 : 0);
+    if (results.size() < static_cast<size_t>(query_count) * values) {
+        throw std::invalid_argument("QueryPool result span is too small");
+    }
+    if (query_count == 0) {
+        return VK_SUCCESS;
+    }
+    const VkDeviceSize stride = sizeof(uint64_t) * values;
+    return vkGetQueryPoolResults(device_, queryPool_, first_query, query_count,
+                                 static_cast<size_t>(stride * query_count), results.data(), stride,
+                                 flags | VK_QUERY_RESULT_64_BIT);
+}
+
+void QueryPool::Cleanup()
+{
+    if (queryPool_ != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(device_, queryPool_, Utils::HostAllocator::For(VK_OBJECT_TYPE_QUERY_POOL));
+        queryPool_ = VK_NULL_HANDLE;
+    }
+    device_ = VK_NULL_HANDLE;
+}
+
+} // namespace VulkanEngine::RAII
@@ -0,0 +1,91 @@
+#ifndef VULKAN_RAII_RENDERING_QUERY_POOL_HPP
+#define VULKAN_RAII_RENDERING_QUERY_POOL_HPP
+
+#include <volk.h>
+#include <cstdint>
+#include <span>
+
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+
+// Block of GPU queries of one type (timestamps, occlusion, pipeline statistics).
+// Queries are written with CommandBuffer::WriteTimestamp / BeginQuery / EndQuery and
+// must be reset before each use, from the host (Reset, needs
+// Device::SupportsHostQueryReset()) or in a command buffer (CommandBuffer::ResetQueryPool).
+// Results are read on the host (GetResults) or copied into a buffer on the GPU
+// (CommandBuffer::CopyQueryPoolResults), e.g. occlusion counts for conditional rendering.
+class QueryPool {
+public:
+    // Invocation counters for overdraw and dispatch checks
+    static constexpr VkQueryPipelineStatisticFlags INVOCATION_STATISTICS =
+        VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+
+    // Constructor. pipeline_statistics selects the counters of a PIPELINE_STATISTICS pool,
+    // which needs the pipelineStatisticsQuery device feature. Occlusion queries begun
+    // with VK_QUERY_CONTROL_PRECISE_BIT need occlusionQueryPrecise
+    QueryPool(const Device& device,
+              VkQueryType type,
+              uint32_t query_count,
+              VkQueryPipelineStatisticFlags pipeline_statistics = 0);
+
+    // Destructor
+    ~QueryPool();
+
+    // Move constructor and assignment
+    QueryPool(QueryPool&& other) noexcept;
+    QueryPool& operator=(QueryPool&& other) noexcept;
+
+    // Delete copy constructor and assignment. this ensures unique ownership of the VkQueryPool by only allowing moving.
+    QueryPool(const QueryPool&) = delete;
+    QueryPool& operator=(const QueryPool&) = delete;
+
+    [[nodiscard]] VkQueryPool GetHandle() const { return queryPool_; }
+
+    // Implicit conversion to VkQueryPool
+    operator VkQueryPool() const { return queryPool_; }
+
+    [[nodiscard]] bool IsValid() const { return queryPool_ != VK_NULL_HANDLE; }
+
+    [[nodiscard]] VkQueryType GetType() const { return type_; }
+    [[nodiscard]] uint32_t GetQueryCount() const { return queryCount_; }
+    [[nodiscard]] VkQueryPipelineStatisticFlags GetPipelineStatistics() const { return pipelineStatistics_; }
+
+    // 64-bit values one query produces (counter count for pipeline statistics, otherwise 1)
+    [[nodiscard]] uint32_t GetValuesPerQuery() const;
+
+    // Bytes per query of results written with flags (64- or 32-bit values, plus availability)
+    [[nodiscard]] VkDeviceSize GetResultStride(VkQueryResultFlags flags) const;
+
+    // One counter out of a query's pipeline statistics values (in counter bit order)
+    [[nodiscard]] uint64_t GetStatistic(std::span<const uint64_t> query_values, VkQueryPipelineStatisticFlagBits counter) const;
+
+    // Reset queries from the host; none of them may be in use by pending GPU work
+    void Reset(uint32_t first_query, uint32_t query_count) const;
+    void Reset() const { Reset(0, queryCount_); }
+
+    // Copy 64-bit results into results without waiting unless flags asks for it. With
+    // VK_QUERY_RESULT_WITH_AVAILABILITY_BIT every query gets one extra trailing value,
+    // non-zero once available; otherwise VK_NOT_READY reports unavailable queries
+    [[nodiscard]] VkResult GetResults(uint32_t first_query,
+                                      uint32_t query_count,
+                                      std::span<uint64_t> results,
+                                      VkQueryResultFlags flags = 0) const;
+
+private:
+    VkQueryPool queryPool_{VK_NULL_HANDLE};
+    VkDevice device_{VK_NULL_HANDLE}; // Reference to device
+    VkQueryType type_{VK_QUERY_TYPE_TIMESTAMP};
+    uint32_t queryCount_{0};
+    VkQueryPipelineStatisticFlags pipelineStatistics_{0};
+    bool hostReset_{false};
+
+    void Cleanup();
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RENDERING_QUERY_POOL_HPP
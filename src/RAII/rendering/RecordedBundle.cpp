@@ -0,0 +1,139 @@
+#include "RecordedBundle.hpp"
+
+#include "CommandBuffer.hpp"
+#include "CommandPool.hpp"
+#include "Pipeline.hpp"
+#include "Renderer.hpp"
+#include "../core/Device.hpp"
+#include "../resources/Buffer.hpp"
+#include "../utils/HashUtils.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+namespace VulkanEngine::RAII {
+
+RecordedBundle::RecordedBundle(Renderer& renderer, Mode mode, RecordCallback record)
+    : renderer_(&renderer),
+    mode_(mode),
+    record_(std::move(record))
+{
+    if (!record_) {
+        throw std::invalid_argument("RecordedBundle needs a record callback");
+    }
+    const Device& device = renderer.GetDevice();
+    // Buffers are re-recorded one at a time
+    commandPool_ = std::make_unique<CommandPool>(device,
+                                                 device.GetQueueFamilyIndices().graphicsFamily_.value(),
+                                                 VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+    slots_.resize(mode == Mode::PER_FRAME ? renderer.GetMaxFramesInFlight() : 1);
+}
+
+RecordedBundle::~RecordedBundle()
+{
+    // Command buffers go before the pool they came from
+    slots_.clear();
+    retired_.clear();
+    commandPool_.reset();
+}
+
+void RecordedBundle::DependOn(const Pipeline& pipeline)
+{
+    pipelines_.push_back(&pipeline);
+}
+
+void RecordedBundle::DependOn(const Buffer& buffer)
+{
+    buffers_.push_back(&buffer);
+}
+
+void RecordedBundle::ClearDependencies()
+{
+    pipelines_.clear();
+    buffers_.clear();
+}
+
+void RecordedBundle::Invalidate()
+{
+    invalidation_++;
+}
+
+void RecordedBundle::Execute()
+{
+    CommandBuffer& primary = renderer_->GetCurrentCommandBuffer();
+    Slot& slot = slots_[mode_ == Mode::PER_FRAME ? renderer_->GetCurrentFrameIndex() : 0];
+
+    RecordKey key = MakeKey();
+    if (!slot.recorded || slot.key != key) {
+        if (mode_ == Mode::SIMULTANEOUS_USE && slot.buffer) {
+            // Earlier frames may still be executing it; frame N retires before frame N + frames in flight begins
+            const uint64_t frame = renderer_->GetTotalFrameCount();
+            retired_.push_back({std::move(slot.buffer), frame + renderer_->GetMaxFramesInFlight() - 1});
+        }
+        if (!slot.buffer) {
+            slot.buffer = AcquireBuffer();
+        }
+
+        // PER_FRAME copies are only executed by their own frame, which BeginFrame waited for
+        Renderer::SecondaryInheritance inheritance;
+        renderer_->FillSecondaryInheritance(inheritance, false);
+        VkCommandBufferUsageFlags usage = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        if (mode_ == Mode::SIMULTANEOUS_USE) {
+            usage |= VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+        }
+        slot.buffer->Begin(usage, &inheritance.info);
+        record_(*slot.buffer);
+        slot.buffer->End();
+        slot.key = std::move(key);
+        slot.recorded = true;
+        recordCount_++;
+    }
+
+    const VkCommandBuffer handle = slot.buffer->GetHandle();
+    primary.ExecuteCommands(std::span<const VkCommandBuffer>(&handle, 1));
+}
+
+RecordedBundle::RecordKey RecordedBundle::MakeKey() const
+{
+    Renderer::SecondaryInheritance inheritance;
+    renderer_->FillSecondaryInheritance(inheritance, false);
+
+    RecordKey key;
+    key.renderPass = inheritance.info.renderPass;
+    key.colorFormat = inheritance.colorFormat;
+    key.depthFormat = inheritance.rendering.depthAttachmentFormat;
+    key.swapchainGeneration = renderer_->GetSwapchainGeneration();
+    key.invalidation = invalidation_;
+    key.dependencyHash = Utils::FNV1A_OFFSET_BASIS;
+    for (const Pipeline* pipeline : pipelines_) {
+        const uint64_t handle = Utils::HandleToUint64(pipeline->GetHandle());
+        key.dependencyHash = Utils::HashFnv1a(&handle, 1, key.dependencyHash);
+    }
+    for (const Buffer* buffer : buffers_) {
+        const uint64_t handle = Utils::HandleToUint64(buffer->GetHandle());
+        key.dependencyHash = Utils::HashFnv1a(&handle, 1, key.dependencyHash);
+    }
+    return key;
+}
+
+std::unique_ptr<CommandBuffer> RecordedBundle::AcquireBuffer()
+{
+    const uint64_t frame = renderer_->GetTotalFrameCount();
+    auto reusable = std::find_if(retired_.begin(), retired_.end(), [frame](const RetiredBuffer& retired) {
+        return retired.reusableAt <= frame;
+    });
+    if (reusable != retired_.end()) {
+        std::unique_ptr<CommandBuffer> buffer = std::move(reusable->buffer);
+        retired_.erase(reusable);
+        return buffer;
+    }
+    return std::make_unique<CommandBuffer>(*commandPool_, VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+}
+
+} // namespace VulkanEngine::RAII
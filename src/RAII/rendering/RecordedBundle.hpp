@@ -0,0 +1,109 @@
+#ifndef VULKAN_RAII_RENDERING_RECORDED_BUNDLE_HPP
+#define VULKAN_RAII_RENDERING_RECORDED_BUNDLE_HPP
+
+#include <volk.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace VulkanEngine::RAII {
+
+class CommandPool; // Forward declaration
+class CommandBuffer; // Forward declaration
+class Renderer; // Forward declaration
+class Pipeline; // Forward declaration
+class Buffer; // Forward declaration
+
+// Secondary command buffer recorded once and replayed every frame with
+// vkCmdExecuteCommands, for content that records the same commands each frame
+// (static geometry, UI backgrounds). It is re-recorded automatically when the
+// renderer's swapchain is recreated, the render pass or attachment formats it
+// continues change, or a declared dependency (pipeline, buffer) gets a new handle;
+// Invalidate() covers anything else the record callback reads.
+//
+// SIMULTANEOUS_USE keeps one buffer executed by every frame in flight; a stale one is
+// replaced by a fresh buffer and reused once the frames that executed it retired.
+// PER_FRAME keeps a copy per frame in flight, re-recorded when its frame comes round,
+// for drivers where SIMULTANEOUS_USE costs replay speed.
+class RecordedBundle {
+public:
+    enum class Mode {
+        SIMULTANEOUS_USE,
+        PER_FRAME
+    };
+
+    using RecordCallback = std::function<void(CommandBuffer& command_buffer)>;
+
+    // Dynamic rendering bundles inherit the depth format given to Renderer::SetRecordingThreadCount
+    RecordedBundle(Renderer& renderer, Mode mode, RecordCallback record);
+
+    // Destructor (the frames that executed the bundle must have retired)
+    ~RecordedBundle();
+
+    // Delete copy and move. executed command buffers reference the bundle's pool.
+    RecordedBundle(const RecordedBundle&) = delete;
+    RecordedBundle& operator=(const RecordedBundle&) = delete;
+    RecordedBundle(RecordedBundle&&) = delete;
+    RecordedBundle& operator=(RecordedBundle&&) = delete;
+
+    // Re-record when these objects' handles change (e.g. pipeline rebuilds, defragmentation moves)
+    void DependOn(const Pipeline& pipeline);
+    void DependOn(const Buffer& buffer);
+    void ClearDependencies();
+
+    // Force a re-record on the next Execute()
+    void Invalidate();
+
+    // Execute into the renderer's current command buffer, re-recording first when
+    // stale. Call inside the swapchain render pass, begun with secondary contents
+    // (SECONDARY_COMMAND_BUFFERS, or the matching rendering flag for dynamic rendering)
+    void Execute();
+
+    [[nodiscard]] Mode GetMode() const { return mode_; }
+    [[nodiscard]] uint64_t GetRecordCount() const { return recordCount_; }
+
+private:
+    // Everything a recording was made against
+    struct RecordKey {
+        VkRenderPass renderPass{VK_NULL_HANDLE};
+        VkFormat colorFormat{VK_FORMAT_UNDEFINED};
+        VkFormat depthFormat{VK_FORMAT_UNDEFINED};
+        uint64_t swapchainGeneration{0};
+        uint64_t invalidation{0};
+        uint64_t dependencyHash{0}; // Handles of the declared dependencies, in order
+
+        bool operator==(const RecordKey& other) const = default;
+    };
+
+    struct Slot {
+        std::unique_ptr<CommandBuffer> buffer;
+        RecordKey key;
+        bool recorded{false};
+    };
+
+    // Replaced SIMULTANEOUS_USE buffer, reusable once reusableAt frames have been submitted
+    struct RetiredBuffer {
+        std::unique_ptr<CommandBuffer> buffer;
+        uint64_t reusableAt{0};
+    };
+
+    Renderer* renderer_{nullptr};
+    Mode mode_{Mode::SIMULTANEOUS_USE};
+    RecordCallback record_;
+    std::unique_ptr<CommandPool> commandPool_;
+    std::vector<Slot> slots_;
+    std::vector<RetiredBuffer> retired_;
+    std::vector<const Pipeline*> pipelines_;
+    std::vector<const Buffer*> buffers_;
+    uint64_t invalidation_{0};
+    uint64_t recordCount_{0};
+
+    RecordKey MakeKey() const;
+    std::unique_ptr<CommandBuffer> AcquireBuffer();
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RENDERING_RECORDED_BUNDLE_HPP
@@ -0,0 +1,610 @@
+#include "RenderGraph.hpp"
+
+#include "CommandBuffer.hpp"
+#include "../core/Device.hpp"
+#include "../resources/Buffer.hpp"
+#include "../resources/Image.hpp"
+#include "../resources/VmaAllocator.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+namespace VulkanEngine::RAII {
+
+namespace {
+bool ReadsContents(VkAccessFlags2KHR access)
+{
+    constexpr VkAccessFlags2KHR read_access = VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT_KHR |
+                                              VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT_KHR |
+                                              VK_ACCESS_2_INPUT_ATTACHMENT_READ_BIT_KHR |
+                                              VK_ACCESS_2_SHADER_READ_BIT_KHR |
+                                              VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR |
+                                              VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR |
+                                              VK_ACCESS_2_TRANSFER_READ_BIT_KHR |
+                                              VK_ACCESS_2_MEMORY_READ_BIT_KHR;
+    return (access & read_access) != 0;
+}
+} // namespace
+
+RenderGraph::RenderGraph(const Device& device, const VmaAllocator& allocator)
+    : device_(&device),
+    allocator_(allocator.GetHandle())
+{
+    if (device == VK_NULL_HANDLE || allocator_ == VK_NULL_HANDLE) {
+        throw std::invalid_argument("RenderGraph requires a valid device and allocator");
+    }
+}
+
+RenderGraph::~RenderGraph()
+{
+    ReleaseTransients();
+}
+
+RenderGraph::ResourceHandle RenderGraph::CreateImage(const char* name, const ImageDesc& desc)
+{
+    if (desc.width == 0 || desc.height == 0 || desc.format == VK_FORMAT_UNDEFINED || desc.usage == 0) {
+        throw std::invalid_argument("RenderGraph transient images need an extent, format and usage");
+    }
+    Resource resource;
+    resource.name = name ? name : "";
+    resource.desc = desc;
+    resources_.push_back(std::move(resource));
+    compiled_ = false;
+    return static_cast<ResourceHandle>(resources_.size() - 1);
+}
+
+RenderGraph::ResourceHandle RenderGraph::ImportImage(const char* name, Image& image)
+{
+    Resource resource;
+    resource.name = name ? name : "";
+    resource.imported = true;
+    resource.image = &image;
+    resources_.push_back(std::move(resource));
+    compiled_ = false;
+    return static_cast<ResourceHandle>(resources_.size() - 1);
+}
+
+RenderGraph::ResourceHandle RenderGraph::ImportBuffer(const char* name, Buffer& buffer)
+{
+    Resource resource;
+    resource.name = name ? name : "";
+    resource.imported = true;
+    resource.buffer = true;
+    resource.bufferRef = &buffer;
+    resources_.push_back(std::move(resource));
+    compiled_ = false;
+    return static_cast<ResourceHandle>(resources_.size() - 1);
+}
+
+void RenderGraph::SetImportedImage(ResourceHandle resource, Image& image)
+{
+    if (resource >= resources_.size() || !resources_[resource].imported || resources_[resource].buffer) {
+        throw std::invalid_argument("RenderGraph resource is not an imported image");
+    }
+    resources_[resource].image = &image;
+}
+
+void RenderGraph::SetImportedBuffer(ResourceHandle resource, Buffer& buffer)
+{
+    if (resource >= resources_.size() || !resources_[resource].buffer) {
+        throw std::invalid_argument("RenderGraph resource is not an imported buffer");
+    }
+    resources_[resource].bufferRef = &buffer;
+}
+
+RenderGraph::PassHandle RenderGraph::AddPass(const char* name, PassQueue queue, ExecuteCallback execute)
+{
+    Pass pass;
+    pass.name = name ? name : "";
+    pass.queue = queue;
+    pass.execute = std::move(execute);
+    passes_.push_back(std::move(pass));
+    compiled_ = false;
+    return static_cast<PassHandle>(passes_.size() - 1);
+}
+
+void RenderGraph::Read(PassHandle pass, ResourceHandle resource, const ResourceAccess& access)
+{
+    if (pass >= passes_.size() || resource >= resources_.size()) {
+        throw std::invalid_argument("RenderGraph::Read called with an unknown pass or resource");
+    }
+    passes_[pass].accesses.push_back(PassAccess{resource, access, false});
+    compiled_ = false;
+}
+
+void RenderGraph::Write(PassHandle pass, ResourceHandle resource, const ResourceAccess& access)
+{
+    if (pass >= passes_.size() || resource >= resources_.size()) {
+        throw std::invalid_argument("RenderGraph::Write called with an unknown pass or resource");
+    }
+    passes_[pass].accesses.push_back(PassAccess{resource, access, true});
+    compiled_ = false;
+}
+
+void RenderGraph::SetSideEffects(PassHandle pass)
+{
+    if (pass >= passes_.size()) {
+        throw std::invalid_argument("RenderGraph::SetSideEffects called with an unknown pass");
+    }
+    passes_[pass].sideEffects = true;
+    compiled_ = false;
+}
+
+void RenderGraph::Compile()
+{
+    ReleaseTransients();
+    order_.clear();
+    asyncPassCount_ = 0;
+    asyncWaitStages_ = VK_PIPELINE_STAGE_2_NONE_KHR;
+    for (Pass& pass : passes_) {
+        pass.culled = false;
+        pass.async = false;
+    }
+    for (Resource& resource : resources_) {
+        resource.firstUse = NONE;
+        resource.lastUse = NONE;
+        resource.block = NONE;
+        resource.predecessor = NONE;
+        resource.asyncTouched = false;
+        resource.graphicsTouched = false;
+    }
+
+    // Declaration order is the reference order: a read depends on the last write
+    // before it, a write on that write and every read since
+    std::vector<std::vector<PassHandle>> dependencies(passes_.size());
+    std::vector<std::vector<PassHandle>> producers(passes_.size());
+    std::vector<PassHandle> last_writer(resources_.size(), NONE);
+    std::vector<std::vector<PassHandle>> readers(resources_.size());
+    for (PassHandle p = 0; p < passes_.size(); ++p) {
+        for (const PassAccess& access : passes_[p].accesses) {
+            const ResourceHandle r = access.resource;
+            if (last_writer[r] != NONE && last_writer[r] != p) {
+                dependencies[p].push_back(last_writer[r]);
+                producers[p].push_back(last_writer[r]);
+            }
+            if (access.write) {
+                for (PassHandle reader : readers[r]) {
+                    if (reader != p) {
+                        dependencies[p].push_back(reader);
+                    }
+                }
+            }
+        }
+        for (const PassAccess& access : passes_[p].accesses) {
+            if (access.write) {
+                last_writer[access.resource] = p;
+                readers[access.resource].clear();
+            }
+        }
+        for (const PassAccess& access : passes_[p].accesses) {
+            if (!access.write && last_writer[access.resource] != p) {
+                readers[access.resource].push_back(p);
+            }
+        }
+        std::sort(dependencies[p].begin(), dependencies[p].end());
+        dependencies[p].erase(std::unique(dependencies[p].begin(), dependencies[p].end()), dependencies[p].end());
+    }
+
+    CullPasses(producers);
+
+    // An async pass may only depend on other async passes, so it can start as soon as the frame does
+    for (PassHandle p = 0; p < passes_.size(); ++p) {
+        Pass& pass = passes_[p];
+        if (pass.culled || pass.queue != PassQueue::ASYNC_COMPUTE) {
+            continue;
+        }
+        pass.async = std::all_of(dependencies[p].begin(), dependencies[p].end(), [this](PassHandle dependency) {
+            return passes_[dependency].culled || passes_[dependency].async;
+        });
+        asyncPassCount_ += pass.async ? 1 : 0;
+    }
+
+    OrderPasses(dependencies);
+
+    for (uint32_t position = 0; position < order_.size(); ++position) {
+        const Pass& pass = passes_[order_[position]];
+        for (const PassAccess& access : pass.accesses) {
+            Resource& resource = resources_[access.resource];
+            resource.firstUse = std::min(resource.firstUse, position);
+            resource.lastUse = position;
+            if (pass.async) {
+                resource.asyncTouched = true;
+            } else {
+                resource.graphicsTouched = true;
+            }
+        }
+    }
+    for (const PassHandle p : order_) {
+        if (passes_[p].async) {
+            continue;
+        }
+        for (const PassAccess& access : passes_[p].accesses) {
+            if (resources_[access.resource].asyncTouched) {
+                asyncWaitStages_ |= access.access.stages;
+            }
+        }
+    }
+
+    PlanAttachmentOps();
+    AllocateTransients();
+    compiled_ = true;
+}
+
+void RenderGraph::PlanAttachmentOps()
+{
+    // VK_KHR_dynamic_rendering brings VK_ATTACHMENT_STORE_OP_NONE_KHR
+    const bool store_op_none = device_->SupportsDynamicRendering();
+
+    // Positions in order_ touching each image
+    std::vector<std::vector<uint32_t>> uses(resources_.size());
+    for (uint32_t position = 0; position < order_.size(); ++position) {
+        for (const PassAccess& access : passes_[order_[position]].accesses) {
+            std::vector<uint32_t>& positions = uses[access.resource];
+            if (!resources_[access.resource].buffer && (positions.empty() || positions.back() != position)) {
+                positions.push_back(position);
+            }
+        }
+    }
+    auto reads_at = [this](uint32_t position, ResourceHandle resource) {
+        const std::vector<PassAccess>& accesses = passes_[order_[position]].accesses;
+        return std::any_of(accesses.begin(), accesses.end(), [resource](const PassAccess& access) {
+            return access.resource == resource && (!access.write || ReadsContents(access.access.access));
+        });
+    };
+
+    std::vector<bool> written(resources_.size(), false);
+    for (Pass& pass : passes_) {
+        pass.attachmentOps.clear();
+    }
+    for (uint32_t position = 0; position < order_.size(); ++position) {
+        Pass& pass = passes_[order_[position]];
+        for (const PassAccess& access : pass.accesses) {
+            const ResourceHandle r = access.resource;
+            const bool planned = std::any_of(pass.attachmentOps.begin(), pass.attachmentOps.end(),
+                                             [r](const auto& entry) { return entry.first == r; });
+            if (resources_[r].buffer || planned) {
+                continue;
+            }
+            const bool writes = std::any_of(pass.accesses.begin(), pass.accesses.end(), [r](const PassAccess& other) {
+                return other.resource == r && other.write;
+            });
+            const auto next = std::upper_bound(uses[r].begin(), uses[r].end(), position);
+            const bool needed_later = next != uses[r].end() ? reads_at(*next, r) : resources_[r].imported;
+
+            AttachmentOps ops;
+            ops.loadOp = RenderPassPlanner::ChooseLoadOp(reads_at(position, r), resources_[r].imported || written[r]);
+            ops.storeOp = RenderPassPlanner::ChooseStoreOp(writes, needed_later, store_op_none);
+            pass.attachmentOps.emplace_back(r, ops);
+        }
+        for (const PassAccess& access : pass.accesses) {
+            written[access.resource] = written[access.resource] || access.write;
+        }
+    }
+}
+
+void RenderGraph::CullPasses(const std::vector<std::vector<PassHandle>>& producers)
+{
+    std::vector<bool> needed(passes_.size(), false);
+    std::vector<PassHandle> pending;
+    for (PassHandle p = 0; p < passes_.size(); ++p) {
+        const Pass& pass = passes_[p];
+        const bool writes_import = std::any_of(pass.accesses.begin(), pass.accesses.end(), [this](const PassAccess& access) {
+            return access.write && resources_[access.resource].imported;
+        });
+        if (pass.sideEffects || writes_import) {
+            needed[p] = true;
+            pending.push_back(p);
+        }
+    }
+    while (!pending.empty()) {
+        const PassHandle p = pending.back();
+        pending.pop_back();
+        for (PassHandle producer : producers[p]) {
+            if (!needed[producer]) {
+                needed[producer] = true;
+                pending.push_back(producer);
+            }
+        }
+    }
+    for (PassHandle p = 0; p < passes_.size(); ++p) {
+        passes_[p].culled = !needed[p];
+    }
+}
+
+void RenderGraph::OrderPasses(const std::vector<std::vector<PassHandle>>& dependencies)
+{
+    std::vector<uint32_t> remaining(passes_.size(), 0);
+    std::vector<std::vector<PassHandle>> dependents(passes_.size());
+    for (PassHandle p = 0; p < passes_.size(); ++p) {
+        if (passes_[p].culled) {
+            continue;
+        }
+        for (PassHandle dependency : dependencies[p]) {
+            if (!passes_[dependency].culled) {
+                ++remaining[p];
+                dependents[dependency].push_back(p);
+            }
+        }
+    }
+
+    // Ready async passes go first so the compute queue gets its work as early as
+    // possible; otherwise declaration order is kept
+    std::set<std::pair<uint32_t, PassHandle>> ready;
+    for (PassHandle p = 0; p < passes_.size(); ++p) {
+        if (!passes_[p].culled && remaining[p] == 0) {
+            ready.emplace(passes_[p].async ? 0u : 1u, p);
+        }
+    }
+    while (!ready.empty()) {
+        const PassHandle p = ready.begin()->second;
+        ready.erase(ready.begin());
+        order_.push_back(p);
+        for (PassHandle dependent : dependents[p]) {
+            if (--remaining[dependent] == 0) {
+                ready.emplace(passes_[dependent].async ? 0u : 1u, dependent);
+            }
+        }
+    }
+}
+
+void RenderGraph::AllocateTransients()
+{
+    const QueueFamilyIndices& families = device_->GetQueueFamilyIndices();
+    const uint32_t graphics_family = families.graphicsFamily_.value_or(0);
+    const uint32_t compute_family = families.computeFamily_.value_or(graphics_family);
+    const uint32_t shared_families[] = {graphics_family, compute_family};
+
+    std::vector<std::pair<VkMemoryRequirements, ResourceHandle>> transients;
+    for (ResourceHandle r = 0; r < resources_.size(); ++r) {
+        Resource& resource = resources_[r];
+        if (resource.imported || resource.firstUse == NONE) {
+            continue;
+        }
+        VkImageCreateInfo image_info{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+        image_info.imageType = VK_IMAGE_TYPE_2D;
+        image_info.extent = {resource.desc.width, resource.desc.height, 1};
+        image_info.mipLevels = resource.desc.mipLevels;
+        image_info.arrayLayers = resource.desc.arrayLayers;
+        image_info.format = resource.desc.format;
+        image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+        image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        image_info.usage = resource.desc.usage;
+        image_info.samples = resource.desc.samples;
+        image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (resource.asyncTouched && resource.graphicsTouched && graphics_family != compute_family) {
+            image_info.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            image_info.queueFamilyIndexCount = 2;
+            image_info.pQueueFamilyIndices = shared_families;
+        }
+        resource.transient = std::make_unique<Image>(*device_, image_info);
+        resource.image = resource.transient.get();
+        if (!resource.name.empty()) {
+            resource.transient->SetDebugName(resource.name.c_str());
+        }
+        transients.emplace_back(resource.transient->GetMemoryRequirements(), r);
+    }
+
+    // Largest first, each into the first block whose members all live at other times
+    std::stable_sort(transients.begin(), transients.end(), [](const auto& a, const auto& b) {
+        return a.first.size > b.first.size;
+    });
+    for (const auto& [requirements, r] : transients) {
+        Resource& resource = resources_[r];
+        unaliasedMemorySize_ += requirements.size;
+
+        const bool lazy = (resource.desc.usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT) != 0;
+        uint32_t block_index = NONE;
+        for (uint32_t b = 0; b < blocks_.size() && !resource.asyncTouched; ++b) {
+            const MemoryBlock& block = blocks_[b];
+            if (block.async || block.lazy != lazy || (block.requirements.memoryTypeBits & requirements.memoryTypeBits) == 0) {
+                continue;
+            }
+            const bool disjoint = std::all_of(block.members.begin(), block.members.end(), [&](ResourceHandle member) {
+                return resources_[member].lastUse < resource.firstUse || resource.lastUse < resources_[member].firstUse;
+            });
+            if (disjoint) {
+                block_index = b;
+                break;
+            }
+        }
+        if (block_index == NONE) {
+            MemoryBlock block;
+            block.requirements = requirements;
+            block.async = resource.asyncTouched;
+            block.lazy = lazy;
+            blocks_.push_back(std::move(block));
+            block_index = static_cast<uint32_t>(blocks_.size() - 1);
+        } else {
+            VkMemoryRequirements& merged = blocks_[block_index].requirements;
+            merged.size = std::max(merged.size, requirements.size);
+            merged.alignment = std::max(merged.alignment, requirements.alignment);
+            merged.memoryTypeBits &= requirements.memoryTypeBits;
+        }
+        blocks_[block_index].members.push_back(r);
+        resource.block = block_index;
+    }
+
+    for (MemoryBlock& block : blocks_) {
+        VmaAllocationCreateInfo alloc_info{};
+        alloc_info.preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        if (block.lazy) {
+            // Preferred rather than required, so devices without such a type fall back to device local
+            alloc_info.preferredFlags |= VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+        }
+        if (vmaAllocateMemory(allocator_, &block.requirements, &alloc_info, &block.allocation, nullptr) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate render graph transient memory");
+        }
+        transientMemorySize_ += block.requirements.size;
+
+        std::sort(block.members.begin(), block.members.end(), [this](ResourceHandle a, ResourceHandle b) {
+            return resources_[a].firstUse < resources_[b].firstUse;
+        });
+        for (size_t i = 0; i < block.members.size(); ++i) {
+            Resource& member = resources_[block.members[i]];
+            if (vmaBindImageMemory(allocator_, block.allocation, member.image->GetHandle()) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to bind render graph transient image");
+            }
+            // The first occupant of a frame follows the last one of the previous frame
+            member.predecessor = block.members[i == 0 ? block.members.size() - 1 : i - 1];
+        }
+    }
+}
+
+void RenderGraph::ReleaseTransients()
+{
+    // Images go before the memory they are bound to
+    for (Resource& resource : resources_) {
+        if (resource.transient) {
+            resource.transient.reset();
+            resource.image = nullptr;
+        }
+    }
+    for (MemoryBlock& block : blocks_) {
+        if (block.allocation != VK_NULL_HANDLE) {
+            vmaFreeMemory(allocator_, block.allocation);
+        }
+    }
+    blocks_.clear();
+    transientMemorySize_ = 0;
+    unaliasedMemorySize_ = 0;
+    compiled_ = false;
+}
+
+void RenderGraph::Execute(CommandBuffer& graphics, CommandBuffer* async_compute)
+{
+    if (!compiled_) {
+        throw std::logic_error("RenderGraph::Execute called before Compile");
+    }
+
+    const bool use_async = async_compute != nullptr && asyncPassCount_ > 0;
+    if (use_async) {
+        for (uint32_t position = 0; position < order_.size(); ++position) {
+            const Pass& pass = passes_[order_[position]];
+            if (pass.async) {
+                RecordPass(pass, position, *async_compute);
+            }
+        }
+
+        // The graphics submission waits for the compute one at asyncWaitStages_, which
+        // orders every async access before those stages; tracking restarts from there
+        for (Resource& resource : resources_) {
+            if (!resource.asyncTouched || !resource.graphicsTouched) {
+                continue;
+            }
+            if (resource.buffer) {
+                ResourceState state{};
+                state.writeStages = asyncWaitStages_;
+                resource.bufferRef->SetTrackedState(state);
+                continue;
+            }
+            Image& image = *resource.image;
+            for (uint32_t layer = 0; layer < image.GetArrayLayers(); ++layer) {
+                for (uint32_t mip = 0; mip < image.GetMipLevels(); ++mip) {
+                    ResourceState state{};
+                    state.layout = image.GetTrackedState(mip, layer).layout;
+                    state.writeStages = asyncWaitStages_;
+                    image.SetTrackedState(state, mip, 1, layer, 1);
+                }
+            }
+        }
+    }
+
+    for (uint32_t position = 0; position < order_.size(); ++position) {
+        const Pass& pass = passes_[order_[position]];
+        if (!use_async || !pass.async) {
+            RecordPass(pass, position, graphics);
+        }
+    }
+}
+
+void RenderGraph::RecordPass(const Pass& pass, uint32_t position, CommandBuffer& command_buffer)
+{
+    for (size_t i = 0; i < pass.accesses.size(); ++i) {
+        const PassAccess& access = pass.accesses[i];
+        Resource& resource = resources_[access.resource];
+        if (resource.buffer) {
+            command_buffer.RequireBuffer(*resource.bufferRef, access.access.stages, access.access.access);
+            continue;
+        }
+        const bool first_in_pass = std::none_of(pass.accesses.begin(), pass.accesses.begin() + static_cast<std::ptrdiff_t>(i),
+                                                [&](const PassAccess& earlier) { return earlier.resource == access.resource; });
+        if (!resource.imported && resource.firstUse == position && first_in_pass) {
+            SeedTransient(resource);
+        }
+        command_buffer.RequireImage(*resource.image, access.access);
+    }
+    command_buffer.FlushBarriers();
+    if (pass.execute) {
+        const CommandBuffer::LabelScope label(command_buffer, pass.name.c_str());
+        pass.execute(command_buffer);
+    }
+}
+
+void RenderGraph::SeedTransient(Resource& resource)
+{
+    // Contents are discarded every frame; the first use waits for whatever last used the memory
+    const Image& previous = *resources_[resource.predecessor].image;
+    ResourceState state{};
+    for (uint32_t layer = 0; layer < previous.GetArrayLayers(); ++layer) {
+        for (uint32_t mip = 0; mip < previous.GetMipLevels(); ++mip) {
+            const ResourceState& last = previous.GetTrackedState(mip, layer);
+            state.writeStages |= last.writeStages | last.readStages;
+            state.writeAccess |= last.writeAccess;
+        }
+    }
+    resource.image->SetTrackedState(state);
+}
+
+void RenderGraph::Reset()
+{
+    ReleaseTransients();
+    passes_.clear();
+    resources_.clear();
+    order_.clear();
+    asyncPassCount_ = 0;
+    asyncWaitStages_ = VK_PIPELINE_STAGE_2_NONE_KHR;
+}
+
+AttachmentOps RenderGraph::GetAttachmentOps(PassHandle pass, ResourceHandle resource) const
+{
+    if (!compiled_) {
+        throw std::logic_error("RenderGraph attachment ops exist only after Compile");
+    }
+    if (pass >= passes_.size()) {
+        throw std::invalid_argument("RenderGraph::GetAttachmentOps called with an unknown pass");
+    }
+    for (const auto& [planned, ops] : passes_[pass].attachmentOps) {
+        if (planned == resource) {
+            return ops;
+        }
+    }
+    throw std::invalid_argument("RenderGraph pass does not use the image (or was culled)");
+}
+
+Image& RenderGraph::GetImage(ResourceHandle resource) const
+{
+    if (resource >= resources_.size() || resources_[resource].buffer) {
+        throw std::invalid_argument("RenderGraph resource is not an image");
+    }
+    if (resources_[resource].image == nullptr) {
+        throw std::logic_error("RenderGraph transient images exist only after Compile");
+    }
+    return *resources_[resource].image;
+}
+
+Buffer& RenderGraph::GetBuffer(ResourceHandle resource) const
+{
+    if (resource >= resources_.size() || !resources_[resource].buffer) {
+        throw std::invalid_argument("RenderGraph resource is not a buffer");
+    }
+    return *resources_[resource].bufferRef;
+}
+
+} // namespace VulkanEngine::RAII
@@ -0,0 +1,201 @@
+#ifndef VULKAN_RAII_RENDERING_RENDER_GRAPH_HPP
+#define VULKAN_RAII_RENDERING_RENDER_GRAPH_HPP
+
+#include <volk.h>
+#include <vk_mem_alloc.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "RenderPassPlanner.hpp"
+#include "../sync/ResourceState.hpp"
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+class VmaAllocator; // Forward declaration
+class Image; // Forward declaration
+class Buffer; // Forward declaration
+class CommandBuffer; // Forward declaration
+
+// Frame graph over CommandBuffer recording. Passes declare the resources they read
+// and write; Compile() culls passes that contribute nothing to an imported
+// resource (or a pass marked with side effects), orders the rest, and places
+// transient images whose lifetimes do not overlap in shared VMA allocations.
+// Execute() records the passes, issuing each declared access through the command
+// buffer's BarrierBatcher so only the barriers the tracked state needs are recorded,
+// flushed before the pass callback runs (and so before any render pass it begins).
+//
+// ASYNC_COMPUTE passes whose every dependency is another async pass are recorded
+// into the async compute command buffer given to Execute(). The graphics submission
+// must then wait on the compute submission at GetAsyncComputeWaitStages(); async
+// transient images are shared between the two queue families and never aliased.
+//
+// Compile() also picks each pass's attachment load and store ops from the declared
+// accesses (see GetAttachmentOps), so passes beginning dynamic rendering neither load
+// contents they overwrite nor store contents nothing reads.
+class RenderGraph {
+public:
+    enum class PassQueue {
+        GRAPHICS,
+        ASYNC_COMPUTE
+    };
+
+    // Transient image description; memory is owned and aliased by the graph. Images that
+    // never leave their render pass should add VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT: they
+    // are aliased only with each other in lazily allocated memory on tile-based GPUs
+    struct ImageDesc {
+        uint32_t width{0};
+        uint32_t height{0};
+        VkFormat format{VK_FORMAT_UNDEFINED};
+        VkImageUsageFlags usage{0};
+        uint32_t mipLevels{1};
+        uint32_t arrayLayers{1};
+        VkSampleCountFlagBits samples{VK_SAMPLE_COUNT_1_BIT};
+    };
+
+    using ResourceHandle = uint32_t;
+    using PassHandle = uint32_t;
+    using ExecuteCallback = std::function<void(CommandBuffer& command_buffer)>;
+
+    RenderGraph(const Device& device, const VmaAllocator& allocator);
+
+    // Destructor
+    ~RenderGraph();
+
+    // Delete copy and move. pass callbacks usually capture the graph to look up resources.
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+    RenderGraph(RenderGraph&&) = delete;
+    RenderGraph& operator=(RenderGraph&&) = delete;
+
+    // Declare a transient image, created and aliased by Compile()
+    ResourceHandle CreateImage(const char* name, const ImageDesc& desc);
+
+    // Declare an externally owned image or buffer; passes writing it are never culled
+    ResourceHandle ImportImage(const char* name, Image& image);
+    ResourceHandle ImportBuffer(const char* name, Buffer& buffer);
+
+    // Re-point an imported resource (e.g. per frame); takes effect from the next Execute()
+    void SetImportedImage(ResourceHandle resource, Image& image);
+    void SetImportedBuffer(ResourceHandle resource, Buffer& buffer);
+
+    // Declare a pass; execute records its commands
+    PassHandle AddPass(const char* name, PassQueue queue, ExecuteCallback execute);
+
+    // Declare how pass uses resource (access.layout is ignored for buffers). A write whose
+    // access has no read bit overwrites every pixel; add the attachment read bit
+    // (COLOR_ATTACHMENT_READ, DEPTH_STENCIL_ATTACHMENT_READ) when blending or testing against it
+    void Read(PassHandle pass, ResourceHandle resource, const ResourceAccess& access);
+    void Write(PassHandle pass, ResourceHandle resource, const ResourceAccess& access);
+
+    // Keep pass even when nothing reads what it writes (readbacks, queries, ...)
+    void SetSideEffects(PassHandle pass);
+
+    // Cull, order and allocate; call after declaring and whenever the declaration changes.
+    // Transient memory is reallocated, so the GPU must be done with the previous frames
+    void Compile();
+
+    // Record the compiled passes. Without async_compute every pass is recorded into graphics
+    void Execute(CommandBuffer& graphics, CommandBuffer* async_compute = nullptr);
+
+    // Drop every pass and resource (waits for nothing; the caller must know the GPU is done)
+    void Reset();
+
+    // Image behind a resource (transient images exist after Compile())
+    [[nodiscard]] Image& GetImage(ResourceHandle resource) const;
+    [[nodiscard]] Buffer& GetBuffer(ResourceHandle resource) const;
+
+    [[nodiscard]] bool IsCompiled() const { return compiled_; }
+    [[nodiscard]] bool IsPassCulled(PassHandle pass) const { return passes_[pass].culled; }
+    [[nodiscard]] bool RunsOnAsyncCompute(PassHandle pass) const { return passes_[pass].async; }
+    [[nodiscard]] const std::vector<PassHandle>& GetExecutionOrder() const { return order_; }
+
+    // Load and store ops for pass rendering to image resource, chosen by Compile() with
+    // RenderPassPlanner's rules: LOAD only when the pass reads earlier contents, STORE only
+    // when a later pass (or the owner of an imported image) reads what it leaves
+    [[nodiscard]] AttachmentOps GetAttachmentOps(PassHandle pass, ResourceHandle resource) const;
+    [[nodiscard]] bool HasAsyncComputeWork() const { return asyncPassCount_ > 0; }
+
+    // Stages at which graphics work first touches what the async passes produce or read
+    [[nodiscard]] VkPipelineStageFlags2KHR GetAsyncComputeWaitStages() const { return asyncWaitStages_; }
+
+    // Bytes of transient memory allocated, and what it would take without aliasing
+    [[nodiscard]] VkDeviceSize GetTransientMemorySize() const { return transientMemorySize_; }
+    [[nodiscard]] VkDeviceSize GetUnaliasedMemorySize() const { return unaliasedMemorySize_; }
+    [[nodiscard]] uint32_t GetMemoryBlockCount() const { return static_cast<uint32_t>(blocks_.size()); }
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct PassAccess {
+        ResourceHandle resource;
+        ResourceAccess access;
+        bool write;
+    };
+
+    struct Pass {
+        std::string name;
+        PassQueue queue{PassQueue::GRAPHICS};
+        ExecuteCallback execute;
+        std::vector<PassAccess> accesses;
+        std::vector<std::pair<ResourceHandle, AttachmentOps>> attachmentOps; // Compile results, per image
+        bool sideEffects{false};
+        bool culled{false};
+        bool async{false}; // Recorded on the async compute queue
+    };
+
+    struct Resource {
+        std::string name;
+        bool imported{false};
+        bool buffer{false};
+        ImageDesc desc{};
+        Image* image{nullptr};
+        Buffer* bufferRef{nullptr};
+        std::unique_ptr<Image> transient;
+
+        // Compile results (positions in order_)
+        uint32_t firstUse{NONE};
+        uint32_t lastUse{NONE};
+        uint32_t block{NONE};
+        ResourceHandle predecessor{NONE}; // Previous occupant of the memory block
+        bool asyncTouched{false};
+        bool graphicsTouched{false};
+    };
+
+    struct MemoryBlock {
+        VmaAllocation allocation{VK_NULL_HANDLE};
+        VkMemoryRequirements requirements{};
+        std::vector<ResourceHandle> members; // Ordered by first use
+        bool async{false}; // Holds an async compute image, which is never aliased
+        bool lazy{false}; // Holds transient attachments; lazily allocated where the device allows
+    };
+
+    const Device* device_{nullptr};
+    ::VmaAllocator allocator_{VK_NULL_HANDLE};
+    std::vector<Pass> passes_;
+    std::vector<Resource> resources_;
+    std::vector<PassHandle> order_;
+    std::vector<MemoryBlock> blocks_;
+    uint32_t asyncPassCount_{0};
+    VkPipelineStageFlags2KHR asyncWaitStages_{VK_PIPELINE_STAGE_2_NONE_KHR};
+    VkDeviceSize transientMemorySize_{0};
+    VkDeviceSize unaliasedMemorySize_{0};
+    bool compiled_{false};
+
+    void CullPasses(const std::vector<std::vector<PassHandle>>& producers);
+    void OrderPasses(const std::vector<std::vector<PassHandle>>& dependencies);
+    void PlanAttachmentOps();
+    void AllocateTransients();
+    void ReleaseTransients();
+    void RecordPass(const Pass& pass, uint32_t position, CommandBuffer& command_buffer);
+    void SeedTransient(Resource& resource);
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RENDERING_RENDER_GRAPH_HPP
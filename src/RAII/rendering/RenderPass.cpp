@@ -2,6 +2,9 @@
 #include "RenderPass.hpp"
 
 #include "../core/Device.hpp"
+#include "../resources/Image.hpp"
+#include "../utils/FormatUtils.hpp"
+#include "../utils/HostAllocator.hpp"
 
 #include <cstddef>
 #include <cstdint>
@@ -37,14 +40,15 @@ RenderPass::RenderPass(const Device& device,
                        VkFormat depth_format,
                        VkSampleCountFlagBits samples,
                        VkAttachmentLoadOp color_load_op,
-                       VkAttachmentLoadOp depth_load_op)
+                       VkAttachmentLoadOp depth_load_op,
+                       VkImageLayout color_final_layout)
     : device_(device.GetHandle())
 {
     if (device == VK_NULL_HANDLE) {
         throw std::invalid_argument("RenderPass requires a valid device");
     }
 
-    CreateSimpleRenderPass(color_format, depth_format, samples, color_load_op, depth_load_op);
+    CreateSimpleRenderPass(color_format, depth_format, samples, color_load_op, depth_load_op, color_final_layout);
     CreateRenderPass();
 }
 
@@ -86,8 +90,61 @@ VkAttachmentReference RenderPass::CreateDepthAttachmentRef(uint32_t attachment,
     return {attachment, layout};
 }
 
+VkAttachmentStoreOp RenderPass::GetStoreOp(const Image& image) {
+    return image.IsTransient() ? VK_ATTACHMENT_STORE_OP_DONT_CARE : VK_ATTACHMENT_STORE_OP_STORE;
+}
+
+AttachmentDescription RenderPass::CreateAttachment(const Image& image,
+                                                   VkAttachmentLoadOp load_op,
+                                                   VkImageLayout final_layout) {
+    AttachmentDescription attachment{};
+    attachment.format = image.GetFormat();
+    attachment.samples = image.GetSamples();
+    attachment.loadOp = load_op;
+    attachment.storeOp = GetStoreOp(image);
+    if (Utils::FormatUtils::IsStencilFormat(image.GetFormat())) {
+        attachment.stencilLoadOp = load_op;
+        attachment.stencilStoreOp = attachment.storeOp;
+    }
+    attachment.initialLayout = load_op == VK_ATTACHMENT_LOAD_OP_LOAD ? final_layout : VK_IMAGE_LAYOUT_UNDEFINED;
+    attachment.finalLayout = final_layout;
+    attachment.transient = image.IsTransient();
+    return attachment;
+}
+
+VkRenderingAttachmentInfoKHR RenderPass::CreateRenderingAttachment(const Image& image,
+                                                                   VkImageView image_view,
+                                                                   VkImageLayout layout,
+                                                                   VkAttachmentLoadOp load_op,
+                                                                   const VkClearValue& clear_value) {
+    VkRenderingAttachmentInfoKHR attachment{VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR};
+    attachment.imageView = image_view;
+    attachment.imageLayout = layout;
+    attachment.loadOp = load_op;
+    attachment.storeOp = GetStoreOp(image);
+    attachment.clearValue = clear_value;
+    return attachment;
+}
+
+VkRenderingFragmentShadingRateAttachmentInfoKHR RenderPass::CreateShadingRateAttachment(VkImageView image_view,
+                                                                                         VkExtent2D texel_size,
+                                                                                         VkImageLayout layout) {
+    VkRenderingFragmentShadingRateAttachmentInfoKHR attachment{VK_STRUCTURE_TYPE_RENDERING_FRAGMENT_SHADING_RATE_ATTACHMENT_INFO_KHR};
+    attachment.imageView = image_view;
+    attachment.imageLayout = layout;
+    attachment.shadingRateAttachmentTexelSize = texel_size;
+    return attachment;
+}
+
 void RenderPass::CreateRenderPass()
 {
+    for (const auto& subpass : subpasses_) {
+        if (subpass.shadingRateAttachment.attachment != VK_ATTACHMENT_UNUSED) {
+            CreateRenderPass2();
+            return;
+        }
+    }
+
     std::vector<VkAttachmentDescription> vk_attachments = ConvertAttachments();
 
     std::vector<std::vector<VkAttachmentReference>> input_attachment_refs(subpasses_.size());
@@ -138,16 +195,137 @@ void RenderPass::CreateRenderPass()
     render_pass_info.dependencyCount = static_cast<uint32_t>(vk_dependencies.size());
     render_pass_info.pDependencies = vk_dependencies.empty() ? nullptr : vk_dependencies.data();
 
-    if (vkCreateRenderPass(device_, &render_pass_info, nullptr, &renderPass_) != VK_SUCCESS) {
+    if (vkCreateRenderPass(device_, &render_pass_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_RENDER_PASS), &renderPass_) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create render pass");
     }
 }
 
+void RenderPass::CreateRenderPass2()
+{
+    // Input attachments are the only references whose aspect is read
+    auto aspect_of = [this](uint32_t attachment) -> VkImageAspectFlags {
+        if (attachment >= attachments_.size()) {
+            return 0;
+        }
+        const VkFormat format = attachments_[attachment].format;
+        VkImageAspectFlags aspect = 0;
+        if (Utils::FormatUtils::IsDepthFormat(format)) {
+            aspect |= VK_IMAGE_ASPECT_DEPTH_BIT;
+        }
+        if (Utils::FormatUtils::IsStencilFormat(format)) {
+            aspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+        }
+        return aspect != 0 ? aspect : VK_IMAGE_ASPECT_COLOR_BIT;
+    };
+    auto convert_refs = [&aspect_of](const std::vector<VkAttachmentReference>& refs) {
+        std::vector<VkAttachmentReference2> refs2;
+        refs2.reserve(refs.size());
+        for (const VkAttachmentReference& ref : refs) {
+            VkAttachmentReference2 ref2{VK_STRUCTURE_TYPE_ATTACHMENT_REFERENCE_2};
+            ref2.attachment = ref.attachment;
+            ref2.layout = ref.layout;
+            ref2.aspectMask = aspect_of(ref.attachment);
+            refs2.push_back(ref2);
+        }
+        return refs2;
+    };
+
+    std::vector<VkAttachmentDescription2> vk_attachments;
+    vk_attachments.reserve(attachments_.size());
+    for (const VkAttachmentDescription& attachment : ConvertAttachments()) {
+        VkAttachmentDescription2 desc{VK_STRUCTURE_TYPE_ATTACHMENT_DESCRIPTION_2};
+        desc.flags = attachment.flags;
+        desc.format = attachment.format;
+        desc.samples = attachment.samples;
+        desc.loadOp = attachment.loadOp;
+        desc.storeOp = attachment.storeOp;
+        desc.stencilLoadOp = attachment.stencilLoadOp;
+        desc.stencilStoreOp = attachment.stencilStoreOp;
+        desc.initialLayout = attachment.initialLayout;
+        desc.finalLayout = attachment.finalLayout;
+        vk_attachments.push_back(desc);
+    }
+
+    const size_t subpass_count = subpasses_.size();
+    std::vector<std::vector<VkAttachmentReference2>> input_attachment_refs(subpass_count);
+    std::vector<std::vector<VkAttachmentReference2>> color_attachment_refs(subpass_count);
+    std::vector<std::vector<VkAttachmentReference2>> resolve_attachment_refs(subpass_count);
+    std::vector<VkAttachmentReference2> depth_attachment_refs(subpass_count);
+    std::vector<VkAttachmentReference2> shading_rate_refs(subpass_count);
+    std::vector<VkFragmentShadingRateAttachmentInfoKHR> shading_rate_infos(subpass_count);
+
+    std::vector<VkSubpassDescription2> vk_subpasses(subpass_count);
+    for (size_t i = 0; i < subpass_count; ++i) {
+        const auto& subpass = subpasses_[i];
+        auto& vk_subpass = vk_subpasses[i];
+        vk_subpass = {VK_STRUCTURE_TYPE_SUBPASS_DESCRIPTION_2};
+        vk_subpass.pipelineBindPoint = subpass.pipelineBindPoint;
+        vk_subpass.flags = subpass.flags;
+
+        input_attachment_refs[i] = convert_refs(subpass.inputAttachments);
+        color_attachment_refs[i] = convert_refs(subpass.colorAttachments);
+        resolve_attachment_refs[i] = convert_refs(subpass.resolveAttachments);
+
+        vk_subpass.inputAttachmentCount = static_cast<uint32_t>(input_attachment_refs[i].size());
+        vk_subpass.pInputAttachments = input_attachment_refs[i].empty() ? nullptr : input_attachment_refs[i].data();
+        vk_subpass.colorAttachmentCount = static_cast<uint32_t>(color_attachment_refs[i].size());
+        vk_subpass.pColorAttachments = color_attachment_refs[i].empty() ? nullptr : color_attachment_refs[i].data();
+        vk_subpass.pResolveAttachments = resolve_attachment_refs[i].empty() ? nullptr : resolve_attachment_refs[i].data();
+        vk_subpass.preserveAttachmentCount = static_cast<uint32_t>(subpass.preserveAttachments.size());
+        vk_subpass.pPreserveAttachments = subpass.preserveAttachments.empty() ? nullptr : subpass.preserveAttachments.data();
+
+        if (subpass.depthStencilAttachment.attachment != VK_ATTACHMENT_UNUSED) {
+            depth_attachment_refs[i] = convert_refs({subpass.depthStencilAttachment}).front();
+            vk_subpass.pDepthStencilAttachment = &depth_attachment_refs[i];
+        }
+
+        if (subpass.shadingRateAttachment.attachment != VK_ATTACHMENT_UNUSED) {
+            if (subpass.shadingRateTexelSize.width == 0 || subpass.shadingRateTexelSize.height == 0) {
+                throw std::invalid_argument("Shading rate attachments need a texel size");
+            }
+            shading_rate_refs[i] = {VK_STRUCTURE_TYPE_ATTACHMENT_REFERENCE_2};
+            shading_rate_refs[i].attachment = subpass.shadingRateAttachment.attachment;
+            shading_rate_refs[i].layout = subpass.shadingRateAttachment.layout;
+            shading_rate_infos[i] = {VK_STRUCTURE_TYPE_FRAGMENT_SHADING_RATE_ATTACHMENT_INFO_KHR};
+            shading_rate_infos[i].pFragmentShadingRateAttachment = &shading_rate_refs[i];
+            shading_rate_infos[i].shadingRateAttachmentTexelSize = subpass.shadingRateTexelSize;
+            vk_subpass.pNext = &shading_rate_infos[i];
+        }
+    }
+
+    std::vector<VkSubpassDependency2> vk_dependencies;
+    vk_dependencies.reserve(dependencies_.size());
+    for (const VkSubpassDependency& dependency : ConvertDependencies()) {
+        VkSubpassDependency2 dep{VK_STRUCTURE_TYPE_SUBPASS_DEPENDENCY_2};
+        dep.srcSubpass = dependency.srcSubpass;
+        dep.dstSubpass = dependency.dstSubpass;
+        dep.srcStageMask = dependency.srcStageMask;
+        dep.dstStageMask = dependency.dstStageMask;
+        dep.srcAccessMask = dependency.srcAccessMask;
+        dep.dstAccessMask = dependency.dstAccessMask;
+        dep.dependencyFlags = dependency.dependencyFlags;
+        vk_dependencies.push_back(dep);
+    }
+
+    VkRenderPassCreateInfo2 render_pass_info{VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO_2};
+    render_pass_info.attachmentCount = static_cast<uint32_t>(vk_attachments.size());
+    render_pass_info.pAttachments = vk_attachments.empty() ? nullptr : vk_attachments.data();
+    render_pass_info.subpassCount = static_cast<uint32_t>(vk_subpasses.size());
+    render_pass_info.pSubpasses = vk_subpasses.data();
+    render_pass_info.dependencyCount = static_cast<uint32_t>(vk_dependencies.size());
+    render_pass_info.pDependencies = vk_dependencies.empty() ? nullptr : vk_dependencies.data();
+
+    if (vkCreateRenderPass2(device_, &render_pass_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_RENDER_PASS), &renderPass_) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create render pass with shading rate attachments");
+    }
+}
+
 void RenderPass::CreateSimpleRenderPass(VkFormat color_format,
                                         VkFormat depth_format,
                                         VkSampleCountFlagBits samples,
                                         VkAttachmentLoadOp color_load_op,
-                                        VkAttachmentLoadOp depth_load_op)
+                                        VkAttachmentLoadOp depth_load_op,
+                                        VkImageLayout color_final_layout)
 {
     attachments_.clear();
     subpasses_.clear();
@@ -159,7 +337,7 @@ void RenderPass::CreateSimpleRenderPass(VkFormat color_format,
     color_attachment.loadOp = color_load_op;
     color_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
     color_attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    color_attachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    color_attachment.finalLayout = color_final_layout;
     attachments_.push_back(color_attachment);
 
     bool has_depth = depth_format != VK_FORMAT_UNDEFINED;
@@ -192,6 +370,10 @@ void RenderPass::CreateSimpleRenderPass(VkFormat color_format,
     dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
     dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
     dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    if (color_final_layout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL) {
+        // The previous frame's copy out of the image must finish before it is overwritten
+        dependency.srcStageMask |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+    }
     if (has_depth) {
         dependency.srcStageMask |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
         dependency.dstStageMask |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
@@ -203,7 +385,7 @@ void RenderPass::CreateSimpleRenderPass(VkFormat color_format,
 void RenderPass::Cleanup()
 {
     if (renderPass_ != VK_NULL_HANDLE) {
-        vkDestroyRenderPass(device_, renderPass_, nullptr);
+        vkDestroyRenderPass(device_, renderPass_, Utils::HostAllocator::For(VK_OBJECT_TYPE_RENDER_PASS));
         renderPass_ = VK_NULL_HANDLE;
     }
     device_ = VK_NULL_HANDLE;
@@ -218,9 +400,9 @@ std::vector<VkAttachmentDescription> RenderPass::ConvertAttachments() const {
         desc.format = attachment.format;
         desc.samples = attachment.samples;
         desc.loadOp = attachment.loadOp;
-        desc.storeOp = attachment.storeOp;
+        desc.storeOp = attachment.transient ? VK_ATTACHMENT_STORE_OP_DONT_CARE : attachment.storeOp;
         desc.stencilLoadOp = attachment.stencilLoadOp;
-        desc.stencilStoreOp = attachment.stencilStoreOp;
+        desc.stencilStoreOp = attachment.transient ? VK_ATTACHMENT_STORE_OP_DONT_CARE : attachment.stencilStoreOp;
         desc.initialLayout = attachment.initialLayout;
         desc.finalLayout = attachment.finalLayout;
         attachments.push_back(desc);
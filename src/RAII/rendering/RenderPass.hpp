@@ -8,6 +8,7 @@
 namespace VulkanEngine::RAII {
 
 class Device; // Forward declaration
+class Image; // Forward declaration
 
 struct AttachmentDescription {
     VkFormat format;
@@ -19,6 +20,7 @@ struct AttachmentDescription {
     VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
     VkImageLayout finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
     VkAttachmentDescriptionFlags flags = 0;
+    bool transient = false; // Contents never leave the render pass: both store ops become DONT_CARE
 };
 
 struct SubpassDescription {
@@ -29,6 +31,10 @@ struct SubpassDescription {
     VkAttachmentReference depthStencilAttachment{VK_ATTACHMENT_UNUSED, VK_IMAGE_LAYOUT_UNDEFINED};
     std::vector<uint32_t> preserveAttachments;
     VkSubpassDescriptionFlags flags = 0;
+    // Shading rate attachment (VK_KHR_fragment_shading_rate); each of its texels covers
+    // shadingRateTexelSize pixels. Using one creates the pass through vkCreateRenderPass2
+    VkAttachmentReference shadingRateAttachment{VK_ATTACHMENT_UNUSED, VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR};
+    VkExtent2D shadingRateTexelSize{0, 0};
 };
 
 struct SubpassDependency {
@@ -49,13 +55,15 @@ public:
                const std::vector<SubpassDescription>& subpasses,
                const std::vector<SubpassDependency>& dependencies = {});
 
-    // Constructor for simple single-subpass render pass
+    // Constructor for simple single-subpass render pass. color_final_layout is the
+    // swapchain's Swapchain::GetPresentLayout() (TRANSFER_SRC_OPTIMAL when headless)
     RenderPass(const Device& device,
                VkFormat color_format,
                VkFormat depth_format = VK_FORMAT_UNDEFINED,
                VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT,
                VkAttachmentLoadOp color_load_op = VK_ATTACHMENT_LOAD_OP_CLEAR,
-               VkAttachmentLoadOp depth_load_op = VK_ATTACHMENT_LOAD_OP_CLEAR);
+               VkAttachmentLoadOp depth_load_op = VK_ATTACHMENT_LOAD_OP_CLEAR,
+               VkImageLayout color_final_layout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
 
     // Destructor
     ~RenderPass();
@@ -99,6 +107,30 @@ public:
     static VkAttachmentReference CreateDepthAttachmentRef(uint32_t attachment,
                                                          VkImageLayout layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
 
+    // Store op for image: DONT_CARE for transient attachments (Image::IsTransient), so
+    // tile-based GPUs skip the writeback to memory, STORE otherwise
+    static VkAttachmentStoreOp GetStoreOp(const Image& image);
+
+    // Helper to describe an attachment rendering into image, taking format, samples and
+    // (through GetStoreOp) the store ops from it. Stencil ops follow load_op for formats with stencil
+    static AttachmentDescription CreateAttachment(const Image& image,
+                                                  VkAttachmentLoadOp load_op,
+                                                  VkImageLayout final_layout);
+
+    // Dynamic rendering counterpart of CreateAttachment for CommandBuffer::BeginRendering
+    static VkRenderingAttachmentInfoKHR CreateRenderingAttachment(const Image& image,
+                                                                  VkImageView image_view,
+                                                                  VkImageLayout layout,
+                                                                  VkAttachmentLoadOp load_op,
+                                                                  const VkClearValue& clear_value = {});
+
+    // Shading rate attachment for CommandBuffer::BeginRendering; texel_size is the pixel
+    // area one texel covers (see Device::GetFragmentShadingRateProperties)
+    static VkRenderingFragmentShadingRateAttachmentInfoKHR CreateShadingRateAttachment(
+        VkImageView image_view,
+        VkExtent2D texel_size,
+        VkImageLayout layout = VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR);
+
 private:
     VkRenderPass renderPass_{VK_NULL_HANDLE};
     VkDevice device_{VK_NULL_HANDLE}; // Reference to device
@@ -109,9 +141,11 @@ private:
 
     // Helper methods
     void CreateRenderPass();
+    void CreateRenderPass2(); // Subpasses with a shading rate attachment
     void CreateSimpleRenderPass(VkFormat color_format, VkFormat depth_format, 
                                VkSampleCountFlagBits samples,
-                               VkAttachmentLoadOp color_load_op, VkAttachmentLoadOp depth_load_op);
+                               VkAttachmentLoadOp color_load_op, VkAttachmentLoadOp depth_load_op,
+                               VkImageLayout color_final_layout);
     void Cleanup();
     
     // Conversion helpers
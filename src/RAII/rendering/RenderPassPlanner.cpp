@@ -0,0 +1,472 @@
+#include "RenderPassPlanner.hpp"
+
+#include "../core/Device.hpp"
+#include "../utils/FormatUtils.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+
+namespace VulkanEngine::RAII {
+
+namespace {
+using Usage = RenderPassPlanner::Usage;
+
+constexpr uint32_t NONE = UINT32_MAX;
+
+struct StageAccess {
+    VkPipelineStageFlags stages{0};
+    VkAccessFlags access{0};
+    bool writes{false};
+};
+
+bool ReadsContents(Usage usage)
+{
+    return usage == Usage::COLOR_BLEND || usage == Usage::DEPTH_TEST || usage == Usage::DEPTH_READ_ONLY ||
+           usage == Usage::INPUT || usage == Usage::SAMPLED;
+}
+
+bool WritesContents(Usage usage)
+{
+    return usage == Usage::COLOR_WRITE || usage == Usage::COLOR_BLEND || usage == Usage::DEPTH_TEST ||
+           usage == Usage::RESOLVE;
+}
+
+bool IsAttachmentUse(Usage usage)
+{
+    return usage != Usage::SAMPLED;
+}
+
+bool IsDepthStencil(VkFormat format)
+{
+    return Utils::FormatUtils::IsDepthFormat(format) || Utils::FormatUtils::IsStencilFormat(format);
+}
+
+VkImageLayout GetUsageLayout(Usage usage, bool depth_stencil)
+{
+    switch (usage) {
+        case Usage::COLOR_WRITE:
+        case Usage::COLOR_BLEND:
+        case Usage::RESOLVE:
+            return VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        case Usage::DEPTH_TEST:
+            return VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        case Usage::DEPTH_READ_ONLY:
+            return VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+        case Usage::INPUT:
+        case Usage::SAMPLED:
+            return depth_stencil ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    }
+    return VK_IMAGE_LAYOUT_GENERAL;
+}
+
+StageAccess GetStageAccess(Usage usage)
+{
+    constexpr VkPipelineStageFlags fragment_tests = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                                                    VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    switch (usage) {
+        case Usage::COLOR_WRITE:
+        case Usage::RESOLVE:
+            return {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, true};
+        case Usage::COLOR_BLEND:
+            return {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                    VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                    true};
+        case Usage::DEPTH_TEST:
+            return {fragment_tests,
+                    VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                    true};
+        case Usage::DEPTH_READ_ONLY:
+            return {fragment_tests, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT, false};
+        case Usage::INPUT:
+            return {VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_INPUT_ATTACHMENT_READ_BIT, false};
+        case Usage::SAMPLED:
+            return {VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, false};
+    }
+    return {};
+}
+
+// What runs before and after a planned render pass is other attachment and fragment work
+constexpr StageAccess EXTERNAL_SOURCE{VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                                          VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                                          VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT |
+                                          VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                      VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                                      true};
+constexpr StageAccess EXTERNAL_DESTINATION{VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                                               VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                                               VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT |
+                                               VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                           VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INPUT_ATTACHMENT_READ_BIT |
+                                               VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                               VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                                               VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                                           true};
+
+void AddUniqueReference(std::vector<VkAttachmentReference>& references, const VkAttachmentReference& reference)
+{
+    const bool present = std::any_of(references.begin(), references.end(), [&](const VkAttachmentReference& existing) {
+        return existing.attachment == reference.attachment;
+    });
+    if (!present) {
+        references.push_back(reference);
+    }
+}
+} // namespace
+
+VkAttachmentLoadOp RenderPassPlanner::ChooseLoadOp(bool reads_contents, bool has_contents)
+{
+    if (!reads_contents) {
+        return VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    }
+    // Reading contents nothing wrote yet: a clear is the cheapest defined start
+    return has_contents ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR;
+}
+
+VkAttachmentStoreOp RenderPassPlanner::ChooseStoreOp(bool written, bool needed_later, bool store_op_none)
+{
+    if (!written && store_op_none) {
+        return VK_ATTACHMENT_STORE_OP_NONE_KHR;
+    }
+    return needed_later ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+}
+
+std::unique_ptr<RenderPass> RenderPassPlanner::Plan::CreateRenderPass(const Device& device, uint32_t group) const
+{
+    if (group >= groups.size()) {
+        throw std::out_of_range("RenderPassPlanner plan has no group " + std::to_string(group));
+    }
+    const Group& planned = groups[group];
+    return std::make_unique<RenderPass>(device, planned.attachmentDescriptions, planned.subpasses, planned.dependencies);
+}
+
+uint32_t RenderPassPlanner::AddAttachment(const Attachment& attachment)
+{
+    if (attachment.format == VK_FORMAT_UNDEFINED) {
+        throw std::invalid_argument("RenderPassPlanner attachments need a format");
+    }
+    if (attachment.preserveContents && attachment.initialLayout == VK_IMAGE_LAYOUT_UNDEFINED) {
+        throw std::invalid_argument("RenderPassPlanner attachments preserving their contents need an initial layout");
+    }
+    attachments_.push_back(attachment);
+    return static_cast<uint32_t>(attachments_.size() - 1);
+}
+
+uint32_t RenderPassPlanner::AddPass(const char* name, VkExtent2D extent)
+{
+    if (extent.width == 0 || extent.height == 0) {
+        throw std::invalid_argument("RenderPassPlanner passes need a non-empty extent");
+    }
+    Pass pass;
+    pass.name = name ? name : "";
+    pass.extent = extent;
+    passes_.push_back(std::move(pass));
+    return static_cast<uint32_t>(passes_.size() - 1);
+}
+
+void RenderPassPlanner::Use(uint32_t pass, uint32_t attachment, Usage usage)
+{
+    if (pass >= passes_.size() || attachment >= attachments_.size()) {
+        throw std::invalid_argument("RenderPassPlanner::Use called with an unknown pass or attachment");
+    }
+    const bool depth_stencil = IsDepthStencil(attachments_[attachment].format);
+    const bool depth_usage = usage == Usage::DEPTH_TEST || usage == Usage::DEPTH_READ_ONLY;
+    const bool color_usage = usage == Usage::COLOR_WRITE || usage == Usage::COLOR_BLEND || usage == Usage::RESOLVE;
+    if ((depth_usage && !depth_stencil) || (color_usage && depth_stencil)) {
+        throw std::invalid_argument("RenderPassPlanner usage does not match the format of the attachment");
+    }
+    passes_[pass].uses.push_back(AttachmentUse{attachment, usage});
+}
+
+VkImageLayout RenderPassPlanner::GetLayout(uint32_t pass, uint32_t attachment) const
+{
+    const bool depth_stencil = IsDepthStencil(attachments_[attachment].format);
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    for (const AttachmentUse& use : passes_[pass].uses) {
+        if (use.attachment != attachment) {
+            continue;
+        }
+        const VkImageLayout use_layout = GetUsageLayout(use.usage, depth_stencil);
+        if (layout == VK_IMAGE_LAYOUT_UNDEFINED) {
+            layout = use_layout;
+        } else if (layout != use_layout) {
+            // Written and read by one pass (a feedback loop)
+            return VK_IMAGE_LAYOUT_GENERAL;
+        }
+    }
+    return layout;
+}
+
+VkSampleCountFlagBits RenderPassPlanner::GetSamples(uint32_t pass) const
+{
+    for (const AttachmentUse& use : passes_[pass].uses) {
+        if (use.usage != Usage::RESOLVE && use.usage != Usage::SAMPLED) {
+            return attachments_[use.attachment].samples;
+        }
+    }
+    return VK_SAMPLE_COUNT_1_BIT;
+}
+
+std::vector<std::vector<uint32_t>> RenderPassPlanner::GroupPasses(const Options& options) const
+{
+    std::vector<std::vector<uint32_t>> groups;
+    std::vector<bool> group_attachments(attachments_.size(), false);
+    std::vector<bool> group_sampled(attachments_.size(), false);
+    for (uint32_t p = 0; p < passes_.size(); ++p) {
+        const Pass& pass = passes_[p];
+        const bool has_attachment = std::any_of(pass.uses.begin(), pass.uses.end(), [](const AttachmentUse& use) {
+            return IsAttachmentUse(use.usage);
+        });
+        if (!has_attachment) {
+            throw std::invalid_argument("RenderPassPlanner pass '" + pass.name + "' uses no attachment");
+        }
+
+        // Sampling reads any pixel, so what a render pass renders can only be sampled after it ends
+        bool merge = options.mergeSubpasses && !groups.empty();
+        if (merge) {
+            const Pass& first = passes_[groups.back().front()];
+            merge = first.extent.width == pass.extent.width && first.extent.height == pass.extent.height &&
+                    GetSamples(groups.back().front()) == GetSamples(p);
+        }
+        for (size_t i = 0; merge && i < pass.uses.size(); ++i) {
+            const AttachmentUse& use = pass.uses[i];
+            merge = IsAttachmentUse(use.usage) ? !group_sampled[use.attachment] : !group_attachments[use.attachment];
+        }
+        if (!merge) {
+            groups.emplace_back();
+            group_attachments.assign(attachments_.size(), false);
+            group_sampled.assign(attachments_.size(), false);
+        }
+
+        groups.back().push_back(p);
+        for (const AttachmentUse& use : pass.uses) {
+            if (IsAttachmentUse(use.usage)) {
+                group_attachments[use.attachment] = true;
+            } else {
+                group_sampled[use.attachment] = true;
+            }
+        }
+    }
+    return groups;
+}
+
+RenderPassPlanner::Plan RenderPassPlanner::Build(const Options& options) const
+{
+    Plan plan;
+    plan.passGroups.assign(passes_.size(), 0);
+    plan.passSubpasses.assign(passes_.size(), 0);
+    plan.transientAttachments.assign(attachments_.size(), true);
+
+    // Passes touching each attachment, in order
+    std::vector<std::vector<uint32_t>> attachment_passes(attachments_.size());
+    for (uint32_t p = 0; p < passes_.size(); ++p) {
+        for (const AttachmentUse& use : passes_[p].uses) {
+            std::vector<uint32_t>& users = attachment_passes[use.attachment];
+            if (users.empty() || users.back() != p) {
+                users.push_back(p);
+            }
+            if (use.usage == Usage::SAMPLED) {
+                plan.transientAttachments[use.attachment] = false;
+            }
+        }
+    }
+    for (uint32_t a = 0; a < attachments_.size(); ++a) {
+        const Attachment& attachment = attachments_[a];
+        if (attachment_passes[a].empty() || attachment.preserveContents || attachment.keepContents) {
+            plan.transientAttachments[a] = false;
+        }
+    }
+
+    auto pass_uses = [this](uint32_t pass, uint32_t attachment, auto&& predicate) {
+        return std::any_of(passes_[pass].uses.begin(), passes_[pass].uses.end(), [&](const AttachmentUse& use) {
+            return use.attachment == attachment && predicate(use.usage);
+        });
+    };
+    auto pass_stage_access = [this](uint32_t pass, uint32_t attachment) {
+        StageAccess combined{};
+        for (const AttachmentUse& use : passes_[pass].uses) {
+            if (use.attachment == attachment) {
+                const StageAccess use_access = GetStageAccess(use.usage);
+                combined.stages |= use_access.stages;
+                combined.access |= use_access.access;
+                combined.writes = combined.writes || use_access.writes;
+            }
+        }
+        return combined;
+    };
+
+    std::vector<bool> written(attachments_.size(), false); // By an earlier group
+    std::vector<VkImageLayout> current_layout(attachments_.size());
+    for (uint32_t a = 0; a < attachments_.size(); ++a) {
+        current_layout[a] = attachments_[a].initialLayout;
+    }
+
+    const std::vector<std::vector<uint32_t>> pass_groups = GroupPasses(options);
+    for (uint32_t g = 0; g < pass_groups.size(); ++g) {
+        Group group;
+        group.passes = pass_groups[g];
+        group.extent = passes_[group.passes.front()].extent;
+
+        std::vector<uint32_t> local(attachments_.size(), NONE);
+        for (uint32_t j = 0; j < group.passes.size(); ++j) {
+            const uint32_t p = group.passes[j];
+            plan.passGroups[p] = g;
+            plan.passSubpasses[p] = j;
+            for (const AttachmentUse& use : passes_[p].uses) {
+                if (IsAttachmentUse(use.usage) && local[use.attachment] == NONE) {
+                    local[use.attachment] = static_cast<uint32_t>(group.attachments.size());
+                    group.attachments.push_back(use.attachment);
+                }
+            }
+        }
+
+        const uint32_t last_pass = group.passes.back();
+        for (const uint32_t a : group.attachments) {
+            const Attachment& attachment = attachments_[a];
+            const std::vector<uint32_t>& users = attachment_passes[a];
+
+            uint32_t first_user = NONE;
+            uint32_t last_user = NONE;
+            bool written_in_group = false;
+            for (const uint32_t p : group.passes) {
+                if (!pass_uses(p, a, IsAttachmentUse)) {
+                    continue;
+                }
+                first_user = first_user == NONE ? p : first_user;
+                last_user = p;
+                written_in_group = written_in_group || pass_uses(p, a, WritesContents);
+            }
+
+            // The next pass to touch the attachment decides whether it is stored and how it is left
+            bool needed_later = attachment.keepContents;
+            VkImageLayout final_layout = attachment.finalLayout != VK_IMAGE_LAYOUT_UNDEFINED ? attachment.finalLayout
+                                                                                            : GetLayout(last_user, a);
+            const auto next = std::upper_bound(users.begin(), users.end(), last_pass);
+            if (next != users.end()) {
+                needed_later = pass_uses(*next, a, ReadsContents);
+                final_layout = GetLayout(*next, a);
+            }
+
+            const bool has_contents = written[a] || attachment.preserveContents;
+            AttachmentDescription description{};
+            description.format = attachment.format;
+            description.samples = attachment.samples;
+            description.loadOp = ChooseLoadOp(pass_uses(first_user, a, ReadsContents), has_contents);
+            description.storeOp = ChooseStoreOp(written_in_group, needed_later, options.storeOpNone);
+            if (Utils::FormatUtils::IsStencilFormat(attachment.format)) {
+                description.stencilLoadOp = description.loadOp;
+                description.stencilStoreOp = description.storeOp;
+            }
+            description.initialLayout = description.loadOp == VK_ATTACHMENT_LOAD_OP_LOAD ? current_layout[a]
+                                                                                         : VK_IMAGE_LAYOUT_UNDEFINED;
+            description.finalLayout = final_layout;
+            group.attachmentDescriptions.push_back(description);
+
+            if (description.loadOp == VK_ATTACHMENT_LOAD_OP_LOAD || description.storeOp != VK_ATTACHMENT_STORE_OP_DONT_CARE) {
+                plan.transientAttachments[a] = false;
+            }
+            written[a] = written[a] || written_in_group;
+            current_layout[a] = final_layout;
+        }
+
+        // One subpass per pass
+        for (const uint32_t p : group.passes) {
+            SubpassDescription subpass;
+            std::vector<VkAttachmentReference> resolves;
+            for (const AttachmentUse& use : passes_[p].uses) {
+                if (!IsAttachmentUse(use.usage)) {
+                    continue;
+                }
+                const VkAttachmentReference reference{local[use.attachment], GetLayout(p, use.attachment)};
+                switch (use.usage) {
+                    case Usage::COLOR_WRITE:
+                    case Usage::COLOR_BLEND:
+                        AddUniqueReference(subpass.colorAttachments, reference);
+                        break;
+                    case Usage::DEPTH_TEST:
+                    case Usage::DEPTH_READ_ONLY:
+                        if (subpass.depthStencilAttachment.attachment != VK_ATTACHMENT_UNUSED &&
+                            subpass.depthStencilAttachment.attachment != reference.attachment) {
+                            throw std::invalid_argument("RenderPassPlanner pass '" + passes_[p].name +
+                                                        "' uses more than one depth attachment");
+                        }
+                        subpass.depthStencilAttachment = reference;
+                        break;
+                    case Usage::INPUT:
+                        AddUniqueReference(subpass.inputAttachments, reference);
+                        break;
+                    case Usage::RESOLVE:
+                        AddUniqueReference(resolves, reference);
+                        break;
+                    case Usage::SAMPLED:
+                        break;
+                }
+            }
+            if (!resolves.empty()) {
+                if (resolves.size() > subpass.colorAttachments.size()) {
+                    throw std::invalid_argument("RenderPassPlanner pass '" + passes_[p].name +
+                                                "' resolves more attachments than it renders");
+                }
+                resolves.resize(subpass.colorAttachments.size(), VkAttachmentReference{VK_ATTACHMENT_UNUSED, VK_IMAGE_LAYOUT_UNDEFINED});
+                subpass.resolveAttachments = std::move(resolves);
+            }
+            group.subpasses.push_back(std::move(subpass));
+        }
+
+        auto add_dependency = [&group](uint32_t src, uint32_t dst, const StageAccess& src_access, const StageAccess& dst_access) {
+            auto existing = std::find_if(group.dependencies.begin(), group.dependencies.end(), [&](const SubpassDependency& dependency) {
+                return dependency.srcSubpass == src && dependency.dstSubpass == dst;
+            });
+            if (existing == group.dependencies.end()) {
+                SubpassDependency dependency;
+                dependency.srcSubpass = src;
+                dependency.dstSubpass = dst;
+                dependency.srcStageMask = 0;
+                dependency.dstStageMask = 0;
+                dependency.srcAccessMask = 0;
+                dependency.dstAccessMask = 0;
+                // Subpasses only read what earlier ones wrote at the same pixel
+                dependency.dependencyFlags = (src != VK_SUBPASS_EXTERNAL && dst != VK_SUBPASS_EXTERNAL) ? VK_DEPENDENCY_BY_REGION_BIT : 0;
+                group.dependencies.push_back(dependency);
+                existing = group.dependencies.end() - 1;
+            }
+            existing->srcStageMask |= src_access.stages;
+            existing->dstStageMask |= dst_access.stages;
+            existing->srcAccessMask |= src_access.access;
+            existing->dstAccessMask |= dst_access.access;
+        };
+
+        // Chain every attachment's subpasses, keeping its contents alive in the subpasses between
+        for (const uint32_t a : group.attachments) {
+            uint32_t previous = NONE;
+            StageAccess previous_access{};
+            for (uint32_t j = 0; j < group.passes.size(); ++j) {
+                const uint32_t p = group.passes[j];
+                if (!pass_uses(p, a, IsAttachmentUse)) {
+                    continue;
+                }
+                const StageAccess access = pass_stage_access(p, a);
+                if (previous == NONE) {
+                    add_dependency(VK_SUBPASS_EXTERNAL, j, EXTERNAL_SOURCE, access);
+                } else {
+                    if (previous_access.writes || access.writes) {
+                        add_dependency(previous, j, previous_access, access);
+                    }
+                    for (uint32_t between = previous + 1; between < j; ++between) {
+                        group.subpasses[between].preserveAttachments.push_back(local[a]);
+                    }
+                }
+                previous = j;
+                previous_access = access;
+            }
+            add_dependency(previous, VK_SUBPASS_EXTERNAL, previous_access, EXTERNAL_DESTINATION);
+        }
+
+        plan.groups.push_back(std::move(group));
+    }
+    return plan;
+}
+
+} // namespace VulkanEngine::RAII
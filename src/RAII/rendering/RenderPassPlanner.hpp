@@ -0,0 +1,123 @@
+#ifndef VULKAN_RAII_RENDERING_RENDER_PASS_PLANNER_HPP
+#define VULKAN_RAII_RENDERING_RENDER_PASS_PLANNER_HPP
+
+#include <volk.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "RenderPass.hpp"
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+
+// Load and store ops for one attachment of one pass
+struct AttachmentOps {
+    VkAttachmentLoadOp loadOp{VK_ATTACHMENT_LOAD_OP_LOAD};
+    VkAttachmentStoreOp storeOp{VK_ATTACHMENT_STORE_OP_STORE};
+};
+
+// Derives render passes from what each pass reads and writes instead of hand-picked
+// AttachmentDescription/SubpassDescription structs. Load ops are LOAD only where
+// earlier contents are read, CLEAR where contents are read before anything wrote
+// them and DONT_CARE where the pass overwrites every pixel; store ops are STORE only
+// where a later pass (or the caller, after the last one) reads what was written.
+// Consecutive passes of the same extent and sample count are merged into subpasses
+// of one render pass, with pixel-local reads of earlier results as input
+// attachments, so tile-based GPUs keep the intermediate attachments on chip.
+// Passes are taken in declaration order, which must be the execution order
+class RenderPassPlanner {
+public:
+    enum class Usage {
+        COLOR_WRITE,     // Color attachment whose every pixel the pass overwrites
+        COLOR_BLEND,     // Color attachment blended onto or partially covered: reads earlier contents
+        DEPTH_TEST,      // Depth/stencil attachment tested and written
+        DEPTH_READ_ONLY, // Depth/stencil attachment tested, not written
+        INPUT,           // Input attachment: read at the fragment's own pixel (subpassLoad)
+        RESOLVE,         // Resolve target of the pass's color attachment with the same index
+        SAMPLED          // Sampled anywhere; ends the render pass that wrote it
+    };
+
+    struct Attachment {
+        VkFormat format{VK_FORMAT_UNDEFINED};
+        VkSampleCountFlagBits samples{VK_SAMPLE_COUNT_1_BIT};
+        VkImageLayout initialLayout{VK_IMAGE_LAYOUT_UNDEFINED}; // Layout before the first pass
+        VkImageLayout finalLayout{VK_IMAGE_LAYOUT_UNDEFINED}; // After the last pass; UNDEFINED keeps the last one
+        bool preserveContents{false}; // Contents from before the first pass are read
+        bool keepContents{false}; // Contents are read after the last pass (presented, read back, next frame)
+    };
+
+    struct Options {
+        bool mergeSubpasses{true};
+        // VK_ATTACHMENT_STORE_OP_NONE for attachments a render pass only reads (Vulkan 1.3,
+        // VK_KHR_dynamic_rendering or VK_EXT_load_store_op_none); otherwise they are stored
+        bool storeOpNone{false};
+    };
+
+    // One render pass: its attachments, subpasses and dependencies, ready for the RenderPass constructor
+    struct Group {
+        std::vector<uint32_t> passes; // One subpass each, in order
+        std::vector<uint32_t> attachments; // Planner attachment behind each render pass attachment
+        std::vector<AttachmentDescription> attachmentDescriptions;
+        std::vector<SubpassDescription> subpasses;
+        std::vector<SubpassDependency> dependencies;
+        VkExtent2D extent{0, 0};
+    };
+
+    struct Plan {
+        std::vector<Group> groups;
+        std::vector<uint32_t> passGroups; // Group of each pass
+        std::vector<uint32_t> passSubpasses; // Subpass of each pass within its group
+        // Never stored nor loaded: can use VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT and lazily allocated memory
+        std::vector<bool> transientAttachments;
+
+        [[nodiscard]] std::unique_ptr<RenderPass> CreateRenderPass(const Device& device, uint32_t group) const;
+
+        // Framebuffer image order for group: its attachments' planner indices map to these positions
+        [[nodiscard]] const std::vector<uint32_t>& GetFramebufferAttachments(uint32_t group) const {
+            return groups[group].attachments;
+        }
+    };
+
+    uint32_t AddAttachment(const Attachment& attachment);
+    uint32_t AddPass(const char* name, VkExtent2D extent);
+
+    // Declare how pass uses attachment; a pass may use one attachment several ways
+    void Use(uint32_t pass, uint32_t attachment, Usage usage);
+
+    [[nodiscard]] Plan Build(const Options& options) const;
+    [[nodiscard]] Plan Build() const { return Build(Options{}); }
+
+    [[nodiscard]] uint32_t GetAttachmentCount() const { return static_cast<uint32_t>(attachments_.size()); }
+    [[nodiscard]] uint32_t GetPassCount() const { return static_cast<uint32_t>(passes_.size()); }
+
+    // The rules Build applies, for passes that begin dynamic rendering themselves (see RenderGraph)
+    [[nodiscard]] static VkAttachmentLoadOp ChooseLoadOp(bool reads_contents, bool has_contents);
+    [[nodiscard]] static VkAttachmentStoreOp ChooseStoreOp(bool written, bool needed_later, bool store_op_none);
+
+private:
+    struct AttachmentUse {
+        uint32_t attachment;
+        Usage usage;
+    };
+
+    struct Pass {
+        std::string name;
+        VkExtent2D extent{0, 0};
+        std::vector<AttachmentUse> uses;
+    };
+
+    std::vector<Attachment> attachments_;
+    std::vector<Pass> passes_;
+
+    [[nodiscard]] std::vector<std::vector<uint32_t>> GroupPasses(const Options& options) const;
+    [[nodiscard]] VkImageLayout GetLayout(uint32_t pass, uint32_t attachment) const;
+    [[nodiscard]] VkSampleCountFlagBits GetSamples(uint32_t pass) const;
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RENDERING_RENDER_PASS_PLANNER_HPP
@@ -2,20 +2,36 @@
 
 #include "CommandBuffer.hpp"
 #include "CommandPool.hpp"
+#include "FrameCommandAllocator.hpp"
 #include "Framebuffer.hpp"
+#include "GpuProfiler.hpp"
 #include "RenderPass.hpp"
 #include "../core/Device.hpp"
 #include "../presentation/Swapchain.hpp"
+#include "../resources/Buffer.hpp"
+#include "../resources/Image.hpp"
+#include "../sync/BarrierBatcher.hpp"
 #include "../sync/Semaphore.hpp"
 #include "../sync/Fence.hpp"
+#include "../sync/ResourceState.hpp"
+#include "../utils/FormatUtils.hpp"
+#include "../utils/ImageUtils.hpp"
+#include "../utils/LatencyTracker.hpp"
+#include "../utils/Profiler.hpp"
+#include "../utils/TracyUtils.hpp"
+#include "../utils/SyncUtils.hpp"
 // #include "../utils/SDLUtils.hpp"
 
 
 #include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <utility>
+#include <span>
 #include <vector>
 #include <limits>
 #include <iostream>
@@ -23,6 +39,111 @@
 
 namespace VulkanEngine::RAII {
 
+namespace {
+
+// Source half of a queue family ownership transfer; the destination scope is ignored
+template <typename Barrier>
+Barrier MakeReleaseBarrier(Barrier barrier)
+{
+    barrier.dstStageMask = VK_PIPELINE_STAGE_2_NONE_KHR;
+    barrier.dstAccessMask = VK_ACCESS_2_NONE_KHR;
+    return barrier;
+}
+
+// Destination half; the semaphore wait orders it after the release
+template <typename Barrier>
+Barrier MakeAcquireBarrier(Barrier barrier)
+{
+    barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE_KHR;
+    barrier.srcAccessMask = VK_ACCESS_2_NONE_KHR;
+    return barrier;
+}
+
+// Bounded so a window that stops presenting (e.g. minimized) cannot hang BeginFrame
+constexpr uint64_t PRESENT_WAIT_TIMEOUT_NS = 100'000'000;
+
+// Weight of the newest sample in the latency moving averages
+constexpr double LATENCY_SMOOTHING = 0.1;
+
+// Presented frames BeginFrame lets stay queued (0: no pacing)
+size_t GetPresentQueueDepth(Swapchain::LatencyMode mode)
+{
+    switch (mode) {
+        case Swapchain::LatencyMode::LOWEST_LATENCY:
+            return 1;
+        case Swapchain::LatencyMode::BALANCED:
+            return 2;
+        case Swapchain::LatencyMode::THROUGHPUT:
+        default:
+            return 0;
+    }
+}
+
+double UpdateAverage(double average, double sample, uint64_t sample_count)
+{
+    return sample_count <= 1 ? sample : average + LATENCY_SMOOTHING * (sample - average);
+}
+
+// Clip rect to extent; empty results have a zero width or height
+VkRect2D ClipRect(const VkRect2D& rect, const VkExtent2D& extent)
+{
+    const int64_t x0 = std::max<int64_t>(rect.offset.x, 0);
+    const int64_t y0 = std::max<int64_t>(rect.offset.y, 0);
+    const int64_t x1 = std::min<int64_t>(static_cast<int64_t>(rect.offset.x) + rect.extent.width, extent.width);
+    const int64_t y1 = std::min<int64_t>(static_cast<int64_t>(rect.offset.y) + rect.extent.height, extent.height);
+    VkRect2D clipped{};
+    clipped.offset = {static_cast<int32_t>(x0), static_cast<int32_t>(y0)};
+    clipped.extent = {static_cast<uint32_t>(std::max<int64_t>(x1 - x0, 0)), static_cast<uint32_t>(std::max<int64_t>(y1 - y0, 0))};
+    return clipped;
+}
+
+// Smallest rect covering both (an empty rect covers nothing)
+VkRect2D UnionRect(const VkRect2D& a, const VkRect2D& b)
+{
+    if (a.extent.width == 0 || a.extent.height == 0) {
+        return b;
+    }
+    if (b.extent.width == 0 || b.extent.height == 0) {
+        return a;
+    }
+    const int64_t x0 = std::min(a.offset.x, b.offset.x);
+    const int64_t y0 = std::min(a.offset.y, b.offset.y);
+    const int64_t x1 = std::max(static_cast<int64_t>(a.offset.x) + a.extent.width, static_cast<int64_t>(b.offset.x) + b.extent.width);
+    const int64_t y1 = std::max(static_cast<int64_t>(a.offset.y) + a.extent.height, static_cast<int64_t>(b.offset.y) + b.extent.height);
+    VkRect2D result{};
+    result.offset = {static_cast<int32_t>(x0), static_cast<int32_t>(y0)};
+    result.extent = {static_cast<uint32_t>(x1 - x0), static_cast<uint32_t>(y1 - y0)};
+    return result;
+}
+
+const char* QueueTrackName(QueueType queue)
+{
+    switch (queue) {
+        case QueueType::COMPUTE: return "GPU Compute";
+        case QueueType::TRANSFER: return "GPU Transfer";
+        default: return "GPU Graphics";
+    }
+}
+
+
+// Submit under the device's per-queue mutex: uploads, copy batches and presents share
+// the VkQueue whenever their family falls back to this one
+VkResult SubmitLocked(const Device& device, VkQueue queue, const VkSubmitInfo2KHR& submit, VkFence fence, bool sync2)
+{
+    const std::shared_ptr<std::mutex> queue_mutex = device.GetQueueMutex(queue);
+    std::unique_lock<std::mutex> lock;
+    if (queue_mutex) {
+        lock = std::unique_lock<std::mutex>(*queue_mutex);
+    }
+    return Utils::SyncUtils::QueueSubmit2(queue,
+                                          std::span<const VkSubmitInfo2KHR>(&submit, 1),
+                                          fence,
+                                          sync2,
+                                          &device.GetDispatch());
+}
+
+} // namespace
+
 Renderer::Renderer(const Device& device,
                    Swapchain& swapchain,
                    const RenderPass& render_pass,
@@ -30,83 +151,40 @@ Renderer::Renderer(const Device& device,
     : device_(&device),
     swapchain_(&swapchain),
     renderPass_(&render_pass),
-    maxFramesInFlight_(std::max(1u, max_frames_in_flight))
+    maxFramesInFlight_(std::max(1u, max_frames_in_flight)),
+    framesInFlight_(maxFramesInFlight_)
 {
     CreateCommandObjects();
     CreateSyncObjects(swapchain.GetImageCount());
     CreateFramebuffers();
+    ResetDamageHistory();
 }
 
-Renderer::~Renderer() {
-    Cleanup();
+Renderer::Renderer(const Device& device,
+                   Swapchain& swapchain,
+                   uint32_t max_frames_in_flight)
+    : device_(&device),
+    swapchain_(&swapchain),
+    maxFramesInFlight_(std::max(1u, max_frames_in_flight)),
+    framesInFlight_(maxFramesInFlight_),
+    dynamicRendering_(true)
+{
+    if (!device.SupportsDynamicRendering()) {
+        throw std::runtime_error("Renderer without a render pass requires dynamic rendering support");
+    }
+    CreateCommandObjects();
+    CreateSyncObjects(swapchain.GetImageCount());
+    swapchainImages_ = swapchain.GetImages();
+    ResetDamageHistory();
 }
 
-Renderer::Renderer(Renderer&& other) noexcept
-    : device_(other.device_),
-    swapchain_(other.swapchain_),
-    renderPass_(other.renderPass_),
-    maxFramesInFlight_(other.maxFramesInFlight_),
-    currentFrame_(other.currentFrame_),
-    imageIndex_(other.imageIndex_),
-    frameInProgress_(other.frameInProgress_),
-    needsSwapchainRecreation_(other.needsSwapchainRecreation_),
-    commandPools_(std::move(other.commandPools_)),
-    commandBuffers_(std::move(other.commandBuffers_)),
-    computeCommandPools_(std::move(other.computeCommandPools_)),
-    computeCommandBuffers_(std::move(other.computeCommandBuffers_)),
-    imageAvailableSemaphores_(std::move(other.imageAvailableSemaphores_)),
-    renderFinishedSemaphores_(std::move(other.renderFinishedSemaphores_)),
-    inFlightFences_(std::move(other.inFlightFences_)),
-    framebuffers_(std::move(other.framebuffers_)),
-    extraAttachments_(std::move(other.extraAttachments_))
-{
-    other.device_ = nullptr;
-    other.swapchain_ = nullptr;
-    other.renderPass_ = nullptr;
-    other.maxFramesInFlight_ = 0;
-    other.currentFrame_ = 0;
-    other.imageIndex_ = 0;
-    other.frameInProgress_ = false;
-    other.needsSwapchainRecreation_ = false;
-    other.extraAttachments_.clear();
-}
-
-Renderer& Renderer::operator=(Renderer&& other) noexcept {
-    if (this != &other) {
-        Cleanup();
-        device_ = other.device_;
-        swapchain_ = other.swapchain_;
-        renderPass_ = other.renderPass_;
-        maxFramesInFlight_ = other.maxFramesInFlight_;
-        currentFrame_ = other.currentFrame_;
-        imageIndex_ = other.imageIndex_;
-        frameInProgress_ = other.frameInProgress_;
-        needsSwapchainRecreation_ = other.needsSwapchainRecreation_;
-        commandPools_ = std::move(other.commandPools_);
-        commandBuffers_ = std::move(other.commandBuffers_);
-        computeCommandPools_ = std::move(other.computeCommandPools_);
-        computeCommandBuffers_ = std::move(other.computeCommandBuffers_);
-        imageAvailableSemaphores_ = std::move(other.imageAvailableSemaphores_);
-        renderFinishedSemaphores_ = std::move(other.renderFinishedSemaphores_);
-        inFlightFences_ = std::move(other.inFlightFences_);
-        framebuffers_ = std::move(other.framebuffers_);
-        extraAttachments_ = std::move(other.extraAttachments_);
-
-        other.device_ = nullptr;
-        other.swapchain_ = nullptr;
-        other.renderPass_ = nullptr;
-        other.maxFramesInFlight_ = 0;
-        other.currentFrame_ = 0;
-        other.imageIndex_ = 0;
-        other.frameInProgress_ = false;
-        other.needsSwapchainRecreation_ = false;
-        other.extraAttachments_.clear();
-    }
-    return *this;
+Renderer::~Renderer() {
+    Cleanup();
 }
 
 bool Renderer::BeginFrame()
 {
+    VULKAN_RAII_PROFILE_SCOPE("Renderer::BeginFrame");
     if (frameInProgress_) {
         return false;
     }
@@ -116,12 +194,52 @@ bool Renderer::BeginFrame()
     }
 
     VulkanEngine::RAII::Fence& fence = *inFlightFences_[currentFrame_];
-    fence.Wait();
+    // Frame N reuses the slot of frame N - maxFramesInFlight, and waits for frame
+    // N - framesInFlight, which finishes no earlier than that one
+    const uint64_t frame_value = GetFrameTimelineValue();
+    const Clock::time_point wait_start = Clock::now();
+    if (frameTimeline_) {
+        if (frame_value > framesInFlight_ &&
+            frameTimeline_->Wait(frame_value - framesInFlight_) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to wait for the frame timeline");
+        }
+    } else {
+        if (framesInFlight_ < maxFramesInFlight_ && frame_value > framesInFlight_) {
+            inFlightFences_[(currentFrame_ + maxFramesInFlight_ - framesInFlight_) % maxFramesInFlight_]->Wait();
+        }
+        fence.Wait();
+    }
+    const std::chrono::duration<double, std::milli> gpu_wait = Clock::now() - wait_start;
+    // Submissions complete in order, so every earlier frame has finished as well
+    if (frame_value > framesInFlight_) {
+        completedFrameValue_ = frame_value - framesInFlight_;
+    }
+    PacePresents();
+    PollDisplayTimings();
+    RecordFrameStart(wait_start, gpu_wait.count());
+    PollPresentFences();
+    ReleaseRetiredSwapchains();
+    // Objects dropped with Device::DeferDestroy during this frame retire with its value
+    DeferredDestructionQueue& deferred_destruction = device_->GetDeferredDestruction();
+    deferred_destruction.Collect(completedFrameValue_);
+    deferred_destruction.SetRecordingValue(frame_value);
+
+    // Everything submitted for this frame index has retired; let owners recycle per-frame resources
+    for (const auto& entry : frameBeginCallbacks_) {
+        entry.second(currentFrame_);
+    }
+    ResetSecondaryCommandBuffers();
     
+    // Headless rings hand out images without signalling; nothing waits for the acquire
+    const VkSemaphore acquire_semaphore = swapchain_->IsHeadless() ? VK_NULL_HANDLE : imageAvailableSemaphores_[currentFrame_]->GetHandle();
+    const Clock::time_point acquire_start = Clock::now();
     VkResult result = swapchain_->AcquireNextImage(std::numeric_limits<uint64_t>::max(),
-                                                    *imageAvailableSemaphores_[currentFrame_],
+                                                    acquire_semaphore,
                                                     VK_NULL_HANDLE,
                                                     imageIndex_);
+    const std::chrono::duration<double, std::milli> acquire_time = Clock::now() - acquire_start;
+    lastFrameTimings_.acquireMs = acquire_time.count();
+    frameTimings_.acquireMs = UpdateAverage(frameTimings_.acquireMs, acquire_time.count(), totalFrameCount_ + 1);
     
     if (result == VK_ERROR_OUT_OF_DATE_KHR || swapchain_->NeedsRecreate())
     {
@@ -136,14 +254,43 @@ bool Renderer::BeginFrame()
     }
 
     // only when we know we are going to do work, reset the fence
-    fence.Reset();
+    if (!frameTimeline_) {
+        fence.Reset();
+    }
     
+    // One pool-level reset per frame returns the frame's command buffers to the initial state
+    commandPools_[currentFrame_]->Reset();
     auto& command_buffer = *commandBuffers_[currentFrame_];
-    command_buffer.Reset();
     command_buffer.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-
+    command_buffer.AttachProfiler(gpuProfiler_, QueueType::GRAPHICS);
+    if (!splitCommandBuffers_.empty()) {
+        splitCommandBuffers_[currentFrame_]->AttachProfiler(gpuProfiler_, QueueType::GRAPHICS);
+    }
     if (!computeCommandBuffers_.empty()) {
-        computeCommandBuffers_[currentFrame_]->Reset();
+        computeCommandBuffers_[currentFrame_]->AttachProfiler(gpuProfiler_, QueueType::COMPUTE);
+    }
+    command_buffer.BeginZone(GPU_FRAME_ZONE);
+    if (tracyGpu_) {
+        // Tracy zones end in the command buffer they begin in: this one covers the
+        // primary command buffer, up to the split if there is one
+        tracyGpu_->Collect(command_buffer);
+        tracyGpu_->BeginZone(command_buffer, GPU_FRAME_ZONE);
+    }
+    graphicsSplit_ = false;
+    computeRecording_ = false;
+    pendingBufferAcquires_.clear();
+    pendingImageAcquires_.clear();
+
+    frameDamage_.clear();
+    if (dynamicRendering_) {
+        // No render pass does this for us; previous contents are discarded unless preserved
+        const bool keep_contents = preserveContents_ && imageRenderedFrame_[imageIndex_] != 0;
+        TransitionSwapchainImage(keep_contents ? swapchain_->GetPresentLayout() : VK_IMAGE_LAYOUT_UNDEFINED,
+                                 VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    }
+
+    if (!computeCommandPools_.empty()) {
+        computeCommandPools_[currentFrame_]->Reset();
     }
 
     frameInProgress_ = true;
@@ -152,41 +299,174 @@ bool Renderer::BeginFrame()
 
 bool Renderer::EndFrame()
 {
+    VULKAN_RAII_PROFILE_SCOPE("Renderer::EndFrame");
     if (!frameInProgress_ || !device_ || !swapchain_) {
         return false;
     }
 
-    auto& command_buffer = *commandBuffers_[currentFrame_];
-    command_buffer.End();
+    const ComputeSyncPoint sync_point = asyncComputeSync_.syncPoint;
+    if (computeRecording_ && sync_point == ComputeSyncPoint::AFTER_GEOMETRY && !graphicsSplit_) {
+        // Compute waits for everything recorded so far; the rest of the frame waits for compute
+        SplitGraphicsSubmission();
+    }
+    // OVERLAP_GEOMETRY without a split: the whole graphics submission waits for compute
+    FlushPendingAcquires(GetActiveGraphicsCommandBuffer());
 
-    // Wait on the same semaphore we used for acquire in begin_frame (per-frame indexing)
-    VkSemaphore wait_semaphores[] = {*imageAvailableSemaphores_[currentFrame_]};
-    VkPipelineStageFlags wait_stages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    // Signal the per-image render-finished semaphore; present will wait on this
-    VkSemaphore signal_semaphores[] = {*renderFinishedSemaphores_[imageIndex_]};
-
-    VkSubmitInfo submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO};
-    submit_info.waitSemaphoreCount = 1;
-    submit_info.pWaitSemaphores = wait_semaphores;
-    submit_info.pWaitDstStageMask = wait_stages;
-    submit_info.commandBufferCount = 1;
-    VkCommandBuffer raw_command_buffer = command_buffer.GetHandle();
-    submit_info.pCommandBuffers = &raw_command_buffer;
-    submit_info.signalSemaphoreCount = 1;
-    submit_info.pSignalSemaphores = signal_semaphores;
+    if (dynamicRendering_) {
+        TransitionSwapchainImage(VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, swapchain_->GetPresentLayout());
+    }
+    const bool headless = swapchain_->IsHeadless();
+    if (headless && frameReadback_) {
+        // The image is in TRANSFER_SRC_OPTIMAL now (final transition or render pass final layout)
+        const VkExtent2D extent = swapchain_->GetExtent();
+        VkBufferImageCopy region{};
+        region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+        region.imageExtent = {extent.width, extent.height, 1};
+        frameReadbackHandle_ = frameReadback_->ReadImage(GetActiveGraphicsCommandBuffer(), swapchain_->GetOffscreenImage(imageIndex_), region);
+    }
+    GetActiveGraphicsCommandBuffer().EndZone(); // GPU_FRAME_ZONE
+    if (tracyGpu_ && !graphicsSplit_) {
+        tracyGpu_->EndZone();
+    }
+    GetActiveGraphicsCommandBuffer().End();
+    if (computeRecording_) {
+        computeCommandBuffers_[currentFrame_]->End();
+    }
+    if (gpuProfiler_) {
+        gpuProfiler_->MarkSubmit();
+    }
 
+    const bool sync2 = device_->SupportsSynchronization2();
     VkQueue graphics_queue = device_->GetGraphicsQueue();
-    if (vkQueueSubmit(graphics_queue,
-                      1,
-                      &submit_info,
-                      *inFlightFences_[currentFrame_]) != VK_SUCCESS) {
+
+    VkCommandBufferSubmitInfoKHR command_buffer_infos[2] = {
+        {VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO_KHR},
+        {VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO_KHR}
+    };
+    command_buffer_infos[0].commandBuffer = commandBuffers_[currentFrame_]->GetHandle();
+    if (graphicsSplit_) {
+        command_buffer_infos[1].commandBuffer = splitCommandBuffers_[currentFrame_]->GetHandle();
+    }
+
+    // Wait on the same semaphore we used for acquire in begin_frame (per-frame indexing)
+    const VkSemaphoreSubmitInfoKHR acquire_wait_info = Utils::SyncUtils::CreateSemaphoreSubmitInfo(*imageAvailableSemaphores_[currentFrame_],
+                                                                                                   VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR);
+
+    // When compute waits for or overlaps the geometry segment, that segment goes first on its own
+    const bool separate_geometry = computeRecording_ && graphicsSplit_ && sync_point != ComputeSyncPoint::BEFORE_GEOMETRY;
+    if (separate_geometry) {
+        const VkSemaphoreSubmitInfoKHR geometry_signal_info = Utils::SyncUtils::CreateSemaphoreSubmitInfo(*geometryFinishedSemaphores_[currentFrame_],
+                                                                                                          VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR);
+        VkSubmitInfo2KHR geometry_submit{VK_STRUCTURE_TYPE_SUBMIT_INFO_2_KHR};
+        geometry_submit.waitSemaphoreInfoCount = headless ? 0 : 1;
+        geometry_submit.pWaitSemaphoreInfos = &acquire_wait_info;
+        geometry_submit.commandBufferInfoCount = 1;
+        geometry_submit.pCommandBufferInfos = &command_buffer_infos[0];
+        if (sync_point == ComputeSyncPoint::AFTER_GEOMETRY) {
+            geometry_submit.signalSemaphoreInfoCount = 1;
+            geometry_submit.pSignalSemaphoreInfos = &geometry_signal_info;
+        }
+        if (SubmitLocked(*device_, graphics_queue, geometry_submit, VK_NULL_HANDLE, sync2) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to submit geometry command buffer");
+        }
+    }
+
+    if (computeRecording_) {
+        const VkSemaphoreSubmitInfoKHR geometry_wait_info = Utils::SyncUtils::CreateSemaphoreSubmitInfo(*geometryFinishedSemaphores_[currentFrame_],
+                                                                                                        asyncComputeSync_.computeWaitStages);
+        const VkSemaphoreSubmitInfoKHR compute_signal_info = Utils::SyncUtils::CreateSemaphoreSubmitInfo(*computeFinishedSemaphores_[currentFrame_],
+                                                                                                         VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR);
+        VkCommandBufferSubmitInfoKHR compute_buffer_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO_KHR};
+        compute_buffer_info.commandBuffer = computeCommandBuffers_[currentFrame_]->GetHandle();
+
+        VkSubmitInfo2KHR compute_submit{VK_STRUCTURE_TYPE_SUBMIT_INFO_2_KHR};
+        if (sync_point == ComputeSyncPoint::AFTER_GEOMETRY) {
+            compute_submit.waitSemaphoreInfoCount = 1;
+            compute_submit.pWaitSemaphoreInfos = &geometry_wait_info;
+        }
+        compute_submit.commandBufferInfoCount = 1;
+        compute_submit.pCommandBufferInfos = &compute_buffer_info;
+        compute_submit.signalSemaphoreInfoCount = 1;
+        compute_submit.pSignalSemaphoreInfos = &compute_signal_info;
+        if (SubmitLocked(*device_, device_->GetComputeQueue(), compute_submit, VK_NULL_HANDLE, sync2) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to submit compute command buffer");
+        }
+    }
+
+    // The last graphics submission waits for acquire (unless the geometry segment did) and compute
+    VkSemaphoreSubmitInfoKHR wait_infos[2]{};
+    uint32_t wait_count = 0;
+    if (!separate_geometry && !headless) {
+        wait_infos[wait_count++] = acquire_wait_info;
+    }
+    if (computeRecording_) {
+        wait_infos[wait_count++] = Utils::SyncUtils::CreateSemaphoreSubmitInfo(*computeFinishedSemaphores_[currentFrame_],
+                                                                               asyncComputeSync_.graphicsWaitStages);
+    }
+    // Signal the per-image render-finished semaphore; present will wait on this (headless
+    // presents wait on nothing). Timeline pacing signals the frame value alongside it
+    VkSemaphoreSubmitInfoKHR signal_infos[2]{};
+    uint32_t signal_count = 0;
+    if (!headless) {
+        signal_infos[signal_count++] = Utils::SyncUtils::CreateSemaphoreSubmitInfo(*renderFinishedSemaphores_[imageIndex_],
+                                                                                   VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR);
+    }
+
+    VkSubmitInfo2KHR submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO_2_KHR};
+    submit_info.waitSemaphoreInfoCount = wait_count;
+    submit_info.pWaitSemaphoreInfos = wait_infos;
+    if (separate_geometry) {
+        submit_info.commandBufferInfoCount = 1;
+        submit_info.pCommandBufferInfos = &command_buffer_infos[1];
+    } else {
+        submit_info.commandBufferInfoCount = graphicsSplit_ ? 2 : 1;
+        submit_info.pCommandBufferInfos = command_buffer_infos;
+    }
+    VkFence submit_fence = *inFlightFences_[currentFrame_];
+    if (frameTimeline_) {
+        signal_infos[signal_count++] = Utils::SyncUtils::CreateSemaphoreSubmitInfo(frameTimeline_->GetHandle(),
+                                                                                   VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR,
+                                                                                   GetFrameTimelineValue());
+        submit_fence = VK_NULL_HANDLE;
+    }
+    submit_info.signalSemaphoreInfoCount = signal_count;
+    submit_info.pSignalSemaphoreInfos = signal_infos;
+
+    if (latencyTracker_) {
+        latencyTracker_->Mark(GetFrameTimelineValue(), Utils::LatencyTracker::Marker::RENDER_SUBMIT);
+    }
+    if (SubmitLocked(*device_, graphics_queue, submit_info, submit_fence, sync2) != VK_SUCCESS) {
         throw std::runtime_error("Failed to submit draw command buffer");
     }
+    computeRecording_ = false;
 
     // Present waits on the semaphore signaled by the submit above (per-image indexing)
-    std::vector<VkSemaphore> wait_sem{*renderFinishedSemaphores_[imageIndex_]};
+    std::vector<VkSemaphore> wait_sem;
+    if (!headless) {
+        wait_sem.push_back(*renderFinishedSemaphores_[imageIndex_]);
+    }
     VkQueue present_queue = device_->GetPresentQueue();
-    VkResult present_result = swapchain_->Present(wait_sem, imageIndex_, present_queue);
+    // Frame values double as present ids: unique and increasing
+    const bool present_wait = swapchain_->SupportsPresentWait();
+    const uint64_t present_id = present_wait || swapchain_->SupportsDisplayTiming() ? GetFrameTimelineValue() : 0;
+    // Present fences let retired swapchains go as soon as the presentation engine is done
+    const VkFence present_fence = !headless && device_->SupportsSwapchainMaintenance1() ? AcquirePresentFence() : VK_NULL_HANDLE;
+    // Damage is relative to the previous present, which is the previous frame
+    std::vector<VkRectLayerKHR> present_damage;
+    present_damage.reserve(frameDamage_.size());
+    for (const VkRect2D& rect : frameDamage_) {
+        present_damage.push_back({rect.offset, rect.extent, 0});
+    }
+    RecordFrameDamage();
+    VkResult present_result = swapchain_->Present(wait_sem, imageIndex_, present_queue, present_id, present_fence, present_damage);
+    if (present_result == VK_SUCCESS || present_result == VK_SUBOPTIMAL_KHR) {
+        if (present_wait) {
+            pendingPresents_.emplace_back(present_id, frameStart_);
+        }
+        if (latencyTracker_) {
+            latencyTracker_->Mark(GetFrameTimelineValue(), Utils::LatencyTracker::Marker::PRESENT);
+        }
+    }
 
     // std::cout << "present_result: " << present_result << " needSwapchainRecreation_: " << needsSwapchainRecreation_ << " swapchain_->needs_recreate(): " << swapchain_->NeedsRecreate() << '\n';
     if (present_result == VK_ERROR_OUT_OF_DATE_KHR || needsSwapchainRecreation_ || swapchain_->NeedsRecreate()) {
@@ -210,17 +490,287 @@ bool Renderer::EndFrame()
         throw std::runtime_error("Failed to present swapchain image");
     }
 
+    if (Utils::Profiler::IsEnabled()) {
+        CollectProfilerFrame();
+    }
+    VULKAN_RAII_TRACY_FRAME_MARK();
+
     frameInProgress_ = false;
     currentFrame_ = (currentFrame_ + 1) % maxFramesInFlight_;
     totalFrameCount_++;
     return !needsSwapchainRecreation_;
 }
 
+void Renderer::SetFrameReadback(ReadbackManager* readback)
+{
+    if (frameInProgress_) {
+        throw std::logic_error("SetFrameReadback must be called outside a frame");
+    }
+    if (readback && !swapchain_->IsHeadless()) {
+        throw std::logic_error("Frame readback requires a headless swapchain");
+    }
+    frameReadback_ = readback;
+    frameReadbackHandle_ = {};
+}
+
+void Renderer::AddFrameDamage(const VkRect2D& rect)
+{
+    AddFrameDamage(std::span<const VkRect2D>(&rect, 1));
+}
+
+void Renderer::AddFrameDamage(std::span<const VkRect2D> rects)
+{
+    if (!frameInProgress_) {
+        throw std::logic_error("AddFrameDamage must be called during a frame");
+    }
+    const VkExtent2D extent = swapchain_->GetExtent();
+    for (const VkRect2D& rect : rects) {
+        const VkRect2D clipped = ClipRect(rect, extent);
+        if (clipped.extent.width != 0 && clipped.extent.height != 0) {
+            frameDamage_.push_back(clipped);
+        }
+    }
+}
+
+VkRect2D Renderer::GetRepaintBounds() const
+{
+    VkRect2D full{};
+    full.extent = swapchain_ != nullptr ? swapchain_->GetExtent() : VkExtent2D{0, 0};
+    if (!frameInProgress_ || !preserveContents_ || frameDamage_.empty()) {
+        return full;
+    }
+    const uint64_t rendered = imageRenderedFrame_[imageIndex_];
+    // The history must reach back to the frame after the image's last render
+    if (rendered == 0 || damageHistory_.empty() || damageHistory_.front().first > rendered + 1) {
+        return full;
+    }
+
+    VkRect2D bounds{};
+    for (const VkRect2D& rect : frameDamage_) {
+        bounds = UnionRect(bounds, rect);
+    }
+    for (const auto& entry : damageHistory_) {
+        if (entry.first > rendered) {
+            bounds = UnionRect(bounds, entry.second);
+        }
+    }
+    return bounds;
+}
+
+void Renderer::SetRepaintScissor()
+{
+    if (!frameInProgress_) {
+        throw std::runtime_error("No frame in progress");
+    }
+    GetActiveGraphicsCommandBuffer().SetScissor(GetRepaintBounds());
+}
+
+void Renderer::CollectProfilerFrame()
+{
+    // Each resolved GPU frame is merged once, into the CPU frame that sees it first
+    std::vector<Utils::Profiler::GpuZone> gpu_zones;
+    if (gpuProfiler_ && gpuProfiler_->GetResolvedFrameCount() != profiledGpuFrames_) {
+        profiledGpuFrames_ = gpuProfiler_->GetResolvedFrameCount();
+        const uint64_t submit_ns = gpuProfiler_->GetResultsSubmitNs();
+        for (const GpuProfiler::Zone& zone : gpuProfiler_->GetResults()) {
+            Utils::Profiler::GpuZone& gpu_zone = gpu_zones.emplace_back();
+            gpu_zone.name = zone.name;
+            gpu_zone.track = QueueTrackName(zone.queue);
+            gpu_zone.depth = zone.depth;
+            gpu_zone.startNs = submit_ns + static_cast<uint64_t>(zone.startMs * 1'000'000.0);
+            gpu_zone.durationNs = static_cast<uint64_t>(zone.durationMs * 1'000'000.0);
+        }
+    }
+    Utils::Profiler::Instance().CollectFrame(GetFrameTimelineValue(), gpu_zones);
+}
+
+void Renderer::RecordFrameDamage()
+{
+    VkRect2D bounds{};
+    bounds.extent = swapchain_->GetExtent();
+    if (!frameDamage_.empty()) {
+        bounds = {};
+        for (const VkRect2D& rect : frameDamage_) {
+            bounds = UnionRect(bounds, rect);
+        }
+    }
+    const uint64_t frame_value = GetFrameTimelineValue();
+    damageHistory_.emplace_back(frame_value, bounds);
+    imageRenderedFrame_[imageIndex_] = frame_value;
+    frameDamage_.clear();
+
+    // An image is re-acquired at most every image-count frames in practice; older
+    // entries make GetRepaintBounds fall back to the full extent
+    const size_t max_history = 2 * imageRenderedFrame_.size();
+    while (damageHistory_.size() > max_history) {
+        damageHistory_.pop_front();
+    }
+}
+
+void Renderer::ResetDamageHistory()
+{
+    // New images have no contents worth keeping
+    damageHistory_.clear();
+    imageRenderedFrame_.assign(swapchain_->GetImageCount(), 0);
+}
+
+void Renderer::SetLatencyMode(Swapchain::LatencyMode mode)
+{
+    if (frameInProgress_) {
+        throw std::logic_error("SetLatencyMode must be called outside a frame");
+    }
+    latencyMode_ = mode;
+    swapchain_->SetLatencyMode(mode);
+}
+
+void Renderer::PacePresents()
+{
+    const size_t depth = GetPresentQueueDepth(latencyMode_);
+    while (!pendingPresents_.empty()) {
+        // Wait while too many frames are queued; otherwise only collect finished presents
+        const bool pace = depth > 0 && pendingPresents_.size() >= depth;
+        const auto& [present_id, frame_start] = pendingPresents_.front();
+        const VkResult result = swapchain_->WaitForPresent(present_id, pace ? PRESENT_WAIT_TIMEOUT_NS : 0);
+        if (result == VK_TIMEOUT) {
+            break;
+        }
+        if (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR) {
+            if (latencyTracker_ && !swapchain_->SupportsDisplayTiming()) {
+                latencyTracker_->Mark(present_id, Utils::LatencyTracker::Marker::DISPLAY);
+            }
+            const std::chrono::duration<double, std::milli> latency = Clock::now() - frame_start;
+            latencyStats_.timedFrames++;
+            latencyStats_.lastMs = latency.count();
+            latencyStats_.averageMs = UpdateAverage(latencyStats_.averageMs, latency.count(), latencyStats_.timedFrames);
+        }
+        // Other results (out of date, surface lost) mean the present will never be timed
+        pendingPresents_.pop_front();
+    }
+}
+
+void Renderer::PollDisplayTimings()
+{
+    if (!latencyTracker_ || !swapchain_->SupportsDisplayTiming()) {
+        return;
+    }
+    const uint64_t newest = GetFrameTimelineValue();
+    for (const VkPastPresentationTimingGOOGLE& timing : swapchain_->GetPastPresentationTimings()) {
+        // Present ids are frame values truncated to 32 bits; recent frames recover the rest
+        uint64_t frame_value = (newest & ~uint64_t{0xFFFFFFFF}) | timing.presentID;
+        if (frame_value > newest && frame_value > uint64_t{0xFFFFFFFF}) {
+            frame_value -= uint64_t{1} << 32;
+        }
+        const Clock::time_point display_time{std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(timing.actualPresentTime))};
+        latencyTracker_->Mark(frame_value, Utils::LatencyTracker::Marker::DISPLAY, display_time);
+    }
+}
+
+void Renderer::PollPresentFences()
+{
+    // Rejected presents (out of date, surface lost) still signal their fence
+    while (!pendingPresentFences_.empty() && pendingPresentFences_.front().second->GetStatus() == VK_SUCCESS) {
+        presentedFrameValue_ = pendingPresentFences_.front().first;
+        pendingPresentFences_.pop_front(); // The lease resets the fence and returns it to the pool
+    }
+}
+
+void Renderer::ReleaseRetiredSwapchains()
+{
+    const bool present_fences = !swapchain_->IsHeadless() && device_->SupportsSwapchainMaintenance1();
+    while (!retiredSwapchains_.empty()) {
+        const uint64_t last_frame = retiredSwapchains_.front().lastFrameValue;
+        // Without present fences nothing reports when the presentation engine lets go of
+        // the old images; one more retired frame after the last present is the usual margin
+        const bool released = present_fences ? completedFrameValue_ >= last_frame && presentedFrameValue_ >= last_frame
+                                             : completedFrameValue_ > last_frame;
+        if (!released) {
+            break;
+        }
+        retiredSwapchains_.pop_front();
+    }
+}
+
+VkFence Renderer::AcquirePresentFence()
+{
+    FencePool::Lease fence = fencePool_->Acquire();
+    const VkFence handle = *fence;
+    pendingPresentFences_.emplace_back(GetFrameTimelineValue(), std::move(fence));
+    return handle;
+}
+
+void Renderer::RecordFrameStart(Clock::time_point wait_start, double gpu_wait_ms)
+{
+    const Clock::time_point now = Clock::now();
+    if (totalFrameCount_ > 0) {
+        const std::chrono::duration<double, std::milli> interval = now - frameStart_;
+        const std::chrono::duration<double, std::milli> cpu = wait_start - frameStart_;
+        latencyStats_.frameIntervalMs = UpdateAverage(latencyStats_.frameIntervalMs, interval.count(), totalFrameCount_);
+        frameTimings_.cpuMs = UpdateAverage(frameTimings_.cpuMs, cpu.count(), totalFrameCount_);
+        frameTimings_.gpuWaitMs = UpdateAverage(frameTimings_.gpuWaitMs, gpu_wait_ms, totalFrameCount_);
+        lastFrameTimings_.cpuMs = cpu.count();
+        lastFrameTimings_.gpuWaitMs = gpu_wait_ms;
+        UpdateAdaptiveDepth(cpu.count(), gpu_wait_ms);
+    }
+    frameStart_ = now;
+}
+
+void Renderer::SetFramesInFlight(uint32_t depth)
+{
+    if (frameInProgress_) {
+        throw std::logic_error("SetFramesInFlight must be called outside a frame");
+    }
+    if (depth == 0 || depth > maxFramesInFlight_) {
+        throw std::out_of_range("Frames in flight must be between 1 and GetMaxFramesInFlight()");
+    }
+    framesInFlight_ = depth;
+}
+
+void Renderer::EnableAdaptiveFramesInFlight(const AdaptiveFramesInFlight& policy)
+{
+    const uint32_t max_depth = policy.maxDepth == 0 ? maxFramesInFlight_ : policy.maxDepth;
+    if (policy.minDepth == 0 || policy.minDepth > max_depth || max_depth > maxFramesInFlight_) {
+        throw std::out_of_range("Adaptive frames in flight bounds must lie within 1..GetMaxFramesInFlight()");
+    }
+    if (policy.sampleFrames == 0 || policy.lowerWaitRatio >= policy.raiseWaitRatio) {
+        throw std::invalid_argument("Adaptive frames in flight needs sample frames and lowerWaitRatio < raiseWaitRatio");
+    }
+    adaptivePolicy_ = policy;
+    adaptivePolicy_.maxDepth = max_depth;
+    adaptiveDepth_ = true;
+    adaptiveCpuMs_ = 0.0;
+    adaptiveWaitMs_ = 0.0;
+    adaptiveSamples_ = 0;
+    framesInFlight_ = std::clamp(framesInFlight_, adaptivePolicy_.minDepth, adaptivePolicy_.maxDepth);
+}
+
+void Renderer::UpdateAdaptiveDepth(double cpu_ms, double gpu_wait_ms)
+{
+    if (!adaptiveDepth_) {
+        return;
+    }
+    adaptiveCpuMs_ += cpu_ms;
+    adaptiveWaitMs_ += gpu_wait_ms;
+    if (++adaptiveSamples_ < adaptivePolicy_.sampleFrames) {
+        return;
+    }
+
+    const double total_ms = adaptiveCpuMs_ + adaptiveWaitMs_;
+    const double wait_ratio = total_ms > 0.0 ? adaptiveWaitMs_ / total_ms : 0.0;
+    if (wait_ratio > adaptivePolicy_.raiseWaitRatio && framesInFlight_ < adaptivePolicy_.maxDepth) {
+        framesInFlight_++;
+    } else if (wait_ratio < adaptivePolicy_.lowerWaitRatio && framesInFlight_ > adaptivePolicy_.minDepth) {
+        framesInFlight_--;
+    }
+    adaptiveCpuMs_ = 0.0;
+    adaptiveWaitMs_ = 0.0;
+    adaptiveSamples_ = 0;
+}
+
 CommandBuffer& Renderer::GetCurrentCommandBuffer() {
     if (!frameInProgress_) {
         throw std::runtime_error("No frame in progress");
     }
-    return *commandBuffers_[currentFrame_];
+    return GetActiveGraphicsCommandBuffer();
 }
 
 CommandBuffer& Renderer::GetCurrentComputeCommandBuffer() {
@@ -230,12 +780,288 @@ CommandBuffer& Renderer::GetCurrentComputeCommandBuffer() {
     if (computeCommandBuffers_.empty()) {
         throw std::runtime_error("Compute command buffers are not available for this renderer");
     }
-    return *computeCommandBuffers_[currentFrame_];
+    CommandBuffer& command_buffer = *computeCommandBuffers_[currentFrame_];
+    if (!computeRecording_) {
+        command_buffer.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+        computeRecording_ = true;
+    }
+    return command_buffer;
+}
+
+void Renderer::SetAsyncComputeSync(const AsyncComputeSync& sync)
+{
+    if (frameInProgress_) {
+        throw std::runtime_error("Async compute synchronization cannot change during a frame");
+    }
+    if (sync.graphicsWaitStages == VK_PIPELINE_STAGE_2_NONE_KHR || sync.computeWaitStages == VK_PIPELINE_STAGE_2_NONE_KHR) {
+        throw std::invalid_argument("Async compute wait stages must not be empty");
+    }
+    asyncComputeSync_ = sync;
+}
+
+void Renderer::SplitGraphicsSubmission()
+{
+    if (!frameInProgress_) {
+        throw std::runtime_error("No frame in progress");
+    }
+    if (graphicsSplit_) {
+        throw std::logic_error("The graphics submission is already split this frame");
+    }
+
+    CommandBuffer& geometry = *commandBuffers_[currentFrame_];
+    if (!dynamicRendering_) {
+        // Carry the acquire wait (made in the geometry submission) over to the render pass after the split;
+        // dynamic rendering gets this from the swapchain image transition recorded in BeginFrame
+        VkMemoryBarrier2KHR barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER_2_KHR};
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR;
+        geometry.PipelineBarrier2(std::span<const VkMemoryBarrier2KHR>(&barrier, 1));
+    }
+    if (tracyGpu_) {
+        tracyGpu_->EndZone();
+    }
+    geometry.End();
+
+    CommandBuffer& split = *splitCommandBuffers_[currentFrame_];
+    split.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    graphicsSplit_ = true;
+    FlushPendingAcquires(split);
+}
+
+void Renderer::TransferOwnership(Buffer& buffer,
+                                 QueueType destination,
+                                 const ResourceAccess& source_access,
+                                 const ResourceAccess& destination_access)
+{
+    VkBufferMemoryBarrier2KHR barrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR};
+    barrier.srcStageMask = source_access.stages;
+    barrier.srcAccessMask = source_access.access;
+    barrier.dstStageMask = destination_access.stages;
+    barrier.dstAccessMask = destination_access.access;
+    barrier.buffer = buffer.GetHandle();
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+    RecordOwnershipTransfer(destination, &barrier, nullptr);
+
+    // The acquire already made the destination stages wait; a writing destination is the last write
+    buffer.SetTrackedState(BarrierBatcher::GetStateAfter(destination_access));
+}
+
+void Renderer::TransferOwnership(Image& image,
+                                 QueueType destination,
+                                 const ResourceAccess& source_access,
+                                 const ResourceAccess& destination_access)
+{
+    TransferOwnership(image,
+                      destination,
+                      source_access,
+                      destination_access,
+                      Utils::ImageUtils::CreateSubresourceRange(Utils::ImageUtils::GetImageAspectFlags(image.GetFormat())));
+}
+
+void Renderer::TransferOwnership(Image& image,
+                                 QueueType destination,
+                                 const ResourceAccess& source_access,
+                                 const ResourceAccess& destination_access,
+                                 const VkImageSubresourceRange& range)
+{
+    VkImageMemoryBarrier2KHR barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR};
+    barrier.srcStageMask = source_access.stages;
+    barrier.srcAccessMask = source_access.access;
+    barrier.dstStageMask = destination_access.stages;
+    barrier.dstAccessMask = destination_access.access;
+    barrier.oldLayout = source_access.layout;
+    barrier.newLayout = destination_access.layout;
+    barrier.image = image.GetHandle();
+    barrier.subresourceRange = range;
+    RecordOwnershipTransfer(destination, nullptr, &barrier);
+
+    image.SetTrackedState(BarrierBatcher::GetStateAfter(destination_access),
+                          range.baseMipLevel, range.levelCount, range.baseArrayLayer, range.layerCount);
+}
+
+void Renderer::BeginSwapchainRendering(const VkClearColorValue& clear_color,
+                                       const VkRenderingAttachmentInfoKHR* depth_attachment,
+                                       VkRenderingFlagsKHR flags)
+{
+    if (!frameInProgress_) {
+        throw std::runtime_error("No frame in progress");
+    }
+    if (!dynamicRendering_) {
+        throw std::runtime_error("Swapchain rendering requires a dynamic rendering renderer");
+    }
+
+    VkRenderingAttachmentInfoKHR color_attachment{VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR};
+    color_attachment.imageView = swapchain_->GetImageViews()[imageIndex_];
+    color_attachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    color_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    color_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    color_attachment.clearValue.color = clear_color;
+
+    // With preserved contents everything outside the repaint bounds is kept as is
+    const VkRect2D render_area = GetRepaintBounds();
+    GetActiveGraphicsCommandBuffer().BeginRendering(render_area,
+                                                    std::span<const VkRenderingAttachmentInfoKHR>(&color_attachment, 1),
+                                                    depth_attachment,
+                                                    nullptr,
+                                                    flags);
+}
+
+void Renderer::EndSwapchainRendering()
+{
+    if (!frameInProgress_) {
+        throw std::runtime_error("No frame in progress");
+    }
+    GetActiveGraphicsCommandBuffer().EndRendering();
+}
+
+void Renderer::SetRecordingThreadCount(uint32_t thread_count, VkFormat depth_format)
+{
+    if (frameInProgress_) {
+        throw std::runtime_error("Recording threads cannot change during a frame");
+    }
+    if (!device_) {
+        throw std::runtime_error("Renderer requires a valid device");
+    }
+    const uint32_t graphics_family = device_->GetQueueFamilyIndices().graphicsFamily_.value();
+
+    WaitIdle();
+    recordingThreads_.clear();
+    recordingThreads_.resize(thread_count);
+    for (RecordingThread& thread : recordingThreads_) {
+        thread.allocator = std::make_unique<FrameCommandAllocator>(*device_, graphics_family, maxFramesInFlight_);
+    }
+    secondaryDepthFormat_ = depth_format;
+}
+
+CommandBuffer& Renderer::BeginSecondaryCommandBuffer(uint32_t thread_index, uint32_t sort_key)
+{
+    if (!frameInProgress_) {
+        throw std::runtime_error("No frame in progress");
+    }
+
+    SecondaryInheritance inheritance;
+    FillSecondaryInheritance(inheritance);
+    return BeginSecondaryCommandBuffer(thread_index,
+                                       sort_key,
+                                       inheritance.info,
+                                       VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT);
+}
+
+void Renderer::FillSecondaryInheritance(SecondaryInheritance& inheritance, bool include_framebuffer) const
+{
+    inheritance = SecondaryInheritance{};
+    if (dynamicRendering_) {
+        inheritance.colorFormat = swapchain_->GetImageFormat();
+        inheritance.rendering.colorAttachmentCount = 1;
+        inheritance.rendering.pColorAttachmentFormats = &inheritance.colorFormat;
+        if (Utils::FormatUtils::IsDepthFormat(secondaryDepthFormat_)) {
+            inheritance.rendering.depthAttachmentFormat = secondaryDepthFormat_;
+        }
+        if (Utils::FormatUtils::IsStencilFormat(secondaryDepthFormat_)) {
+            inheritance.rendering.stencilAttachmentFormat = secondaryDepthFormat_;
+        }
+        inheritance.rendering.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+        inheritance.info.pNext = &inheritance.rendering;
+        return;
+    }
+
+    inheritance.info.renderPass = renderPass_->GetHandle();
+    inheritance.info.subpass = 0;
+    if (include_framebuffer) {
+        if (imageIndex_ >= framebuffers_.size()) {
+            throw std::runtime_error("Renderer has no framebuffer for the current swapchain image");
+        }
+        inheritance.info.framebuffer = framebuffers_[imageIndex_]->GetHandle();
+    }
+}
+
+CommandBuffer& Renderer::BeginSecondaryCommandBuffer(uint32_t thread_index,
+                                                     uint32_t sort_key,
+                                                     const VkCommandBufferInheritanceInfo& inheritance_info,
+                                                     VkCommandBufferUsageFlags usage_flags)
+{
+    if (!frameInProgress_) {
+        throw std::runtime_error("No frame in progress");
+    }
+    if (thread_index >= recordingThreads_.size()) {
+        throw std::invalid_argument("Recording thread index out of range (see SetRecordingThreadCount)");
+    }
+
+    RecordingThread& thread = recordingThreads_[thread_index];
+    CommandBuffer& command_buffer = thread.allocator->Allocate(VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+    thread.recorded.emplace_back(sort_key, command_buffer.GetHandle());
+
+    command_buffer.Begin(usage_flags, &inheritance_info);
+    return command_buffer;
+}
+
+void Renderer::ExecuteSecondaryCommandBuffers()
+{
+    if (!frameInProgress_) {
+        throw std::runtime_error("No frame in progress");
+    }
+
+    // Gathered in (thread, begin order), so a stable sort on the key gives the full order
+    std::vector<std::pair<uint32_t, VkCommandBuffer>> recorded;
+    for (RecordingThread& thread : recordingThreads_) {
+        recorded.insert(recorded.end(), thread.recorded.begin() + static_cast<std::ptrdiff_t>(thread.executed), thread.recorded.end());
+        thread.executed = thread.recorded.size();
+    }
+    std::stable_sort(recorded.begin(), recorded.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+
+    std::vector<VkCommandBuffer> command_buffers;
+    command_buffers.reserve(recorded.size());
+    for (const auto& entry : recorded) {
+        command_buffers.push_back(entry.second);
+    }
+    GetActiveGraphicsCommandBuffer().ExecuteCommands(command_buffers);
+}
+
+void Renderer::EnableTimelinePacing()
+{
+    if (frameInProgress_) {
+        throw std::runtime_error("Frame pacing cannot change during a frame");
+    }
+    if (!device_ || !device_->SupportsTimelineSemaphores()) {
+        throw std::runtime_error("Timeline pacing requires timeline semaphore support");
+    }
+    if (frameTimeline_) {
+        return;
+    }
+    // Frames so far were paced by fences; start the timeline at the last recorded frame
+    WaitIdle();
+    frameTimeline_ = std::make_unique<Semaphore>(*device_, totalFrameCount_);
+}
+
+uint64_t Renderer::GetCompletedFrameValue() const
+{
+    if (!frameTimeline_) {
+        throw std::runtime_error("Completed frame values require timeline pacing");
+    }
+    return frameTimeline_->GetCounterValue();
+}
+
+FrameBeginSubscription Renderer::SubscribeFrameBegin(FrameCallback callback) {
+    if (!callback) {
+        throw std::invalid_argument("Frame begin callback must not be empty");
+    }
+    const uint32_t id = nextCallbackId_++;
+    frameBeginCallbacks_.emplace_back(id, std::move(callback));
+    return FrameBeginSubscription(*this, id);
+}
+
+void Renderer::RemoveFrameBeginCallback(uint32_t callback_id) {
+    std::erase_if(frameBeginCallbacks_, [callback_id](const auto& entry) {
+        return entry.first == callback_id;
+    });
 }
 
 void Renderer::WaitIdle() {
     if (device_) {
-        vkDeviceWaitIdle(device_->GetHandle());
+        device_->WaitIdle(); // Also destroys the deferred objects
     }
 }
 
@@ -254,15 +1080,45 @@ void Renderer::RebuildFramebuffers() {
 
 void Renderer::Recreate(bool recreate_semaphores)
 {
-    WaitIdle();
-    // recreate swapchain
-    swapchain_->Recreate();
-    // recreate semaphore sync objects if requested
+    // No device idle: frames in flight keep using the old swapchain's resources, which
+    // stay alive until the last frame recorded against them (the one being ended, or
+    // the last one submitted) has retired
+    RetiredSwapchainResources retired;
+    retired.lastFrameValue = frameInProgress_ ? GetFrameTimelineValue() : totalFrameCount_;
+    retired.swapchain = swapchain_->Recreate();
+    if (!retired.swapchain.IsValid()) {
+        return; // Nothing was recreated (e.g. minimized window)
+    }
+    swapchainGeneration_++;
+    ResetDamageHistory();
+    // Present ids belong to the old swapchain and can no longer be waited on
+    pendingPresents_.clear();
+
+    // Present semaphores may still be waited on by queued presents of the old images, so
+    // they are always replaced; acquire semaphores only if requested
+    const uint32_t image_count = swapchain_->GetImageCount();
+    retired.semaphores = std::move(renderFinishedSemaphores_);
+    renderFinishedSemaphores_.clear();
     if (recreate_semaphores) {
-        RecreateSemaphoreSyncObjects(swapchain_->GetImageCount());
+        for (auto& semaphore : imageAvailableSemaphores_) {
+            retired.semaphores.push_back(std::move(semaphore));
+        }
+        RecreateSemaphoreSyncObjects(image_count);
+    } else {
+        renderFinishedSemaphores_.reserve(image_count);
+        for (uint32_t i = 0; i < image_count; ++i) {
+            renderFinishedSemaphores_.push_back(semaphorePool_->Acquire());
+        }
     }
-    // create new framebuffers
-    CreateFramebuffers();
+
+    // create new framebuffers (dynamic rendering only needs the new images)
+    if (dynamicRendering_) {
+        swapchainImages_ = swapchain_->GetImages();
+    } else {
+        retired.framebuffers = std::move(framebuffers_);
+        CreateFramebuffers();
+    }
+    retiredSwapchains_.push_back(std::move(retired));
 }
 
 void Renderer::RecreateSemaphoreSyncObjects(uint32_t num_of_swapchain_images)
@@ -278,16 +1134,21 @@ void Renderer::RecreateSemaphoreSyncObjects(uint32_t num_of_swapchain_images)
     imageAvailableSemaphores_.reserve(maxFramesInFlight_);
     renderFinishedSemaphores_.reserve(num_of_swapchain_images);
 
+    // Acquire semaphores are per frame in flight, render-finished ones per image; either count may be larger
+    for (uint32_t i = 0; i < maxFramesInFlight_; ++i) {
+        imageAvailableSemaphores_.push_back(semaphorePool_->Acquire());
+    }
     for (uint32_t i = 0; i < num_of_swapchain_images; ++i) {
-        renderFinishedSemaphores_.push_back(std::make_unique<Semaphore>(*device_));
-        if (i < maxFramesInFlight_) {
-            imageAvailableSemaphores_.push_back(std::make_unique<Semaphore>(*device_));
-        }
+        renderFinishedSemaphores_.push_back(semaphorePool_->Acquire());
     }
 }
 
 void Renderer::CreateSyncObjects(uint32_t num_of_swapchain_images)
 {
+    if (!semaphorePool_) {
+        semaphorePool_ = std::make_unique<SemaphorePool>(*device_);
+        fencePool_ = std::make_unique<FencePool>(*device_);
+    }
     imageAvailableSemaphores_.clear();
     renderFinishedSemaphores_.clear();
     inFlightFences_.clear();
@@ -296,12 +1157,14 @@ void Renderer::CreateSyncObjects(uint32_t num_of_swapchain_images)
     renderFinishedSemaphores_.reserve(num_of_swapchain_images);
     inFlightFences_.reserve(maxFramesInFlight_);
 
+    // Per frame in flight, independent of the image count, which may be smaller
+    for (uint32_t i = 0; i < maxFramesInFlight_; ++i) {
+        imageAvailableSemaphores_.push_back(semaphorePool_->Acquire());
+        inFlightFences_.push_back(std::make_unique<Fence>(*device_, VK_FENCE_CREATE_SIGNALED_BIT));
+    }
+    // Per swapchain image: present waits on the one signaled for the image it shows
     for (uint32_t i = 0; i < num_of_swapchain_images; ++i) {
-        renderFinishedSemaphores_.push_back(std::make_unique<Semaphore>(*device_));
-        if (i < maxFramesInFlight_) {
-            imageAvailableSemaphores_.push_back(std::make_unique<Semaphore>(*device_));
-            inFlightFences_.push_back(std::make_unique<Fence>(*device_, VK_FENCE_CREATE_SIGNALED_BIT));
-        }
+        renderFinishedSemaphores_.push_back(semaphorePool_->Acquire());
     }
 }
 
@@ -316,20 +1179,28 @@ void Renderer::CreateCommandObjects()
         throw std::runtime_error("Renderer requires graphics queue family");
     }
 
+    splitCommandBuffers_.clear();
     commandPools_.clear();
     commandBuffers_.clear();
     computeCommandPools_.clear();
     computeCommandBuffers_.clear();
+    computeFinishedSemaphores_.clear();
+    geometryFinishedSemaphores_.clear();
 
     commandPools_.reserve(maxFramesInFlight_);
     commandBuffers_.reserve(maxFramesInFlight_);
+    splitCommandBuffers_.reserve(maxFramesInFlight_);
 
     for (uint32_t i = 0; i < maxFramesInFlight_; ++i) {
-        std::unique_ptr<VulkanEngine::RAII::CommandPool> pool = std::make_unique<CommandPool>(*device_, indices.graphicsFamily_.value());
+        std::unique_ptr<VulkanEngine::RAII::CommandPool> pool = std::make_unique<CommandPool>(*device_, indices.graphicsFamily_.value(), VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
         std::unique_ptr<VulkanEngine::RAII::CommandBuffer> buffer = std::make_unique<CommandBuffer>(*pool);
+        splitCommandBuffers_.push_back(std::make_unique<CommandBuffer>(*pool));
         commandPools_.push_back(std::move(pool));
         commandBuffers_.push_back(std::move(buffer));
     }
+    if (!tracyGpu_) {
+        tracyGpu_ = Utils::TracyGpuContext::Create(*device_, device_->GetGraphicsQueue(), indices.graphicsFamily_.value(), "Graphics");
+    }
 
     CreateComputeCommandObjects(indices);
 }
@@ -345,10 +1216,12 @@ void Renderer::CreateComputeCommandObjects(const QueueFamilyIndices& indices)
     computeCommandBuffers_.reserve(maxFramesInFlight_);
 
     for (uint32_t i = 0; i < maxFramesInFlight_; ++i) {
-        auto pool = std::make_unique<CommandPool>(*device_, compute_family);
+        auto pool = std::make_unique<CommandPool>(*device_, compute_family, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
         auto buffer = std::make_unique<CommandBuffer>(*pool);
         computeCommandPools_.push_back(std::move(pool));
         computeCommandBuffers_.push_back(std::move(buffer));
+        computeFinishedSemaphores_.push_back(std::make_unique<Semaphore>(*device_));
+        geometryFinishedSemaphores_.push_back(std::make_unique<Semaphore>(*device_));
     }
 }
 
@@ -394,30 +1267,206 @@ void Renderer::CreateFramebuffers()
     }
 }
 
+void Renderer::TransitionSwapchainImage(VkImageLayout old_layout, VkImageLayout new_layout)
+{
+    VkImageMemoryBarrier2KHR barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR};
+    barrier.oldLayout = old_layout;
+    barrier.newLayout = new_layout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = swapchainImages_[imageIndex_];
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    barrier.srcStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR;
+    if (new_layout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR) {
+        // Present is ordered by the render-finished semaphore, not by a later stage
+        barrier.srcAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_NONE_KHR;
+    } else if (new_layout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL) {
+        // Headless: ready for the frame readback (or the caller's own copy)
+        barrier.srcAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR;
+        barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT_KHR;
+    } else if (swapchain_->IsHeadless()) {
+        // No acquire semaphore: wait for the copy out of this image's previous frame instead
+        barrier.srcStageMask |= VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR;
+        barrier.dstAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR;
+    } else {
+        // Chained to the acquire semaphore wait at the color output stage
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR;
+        barrier.dstAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR;
+    }
+
+    GetActiveGraphicsCommandBuffer().PipelineBarrier2({}, {}, std::span<const VkImageMemoryBarrier2KHR>(&barrier, 1));
+}
+
+CommandBuffer& Renderer::GetActiveGraphicsCommandBuffer()
+{
+    return graphicsSplit_ ? *splitCommandBuffers_[currentFrame_] : *commandBuffers_[currentFrame_];
+}
+
+CommandBuffer* Renderer::GetGraphicsCommandBufferAfterCompute()
+{
+    if (asyncComputeSync_.syncPoint == ComputeSyncPoint::BEFORE_GEOMETRY) {
+        return &GetActiveGraphicsCommandBuffer();
+    }
+    return graphicsSplit_ ? splitCommandBuffers_[currentFrame_].get() : nullptr;
+}
+
+void Renderer::RecordOwnershipTransfer(QueueType destination,
+                                       VkBufferMemoryBarrier2KHR* buffer_barrier,
+                                       VkImageMemoryBarrier2KHR* image_barrier)
+{
+    if (!frameInProgress_) {
+        throw std::runtime_error("No frame in progress");
+    }
+    if (destination != QueueType::GRAPHICS && destination != QueueType::COMPUTE) {
+        throw std::invalid_argument("Ownership can only move between the graphics and compute queues");
+    }
+    if (computeCommandBuffers_.empty()) {
+        throw std::runtime_error("Compute command buffers are not available for this renderer");
+    }
+    const bool to_compute = destination == QueueType::COMPUTE;
+    if (to_compute && (asyncComputeSync_.syncPoint != ComputeSyncPoint::AFTER_GEOMETRY || graphicsSplit_)) {
+        throw std::logic_error("Graphics to compute transfers require AFTER_GEOMETRY and must be recorded before the split");
+    }
+
+    const QueueFamilyIndices& indices = device_->GetQueueFamilyIndices();
+    const uint32_t graphics_family = indices.graphicsFamily_.value();
+    const uint32_t compute_family = indices.computeFamily_.value();
+    const std::span<const VkBufferMemoryBarrier2KHR> buffer_barriers(buffer_barrier, buffer_barrier ? 1 : 0);
+    const std::span<const VkImageMemoryBarrier2KHR> image_barriers(image_barrier, image_barrier ? 1 : 0);
+
+    if (graphics_family != compute_family) {
+        const uint32_t source_family = to_compute ? graphics_family : compute_family;
+        const uint32_t destination_family = to_compute ? compute_family : graphics_family;
+        if (buffer_barrier) {
+            buffer_barrier->srcQueueFamilyIndex = source_family;
+            buffer_barrier->dstQueueFamilyIndex = destination_family;
+        }
+        if (image_barrier) {
+            image_barrier->srcQueueFamilyIndex = source_family;
+            image_barrier->dstQueueFamilyIndex = destination_family;
+        }
+
+        CommandBuffer& source = to_compute ? GetActiveGraphicsCommandBuffer() : GetCurrentComputeCommandBuffer();
+        std::vector<VkBufferMemoryBarrier2KHR> release_buffers;
+        std::vector<VkImageMemoryBarrier2KHR> release_images;
+        for (const auto& barrier : buffer_barriers) {
+            release_buffers.push_back(MakeReleaseBarrier(barrier));
+        }
+        for (const auto& barrier : image_barriers) {
+            release_images.push_back(MakeReleaseBarrier(barrier));
+        }
+        source.FlushBarriers();
+        source.PipelineBarrier2({}, release_buffers, release_images);
+
+        if (buffer_barrier) {
+            *buffer_barrier = MakeAcquireBarrier(*buffer_barrier);
+        }
+        if (image_barrier) {
+            *image_barrier = MakeAcquireBarrier(*image_barrier);
+        }
+    } else {
+        // One family: the semaphore orders the queues and makes the writes visible,
+        // so all that is left is the layout transition, chained to the wait
+        if (!image_barrier || image_barrier->oldLayout == image_barrier->newLayout) {
+            return;
+        }
+        image_barrier->srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR;
+        image_barrier->srcAccessMask = VK_ACCESS_2_NONE_KHR;
+        image_barrier->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        image_barrier->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    }
+
+    CommandBuffer* target = to_compute ? &GetCurrentComputeCommandBuffer() : GetGraphicsCommandBufferAfterCompute();
+    if (!target) {
+        pendingBufferAcquires_.insert(pendingBufferAcquires_.end(), buffer_barriers.begin(), buffer_barriers.end());
+        pendingImageAcquires_.insert(pendingImageAcquires_.end(), image_barriers.begin(), image_barriers.end());
+        return;
+    }
+    target->FlushBarriers();
+    target->PipelineBarrier2({}, buffer_barriers, image_barriers);
+}
+
+void Renderer::FlushPendingAcquires(CommandBuffer& command_buffer)
+{
+    if (pendingBufferAcquires_.empty() && pendingImageAcquires_.empty()) {
+        return;
+    }
+    command_buffer.FlushBarriers();
+    command_buffer.PipelineBarrier2({}, pendingBufferAcquires_, pendingImageAcquires_);
+    pendingBufferAcquires_.clear();
+    pendingImageAcquires_.clear();
+}
+
+void Renderer::ResetSecondaryCommandBuffers()
+{
+    for (RecordingThread& thread : recordingThreads_) {
+        thread.allocator->BeginFrame(currentFrame_);
+        thread.recorded.clear();
+        thread.executed = 0;
+    }
+}
+
 void Renderer::Cleanup()
 {
     if (device_) {
-        vkDeviceWaitIdle(device_->GetHandle());
+        device_->WaitIdle(); // Also destroys the deferred objects
+    }
+    // Device idle does not cover the presentation engine; present fences do
+    for (const auto& entry : pendingPresentFences_) {
+        entry.second->Wait(PRESENT_WAIT_TIMEOUT_NS);
     }
+    pendingPresentFences_.clear();
+    retiredSwapchains_.clear();
+    tracyGpu_.reset();
 
     framebuffers_.clear();
+    splitCommandBuffers_.clear();
     commandBuffers_.clear();
     commandPools_.clear();
     computeCommandBuffers_.clear();
     computeCommandPools_.clear();
+    computeFinishedSemaphores_.clear();
+    geometryFinishedSemaphores_.clear();
+    pendingBufferAcquires_.clear();
+    pendingImageAcquires_.clear();
+    recordingThreads_.clear();
     imageAvailableSemaphores_.clear();
     renderFinishedSemaphores_.clear();
+    // Every lease has been returned by now
+    semaphorePool_.reset();
+    fencePool_.reset();
     inFlightFences_.clear();
+    frameTimeline_.reset();
     extraAttachments_.clear();
+    swapchainImages_.clear();
+    frameBeginCallbacks_.clear();
+    completedFrameValue_ = 0;
+    presentedFrameValue_ = 0;
+    frameReadback_ = nullptr;
+    frameReadbackHandle_ = {};
+    latencyTracker_ = nullptr;
+    gpuProfiler_ = nullptr;
+    frameDamage_.clear();
+    imageRenderedFrame_.clear();
+    damageHistory_.clear();
+    preserveContents_ = false;
 
     device_ = nullptr;
     swapchain_ = nullptr;
     renderPass_ = nullptr;
     maxFramesInFlight_ = 0;
+    framesInFlight_ = 0;
+    adaptiveDepth_ = false;
     currentFrame_ = 0;
     imageIndex_ = 0;
     frameInProgress_ = false;
     needsSwapchainRecreation_ = false;
+    dynamicRendering_ = false;
+    computeRecording_ = false;
+    graphicsSplit_ = false;
 }
 
 } // namespace VulkanEngine::RAII
@@ -2,9 +2,19 @@
 #define VULKAN_RAII_RENDERING_RENDERER_HPP
 
 #include <volk.h>
+#include <chrono>
+#include <deque>
+#include <span>
 #include <vector>
 #include <memory>
-
+#include <functional>
+#include <utility>
+
+#include "FrameBeginSubscription.hpp"
+#include "../core/Queue.hpp"
+#include "../presentation/Swapchain.hpp"
+#include "../resources/ReadbackManager.hpp"
+#include "../sync/SyncObjectPool.hpp"
 #include "../types/QueueFamilyIndices.hpp"
 
 // Forward declare SDL types
@@ -14,13 +24,22 @@ struct SDL_Window;
 namespace VulkanEngine::RAII {
 
 class Device; // Forward declaration
-class Swapchain; // Forward declaration
 class RenderPass; // Forward declaration
 class Framebuffer; // Forward declaration
 class CommandPool; // Forward declaration
 class CommandBuffer; // Forward declaration
+class FrameCommandAllocator; // Forward declaration
 class Semaphore; // Forward declaration
 class Fence; // Forward declaration
+class Buffer; // Forward declaration
+class Image; // Forward declaration
+struct ResourceAccess; // Forward declaration
+class GpuProfiler; // Forward declaration
+
+namespace Utils {
+class LatencyTracker; // Forward declaration
+class TracyGpuContext; // Forward declaration
+}
 
 class Renderer {
 public:
@@ -30,16 +49,21 @@ public:
              const RenderPass& render_pass,
              uint32_t max_frames_in_flight = 2);
 
+    // Constructor for dynamic rendering (no render pass and no framebuffers). The
+    // acquired swapchain image is transitioned for color output in BeginFrame and
+    // for presenting in EndFrame; record into it with BeginSwapchainRendering()
+    Renderer(const Device& device,
+             Swapchain& swapchain,
+             uint32_t max_frames_in_flight = 2);
+
     // Destructor
     ~Renderer();
 
-    // Move constructor and assignment
-    Renderer(Renderer&& other) noexcept;
-    Renderer& operator=(Renderer&& other) noexcept;
-
-    // Delete copy constructor and assignment
+    // Delete copy and move: attached objects and frame-begin subscriptions point at this renderer
     Renderer(const Renderer&) = delete;
     Renderer& operator=(const Renderer&) = delete;
+    Renderer(Renderer&&) = delete;
+    Renderer& operator=(Renderer&&) = delete;
 
     // Begin frame rendering
     bool BeginFrame();
@@ -50,12 +74,100 @@ public:
     // Get current command buffer for recording
     CommandBuffer& GetCurrentCommandBuffer();
 
-    // Access the per-frame compute command buffer when available
+    // Access the per-frame compute command buffer when available. The first call in a
+    // frame begins it, and EndFrame submits it on the compute queue (see SetAsyncComputeSync)
     CommandBuffer& GetCurrentComputeCommandBuffer();
 
     // Check if compute command buffers are provided
     [[nodiscard]] bool HasComputeCommandBuffers() const { return !computeCommandBuffers_.empty(); }
 
+    // Where the compute submission sits relative to the frame's graphics work:
+    //  BEFORE_GEOMETRY  - all graphics work waits for compute (compute feeds the frame)
+    //  OVERLAP_GEOMETRY - compute runs alongside the graphics work recorded before
+    //                     SplitGraphicsSubmission(); the work after the split waits for it
+    //  AFTER_GEOMETRY   - compute waits for the work before the split, and the work after
+    //                     the split waits for compute
+    enum class ComputeSyncPoint {
+        BEFORE_GEOMETRY,
+        OVERLAP_GEOMETRY,
+        AFTER_GEOMETRY
+    };
+
+    struct AsyncComputeSync {
+        ComputeSyncPoint syncPoint{ComputeSyncPoint::BEFORE_GEOMETRY};
+        VkPipelineStageFlags2KHR graphicsWaitStages{VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR}; // Graphics stages blocked on compute
+        VkPipelineStageFlags2KHR computeWaitStages{VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR}; // AFTER_GEOMETRY only
+    };
+
+    // Configure how EndFrame orders the compute submission against graphics. The last
+    // graphics submission always waits for compute, so the frame fence (or timeline
+    // value) retires both queues. Only hazards within a frame are covered: data
+    // crossing queues between frames needs per-frame copies. Call outside a frame
+    void SetAsyncComputeSync(const AsyncComputeSync& sync);
+    [[nodiscard]] const AsyncComputeSync& GetAsyncComputeSync() const { return asyncComputeSync_; }
+
+    // End the geometry segment of the frame's graphics work and continue recording into
+    // a second command buffer, submitted separately so compute can wait for or overlap
+    // the first. GetCurrentCommandBuffer() returns the new buffer afterwards
+    void SplitGraphicsSubmission();
+    [[nodiscard]] bool IsGraphicsSubmissionSplit() const { return graphicsSplit_; }
+
+    // Move a resource between the graphics and compute queue families: the release
+    // (source_access: last use on the current owner) is recorded on the source queue's
+    // buffer, the acquire (destination_access: first use on the new owner) on the
+    // destination's, after its wait for the source. Acquires on graphics after the
+    // split are held until SplitGraphicsSubmission(). Graphics-to-compute transfers
+    // need AFTER_GEOMETRY and must be recorded before the split. With a single family
+    // only the layout transition is recorded. Updates the tracked state
+    void TransferOwnership(Buffer& buffer,
+                           QueueType destination,
+                           const ResourceAccess& source_access,
+                           const ResourceAccess& destination_access);
+    void TransferOwnership(Image& image,
+                           QueueType destination,
+                           const ResourceAccess& source_access,
+                           const ResourceAccess& destination_access);
+    void TransferOwnership(Image& image,
+                           QueueType destination,
+                           const ResourceAccess& source_access,
+                           const ResourceAccess& destination_access,
+                           const VkImageSubresourceRange& range);
+
+    // Select the swapchain present mode for mode (applied by the next recreation) and, with
+    // Device::SupportsPresentWait(), pace BeginFrame on presentation: LOWEST_LATENCY starts
+    // a frame only once the previous one is on screen, BALANCED allows one queued frame,
+    // THROUGHPUT never waits. The CPU then starts (and samples input) just before the GPU
+    // can use the frame instead of queue depth frames early. Call outside a frame
+    void SetLatencyMode(Swapchain::LatencyMode mode);
+    [[nodiscard]] Swapchain::LatencyMode GetLatencyMode() const { return latencyMode_; }
+
+    // Frame start (return of BeginFrame's waits) to presentation, timed with present waits.
+    // Presents that were not waited on are polled at the next BeginFrame, so their
+    // latency is an upper bound. Nothing is measured without present wait support
+    struct LatencyStats {
+        double lastMs{0.0};
+        double averageMs{0.0}; // Exponential moving average
+        double frameIntervalMs{0.0}; // Moving average of the time between frame starts
+        uint64_t timedFrames{0};
+
+        // Average latency in frames, e.g. to check a target of under 2 frames
+        [[nodiscard]] double GetAverageFrames() const { return frameIntervalMs > 0.0 ? averageMs / frameIntervalMs : 0.0; }
+    };
+    [[nodiscard]] const LatencyStats& GetLatencyStats() const { return latencyStats_; }
+
+    // Stamp RENDER_SUBMIT, PRESENT and DISPLAY markers into tracker, keyed by
+    // GetFrameTimelineValue(). Display times come from VK_GOOGLE_display_timing when the
+    // swapchain supports it, otherwise from present waits (an upper bound, see above).
+    // The tracker must outlive the renderer or be detached with nullptr
+    void SetLatencyTracker(Utils::LatencyTracker* tracker) { latencyTracker_ = tracker; }
+    [[nodiscard]] Utils::LatencyTracker* GetLatencyTracker() const { return latencyTracker_; }
+
+    // Profiler the frame's graphics and compute command buffers are attached to for
+    // CommandBuffer::BeginZone (set by GpuProfiler::AttachToRenderer). While the
+    // Utils::Profiler is enabled, EndFrame collects its frame and merges these zones in
+    void SetGpuProfiler(GpuProfiler* profiler) { gpuProfiler_ = profiler; }
+    [[nodiscard]] GpuProfiler* GetGpuProfiler() const { return gpuProfiler_; }
+
     // Get current frame index (frame in flight index)
     [[nodiscard]] uint32_t GetCurrentFrameIndex() const { return currentFrame_; }
 
@@ -75,12 +187,140 @@ public:
     // Rebuild framebuffers to incorporate current attachments and swapchain state.
     void RebuildFramebuffers();
 
-    // Recreate resources (for window resize)
+    // Recreate resources (for window resize) without idling the device. The new swapchain
+    // is created from the old one (oldSwapchain); the old swapchain, its views,
+    // framebuffers and present semaphores are retired and destroyed from a later
+    // BeginFrame, once the frames recorded against them have finished. With
+    // VK_EXT_swapchain_maintenance1, present fences also hold them until the
+    // presentation engine has released the old images
     void Recreate(bool recreate_semaphores = true);
 
-    // Get max frames in flight
+    // Headless swapchains (Swapchain::IsHeadless()): copy every frame's image to the host
+    // through readback, recorded at the end of the frame. Attach the manager to this
+    // renderer (ReadbackManager::AttachToRenderer) so the copies complete with the
+    // frame; nullptr stops them. Call outside a frame
+    void SetFrameReadback(ReadbackManager* readback);
+
+    // Readback of the last ended frame's image (invalid without SetFrameReadback)
+    [[nodiscard]] const ReadbackHandle& GetFrameReadback() const { return frameReadbackHandle_; }
+
+    // Damage tracking (VK_KHR_incremental_present). Rectangles added during a frame are
+    // passed to Present as the area that changed since the previous present; a frame
+    // without damage counts as fully damaged
+    void AddFrameDamage(const VkRect2D& rect);
+    void AddFrameDamage(std::span<const VkRect2D> rects);
+    [[nodiscard]] const std::vector<VkRect2D>& GetFrameDamage() const { return frameDamage_; }
+
+    // Keep swapchain images' previous contents so a frame only redraws its repaint
+    // bounds. Dynamic rendering then transitions re-acquired images from the present
+    // layout instead of UNDEFINED, and BeginSwapchainRendering clears and renders only
+    // the repaint bounds; render pass renderers need a pass that loads the previous
+    // contents. Pixels a clipped swapchain left undefined are not restored
+    void SetPreserveSwapchainContents(bool preserve) { preserveContents_ = preserve; }
+    [[nodiscard]] bool PreservesSwapchainContents() const { return preserveContents_; }
+
+    // Area the current frame must redraw: its own damage plus the damage of every frame
+    // since the acquired image was last rendered (buffer age). The full extent without
+    // preserved contents, or for images not rendered since the last Recreate
+    [[nodiscard]] VkRect2D GetRepaintBounds() const;
+
+    // Set scissor 0 of the active graphics command buffer to GetRepaintBounds()
+    void SetRepaintScissor();
+
+    // Swapchains retired by Recreate and not yet destroyed
+    [[nodiscard]] size_t GetRetiredSwapchainCount() const { return retiredSwapchains_.size(); }
+
+    // Check whether this renderer uses dynamic rendering instead of framebuffers
+    [[nodiscard]] bool UsesDynamicRendering() const { return dynamicRendering_; }
+
+    // Dynamic rendering: begin rendering to the acquired swapchain image, cleared to
+    // clear_color, with an optional depth attachment the caller owns. Renders the
+    // repaint bounds only (add the frame's damage first; see SetPreserveSwapchainContents)
+    // (pass VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT_KHR to record it with secondaries)
+    void BeginSwapchainRendering(const VkClearColorValue& clear_color,
+                                 const VkRenderingAttachmentInfoKHR* depth_attachment = nullptr,
+                                 VkRenderingFlagsKHR flags = 0);
+    void EndSwapchainRendering();
+
+    // Multithreaded recording: creates a command pool per recording thread and
+    // frame in flight for secondary command buffers. depth_format is inherited by
+    // dynamic rendering secondaries (the depth attachment passed to
+    // BeginSwapchainRendering). Call outside a frame; waits for the device.
+    void SetRecordingThreadCount(uint32_t thread_count, VkFormat depth_format = VK_FORMAT_UNDEFINED);
+    [[nodiscard]] uint32_t GetRecordingThreadCount() const { return static_cast<uint32_t>(recordingThreads_.size()); }
+
+    // Begin a secondary command buffer from thread_index's pool for the current frame,
+    // continuing the swapchain render pass and framebuffer (or swapchain dynamic
+    // rendering). Each thread_index must only be used by one thread at a time;
+    // End() the buffer on that thread. sort_key orders execution (see ExecuteSecondaryCommandBuffers)
+    CommandBuffer& BeginSecondaryCommandBuffer(uint32_t thread_index, uint32_t sort_key);
+
+    // Same, with caller-provided inheritance for other render passes (or none for
+    // secondaries executed outside a render pass)
+    CommandBuffer& BeginSecondaryCommandBuffer(uint32_t thread_index,
+                                               uint32_t sort_key,
+                                               const VkCommandBufferInheritanceInfo& inheritance_info,
+                                               VkCommandBufferUsageFlags usage_flags);
+
+    // Inheritance continuing the swapchain render pass (or swapchain dynamic rendering)
+    // for secondaries. pNext of info points at rendering, so fill it in place. Without
+    // include_framebuffer the secondary is valid for every swapchain image
+    struct SecondaryInheritance {
+        VkCommandBufferInheritanceInfo info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
+        VkCommandBufferInheritanceRenderingInfoKHR rendering{VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO_KHR};
+        VkFormat colorFormat{VK_FORMAT_UNDEFINED};
+    };
+    void FillSecondaryInheritance(SecondaryInheritance& inheritance, bool include_framebuffer = true) const;
+
+    // Execute every secondary begun this frame into the primary, ordered by
+    // sort_key, then thread_index, then begin order, so the result does not depend
+    // on thread timing. Call after the recording threads have finished
+    void ExecuteSecondaryCommandBuffers();
+
+    // Get max frames in flight: the number of frame slots, fixed at construction. Per-frame
+    // resources (here and in the subsystems keyed by frame index) are sized by it
     [[nodiscard]] uint32_t GetMaxFramesInFlight() const { return maxFramesInFlight_; }
 
+    // Frames the CPU may run ahead of the GPU, 1..GetMaxFramesInFlight(). Slots still
+    // rotate over all of them, so lowering or raising the depth needs no recreation and
+    // no device idle: BeginFrame just waits for frame N - depth instead of the slot's
+    // previous frame. 1 gives the lowest latency, the maximum the deepest pipelining.
+    // Call outside a frame; the adaptive policy overrides it while enabled
+    void SetFramesInFlight(uint32_t depth);
+    [[nodiscard]] uint32_t GetFramesInFlight() const { return framesInFlight_; }
+
+    // Moving averages over frame starts: cpuMs from a frame start to the next BeginFrame
+    // call, gpuWaitMs the time BeginFrame then blocks until the GPU frees a frame, and
+    // acquireMs the time it blocks in vkAcquireNextImageKHR (presentation bound)
+    struct FrameTimings {
+        double cpuMs{0.0};
+        double gpuWaitMs{0.0};
+        double acquireMs{0.0};
+    };
+    [[nodiscard]] const FrameTimings& GetFrameTimings() const { return frameTimings_; }
+
+    // The same values for the latest BeginFrame only, for per-frame statistics
+    [[nodiscard]] const FrameTimings& GetLastFrameTimings() const { return lastFrameTimings_; }
+
+    // GPU zone spanning each frame's graphics work while a GpuProfiler is attached;
+    // GpuProfiler::GetZoneMs(GPU_FRAME_ZONE) is the GPU frame time
+    static constexpr const char* GPU_FRAME_ZONE = "Renderer::Frame";
+
+    // Adaptive depth: every sampleFrames frames, the share of time BeginFrame spent
+    // blocked on the GPU decides. Above raiseWaitRatio the GPU is the bottleneck and the
+    // depth goes up for throughput; below lowerWaitRatio the CPU is, and extra depth only
+    // adds latency, so it goes down
+    struct AdaptiveFramesInFlight {
+        uint32_t minDepth{1};
+        uint32_t maxDepth{0}; // 0: GetMaxFramesInFlight()
+        double raiseWaitRatio{0.25};
+        double lowerWaitRatio{0.05};
+        uint32_t sampleFrames{60};
+    };
+    void EnableAdaptiveFramesInFlight(const AdaptiveFramesInFlight& policy = {});
+    void DisableAdaptiveFramesInFlight() { adaptiveDepth_ = false; }
+    [[nodiscard]] bool UsesAdaptiveFramesInFlight() const { return adaptiveDepth_; }
+
     // SDL2-specific methods
     
     // Check if renderer needs to handle window resize
@@ -96,32 +336,146 @@ public:
 
     [[nodiscard]] uint64_t GetTotalFrameCount() const { return totalFrameCount_; }
 
+    // Incremented by every Recreate(); work recorded against the swapchain is stale once it changes
+    [[nodiscard]] uint64_t GetSwapchainGeneration() const { return swapchainGeneration_; }
+
+    // The device this renderer records for
+    [[nodiscard]] const Device& GetDevice() const { return *device_; }
+
+    // Timeline pacing: GPU progress is one timeline semaphore instead of a fence per
+    // frame in flight. Frame N (GetFrameTimelineValue() while recording it, starting
+    // at 1) signals value N when its submission completes, and BeginFrame for frame N
+    // waits for N - maxFramesInFlight, with no fence resets. Other subsystems can key
+    // their own retirement off the same values (e.g. ReadbackManager::MarkSubmitted).
+    // Requires Device::SupportsTimelineSemaphores(); call outside a frame
+    void EnableTimelinePacing();
+    [[nodiscard]] bool UsesTimelinePacing() const { return frameTimeline_ != nullptr; }
+
+    // Timeline semaphore of timeline pacing (nullptr when pacing with fences)
+    [[nodiscard]] const Semaphore* GetFrameTimeline() const { return frameTimeline_.get(); }
+
+    // Value the frame being recorded (or recorded next) signals on completion
+    [[nodiscard]] uint64_t GetFrameTimelineValue() const { return totalFrameCount_ + 1; }
+
+    // Last completed frame value, and whether frame_value has retired (timeline pacing only)
+    [[nodiscard]] uint64_t GetCompletedFrameValue() const;
+    [[nodiscard]] bool IsFrameRetired(uint64_t frame_value) const { return frame_value <= GetCompletedFrameValue(); }
+
+    // Callback invoked from BeginFrame once the frame's fence has been waited on,
+    // i.e. when every resource used by that frame index may be recycled
+    using FrameCallback = std::function<void(uint32_t frame_index)>;
+
+    // Register a frame-begin callback, removed again with the returned subscription
+    [[nodiscard]] FrameBeginSubscription SubscribeFrameBegin(FrameCallback callback);
+
 private:
+    friend class FrameBeginSubscription;
+
+    // Secondary command buffers of one recording thread; the allocator recycles
+    // them per frame, recorded lists what the current frame began
+    struct RecordingThread {
+        std::unique_ptr<FrameCommandAllocator> allocator;
+        std::vector<std::pair<uint32_t, VkCommandBuffer>> recorded; // (sort key, command buffer)
+        size_t executed{0}; // Already passed to ExecuteSecondaryCommandBuffers
+    };
+
+    // What Recreate replaced, kept until lastFrameValue (the last frame recorded
+    // against the old swapchain) has retired
+    struct RetiredSwapchainResources {
+        uint64_t lastFrameValue{0};
+        RetiredSwapchain swapchain;
+        std::vector<std::unique_ptr<Framebuffer>> framebuffers;
+        std::vector<SemaphorePool::Lease> semaphores;
+    };
+
     const Device* device_{nullptr};
     Swapchain* swapchain_{nullptr};
     const RenderPass* renderPass_{nullptr};
 
     uint32_t maxFramesInFlight_{3};
+    uint32_t framesInFlight_{3}; // Active depth, <= maxFramesInFlight_
     uint32_t currentFrame_{0};
     uint32_t imageIndex_{0};
     bool frameInProgress_{false};
     bool needsSwapchainRecreation_{false};
+    bool dynamicRendering_{false};
 
     uint64_t totalFrameCount_{0};
     uint64_t lastRecreateTime_{0};
+    uint64_t swapchainGeneration_{0};
 
     // Per-frame resources
     std::vector<std::unique_ptr<CommandPool>> commandPools_;
     std::vector<std::unique_ptr<CommandBuffer>> commandBuffers_;
     std::vector<std::unique_ptr<CommandPool>> computeCommandPools_;
     std::vector<std::unique_ptr<CommandBuffer>> computeCommandBuffers_;
-    std::vector<std::unique_ptr<Semaphore>> imageAvailableSemaphores_;
-    std::vector<std::unique_ptr<Semaphore>> renderFinishedSemaphores_;
+    // Acquire/present semaphores and present fences come back here when retired, so
+    // steady-state frames and Recreate reuse them instead of recreating them
+    std::unique_ptr<SemaphorePool> semaphorePool_;
+    std::unique_ptr<FencePool> fencePool_;
+    std::vector<SemaphorePool::Lease> imageAvailableSemaphores_;
+    std::vector<SemaphorePool::Lease> renderFinishedSemaphores_;
     std::vector<std::unique_ptr<Fence>> inFlightFences_;
+    std::unique_ptr<Semaphore> frameTimeline_; // Timeline pacing only
+
+    // Async compute (see SetAsyncComputeSync)
+    std::vector<std::unique_ptr<CommandBuffer>> splitCommandBuffers_; // Graphics work after SplitGraphicsSubmission
+    std::vector<std::unique_ptr<Semaphore>> computeFinishedSemaphores_;
+    std::vector<std::unique_ptr<Semaphore>> geometryFinishedSemaphores_;
+    AsyncComputeSync asyncComputeSync_{};
+    bool computeRecording_{false};
+    bool graphicsSplit_{false};
+    std::vector<VkBufferMemoryBarrier2KHR> pendingBufferAcquires_; // Graphics acquires waiting for the split
+    std::vector<VkImageMemoryBarrier2KHR> pendingImageAcquires_;
+
+    // Latency pacing (see SetLatencyMode)
+    using Clock = std::chrono::steady_clock;
+    Swapchain::LatencyMode latencyMode_{Swapchain::LatencyMode::THROUGHPUT};
+    std::deque<std::pair<uint64_t, Clock::time_point>> pendingPresents_; // (present id, frame start), oldest first
+    Clock::time_point frameStart_{};
+    LatencyStats latencyStats_{};
+    Utils::LatencyTracker* latencyTracker_{nullptr};
+    GpuProfiler* gpuProfiler_{nullptr};
+    uint64_t profiledGpuFrames_{0}; // GpuProfiler::GetResolvedFrameCount() last merged into the CPU profiler
+    std::unique_ptr<Utils::TracyGpuContext> tracyGpu_; // Graphics queue; only when Tracy is compiled in
+
+    // Frames-in-flight depth (see SetFramesInFlight)
+    FrameTimings frameTimings_{};
+    FrameTimings lastFrameTimings_{};
+    AdaptiveFramesInFlight adaptivePolicy_{};
+    bool adaptiveDepth_{false};
+    double adaptiveCpuMs_{0.0}; // Sums over the current sample window
+    double adaptiveWaitMs_{0.0};
+    uint32_t adaptiveSamples_{0};
+
+    // Stall-free recreation (see Recreate)
+    std::deque<RetiredSwapchainResources> retiredSwapchains_; // Oldest first
+    std::deque<std::pair<uint64_t, FencePool::Lease>> pendingPresentFences_; // (frame value, fence), oldest first
+    uint64_t completedFrameValue_{0}; // Frames up to this value finished on the GPU
+    uint64_t presentedFrameValue_{0}; // Presents up to this frame value released their images
+
+    // Headless frame readback (see SetFrameReadback)
+    ReadbackManager* frameReadback_{nullptr};
+    ReadbackHandle frameReadbackHandle_{};
+
+    // Damage tracking (see AddFrameDamage)
+    std::vector<VkRect2D> frameDamage_;
+    std::vector<uint64_t> imageRenderedFrame_; // Frame value that last rendered each image, 0 = never
+    std::deque<std::pair<uint64_t, VkRect2D>> damageHistory_; // (frame value, damage bounds), oldest first
+    bool preserveContents_{false};
 
     // Framebuffers for each swapchain image
     std::vector<std::unique_ptr<Framebuffer>> framebuffers_;
     std::vector<std::vector<VkImageView>> extraAttachments_;
+    std::vector<VkImage> swapchainImages_; // Dynamic rendering only
+
+    // Multithreaded recording
+    std::vector<RecordingThread> recordingThreads_;
+    VkFormat secondaryDepthFormat_{VK_FORMAT_UNDEFINED};
+
+    // Frame-begin callbacks (id, callback)
+    std::vector<std::pair<uint32_t, FrameCallback>> frameBeginCallbacks_;
+    uint32_t nextCallbackId_{1};
 
     // Helper methods
     void CreateSyncObjects(uint32_t num_of_swapchain_images);
@@ -129,7 +483,26 @@ private:
     void CreateCommandObjects();
     void CreateComputeCommandObjects(const QueueFamilyIndices& indices);
     void CreateFramebuffers();
+    void TransitionSwapchainImage(VkImageLayout old_layout, VkImageLayout new_layout);
+    CommandBuffer& GetActiveGraphicsCommandBuffer();
+    CommandBuffer* GetGraphicsCommandBufferAfterCompute();
+    void RecordOwnershipTransfer(QueueType destination,
+                                 VkBufferMemoryBarrier2KHR* buffer_barrier,
+                                 VkImageMemoryBarrier2KHR* image_barrier);
+    void FlushPendingAcquires(CommandBuffer& command_buffer);
+    void PacePresents();
+    void PollDisplayTimings();
+    void RecordFrameStart(Clock::time_point wait_start, double gpu_wait_ms);
+    void UpdateAdaptiveDepth(double cpu_ms, double gpu_wait_ms);
+    void PollPresentFences();
+    void ReleaseRetiredSwapchains();
+    VkFence AcquirePresentFence();
+    void RecordFrameDamage();
+    void CollectProfilerFrame();
+    void ResetDamageHistory();
+    void ResetSecondaryCommandBuffers();
     void Cleanup();
+    void RemoveFrameBeginCallback(uint32_t callback_id); // From FrameBeginSubscription
 };
 
 } // namespace VulkanEngine::RAII
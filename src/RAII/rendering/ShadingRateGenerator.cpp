@@ -0,0 +1,126 @@
+#include "ShadingRateGenerator.hpp"
+
+#include "CommandBuffer.hpp"
+#include "RenderPass.hpp"
+#include "../core/Device.hpp"
+#include "../resources/Image.hpp"
+#include "../resources/ImageView.hpp"
+#include "../sync/ResourceState.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+
+namespace VulkanEngine::RAII {
+
+namespace {
+uint32_t Log2(uint32_t value)
+{
+    uint32_t result = 0;
+    while (value > 1) {
+        value >>= 1;
+        ++result;
+    }
+    return result;
+}
+
+// The attachment texel size is a power of two between the device's limits; the
+// largest one keeps the rate image smallest
+VkExtent2D ChooseTexelSize(const VkPhysicalDeviceFragmentShadingRatePropertiesKHR& properties)
+{
+    VkExtent2D size = properties.maxFragmentShadingRateAttachmentTexelSize;
+    size.width = std::max(size.width, properties.minFragmentShadingRateAttachmentTexelSize.width);
+    size.height = std::max(size.height, properties.minFragmentShadingRateAttachmentTexelSize.height);
+    return {std::max(size.width, 1u), std::max(size.height, 1u)};
+}
+} // namespace
+
+ShadingRateGenerator::ShadingRateGenerator(const Device& device,
+                                           const VmaAllocator& allocator,
+                                           ShaderLayoutCache& layouts,
+                                           const Shader& rate_shader,
+                                           VkExtent2D extent)
+    : job_(device, layouts, rate_shader)
+{
+    if (!device.SupportsAttachmentFragmentShadingRate()) {
+        throw std::runtime_error("ShadingRateGenerator requires attachmentFragmentShadingRate");
+    }
+    if (extent.width == 0 || extent.height == 0) {
+        throw std::invalid_argument("ShadingRateGenerator needs a non-empty extent");
+    }
+
+    const VkPhysicalDeviceFragmentShadingRatePropertiesKHR& properties = device.GetFragmentShadingRateProperties();
+    maxFragmentSize_ = properties.maxFragmentSize;
+    texelSize_ = ChooseTexelSize(properties);
+    rateExtent_ = {(extent.width + texelSize_.width - 1) / texelSize_.width,
+                   (extent.height + texelSize_.height - 1) / texelSize_.height};
+
+    image_ = std::make_unique<Image>(allocator,
+                                     rateExtent_.width,
+                                     rateExtent_.height,
+                                     1,
+                                     1,
+                                     1,
+                                     VK_FORMAT_R8_UINT,
+                                     VK_IMAGE_TYPE_2D,
+                                     VK_IMAGE_TILING_OPTIMAL,
+                                     VK_IMAGE_USAGE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR | VK_IMAGE_USAGE_STORAGE_BIT);
+}
+
+ShadingRateGenerator::~ShadingRateGenerator() = default;
+
+uint32_t ShadingRateGenerator::EncodeRate(VkExtent2D fragment_size)
+{
+    return (Log2(fragment_size.width) << 2) | Log2(fragment_size.height);
+}
+
+VkImageView ShadingRateGenerator::GetImageView() const
+{
+    return image_->GetView().GetHandle();
+}
+
+VkRenderingFragmentShadingRateAttachmentInfoKHR ShadingRateGenerator::GetAttachmentInfo() const
+{
+    return RenderPass::CreateShadingRateAttachment(GetImageView(), texelSize_);
+}
+
+void ShadingRateGenerator::Generate(CommandBuffer& command_buffer,
+                                    VkImageView source_view,
+                                    VkSampler source_sampler,
+                                    Mode mode,
+                                    float threshold,
+                                    VkExtent2D max_fragment_size)
+{
+    const VkExtent2D max_rate{std::clamp(max_fragment_size.width, 1u, std::max(maxFragmentSize_.width, 1u)),
+                              std::clamp(max_fragment_size.height, 1u, std::max(maxFragmentSize_.height, 1u))};
+
+    command_buffer.RequireImage(*image_, ResourceAccess{VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+                                                        VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR,
+                                                        VK_IMAGE_LAYOUT_GENERAL});
+
+    const std::array<ComputeBinding, 2> bindings{
+        ComputeBinding::FromImage(0, source_view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, source_sampler),
+        ComputeBinding::FromImage(1, GetImageView(), VK_IMAGE_LAYOUT_GENERAL)};
+
+    Constants constants{};
+    constants.rateWidth = rateExtent_.width;
+    constants.rateHeight = rateExtent_.height;
+    constants.texelWidth = texelSize_.width;
+    constants.texelHeight = texelSize_.height;
+    constants.threshold = threshold;
+    constants.mode = static_cast<uint32_t>(mode);
+    constants.maxRate = EncodeRate(max_rate);
+
+    job_.Bind(command_buffer);
+    job_.PushBindings(command_buffer, bindings);
+    job_.PushConstants(command_buffer, constants);
+    job_.Dispatch(command_buffer, rateExtent_.width, rateExtent_.height);
+
+    // Flushed by the next render pass begin
+    command_buffer.RequireImage(*image_, ResourceAccess{VK_PIPELINE_STAGE_2_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR,
+                                                        VK_ACCESS_2_FRAGMENT_SHADING_RATE_ATTACHMENT_READ_BIT_KHR,
+                                                        VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR});
+}
+
+} // namespace VulkanEngine::RAII
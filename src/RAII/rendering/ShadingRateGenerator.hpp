@@ -0,0 +1,96 @@
+#ifndef VULKAN_RAII_RENDERING_SHADING_RATE_GENERATOR_HPP
+#define VULKAN_RAII_RENDERING_SHADING_RATE_GENERATOR_HPP
+
+#include <volk.h>
+
+#include <cstdint>
+#include <memory>
+
+#include "ComputeJob.hpp"
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+class VmaAllocator; // Forward declaration
+class Image; // Forward declaration
+class CommandBuffer; // Forward declaration
+class Shader; // Forward declaration
+class ShaderLayoutCache; // Forward declaration
+
+// Builds a shading rate image (VK_KHR_fragment_shading_rate) from the previous
+// frame, so flat or fast-moving screen regions shade at 2x2 or 4x4 and detailed,
+// still ones at full rate. One R8_UINT texel covers GetTexelSize() pixels and holds
+// EncodeRate of the fragment size to use there.
+// Shader contract (one invocation per rate texel):
+//   push Constants; set 0: binding 0 source (combined image sampler: previous frame
+//   luminance for LUMINANCE, screen-space motion vectors for MOTION),
+//   binding 1 rate image (r8ui storage image)
+// Draw with the image through RenderPass::CreateShadingRateAttachment (dynamic rendering)
+// or a SubpassDescription::shadingRateAttachment, and with combiner ops that read it
+// (VK_FRAGMENT_SHADING_RATE_COMBINER_OP_MAX_KHR or REPLACE)
+class ShadingRateGenerator {
+public:
+    enum class Mode : uint32_t {
+        LUMINANCE = 0, // Coarser where the local luminance contrast is below threshold
+        MOTION = 1 // Coarser where motion exceeds threshold pixels per frame
+    };
+
+    struct Constants {
+        uint32_t rateWidth;
+        uint32_t rateHeight;
+        uint32_t texelWidth;
+        uint32_t texelHeight;
+        float threshold;
+        uint32_t mode; // Mode
+        uint32_t maxRate; // EncodeRate of the coarsest fragment size allowed
+    };
+
+    // Creates the rate image for a framebuffer of extent. Throws std::runtime_error
+    // without attachment shading rate support
+    ShadingRateGenerator(const Device& device,
+                         const VmaAllocator& allocator,
+                         ShaderLayoutCache& layouts,
+                         const Shader& rate_shader,
+                         VkExtent2D extent);
+
+    // Destructor
+    ~ShadingRateGenerator();
+
+    // Delete copy and move. recorded command buffers reference the owned rate image.
+    ShadingRateGenerator(const ShadingRateGenerator&) = delete;
+    ShadingRateGenerator& operator=(const ShadingRateGenerator&) = delete;
+    ShadingRateGenerator(ShadingRateGenerator&&) = delete;
+    ShadingRateGenerator& operator=(ShadingRateGenerator&&) = delete;
+
+    // Record the rate image generation from source, sampled in SHADER_READ_ONLY_OPTIMAL,
+    // and leave the image ready to be read as a shading rate attachment.
+    // max_fragment_size is clamped to the device's maxFragmentSize
+    void Generate(CommandBuffer& command_buffer,
+                  VkImageView source_view,
+                  VkSampler source_sampler,
+                  Mode mode,
+                  float threshold,
+                  VkExtent2D max_fragment_size = {4, 4});
+
+    // Rate texel value for a fragment size: (log2(width) << 2) | log2(height)
+    [[nodiscard]] static uint32_t EncodeRate(VkExtent2D fragment_size);
+
+    // For RenderPass::CreateShadingRateAttachment
+    [[nodiscard]] VkRenderingFragmentShadingRateAttachmentInfoKHR GetAttachmentInfo() const;
+
+    [[nodiscard]] Image& GetImage() const { return *image_; }
+    [[nodiscard]] VkImageView GetImageView() const;
+    [[nodiscard]] VkExtent2D GetTexelSize() const { return texelSize_; }
+    [[nodiscard]] VkExtent2D GetRateExtent() const { return rateExtent_; }
+
+private:
+    VkExtent2D maxFragmentSize_{1, 1};
+    VkExtent2D texelSize_{1, 1};
+    VkExtent2D rateExtent_{1, 1};
+    ComputeJob job_;
+    std::unique_ptr<Image> image_;
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RENDERING_SHADING_RATE_GENERATOR_HPP
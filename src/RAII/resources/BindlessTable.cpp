@@ -0,0 +1,283 @@
+#include "BindlessTable.hpp"
+
+#include "../core/Device.hpp"
+#include "../core/PhysicalDevice.hpp"
+#include "../rendering/CommandBuffer.hpp"
+#include "../rendering/Renderer.hpp"
+#include "../utils/Constants.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace VulkanEngine::RAII {
+
+namespace {
+size_t ArrayIndex(BindlessResourceType type)
+{
+    return static_cast<size_t>(type);
+}
+
+const char* TypeName(BindlessResourceType type)
+{
+    switch (type) {
+        case BindlessResourceType::SAMPLED_IMAGE: return "sampled image";
+        case BindlessResourceType::SAMPLER: return "sampler";
+        case BindlessResourceType::STORAGE_IMAGE: return "storage image";
+        case BindlessResourceType::STORAGE_BUFFER: return "storage buffer";
+    }
+    return "resource";
+}
+} // namespace
+
+BindlessTable::BindlessTable(const Device& device, const Options& options)
+    : device_(&device),
+    arrays_(CreateSlotArrays(device, options)),
+    layout_(CreateLayout(device, arrays_, options.stageFlags)),
+    pool_(CreatePool(device, arrays_)),
+    framesInFlight_(Constants::MAX_FRAMES_IN_FLIGHT)
+{
+    const SlotArray& last = arrays_.back();
+    VkDescriptorSetVariableDescriptorCountAllocateInfo variable_count{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO};
+    variable_count.descriptorSetCount = 1;
+    variable_count.pDescriptorCounts = &last.capacity;
+    if (pool_.TryAllocateDescriptorSet(layout_.GetHandle(), descriptorSet_, &variable_count) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate bindless descriptor set");
+    }
+}
+
+BindlessTable::BindlessTable(const Device& device)
+    : BindlessTable(device, Options{}) {}
+
+BindlessTable::~BindlessTable()
+{
+    Detach();
+    // The set is freed with the pool
+}
+
+bool BindlessTable::IsSupported(const Device& device)
+{
+    return device.SupportsDescriptorIndexing();
+}
+
+void BindlessTable::AttachToRenderer(Renderer& renderer)
+{
+    Detach();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        framesInFlight_ = renderer.GetMaxFramesInFlight();
+    }
+    frameBeginSubscription_ = renderer.SubscribeFrameBegin([this](uint32_t /*frame_index*/) {
+        BeginFrame();
+    });
+}
+
+void BindlessTable::Detach()
+{
+    frameBeginSubscription_.Reset();
+}
+
+void BindlessTable::BeginFrame()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++frameCounter_;
+    for (SlotArray& array : arrays_) {
+        // Retired in release order, so the oldest is always at the front
+        while (!array.retired.empty() && array.retired.front().second + framesInFlight_ <= frameCounter_) {
+            array.freeSlots.push_back(array.retired.front().first);
+            array.retired.pop_front();
+        }
+    }
+}
+
+uint32_t BindlessTable::RegisterSampledImage(VkImageView image_view, VkImageLayout image_layout)
+{
+    if (image_view == VK_NULL_HANDLE) {
+        throw std::invalid_argument("BindlessTable requires a valid image view");
+    }
+    const VkDescriptorImageInfo image_info{VK_NULL_HANDLE, image_view, image_layout};
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint32_t slot = AcquireSlot(BindlessResourceType::SAMPLED_IMAGE);
+    WriteDescriptor(arrays_[ArrayIndex(BindlessResourceType::SAMPLED_IMAGE)], slot, &image_info, nullptr);
+    return slot;
+}
+
+uint32_t BindlessTable::RegisterSampler(VkSampler sampler)
+{
+    if (sampler == VK_NULL_HANDLE) {
+        throw std::invalid_argument("BindlessTable requires a valid sampler");
+    }
+    const VkDescriptorImageInfo image_info{sampler, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_UNDEFINED};
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint32_t slot = AcquireSlot(BindlessResourceType::SAMPLER);
+    WriteDescriptor(arrays_[ArrayIndex(BindlessResourceType::SAMPLER)], slot, &image_info, nullptr);
+    return slot;
+}
+
+uint32_t BindlessTable::RegisterStorageImage(VkImageView image_view, VkImageLayout image_layout)
+{
+    if (image_view == VK_NULL_HANDLE) {
+        throw std::invalid_argument("BindlessTable requires a valid image view");
+    }
+    const VkDescriptorImageInfo image_info{VK_NULL_HANDLE, image_view, image_layout};
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint32_t slot = AcquireSlot(BindlessResourceType::STORAGE_IMAGE);
+    WriteDescriptor(arrays_[ArrayIndex(BindlessResourceType::STORAGE_IMAGE)], slot, &image_info, nullptr);
+    return slot;
+}
+
+uint32_t BindlessTable::RegisterStorageBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range)
+{
+    if (buffer == VK_NULL_HANDLE) {
+        throw std::invalid_argument("BindlessTable requires a valid buffer");
+    }
+    const VkDescriptorBufferInfo buffer_info{buffer, offset, range};
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint32_t slot = AcquireSlot(BindlessResourceType::STORAGE_BUFFER);
+    WriteDescriptor(arrays_[ArrayIndex(BindlessResourceType::STORAGE_BUFFER)], slot, nullptr, &buffer_info);
+    return slot;
+}
+
+void BindlessTable::Release(BindlessResourceType type, uint32_t slot)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    SlotArray& array = arrays_[ArrayIndex(type)];
+    if (slot >= array.highWater) {
+        throw std::out_of_range("BindlessTable slot was never registered");
+    }
+    if (!array.registered[slot]) {
+        throw std::out_of_range("BindlessTable slot was already released");
+    }
+    array.registered[slot] = false;
+    // The descriptor is left as is: frames in flight may still read it, and partially
+    // bound slots that are no longer indexed do not need to be valid
+    array.retired.emplace_back(slot, frameCounter_);
+    --array.used;
+}
+
+void BindlessTable::Bind(const CommandBuffer& command_buffer,
+                         VkPipelineBindPoint bind_point,
+                         VkPipelineLayout pipeline_layout,
+                         uint32_t set_index) const
+{
+    command_buffer.BindDescriptorSets(bind_point, pipeline_layout, set_index, std::span<const VkDescriptorSet>(&descriptorSet_, 1));
+}
+
+uint32_t BindlessTable::GetCapacity(BindlessResourceType type) const
+{
+    return arrays_[ArrayIndex(type)].capacity;
+}
+
+uint32_t BindlessTable::GetUsedCount(BindlessResourceType type) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return arrays_[ArrayIndex(type)].used;
+}
+
+std::array<BindlessTable::SlotArray, 4> BindlessTable::CreateSlotArrays(const Device& device, const Options& options)
+{
+    if (!device.SupportsDescriptorIndexing()) {
+        throw std::runtime_error("BindlessTable requires descriptor indexing with update-after-bind support");
+    }
+
+    const VkPhysicalDeviceDescriptorIndexingProperties& indexing_properties =
+        device.GetPhysicalDevice().GetDescriptorIndexingProperties();
+
+    auto limit = [](uint32_t requested, uint32_t per_set, uint32_t per_stage) {
+        return std::max(1u, std::min({requested, per_set, per_stage}));
+    };
+    return {{
+        {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, SAMPLED_IMAGE_BINDING,
+         limit(options.maxSampledImages,
+               indexing_properties.maxDescriptorSetUpdateAfterBindSampledImages,
+               indexing_properties.maxPerStageDescriptorUpdateAfterBindSampledImages)},
+        {VK_DESCRIPTOR_TYPE_SAMPLER, SAMPLER_BINDING,
+         limit(options.maxSamplers,
+               indexing_properties.maxDescriptorSetUpdateAfterBindSamplers,
+               indexing_properties.maxPerStageDescriptorUpdateAfterBindSamplers)},
+        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, STORAGE_IMAGE_BINDING,
+         limit(options.maxStorageImages,
+               indexing_properties.maxDescriptorSetUpdateAfterBindStorageImages,
+               indexing_properties.maxPerStageDescriptorUpdateAfterBindStorageImages)},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, STORAGE_BUFFER_BINDING,
+         limit(options.maxStorageBuffers,
+               indexing_properties.maxDescriptorSetUpdateAfterBindStorageBuffers,
+               indexing_properties.maxPerStageDescriptorUpdateAfterBindStorageBuffers)}
+    }};
+}
+
+DescriptorSetLayout BindlessTable::CreateLayout(const Device& device,
+                                                const std::array<SlotArray, 4>& arrays,
+                                                VkShaderStageFlags stage_flags)
+{
+    std::vector<VkDescriptorSetLayoutBinding> bindings;
+    std::vector<VkDescriptorBindingFlags> binding_flags;
+    for (const SlotArray& array : arrays) {
+        VkDescriptorSetLayoutBinding binding{};
+        binding.binding = array.binding;
+        binding.descriptorType = array.descriptorType;
+        binding.descriptorCount = array.capacity;
+        binding.stageFlags = stage_flags;
+        bindings.push_back(binding);
+        // Slots are written while earlier frames using other slots are still executing
+        binding_flags.push_back(VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                                VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                                VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT);
+    }
+    // Only the highest binding may have a variable count
+    binding_flags.back() |= VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT;
+    return DescriptorSetLayout(device, bindings, binding_flags, VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT);
+}
+
+DescriptorPool BindlessTable::CreatePool(const Device& device, const std::array<SlotArray, 4>& arrays)
+{
+    std::vector<VkDescriptorPoolSize> pool_sizes;
+    pool_sizes.reserve(arrays.size());
+    for (const SlotArray& array : arrays) {
+        pool_sizes.push_back({array.descriptorType, array.capacity});
+    }
+    return DescriptorPool(device, 1, pool_sizes, VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT);
+}
+
+uint32_t BindlessTable::AcquireSlot(BindlessResourceType type)
+{
+    SlotArray& array = arrays_[ArrayIndex(type)];
+    uint32_t slot = INVALID_SLOT;
+    if (!array.freeSlots.empty()) {
+        slot = array.freeSlots.back();
+        array.freeSlots.pop_back();
+    } else if (array.highWater < array.capacity) {
+        slot = array.highWater++;
+        array.registered.push_back(false);
+    } else {
+        throw std::runtime_error(std::string("BindlessTable has no free ") + TypeName(type) + " slot");
+    }
+    array.registered[slot] = true;
+    ++array.used;
+    return slot;
+}
+
+void BindlessTable::WriteDescriptor(const SlotArray& array,
+                                    uint32_t slot,
+                                    const VkDescriptorImageInfo* image_info,
+                                    const VkDescriptorBufferInfo* buffer_info) const
+{
+    VkWriteDescriptorSet write{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+    write.dstSet = descriptorSet_;
+    write.dstBinding = array.binding;
+    write.dstArrayElement = slot;
+    write.descriptorCount = 1;
+    write.descriptorType = array.descriptorType;
+    write.pImageInfo = image_info;
+    write.pBufferInfo = buffer_info;
+    vkUpdateDescriptorSets(device_->GetHandle(), 1, &write, 0, nullptr);
+}
+
+} // namespace VulkanEngine::RAII
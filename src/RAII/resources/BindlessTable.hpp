@@ -0,0 +1,147 @@
+#ifndef VULKAN_RAII_RESOURCES_BINDLESS_TABLE_HPP
+#define VULKAN_RAII_RESOURCES_BINDLESS_TABLE_HPP
+
+#include <volk.h>
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "../rendering/FrameBeginSubscription.hpp"
+#include "DescriptorPool.hpp"
+#include "DescriptorSetLayout.hpp"
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+class Renderer; // Forward declaration
+class CommandBuffer; // Forward declaration
+
+enum class BindlessResourceType : uint8_t {
+    SAMPLED_IMAGE,
+    SAMPLER,
+    STORAGE_IMAGE,
+    STORAGE_BUFFER
+};
+
+// One update-after-bind descriptor set holding every registered resource, so a
+// frame binds a single set and shaders index resources by slot:
+//   layout(set = N, binding = 0) uniform texture2D textures[];
+//   layout(set = N, binding = 1) uniform sampler samplers[];
+//   layout(set = N, binding = 2, rgba8) uniform image2D storageImages[];
+//   layout(set = N, binding = 3) buffer Buffers { ... } buffers[];
+// All bindings are partially bound; the last one has a variable descriptor count.
+// Released slots are reused only once the frames in flight at release time have
+// completed, so a slot still read by the GPU is never overwritten.
+// Requires Device::SupportsDescriptorIndexing(). Thread-safe.
+class BindlessTable {
+public:
+    static constexpr uint32_t INVALID_SLOT = UINT32_MAX;
+
+    static constexpr uint32_t SAMPLED_IMAGE_BINDING = 0;
+    static constexpr uint32_t SAMPLER_BINDING = 1;
+    static constexpr uint32_t STORAGE_IMAGE_BINDING = 2;
+    static constexpr uint32_t STORAGE_BUFFER_BINDING = 3;
+
+    // Slot counts per resource type, clamped to the device's update-after-bind limits
+    struct Options {
+        uint32_t maxSampledImages{16384};
+        uint32_t maxSamplers{256};
+        uint32_t maxStorageImages{1024};
+        uint32_t maxStorageBuffers{16384};
+        VkShaderStageFlags stageFlags{VK_SHADER_STAGE_ALL};
+    };
+
+    // Constructor
+    BindlessTable(const Device& device, const Options& options);
+    explicit BindlessTable(const Device& device);
+
+    // Destructor
+    ~BindlessTable();
+
+    // Delete copy and move. the attached renderer holds a callback referencing this object.
+    BindlessTable(const BindlessTable&) = delete;
+    BindlessTable& operator=(const BindlessTable&) = delete;
+    BindlessTable(BindlessTable&&) = delete;
+    BindlessTable& operator=(BindlessTable&&) = delete;
+
+    [[nodiscard]] static bool IsSupported(const Device& device);
+
+    // Recycle released slots from Renderer::BeginFrame. The renderer must outlive
+    // this table or Detach() must be called first
+    void AttachToRenderer(Renderer& renderer);
+    void Detach();
+
+    // Advance one frame and recycle slots whose last frame has completed
+    // (called by the attached renderer; call once per frame otherwise)
+    void BeginFrame();
+
+    // Write the resource into a free slot and return it. Throws when the type has no free slot
+    [[nodiscard]] uint32_t RegisterSampledImage(VkImageView image_view,
+                                                VkImageLayout image_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    [[nodiscard]] uint32_t RegisterSampler(VkSampler sampler);
+    [[nodiscard]] uint32_t RegisterStorageImage(VkImageView image_view,
+                                                VkImageLayout image_layout = VK_IMAGE_LAYOUT_GENERAL);
+    [[nodiscard]] uint32_t RegisterStorageBuffer(VkBuffer buffer,
+                                                 VkDeviceSize offset = 0,
+                                                 VkDeviceSize range = VK_WHOLE_SIZE);
+
+    // Return a slot. It stays valid for frames already recorded and is reused later.
+    // Throws std::out_of_range for a slot that is not registered, including one released twice
+    void Release(BindlessResourceType type, uint32_t slot);
+
+    // Bind the table as set_index of the pipeline layout
+    void Bind(const CommandBuffer& command_buffer,
+              VkPipelineBindPoint bind_point,
+              VkPipelineLayout pipeline_layout,
+              uint32_t set_index = 0) const;
+
+    [[nodiscard]] const DescriptorSetLayout& GetLayout() const { return layout_; }
+    [[nodiscard]] VkDescriptorSet GetDescriptorSet() const { return descriptorSet_; }
+
+    [[nodiscard]] uint32_t GetCapacity(BindlessResourceType type) const;
+    [[nodiscard]] uint32_t GetUsedCount(BindlessResourceType type) const;
+
+private:
+    struct SlotArray {
+        VkDescriptorType descriptorType;
+        uint32_t binding;
+        uint32_t capacity;
+        uint32_t highWater{0}; // Slots at or above it were never handed out
+        uint32_t used{0};
+        std::vector<uint32_t> freeSlots;
+        std::vector<bool> registered; // Per slot below highWater: handed out and not released since
+        std::deque<std::pair<uint32_t, uint64_t>> retired; // Slot, frame it was released in
+    };
+
+    const Device* device_{nullptr};
+    std::array<SlotArray, 4> arrays_;
+    DescriptorSetLayout layout_;
+    DescriptorPool pool_;
+    VkDescriptorSet descriptorSet_{VK_NULL_HANDLE};
+
+    mutable std::mutex mutex_;
+    uint64_t frameCounter_{0};
+    uint32_t framesInFlight_{0};
+
+    FrameBeginSubscription frameBeginSubscription_;
+
+    static std::array<SlotArray, 4> CreateSlotArrays(const Device& device, const Options& options);
+    static DescriptorSetLayout CreateLayout(const Device& device,
+                                            const std::array<SlotArray, 4>& arrays,
+                                            VkShaderStageFlags stage_flags);
+    static DescriptorPool CreatePool(const Device& device, const std::array<SlotArray, 4>& arrays);
+
+    uint32_t AcquireSlot(BindlessResourceType type);
+    void WriteDescriptor(const SlotArray& array,
+                         uint32_t slot,
+                         const VkDescriptorImageInfo* image_info,
+                         const VkDescriptorBufferInfo* buffer_info) const;
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RESOURCES_BINDLESS_TABLE_HPP
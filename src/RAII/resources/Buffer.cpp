@@ -1,7 +1,14 @@
 #include "Buffer.hpp"
 
 #include "VmaAllocator.hpp"
+#include "MemoryPool.hpp"
+#include "BufferCopyBatch.hpp"
 #include "../core/Device.hpp"
+#include "../rendering/CommandBuffer.hpp"
+#include "../sync/BarrierBatcher.hpp"
+#include "../utils/HostAllocator.hpp"
+#include "../utils/SyncUtils.hpp"
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <stdexcept>
@@ -10,22 +17,6 @@
 
 namespace VulkanEngine::RAII {
 
-namespace {
-void SetDebugNameInternal(VkDevice device, VkBuffer buffer, const char* name)
-{
-    if (!device || !buffer || !name) {
-        return;
-    }
-    if (vkSetDebugUtilsObjectNameEXT) {
-        VkDebugUtilsObjectNameInfoEXT info{VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT};
-        info.objectType = VK_OBJECT_TYPE_BUFFER;
-        info.objectHandle = reinterpret_cast<uint64_t>(buffer);
-        info.pObjectName = name;
-        vkSetDebugUtilsObjectNameEXT(device, &info);
-    }
-}
-} // namespace
-
 Buffer::Buffer(const VmaAllocator& allocator,
                VkDeviceSize size,
                VkBufferUsageFlags usage,
@@ -38,18 +29,49 @@ Buffer::Buffer(const VmaAllocator& allocator,
     device_(allocator.GetDevice()),
     usingVMA_(true)
 {
-    VkBufferCreateInfo buffer_info{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
-    buffer_info.size = size;
-    buffer_info.usage = usage;
-    buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
     VmaAllocationCreateInfo alloc_info{};
     alloc_info.usage = memory_usage;
     alloc_info.flags = flags;
+    CreateVmaBuffer(allocator, alloc_info);
 
-    if (allocator.CreateBuffer(buffer_info, alloc_info, buffer_, allocation_, &allocationInfo_) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to create VMA buffer");
+    if (name) {
+        SetDebugName(name);
+    }
+}
+
+Buffer::Buffer(const VmaAllocator& allocator,
+               VkDeviceSize size,
+               VkBufferUsageFlags usage,
+               const VmaAllocationCreateInfo& allocation_info,
+               const char* name)
+    : size_(size),
+    usage_(usage),
+    vmaAllocator_(allocator.GetHandle()),
+    device_(allocator.GetDevice()),
+    usingVMA_(true)
+{
+    CreateVmaBuffer(allocator, allocation_info);
+
+    if (name) {
+        SetDebugName(name);
     }
+}
+
+Buffer::Buffer(const MemoryPool& pool,
+               VkDeviceSize size,
+               VkBufferUsageFlags usage,
+               VmaAllocationCreateFlags flags,
+               const char* name)
+    : size_(size),
+    usage_(usage),
+    vmaAllocator_(pool.GetAllocator().GetHandle()),
+    device_(pool.GetAllocator().GetDevice()),
+    usingVMA_(true)
+{
+    VmaAllocationCreateInfo alloc_info{};
+    alloc_info.pool = pool.GetHandle();
+    alloc_info.flags = flags;
+    CreateVmaBuffer(pool.GetAllocator(), alloc_info);
 
     if (name) {
         SetDebugName(name);
@@ -69,6 +91,7 @@ Buffer::Buffer(const Device& device,
     if (device.CreateBuffer(size, usage, properties, buffer_, memory_) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create device buffer");
     }
+    QueryDeviceAddress();
 
     if (name) {
         SetDebugName(name);
@@ -84,6 +107,7 @@ Buffer::Buffer(Buffer&& other) noexcept
     : buffer_(other.buffer_),
     size_(other.size_),
     usage_(other.usage_),
+    deviceAddress_(other.deviceAddress_),
     vmaAllocator_(other.vmaAllocator_),
     allocation_(other.allocation_),
     allocationInfo_(other.allocationInfo_),
@@ -91,14 +115,17 @@ Buffer::Buffer(Buffer&& other) noexcept
     memory_(other.memory_),
     memoryProperties_(other.memoryProperties_),
     usingVMA_(other.usingVMA_),
+    persistentlyMapped_(other.persistentlyMapped_),
     mappedData_(other.mappedData_),
-    debugName_(std::move(other.debugName_))
+    debugName_(std::move(other.debugName_)),
+    trackedState_(other.trackedState_)
 {
     other.buffer_ = VK_NULL_HANDLE;
     other.allocation_ = VK_NULL_HANDLE;
     other.memory_ = VK_NULL_HANDLE;
     other.mappedData_ = nullptr;
     other.usingVMA_ = false;
+    other.persistentlyMapped_ = false;
 }
 
 Buffer& Buffer::operator=(Buffer&& other) noexcept {
@@ -107,6 +134,7 @@ Buffer& Buffer::operator=(Buffer&& other) noexcept {
         buffer_ = other.buffer_;
         size_ = other.size_;
         usage_ = other.usage_;
+        deviceAddress_ = other.deviceAddress_;
         vmaAllocator_ = other.vmaAllocator_;
         allocation_ = other.allocation_;
         allocationInfo_ = other.allocationInfo_;
@@ -114,18 +142,59 @@ Buffer& Buffer::operator=(Buffer&& other) noexcept {
         memory_ = other.memory_;
         memoryProperties_ = other.memoryProperties_;
         usingVMA_ = other.usingVMA_;
+        persistentlyMapped_ = other.persistentlyMapped_;
         mappedData_ = other.mappedData_;
         debugName_ = std::move(other.debugName_);
+        trackedState_ = other.trackedState_;
 
         other.buffer_ = VK_NULL_HANDLE;
         other.allocation_ = VK_NULL_HANDLE;
         other.memory_ = VK_NULL_HANDLE;
         other.mappedData_ = nullptr;
         other.usingVMA_ = false;
+        other.persistentlyMapped_ = false;
     }
     return *this;
 }
 
+void Buffer::CreateVmaBuffer(const VmaAllocator& allocator, const VmaAllocationCreateInfo& alloc_info)
+{
+    VkBufferCreateInfo buffer_info{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    buffer_info.size = size_;
+    buffer_info.usage = usage_;
+    buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (allocator.CreateBuffer(buffer_info, alloc_info, buffer_, allocation_, &allocationInfo_) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create VMA buffer");
+    }
+    QueryDeviceAddress();
+
+    if ((alloc_info.flags & VMA_ALLOCATION_CREATE_MAPPED_BIT) && allocationInfo_.pMappedData) {
+        // VMA owns this mapping for the lifetime of the allocation
+        persistentlyMapped_ = true;
+        mappedData_ = allocationInfo_.pMappedData;
+    }
+}
+
+VkDeviceAddress Buffer::GetDeviceAddress() const
+{
+    if ((usage_ & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) == 0) {
+        throw std::runtime_error("Buffer was not created with SHADER_DEVICE_ADDRESS usage");
+    }
+    return deviceAddress_;
+}
+
+void Buffer::QueryDeviceAddress()
+{
+    if ((usage_ & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) == 0) {
+        deviceAddress_ = 0;
+        return;
+    }
+    VkBufferDeviceAddressInfo address_info{VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO};
+    address_info.buffer = buffer_;
+    deviceAddress_ = vkGetBufferDeviceAddress(device_, &address_info);
+}
+
 void* Buffer::Map()
 {
     if (!usingVMA_) {
@@ -141,7 +210,7 @@ void* Buffer::Map()
 
 void Buffer::Unmap()
 {
-    if (usingVMA_ && mappedData_) {
+    if (usingVMA_ && mappedData_ && !persistentlyMapped_) {
         vmaUnmapMemory(vmaAllocator_, allocation_);
         mappedData_ = nullptr;
     }
@@ -246,8 +315,24 @@ void Buffer::Invalidate(VkDeviceSize size, VkDeviceSize offset)
     vkInvalidateMappedMemoryRanges(device_, 1, &range);
 }
 
-void Buffer::CopyFrom(const Buffer& /*srcBuffer*/, VkDeviceSize /*size*/, VkDeviceSize /*srcOffset*/, VkDeviceSize /*dstOffset*/) {
-    throw std::runtime_error("copyFrom without command buffer is not implemented; use the command buffer overload");
+void Buffer::CopyFrom(BufferCopyBatch& batch, const Buffer& src_buffer, VkDeviceSize size,
+                      VkDeviceSize src_offset, VkDeviceSize dst_offset) {
+    if (src_offset >= src_buffer.GetSize() || dst_offset >= size_) {
+        throw std::out_of_range("CopyFrom offset exceeds buffer size");
+    }
+
+    const VkDeviceSize copy_size = (size == VK_WHOLE_SIZE)
+        ? std::min(src_buffer.GetSize() - src_offset, size_ - dst_offset)
+        : size;
+    if (src_offset + copy_size > src_buffer.GetSize() || dst_offset + copy_size > size_) {
+        throw std::out_of_range("CopyFrom range exceeds buffer size");
+    }
+
+    VkBufferCopy copy_region{};
+    copy_region.srcOffset = src_offset;
+    copy_region.dstOffset = dst_offset;
+    copy_region.size = copy_size;
+    batch.Enqueue(src_buffer.GetHandle(), buffer_, copy_region);
 }
 
 void Buffer::CopyFrom(VkCommandBuffer command_buffer,
@@ -265,11 +350,50 @@ void Buffer::CopyFrom(VkCommandBuffer command_buffer,
 
 void Buffer::SetDebugName(const char* name)
 {
+    if constexpr (!Utils::DEBUG_NAMES_ENABLED) {
+        return;
+    }
     if (!name) {
         return;
     }
-    debugName_ = name;
-    SetDebugNameInternal(device_, buffer_, name);
+    debugName_.Set(name);
+    Utils::SetObjectName(device_, VK_OBJECT_TYPE_BUFFER, buffer_, name);
+    if (usingVMA_ && allocation_ != VK_NULL_HANDLE) {
+        // MemoryStatistics::QueryNamedUsage reads it back
+        vmaSetAllocationName(vmaAllocator_, allocation_, name);
+    }
+}
+
+void Buffer::ReleaseOwnership(const CommandBuffer& command_buffer, const OwnershipTransfer& transfer) const {
+    ReleaseOwnership(command_buffer, transfer, 0, VK_WHOLE_SIZE);
+}
+
+void Buffer::ReleaseOwnership(const CommandBuffer& command_buffer,
+                              const OwnershipTransfer& transfer,
+                              VkDeviceSize offset,
+                              VkDeviceSize size) const {
+    if (!transfer.ChangesFamily()) {
+        return;
+    }
+    const VkBufferMemoryBarrier2KHR barrier = Utils::SyncUtils::CreateOwnershipBarrier(buffer_, transfer, true, offset, size);
+    command_buffer.FlushBarriers();
+    command_buffer.PipelineBarrier2({}, std::span<const VkBufferMemoryBarrier2KHR>(&barrier, 1));
+}
+
+void Buffer::AcquireOwnership(const CommandBuffer& command_buffer, const OwnershipTransfer& transfer) {
+    AcquireOwnership(command_buffer, transfer, 0, VK_WHOLE_SIZE);
+}
+
+void Buffer::AcquireOwnership(const CommandBuffer& command_buffer,
+                              const OwnershipTransfer& transfer,
+                              VkDeviceSize offset,
+                              VkDeviceSize size) {
+    const VkBufferMemoryBarrier2KHR barrier = Utils::SyncUtils::CreateOwnershipBarrier(buffer_, transfer, false, offset, size);
+    command_buffer.FlushBarriers();
+    command_buffer.PipelineBarrier2({}, std::span<const VkBufferMemoryBarrier2KHR>(&barrier, 1));
+
+    // The acquire already made the destination stages wait
+    trackedState_ = BarrierBatcher::GetStateAfter(transfer.destinationAccess);
 }
 
 Buffer Buffer::CreateStaging(const VmaAllocator& allocator, VkDeviceSize size) {
@@ -344,6 +468,22 @@ Buffer Buffer::CreateStorageBuffer(const Device& device, VkDeviceSize size) {
                   VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 }
 
+Buffer Buffer::CreateDeviceAddressBuffer(const VmaAllocator& allocator,
+                                         VkDeviceSize size,
+                                         VkBufferUsageFlags usage,
+                                         const char* name) {
+    const Device* device = allocator.GetDeviceRef();
+    if (device && !device->SupportsBufferDeviceAddress()) {
+        throw std::runtime_error("Device does not support buffer device addresses");
+    }
+    return Buffer(allocator,
+                  size,
+                  usage | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                  VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+                  0,
+                  name);
+}
+
 void Buffer::Cleanup()
 {
     if (mappedData_) {
@@ -356,10 +496,10 @@ void Buffer::Cleanup()
         }
     } else {
         if (buffer_ != VK_NULL_HANDLE) {
-            vkDestroyBuffer(device_, buffer_, nullptr);
+            vkDestroyBuffer(device_, buffer_, Utils::HostAllocator::For(VK_OBJECT_TYPE_BUFFER));
         }
         if (memory_ != VK_NULL_HANDLE) {
-            vkFreeMemory(device_, memory_, nullptr);
+            vkFreeMemory(device_, memory_, Utils::HostAllocator::For(VK_OBJECT_TYPE_DEVICE_MEMORY));
         }
     }
     buffer_ = VK_NULL_HANDLE;
@@ -367,6 +507,7 @@ void Buffer::Cleanup()
     allocation_ = VK_NULL_HANDLE;
     device_ = VK_NULL_HANDLE;
     mappedData_ = nullptr;
+    persistentlyMapped_ = false;
 }
 
 } // namespace VulkanEngine::RAII
\ No newline at end of file
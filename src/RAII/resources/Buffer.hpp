@@ -5,10 +5,16 @@
 #include <vk_mem_alloc.h>
 #include <string>
 
+#include "../sync/ResourceState.hpp"
+#include "../utils/DebugUtils.hpp"
+
 namespace VulkanEngine::RAII {
 
 class Device; // Forward declaration
+class CommandBuffer; // Forward declaration
 class VmaAllocator; // Forward declaration
+class MemoryPool; // Forward declaration
+class BufferCopyBatch; // Forward declaration
 
 class Buffer {
 public:
@@ -20,6 +26,20 @@ public:
            VmaAllocationCreateFlags flags = 0,
            const char* name = nullptr);
 
+    // Constructor that creates a buffer with VMA from a full allocation create info (pool, priority, ...)
+    Buffer(const VmaAllocator& allocator,
+           VkDeviceSize size,
+           VkBufferUsageFlags usage,
+           const VmaAllocationCreateInfo& allocation_info,
+           const char* name = nullptr);
+
+    // Constructor that creates a buffer inside a custom VMA pool
+    Buffer(const MemoryPool& pool,
+           VkDeviceSize size,
+           VkBufferUsageFlags usage,
+           VmaAllocationCreateFlags flags = 0,
+           const char* name = nullptr);
+
     // Constructor that creates a buffer with traditional Vulkan memory management
     Buffer(const Device& device,
            VkDeviceSize size,
@@ -52,6 +72,20 @@ public:
     // Get buffer usage flags
     [[nodiscard]] VkBufferUsageFlags GetUsage() const { return usage_; }
 
+    // Device address (requires SHADER_DEVICE_ADDRESS usage and Device::SupportsBufferDeviceAddress()),
+    // queried once at creation, so it can be handed to shaders through push constants every
+    // draw. Changes when DefragmentationScheduler moves the buffer
+    [[nodiscard]] VkDeviceAddress GetDeviceAddress() const;
+
+    // Get the VMA allocation (VK_NULL_HANDLE for traditional memory)
+    [[nodiscard]] VmaAllocation GetAllocation() const { return allocation_; }
+
+    // Persistently mapped pointer (VMA_ALLOCATION_CREATE_MAPPED_BIT), or the current mapping if any
+    [[nodiscard]] void* GetMappedData() const { return mappedData_; }
+
+    // Check if the buffer was created persistently mapped
+    [[nodiscard]] bool IsPersistentlyMapped() const { return persistentlyMapped_; }
+
     // Memory mapping (for VMA)
     void* Map();
     void Unmap();
@@ -81,8 +115,8 @@ public:
     // Invalidate memory (for non-coherent memory)
     void Invalidate(VkDeviceSize size = VK_WHOLE_SIZE, VkDeviceSize offset = 0);
 
-    // Copy from another buffer
-    void CopyFrom(const Buffer& src_buffer, VkDeviceSize size = VK_WHOLE_SIZE, 
+    // Queue a copy from another buffer into batch (executed on its next flush)
+    void CopyFrom(BufferCopyBatch& batch, const Buffer& src_buffer, VkDeviceSize size = VK_WHOLE_SIZE,
                   VkDeviceSize src_offset = 0, VkDeviceSize dst_offset = 0);
 
     // Copy from another buffer using command buffer
@@ -90,11 +124,33 @@ public:
                   VkDeviceSize size = VK_WHOLE_SIZE, 
                   VkDeviceSize src_offset = 0, VkDeviceSize dst_offset = 0);
 
-    // Set debug name (for debugging)
+    // Set debug name (for debugging). Compiled out with VULKAN_RAII_DEBUG_NAMES=0
     void SetDebugName(const char* name);
 
-    // Get debug name
-    [[nodiscard]] const char* GetDebugName() const { return debugName_.c_str(); }
+    // Get debug name; empty when names are compiled out
+    [[nodiscard]] const char* GetDebugName() const { return debugName_.Get(); }
+
+    // Synchronization state of the whole buffer as left by the commands recorded through a BarrierBatcher
+    [[nodiscard]] const ResourceState& GetTrackedState() const { return trackedState_; }
+
+    // Overwrite the tracked state, e.g. after barriers recorded outside a BarrierBatcher or on another queue
+    void SetTrackedState(const ResourceState& state) { trackedState_ = state; }
+
+    // Queue family ownership transfer (see OwnershipTransfer), so an exclusive buffer can
+    // move between e.g. the transfer and graphics queues. Record the release into a command
+    // buffer of transfer.srcFamily and the acquire into one of transfer.dstFamily. Within
+    // one family the release records nothing and the acquire is a plain barrier. The ranged
+    // overloads hand over only [offset, offset + size), e.g. a sub-allocation being uploaded
+    void ReleaseOwnership(const CommandBuffer& command_buffer, const OwnershipTransfer& transfer) const;
+    void ReleaseOwnership(const CommandBuffer& command_buffer,
+                          const OwnershipTransfer& transfer,
+                          VkDeviceSize offset,
+                          VkDeviceSize size) const;
+    void AcquireOwnership(const CommandBuffer& command_buffer, const OwnershipTransfer& transfer);
+    void AcquireOwnership(const CommandBuffer& command_buffer,
+                          const OwnershipTransfer& transfer,
+                          VkDeviceSize offset,
+                          VkDeviceSize size);
 
     // Helper to create staging buffer
     static Buffer CreateStaging(const VmaAllocator& allocator, VkDeviceSize size);
@@ -116,10 +172,23 @@ public:
     static Buffer CreateStorageBuffer(const VmaAllocator& allocator, VkDeviceSize size);
     static Buffer CreateStorageBuffer(const Device& device, VkDeviceSize size);
 
+    // Helper to create a device-local buffer with SHADER_DEVICE_ADDRESS usage added to usage,
+    // for GPU-driven passes that reach buffers through pointers instead of descriptors.
+    // Throws std::runtime_error when the device lacks bufferDeviceAddress
+    static Buffer CreateDeviceAddressBuffer(const VmaAllocator& allocator,
+                                            VkDeviceSize size,
+                                            VkBufferUsageFlags usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                                                       VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                            const char* name = nullptr);
+
 private:
+    // Re-points the handle once a defragmentation move of the allocation completes
+    friend class DefragmentationScheduler;
+
     VkBuffer buffer_{VK_NULL_HANDLE};
     VkDeviceSize size_{0};
     VkBufferUsageFlags usage_{0};
+    VkDeviceAddress deviceAddress_{0}; // 0 without SHADER_DEVICE_ADDRESS usage
 
     // VMA allocation (raw VMA handle, not the RAII wrapper)
     ::VmaAllocator vmaAllocator_{VK_NULL_HANDLE};
@@ -132,12 +201,16 @@ private:
     VkMemoryPropertyFlags memoryProperties_{0};
 
     bool usingVMA_{false};
+    bool persistentlyMapped_{false};
     void* mappedData_{nullptr};
-    std::string debugName_;
+    [[no_unique_address]] Utils::DebugName debugName_; // Empty type when names are compiled out
+    ResourceState trackedState_{};
 
     // Helper methods
+    void CreateVmaBuffer(const VmaAllocator& allocator, const VmaAllocationCreateInfo& alloc_info);
     void CreateBuffer();
     void AllocateMemory(VkMemoryPropertyFlags properties);
+    void QueryDeviceAddress();
     void Cleanup();
 };
 
@@ -0,0 +1,245 @@
+#include "BufferCopyBatch.hpp"
+
+#include "../core/Device.hpp"
+#include "../rendering/Renderer.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+
+
+namespace VulkanEngine::RAII {
+
+namespace {
+bool Overlaps(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size,
+              VkBuffer other_buffer, VkDeviceSize other_offset, VkDeviceSize other_size)
+{
+    return buffer == other_buffer && offset < other_offset + other_size && other_offset < offset + size;
+}
+} // namespace
+
+BufferCopyBatch::BufferCopyBatch(const Device& device, const Queue& queue)
+    : device_(&device),
+    queue_(queue)
+{
+    if (!queue_.IsValid()) {
+        throw std::invalid_argument("BufferCopyBatch requires a valid queue");
+    }
+
+    commandPool_ = std::make_unique<CommandPool>(device,
+                                                 queue_.GetFamilyIndex(),
+                                                 VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+}
+
+BufferCopyBatch::~BufferCopyBatch()
+{
+    Detach();
+    try {
+        Flush();
+        WaitIdle();
+    } catch (const std::exception& e) {
+        std::cerr << "[BufferCopyBatch] Failed to drain copies on destruction: " << e.what() << '\n';
+    }
+}
+
+void BufferCopyBatch::Enqueue(VkBuffer src, VkBuffer dst, const VkBufferCopy& region)
+{
+    if (src == VK_NULL_HANDLE || dst == VK_NULL_HANDLE || region.size == 0) {
+        throw std::invalid_argument("BufferCopyBatch requires valid buffers and a non-zero size");
+    }
+    if (Overlaps(src, region.srcOffset, region.size, dst, region.dstOffset, region.size)) {
+        throw std::invalid_argument("BufferCopyBatch source and destination ranges overlap");
+    }
+
+    const auto overlaps = [](const std::vector<Range>& ranges, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size) {
+        return std::any_of(ranges.begin(), ranges.end(), [&](const Range& range) {
+            return Overlaps(buffer, offset, size, range.buffer, range.offset, range.size);
+        });
+    };
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Reading what an earlier copy writes, or overwriting what it reads or writes, must wait for it
+    const bool dependent = overlaps(written_, src, region.srcOffset, region.size) ||
+                           overlaps(written_, dst, region.dstOffset, region.size) ||
+                           overlaps(read_, dst, region.dstOffset, region.size);
+    if (dependent) {
+        read_.clear();
+        written_.clear();
+    }
+    read_.push_back(Range{src, region.srcOffset, region.size});
+    written_.push_back(Range{dst, region.dstOffset, region.size});
+
+    if (!dependent) {
+        // Join a copy of the same pair recorded since the last barrier
+        for (auto it = pending_.rbegin(); it != pending_.rend(); ++it) {
+            if (it->src == src && it->dst == dst) {
+                // Merge with the previous region when both ranges continue it
+                VkBufferCopy& last = it->regions.back();
+                if (last.srcOffset + last.size == region.srcOffset && last.dstOffset + last.size == region.dstOffset) {
+                    last.size += region.size;
+                } else {
+                    it->regions.push_back(region);
+                    ++pendingRegions_;
+                }
+                return;
+            }
+            if (it->barrierBefore) {
+                break;
+            }
+        }
+    }
+    pending_.push_back(Copy{src, dst, {region}, dependent});
+    ++pendingRegions_;
+}
+
+VkFence BufferCopyBatch::Flush(bool wait)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (pending_.empty()) {
+        VkFence last = inFlight_.empty() ? VK_NULL_HANDLE : inFlight_.back().fence->GetHandle();
+        lock.unlock();
+        if (wait && last != VK_NULL_HANDLE) {
+            WaitIdle();
+        }
+        return last;
+    }
+
+    RecycleCompleted();
+    Submission submission = AcquireSubmission();
+
+    VkCommandBufferBeginInfo begin_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if (vkBeginCommandBuffer(submission.commandBuffer, &begin_info) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to begin buffer copy command buffer");
+    }
+
+    // Earlier GPU writes to the sources/destinations must land before the copies run
+    VkMemoryBarrier before{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+    before.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+    before.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(submission.commandBuffer,
+                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 1, &before, 0, nullptr, 0, nullptr);
+
+    for (const Copy& copy : pending_) {
+        if (copy.barrierBefore) {
+            VkMemoryBarrier between{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+            between.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            between.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+            vkCmdPipelineBarrier(submission.commandBuffer,
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 0, 1, &between, 0, nullptr, 0, nullptr);
+        }
+        vkCmdCopyBuffer(submission.commandBuffer,
+                        copy.src,
+                        copy.dst,
+                        static_cast<uint32_t>(copy.regions.size()),
+                        copy.regions.data());
+    }
+
+    // Make the copied data visible to everything submitted to this queue afterwards
+    VkMemoryBarrier after{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+    after.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    after.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+    vkCmdPipelineBarrier(submission.commandBuffer,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                         0, 1, &after, 0, nullptr, 0, nullptr);
+
+    if (vkEndCommandBuffer(submission.commandBuffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to end buffer copy command buffer");
+    }
+
+    if (queue_.Submit(submission.commandBuffer, VK_NULL_HANDLE, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                      VK_NULL_HANDLE, submission.fence->GetHandle()) != VK_SUCCESS) {
+        freeSubmissions_.push_back(std::move(submission));
+        throw std::runtime_error("Failed to submit buffer copy batch");
+    }
+
+    pending_.clear();
+    pendingRegions_ = 0;
+    read_.clear();
+    written_.clear();
+
+    const VkFence fence = submission.fence->GetHandle();
+    inFlight_.push_back(std::move(submission));
+    lock.unlock();
+
+    if (wait && vkWaitForFences(device_->GetHandle(), 1, &fence, VK_TRUE, UINT64_MAX) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to wait for buffer copy batch");
+    }
+    return fence;
+}
+
+void BufferCopyBatch::WaitIdle()
+{
+    // Submissions on one queue complete in order, so the last fence covers the rest.
+    // Waiting without the lock lets other threads keep enqueueing and flushing
+    VkFence last = VK_NULL_HANDLE;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (inFlight_.empty()) {
+            return;
+        }
+        last = inFlight_.back().fence->GetHandle();
+    }
+    if (vkWaitForFences(device_->GetHandle(), 1, &last, VK_TRUE, UINT64_MAX) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to wait for buffer copy batch");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    RecycleCompleted();
+}
+
+void BufferCopyBatch::AttachToRenderer(Renderer& renderer)
+{
+    Detach();
+    frameBeginSubscription_ = renderer.SubscribeFrameBegin([this](uint32_t /*frame_index*/) {
+        Flush();
+    });
+}
+
+void BufferCopyBatch::Detach()
+{
+    frameBeginSubscription_.Reset();
+}
+
+size_t BufferCopyBatch::GetPendingRegionCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pendingRegions_;
+}
+
+size_t BufferCopyBatch::GetPendingCopyCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
+
+BufferCopyBatch::Submission BufferCopyBatch::AcquireSubmission()
+{
+    if (!freeSubmissions_.empty()) {
+        Submission submission = std::move(freeSubmissions_.back());
+        freeSubmissions_.pop_back();
+        (void)submission.fence->Reset();
+        if (vkResetCommandBuffer(submission.commandBuffer, 0) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to reset buffer copy command buffer");
+        }
+        return submission;
+    }
+
+    Submission submission;
+    submission.commandBuffer = commandPool_->AllocateCommandBuffer();
+    submission.fence = std::make_unique<Fence>(*device_);
+    return submission;
+}
+
+void BufferCopyBatch::RecycleCompleted()
+{
+    while (!inFlight_.empty() && inFlight_.front().fence->IsSignaled()) {
+        freeSubmissions_.push_back(std::move(inFlight_.front()));
+        inFlight_.pop_front();
+    }
+}
+
+} // namespace VulkanEngine::RAII
@@ -0,0 +1,104 @@
+#ifndef VULKAN_RAII_RESOURCES_BUFFER_COPY_BATCH_HPP
+#define VULKAN_RAII_RESOURCES_BUFFER_COPY_BATCH_HPP
+
+#include <volk.h>
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../core/Queue.hpp"
+#include "../rendering/CommandPool.hpp"
+#include "../rendering/FrameBeginSubscription.hpp"
+#include "../sync/Fence.hpp"
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+class Renderer; // Forward declaration
+
+// Queue of deferred buffer -> buffer copies, owned by the caller and handed to
+// Buffer::CopyFrom. Copies run in the order they were queued: those between the
+// same pair of buffers are coalesced into a single vkCmdCopyBuffer until a copy
+// reads or overwrites a range an earlier one touched, which gets a transfer ->
+// transfer barrier in front of it. The whole batch goes out in one submission on
+// Flush() (or at the next Renderer::BeginFrame when attached).
+class BufferCopyBatch {
+public:
+    // Constructor that creates the command pool
+    BufferCopyBatch(const Device& device, const Queue& queue);
+
+    // Destructor flushes and waits for pending copies
+    ~BufferCopyBatch();
+
+    // Delete copy and move. the attached renderer holds a callback referencing this object.
+    BufferCopyBatch(const BufferCopyBatch&) = delete;
+    BufferCopyBatch& operator=(const BufferCopyBatch&) = delete;
+    BufferCopyBatch(BufferCopyBatch&&) = delete;
+    BufferCopyBatch& operator=(BufferCopyBatch&&) = delete;
+
+    // Queue a copy region from src to dst (after every copy queued before it)
+    void Enqueue(VkBuffer src, VkBuffer dst, const VkBufferCopy& region);
+
+    // Record and submit every queued copy. Returns the fence of the submission
+    // (the previous one when nothing was queued, or VK_NULL_HANDLE); if wait is set the call blocks on it.
+    // The fence stays owned by the batch and may be reused by a later Flush() once signaled
+    VkFence Flush(bool wait = false);
+
+    // Block until every submitted batch has completed
+    void WaitIdle();
+
+    // Flush automatically from Renderer::BeginFrame. The renderer must outlive
+    // this batch or Detach() must be called first
+    void AttachToRenderer(Renderer& renderer);
+    void Detach();
+
+    // Number of queued regions / vkCmdCopyBuffer calls the next flush will record
+    [[nodiscard]] size_t GetPendingRegionCount() const;
+    [[nodiscard]] size_t GetPendingCopyCount() const;
+
+private:
+    struct Submission {
+        VkCommandBuffer commandBuffer{VK_NULL_HANDLE};
+        std::unique_ptr<Fence> fence;
+    };
+
+    // One vkCmdCopyBuffer
+    struct Copy {
+        VkBuffer src{VK_NULL_HANDLE};
+        VkBuffer dst{VK_NULL_HANDLE};
+        std::vector<VkBufferCopy> regions;
+        bool barrierBefore{false}; // Depends on a copy recorded before it
+    };
+
+    struct Range {
+        VkBuffer buffer{VK_NULL_HANDLE};
+        VkDeviceSize offset{0};
+        VkDeviceSize size{0};
+    };
+
+    const Device* device_{nullptr};
+    Queue queue_;
+    std::unique_ptr<CommandPool> commandPool_;
+
+    std::vector<Copy> pending_; // Queue order
+    size_t pendingRegions_{0};
+    // Ranges read and written since the last barrier; copies among them may run in any order
+    std::vector<Range> read_;
+    std::vector<Range> written_;
+    mutable std::mutex mutex_;
+
+    std::deque<Submission> inFlight_;
+    std::vector<Submission> freeSubmissions_;
+
+    FrameBeginSubscription frameBeginSubscription_;
+
+    Submission AcquireSubmission();
+    void RecycleCompleted();
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RESOURCES_BUFFER_COPY_BATCH_HPP
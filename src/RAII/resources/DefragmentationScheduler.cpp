@@ -0,0 +1,385 @@
+#include "DefragmentationScheduler.hpp"
+
+#include "Buffer.hpp"
+#include "Image.hpp"
+#include "VmaAllocator.hpp"
+#include "../rendering/CommandBuffer.hpp"
+#include "../rendering/Renderer.hpp"
+#include "../utils/ImageUtils.hpp"
+#include "../utils/HostAllocator.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+
+namespace VulkanEngine::RAII {
+
+namespace {
+constexpr VkBufferUsageFlags BUFFER_MOVE_USAGE = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+constexpr VkImageUsageFlags IMAGE_MOVE_USAGE = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+} // namespace
+
+DefragmentationScheduler::DefragmentationScheduler(const VmaAllocator& allocator, const Settings& settings)
+    : allocator_(&allocator),
+    settings_(settings) {}
+
+DefragmentationScheduler::DefragmentationScheduler(const VmaAllocator& allocator)
+    : DefragmentationScheduler(allocator, Settings{}) {}
+
+DefragmentationScheduler::~DefragmentationScheduler()
+{
+    Detach();
+    try {
+        while (passState_ != PassState::IDLE) {
+            CompletePass();
+        }
+        if (context_ != VK_NULL_HANDLE) {
+            Finish();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[DefragmentationScheduler] Failed to finish defragmentation on destruction: " << e.what() << '\n';
+    }
+}
+
+void DefragmentationScheduler::Register(Buffer& buffer, MovedCallback on_moved)
+{
+    if (!buffer.usingVMA_ || buffer.allocation_ == VK_NULL_HANDLE) {
+        throw std::invalid_argument("Only VMA buffers can be defragmented");
+    }
+    if ((buffer.usage_ & BUFFER_MOVE_USAGE) != BUFFER_MOVE_USAGE) {
+        throw std::invalid_argument("Defragmented buffers require transfer src and dst usage");
+    }
+    Target target{};
+    target.buffer = &buffer;
+    target.onMoved = std::move(on_moved);
+    targets_[buffer.allocation_] = std::move(target);
+}
+
+void DefragmentationScheduler::Register(Image& image, VkImageLayout layout, MovedCallback on_moved)
+{
+    if (!image.usingVMA_ || image.allocation_ == VK_NULL_HANDLE) {
+        throw std::invalid_argument("Only VMA images can be defragmented");
+    }
+    if ((image.usage_ & IMAGE_MOVE_USAGE) != IMAGE_MOVE_USAGE) {
+        throw std::invalid_argument("Defragmented images require transfer src and dst usage");
+    }
+    if (layout == VK_IMAGE_LAYOUT_UNDEFINED || layout == VK_IMAGE_LAYOUT_PREINITIALIZED) {
+        throw std::invalid_argument("Defragmented images require a defined layout");
+    }
+    Target target{};
+    target.image = &image;
+    target.layout = layout;
+    target.onMoved = std::move(on_moved);
+    targets_[image.allocation_] = std::move(target);
+}
+
+void DefragmentationScheduler::Unregister(const Buffer& buffer)
+{
+    const VmaAllocation allocation = buffer.allocation_;
+    if (std::any_of(pendingMoves_.begin(), pendingMoves_.end(),
+                    [allocation](const PendingMove& move) { return move.allocation == allocation; })) {
+        throw std::logic_error("Cannot unregister a buffer that is being moved");
+    }
+    targets_.erase(allocation);
+}
+
+void DefragmentationScheduler::Unregister(const Image& image)
+{
+    const VmaAllocation allocation = image.allocation_;
+    if (std::any_of(pendingMoves_.begin(), pendingMoves_.end(),
+                    [allocation](const PendingMove& move) { return move.allocation == allocation; })) {
+        throw std::logic_error("Cannot unregister an image that is being moved");
+    }
+    targets_.erase(allocation);
+}
+
+void DefragmentationScheduler::Start()
+{
+    if (context_ != VK_NULL_HANDLE) {
+        return;
+    }
+
+    ::VmaDefragmentationInfo info{};
+    info.flags = settings_.algorithm;
+    info.pool = settings_.pool;
+    info.maxBytesPerPass = settings_.maxBytesPerPass;
+    info.maxAllocationsPerPass = settings_.maxAllocationsPerPass;
+    if (allocator_->BeginDefragmentation(info, context_) != VK_SUCCESS) {
+        context_ = VK_NULL_HANDLE;
+        throw std::runtime_error("Failed to begin VMA defragmentation");
+    }
+}
+
+bool DefragmentationScheduler::Step(const CommandBuffer& command_buffer)
+{
+    if (context_ == VK_NULL_HANDLE || passState_ != PassState::IDLE) {
+        return false;
+    }
+
+    passInfo_ = {};
+    const VkResult result = vmaBeginDefragmentationPass(allocator_->GetHandle(), context_, &passInfo_);
+    if (result == VK_SUCCESS) {
+        // Nothing left to move
+        Finish();
+        return false;
+    }
+    if (result != VK_INCOMPLETE) {
+        throw std::runtime_error("Failed to begin VMA defragmentation pass");
+    }
+
+    const VkCommandBuffer cmd = command_buffer.GetHandle();
+
+    // Earlier writes to the moved resources must land before they are copied
+    VkMemoryBarrier before{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+    before.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+    before.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    vkCmdPipelineBarrier(cmd,
+                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 1, &before, 0, nullptr, 0, nullptr);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < passInfo_.moveCount; ++i) {
+        ::VmaDefragmentationMove& move = passInfo_.pMoves[i];
+        auto it = targets_.find(move.srcAllocation);
+
+        // Unknown allocations and everything past the CPU budget stay where they are this pass
+        const bool over_budget = std::chrono::steady_clock::now() - start > settings_.maxCpuTimePerPass;
+        if (it == targets_.end() || over_budget) {
+            move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+            continue;
+        }
+
+        const bool recorded = it->second.buffer ? RecordBufferMove(cmd, move, it->second)
+                                                : RecordImageMove(cmd, move, it->second);
+        if (!recorded) {
+            move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+        }
+    }
+
+    // Make the copies visible to whatever uses the new handles afterwards
+    VkMemoryBarrier after{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+    after.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    after.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                         0, 1, &after, 0, nullptr, 0, nullptr);
+
+    if (pendingMoves_.empty()) {
+        // Every move was ignored; there is no GPU work to wait for
+        Retire();
+        return true;
+    }
+    passState_ = PassState::COPYING;
+    passWaitValue_ = renderer_ ? renderer_->GetFrameTimelineValue() : 0;
+    return true;
+}
+
+void DefragmentationScheduler::CompletePass()
+{
+    if (passState_ == PassState::COPYING) {
+        Repoint();
+        // Frames recorded so far still reference the old handles
+        passState_ = PassState::RETIRING;
+        passWaitValue_ = renderer_ ? renderer_->GetFrameTimelineValue() - 1 : 0;
+    } else if (passState_ == PassState::RETIRING) {
+        Retire();
+    }
+}
+
+void DefragmentationScheduler::AttachToRenderer(Renderer& renderer)
+{
+    Detach();
+    renderer_ = &renderer;
+    frameBeginSubscription_ = renderer.SubscribeFrameBegin([this](uint32_t /*frame_index*/) {
+        if (passState_ != PassState::IDLE && renderer_->IsFrameRetired(passWaitValue_)) {
+            CompletePass();
+        }
+    });
+}
+
+void DefragmentationScheduler::Detach()
+{
+    frameBeginSubscription_.Reset();
+    renderer_ = nullptr;
+}
+
+void DefragmentationScheduler::Repoint()
+{
+    // The copies are done: commands recorded from now on use the new handles and memory
+    for (PendingMove& pending : pendingMoves_) {
+        Target& target = targets_.at(pending.allocation);
+        if (target.buffer) {
+            Buffer& buffer = *target.buffer;
+            pending.oldBuffer = buffer.buffer_;
+            buffer.buffer_ = pending.newBuffer;
+            buffer.QueryDeviceAddress();
+            vmaGetAllocationInfo(allocator_->GetHandle(), pending.newAllocation, &buffer.allocationInfo_);
+            if (buffer.persistentlyMapped_) {
+                buffer.mappedData_ = buffer.allocationInfo_.pMappedData;
+            }
+            if (!buffer.debugName_.IsEmpty()) {
+                buffer.SetDebugName(std::string(buffer.debugName_.Get()).c_str());
+            }
+        } else {
+            Image& image = *target.image;
+            pending.oldImage = image.image_;
+            pending.oldViews = image.DetachViews(); // Recreated for the new handle on the next GetView
+            image.image_ = pending.newImage;
+            vmaGetAllocationInfo(allocator_->GetHandle(), pending.newAllocation, &image.allocationInfo_);
+        }
+        if (target.onMoved) {
+            target.onMoved();
+        }
+    }
+}
+
+void DefragmentationScheduler::Retire()
+{
+    // srcAllocation takes over the new memory and the old memory is freed
+    const VkResult result = vmaEndDefragmentationPass(allocator_->GetHandle(), context_, &passInfo_);
+
+    const VkDevice device = allocator_->GetDevice();
+    for (PendingMove& pending : pendingMoves_) {
+        Target& target = targets_.at(pending.allocation);
+        if (target.buffer) {
+            vkDestroyBuffer(device, pending.oldBuffer, Utils::HostAllocator::For(VK_OBJECT_TYPE_BUFFER));
+            vmaGetAllocationInfo(allocator_->GetHandle(), target.buffer->allocation_, &target.buffer->allocationInfo_);
+        } else {
+            pending.oldViews.reset();
+            vkDestroyImage(device, pending.oldImage, Utils::HostAllocator::For(VK_OBJECT_TYPE_IMAGE));
+            vmaGetAllocationInfo(allocator_->GetHandle(), target.image->allocation_, &target.image->allocationInfo_);
+        }
+    }
+    pendingMoves_.clear();
+    passState_ = PassState::IDLE;
+
+    if (result == VK_SUCCESS) {
+        Finish();
+    }
+}
+
+bool DefragmentationScheduler::RecordBufferMove(VkCommandBuffer cmd,
+                                                const ::VmaDefragmentationMove& move,
+                                                const Target& target)
+{
+    const Buffer& buffer = *target.buffer;
+    const VkDevice device = allocator_->GetDevice();
+
+    VkBufferCreateInfo buffer_info{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    buffer_info.size = buffer.size_;
+    buffer_info.usage = buffer.usage_;
+    buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VkBuffer new_buffer = VK_NULL_HANDLE;
+    if (vkCreateBuffer(device, &buffer_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_BUFFER), &new_buffer) != VK_SUCCESS) {
+        return false;
+    }
+    if (vmaBindBufferMemory(allocator_->GetHandle(), move.dstTmpAllocation, new_buffer) != VK_SUCCESS) {
+        vkDestroyBuffer(device, new_buffer, Utils::HostAllocator::For(VK_OBJECT_TYPE_BUFFER));
+        return false;
+    }
+
+    VkBufferCopy region{};
+    region.size = buffer.size_;
+    vkCmdCopyBuffer(cmd, buffer.buffer_, new_buffer, 1, &region);
+
+    PendingMove pending{};
+    pending.allocation = move.srcAllocation;
+    pending.newAllocation = move.dstTmpAllocation;
+    pending.newBuffer = new_buffer;
+    pendingMoves_.push_back(pending);
+    return true;
+}
+
+bool DefragmentationScheduler::RecordImageMove(VkCommandBuffer cmd,
+                                               const ::VmaDefragmentationMove& move,
+                                               const Target& target)
+{
+    const Image& image = *target.image;
+    const VkDevice device = allocator_->GetDevice();
+
+    VkImageCreateInfo image_info{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+    image_info.imageType = image.imageType_;
+    image_info.extent = {image.width_, image.height_, image.depth_};
+    image_info.mipLevels = image.mipLevels_;
+    image_info.arrayLayers = image.arrayLayers_;
+    image_info.format = image.format_;
+    image_info.tiling = image.tiling_;
+    image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    image_info.usage = image.usage_;
+    image_info.samples = image.samples_;
+    image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VkImage new_image = VK_NULL_HANDLE;
+    if (vkCreateImage(device, &image_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_IMAGE), &new_image) != VK_SUCCESS) {
+        return false;
+    }
+    if (vmaBindImageMemory(allocator_->GetHandle(), move.dstTmpAllocation, new_image) != VK_SUCCESS) {
+        vkDestroyImage(device, new_image, Utils::HostAllocator::For(VK_OBJECT_TYPE_IMAGE));
+        return false;
+    }
+
+    const VkImageAspectFlags aspect = Utils::ImageUtils::GetImageAspectFlags(image.format_);
+    VkImageMemoryBarrier to_copy[2] = {
+        Utils::ImageUtils::CreateImageMemoryBarrier(image.image_, target.layout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                                    aspect, 0, image.mipLevels_, 0, image.arrayLayers_),
+        Utils::ImageUtils::CreateImageMemoryBarrier(new_image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                    aspect, 0, image.mipLevels_, 0, image.arrayLayers_)};
+    to_copy[0].srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+    to_copy[0].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    to_copy[1].srcAccessMask = 0;
+    to_copy[1].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd,
+                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 0, nullptr, 0, nullptr, 2, to_copy);
+
+    std::vector<VkImageCopy> regions;
+    regions.reserve(image.mipLevels_);
+    for (uint32_t level = 0; level < image.mipLevels_; ++level) {
+        uint32_t mip_width = 0;
+        uint32_t mip_height = 0;
+        uint32_t mip_depth = 0;
+        Utils::ImageUtils::GetMipLevelDimensions(image.width_, image.height_, image.depth_, level,
+                                                 mip_width, mip_height, mip_depth);
+        const VkImageSubresourceLayers layers = Utils::ImageUtils::CreateSubresourceLayers(aspect, level, 0, image.arrayLayers_);
+        regions.push_back(Utils::ImageUtils::CreateImageCopy(layers, {0, 0, 0}, layers, {0, 0, 0},
+                                                             {mip_width, mip_height, mip_depth}));
+    }
+    vkCmdCopyImage(cmd,
+                   image.image_, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                   new_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                   static_cast<uint32_t>(regions.size()), regions.data());
+
+    // Both images return to the tracked layout: the old one is used until the re-point
+    VkImageMemoryBarrier to_layout[2] = {
+        Utils::ImageUtils::CreateImageMemoryBarrier(image.image_, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, target.layout,
+                                                    aspect, 0, image.mipLevels_, 0, image.arrayLayers_),
+        Utils::ImageUtils::CreateImageMemoryBarrier(new_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, target.layout,
+                                                    aspect, 0, image.mipLevels_, 0, image.arrayLayers_)};
+    to_layout[0].srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    to_layout[0].dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+    to_layout[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    to_layout[1].dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                         0, 0, nullptr, 0, nullptr, 2, to_layout);
+
+    PendingMove pending{};
+    pending.allocation = move.srcAllocation;
+    pending.newAllocation = move.dstTmpAllocation;
+    pending.newImage = new_image;
+    pendingMoves_.push_back(pending);
+    return true;
+}
+
+void DefragmentationScheduler::Finish()
+{
+    lastStats_ = {};
+    (void)allocator_->EndDefragmentation(context_, &lastStats_);
+    context_ = VK_NULL_HANDLE;
+}
+
+} // namespace VulkanEngine::RAII
@@ -0,0 +1,134 @@
+#ifndef VULKAN_RAII_RESOURCES_DEFRAGMENTATION_SCHEDULER_HPP
+#define VULKAN_RAII_RESOURCES_DEFRAGMENTATION_SCHEDULER_HPP
+
+#include <volk.h>
+#include <vk_mem_alloc.h>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "../rendering/FrameBeginSubscription.hpp"
+
+namespace VulkanEngine::RAII {
+
+class VmaAllocator; // Forward declaration
+class Buffer; // Forward declaration
+class Image; // Forward declaration
+class CommandBuffer; // Forward declaration
+class Renderer; // Forward declaration
+
+// Runs VMA defragmentation incrementally, one bounded pass per frame. Each pass
+// records its move copies into the frame's command buffer; once that frame has
+// completed the registered Buffer/Image objects are re-pointed at their new
+// handles. Frames recorded before the re-point still use the old handles and
+// memory, so those are released only after every one of them has completed too.
+// Only registered resources are moved. They must stay at the same address while
+// registered, and neither the GPU nor the host may write them between the frame
+// that records a pass and the re-point (the copies would not carry the writes).
+class DefragmentationScheduler {
+public:
+    // Invoked after a resource was re-pointed (recreate views, descriptors, ...)
+    using MovedCallback = std::function<void()>;
+
+    struct Settings {
+        VmaDefragmentationFlags algorithm{VMA_DEFRAGMENTATION_FLAG_ALGORITHM_BALANCED_BIT};
+        VkDeviceSize maxBytesPerPass{16ull * 1024 * 1024};
+        uint32_t maxAllocationsPerPass{64};
+        std::chrono::microseconds maxCpuTimePerPass{500};
+        ::VmaPool pool{VK_NULL_HANDLE}; // Defragment a custom pool instead of the default ones
+    };
+
+    // Constructor
+    DefragmentationScheduler(const VmaAllocator& allocator, const Settings& settings);
+    explicit DefragmentationScheduler(const VmaAllocator& allocator);
+
+    // Destructor (the last recorded pass must have completed on the GPU)
+    ~DefragmentationScheduler();
+
+    // Delete copy and move. the attached renderer holds a callback referencing this object.
+    DefragmentationScheduler(const DefragmentationScheduler&) = delete;
+    DefragmentationScheduler& operator=(const DefragmentationScheduler&) = delete;
+    DefragmentationScheduler(DefragmentationScheduler&&) = delete;
+    DefragmentationScheduler& operator=(DefragmentationScheduler&&) = delete;
+
+    // Allow a VMA resource to be moved (requires transfer src and dst usage).
+    // Images are copied and left in layout, which must be their layout whenever a pass is recorded
+    void Register(Buffer& buffer, MovedCallback on_moved = {});
+    void Register(Image& image, VkImageLayout layout, MovedCallback on_moved = {});
+    void Unregister(const Buffer& buffer);
+    void Unregister(const Image& image);
+
+    // Start a defragmentation run; passes are then recorded by Step()
+    void Start();
+    [[nodiscard]] bool IsRunning() const { return context_ != VK_NULL_HANDLE; }
+
+    // Record the next pass into command_buffer (ideally first in the frame).
+    // Returns false when nothing was recorded (not running, or a pass is still in flight)
+    bool Step(const CommandBuffer& command_buffer);
+
+    // Advance the recorded pass (automatic when attached): the first call re-points the
+    // moved resources and must follow completion of the pass's command buffer; the second
+    // releases the old handles and memory and must follow completion of everything
+    // recorded before the first call
+    void CompletePass();
+
+    // Advance passes from Renderer::BeginFrame once the frames they wait for have retired.
+    // The renderer must outlive this scheduler or Detach() must be called first
+    void AttachToRenderer(Renderer& renderer);
+    void Detach();
+
+    // Statistics of the last finished run
+    [[nodiscard]] const ::VmaDefragmentationStats& GetLastStats() const { return lastStats_; }
+
+private:
+    struct Target {
+        Buffer* buffer{nullptr};
+        Image* image{nullptr};
+        VkImageLayout layout{VK_IMAGE_LAYOUT_UNDEFINED};
+        MovedCallback onMoved;
+    };
+
+    struct PendingMove {
+        VmaAllocation allocation{VK_NULL_HANDLE};
+        VmaAllocation newAllocation{VK_NULL_HANDLE}; // The move's dstTmpAllocation
+        VkBuffer newBuffer{VK_NULL_HANDLE};
+        VkImage newImage{VK_NULL_HANDLE};
+        VkBuffer oldBuffer{VK_NULL_HANDLE};
+        VkImage oldImage{VK_NULL_HANDLE};
+        std::shared_ptr<void> oldViews; // Views of oldImage, kept until it is destroyed
+    };
+
+    enum class PassState {
+        IDLE,
+        COPYING, // Copies recorded; waiting for their frame
+        RETIRING // Re-pointed; waiting for the frames that still use the old handles
+    };
+
+    const VmaAllocator* allocator_{nullptr};
+    Settings settings_;
+    std::unordered_map<VmaAllocation, Target> targets_;
+
+    ::VmaDefragmentationContext context_{VK_NULL_HANDLE};
+    ::VmaDefragmentationPassMoveInfo passInfo_{};
+    std::vector<PendingMove> pendingMoves_;
+    PassState passState_{PassState::IDLE};
+    uint64_t passWaitValue_{0}; // Frame timeline value whose retirement advances passState_
+    ::VmaDefragmentationStats lastStats_{};
+
+    Renderer* renderer_{nullptr};
+    FrameBeginSubscription frameBeginSubscription_;
+
+    bool RecordBufferMove(VkCommandBuffer cmd, const ::VmaDefragmentationMove& move, const Target& target);
+    bool RecordImageMove(VkCommandBuffer cmd, const ::VmaDefragmentationMove& move, const Target& target);
+    void Repoint();
+    void Retire();
+    void Finish();
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RESOURCES_DEFRAGMENTATION_SCHEDULER_HPP
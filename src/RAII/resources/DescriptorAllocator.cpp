@@ -0,0 +1,154 @@
+#include "DescriptorAllocator.hpp"
+
+#include "DescriptorSetLayout.hpp"
+#include "../core/Device.hpp"
+#include "../rendering/CommandBuffer.hpp"
+#include "../rendering/Renderer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+
+namespace VulkanEngine::RAII {
+
+DescriptorAllocator::DescriptorAllocator(const Device& device,
+                                         uint32_t frame_count,
+                                         uint32_t initial_sets_per_pool,
+                                         const std::vector<PoolSizeRatio>& ratios)
+    : device_(&device),
+    ratios_(ratios),
+    setsPerPool_(std::clamp(initial_sets_per_pool, 1u, MAX_SETS_PER_POOL)),
+    frames_(std::max(1u, frame_count))
+{
+    if (ratios_.empty()) {
+        throw std::invalid_argument("DescriptorAllocator requires at least one pool size ratio");
+    }
+}
+
+DescriptorAllocator::~DescriptorAllocator()
+{
+    Detach();
+}
+
+void DescriptorAllocator::AttachToRenderer(Renderer& renderer)
+{
+    Detach();
+    if (renderer.GetMaxFramesInFlight() > frames_.size()) {
+        throw std::invalid_argument("DescriptorAllocator has fewer frames than the renderer has frames in flight");
+    }
+    frameBeginSubscription_ = renderer.SubscribeFrameBegin([this](uint32_t frame_index) {
+        BeginFrame(frame_index);
+    });
+}
+
+void DescriptorAllocator::Detach()
+{
+    frameBeginSubscription_.Reset();
+}
+
+void DescriptorAllocator::BeginFrame(uint32_t frame_index)
+{
+    currentFrame_ = frame_index % static_cast<uint32_t>(frames_.size());
+    FramePools& frame = frames_[currentFrame_];
+    for (DescriptorPool& pool : frame.pools) {
+        pool.Reset();
+    }
+    frame.current = 0;
+    frame.allocatedSets = 0;
+}
+
+VkDescriptorSet DescriptorAllocator::Allocate(VkDescriptorSetLayout layout, const void* next)
+{
+    if (layout == VK_NULL_HANDLE) {
+        throw std::invalid_argument("DescriptorAllocator requires a valid descriptor set layout");
+    }
+
+    FramePools& frame = frames_[currentFrame_];
+    while (true) {
+        const bool fresh_pool = frame.current == frame.pools.size();
+        if (fresh_pool) {
+            frame.pools.push_back(CreatePool());
+        }
+
+        VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
+        const VkResult result = frame.pools[frame.current].TryAllocateDescriptorSet(layout, descriptor_set, next);
+        if (result == VK_SUCCESS) {
+            ++frame.allocatedSets;
+            return descriptor_set;
+        }
+        if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL) {
+            throw std::runtime_error("Failed to allocate descriptor set");
+        }
+        if (fresh_pool) {
+            // An empty pool cannot hold it either: the layout needs types or counts the ratios do not cover
+            throw std::runtime_error("Descriptor set layout does not fit a DescriptorAllocator pool");
+        }
+        ++frame.current;
+    }
+}
+
+void DescriptorAllocator::PushDescriptorSet(const CommandBuffer& command_buffer,
+                                            VkPipelineBindPoint bind_point,
+                                            VkPipelineLayout pipeline_layout,
+                                            uint32_t set_index,
+                                            const DescriptorSetLayout& layout,
+                                            std::span<const VkWriteDescriptorSet> writes)
+{
+    if (layout.IsPushDescriptor()) {
+        command_buffer.PushDescriptorSet(bind_point, pipeline_layout, set_index, writes);
+        return;
+    }
+
+    const VkDescriptorSet descriptor_set = Allocate(layout.GetHandle());
+    std::vector<VkWriteDescriptorSet> set_writes(writes.begin(), writes.end());
+    for (VkWriteDescriptorSet& write : set_writes) {
+        write.dstSet = descriptor_set;
+    }
+    if (!set_writes.empty()) {
+        vkUpdateDescriptorSets(device_->GetHandle(), static_cast<uint32_t>(set_writes.size()), set_writes.data(), 0, nullptr);
+    }
+    command_buffer.BindDescriptorSets(bind_point, pipeline_layout, set_index, std::span<const VkDescriptorSet>(&descriptor_set, 1));
+}
+
+size_t DescriptorAllocator::GetPoolCount() const
+{
+    size_t count = 0;
+    for (const FramePools& frame : frames_) {
+        count += frame.pools.size();
+    }
+    return count;
+}
+
+std::vector<DescriptorAllocator::PoolSizeRatio> DescriptorAllocator::GetDefaultRatios()
+{
+    return {
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2.0f},
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.0f},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2.0f},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4.0f},
+        {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1.0f},
+        {VK_DESCRIPTOR_TYPE_SAMPLER, 1.0f},
+        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.0f}
+    };
+}
+
+DescriptorPool DescriptorAllocator::CreatePool()
+{
+    std::vector<VkDescriptorPoolSize> pool_sizes;
+    pool_sizes.reserve(ratios_.size());
+    for (const PoolSizeRatio& ratio : ratios_) {
+        const auto count = static_cast<uint32_t>(std::ceil(ratio.ratio * static_cast<float>(setsPerPool_)));
+        pool_sizes.push_back({ratio.type, std::max(1u, count)});
+    }
+    DescriptorPool pool(*device_, setsPerPool_, pool_sizes);
+
+    // Each pool added means the frame outgrew its pools, so the next one is larger
+    setsPerPool_ = std::min(setsPerPool_ * 2, MAX_SETS_PER_POOL);
+    return pool;
+}
+
+} // namespace VulkanEngine::RAII
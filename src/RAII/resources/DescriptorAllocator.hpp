@@ -0,0 +1,103 @@
+#ifndef VULKAN_RAII_RESOURCES_DESCRIPTOR_ALLOCATOR_HPP
+#define VULKAN_RAII_RESOURCES_DESCRIPTOR_ALLOCATOR_HPP
+
+#include <volk.h>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "../rendering/FrameBeginSubscription.hpp"
+#include "DescriptorPool.hpp"
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+class Renderer; // Forward declaration
+class CommandBuffer; // Forward declaration
+class DescriptorSetLayout; // Forward declaration
+
+// Growable descriptor set allocator with one list of DescriptorPools per frame in
+// flight. Sets are allocated from the current frame's newest pool; when it runs
+// out another pool (twice as large, up to MAX_SETS_PER_POOL) is added instead of
+// failing. Sets are never freed individually: all pools of a frame are reset at
+// once when the renderer recycles that frame, and kept for reuse.
+// Not thread-safe; use one allocator per recording thread.
+class DescriptorAllocator {
+public:
+    // Descriptors of a type per set, e.g. {UNIFORM_BUFFER, 2.0f} reserves two per set
+    struct PoolSizeRatio {
+        VkDescriptorType type;
+        float ratio;
+    };
+
+    static constexpr uint32_t MAX_SETS_PER_POOL = 4096;
+
+    // Constructor. No pool is created before the first allocation
+    DescriptorAllocator(const Device& device,
+                        uint32_t frame_count,
+                        uint32_t initial_sets_per_pool = 64,
+                        const std::vector<PoolSizeRatio>& ratios = GetDefaultRatios());
+
+    // Destructor
+    ~DescriptorAllocator();
+
+    // Delete copy and move. the attached renderer holds a callback referencing this object.
+    DescriptorAllocator(const DescriptorAllocator&) = delete;
+    DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+    DescriptorAllocator(DescriptorAllocator&&) = delete;
+    DescriptorAllocator& operator=(DescriptorAllocator&&) = delete;
+
+    // Recycle frames automatically from Renderer::BeginFrame. The renderer must outlive
+    // this allocator or Detach() must be called first
+    void AttachToRenderer(Renderer& renderer);
+    void Detach();
+
+    // Reset all pools of frame_index and make it current (called by the attached renderer).
+    // Sets allocated for that frame become invalid
+    void BeginFrame(uint32_t frame_index);
+
+    // Allocate a set for the current frame. next is chained into VkDescriptorSetAllocateInfo
+    // (e.g. VkDescriptorSetVariableDescriptorCountAllocateInfo)
+    [[nodiscard]] VkDescriptorSet Allocate(VkDescriptorSetLayout layout, const void* next = nullptr);
+
+    // Bind per-draw descriptors as set_index: pushed when the layout is a push descriptor
+    // layout, otherwise written into a set allocated for the current frame (dstSet is ignored)
+    void PushDescriptorSet(const CommandBuffer& command_buffer,
+                           VkPipelineBindPoint bind_point,
+                           VkPipelineLayout pipeline_layout,
+                           uint32_t set_index,
+                           const DescriptorSetLayout& layout,
+                           std::span<const VkWriteDescriptorSet> writes);
+
+    // Pools owned across all frames, and sets handed out for the current frame
+    [[nodiscard]] size_t GetPoolCount() const;
+    [[nodiscard]] uint32_t GetAllocatedSetCount() const { return frames_[currentFrame_].allocatedSets; }
+
+    [[nodiscard]] uint32_t GetFrameCount() const { return static_cast<uint32_t>(frames_.size()); }
+    [[nodiscard]] uint32_t GetCurrentFrame() const { return currentFrame_; }
+
+    // Ratios covering the common descriptor types
+    static std::vector<PoolSizeRatio> GetDefaultRatios();
+
+private:
+    struct FramePools {
+        std::vector<DescriptorPool> pools;
+        size_t current{0};
+        uint32_t allocatedSets{0};
+    };
+
+    const Device* device_{nullptr};
+    std::vector<PoolSizeRatio> ratios_;
+    uint32_t setsPerPool_{0}; // Size of the next pool created
+    std::vector<FramePools> frames_;
+    uint32_t currentFrame_{0};
+
+    FrameBeginSubscription frameBeginSubscription_;
+
+    DescriptorPool CreatePool();
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RESOURCES_DESCRIPTOR_ALLOCATOR_HPP
@@ -0,0 +1,249 @@
+#include "DescriptorBufferAllocator.hpp"
+
+#include "../core/Device.hpp"
+#include "../core/PhysicalDevice.hpp"
+#include "../rendering/CommandBuffer.hpp"
+#include "../rendering/Renderer.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+
+namespace VulkanEngine::RAII {
+
+namespace {
+constexpr VkBufferUsageFlags DESCRIPTOR_BUFFER_USAGE = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT |
+                                                       VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT |
+                                                       VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+
+VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+    return alignment == 0 ? value : (value + alignment - 1) / alignment * alignment;
+}
+
+// The buffer holds samplers and resources, so both address ranges bound its size
+VkDeviceSize FrameRegionSize(const VkPhysicalDeviceDescriptorBufferPropertiesEXT& properties,
+                             uint32_t frame_count,
+                             VkDeviceSize requested)
+{
+    const VkDeviceSize alignment = std::max<VkDeviceSize>(1, properties.descriptorBufferOffsetAlignment);
+    const VkDeviceSize range = std::min(properties.maxResourceDescriptorBufferRange, properties.maxSamplerDescriptorBufferRange);
+    const VkDeviceSize limit = range / frame_count / alignment * alignment;
+    const VkDeviceSize size = std::min(AlignUp(std::max<VkDeviceSize>(requested, 1), alignment), limit);
+    if (size == 0) {
+        throw std::invalid_argument("DescriptorBufferAllocator frame count exceeds the descriptor buffer range");
+    }
+    return size;
+}
+} // namespace
+
+DescriptorBufferAllocator::DescriptorBufferAllocator(const Device& device, uint32_t frame_count, VkDeviceSize bytes_per_frame)
+    : device_(&device),
+    properties_(QueryProperties(device)),
+    frameCount_(std::max(1u, frame_count)),
+    bytesPerFrame_(FrameRegionSize(properties_, frameCount_, bytes_per_frame)),
+    buffer_(device,
+            bytesPerFrame_ * frameCount_,
+            DESCRIPTOR_BUFFER_USAGE,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            "DescriptorBufferAllocator")
+{
+    // Mapped for the allocator's lifetime; Buffer unmaps on destruction
+    mapped_ = static_cast<uint8_t*>(buffer_.MapMemory());
+    address_ = buffer_.GetDeviceAddress();
+}
+
+DescriptorBufferAllocator::~DescriptorBufferAllocator()
+{
+    Detach();
+}
+
+bool DescriptorBufferAllocator::IsSupported(const Device& device)
+{
+    return device.SupportsDescriptorBuffer();
+}
+
+void DescriptorBufferAllocator::AttachToRenderer(Renderer& renderer)
+{
+    Detach();
+    if (renderer.GetMaxFramesInFlight() > frameCount_) {
+        throw std::invalid_argument("DescriptorBufferAllocator has fewer frames than the renderer has frames in flight");
+    }
+    frameBeginSubscription_ = renderer.SubscribeFrameBegin([this](uint32_t frame_index) {
+        BeginFrame(frame_index);
+    });
+}
+
+void DescriptorBufferAllocator::Detach()
+{
+    frameBeginSubscription_.Reset();
+}
+
+void DescriptorBufferAllocator::BeginFrame(uint32_t frame_index)
+{
+    currentFrame_ = frame_index % frameCount_;
+    cursor_ = 0;
+}
+
+DescriptorBufferSet DescriptorBufferAllocator::Allocate(VkDescriptorSetLayout layout)
+{
+    if (layout == VK_NULL_HANDLE) {
+        throw std::invalid_argument("DescriptorBufferAllocator requires a valid descriptor set layout");
+    }
+
+    VkDeviceSize layout_size = 0;
+    vkGetDescriptorSetLayoutSizeEXT(device_->GetHandle(), layout, &layout_size);
+    const VkDeviceSize offset = AlignUp(cursor_, properties_.descriptorBufferOffsetAlignment);
+    if (offset + layout_size > bytesPerFrame_) {
+        throw std::runtime_error("DescriptorBufferAllocator frame region is full");
+    }
+    cursor_ = offset + layout_size;
+
+    DescriptorBufferSet set{};
+    set.layout = layout;
+    set.offset = static_cast<VkDeviceSize>(currentFrame_) * bytesPerFrame_ + offset;
+    set.data = mapped_ + set.offset;
+    return set;
+}
+
+void DescriptorBufferAllocator::WriteBuffer(const DescriptorBufferSet& set,
+                                            uint32_t binding,
+                                            VkDescriptorType type,
+                                            const Buffer& buffer,
+                                            VkDeviceSize offset,
+                                            VkDeviceSize range,
+                                            uint32_t array_element) const
+{
+    VkDescriptorAddressInfoEXT address_info{VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT};
+    address_info.address = buffer.GetDeviceAddress() + offset;
+    address_info.range = range == VK_WHOLE_SIZE ? buffer.GetSize() - offset : range;
+
+    VkDescriptorGetInfoEXT info{VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT};
+    info.type = type;
+    switch (type) {
+        case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            info.data.pUniformBuffer = &address_info;
+            break;
+        case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+            info.data.pStorageBuffer = &address_info;
+            break;
+        default:
+            // Dynamic buffers do not exist with descriptor buffers; texel buffers need a format
+            throw std::invalid_argument("DescriptorBufferAllocator::WriteBuffer supports uniform and storage buffers");
+    }
+    WriteDescriptor(set, binding, array_element, info);
+}
+
+void DescriptorBufferAllocator::WriteImage(const DescriptorBufferSet& set,
+                                           uint32_t binding,
+                                           VkDescriptorType type,
+                                           VkImageView image_view,
+                                           VkSampler sampler,
+                                           VkImageLayout image_layout,
+                                           uint32_t array_element) const
+{
+    const VkDescriptorImageInfo image_info{sampler, image_view, image_layout};
+
+    VkDescriptorGetInfoEXT info{VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT};
+    info.type = type;
+    switch (type) {
+        case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+            info.data.pCombinedImageSampler = &image_info;
+            break;
+        case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+            info.data.pSampledImage = &image_info;
+            break;
+        case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+            info.data.pStorageImage = &image_info;
+            break;
+        case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+            info.data.pInputAttachmentImage = &image_info;
+            break;
+        default:
+            throw std::invalid_argument("DescriptorBufferAllocator::WriteImage requires an image descriptor type");
+    }
+    WriteDescriptor(set, binding, array_element, info);
+}
+
+void DescriptorBufferAllocator::WriteSampler(const DescriptorBufferSet& set,
+                                             uint32_t binding,
+                                             VkSampler sampler,
+                                             uint32_t array_element) const
+{
+    VkDescriptorGetInfoEXT info{VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT};
+    info.type = VK_DESCRIPTOR_TYPE_SAMPLER;
+    info.data.pSampler = &sampler;
+    WriteDescriptor(set, binding, array_element, info);
+}
+
+void DescriptorBufferAllocator::BindBuffer(const CommandBuffer& command_buffer) const
+{
+    VkDescriptorBufferBindingInfoEXT binding_info{VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT};
+    binding_info.address = address_;
+    binding_info.usage = DESCRIPTOR_BUFFER_USAGE;
+    command_buffer.BindDescriptorBuffers(std::span<const VkDescriptorBufferBindingInfoEXT>(&binding_info, 1));
+}
+
+void DescriptorBufferAllocator::Bind(const CommandBuffer& command_buffer,
+                                     VkPipelineBindPoint bind_point,
+                                     VkPipelineLayout pipeline_layout,
+                                     uint32_t first_set,
+                                     std::span<const DescriptorBufferSet> sets) const
+{
+    if (sets.empty()) {
+        return;
+    }
+    // Every set lives in the one buffer bound at index 0
+    const std::vector<uint32_t> buffer_indices(sets.size(), 0);
+    std::vector<VkDeviceSize> offsets;
+    offsets.reserve(sets.size());
+    for (const DescriptorBufferSet& set : sets) {
+        offsets.push_back(set.offset);
+    }
+    command_buffer.SetDescriptorBufferOffsets(bind_point, pipeline_layout, first_set, buffer_indices, offsets);
+}
+
+VkPhysicalDeviceDescriptorBufferPropertiesEXT DescriptorBufferAllocator::QueryProperties(const Device& device)
+{
+    if (!device.SupportsDescriptorBuffer()) {
+        throw std::runtime_error("VK_EXT_descriptor_buffer is not enabled on this device");
+    }
+    VkPhysicalDeviceDescriptorBufferPropertiesEXT properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT};
+    VkPhysicalDeviceProperties2 properties2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2};
+    properties2.pNext = &properties;
+    vkGetPhysicalDeviceProperties2(device.GetPhysicalDevice().GetHandle(), &properties2);
+    return properties;
+}
+
+size_t DescriptorBufferAllocator::GetDescriptorSize(VkDescriptorType type) const
+{
+    switch (type) {
+        case VK_DESCRIPTOR_TYPE_SAMPLER: return properties_.samplerDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER: return properties_.combinedImageSamplerDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE: return properties_.sampledImageDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE: return properties_.storageImageDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT: return properties_.inputAttachmentDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER: return properties_.uniformBufferDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER: return properties_.storageBufferDescriptorSize;
+        default: return 0;
+    }
+}
+
+void DescriptorBufferAllocator::WriteDescriptor(const DescriptorBufferSet& set,
+                                                uint32_t binding,
+                                                uint32_t array_element,
+                                                const VkDescriptorGetInfoEXT& info) const
+{
+    if (set.data == nullptr || set.layout == VK_NULL_HANDLE) {
+        throw std::invalid_argument("DescriptorBufferAllocator requires an allocated set");
+    }
+    VkDeviceSize binding_offset = 0;
+    vkGetDescriptorSetLayoutBindingOffsetEXT(device_->GetHandle(), set.layout, binding, &binding_offset);
+    const size_t size = GetDescriptorSize(info.type);
+    vkGetDescriptorEXT(device_->GetHandle(), &info, size, set.data + binding_offset + array_element * size);
+}
+
+} // namespace VulkanEngine::RAII
@@ -0,0 +1,120 @@
+#ifndef VULKAN_RAII_RESOURCES_DESCRIPTOR_BUFFER_ALLOCATOR_HPP
+#define VULKAN_RAII_RESOURCES_DESCRIPTOR_BUFFER_ALLOCATOR_HPP
+
+#include <volk.h>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "../rendering/FrameBeginSubscription.hpp"
+#include "Buffer.hpp"
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+class Renderer; // Forward declaration
+class CommandBuffer; // Forward declaration
+
+// A set living in a descriptor buffer: descriptors are written straight into data
+struct DescriptorBufferSet {
+    VkDescriptorSetLayout layout{VK_NULL_HANDLE};
+    VkDeviceSize offset{0}; // From the start of the descriptor buffer
+    uint8_t* data{nullptr}; // Mapped memory at offset
+};
+
+// VK_EXT_descriptor_buffer counterpart of DescriptorAllocator: no pools and no
+// VkDescriptorSet, sets are aligned ranges of one host-visible buffer with a
+// fixed region per frame in flight, and writing a descriptor is a
+// vkGetDescriptorEXT into mapped memory. Regions are recycled whole when the
+// renderer reuses their frame.
+// Set layouts need VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT and
+// pipelines VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT.
+// Not thread-safe; use one allocator per recording thread.
+class DescriptorBufferAllocator {
+public:
+    // Constructor. bytes_per_frame is clamped to the device's descriptor buffer range
+    DescriptorBufferAllocator(const Device& device, uint32_t frame_count, VkDeviceSize bytes_per_frame = 1u << 20);
+
+    // Destructor
+    ~DescriptorBufferAllocator();
+
+    // Delete copy and move. the attached renderer holds a callback referencing this object.
+    DescriptorBufferAllocator(const DescriptorBufferAllocator&) = delete;
+    DescriptorBufferAllocator& operator=(const DescriptorBufferAllocator&) = delete;
+    DescriptorBufferAllocator(DescriptorBufferAllocator&&) = delete;
+    DescriptorBufferAllocator& operator=(DescriptorBufferAllocator&&) = delete;
+
+    [[nodiscard]] static bool IsSupported(const Device& device);
+
+    // Recycle frames automatically from Renderer::BeginFrame. The renderer must outlive
+    // this allocator or Detach() must be called first
+    void AttachToRenderer(Renderer& renderer);
+    void Detach();
+
+    // Rewind the region of frame_index and make it current (called by the attached renderer).
+    // Sets allocated for that frame become invalid
+    void BeginFrame(uint32_t frame_index);
+
+    // Reserve a set for the current frame. Throws when the frame's region is full
+    [[nodiscard]] DescriptorBufferSet Allocate(VkDescriptorSetLayout layout);
+
+    // Write descriptors into a set. buffer must have SHADER_DEVICE_ADDRESS usage
+    void WriteBuffer(const DescriptorBufferSet& set,
+                     uint32_t binding,
+                     VkDescriptorType type,
+                     const Buffer& buffer,
+                     VkDeviceSize offset = 0,
+                     VkDeviceSize range = VK_WHOLE_SIZE,
+                     uint32_t array_element = 0) const;
+    void WriteImage(const DescriptorBufferSet& set,
+                    uint32_t binding,
+                    VkDescriptorType type,
+                    VkImageView image_view,
+                    VkSampler sampler = VK_NULL_HANDLE,
+                    VkImageLayout image_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                    uint32_t array_element = 0) const;
+    void WriteSampler(const DescriptorBufferSet& set, uint32_t binding, VkSampler sampler, uint32_t array_element = 0) const;
+
+    // Bind the descriptor buffer; once per command buffer, before Bind()
+    void BindBuffer(const CommandBuffer& command_buffer) const;
+
+    // Point consecutive sets starting at first_set at their ranges of the bound buffer
+    void Bind(const CommandBuffer& command_buffer,
+              VkPipelineBindPoint bind_point,
+              VkPipelineLayout pipeline_layout,
+              uint32_t first_set,
+              std::span<const DescriptorBufferSet> sets) const;
+
+    // Bytes used by the current frame, and the size of each frame's region
+    [[nodiscard]] VkDeviceSize GetUsedBytes() const { return cursor_; }
+    [[nodiscard]] VkDeviceSize GetBytesPerFrame() const { return bytesPerFrame_; }
+
+    [[nodiscard]] uint32_t GetFrameCount() const { return frameCount_; }
+    [[nodiscard]] uint32_t GetCurrentFrame() const { return currentFrame_; }
+
+private:
+    const Device* device_{nullptr};
+    VkPhysicalDeviceDescriptorBufferPropertiesEXT properties_{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT};
+    uint32_t frameCount_{0};
+    VkDeviceSize bytesPerFrame_{0};
+    Buffer buffer_;
+    uint8_t* mapped_{nullptr};
+    VkDeviceAddress address_{0};
+    uint32_t currentFrame_{0};
+    VkDeviceSize cursor_{0}; // Offset into the current frame's region
+
+    FrameBeginSubscription frameBeginSubscription_;
+
+    static VkPhysicalDeviceDescriptorBufferPropertiesEXT QueryProperties(const Device& device);
+
+    [[nodiscard]] size_t GetDescriptorSize(VkDescriptorType type) const;
+    void WriteDescriptor(const DescriptorBufferSet& set,
+                         uint32_t binding,
+                         uint32_t array_element,
+                         const VkDescriptorGetInfoEXT& info) const;
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RESOURCES_DESCRIPTOR_BUFFER_ALLOCATOR_HPP
@@ -1,9 +1,12 @@
 #include "DescriptorPool.hpp"
 
 #include "../core/Device.hpp"
+#include "../utils/PerfCounters.hpp"
+#include "../utils/HostAllocator.hpp"
 
 #include <algorithm>
 #include <cstdint>
+#include <span>
 #include <stdexcept>
 #include <utility>
 #include <vector>
@@ -80,6 +83,19 @@ std::vector<VkDescriptorSet> DescriptorPool::AllocateDescriptorSets(const std::v
     }
 
     std::vector<VkDescriptorSet> descriptor_sets(layouts.size());
+    AllocateDescriptorSets(std::span<const VkDescriptorSetLayout>(layouts), std::span<VkDescriptorSet>(descriptor_sets));
+    return descriptor_sets;
+}
+
+void DescriptorPool::AllocateDescriptorSets(std::span<const VkDescriptorSetLayout> layouts, std::span<VkDescriptorSet> descriptor_sets)
+{
+    if (layouts.empty()) {
+        return;
+    }
+    if (descriptor_sets.size() < layouts.size()) {
+        throw std::invalid_argument("Descriptor set storage is smaller than the layout count");
+    }
+
     VkDescriptorSetAllocateInfo alloc_info{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
     alloc_info.descriptorPool = descriptorPool_;
     alloc_info.descriptorSetCount = static_cast<uint32_t>(layouts.size());
@@ -89,16 +105,33 @@ std::vector<VkDescriptorSet> DescriptorPool::AllocateDescriptorSets(const std::v
     if (result != VK_SUCCESS) {
         throw std::runtime_error("Failed to allocate descriptor sets");
     }
-    return descriptor_sets;
 }
 
 VkDescriptorSet DescriptorPool::AllocateDescriptorSet(VkDescriptorSetLayout layout)
 {
-    auto sets = AllocateDescriptorSets({layout});
-    return sets.front();
+    VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
+    AllocateDescriptorSets(std::span<const VkDescriptorSetLayout>(&layout, 1), std::span<VkDescriptorSet>(&descriptor_set, 1));
+    return descriptor_set;
+}
+
+VkResult DescriptorPool::TryAllocateDescriptorSet(VkDescriptorSetLayout layout,
+                                                  VkDescriptorSet& descriptor_set,
+                                                  const void* next)
+{
+    VkDescriptorSetAllocateInfo alloc_info{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+    alloc_info.pNext = next;
+    alloc_info.descriptorPool = descriptorPool_;
+    alloc_info.descriptorSetCount = 1;
+    alloc_info.pSetLayouts = &layout;
+    return vkAllocateDescriptorSets(device_, &alloc_info, &descriptor_set);
 }
     
 void DescriptorPool::FreeDescriptorSets(const std::vector<VkDescriptorSet>& descriptor_sets)
+{
+    FreeDescriptorSets(std::span<const VkDescriptorSet>(descriptor_sets));
+}
+
+void DescriptorPool::FreeDescriptorSets(std::span<const VkDescriptorSet> descriptor_sets)
 {
     if (!allowsIndividualFree_ || descriptor_sets.empty()) {
         return;
@@ -114,7 +147,7 @@ void DescriptorPool::FreeDescriptorSet(VkDescriptorSet descriptor_set)
     if (descriptor_set == VK_NULL_HANDLE) {
         return;
     }
-    FreeDescriptorSets({descriptor_set});
+    FreeDescriptorSets(std::span<const VkDescriptorSet>(&descriptor_set, 1));
 }
 
 void DescriptorPool::Reset(VkDescriptorPoolResetFlags flags) {
@@ -123,9 +156,24 @@ void DescriptorPool::Reset(VkDescriptorPoolResetFlags flags) {
 
 void DescriptorPool::UpdateDescriptorSets(const std::vector<VkWriteDescriptorSet>& writes,
                                             const std::vector<VkCopyDescriptorSet>& copies) const {
+    UpdateDescriptorSets(std::span<const VkWriteDescriptorSet>(writes), std::span<const VkCopyDescriptorSet>(copies));
+}
+
+void DescriptorPool::UpdateDescriptorSets(std::span<const VkWriteDescriptorSet> writes,
+                                          std::span<const VkCopyDescriptorSet> copies) const {
     if (writes.empty() && copies.empty()) {
         return;
     }
+    if (Utils::PerfCounters::IsEnabled()) {
+        uint64_t descriptor_count = 0;
+        for (const VkWriteDescriptorSet& write : writes) {
+            descriptor_count += write.descriptorCount;
+        }
+        for (const VkCopyDescriptorSet& copy : copies) {
+            descriptor_count += copy.descriptorCount;
+        }
+        Utils::PerfCounters::AddDescriptorUpdates(descriptor_count);
+    }
     vkUpdateDescriptorSets(device_,
                            static_cast<uint32_t>(writes.size()),
                            writes.empty() ? nullptr : writes.data(),
@@ -181,7 +229,7 @@ void DescriptorPool::CreateDescriptorPool(VkDescriptorPoolCreateFlags flags)
     pool_info.poolSizeCount = static_cast<uint32_t>(poolSizes_.size());
     pool_info.pPoolSizes = poolSizes_.data();
 
-    if (vkCreateDescriptorPool(device_, &pool_info, nullptr, &descriptorPool_) != VK_SUCCESS) {
+    if (vkCreateDescriptorPool(device_, &pool_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_DESCRIPTOR_POOL), &descriptorPool_) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create descriptor pool");
     }
 }
@@ -189,7 +237,7 @@ void DescriptorPool::CreateDescriptorPool(VkDescriptorPoolCreateFlags flags)
 void DescriptorPool::Cleanup()
 {
     if (descriptorPool_ != VK_NULL_HANDLE) {
-        vkDestroyDescriptorPool(device_, descriptorPool_, nullptr);
+        vkDestroyDescriptorPool(device_, descriptorPool_, Utils::HostAllocator::For(VK_OBJECT_TYPE_DESCRIPTOR_POOL));
         descriptorPool_ = VK_NULL_HANDLE;
     }
     device_ = VK_NULL_HANDLE;
@@ -2,6 +2,7 @@
 #define VULKAN_RAII_RESOURCES_DESCRIPTOR_POOL_HPP
 
 #include <volk.h>
+#include <span>
 #include <vector>
 
 
@@ -47,15 +48,29 @@ public:
     // Allocate descriptor sets
     std::vector<VkDescriptorSet> AllocateDescriptorSets(const std::vector<VkDescriptorSetLayout>& layouts);
 
+    // Allocate one set per layout into caller storage (descriptor_sets.size() >= layouts.size()); no heap allocation
+    void AllocateDescriptorSets(std::span<const VkDescriptorSetLayout> layouts, std::span<VkDescriptorSet> descriptor_sets);
+
     // Allocate single descriptor set
     VkDescriptorSet AllocateDescriptorSet(VkDescriptorSetLayout layout);
 
+    // Allocate a single descriptor set without throwing; returns the Vulkan result
+    // (VK_ERROR_OUT_OF_POOL_MEMORY / VK_ERROR_FRAGMENTED_POOL when the pool is exhausted)
+    VkResult TryAllocateDescriptorSet(VkDescriptorSetLayout layout,
+                                      VkDescriptorSet& descriptor_set,
+                                      const void* next = nullptr);
+
     // Update descriptor sets (simple wrapper around vkUpdateDescriptorSets)
     void UpdateDescriptorSets(const std::vector<VkWriteDescriptorSet>& writes,
                                 const std::vector<VkCopyDescriptorSet>& copies = {}) const;
 
+    // Same, over caller storage (e.g. std::array on the stack)
+    void UpdateDescriptorSets(std::span<const VkWriteDescriptorSet> writes,
+                              std::span<const VkCopyDescriptorSet> copies = {}) const;
+
     // Free descriptor sets (only if pool was created with FREE_DESCRIPTOR_SET_BIT)
     void FreeDescriptorSets(const std::vector<VkDescriptorSet>& descriptor_sets);
+    void FreeDescriptorSets(std::span<const VkDescriptorSet> descriptor_sets);
 
     // Free single descriptor set
     void FreeDescriptorSet(VkDescriptorSet descriptor_set);
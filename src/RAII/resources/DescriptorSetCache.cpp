@@ -0,0 +1,390 @@
+#include "DescriptorSetCache.hpp"
+
+#include "../core/Device.hpp"
+#include "../rendering/Renderer.hpp"
+#include "../utils/Constants.hpp"
+#include "../utils/HashUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+
+namespace VulkanEngine::RAII {
+
+namespace {
+bool SortsBefore(const auto& a, const auto& b)
+{
+    return std::tie(a.binding, a.arrayElement) < std::tie(b.binding, b.arrayElement);
+}
+
+uint64_t HashBinding(const DescriptorBufferBinding& buffer)
+{
+    const uint64_t words[] = {buffer.binding, buffer.arrayElement, static_cast<uint64_t>(buffer.type),
+                              Utils::HandleToUint64(buffer.buffer), buffer.offset, buffer.range};
+    return Utils::HashFnv1a(words, std::size(words));
+}
+
+uint64_t HashBinding(const DescriptorImageBinding& image)
+{
+    const uint64_t words[] = {image.binding, image.arrayElement, static_cast<uint64_t>(image.type),
+                              Utils::HandleToUint64(image.sampler), Utils::HandleToUint64(image.imageView),
+                              static_cast<uint64_t>(image.imageLayout)};
+    return Utils::HashFnv1a(words, std::size(words));
+}
+
+bool SameBinding(const DescriptorBufferBinding& a, const DescriptorBufferBinding& b)
+{
+    return a.binding == b.binding && a.arrayElement == b.arrayElement && a.type == b.type &&
+           a.buffer == b.buffer && a.offset == b.offset && a.range == b.range;
+}
+
+// The owning VkImage only drives invalidation, so it stays out of the comparison
+bool SameBinding(const DescriptorImageBinding& a, const DescriptorImageBinding& b)
+{
+    return a.binding == b.binding && a.arrayElement == b.arrayElement && a.type == b.type &&
+           a.sampler == b.sampler && a.imageView == b.imageView && a.imageLayout == b.imageLayout;
+}
+
+// Bindings are summed so the order they were added in does not reach the hash
+uint64_t HashContents(const DescriptorSetContents& contents)
+{
+    uint64_t buffer_sum = 0;
+    for (const DescriptorBufferBinding& buffer : contents.buffers) {
+        buffer_sum += HashBinding(buffer);
+    }
+    uint64_t image_sum = 0;
+    for (const DescriptorImageBinding& image : contents.images) {
+        image_sum += HashBinding(image);
+    }
+    const uint64_t words[] = {Utils::HandleToUint64(contents.layout), contents.buffers.size(), buffer_sum,
+                              contents.images.size(), image_sum};
+    return Utils::HashFnv1a(words, std::size(words));
+}
+
+// Every binding has an equal one in sorted; sizes are checked by the caller
+template<typename Binding>
+bool ContainsAll(const std::vector<Binding>& bindings, const std::vector<Binding>& sorted)
+{
+    for (const Binding& binding : bindings) {
+        auto range = std::equal_range(sorted.begin(), sorted.end(), binding, [](const auto& a, const auto& b) {
+            return SortsBefore(a, b);
+        });
+        if (std::none_of(range.first, range.second, [&](const Binding& other) { return SameBinding(binding, other); })) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void EraseMapping(std::unordered_multimap<uint64_t, uint64_t>& map, uint64_t key, uint64_t id)
+{
+    auto range = map.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == id) {
+            map.erase(it);
+            return;
+        }
+    }
+}
+} // namespace
+
+DescriptorSetContents& DescriptorSetContents::BindBuffer(uint32_t binding,
+                                                         VkDescriptorType type,
+                                                         VkBuffer buffer,
+                                                         VkDeviceSize offset,
+                                                         VkDeviceSize range,
+                                                         uint32_t array_element)
+{
+    buffers.push_back({binding, array_element, type, buffer, offset, range});
+    return *this;
+}
+
+DescriptorSetContents& DescriptorSetContents::BindImage(uint32_t binding,
+                                                        VkDescriptorType type,
+                                                        VkImageView image_view,
+                                                        VkSampler sampler,
+                                                        VkImageLayout image_layout,
+                                                        VkImage image,
+                                                        uint32_t array_element)
+{
+    images.push_back({binding, array_element, type, sampler, image_view, image_layout, image});
+    return *this;
+}
+
+DescriptorSetContents& DescriptorSetContents::BindSampler(uint32_t binding, VkSampler sampler, uint32_t array_element)
+{
+    images.push_back({binding, array_element, VK_DESCRIPTOR_TYPE_SAMPLER, sampler, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_UNDEFINED, VK_NULL_HANDLE});
+    return *this;
+}
+
+DescriptorSetCache::DescriptorSetCache(const Device& device, const Options& options)
+    : device_(&device),
+    options_(options),
+    framesInFlight_(Constants::MAX_FRAMES_IN_FLIGHT)
+{
+    if (options_.ratios.empty()) {
+        throw std::invalid_argument("DescriptorSetCache requires at least one pool size ratio");
+    }
+    options_.setsPerPool = std::max(1u, options_.setsPerPool);
+    options_.maxSets = std::max<size_t>(1, options_.maxSets);
+}
+
+DescriptorSetCache::DescriptorSetCache(const Device& device)
+    : DescriptorSetCache(device, Options{}) {}
+
+DescriptorSetCache::~DescriptorSetCache()
+{
+    Detach();
+    // Destroying the pools frees every set at once
+}
+
+void DescriptorSetCache::AttachToRenderer(Renderer& renderer)
+{
+    Detach();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        framesInFlight_ = renderer.GetMaxFramesInFlight();
+    }
+    frameBeginSubscription_ = renderer.SubscribeFrameBegin([this](uint32_t /*frame_index*/) {
+        Update();
+    });
+}
+
+void DescriptorSetCache::Detach()
+{
+    frameBeginSubscription_.Reset();
+}
+
+void DescriptorSetCache::Update()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++frameCounter_;
+
+    const uint64_t max_age = std::max<uint64_t>(options_.maxFrameAge, framesInFlight_);
+    if (frameCounter_ <= max_age) {
+        return;
+    }
+    std::vector<uint64_t> expired;
+    for (const auto& entry : entries_) {
+        if (entry.second.lastUsedFrame + max_age < frameCounter_) {
+            expired.push_back(entry.first);
+        }
+    }
+    for (uint64_t id : expired) {
+        EraseLocked(id);
+    }
+}
+
+VkDescriptorSet DescriptorSetCache::Get(const DescriptorSetContents& contents)
+{
+    if (contents.layout == VK_NULL_HANDLE) {
+        throw std::invalid_argument("DescriptorSetCache requires a valid descriptor set layout");
+    }
+    const uint64_t hash = HashContents(contents);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto range = byHash_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        Entry& entry = entries_.at(it->second);
+        if (entry.layout == contents.layout &&
+            entry.buffers.size() == contents.buffers.size() && entry.images.size() == contents.images.size() &&
+            ContainsAll(contents.buffers, entry.buffers) && ContainsAll(contents.images, entry.images)) {
+            entry.lastUsedFrame = frameCounter_;
+            ++entry.useCount;
+            ++hitCount_;
+            return entry.set;
+        }
+    }
+
+    ++missCount_;
+    if (entries_.size() >= options_.maxSets) {
+        EvictForCapacityLocked();
+    }
+
+    Entry entry{};
+    entry.set = AllocateLocked(contents.layout, entry.pool);
+
+    // Info arrays are sized up front so the write pointers stay valid
+    std::vector<VkDescriptorBufferInfo> buffer_infos;
+    std::vector<VkDescriptorImageInfo> image_infos;
+    std::vector<VkWriteDescriptorSet> writes;
+    buffer_infos.reserve(contents.buffers.size());
+    image_infos.reserve(contents.images.size());
+    writes.reserve(contents.buffers.size() + contents.images.size());
+    for (const DescriptorBufferBinding& buffer : contents.buffers) {
+        buffer_infos.push_back({buffer.buffer, buffer.offset, buffer.range});
+        VkWriteDescriptorSet write{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+        write.dstSet = entry.set;
+        write.dstBinding = buffer.binding;
+        write.dstArrayElement = buffer.arrayElement;
+        write.descriptorCount = 1;
+        write.descriptorType = buffer.type;
+        write.pBufferInfo = &buffer_infos.back();
+        writes.push_back(write);
+        entry.handles.push_back(Utils::HandleToUint64(buffer.buffer));
+    }
+    for (const DescriptorImageBinding& image : contents.images) {
+        image_infos.push_back({image.sampler, image.imageView, image.imageLayout});
+        VkWriteDescriptorSet write{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+        write.dstSet = entry.set;
+        write.dstBinding = image.binding;
+        write.dstArrayElement = image.arrayElement;
+        write.descriptorCount = 1;
+        write.descriptorType = image.type;
+        write.pImageInfo = &image_infos.back();
+        writes.push_back(write);
+        for (uint64_t handle : {Utils::HandleToUint64(image.sampler), Utils::HandleToUint64(image.imageView),
+                                 Utils::HandleToUint64(image.image)}) {
+            if (handle != 0) {
+                entry.handles.push_back(handle);
+            }
+        }
+    }
+    if (!writes.empty()) {
+        vkUpdateDescriptorSets(device_->GetHandle(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+
+    std::sort(entry.handles.begin(), entry.handles.end());
+    entry.handles.erase(std::unique(entry.handles.begin(), entry.handles.end()), entry.handles.end());
+    entry.layout = contents.layout;
+    entry.buffers = contents.buffers;
+    entry.images = contents.images;
+    std::sort(entry.buffers.begin(), entry.buffers.end(), [](const auto& a, const auto& b) { return SortsBefore(a, b); });
+    std::sort(entry.images.begin(), entry.images.end(), [](const auto& a, const auto& b) { return SortsBefore(a, b); });
+    entry.hash = hash;
+    entry.lastUsedFrame = frameCounter_;
+    entry.useCount = 1;
+
+    const uint64_t id = nextId_++;
+    byHash_.emplace(hash, id);
+    for (uint64_t handle : entry.handles) {
+        byHandle_.emplace(handle, id);
+    }
+    const VkDescriptorSet set = entry.set;
+    entries_.emplace(id, std::move(entry));
+    return set;
+}
+
+void DescriptorSetCache::InvalidateHandle(uint64_t handle)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<uint64_t> ids;
+    auto range = byHandle_.equal_range(handle);
+    for (auto it = range.first; it != range.second; ++it) {
+        ids.push_back(it->second);
+    }
+    for (uint64_t id : ids) {
+        EraseLocked(id);
+    }
+}
+
+void DescriptorSetCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    byHash_.clear();
+    byHandle_.clear();
+    for (PoolEntry& pool : pools_) {
+        pool.pool.Reset();
+        pool.liveSets = 0;
+    }
+}
+
+size_t DescriptorSetCache::GetSetCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+uint64_t DescriptorSetCache::GetHitCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hitCount_;
+}
+
+uint64_t DescriptorSetCache::GetMissCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return missCount_;
+}
+
+VkDescriptorSet DescriptorSetCache::AllocateLocked(VkDescriptorSetLayout layout, size_t& pool_index)
+{
+    // Newest pools first: older ones are the most likely to be full
+    for (size_t i = pools_.size(); i-- > 0;) {
+        VkDescriptorSet set = VK_NULL_HANDLE;
+        const VkResult result = pools_[i].pool.TryAllocateDescriptorSet(layout, set);
+        if (result == VK_SUCCESS) {
+            ++pools_[i].liveSets;
+            pool_index = i;
+            return set;
+        }
+        if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL) {
+            throw std::runtime_error("Failed to allocate descriptor set");
+        }
+    }
+
+    std::vector<VkDescriptorPoolSize> pool_sizes;
+    pool_sizes.reserve(options_.ratios.size());
+    for (const DescriptorAllocator::PoolSizeRatio& ratio : options_.ratios) {
+        const auto count = static_cast<uint32_t>(std::ceil(ratio.ratio * static_cast<float>(options_.setsPerPool)));
+        pool_sizes.push_back({ratio.type, std::max(1u, count)});
+    }
+    pools_.push_back({DescriptorPool(*device_, options_.setsPerPool, pool_sizes, VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT), 0});
+
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    if (pools_.back().pool.TryAllocateDescriptorSet(layout, set) != VK_SUCCESS) {
+        throw std::runtime_error("Descriptor set layout does not fit a DescriptorSetCache pool");
+    }
+    ++pools_.back().liveSets;
+    pool_index = pools_.size() - 1;
+    return set;
+}
+
+void DescriptorSetCache::EvictForCapacityLocked()
+{
+    // Only sets no frame in flight can still be using
+    std::vector<std::pair<uint64_t, const Entry*>> candidates;
+    for (const auto& entry : entries_) {
+        if (entry.second.lastUsedFrame + framesInFlight_ <= frameCounter_) {
+            candidates.emplace_back(entry.first, &entry.second);
+        }
+    }
+    // Least used first, then least recently used; free a batch so this does not run on every miss
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+        return std::tie(a.second->useCount, a.second->lastUsedFrame) < std::tie(b.second->useCount, b.second->lastUsedFrame);
+    });
+    const size_t target = options_.maxSets - options_.maxSets / 8;
+    for (const auto& candidate : candidates) {
+        if (entries_.size() < target) {
+            break;
+        }
+        EraseLocked(candidate.first);
+    }
+}
+
+void DescriptorSetCache::EraseLocked(uint64_t id)
+{
+    auto it = entries_.find(id);
+    if (it == entries_.end()) {
+        return;
+    }
+    Entry& entry = it->second;
+    EraseMapping(byHash_, entry.hash, id);
+    for (uint64_t handle : entry.handles) {
+        EraseMapping(byHandle_, handle, id);
+    }
+    PoolEntry& pool = pools_[entry.pool];
+    pool.pool.FreeDescriptorSet(entry.set);
+    --pool.liveSets;
+    entries_.erase(it);
+}
+
+} // namespace VulkanEngine::RAII
@@ -0,0 +1,159 @@
+#ifndef VULKAN_RAII_RESOURCES_DESCRIPTOR_SET_CACHE_HPP
+#define VULKAN_RAII_RESOURCES_DESCRIPTOR_SET_CACHE_HPP
+
+#include <volk.h>
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "../rendering/FrameBeginSubscription.hpp"
+#include "../utils/HashUtils.hpp"
+#include "DescriptorAllocator.hpp"
+#include "DescriptorPool.hpp"
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+class Renderer; // Forward declaration
+
+struct DescriptorBufferBinding {
+    uint32_t binding{0};
+    uint32_t arrayElement{0};
+    VkDescriptorType type{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER};
+    VkBuffer buffer{VK_NULL_HANDLE};
+    VkDeviceSize offset{0};
+    VkDeviceSize range{VK_WHOLE_SIZE};
+};
+
+struct DescriptorImageBinding {
+    uint32_t binding{0};
+    uint32_t arrayElement{0};
+    VkDescriptorType type{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER};
+    VkSampler sampler{VK_NULL_HANDLE};
+    VkImageView imageView{VK_NULL_HANDLE};
+    VkImageLayout imageLayout{VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+    VkImage image{VK_NULL_HANDLE}; // Optional: lets destroying the Image invalidate the set
+};
+
+// Everything a descriptor set binds, by handle. Cheap to rebuild per draw; the order
+// bindings are added in does not matter
+struct DescriptorSetContents {
+    VkDescriptorSetLayout layout{VK_NULL_HANDLE};
+    std::vector<DescriptorBufferBinding> buffers;
+    std::vector<DescriptorImageBinding> images;
+
+    DescriptorSetContents& BindBuffer(uint32_t binding,
+                                      VkDescriptorType type,
+                                      VkBuffer buffer,
+                                      VkDeviceSize offset = 0,
+                                      VkDeviceSize range = VK_WHOLE_SIZE,
+                                      uint32_t array_element = 0);
+
+    DescriptorSetContents& BindImage(uint32_t binding,
+                                     VkDescriptorType type,
+                                     VkImageView image_view,
+                                     VkSampler sampler = VK_NULL_HANDLE,
+                                     VkImageLayout image_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                     VkImage image = VK_NULL_HANDLE,
+                                     uint32_t array_element = 0);
+
+    DescriptorSetContents& BindSampler(uint32_t binding, VkSampler sampler, uint32_t array_element = 0);
+};
+
+// Hands out one written descriptor set per distinct DescriptorSetContents, so
+// identical sets are neither allocated nor written again. Sets untouched for
+// maxFrameAge frames are freed by Update(); past maxSets the least used sets
+// outside the frames in flight are freed first. Resources do not report their
+// destruction: whoever destroys a bound Buffer, Image, ImageView or Sampler calls
+// Invalidate() with its handle first, so a recycled handle never hits a stale set.
+// Thread-safe.
+class DescriptorSetCache {
+public:
+    struct Options {
+        uint32_t maxFrameAge{120}; // Never below the renderer's frames in flight
+        size_t maxSets{4096};
+        uint32_t setsPerPool{256};
+        std::vector<DescriptorAllocator::PoolSizeRatio> ratios{DescriptorAllocator::GetDefaultRatios()};
+    };
+
+    // Constructor
+    DescriptorSetCache(const Device& device, const Options& options);
+    explicit DescriptorSetCache(const Device& device);
+
+    // Destructor (frees every cached set; none may still be in use)
+    ~DescriptorSetCache();
+
+    // Delete copy and move. The attached renderer references this object.
+    DescriptorSetCache(const DescriptorSetCache&) = delete;
+    DescriptorSetCache& operator=(const DescriptorSetCache&) = delete;
+    DescriptorSetCache(DescriptorSetCache&&) = delete;
+    DescriptorSetCache& operator=(DescriptorSetCache&&) = delete;
+
+    // Run Update() from Renderer::BeginFrame.
+    // The renderer must outlive this cache or Detach() must be called first
+    void AttachToRenderer(Renderer& renderer);
+    void Detach();
+
+    // Advance the frame counter and free sets that aged out. Call once per frame (automatic when attached)
+    void Update();
+
+    // Written set for the contents: cached on a hit, allocated and written on a miss
+    [[nodiscard]] VkDescriptorSet Get(const DescriptorSetContents& contents);
+
+    // Free every set that binds the handle (a VkBuffer, VkImage, VkImageView or VkSampler)
+    template<typename Handle>
+    void Invalidate(Handle handle) { InvalidateHandle(Utils::HandleToUint64(handle)); }
+    void InvalidateHandle(uint64_t handle);
+
+    // Free all sets
+    void Clear();
+
+    [[nodiscard]] size_t GetSetCount() const;
+    [[nodiscard]] uint64_t GetHitCount() const;
+    [[nodiscard]] uint64_t GetMissCount() const;
+
+private:
+    struct Entry {
+        // Contents with the bindings sorted, compared on a hash match
+        VkDescriptorSetLayout layout{VK_NULL_HANDLE};
+        std::vector<DescriptorBufferBinding> buffers;
+        std::vector<DescriptorImageBinding> images;
+        uint64_t hash{0};
+        VkDescriptorSet set{VK_NULL_HANDLE};
+        size_t pool{0};
+        uint64_t lastUsedFrame{0};
+        uint64_t useCount{0};
+        std::vector<uint64_t> handles;
+    };
+
+    struct PoolEntry {
+        DescriptorPool pool;
+        uint32_t liveSets{0};
+    };
+
+    const Device* device_{nullptr};
+    Options options_;
+    uint32_t framesInFlight_{0};
+
+    mutable std::mutex mutex_;
+    std::vector<PoolEntry> pools_;
+    std::unordered_map<uint64_t, Entry> entries_; // By entry id
+    std::unordered_multimap<uint64_t, uint64_t> byHash_; // Content hash -> entry id
+    std::unordered_multimap<uint64_t, uint64_t> byHandle_; // Bound handle -> entry id
+    uint64_t nextId_{1};
+    uint64_t frameCounter_{0};
+    uint64_t hitCount_{0};
+    uint64_t missCount_{0};
+
+    FrameBeginSubscription frameBeginSubscription_;
+
+    VkDescriptorSet AllocateLocked(VkDescriptorSetLayout layout, size_t& pool_index);
+    void EvictForCapacityLocked();
+    void EraseLocked(uint64_t id);
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RESOURCES_DESCRIPTOR_SET_CACHE_HPP
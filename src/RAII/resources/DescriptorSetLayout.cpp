@@ -1,6 +1,7 @@
 #include "DescriptorSetLayout.hpp"
 
 #include "../core/Device.hpp"
+#include "../utils/HostAllocator.hpp"
 
 #include <cstdint>
 #include <stdexcept>
@@ -34,6 +35,23 @@ DescriptorSetLayout::DescriptorSetLayout(const Device& device,
     CreateDescriptorSetLayout(flags);
 }
 
+DescriptorSetLayout::DescriptorSetLayout(const Device& device,
+                                         const std::vector<VkDescriptorSetLayoutBinding>& bindings,
+                                         const std::vector<VkDescriptorBindingFlags>& binding_flags,
+                                         VkDescriptorSetLayoutCreateFlags flags)
+    : device_(device.GetHandle()),
+      bindings_(bindings),
+      bindingFlags_(binding_flags)
+{
+    if (device == VK_NULL_HANDLE) {
+        throw std::invalid_argument("DescriptorSetLayout requires a valid device");
+    }
+    if (binding_flags.size() != bindings.size()) {
+        throw std::invalid_argument("DescriptorSetLayout requires one binding flags entry per binding");
+    }
+    CreateDescriptorSetLayout(flags, binding_flags);
+}
+
 DescriptorSetLayout::~DescriptorSetLayout() {
     Cleanup();
 }
@@ -41,7 +59,9 @@ DescriptorSetLayout::~DescriptorSetLayout() {
 DescriptorSetLayout::DescriptorSetLayout(DescriptorSetLayout&& other) noexcept
     : descriptorSetLayout_(other.descriptorSetLayout_),
     device_(other.device_),
-    bindings_(std::move(other.bindings_))
+    bindings_(std::move(other.bindings_)),
+    bindingFlags_(std::move(other.bindingFlags_)),
+    flags_(other.flags_)
 {
     other.descriptorSetLayout_ = VK_NULL_HANDLE;
     other.device_ = VK_NULL_HANDLE;
@@ -53,6 +73,8 @@ DescriptorSetLayout& DescriptorSetLayout::operator=(DescriptorSetLayout&& other)
         descriptorSetLayout_ = other.descriptorSetLayout_;
         device_ = other.device_;
         bindings_ = std::move(other.bindings_);
+        bindingFlags_ = std::move(other.bindingFlags_);
+        flags_ = other.flags_;
 
         other.descriptorSetLayout_ = VK_NULL_HANDLE;
         other.device_ = VK_NULL_HANDLE;
@@ -99,14 +121,38 @@ DescriptorSetLayout DescriptorSetLayout::CreateSingleBinding(const Device& devic
     return DescriptorSetLayout(device, std::vector<DescriptorSetLayoutBinding>{layout_binding});
 }
 
-void DescriptorSetLayout::CreateDescriptorSetLayout(VkDescriptorSetLayoutCreateFlags flags)
+DescriptorSetLayout DescriptorSetLayout::CreatePushDescriptor(const Device& device,
+                                                              const std::vector<DescriptorSetLayoutBinding>& bindings)
+{
+    if (!device.SupportsPushDescriptor()) {
+        throw std::runtime_error("VK_KHR_push_descriptor is not enabled on this device");
+    }
+    return DescriptorSetLayout(device, bindings, VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR);
+}
+
+DescriptorSetLayout DescriptorSetLayout::CreatePerDraw(const Device& device,
+                                                       const std::vector<DescriptorSetLayoutBinding>& bindings)
+{
+    return device.SupportsPushDescriptor() ? CreatePushDescriptor(device, bindings) : DescriptorSetLayout(device, bindings);
+}
+
+void DescriptorSetLayout::CreateDescriptorSetLayout(VkDescriptorSetLayoutCreateFlags flags,
+                                                    const std::vector<VkDescriptorBindingFlags>& binding_flags)
 {
     VkDescriptorSetLayoutCreateInfo layout_info{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
     layout_info.bindingCount = static_cast<uint32_t>(bindings_.size());
     layout_info.pBindings = bindings_.empty() ? nullptr : bindings_.data();
     layout_info.flags = flags;
+    flags_ = flags;
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo flags_info{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO};
+    if (!binding_flags.empty()) {
+        flags_info.bindingCount = static_cast<uint32_t>(binding_flags.size());
+        flags_info.pBindingFlags = binding_flags.data();
+        layout_info.pNext = &flags_info;
+    }
 
-    if (vkCreateDescriptorSetLayout(device_, &layout_info, nullptr, &descriptorSetLayout_) != VK_SUCCESS) {
+    if (vkCreateDescriptorSetLayout(device_, &layout_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT), &descriptorSetLayout_) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create descriptor set layout");
     }
 }
@@ -114,7 +160,7 @@ void DescriptorSetLayout::CreateDescriptorSetLayout(VkDescriptorSetLayoutCreateF
 void DescriptorSetLayout::Cleanup()
 {
     if (descriptorSetLayout_ != VK_NULL_HANDLE) {
-        vkDestroyDescriptorSetLayout(device_, descriptorSetLayout_, nullptr);
+        vkDestroyDescriptorSetLayout(device_, descriptorSetLayout_, Utils::HostAllocator::For(VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT));
         descriptorSetLayout_ = VK_NULL_HANDLE;
     }
     device_ = VK_NULL_HANDLE;
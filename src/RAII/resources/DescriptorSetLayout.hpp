@@ -29,6 +29,12 @@ public:
                        const std::vector<VkDescriptorSetLayoutBinding>& bindings,
                        VkDescriptorSetLayoutCreateFlags flags = 0);
 
+    // Constructor with per-binding flags (descriptor indexing), one entry per binding
+    DescriptorSetLayout(const Device& device,
+                       const std::vector<VkDescriptorSetLayoutBinding>& bindings,
+                       const std::vector<VkDescriptorBindingFlags>& binding_flags,
+                       VkDescriptorSetLayoutCreateFlags flags = 0);
+
     // Destructor
     ~DescriptorSetLayout();
 
@@ -66,6 +72,15 @@ public:
     // Get descriptor count for binding
     [[nodiscard]] uint32_t GetDescriptorCount(uint32_t binding) const;
 
+    // Get the per-binding flags (empty when created without them)
+    [[nodiscard]] const std::vector<VkDescriptorBindingFlags>& GetBindingFlags() const { return bindingFlags_; }
+
+    // Get the create flags
+    [[nodiscard]] VkDescriptorSetLayoutCreateFlags GetFlags() const { return flags_; }
+
+    // Check if sets of this layout are pushed (CommandBuffer::PushDescriptorSet) instead of allocated
+    [[nodiscard]] bool IsPushDescriptor() const { return (flags_ & VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR) != 0; }
+
     // Helper to create common layouts
     static DescriptorSetLayout CreateSingleBinding(const Device& device,
                                                    uint32_t binding,
@@ -73,13 +88,25 @@ public:
                                                    VkShaderStageFlags stage_flags,
                                                    uint32_t descriptor_count = 1);
 
+    // Push descriptor layout (VK_KHR_push_descriptor); throws when the device lacks it
+    static DescriptorSetLayout CreatePushDescriptor(const Device& device,
+                                                    const std::vector<DescriptorSetLayoutBinding>& bindings);
+
+    // Layout for resources that change every draw: push descriptors when supported,
+    // an ordinary pooled layout otherwise (see DescriptorAllocator::PushDescriptorSet)
+    static DescriptorSetLayout CreatePerDraw(const Device& device,
+                                             const std::vector<DescriptorSetLayoutBinding>& bindings);
+
 private:
     VkDescriptorSetLayout descriptorSetLayout_{VK_NULL_HANDLE};
     VkDevice device_{VK_NULL_HANDLE}; // Reference to device
     std::vector<VkDescriptorSetLayoutBinding> bindings_;
+    std::vector<VkDescriptorBindingFlags> bindingFlags_;
+    VkDescriptorSetLayoutCreateFlags flags_{0};
 
     // Helper methods
-    void CreateDescriptorSetLayout(VkDescriptorSetLayoutCreateFlags flags);
+    void CreateDescriptorSetLayout(VkDescriptorSetLayoutCreateFlags flags,
+                                   const std::vector<VkDescriptorBindingFlags>& binding_flags = {});
     void Cleanup();
     
     // Convert custom bindings to Vulkan bindings
@@ -0,0 +1,231 @@
+#include "DescriptorUpdateTemplate.hpp"
+
+#include "DescriptorSetLayout.hpp"
+#include "../core/Device.hpp"
+#include "../rendering/CommandBuffer.hpp"
+#include "../utils/HostAllocator.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+namespace VulkanEngine::RAII {
+
+namespace {
+// Size and alignment of the info struct a descriptor type reads from the packed data
+void GetDescriptorInfoLayout(VkDescriptorType type, size_t& size, size_t& alignment)
+{
+    switch (type) {
+        case VK_DESCRIPTOR_TYPE_SAMPLER:
+        case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+        case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+        case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+        case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+            size = sizeof(VkDescriptorImageInfo);
+            alignment = alignof(VkDescriptorImageInfo);
+            return;
+        case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+        case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+        case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+        case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+            size = sizeof(VkDescriptorBufferInfo);
+            alignment = alignof(VkDescriptorBufferInfo);
+            return;
+        case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+        case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+            size = sizeof(VkBufferView);
+            alignment = alignof(VkBufferView);
+            return;
+        default:
+            throw std::invalid_argument("Descriptor type cannot be packed into an update template");
+    }
+}
+} // namespace
+
+DescriptorUpdateTemplate::DescriptorUpdateTemplate(const Device& device,
+                                                   VkDescriptorSetLayout layout,
+                                                   const std::vector<VkDescriptorUpdateTemplateEntry>& entries)
+    : device_(device.GetHandle()),
+    entries_(entries)
+{
+    if (device == VK_NULL_HANDLE || layout == VK_NULL_HANDLE || entries_.empty()) {
+        throw std::invalid_argument("DescriptorUpdateTemplate requires a valid device, layout and entries");
+    }
+    CreateTemplate(layout, VK_PIPELINE_BIND_POINT_GRAPHICS);
+}
+
+DescriptorUpdateTemplate::DescriptorUpdateTemplate(const Device& device, const DescriptorSetLayout& layout)
+    : device_(device.GetHandle()),
+    entries_(BuildPackedEntries(layout.GetBindings(), dataSize_))
+{
+    if (device == VK_NULL_HANDLE || !layout.IsValid()) {
+        throw std::invalid_argument("DescriptorUpdateTemplate requires a valid device and layout");
+    }
+    if (layout.IsPushDescriptor()) {
+        throw std::invalid_argument("Push descriptor layouts need the push descriptor DescriptorUpdateTemplate constructor");
+    }
+    CreateTemplate(layout.GetHandle(), VK_PIPELINE_BIND_POINT_GRAPHICS);
+}
+
+DescriptorUpdateTemplate::DescriptorUpdateTemplate(const Device& device,
+                                                   const DescriptorSetLayout& layout,
+                                                   VkPipelineBindPoint bind_point,
+                                                   VkPipelineLayout pipeline_layout,
+                                                   uint32_t set)
+    : device_(device.GetHandle()),
+    pipelineLayout_(pipeline_layout),
+    set_(set),
+    entries_(BuildPackedEntries(layout.GetBindings(), dataSize_))
+{
+    if (device == VK_NULL_HANDLE || !layout.IsValid() || pipeline_layout == VK_NULL_HANDLE) {
+        throw std::invalid_argument("DescriptorUpdateTemplate requires a valid device, layout and pipeline layout");
+    }
+    if (!layout.IsPushDescriptor()) {
+        throw std::invalid_argument("Push descriptor templates require a push descriptor layout");
+    }
+    CreateTemplate(layout.GetHandle(), bind_point);
+}
+
+DescriptorUpdateTemplate DescriptorUpdateTemplate::FromReflection(const Device& device,
+                                                                  VkDescriptorSetLayout layout,
+                                                                  const Utils::SpirvReflection& reflection,
+                                                                  uint32_t set)
+{
+    std::vector<VkDescriptorSetLayoutBinding> bindings;
+    for (const Utils::SpirvReflection::DescriptorBinding& binding : reflection.descriptorBindings) {
+        // Runtime arrays are written sparsely (e.g. BindlessTable), not through a packed struct
+        if (binding.set == set && !binding.IsRuntimeArray()) {
+            bindings.push_back(binding.layoutBinding);
+        }
+    }
+    size_t data_size = 0;
+    DescriptorUpdateTemplate update_template(device, layout, BuildPackedEntries(bindings, data_size));
+    update_template.dataSize_ = data_size;
+    return update_template;
+}
+
+DescriptorUpdateTemplate::~DescriptorUpdateTemplate()
+{
+    Cleanup();
+}
+
+DescriptorUpdateTemplate::DescriptorUpdateTemplate(DescriptorUpdateTemplate&& other) noexcept
+    : updateTemplate_(other.updateTemplate_),
+    device_(other.device_),
+    pipelineLayout_(other.pipelineLayout_),
+    set_(other.set_),
+    dataSize_(other.dataSize_),
+    entries_(std::move(other.entries_))
+{
+    other.updateTemplate_ = VK_NULL_HANDLE;
+    other.device_ = VK_NULL_HANDLE;
+    other.pipelineLayout_ = VK_NULL_HANDLE;
+    other.dataSize_ = 0;
+}
+
+DescriptorUpdateTemplate& DescriptorUpdateTemplate::operator=(DescriptorUpdateTemplate&& other) noexcept
+{
+    if (this != &other) {
+        Cleanup();
+        updateTemplate_ = other.updateTemplate_;
+        device_ = other.device_;
+        pipelineLayout_ = other.pipelineLayout_;
+        set_ = other.set_;
+        dataSize_ = other.dataSize_;
+        entries_ = std::move(other.entries_);
+
+        other.updateTemplate_ = VK_NULL_HANDLE;
+        other.device_ = VK_NULL_HANDLE;
+        other.pipelineLayout_ = VK_NULL_HANDLE;
+        other.dataSize_ = 0;
+    }
+    return *this;
+}
+
+void DescriptorUpdateTemplate::Update(VkDescriptorSet descriptor_set, const void* data) const
+{
+    if (IsPushDescriptor()) {
+        throw std::logic_error("Push descriptor templates are applied with Push()");
+    }
+    vkUpdateDescriptorSetWithTemplate(device_, descriptor_set, updateTemplate_, data);
+}
+
+void DescriptorUpdateTemplate::Push(const CommandBuffer& command_buffer, const void* data) const
+{
+    if (!IsPushDescriptor()) {
+        throw std::logic_error("Only push descriptor templates can be pushed");
+    }
+    command_buffer.PushDescriptorSetWithTemplate(updateTemplate_, pipelineLayout_, set_, data);
+}
+
+std::vector<VkDescriptorUpdateTemplateEntry> DescriptorUpdateTemplate::BuildPackedEntries(const std::vector<VkDescriptorSetLayoutBinding>& bindings,
+                                                                                          size_t& data_size)
+{
+    std::vector<VkDescriptorSetLayoutBinding> sorted = bindings;
+    std::sort(sorted.begin(), sorted.end(), [](const VkDescriptorSetLayoutBinding& a, const VkDescriptorSetLayoutBinding& b) {
+        return a.binding < b.binding;
+    });
+
+    std::vector<VkDescriptorUpdateTemplateEntry> entries;
+    entries.reserve(sorted.size());
+    size_t offset = 0;
+    size_t max_alignment = 1;
+    for (const VkDescriptorSetLayoutBinding& binding : sorted) {
+        if (binding.descriptorCount == 0) {
+            throw std::invalid_argument("Runtime-sized descriptor arrays cannot be packed into an update template");
+        }
+        size_t size = 0;
+        size_t alignment = 1;
+        GetDescriptorInfoLayout(binding.descriptorType, size, alignment);
+        max_alignment = std::max(max_alignment, alignment);
+        offset = (offset + alignment - 1) / alignment * alignment;
+
+        VkDescriptorUpdateTemplateEntry entry{};
+        entry.dstBinding = binding.binding;
+        entry.dstArrayElement = 0;
+        entry.descriptorCount = binding.descriptorCount;
+        entry.descriptorType = binding.descriptorType;
+        entry.offset = offset;
+        entry.stride = size;
+        entries.push_back(entry);
+        offset += size * binding.descriptorCount;
+    }
+    // Rounded like sizeof of the matching struct
+    data_size = (offset + max_alignment - 1) / max_alignment * max_alignment;
+    return entries;
+}
+
+void DescriptorUpdateTemplate::CreateTemplate(VkDescriptorSetLayout layout, VkPipelineBindPoint bind_point)
+{
+    VkDescriptorUpdateTemplateCreateInfo create_info{VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO};
+    create_info.descriptorUpdateEntryCount = static_cast<uint32_t>(entries_.size());
+    create_info.pDescriptorUpdateEntries = entries_.data();
+    if (pipelineLayout_ != VK_NULL_HANDLE) {
+        create_info.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_PUSH_DESCRIPTORS_KHR;
+        create_info.pipelineBindPoint = bind_point;
+        create_info.pipelineLayout = pipelineLayout_;
+        create_info.set = set_;
+    } else {
+        create_info.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+    }
+    create_info.descriptorSetLayout = layout;
+
+    if (vkCreateDescriptorUpdateTemplate(device_, &create_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_DESCRIPTOR_UPDATE_TEMPLATE), &updateTemplate_) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create descriptor update template");
+    }
+}
+
+void DescriptorUpdateTemplate::Cleanup()
+{
+    if (updateTemplate_ != VK_NULL_HANDLE) {
+        vkDestroyDescriptorUpdateTemplate(device_, updateTemplate_, Utils::HostAllocator::For(VK_OBJECT_TYPE_DESCRIPTOR_UPDATE_TEMPLATE));
+        updateTemplate_ = VK_NULL_HANDLE;
+    }
+    device_ = VK_NULL_HANDLE;
+}
+
+} // namespace VulkanEngine::RAII
@@ -0,0 +1,116 @@
+#ifndef VULKAN_RAII_RESOURCES_DESCRIPTOR_UPDATE_TEMPLATE_HPP
+#define VULKAN_RAII_RESOURCES_DESCRIPTOR_UPDATE_TEMPLATE_HPP
+
+#include <volk.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "../utils/SpirvUtils.hpp"
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+class DescriptorSetLayout; // Forward declaration
+class CommandBuffer; // Forward declaration
+
+// Descriptor update template: a set is updated from one packed struct in a single
+// call instead of from VkWriteDescriptorSet arrays built per update.
+// The packed constructors lay bindings out in increasing binding order, each
+// descriptor as a VkDescriptorImageInfo, VkDescriptorBufferInfo or VkBufferView
+// (by descriptor type) at its natural alignment, so a struct such as
+//   struct MaterialDescriptors { VkDescriptorBufferInfo ubo; VkDescriptorImageInfo albedo; };
+// matches a layout with a uniform buffer at binding 0 and a sampled texture at binding 1.
+// GetDataSize() gives the packed size to check such structs against.
+class DescriptorUpdateTemplate {
+public:
+    // Constructor from explicit entries (offsets and strides into the caller's data)
+    DescriptorUpdateTemplate(const Device& device,
+                             VkDescriptorSetLayout layout,
+                             const std::vector<VkDescriptorUpdateTemplateEntry>& entries);
+
+    // Constructor packing every binding of the layout
+    DescriptorUpdateTemplate(const Device& device, const DescriptorSetLayout& layout);
+
+    // Constructor for CommandBuffer::PushDescriptorSetWithTemplate, packing every binding of a push descriptor layout
+    DescriptorUpdateTemplate(const Device& device,
+                             const DescriptorSetLayout& layout,
+                             VkPipelineBindPoint bind_point,
+                             VkPipelineLayout pipeline_layout,
+                             uint32_t set);
+
+    // Template for the bindings of set in reflection data (e.g. Shader::Reflect()).
+    // Runtime arrays are left out; update them with vkUpdateDescriptorSets
+    static DescriptorUpdateTemplate FromReflection(const Device& device,
+                                                   VkDescriptorSetLayout layout,
+                                                   const Utils::SpirvReflection& reflection,
+                                                   uint32_t set);
+
+    // Destructor
+    ~DescriptorUpdateTemplate();
+
+    // Move constructor and assignment
+    DescriptorUpdateTemplate(DescriptorUpdateTemplate&& other) noexcept;
+    DescriptorUpdateTemplate& operator=(DescriptorUpdateTemplate&& other) noexcept;
+
+    // Delete copy constructor and assignment. this ensures unique ownership of the VkDescriptorUpdateTemplate by only allowing moving.
+    DescriptorUpdateTemplate(const DescriptorUpdateTemplate&) = delete;
+    DescriptorUpdateTemplate& operator=(const DescriptorUpdateTemplate&) = delete;
+
+    [[nodiscard]] VkDescriptorUpdateTemplate GetHandle() const { return updateTemplate_; }
+
+    // Implicit conversion to VkDescriptorUpdateTemplate
+    operator VkDescriptorUpdateTemplate() const { return updateTemplate_; }
+
+    // Check if the template is valid
+    [[nodiscard]] bool IsValid() const { return updateTemplate_ != VK_NULL_HANDLE; }
+
+    // Check if this is a push descriptor template
+    [[nodiscard]] bool IsPushDescriptor() const { return pipelineLayout_ != VK_NULL_HANDLE; }
+
+    [[nodiscard]] const std::vector<VkDescriptorUpdateTemplateEntry>& GetEntries() const { return entries_; }
+
+    // Bytes of packed data the entries read (0 for explicit entries)
+    [[nodiscard]] size_t GetDataSize() const { return dataSize_; }
+
+    // Write the set from data laid out as the entries describe
+    void Update(VkDescriptorSet descriptor_set, const void* data) const;
+
+    template<typename T>
+    void Update(VkDescriptorSet descriptor_set, const T& data) const
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Descriptor data must be a plain struct");
+        Update(descriptor_set, static_cast<const void*>(&data));
+    }
+
+    // Push the descriptors into the command buffer (push descriptor templates only)
+    void Push(const CommandBuffer& command_buffer, const void* data) const;
+
+    template<typename T>
+    void Push(const CommandBuffer& command_buffer, const T& data) const
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Descriptor data must be a plain struct");
+        Push(command_buffer, static_cast<const void*>(&data));
+    }
+
+    // Packed entries for bindings (see class comment); runtime-sized arrays are rejected
+    static std::vector<VkDescriptorUpdateTemplateEntry> BuildPackedEntries(const std::vector<VkDescriptorSetLayoutBinding>& bindings,
+                                                                           size_t& data_size);
+
+private:
+    VkDescriptorUpdateTemplate updateTemplate_{VK_NULL_HANDLE};
+    VkDevice device_{VK_NULL_HANDLE}; // Reference to device
+    VkPipelineLayout pipelineLayout_{VK_NULL_HANDLE}; // Push descriptor templates only
+    uint32_t set_{0};
+    size_t dataSize_{0}; // Declared before entries_, which the packing constructors fill alongside it
+    std::vector<VkDescriptorUpdateTemplateEntry> entries_;
+
+    void CreateTemplate(VkDescriptorSetLayout layout, VkPipelineBindPoint bind_point);
+    void Cleanup();
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RESOURCES_DESCRIPTOR_UPDATE_TEMPLATE_HPP
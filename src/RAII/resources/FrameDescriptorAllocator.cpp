@@ -0,0 +1,163 @@
+#include "FrameDescriptorAllocator.hpp"
+
+#include "Buffer.hpp"
+#include "../core/Device.hpp"
+#include "../rendering/CommandBuffer.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+
+namespace VulkanEngine::RAII {
+
+FrameDescriptorAllocator::FrameDescriptorAllocator(const Device& device, uint32_t frame_count, Backend backend)
+    : device_(&device),
+    backend_(backend)
+{
+    if (backend_ == Backend::DESCRIPTOR_BUFFER) {
+        bufferAllocator_ = std::make_unique<DescriptorBufferAllocator>(device, frame_count);
+    } else {
+        poolAllocator_ = std::make_unique<DescriptorAllocator>(device, frame_count);
+    }
+}
+
+FrameDescriptorAllocator::FrameDescriptorAllocator(const Device& device, uint32_t frame_count)
+    : FrameDescriptorAllocator(device, frame_count, ChooseBackend(device)) {}
+
+FrameDescriptorAllocator::Backend FrameDescriptorAllocator::ChooseBackend(const Device& device)
+{
+    return DescriptorBufferAllocator::IsSupported(device) ? Backend::DESCRIPTOR_BUFFER : Backend::DESCRIPTOR_POOL;
+}
+
+VkDescriptorSetLayoutCreateFlags FrameDescriptorAllocator::GetLayoutCreateFlags() const
+{
+    return backend_ == Backend::DESCRIPTOR_BUFFER ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT : 0;
+}
+
+VkPipelineCreateFlags FrameDescriptorAllocator::GetPipelineCreateFlags() const
+{
+    return backend_ == Backend::DESCRIPTOR_BUFFER ? VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT : 0;
+}
+
+void FrameDescriptorAllocator::AttachToRenderer(Renderer& renderer)
+{
+    if (bufferAllocator_) {
+        bufferAllocator_->AttachToRenderer(renderer);
+    } else {
+        poolAllocator_->AttachToRenderer(renderer);
+    }
+}
+
+void FrameDescriptorAllocator::Detach()
+{
+    if (bufferAllocator_) {
+        bufferAllocator_->Detach();
+    } else {
+        poolAllocator_->Detach();
+    }
+}
+
+void FrameDescriptorAllocator::BeginFrame(uint32_t frame_index)
+{
+    if (bufferAllocator_) {
+        bufferAllocator_->BeginFrame(frame_index);
+    } else {
+        poolAllocator_->BeginFrame(frame_index);
+    }
+}
+
+FrameDescriptorSet FrameDescriptorAllocator::Allocate(VkDescriptorSetLayout layout)
+{
+    FrameDescriptorSet set{};
+    if (bufferAllocator_) {
+        set.buffer = bufferAllocator_->Allocate(layout);
+    } else {
+        set.set = poolAllocator_->Allocate(layout);
+    }
+    return set;
+}
+
+void FrameDescriptorAllocator::WriteBuffer(const FrameDescriptorSet& set,
+                                           uint32_t binding,
+                                           VkDescriptorType type,
+                                           const Buffer& buffer,
+                                           VkDeviceSize offset,
+                                           VkDeviceSize range,
+                                           uint32_t array_element) const
+{
+    if (bufferAllocator_) {
+        bufferAllocator_->WriteBuffer(set.buffer, binding, type, buffer, offset, range, array_element);
+        return;
+    }
+    const VkDescriptorBufferInfo buffer_info{buffer.GetHandle(), offset, range};
+    VkWriteDescriptorSet write{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+    write.dstSet = set.set;
+    write.dstBinding = binding;
+    write.dstArrayElement = array_element;
+    write.descriptorCount = 1;
+    write.descriptorType = type;
+    write.pBufferInfo = &buffer_info;
+    vkUpdateDescriptorSets(device_->GetHandle(), 1, &write, 0, nullptr);
+}
+
+void FrameDescriptorAllocator::WriteImage(const FrameDescriptorSet& set,
+                                          uint32_t binding,
+                                          VkDescriptorType type,
+                                          VkImageView image_view,
+                                          VkSampler sampler,
+                                          VkImageLayout image_layout,
+                                          uint32_t array_element) const
+{
+    if (bufferAllocator_) {
+        if (type == VK_DESCRIPTOR_TYPE_SAMPLER) {
+            bufferAllocator_->WriteSampler(set.buffer, binding, sampler, array_element);
+        } else {
+            bufferAllocator_->WriteImage(set.buffer, binding, type, image_view, sampler, image_layout, array_element);
+        }
+        return;
+    }
+    const VkDescriptorImageInfo image_info{sampler, image_view, image_layout};
+    VkWriteDescriptorSet write{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+    write.dstSet = set.set;
+    write.dstBinding = binding;
+    write.dstArrayElement = array_element;
+    write.descriptorCount = 1;
+    write.descriptorType = type;
+    write.pImageInfo = &image_info;
+    vkUpdateDescriptorSets(device_->GetHandle(), 1, &write, 0, nullptr);
+}
+
+void FrameDescriptorAllocator::BeginCommandBuffer(const CommandBuffer& command_buffer) const
+{
+    if (bufferAllocator_) {
+        bufferAllocator_->BindBuffer(command_buffer);
+    }
+}
+
+void FrameDescriptorAllocator::Bind(const CommandBuffer& command_buffer,
+                                    VkPipelineBindPoint bind_point,
+                                    VkPipelineLayout pipeline_layout,
+                                    uint32_t first_set,
+                                    std::span<const FrameDescriptorSet> sets) const
+{
+    if (bufferAllocator_) {
+        std::vector<DescriptorBufferSet> buffer_sets;
+        buffer_sets.reserve(sets.size());
+        for (const FrameDescriptorSet& set : sets) {
+            buffer_sets.push_back(set.buffer);
+        }
+        bufferAllocator_->Bind(command_buffer, bind_point, pipeline_layout, first_set, buffer_sets);
+        return;
+    }
+    std::vector<VkDescriptorSet> descriptor_sets;
+    descriptor_sets.reserve(sets.size());
+    for (const FrameDescriptorSet& set : sets) {
+        descriptor_sets.push_back(set.set);
+    }
+    command_buffer.BindDescriptorSets(bind_point, pipeline_layout, first_set, descriptor_sets);
+}
+
+} // namespace VulkanEngine::RAII
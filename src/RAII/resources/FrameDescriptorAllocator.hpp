@@ -0,0 +1,101 @@
+#ifndef VULKAN_RAII_RESOURCES_FRAME_DESCRIPTOR_ALLOCATOR_HPP
+#define VULKAN_RAII_RESOURCES_FRAME_DESCRIPTOR_ALLOCATOR_HPP
+
+#include <volk.h>
+
+#include <cstdint>
+#include <memory>
+#include <span>
+
+#include "DescriptorAllocator.hpp"
+#include "DescriptorBufferAllocator.hpp"
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+class Renderer; // Forward declaration
+class CommandBuffer; // Forward declaration
+class Buffer; // Forward declaration
+
+// Per-frame descriptor set handed out by either backend
+struct FrameDescriptorSet {
+    VkDescriptorSet set{VK_NULL_HANDLE}; // DESCRIPTOR_POOL backend
+    DescriptorBufferSet buffer; // DESCRIPTOR_BUFFER backend
+};
+
+// One per-frame descriptor interface over DescriptorAllocator and
+// DescriptorBufferAllocator, so callers switch backends per device. Layouts and
+// pipelines used with it must be created with GetLayoutCreateFlags() and
+// GetPipelineCreateFlags() (GraphicsPipelineDescription::createFlags).
+// Not thread-safe; use one allocator per recording thread.
+class FrameDescriptorAllocator {
+public:
+    enum class Backend : uint8_t {
+        DESCRIPTOR_POOL,
+        DESCRIPTOR_BUFFER
+    };
+
+    // Constructor using the given backend
+    FrameDescriptorAllocator(const Device& device, uint32_t frame_count, Backend backend);
+
+    // Constructor choosing the best backend for the device
+    FrameDescriptorAllocator(const Device& device, uint32_t frame_count);
+
+    // Destructor
+    ~FrameDescriptorAllocator() = default;
+
+    // Delete copy and move. the backends hold renderer callbacks referencing themselves.
+    FrameDescriptorAllocator(const FrameDescriptorAllocator&) = delete;
+    FrameDescriptorAllocator& operator=(const FrameDescriptorAllocator&) = delete;
+    FrameDescriptorAllocator(FrameDescriptorAllocator&&) = delete;
+    FrameDescriptorAllocator& operator=(FrameDescriptorAllocator&&) = delete;
+
+    // DESCRIPTOR_BUFFER when the device supports it
+    [[nodiscard]] static Backend ChooseBackend(const Device& device);
+
+    [[nodiscard]] Backend GetBackend() const { return backend_; }
+    [[nodiscard]] VkDescriptorSetLayoutCreateFlags GetLayoutCreateFlags() const;
+    [[nodiscard]] VkPipelineCreateFlags GetPipelineCreateFlags() const;
+
+    // See DescriptorAllocator
+    void AttachToRenderer(Renderer& renderer);
+    void Detach();
+    void BeginFrame(uint32_t frame_index);
+
+    [[nodiscard]] FrameDescriptorSet Allocate(VkDescriptorSetLayout layout);
+
+    // buffer needs SHADER_DEVICE_ADDRESS usage for the descriptor buffer backend
+    void WriteBuffer(const FrameDescriptorSet& set,
+                     uint32_t binding,
+                     VkDescriptorType type,
+                     const Buffer& buffer,
+                     VkDeviceSize offset = 0,
+                     VkDeviceSize range = VK_WHOLE_SIZE,
+                     uint32_t array_element = 0) const;
+    void WriteImage(const FrameDescriptorSet& set,
+                    uint32_t binding,
+                    VkDescriptorType type,
+                    VkImageView image_view,
+                    VkSampler sampler = VK_NULL_HANDLE,
+                    VkImageLayout image_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                    uint32_t array_element = 0) const;
+
+    // Once per command buffer before Bind() (nothing to do for the pool backend)
+    void BeginCommandBuffer(const CommandBuffer& command_buffer) const;
+
+    void Bind(const CommandBuffer& command_buffer,
+              VkPipelineBindPoint bind_point,
+              VkPipelineLayout pipeline_layout,
+              uint32_t first_set,
+              std::span<const FrameDescriptorSet> sets) const;
+
+private:
+    const Device* device_{nullptr};
+    Backend backend_;
+    std::unique_ptr<DescriptorAllocator> poolAllocator_;
+    std::unique_ptr<DescriptorBufferAllocator> bufferAllocator_;
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RESOURCES_FRAME_DESCRIPTOR_ALLOCATOR_HPP
@@ -0,0 +1,125 @@
+#include "FrameRingBuffer.hpp"
+
+#include "VmaAllocator.hpp"
+#include "../core/Device.hpp"
+#include "../core/PhysicalDevice.hpp"
+#include "../rendering/Renderer.hpp"
+#include "../utils/MemoryUtils.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+
+namespace VulkanEngine::RAII {
+
+namespace {
+VkDeviceSize QueryOffsetAlignment(const Device& device, VkBufferUsageFlags usage)
+{
+    const VkPhysicalDeviceLimits& limits = device.GetPhysicalDevice().GetLimits();
+    VkDeviceSize alignment = 1;
+    if (usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT) {
+        alignment = std::max(alignment, limits.minUniformBufferOffsetAlignment);
+    }
+    if (usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) {
+        alignment = std::max(alignment, limits.minStorageBufferOffsetAlignment);
+    }
+    // Keep flushes of non-coherent memory on atom boundaries
+    return std::max(alignment, limits.nonCoherentAtomSize);
+}
+
+VkDeviceSize ValidateFrameSize(VkDeviceSize bytes_per_frame, VkDeviceSize alignment)
+{
+    if (bytes_per_frame == 0) {
+        throw std::invalid_argument("FrameRingBuffer requires a non-zero frame size");
+    }
+    return Utils::MemoryUtils::AlignedSize(bytes_per_frame, alignment);
+}
+} // namespace
+
+FrameRingBuffer::FrameRingBuffer(const Device& device,
+                                 const VmaAllocator& allocator,
+                                 VkDeviceSize bytes_per_frame,
+                                 uint32_t frame_count,
+                                 VkBufferUsageFlags usage,
+                                 const char* name)
+    : alignment_(QueryOffsetAlignment(device, usage)),
+    frameSize_(ValidateFrameSize(bytes_per_frame, alignment_)),
+    frameCount_(std::max(1u, frame_count)),
+    buffer_(allocator,
+            frameSize_ * frameCount_,
+            usage,
+            VMA_MEMORY_USAGE_AUTO_PREFER_HOST,
+            VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT,
+            name)
+{
+    mapped_ = static_cast<uint8_t*>(buffer_.GetMappedData());
+    if (!mapped_) {
+        throw std::runtime_error("FrameRingBuffer failed to persistently map its buffer");
+    }
+}
+
+FrameRingBuffer::~FrameRingBuffer()
+{
+    Detach();
+}
+
+void FrameRingBuffer::AttachToRenderer(Renderer& renderer)
+{
+    Detach();
+    if (renderer.GetMaxFramesInFlight() > frameCount_) {
+        throw std::invalid_argument("FrameRingBuffer has fewer regions than the renderer has frames in flight");
+    }
+    frameBeginSubscription_ = renderer.SubscribeFrameBegin([this](uint32_t frame_index) {
+        BeginFrame(frame_index);
+    });
+}
+
+void FrameRingBuffer::Detach()
+{
+    frameBeginSubscription_.Reset();
+}
+
+void FrameRingBuffer::BeginFrame(uint32_t frame_index)
+{
+    currentFrame_ = frame_index % frameCount_;
+    frameBase_ = frameSize_ * currentFrame_;
+    head_ = frameBase_;
+    flushedHead_ = frameBase_;
+}
+
+RingAllocation FrameRingBuffer::Allocate(VkDeviceSize size)
+{
+    if (size == 0) {
+        throw std::invalid_argument("FrameRingBuffer allocation size must be non-zero");
+    }
+
+    const VkDeviceSize offset = Utils::MemoryUtils::AlignedSize(head_, alignment_);
+    if (offset + size > frameBase_ + frameSize_) {
+        throw std::runtime_error("FrameRingBuffer frame region exhausted");
+    }
+    if (offset > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("FrameRingBuffer offset exceeds dynamic offset range");
+    }
+    head_ = offset + size;
+
+    RingAllocation allocation{};
+    allocation.data = mapped_ + offset;
+    allocation.offset = offset;
+    allocation.dynamicOffset = static_cast<uint32_t>(offset);
+    allocation.size = size;
+    return allocation;
+}
+
+void FrameRingBuffer::FlushCurrentFrame()
+{
+    if (head_ == flushedHead_) {
+        return;
+    }
+    const VkDeviceSize end = std::min(Utils::MemoryUtils::AlignedSize(head_, alignment_), frameBase_ + frameSize_);
+    buffer_.Flush(end - flushedHead_, flushedHead_);
+    flushedHead_ = head_;
+}
+
+} // namespace VulkanEngine::RAII
@@ -0,0 +1,101 @@
+#ifndef VULKAN_RAII_RESOURCES_FRAME_RING_BUFFER_HPP
+#define VULKAN_RAII_RESOURCES_FRAME_RING_BUFFER_HPP
+
+#include <volk.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "../rendering/FrameBeginSubscription.hpp"
+#include "Buffer.hpp"
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+class VmaAllocator; // Forward declaration
+class Renderer; // Forward declaration
+
+// A sub-allocation from the ring; dynamicOffset is ready for BindDescriptorSets
+struct RingAllocation {
+    void* data{nullptr};
+    VkDeviceSize offset{0};
+    uint32_t dynamicOffset{0};
+    VkDeviceSize size{0};
+};
+
+// Persistently mapped buffer split into one region per frame in flight.
+// Allocations are bump-allocated from the current frame's region and the region
+// is recycled once the renderer has waited on that frame's fence.
+class FrameRingBuffer {
+public:
+    // Constructor that creates a persistently mapped buffer with frame_count regions of bytes_per_frame
+    FrameRingBuffer(const Device& device,
+                    const VmaAllocator& allocator,
+                    VkDeviceSize bytes_per_frame,
+                    uint32_t frame_count,
+                    VkBufferUsageFlags usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                    const char* name = nullptr);
+
+    // Destructor
+    ~FrameRingBuffer();
+
+    // Delete copy and move. the attached renderer holds a callback referencing this object.
+    FrameRingBuffer(const FrameRingBuffer&) = delete;
+    FrameRingBuffer& operator=(const FrameRingBuffer&) = delete;
+    FrameRingBuffer(FrameRingBuffer&&) = delete;
+    FrameRingBuffer& operator=(FrameRingBuffer&&) = delete;
+
+    // Recycle regions automatically from Renderer::BeginFrame. The renderer must outlive
+    // this ring or Detach() must be called first
+    void AttachToRenderer(Renderer& renderer);
+    void Detach();
+
+    // Reset the region of frame_index and make it current (called by the attached renderer)
+    void BeginFrame(uint32_t frame_index);
+
+    // Bump-allocate size bytes from the current frame's region
+    [[nodiscard]] RingAllocation Allocate(VkDeviceSize size);
+
+    // Allocate and copy a value in one step
+    template <typename T>
+    RingAllocation Push(const T& value) {
+        RingAllocation allocation = Allocate(sizeof(T));
+        std::memcpy(allocation.data, &value, sizeof(T));
+        return allocation;
+    }
+
+    // Flush the bytes written this frame (no-op on host-coherent memory)
+    void FlushCurrentFrame();
+
+    [[nodiscard]] const Buffer& GetBuffer() const { return buffer_; }
+    [[nodiscard]] VkBuffer GetHandle() const { return buffer_.GetHandle(); }
+
+    // Region size per frame after alignment, and the alignment used for allocations
+    [[nodiscard]] VkDeviceSize GetFrameSize() const { return frameSize_; }
+    [[nodiscard]] VkDeviceSize GetAlignment() const { return alignment_; }
+
+    // Bytes used in the current frame's region
+    [[nodiscard]] VkDeviceSize GetUsedBytes() const { return head_ - frameBase_; }
+
+    [[nodiscard]] uint32_t GetFrameCount() const { return frameCount_; }
+    [[nodiscard]] uint32_t GetCurrentFrame() const { return currentFrame_; }
+
+private:
+    VkDeviceSize alignment_{1};
+    VkDeviceSize frameSize_{0};
+    uint32_t frameCount_{0};
+    Buffer buffer_;
+    uint8_t* mapped_{nullptr};
+
+    uint32_t currentFrame_{0};
+    VkDeviceSize frameBase_{0};
+    VkDeviceSize head_{0};
+    VkDeviceSize flushedHead_{0};
+
+    FrameBeginSubscription frameBeginSubscription_;
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RESOURCES_FRAME_RING_BUFFER_HPP
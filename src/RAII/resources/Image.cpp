@@ -1,14 +1,43 @@
 #include "Image.hpp"
 
+#include "ImageView.hpp"
 #include "VmaAllocator.hpp"
+#include "MemoryPool.hpp"
 #include "../core/Device.hpp"
+#include "../core/PhysicalDevice.hpp"
+#include "../rendering/CommandBuffer.hpp"
+#include "../sync/BarrierBatcher.hpp"
+#include "../utils/FormatUtils.hpp"
+#include "../utils/HashUtils.hpp"
+#include "../utils/ImageUtils.hpp"
+#include "../utils/HostAllocator.hpp"
+#include "../utils/SyncUtils.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
+#include <mutex>
 #include <stdexcept>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace VulkanEngine::RAII {
 
+struct Image::ViewCache {
+    // View type, format, aspect, base mip, mip count, base layer, layer count (counts resolved)
+    using Key = std::array<uint32_t, 7>;
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return static_cast<size_t>(Utils::HashFnv1a(key.data(), key.size()));
+        }
+    };
+
+    std::mutex mutex;
+    std::unordered_map<Key, ImageView, KeyHash> views;
+};
+
 Image::Image(const VmaAllocator& allocator,
              uint32_t width,
              uint32_t height,
@@ -58,6 +87,97 @@ Image::Image(const VmaAllocator& allocator,
     }
 }
 
+Image::Image(const VmaAllocator& allocator,
+             const VkImageCreateInfo& image_info,
+             const VmaAllocationCreateInfo& allocation_info)
+    : width_(image_info.extent.width),
+    height_(image_info.extent.height),
+    depth_(image_info.extent.depth),
+    mipLevels_(image_info.mipLevels),
+    arrayLayers_(image_info.arrayLayers),
+    format_(image_info.format),
+    imageType_(image_info.imageType),
+    tiling_(image_info.tiling),
+    usage_(image_info.usage),
+    samples_(image_info.samples),
+    vmaAllocator_(allocator.GetHandle()),
+    device_(allocator.GetDevice()),
+    deviceRef_(allocator.GetDeviceRef()),
+    usingVMA_(true)
+{
+    if (allocator.CreateImage(image_info, allocation_info, image_, allocation_, &allocationInfo_) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create image with VMA");
+    }
+}
+
+Image::Image(const MemoryPool& pool,
+             uint32_t width,
+             uint32_t height,
+             uint32_t depth,
+             uint32_t mip_levels,
+             uint32_t array_layers,
+             VkFormat format,
+             VkImageType image_type,
+             VkImageTiling tiling,
+             VkImageUsageFlags usage,
+             VkSampleCountFlagBits samples)
+    : width_(width),
+    height_(height),
+    depth_(depth),
+    mipLevels_(mip_levels),
+    arrayLayers_(array_layers),
+    format_(format),
+    imageType_(image_type),
+    tiling_(tiling),
+    usage_(usage),
+    samples_(samples),
+    vmaAllocator_(pool.GetAllocator().GetHandle()),
+    device_(pool.GetAllocator().GetDevice()),
+    deviceRef_(pool.GetAllocator().GetDeviceRef()),
+    usingVMA_(true)
+{
+    VkImageCreateInfo image_info{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+    image_info.imageType = image_type;
+    image_info.extent.width = width;
+    image_info.extent.height = height;
+    image_info.extent.depth = depth;
+    image_info.mipLevels = mip_levels;
+    image_info.arrayLayers = array_layers;
+    image_info.format = format;
+    image_info.tiling = tiling;
+    image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    image_info.usage = usage;
+    image_info.samples = samples;
+    image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo alloc_info{};
+    alloc_info.pool = pool.GetHandle();
+
+    if (pool.GetAllocator().CreateImage(image_info, alloc_info, image_, allocation_, &allocationInfo_) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create image in VMA pool");
+    }
+}
+
+Image::Image(const Device& device, const VkImageCreateInfo& image_info)
+    : width_(image_info.extent.width),
+    height_(image_info.extent.height),
+    depth_(image_info.extent.depth),
+    mipLevels_(image_info.mipLevels),
+    arrayLayers_(image_info.arrayLayers),
+    format_(image_info.format),
+    imageType_(image_info.imageType),
+    tiling_(image_info.tiling),
+    usage_(image_info.usage),
+    samples_(image_info.samples),
+    createFlags_(image_info.flags),
+    device_(device.GetHandle()),
+    deviceRef_(&device)
+{
+    if (vkCreateImage(device_, &image_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_IMAGE), &image_) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create image");
+    }
+}
+
 Image::Image(const Device& device,
              uint32_t width,
              uint32_t height,
@@ -98,7 +218,7 @@ Image::Image(const Device& device,
     image_info.samples = samples;
     image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-    if (vkCreateImage(device_, &image_info, nullptr, &image_) != VK_SUCCESS) {
+    if (vkCreateImage(device_, &image_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_IMAGE), &image_) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create image");
     }
 
@@ -109,8 +229,8 @@ Image::Image(const Device& device,
     alloc_info.allocationSize = mem_requirements.size;
     alloc_info.memoryTypeIndex = device.FindMemoryType(mem_requirements.memoryTypeBits, properties);
 
-    if (vkAllocateMemory(device_, &alloc_info, nullptr, &memory_) != VK_SUCCESS) {
-        vkDestroyImage(device_, image_, nullptr);
+    if (vkAllocateMemory(device_, &alloc_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_DEVICE_MEMORY), &memory_) != VK_SUCCESS) {
+        vkDestroyImage(device_, image_, Utils::HostAllocator::For(VK_OBJECT_TYPE_IMAGE));
         image_ = VK_NULL_HANDLE;
         throw std::runtime_error("Failed to allocate image memory");
     }
@@ -136,6 +256,7 @@ Image::Image(VkImage image,
 
 Image::~Image() {
     Cleanup();
+    delete viewCache_.load(std::memory_order_relaxed);
 }
 
 Image::Image(Image&& other) noexcept
@@ -150,6 +271,7 @@ Image::Image(Image&& other) noexcept
     tiling_(other.tiling_),
     usage_(other.usage_),
     samples_(other.samples_),
+    createFlags_(other.createFlags_),
     vmaAllocator_(other.vmaAllocator_),
     allocation_(other.allocation_),
     allocationInfo_(other.allocationInfo_),
@@ -158,7 +280,10 @@ Image::Image(Image&& other) noexcept
     memory_(other.memory_),
     memoryProperties_(other.memoryProperties_),
     usingVMA_(other.usingVMA_),
-    ownsImage_(other.ownsImage_)
+    ownsImage_(other.ownsImage_),
+    debugName_(std::move(other.debugName_)),
+    trackedStates_(std::move(other.trackedStates_)),
+    viewCache_(other.viewCache_.exchange(nullptr, std::memory_order_relaxed))
 {
     other.image_ = VK_NULL_HANDLE;
     other.allocation_ = VK_NULL_HANDLE;
@@ -180,6 +305,7 @@ Image& Image::operator=(Image&& other) noexcept {
         tiling_ = other.tiling_;
         usage_ = other.usage_;
         samples_ = other.samples_;
+        createFlags_ = other.createFlags_;
         vmaAllocator_ = other.vmaAllocator_;
         allocation_ = other.allocation_;
         allocationInfo_ = other.allocationInfo_;
@@ -189,6 +315,10 @@ Image& Image::operator=(Image&& other) noexcept {
         memoryProperties_ = other.memoryProperties_;
         usingVMA_ = other.usingVMA_;
         ownsImage_ = other.ownsImage_;
+        debugName_ = std::move(other.debugName_);
+        trackedStates_ = std::move(other.trackedStates_);
+        delete viewCache_.exchange(nullptr, std::memory_order_relaxed);
+        viewCache_.store(other.viewCache_.exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
 
         other.image_ = VK_NULL_HANDLE;
         other.allocation_ = VK_NULL_HANDLE;
@@ -198,6 +328,31 @@ Image& Image::operator=(Image&& other) noexcept {
     return *this;
 }
 
+const ResourceState& Image::GetTrackedState(uint32_t mip_level, uint32_t array_layer) const {
+    static const ResourceState UNTRACKED{};
+    if (trackedStates_.empty()) {
+        return UNTRACKED;
+    }
+    return trackedStates_[static_cast<size_t>(array_layer) * mipLevels_ + mip_level];
+}
+
+void Image::SetTrackedState(const ResourceState& state,
+                            uint32_t base_mip_level,
+                            uint32_t level_count,
+                            uint32_t base_array_layer,
+                            uint32_t layer_count) {
+    if (trackedStates_.empty()) {
+        trackedStates_.resize(static_cast<size_t>(mipLevels_) * arrayLayers_);
+    }
+    const uint32_t mip_end = level_count == VK_REMAINING_MIP_LEVELS ? mipLevels_ : base_mip_level + level_count;
+    const uint32_t layer_end = layer_count == VK_REMAINING_ARRAY_LAYERS ? arrayLayers_ : base_array_layer + layer_count;
+    for (uint32_t layer = base_array_layer; layer < layer_end; ++layer) {
+        for (uint32_t mip = base_mip_level; mip < mip_end; ++mip) {
+            trackedStates_[static_cast<size_t>(layer) * mipLevels_ + mip] = state;
+        }
+    }
+}
+
 VkImageView Image::CreateImageView(VkImageViewType view_type,
                                    VkImageAspectFlags aspect_flags,
                                    uint32_t base_mip_level,
@@ -215,12 +370,85 @@ VkImageView Image::CreateImageView(VkImageViewType view_type,
     view_info.subresourceRange.layerCount = layer_count == VK_REMAINING_ARRAY_LAYERS ? arrayLayers_ - base_array_layer : layer_count;
 
     VkImageView image_view = VK_NULL_HANDLE;
-    if (vkCreateImageView(device_, &view_info, nullptr, &image_view) != VK_SUCCESS) {
+    if (vkCreateImageView(device_, &view_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_IMAGE_VIEW), &image_view) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create image view");
     }
     return image_view;
 }
 
+const ImageView& Image::GetView(VkImageViewType view_type,
+                               VkImageAspectFlags aspect_flags,
+                               uint32_t base_mip_level,
+                               uint32_t level_count,
+                               uint32_t base_array_layer,
+                               uint32_t layer_count,
+                               VkFormat format) const {
+    if (image_ == VK_NULL_HANDLE) {
+        throw std::runtime_error("Image::GetView called on an empty or moved-from image");
+    }
+
+    VkImageViewCreateInfo view_info{VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+    view_info.image = image_;
+    view_info.viewType = view_type;
+    view_info.format = format == VK_FORMAT_UNDEFINED ? format_ : format;
+    view_info.subresourceRange.aspectMask = aspect_flags;
+    view_info.subresourceRange.baseMipLevel = base_mip_level;
+    view_info.subresourceRange.levelCount = level_count == VK_REMAINING_MIP_LEVELS ? mipLevels_ - base_mip_level : level_count;
+    view_info.subresourceRange.baseArrayLayer = base_array_layer;
+    view_info.subresourceRange.layerCount = layer_count == VK_REMAINING_ARRAY_LAYERS ? arrayLayers_ - base_array_layer : layer_count;
+
+    const ViewCache::Key key = {static_cast<uint32_t>(view_info.viewType),
+                         static_cast<uint32_t>(view_info.format),
+                         view_info.subresourceRange.aspectMask,
+                         view_info.subresourceRange.baseMipLevel,
+                         view_info.subresourceRange.levelCount,
+                         view_info.subresourceRange.baseArrayLayer,
+                         view_info.subresourceRange.layerCount};
+
+    ViewCache& cache = GetViewCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.views.find(key);
+    if (it == cache.views.end()) {
+        it = cache.views.emplace(key, ImageView(device_, view_info)).first;
+    }
+    return it->second;
+}
+
+size_t Image::GetCachedViewCount() const {
+    ViewCache* cache = viewCache_.load(std::memory_order_acquire);
+    if (!cache) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    return cache->views.size();
+}
+
+Image::ViewCache& Image::GetViewCache() const {
+    ViewCache* cache = viewCache_.load(std::memory_order_acquire);
+    if (cache) {
+        return *cache;
+    }
+    // Racing first calls each build a cache; the loser deletes its own
+    auto created = std::make_unique<ViewCache>();
+    if (viewCache_.compare_exchange_strong(cache, created.get(), std::memory_order_acq_rel, std::memory_order_acquire)) {
+        return *created.release();
+    }
+    return *cache;
+}
+
+std::shared_ptr<void> Image::DetachViews() {
+    return std::shared_ptr<ViewCache>(viewCache_.exchange(nullptr, std::memory_order_acq_rel));
+}
+
+void Image::ReleaseViews() {
+    ViewCache* cache = viewCache_.load(std::memory_order_acquire);
+    if (!cache) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    cache->views.clear();
+}
+
 void Image::TransitionLayout(VkImageLayout old_layout,
                              VkImageLayout new_layout,
                              VkImageAspectFlags aspect_flags,
@@ -281,6 +509,53 @@ void Image::TransitionLayout(VkImageLayout old_layout,
                          0, nullptr,
                          0, nullptr,
                          1, &barrier);
+
+    // Later BarrierBatcher requirements only wait for this transition
+    ResourceState state{};
+    state.layout = new_layout;
+    state.writeStages = Utils::ImageUtils::GetLayoutPipelineStageFlags2(new_layout, false);
+    state.readStages = state.writeStages;
+    state.readAccess = Utils::ImageUtils::GetLayoutAccessFlags2(new_layout);
+    SetTrackedState(state,
+                    barrier.subresourceRange.baseMipLevel,
+                    barrier.subresourceRange.levelCount,
+                    barrier.subresourceRange.baseArrayLayer,
+                    barrier.subresourceRange.layerCount);
+}
+
+void Image::ReleaseOwnership(const CommandBuffer& command_buffer, const OwnershipTransfer& transfer) const {
+    ReleaseOwnership(command_buffer,
+                     transfer,
+                     Utils::ImageUtils::CreateSubresourceRange(Utils::ImageUtils::GetImageAspectFlags(format_)));
+}
+
+void Image::ReleaseOwnership(const CommandBuffer& command_buffer,
+                             const OwnershipTransfer& transfer,
+                             const VkImageSubresourceRange& range) const {
+    if (!transfer.ChangesFamily()) {
+        return;
+    }
+    const VkImageMemoryBarrier2KHR barrier = Utils::SyncUtils::CreateOwnershipBarrier(image_, range, transfer, true);
+    command_buffer.FlushBarriers();
+    command_buffer.PipelineBarrier2({}, {}, std::span<const VkImageMemoryBarrier2KHR>(&barrier, 1));
+}
+
+void Image::AcquireOwnership(const CommandBuffer& command_buffer, const OwnershipTransfer& transfer) {
+    AcquireOwnership(command_buffer,
+                     transfer,
+                     Utils::ImageUtils::CreateSubresourceRange(Utils::ImageUtils::GetImageAspectFlags(format_)));
+}
+
+void Image::AcquireOwnership(const CommandBuffer& command_buffer,
+                             const OwnershipTransfer& transfer,
+                             const VkImageSubresourceRange& range) {
+    const VkImageMemoryBarrier2KHR barrier = Utils::SyncUtils::CreateOwnershipBarrier(image_, range, transfer, false);
+    command_buffer.FlushBarriers();
+    command_buffer.PipelineBarrier2({}, {}, std::span<const VkImageMemoryBarrier2KHR>(&barrier, 1));
+
+    // The acquire performed the layout transition and made the destination stages wait
+    SetTrackedState(BarrierBatcher::GetStateAfter(transfer.destinationAccess),
+                    range.baseMipLevel, range.levelCount, range.baseArrayLayer, range.layerCount);
 }
 
 void Image::CopyFromBuffer(VkBuffer /*buffer*/, const std::vector<VkBufferImageCopy>& /*regions*/) {
@@ -291,8 +566,296 @@ void Image::CopyToBuffer(VkBuffer /*buffer*/, const std::vector<VkBufferImageCop
     throw std::runtime_error("Image::copyToBuffer requires explicit command buffer management and is not implemented in this RAII wrapper yet");
 }
 
-void Image::GenerateMipmaps(VkFilter /*filter*/) {
-    throw std::runtime_error("Image::generateMipmaps requires explicit command buffer management and is not implemented in this RAII wrapper yet");
+void Image::CopyToBuffer(const CommandBuffer& command_buffer,
+                         VkBuffer buffer,
+                         const std::vector<VkBufferImageCopy>& regions,
+                         VkImageLayout src_layout) const
+{
+    if (regions.empty()) {
+        return;
+    }
+    vkCmdCopyImageToBuffer(command_buffer.GetHandle(),
+                           image_,
+                           src_layout,
+                           buffer,
+                           static_cast<uint32_t>(regions.size()),
+                           regions.data());
+}
+
+bool Image::SupportsHostCopy() const {
+    if (!deviceRef_ || !deviceRef_->SupportsHostImageCopy() || (usage_ & VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT) == 0) {
+        return false;
+    }
+    return deviceRef_->GetPhysicalDevice().GetFormatTable().Supports(format_, tiling_, VK_FORMAT_FEATURE_2_HOST_IMAGE_TRANSFER_BIT_EXT);
+}
+
+void Image::CopyFromMemory(std::span<const VkMemoryToImageCopyEXT> regions,
+                           VkImageLayout current_layout,
+                           VkImageLayout final_layout)
+{
+    if (regions.empty()) {
+        return;
+    }
+    if (!SupportsHostCopy()) {
+        throw std::runtime_error("Image does not support host copies (VK_EXT_host_image_copy, HOST_TRANSFER usage)");
+    }
+    const std::vector<VkImageLayout>& dst_layouts = deviceRef_->GetHostImageCopyDstLayouts();
+    if (std::find(dst_layouts.begin(), dst_layouts.end(), final_layout) == dst_layouts.end()) {
+        throw std::invalid_argument("Layout is not supported as a host image copy destination");
+    }
+
+    if (current_layout != final_layout) {
+        std::vector<VkHostImageLayoutTransitionInfoEXT> transitions;
+        transitions.reserve(regions.size());
+        for (const VkMemoryToImageCopyEXT& region : regions) {
+            VkHostImageLayoutTransitionInfoEXT transition{VK_STRUCTURE_TYPE_HOST_IMAGE_LAYOUT_TRANSITION_INFO_EXT};
+            transition.image = image_;
+            transition.oldLayout = current_layout;
+            transition.newLayout = final_layout;
+            transition.subresourceRange = {region.imageSubresource.aspectMask,
+                                           region.imageSubresource.mipLevel, 1,
+                                           region.imageSubresource.baseArrayLayer,
+                                           region.imageSubresource.layerCount};
+            transitions.push_back(transition);
+        }
+        if (vkTransitionImageLayoutEXT(device_, static_cast<uint32_t>(transitions.size()), transitions.data()) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to transition image layout on the host");
+        }
+    }
+
+    VkCopyMemoryToImageInfoEXT copy_info{VK_STRUCTURE_TYPE_COPY_MEMORY_TO_IMAGE_INFO_EXT};
+    copy_info.dstImage = image_;
+    copy_info.dstImageLayout = final_layout;
+    copy_info.regionCount = static_cast<uint32_t>(regions.size());
+    copy_info.pRegions = regions.data();
+    if (vkCopyMemoryToImageEXT(device_, &copy_info) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to copy host memory to image");
+    }
+
+    // Host writes are visible to work submitted afterwards; nothing is left to wait for
+    ResourceState state{};
+    state.layout = final_layout;
+    for (const VkMemoryToImageCopyEXT& region : regions) {
+        SetTrackedState(state, region.imageSubresource.mipLevel, 1,
+                        region.imageSubresource.baseArrayLayer, region.imageSubresource.layerCount);
+    }
+}
+
+void Image::CopyFromMemory(const void* data,
+                           uint32_t mip_level,
+                           VkImageLayout current_layout,
+                           VkImageLayout final_layout,
+                           VkImageAspectFlags aspect_flags)
+{
+    if (!data || mip_level >= mipLevels_) {
+        throw std::invalid_argument("CopyFromMemory requires data and an existing mip level");
+    }
+    VkMemoryToImageCopyEXT region{VK_STRUCTURE_TYPE_MEMORY_TO_IMAGE_COPY_EXT};
+    region.pHostPointer = data;
+    region.imageSubresource = {aspect_flags, mip_level, 0, arrayLayers_};
+    region.imageExtent = {std::max(1u, width_ >> mip_level),
+                          std::max(1u, height_ >> mip_level),
+                          std::max(1u, depth_ >> mip_level)};
+    CopyFromMemory(std::span<const VkMemoryToImageCopyEXT>(&region, 1), current_layout, final_layout);
+}
+
+bool Image::SupportsBlitMipmaps() const {
+    if (!deviceRef_) {
+        // Wrapped images carry no physical device to query; assume the caller knows
+        return true;
+    }
+    return Utils::FormatUtils::SupportsLinearBlit(deviceRef_->GetPhysicalDevice().GetFormatTable(), format_, tiling_);
+}
+
+void Image::GenerateMipmaps(const CommandBuffer& command_buffer,
+                            VkImageLayout base_layout,
+                            VkImageLayout final_layout,
+                            VkFilter filter) const
+{
+    if (filter == VK_FILTER_LINEAR && !SupportsBlitMipmaps()) {
+        throw std::runtime_error("Image format does not support linear blits; use the compute mipmap path");
+    }
+
+    const VkCommandBuffer cmd = command_buffer.GetHandle();
+    const VkImageAspectFlags aspect = Utils::ImageUtils::GetImageAspectFlags(format_);
+
+    // Level 0 becomes the first blit source, the rest become blit destinations
+    std::vector<VkImageMemoryBarrier> barriers;
+    barriers.reserve(2);
+    VkImageMemoryBarrier base = Utils::ImageUtils::CreateImageMemoryBarrier(
+        image_, base_layout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, aspect, 0, 1, 0, arrayLayers_);
+    base.srcAccessMask = Utils::ImageUtils::GetLayoutAccessFlags(base_layout);
+    base.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barriers.push_back(base);
+    if (mipLevels_ > 1) {
+        VkImageMemoryBarrier rest = Utils::ImageUtils::CreateImageMemoryBarrier(
+            image_, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, aspect, 1, mipLevels_ - 1, 0, arrayLayers_);
+        rest.srcAccessMask = 0;
+        rest.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barriers.push_back(rest);
+    }
+    vkCmdPipelineBarrier(cmd,
+                         Utils::ImageUtils::GetLayoutPipelineStageFlags(base_layout, true),
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 0, nullptr, 0, nullptr,
+                         static_cast<uint32_t>(barriers.size()), barriers.data());
+
+    int32_t mip_width = static_cast<int32_t>(width_);
+    int32_t mip_height = static_cast<int32_t>(height_);
+    int32_t mip_depth = static_cast<int32_t>(depth_);
+    for (uint32_t level = 1; level < mipLevels_; ++level) {
+        const int32_t next_width = std::max(mip_width / 2, 1);
+        const int32_t next_height = std::max(mip_height / 2, 1);
+        const int32_t next_depth = std::max(mip_depth / 2, 1);
+
+        VkImageBlit blit{};
+        blit.srcSubresource = Utils::ImageUtils::CreateSubresourceLayers(aspect, level - 1, 0, arrayLayers_);
+        blit.srcOffsets[1] = {mip_width, mip_height, mip_depth};
+        blit.dstSubresource = Utils::ImageUtils::CreateSubresourceLayers(aspect, level, 0, arrayLayers_);
+        blit.dstOffsets[1] = {next_width, next_height, next_depth};
+        vkCmdBlitImage(cmd,
+                       image_, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                       image_, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                       1, &blit, filter);
+
+        // The level just written becomes the next source; the last level stays a destination
+        if (level + 1 < mipLevels_) {
+            VkImageMemoryBarrier to_src = Utils::ImageUtils::CreateImageMemoryBarrier(
+                image_, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, aspect, level, 1, 0, arrayLayers_);
+            to_src.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            to_src.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            vkCmdPipelineBarrier(cmd,
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 0, 0, nullptr, 0, nullptr, 1, &to_src);
+        }
+
+        mip_width = next_width;
+        mip_height = next_height;
+        mip_depth = next_depth;
+    }
+
+    // Every level moves to its final layout in a single batched barrier
+    barriers.clear();
+    const uint32_t source_levels = mipLevels_ > 1 ? mipLevels_ - 1 : 1;
+    VkImageMemoryBarrier sources = Utils::ImageUtils::CreateImageMemoryBarrier(
+        image_, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, final_layout, aspect, 0, source_levels, 0, arrayLayers_);
+    sources.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    sources.dstAccessMask = Utils::ImageUtils::GetLayoutAccessFlags(final_layout);
+    barriers.push_back(sources);
+    if (mipLevels_ > 1) {
+        VkImageMemoryBarrier last = Utils::ImageUtils::CreateImageMemoryBarrier(
+            image_, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, final_layout, aspect, mipLevels_ - 1, 1, 0, arrayLayers_);
+        last.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        last.dstAccessMask = Utils::ImageUtils::GetLayoutAccessFlags(final_layout);
+        barriers.push_back(last);
+    }
+    vkCmdPipelineBarrier(cmd,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         Utils::ImageUtils::GetLayoutPipelineStageFlags(final_layout, false),
+                         0, 0, nullptr, 0, nullptr,
+                         static_cast<uint32_t>(barriers.size()), barriers.data());
+}
+
+void Image::GenerateMipmaps(const CommandBuffer& command_buffer,
+                            const MipmapComputePass& pass,
+                            VkImageLayout base_layout,
+                            VkImageLayout final_layout) const
+{
+    if (pass.pipeline == VK_NULL_HANDLE || pass.layout == VK_NULL_HANDLE || pass.descriptorSet == VK_NULL_HANDLE) {
+        throw std::invalid_argument("Compute mipmap pass requires a pipeline, layout and descriptor set");
+    }
+    if (usage_ != 0 && (usage_ & VK_IMAGE_USAGE_STORAGE_BIT) == 0) {
+        throw std::invalid_argument("Compute mipmap generation requires VK_IMAGE_USAGE_STORAGE_BIT");
+    }
+    if (imageType_ != VK_IMAGE_TYPE_2D) {
+        throw std::invalid_argument("Compute mipmap generation supports 2D images and arrays only");
+    }
+
+    const VkCommandBuffer cmd = command_buffer.GetHandle();
+    const VkImageAspectFlags aspect = Utils::ImageUtils::GetImageAspectFlags(format_);
+    const uint32_t tile_size = std::max(pass.tileSize, 2u);
+    // A workgroup cannot reduce its tile below one texel
+    const uint32_t max_mips_per_dispatch = std::max(1u, Utils::ImageUtils::CalculateMipLevels(tile_size, tile_size) - 1);
+    const uint32_t mips_per_dispatch = std::clamp(pass.mipsPerDispatch, 1u, max_mips_per_dispatch);
+
+    std::vector<VkImageMemoryBarrier> barriers;
+    barriers.reserve(2);
+    VkImageMemoryBarrier base = Utils::ImageUtils::CreateImageMemoryBarrier(
+        image_, base_layout, VK_IMAGE_LAYOUT_GENERAL, aspect, 0, 1, 0, arrayLayers_);
+    base.srcAccessMask = Utils::ImageUtils::GetLayoutAccessFlags(base_layout);
+    base.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    barriers.push_back(base);
+    if (mipLevels_ > 1) {
+        VkImageMemoryBarrier rest = Utils::ImageUtils::CreateImageMemoryBarrier(
+            image_, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, aspect, 1, mipLevels_ - 1, 0, arrayLayers_);
+        rest.srcAccessMask = 0;
+        rest.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barriers.push_back(rest);
+    }
+    vkCmdPipelineBarrier(cmd,
+                         Utils::ImageUtils::GetLayoutPipelineStageFlags(base_layout, true),
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 0, nullptr, 0, nullptr,
+                         static_cast<uint32_t>(barriers.size()), barriers.data());
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass.pipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass.layout, 0, 1, &pass.descriptorSet, 0, nullptr);
+
+    uint32_t src_mip = 0;
+    while (src_mip + 1 < mipLevels_) {
+        uint32_t src_width = 0;
+        uint32_t src_height = 0;
+        uint32_t src_depth = 0;
+        Utils::ImageUtils::GetMipLevelDimensions(width_, height_, 1, src_mip, src_width, src_height, src_depth);
+
+        MipmapPushConstants constants{};
+        constants.srcMip = src_mip;
+        constants.mipCount = std::min(mips_per_dispatch, mipLevels_ - 1 - src_mip);
+        constants.srcWidth = src_width;
+        constants.srcHeight = src_height;
+        constants.layerCount = arrayLayers_;
+        vkCmdPushConstants(cmd, pass.layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+        vkCmdDispatch(cmd,
+                      (src_width + tile_size - 1) / tile_size,
+                      (src_height + tile_size - 1) / tile_size,
+                      arrayLayers_);
+
+        src_mip += constants.mipCount;
+        if (src_mip + 1 < mipLevels_) {
+            // The last written level seeds the next dispatch
+            VkMemoryBarrier between{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+            between.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            between.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+            vkCmdPipelineBarrier(cmd,
+                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                 0, 1, &between, 0, nullptr, 0, nullptr);
+        }
+    }
+
+    VkImageMemoryBarrier to_final = Utils::ImageUtils::CreateImageMemoryBarrier(
+        image_, VK_IMAGE_LAYOUT_GENERAL, final_layout, aspect, 0, mipLevels_, 0, arrayLayers_);
+    to_final.srcAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    to_final.dstAccessMask = Utils::ImageUtils::GetLayoutAccessFlags(final_layout);
+    vkCmdPipelineBarrier(cmd,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         Utils::ImageUtils::GetLayoutPipelineStageFlags(final_layout, false),
+                         0, 0, nullptr, 0, nullptr, 1, &to_final);
+}
+
+void Image::SetDebugName(const char* name)
+{
+    if constexpr (!Utils::DEBUG_NAMES_ENABLED) {
+        return;
+    }
+    if (!name) {
+        return;
+    }
+    debugName_.Set(name);
+    Utils::SetObjectName(device_, VK_OBJECT_TYPE_IMAGE, image_, name);
+    if (usingVMA_ && allocation_ != VK_NULL_HANDLE) {
+        // MemoryStatistics::QueryNamedUsage reads it back
+        vmaSetAllocationName(vmaAllocator_, allocation_, name);
+    }
 }
 
 VkMemoryRequirements Image::GetMemoryRequirements() const {
@@ -301,18 +864,85 @@ VkMemoryRequirements Image::GetMemoryRequirements() const {
     return requirements;
 }
 
+std::vector<VkSparseImageMemoryRequirements> Image::GetSparseMemoryRequirements() const {
+    uint32_t count = 0;
+    vkGetImageSparseMemoryRequirements(device_, image_, &count, nullptr);
+    std::vector<VkSparseImageMemoryRequirements> requirements(count);
+    vkGetImageSparseMemoryRequirements(device_, image_, &count, requirements.data());
+    return requirements;
+}
+
+Image Image::CreateSparse(const Device& device,
+                          uint32_t width,
+                          uint32_t height,
+                          uint32_t mip_levels,
+                          uint32_t array_layers,
+                          VkFormat format,
+                          VkImageUsageFlags usage) {
+    VkImageCreateInfo image_info{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+    image_info.flags = VK_IMAGE_CREATE_SPARSE_BINDING_BIT | VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT;
+    image_info.imageType = VK_IMAGE_TYPE_2D;
+    image_info.extent = {width, height, 1};
+    image_info.mipLevels = mip_levels;
+    image_info.arrayLayers = array_layers;
+    image_info.format = format;
+    image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    image_info.usage = usage;
+    image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+    image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    return Image(device, image_info);
+}
+
+Image Image::CreateTransientAttachment(const VmaAllocator& allocator,
+                                       uint32_t width,
+                                       uint32_t height,
+                                       VkFormat format,
+                                       VkSampleCountFlagBits samples,
+                                       VkImageUsageFlags extra_usage,
+                                       uint32_t array_layers) {
+    if ((extra_usage & ~VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT) != 0) {
+        throw std::invalid_argument("Transient attachments may only add input attachment usage");
+    }
+
+    VkImageCreateInfo image_info{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+    image_info.imageType = VK_IMAGE_TYPE_2D;
+    image_info.extent = {width, height, 1};
+    image_info.mipLevels = 1;
+    image_info.arrayLayers = array_layers;
+    image_info.format = format;
+    image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    image_info.usage = VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | extra_usage |
+        (Utils::FormatUtils::IsDepthFormat(format) || Utils::FormatUtils::IsStencilFormat(format)
+             ? VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT
+             : VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT);
+    image_info.samples = samples;
+    image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    // VMA fails GPU_LAZILY_ALLOCATED outright when no memory type is lazily allocated
+    const Utils::MemoryTypeTable& memory_types = allocator.GetDeviceRef()->GetPhysicalDevice().GetMemoryTypeTable();
+    VmaAllocationCreateInfo allocation_info{};
+    allocation_info.usage = memory_types.GetMatchingTypes(VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) != 0
+        ? VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED
+        : VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+    return Image(allocator, image_info, allocation_info);
+}
+
 void Image::Cleanup()
 {
+    // Views go before the image they refer to
+    ReleaseViews();
     if (usingVMA_) {
         if (image_ != VK_NULL_HANDLE && vmaAllocator_ != VK_NULL_HANDLE) {
             vmaDestroyImage(vmaAllocator_, image_, allocation_);
         }
     } else if (ownsImage_) {
         if (image_ != VK_NULL_HANDLE) {
-            vkDestroyImage(device_, image_, nullptr);
+            vkDestroyImage(device_, image_, Utils::HostAllocator::For(VK_OBJECT_TYPE_IMAGE));
         }
         if (memory_ != VK_NULL_HANDLE) {
-            vkFreeMemory(device_, memory_, nullptr);
+            vkFreeMemory(device_, memory_, Utils::HostAllocator::For(VK_OBJECT_TYPE_DEVICE_MEMORY));
         }
     }
     image_ = VK_NULL_HANDLE;
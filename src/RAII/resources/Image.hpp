@@ -3,13 +3,46 @@
 
 #include <volk.h>
 #include <vk_mem_alloc.h>
+#include <atomic>
+#include <cstddef>
 #include <vector>
 #include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+
+#include "../sync/ResourceState.hpp"
+#include "../utils/DebugUtils.hpp"
 
 namespace VulkanEngine::RAII {
 
 class Device; // Forward declaration
 class VmaAllocator; // Forward declaration
+class MemoryPool; // Forward declaration
+class CommandBuffer; // Forward declaration
+class ImageView; // Forward declaration
+
+// Push constants handed to the compute downsample pipeline for every dispatch
+struct MipmapPushConstants {
+    uint32_t srcMip;
+    uint32_t mipCount;
+    uint32_t srcWidth;
+    uint32_t srcHeight;
+    uint32_t layerCount;
+};
+
+// Compute downsample path for formats without linear blit support. Each dispatch
+// reads srcMip and writes up to mipsPerDispatch following levels (single-pass
+// downsampling), so long mip chains of large texture arrays take few dispatches.
+// The descriptor set must bind every mip level as a storage image array in
+// VK_IMAGE_LAYOUT_GENERAL; the layout exposes MipmapPushConstants to the compute stage.
+struct MipmapComputePass {
+    VkPipeline pipeline{VK_NULL_HANDLE};
+    VkPipelineLayout layout{VK_NULL_HANDLE};
+    VkDescriptorSet descriptorSet{VK_NULL_HANDLE};
+    uint32_t mipsPerDispatch{6};
+    uint32_t tileSize{64}; // Source texels covered by one workgroup along x and y
+};
 
 class Image {
 public:
@@ -27,6 +60,27 @@ public:
           VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT,
           VmaMemoryUsage memory_usage = VMA_MEMORY_USAGE_AUTO);
 
+    // Constructor that creates an image inside a custom VMA pool
+    Image(const MemoryPool& pool,
+          uint32_t width,
+          uint32_t height,
+          uint32_t depth = 1,
+          uint32_t mip_levels = 1,
+          uint32_t array_layers = 1,
+          VkFormat format = VK_FORMAT_R8G8B8A8_SRGB,
+          VkImageType image_type = VK_IMAGE_TYPE_2D,
+          VkImageTiling tiling = VK_IMAGE_TILING_OPTIMAL,
+          VkImageUsageFlags usage = VK_IMAGE_USAGE_SAMPLED_BIT,
+          VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT);
+
+    // Constructor that creates an image with VMA from full create infos (pool, priority, ...)
+    Image(const VmaAllocator& allocator,
+          const VkImageCreateInfo& image_info,
+          const VmaAllocationCreateInfo& allocation_info);
+
+    // Constructor that creates an image without binding memory (sparse or externally bound images)
+    Image(const Device& device, const VkImageCreateInfo& image_info);
+
     // Constructor that creates an image with traditional Vulkan memory management
     Image(const Device& device,
           uint32_t width,
@@ -80,7 +134,17 @@ public:
     [[nodiscard]] VkImageUsageFlags GetUsage() const { return usage_; }
     [[nodiscard]] VkSampleCountFlagBits GetSamples() const { return samples_; }
 
-    // Create image view
+    // Check if the image is a transient attachment: its contents live only within a render
+    // pass, so tile-based GPUs can keep it in tile memory and back it lazily
+    [[nodiscard]] bool IsTransient() const { return (usage_ & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT) != 0; }
+
+    // Check if the image was created sparse resident (memory is bound page by page)
+    [[nodiscard]] bool IsSparse() const { return (createFlags_ & VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT) != 0; }
+
+    // Get the VMA allocation (VK_NULL_HANDLE for traditional or wrapped images)
+    [[nodiscard]] VmaAllocation GetAllocation() const { return allocation_; }
+
+    // Create image view; the caller owns it and must destroy it. Prefer GetView
     [[nodiscard]] VkImageView CreateImageView(VkImageViewType view_type = VK_IMAGE_VIEW_TYPE_2D,
                                VkImageAspectFlags aspect_flags = VK_IMAGE_ASPECT_COLOR_BIT,
                                uint32_t base_mip_level = 0,
@@ -88,6 +152,23 @@ public:
                                uint32_t base_array_layer = 0,
                                uint32_t layer_count = VK_REMAINING_ARRAY_LAYERS) const;
 
+    // Cached view of a subresource range: the same request returns the same view, created on
+    // first use and destroyed with the image (or when DefragmentationScheduler moves it).
+    // format VK_FORMAT_UNDEFINED uses the image's format. Thread-safe
+    [[nodiscard]] const ImageView& GetView(VkImageViewType view_type = VK_IMAGE_VIEW_TYPE_2D,
+                                           VkImageAspectFlags aspect_flags = VK_IMAGE_ASPECT_COLOR_BIT,
+                                           uint32_t base_mip_level = 0,
+                                           uint32_t level_count = VK_REMAINING_MIP_LEVELS,
+                                           uint32_t base_array_layer = 0,
+                                           uint32_t layer_count = VK_REMAINING_ARRAY_LAYERS,
+                                           VkFormat format = VK_FORMAT_UNDEFINED) const;
+
+    // Number of views GetView has created and still holds
+    [[nodiscard]] size_t GetCachedViewCount() const;
+
+    // Destroy the cached views; the GPU and descriptors must be done with them
+    void ReleaseViews();
+
     // Transition image layout
     void TransitionLayout(VkImageLayout old_layout,
                          VkImageLayout new_layout,
@@ -106,16 +187,114 @@ public:
     void CopyToBuffer(VkBuffer buffer,
                      const std::vector<VkBufferImageCopy>& regions);
 
-    // Generate mipmaps
-    void GenerateMipmaps(VkFilter filter = VK_FILTER_LINEAR);
+    // Record a copy to buffer (the image must be in src_layout when the command executes)
+    void CopyToBuffer(const CommandBuffer& command_buffer,
+                      VkBuffer buffer,
+                      const std::vector<VkBufferImageCopy>& regions,
+                      VkImageLayout src_layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL) const;
+
+    // Check if CopyFromMemory can be used: the device supports VK_EXT_host_image_copy, the
+    // image has VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT and its format supports host transfers
+    [[nodiscard]] bool SupportsHostCopy() const;
+
+    // Write texels straight from host memory on the calling thread (VK_EXT_host_image_copy),
+    // with no staging buffer, command buffer or queue round trip. The regions' subresources
+    // are transitioned on the host from current_layout (UNDEFINED discards their contents)
+    // to final_layout, which must be in Device::GetHostImageCopyDstLayouts(). The GPU must
+    // not be accessing those subresources
+    void CopyFromMemory(std::span<const VkMemoryToImageCopyEXT> regions,
+                        VkImageLayout current_layout = VK_IMAGE_LAYOUT_UNDEFINED,
+                        VkImageLayout final_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    // Write one whole mip level of every array layer from tightly packed host memory
+    void CopyFromMemory(const void* data,
+                        uint32_t mip_level = 0,
+                        VkImageLayout current_layout = VK_IMAGE_LAYOUT_UNDEFINED,
+                        VkImageLayout final_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                        VkImageAspectFlags aspect_flags = VK_IMAGE_ASPECT_COLOR_BIT);
+
+    // Check if mipmaps can be generated with linear blits for this image's format
+    [[nodiscard]] bool SupportsBlitMipmaps() const;
+
+    // Record mip generation by blitting every level from the previous one.
+    // Level 0 must be in base_layout; all levels end up in final_layout
+    void GenerateMipmaps(const CommandBuffer& command_buffer,
+                         VkImageLayout base_layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                         VkImageLayout final_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                         VkFilter filter = VK_FILTER_LINEAR) const;
+
+    // Record mip generation with a compute downsample pipeline (requires storage usage)
+    void GenerateMipmaps(const CommandBuffer& command_buffer,
+                         const MipmapComputePass& pass,
+                         VkImageLayout base_layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                         VkImageLayout final_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) const;
 
     // Get memory requirements
     [[nodiscard]] VkMemoryRequirements GetMemoryRequirements() const;
 
+    // Get sparse memory requirements (sparse images only)
+    [[nodiscard]] std::vector<VkSparseImageMemoryRequirements> GetSparseMemoryRequirements() const;
+
+    // Helper to create a sparse resident 2D image (array) for use with SparseResidencyManager
+    static Image CreateSparse(const Device& device,
+                              uint32_t width,
+                              uint32_t height,
+                              uint32_t mip_levels,
+                              uint32_t array_layers,
+                              VkFormat format,
+                              VkImageUsageFlags usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+
+    // Helper to create a transient color or depth/stencil attachment (depth, MSAA or G-buffer
+    // targets that are never read after their render pass). The memory is lazily allocated
+    // where the device has such a memory type (tile-based GPUs), device local otherwise.
+    // extra_usage may only add VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT. Render with
+    // RenderPass::CreateAttachment / CreateRenderingAttachment so nothing is stored
+    static Image CreateTransientAttachment(const VmaAllocator& allocator,
+                                           uint32_t width,
+                                           uint32_t height,
+                                           VkFormat format,
+                                           VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT,
+                                           VkImageUsageFlags extra_usage = 0,
+                                           uint32_t array_layers = 1);
+
     // Get device memory (for traditional Vulkan)
     [[nodiscard]] VkDeviceMemory GetMemory() const { return memory_; }
 
+    // Set debug name (for debugging and memory statistics). Compiled out with VULKAN_RAII_DEBUG_NAMES=0
+    void SetDebugName(const char* name);
+
+    // Get debug name; empty when names are compiled out
+    [[nodiscard]] const char* GetDebugName() const { return debugName_.Get(); }
+
+    // Synchronization state of one mip level and array layer, as left by the
+    // commands recorded through a BarrierBatcher (UNDEFINED and unused until then)
+    [[nodiscard]] const ResourceState& GetTrackedState(uint32_t mip_level, uint32_t array_layer) const;
+
+    // Overwrite the tracked state, e.g. after barriers recorded outside a BarrierBatcher or on another queue
+    void SetTrackedState(const ResourceState& state,
+                         uint32_t base_mip_level = 0,
+                         uint32_t level_count = VK_REMAINING_MIP_LEVELS,
+                         uint32_t base_array_layer = 0,
+                         uint32_t layer_count = VK_REMAINING_ARRAY_LAYERS);
+
+    // Queue family ownership transfer (see OwnershipTransfer) of the whole image or a range,
+    // with the layout change from sourceAccess.layout to destinationAccess.layout, so the
+    // image can stay exclusive (and compressed) while e.g. uploads run on the transfer queue.
+    // Record the release on transfer.srcFamily and the acquire on transfer.dstFamily; within
+    // one family the release records nothing and the acquire is a plain barrier
+    void ReleaseOwnership(const CommandBuffer& command_buffer, const OwnershipTransfer& transfer) const;
+    void ReleaseOwnership(const CommandBuffer& command_buffer,
+                          const OwnershipTransfer& transfer,
+                          const VkImageSubresourceRange& range) const;
+    void AcquireOwnership(const CommandBuffer& command_buffer, const OwnershipTransfer& transfer);
+    void AcquireOwnership(const CommandBuffer& command_buffer,
+                          const OwnershipTransfer& transfer,
+                          const VkImageSubresourceRange& range);
+
 private:
+    // Re-points the handle once a defragmentation move of the allocation completes
+    friend class DefragmentationScheduler;
+
     VkImage image_{VK_NULL_HANDLE};
     uint32_t width_{0};
     uint32_t height_{0};
@@ -127,6 +306,7 @@ private:
     VkImageTiling tiling_{VK_IMAGE_TILING_OPTIMAL};
     VkImageUsageFlags usage_{0};
     VkSampleCountFlagBits samples_{VK_SAMPLE_COUNT_1_BIT};
+    VkImageCreateFlags createFlags_{0};
 
     // VMA allocation
       ::VmaAllocator vmaAllocator_{VK_NULL_HANDLE};
@@ -141,8 +321,18 @@ private:
 
     bool usingVMA_{false};
     bool ownsImage_{true}; // Whether we created the image or just wrap it
+    [[no_unique_address]] Utils::DebugName debugName_; // Empty type when names are compiled out
+    std::vector<ResourceState> trackedStates_; // mipLevels_ * arrayLayers_, layer major; empty until first tracked
+
+    struct ViewCache; // Defined in Image.cpp
+
+    // Created by the first GetView, so images that never need a view pay nothing for it
+    mutable std::atomic<ViewCache*> viewCache_{nullptr};
 
     // Helper methods
+    ViewCache& GetViewCache() const;
+    // Hand the cached views over (to DefragmentationScheduler); the next GetView starts a new cache
+    std::shared_ptr<void> DetachViews();
     void CreateImage();
     void AllocateMemory(VkMemoryPropertyFlags properties);
     void Cleanup();
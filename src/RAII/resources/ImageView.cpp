@@ -0,0 +1,70 @@
+#include "ImageView.hpp"
+
+#include "../core/Device.hpp"
+#include "../utils/HostAllocator.hpp"
+#include <cstdint>
+#include <stdexcept>
+
+
+namespace VulkanEngine::RAII {
+
+ImageView::ImageView(const Device& device, const VkImageViewCreateInfo& create_info)
+    : ImageView(device.GetHandle(), create_info)
+{
+}
+
+ImageView::ImageView(VkDevice device, const VkImageViewCreateInfo& create_info)
+    : device_(device),
+    image_(create_info.image),
+    viewType_(create_info.viewType),
+    format_(create_info.format),
+    subresourceRange_(create_info.subresourceRange)
+{
+    CreateImageView(create_info);
+}
+
+ImageView::~ImageView() {
+    Cleanup();
+}
+
+ImageView::ImageView(ImageView&& other) noexcept
+    : imageView_(other.imageView_),
+    device_(other.device_),
+    image_(other.image_),
+    viewType_(other.viewType_),
+    format_(other.format_),
+    subresourceRange_(other.subresourceRange_)
+{
+    other.imageView_ = VK_NULL_HANDLE;
+    other.device_ = VK_NULL_HANDLE;
+}
+
+ImageView& ImageView::operator=(ImageView&& other) noexcept {
+    if (this != &other) {
+        Cleanup();
+        imageView_ = other.imageView_;
+        device_ = other.device_;
+        image_ = other.image_;
+        viewType_ = other.viewType_;
+        format_ = other.format_;
+        subresourceRange_ = other.subresourceRange_;
+        other.imageView_ = VK_NULL_HANDLE;
+        other.device_ = VK_NULL_HANDLE;
+    }
+    return *this;
+}
+
+void ImageView::CreateImageView(const VkImageViewCreateInfo& create_info) {
+    if (vkCreateImageView(device_, &create_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_IMAGE_VIEW), &imageView_) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create image view");
+    }
+}
+
+void ImageView::Cleanup() {
+    if (imageView_ != VK_NULL_HANDLE && device_ != VK_NULL_HANDLE) {
+        vkDestroyImageView(device_, imageView_, Utils::HostAllocator::For(VK_OBJECT_TYPE_IMAGE_VIEW));
+    }
+    imageView_ = VK_NULL_HANDLE;
+}
+
+} // namespace VulkanEngine::RAII
@@ -0,0 +1,62 @@
+#ifndef VULKAN_RAII_RESOURCES_IMAGE_VIEW_HPP
+#define VULKAN_RAII_RESOURCES_IMAGE_VIEW_HPP
+
+#include <volk.h>
+
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+
+class ImageView {
+public:
+    // Constructor that creates a view from a full create info
+    ImageView(const Device& device, const VkImageViewCreateInfo& create_info);
+
+    // Constructor for owners that only keep the VkDevice (Image's view cache)
+    ImageView(VkDevice device, const VkImageViewCreateInfo& create_info);
+
+    // Destructor
+    ~ImageView();
+
+    // Move constructor and assignment
+    ImageView(ImageView&& other) noexcept;
+    ImageView& operator=(ImageView&& other) noexcept;
+
+    // Delete copy constructor and assignment. this ensures unique ownership of the VkImageView by only allowing moving.
+    ImageView(const ImageView&) = delete;
+    ImageView& operator=(const ImageView&) = delete;
+
+    [[nodiscard]] VkImageView GetHandle() const { return imageView_; }
+
+    // Implicit conversion to VkImageView
+    operator VkImageView() const { return imageView_; }
+
+    // Check if the image view is valid
+    [[nodiscard]] bool IsValid() const { return imageView_ != VK_NULL_HANDLE; }
+
+    // Get view properties
+    [[nodiscard]] VkImage GetImage() const { return image_; }
+    [[nodiscard]] VkImageViewType GetViewType() const { return viewType_; }
+    [[nodiscard]] VkFormat GetFormat() const { return format_; }
+    [[nodiscard]] const VkImageSubresourceRange& GetSubresourceRange() const { return subresourceRange_; }
+
+private:
+    VkImageView imageView_{VK_NULL_HANDLE};
+    VkDevice device_{VK_NULL_HANDLE}; // Reference to device
+
+    // Cached properties for query functions
+    VkImage image_{VK_NULL_HANDLE};
+    VkImageViewType viewType_{VK_IMAGE_VIEW_TYPE_2D};
+    VkFormat format_{VK_FORMAT_UNDEFINED};
+    VkImageSubresourceRange subresourceRange_{};
+
+    // Helper methods
+    void CreateImageView(const VkImageViewCreateInfo& create_info);
+    void Cleanup();
+};
+
+} // namespace VulkanEngine::RAII
+
+
+#endif // VULKAN_RAII_RESOURCES_IMAGE_VIEW_HPP
@@ -0,0 +1,223 @@
+#include "Ktx2File.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace VulkanEngine::RAII {
+
+namespace {
+constexpr std::byte IDENTIFIER[12] = {
+    std::byte{0xAB}, std::byte{0x4B}, std::byte{0x54}, std::byte{0x58}, std::byte{0x20}, std::byte{0x32},
+    std::byte{0x30}, std::byte{0xBB}, std::byte{0x0D}, std::byte{0x0A}, std::byte{0x1A}, std::byte{0x0A}};
+constexpr size_t HEADER_SIZE = 80; // Identifier, header and index, up to the level index
+constexpr size_t LEVEL_INDEX_ENTRY_SIZE = 24;
+constexpr uint8_t TRANSFER_FUNCTION_SRGB = 2; // KHR_DF_TRANSFER_SRGB
+
+// KTX2 is little endian, like every platform Vulkan runs on
+template <typename T>
+T ReadValue(const std::byte* data, size_t offset) {
+    T value{};
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+
+// Written so that neither side can wrap around, whatever the file claims
+bool InBounds(uint64_t offset, uint64_t length, size_t size) {
+    return offset <= size && length <= size - offset;
+}
+} // namespace
+
+Ktx2File::Ktx2File(const std::string& path)
+    : path_(path) {
+    Map();
+    try {
+        Parse();
+    } catch (...) {
+        Unmap();
+        throw;
+    }
+}
+
+Ktx2File::~Ktx2File() {
+    Unmap();
+}
+
+Ktx2File::Ktx2File(Ktx2File&& other) noexcept
+    : path_(std::move(other.path_)),
+    data_(std::exchange(other.data_, nullptr)),
+    size_(std::exchange(other.size_, 0)),
+#ifdef _WIN32
+    fileHandle_(std::exchange(other.fileHandle_, nullptr)),
+    mappingHandle_(std::exchange(other.mappingHandle_, nullptr)),
+#endif
+    format_(other.format_),
+    width_(other.width_),
+    height_(other.height_),
+    depth_(other.depth_),
+    layerCount_(other.layerCount_),
+    faceCount_(other.faceCount_),
+    supercompression_(other.supercompression_),
+    colorModel_(other.colorModel_),
+    srgb_(other.srgb_),
+    sgdByteOffset_(other.sgdByteOffset_),
+    sgdByteLength_(other.sgdByteLength_),
+    levels_(std::move(other.levels_)) {}
+
+Ktx2File& Ktx2File::operator=(Ktx2File&& other) noexcept {
+    if (this != &other) {
+        Unmap();
+        path_ = std::move(other.path_);
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+#ifdef _WIN32
+        fileHandle_ = std::exchange(other.fileHandle_, nullptr);
+        mappingHandle_ = std::exchange(other.mappingHandle_, nullptr);
+#endif
+        format_ = other.format_;
+        width_ = other.width_;
+        height_ = other.height_;
+        depth_ = other.depth_;
+        layerCount_ = other.layerCount_;
+        faceCount_ = other.faceCount_;
+        supercompression_ = other.supercompression_;
+        colorModel_ = other.colorModel_;
+        srgb_ = other.srgb_;
+        sgdByteOffset_ = other.sgdByteOffset_;
+        sgdByteLength_ = other.sgdByteLength_;
+        levels_ = std::move(other.levels_);
+    }
+    return *this;
+}
+
+std::span<const std::byte> Ktx2File::GetLevelData(uint32_t level) const {
+    const Level& entry = levels_[level];
+    return {data_ + entry.byteOffset, static_cast<size_t>(entry.byteLength)};
+}
+
+std::span<const std::byte> Ktx2File::GetSupercompressionGlobalData() const {
+    return {data_ + sgdByteOffset_, static_cast<size_t>(sgdByteLength_)};
+}
+
+void Ktx2File::Map() {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path_.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to open KTX2 file: " + path_);
+    }
+    LARGE_INTEGER file_size{};
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file);
+        throw std::runtime_error("Failed to read the size of KTX2 file: " + path_);
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (view == nullptr) {
+        if (mapping != nullptr) {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        throw std::runtime_error("Failed to map KTX2 file: " + path_);
+    }
+    fileHandle_ = file;
+    mappingHandle_ = mapping;
+    data_ = static_cast<const std::byte*>(view);
+    size_ = static_cast<size_t>(file_size.QuadPart);
+#else
+    const int fd = open(path_.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open KTX2 file: " + path_);
+    }
+    struct stat file_stat{};
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+        close(fd);
+        throw std::runtime_error("Failed to read the size of KTX2 file: " + path_);
+    }
+    void* view = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping keeps the file referenced
+    if (view == MAP_FAILED) {
+        throw std::runtime_error("Failed to map KTX2 file: " + path_);
+    }
+    data_ = static_cast<const std::byte*>(view);
+    size_ = static_cast<size_t>(file_stat.st_size);
+#endif
+}
+
+void Ktx2File::Unmap() {
+    if (data_ == nullptr) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+    CloseHandle(static_cast<HANDLE>(mappingHandle_));
+    CloseHandle(static_cast<HANDLE>(fileHandle_));
+    mappingHandle_ = nullptr;
+    fileHandle_ = nullptr;
+#else
+    munmap(const_cast<std::byte*>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+void Ktx2File::Parse() {
+    if (size_ < HEADER_SIZE || std::memcmp(data_, IDENTIFIER, sizeof(IDENTIFIER)) != 0) {
+        throw std::runtime_error("Not a KTX2 file: " + path_);
+    }
+
+    format_ = static_cast<VkFormat>(ReadValue<uint32_t>(data_, 12));
+    width_ = ReadValue<uint32_t>(data_, 20);
+    height_ = std::max(ReadValue<uint32_t>(data_, 24), 1u);
+    depth_ = std::max(ReadValue<uint32_t>(data_, 28), 1u);
+    layerCount_ = std::max(ReadValue<uint32_t>(data_, 32), 1u);
+    faceCount_ = ReadValue<uint32_t>(data_, 36);
+    // 0 asks the loader to generate mips; the file then still holds level 0
+    const uint32_t level_count = std::max(ReadValue<uint32_t>(data_, 40), 1u);
+    supercompression_ = static_cast<Supercompression>(ReadValue<uint32_t>(data_, 44));
+    const uint32_t dfd_offset = ReadValue<uint32_t>(data_, 48);
+    const uint32_t dfd_length = ReadValue<uint32_t>(data_, 52);
+    sgdByteOffset_ = ReadValue<uint64_t>(data_, 64);
+    sgdByteLength_ = ReadValue<uint64_t>(data_, 72);
+
+    if (width_ == 0 || (faceCount_ != 1 && faceCount_ != 6)) {
+        throw std::runtime_error("Unsupported KTX2 dimensions in " + path_);
+    }
+    if (level_count > (size_ - HEADER_SIZE) / LEVEL_INDEX_ENTRY_SIZE ||
+        !InBounds(sgdByteOffset_, sgdByteLength_, size_)) {
+        throw std::runtime_error("Truncated KTX2 file: " + path_);
+    }
+
+    levels_.resize(level_count);
+    for (uint32_t level = 0; level < level_count; ++level) {
+        const size_t entry = HEADER_SIZE + static_cast<size_t>(level) * LEVEL_INDEX_ENTRY_SIZE;
+        levels_[level].byteOffset = ReadValue<uint64_t>(data_, entry);
+        levels_[level].byteLength = ReadValue<uint64_t>(data_, entry + 8);
+        levels_[level].uncompressedByteLength = ReadValue<uint64_t>(data_, entry + 16);
+        if (!InBounds(levels_[level].byteOffset, levels_[level].byteLength, size_)) {
+            throw std::runtime_error("Truncated KTX2 level data in " + path_);
+        }
+    }
+
+    // Basic data format descriptor block: total size, two header words, then the color
+    // model, primaries and transfer function bytes
+    if (dfd_length >= 16 && InBounds(dfd_offset, dfd_length, size_)) {
+        colorModel_ = ReadValue<uint8_t>(data_, dfd_offset + 12);
+        srgb_ = ReadValue<uint8_t>(data_, dfd_offset + 14) == TRANSFER_FUNCTION_SRGB;
+    }
+}
+
+} // namespace VulkanEngine::RAII
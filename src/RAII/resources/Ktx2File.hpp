@@ -0,0 +1,98 @@
+#ifndef VULKAN_RAII_RESOURCES_KTX2_FILE_HPP
+#define VULKAN_RAII_RESOURCES_KTX2_FILE_HPP
+
+#include <volk.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace VulkanEngine::RAII {
+
+// Read-only, memory-mapped KTX2 container. Level data is handed out as views into the
+// mapping, so streaming it into staging memory is a single copy. Throws
+// std::runtime_error when the file cannot be mapped or is not a valid KTX2 file
+class Ktx2File {
+public:
+    enum class Supercompression : uint32_t {
+        NONE = 0,
+        BASIS_LZ = 1,
+        ZSTD = 2,
+        ZLIB = 3
+    };
+
+    // Data format descriptor color models of Basis Universal payloads
+    static constexpr uint8_t COLOR_MODEL_ETC1S = 163;
+    static constexpr uint8_t COLOR_MODEL_UASTC = 166;
+
+    struct Level {
+        uint64_t byteOffset{0};
+        uint64_t byteLength{0};
+        uint64_t uncompressedByteLength{0};
+    };
+
+    explicit Ktx2File(const std::string& path);
+    ~Ktx2File();
+
+    Ktx2File(Ktx2File&& other) noexcept;
+    Ktx2File& operator=(Ktx2File&& other) noexcept;
+
+    Ktx2File(const Ktx2File&) = delete;
+    Ktx2File& operator=(const Ktx2File&) = delete;
+
+    // VK_FORMAT_UNDEFINED for Basis Universal payloads, which must be transcoded
+    [[nodiscard]] VkFormat GetFormat() const { return format_; }
+    [[nodiscard]] uint32_t GetWidth() const { return width_; }
+    [[nodiscard]] uint32_t GetHeight() const { return height_; }
+    [[nodiscard]] uint32_t GetDepth() const { return depth_; }
+    [[nodiscard]] uint32_t GetLayerCount() const { return layerCount_; }
+    [[nodiscard]] uint32_t GetFaceCount() const { return faceCount_; }
+    [[nodiscard]] uint32_t GetLevelCount() const { return static_cast<uint32_t>(levels_.size()); }
+    [[nodiscard]] Supercompression GetSupercompression() const { return supercompression_; }
+
+    [[nodiscard]] uint8_t GetColorModel() const { return colorModel_; }
+    [[nodiscard]] bool IsBasisUniversal() const { return colorModel_ == COLOR_MODEL_ETC1S || colorModel_ == COLOR_MODEL_UASTC; }
+    [[nodiscard]] bool IsSrgb() const { return srgb_; }
+
+    [[nodiscard]] const Level& GetLevel(uint32_t level) const { return levels_[level]; }
+
+    // Stored (possibly supercompressed) bytes of a level: every layer, face and slice
+    [[nodiscard]] std::span<const std::byte> GetLevelData(uint32_t level) const;
+
+    // Supercompression global data (BasisLZ codebooks); empty for other schemes
+    [[nodiscard]] std::span<const std::byte> GetSupercompressionGlobalData() const;
+
+    [[nodiscard]] const std::string& GetPath() const { return path_; }
+
+private:
+    std::string path_;
+    const std::byte* data_{nullptr};
+    size_t size_{0};
+#ifdef _WIN32
+    void* fileHandle_{nullptr};
+    void* mappingHandle_{nullptr};
+#endif
+
+    VkFormat format_{VK_FORMAT_UNDEFINED};
+    uint32_t width_{0};
+    uint32_t height_{1};
+    uint32_t depth_{1};
+    uint32_t layerCount_{1};
+    uint32_t faceCount_{1};
+    Supercompression supercompression_{Supercompression::NONE};
+    uint8_t colorModel_{0};
+    bool srgb_{false};
+    uint64_t sgdByteOffset_{0};
+    uint64_t sgdByteLength_{0};
+    std::vector<Level> levels_;
+
+    void Map();
+    void Unmap();
+    void Parse();
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RESOURCES_KTX2_FILE_HPP
@@ -0,0 +1,285 @@
+#include "MemoryBudgetManager.hpp"
+
+#include "VmaAllocator.hpp"
+#include "../rendering/Renderer.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+
+namespace VulkanEngine::RAII {
+
+MemoryBudgetManager::MemoryBudgetManager(const VmaAllocator& allocator, float budget_fraction)
+    : allocator_(&allocator),
+    budgetFraction_(std::clamp(budget_fraction, 0.1f, 1.0f))
+{
+    const VkPhysicalDeviceMemoryProperties* properties = nullptr;
+    vmaGetMemoryProperties(allocator.GetHandle(), &properties);
+
+    heapCount_ = properties->memoryHeapCount;
+    heapDeviceLocal_.resize(heapCount_);
+    for (uint32_t i = 0; i < heapCount_; ++i) {
+        heapDeviceLocal_[i] = (properties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+    }
+    memoryTypeHeaps_.resize(properties->memoryTypeCount);
+    for (uint32_t i = 0; i < properties->memoryTypeCount; ++i) {
+        memoryTypeHeaps_[i] = properties->memoryTypes[i].heapIndex;
+    }
+}
+
+MemoryBudgetManager::~MemoryBudgetManager()
+{
+    Detach();
+}
+
+uint32_t MemoryBudgetManager::RegisterEvictable(VmaAllocation allocation, float priority, EvictionCallback on_evict)
+{
+    if (allocation == VK_NULL_HANDLE || !on_evict) {
+        throw std::invalid_argument("Evictable allocations require an allocation and an eviction callback");
+    }
+
+    VmaAllocationInfo info{};
+    allocator_->GetAllocationInfo(allocation, info);
+
+    Evictable entry{};
+    entry.id = nextId_++;
+    entry.allocation = allocation;
+    entry.heapIndex = memoryTypeHeaps_[info.memoryType];
+    entry.size = info.size;
+    entry.priority = std::clamp(priority, 0.0f, 1.0f);
+    entry.lastUsedFrame = frameNumber_;
+    entry.onEvict = std::move(on_evict);
+    evictables_.push_back(std::move(entry));
+    return evictables_.back().id;
+}
+
+void MemoryBudgetManager::Unregister(uint32_t id)
+{
+    std::erase_if(evictables_, [id](const Evictable& entry) { return entry.id == id; });
+}
+
+void MemoryBudgetManager::Touch(uint32_t id)
+{
+    for (Evictable& entry : evictables_) {
+        if (entry.id == id) {
+            entry.lastUsedFrame = frameNumber_;
+            return;
+        }
+    }
+}
+
+bool MemoryBudgetManager::MakeRoom(uint32_t heap_index, VkDeviceSize bytes)
+{
+    if (heap_index >= heapCount_) {
+        throw std::out_of_range("Memory heap index out of range");
+    }
+
+    ::VmaBudget budgets[VK_MAX_MEMORY_HEAPS]{};
+    allocator_->GetHeapBudgets(budgets);
+    const VkDeviceSize limit = GetHeapLimit(budgets[heap_index]);
+    const VkDeviceSize usage = budgets[heap_index].usage;
+    if (usage + bytes <= limit) {
+        return true;
+    }
+
+    const VkDeviceSize needed = usage + bytes - limit;
+    return Evict(heap_index, needed, std::numeric_limits<float>::max()) >= needed;
+}
+
+Buffer MemoryBudgetManager::CreateBuffer(VkDeviceSize size,
+                                         VkBufferUsageFlags usage,
+                                         float priority,
+                                         VmaAllocationCreateFlags flags,
+                                         const char* name)
+{
+    VkBufferCreateInfo buffer_info{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    buffer_info.size = size;
+    buffer_info.usage = usage;
+    buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo alloc_info{};
+    alloc_info.usage = VMA_MEMORY_USAGE_AUTO;
+    alloc_info.flags = flags;
+    alloc_info.priority = std::clamp(priority, 0.0f, 1.0f);
+
+    const uint32_t heap_index = GetBufferHeap(buffer_info, alloc_info);
+    (void)MakeRoom(heap_index, size);
+    try {
+        return Buffer(*allocator_, size, usage, alloc_info, name);
+    } catch (const std::runtime_error&) {
+        // Budget numbers lag behind the driver; free lower priorities and retry
+    }
+
+    if (Evict(heap_index, size, alloc_info.priority) > 0) {
+        try {
+            return Buffer(*allocator_, size, usage, alloc_info, name);
+        } catch (const std::runtime_error&) {
+        }
+    }
+
+    std::cerr << "[MemoryBudgetManager] Heap " << heap_index << " exhausted, placing "
+              << size << " byte buffer in host memory\n";
+    alloc_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+    return Buffer(*allocator_, size, usage, alloc_info, name);
+}
+
+Image MemoryBudgetManager::CreateImage(const VkImageCreateInfo& image_info, float priority)
+{
+    VmaAllocationCreateInfo alloc_info{};
+    alloc_info.usage = VMA_MEMORY_USAGE_AUTO;
+    alloc_info.priority = std::clamp(priority, 0.0f, 1.0f);
+
+    const uint32_t heap_index = GetImageHeap(image_info, alloc_info);
+
+    // Estimate from the memory requirements of an equivalent image
+    VkDeviceSize size = 0;
+    VkDeviceImageMemoryRequirements requirements_info{VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS};
+    requirements_info.pCreateInfo = &image_info;
+    VkMemoryRequirements2 requirements{VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2};
+    if (vkGetDeviceImageMemoryRequirements) {
+        vkGetDeviceImageMemoryRequirements(allocator_->GetDevice(), &requirements_info, &requirements);
+        size = requirements.memoryRequirements.size;
+    }
+
+    (void)MakeRoom(heap_index, size);
+    try {
+        return Image(*allocator_, image_info, alloc_info);
+    } catch (const std::runtime_error&) {
+        // Budget numbers lag behind the driver; free lower priorities and retry
+    }
+
+    if (Evict(heap_index, std::max<VkDeviceSize>(size, 1), alloc_info.priority) > 0) {
+        try {
+            return Image(*allocator_, image_info, alloc_info);
+        } catch (const std::runtime_error&) {
+        }
+    }
+
+    std::cerr << "[MemoryBudgetManager] Heap " << heap_index << " exhausted, placing image in host memory\n";
+    alloc_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+    return Image(*allocator_, image_info, alloc_info);
+}
+
+void MemoryBudgetManager::Update(uint64_t frame_number)
+{
+    frameNumber_ = frame_number;
+    // Lets VMA refresh its cached budget from the driver
+    vmaSetCurrentFrameIndex(allocator_->GetHandle(), static_cast<uint32_t>(frame_number));
+
+    ::VmaBudget budgets[VK_MAX_MEMORY_HEAPS]{};
+    allocator_->GetHeapBudgets(budgets);
+    for (uint32_t heap = 0; heap < heapCount_; ++heap) {
+        const VkDeviceSize limit = GetHeapLimit(budgets[heap]);
+        if (budgets[heap].usage > limit) {
+            (void)Evict(heap, budgets[heap].usage - limit, std::numeric_limits<float>::max());
+        }
+    }
+}
+
+void MemoryBudgetManager::AttachToRenderer(Renderer& renderer)
+{
+    Detach();
+    renderer_ = &renderer;
+    frameBeginSubscription_ = renderer.SubscribeFrameBegin([this](uint32_t /*frame_index*/) {
+        Update(renderer_->GetTotalFrameCount());
+    });
+}
+
+void MemoryBudgetManager::Detach()
+{
+    frameBeginSubscription_.Reset();
+    renderer_ = nullptr;
+}
+
+MemoryBudgetManager::HeapStatus MemoryBudgetManager::GetHeapStatus(uint32_t heap_index) const
+{
+    if (heap_index >= heapCount_) {
+        throw std::out_of_range("Memory heap index out of range");
+    }
+
+    ::VmaBudget budgets[VK_MAX_MEMORY_HEAPS]{};
+    allocator_->GetHeapBudgets(budgets);
+
+    HeapStatus status{};
+    status.budget = budgets[heap_index].budget;
+    status.usage = budgets[heap_index].usage;
+    status.deviceLocal = heapDeviceLocal_[heap_index];
+    for (const Evictable& entry : evictables_) {
+        if (entry.heapIndex == heap_index) {
+            status.evictableBytes += entry.size;
+        }
+    }
+    return status;
+}
+
+VkDeviceSize MemoryBudgetManager::GetHeapLimit(const ::VmaBudget& budget) const
+{
+    return static_cast<VkDeviceSize>(static_cast<double>(budget.budget) * budgetFraction_);
+}
+
+VkDeviceSize MemoryBudgetManager::Evict(uint32_t heap_index, VkDeviceSize bytes, float max_priority)
+{
+    // Lowest priority first, least recently used among equals; never what this frame touched
+    std::vector<const Evictable*> candidates;
+    for (const Evictable& entry : evictables_) {
+        if (entry.heapIndex == heap_index && entry.priority < max_priority && entry.lastUsedFrame != frameNumber_) {
+            candidates.push_back(&entry);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Evictable* a, const Evictable* b) {
+        if (a->priority != b->priority) {
+            return a->priority < b->priority;
+        }
+        return a->lastUsedFrame < b->lastUsedFrame;
+    });
+
+    std::vector<uint32_t> victims;
+    VkDeviceSize freed = 0;
+    for (const Evictable* entry : candidates) {
+        if (freed >= bytes) {
+            break;
+        }
+        victims.push_back(entry->id);
+        freed += entry->size;
+    }
+
+    for (uint32_t id : victims) {
+        auto it = std::find_if(evictables_.begin(), evictables_.end(), [id](const Evictable& entry) {
+            return entry.id == id;
+        });
+        if (it == evictables_.end()) {
+            continue; // Unregistered by an earlier callback
+        }
+        EvictionCallback on_evict = std::move(it->onEvict);
+        evictables_.erase(it);
+        ++evictionCount_;
+        on_evict();
+    }
+    return freed;
+}
+
+uint32_t MemoryBudgetManager::GetBufferHeap(const VkBufferCreateInfo& buffer_info,
+                                            const VmaAllocationCreateInfo& allocation_info) const
+{
+    uint32_t memory_type_index = 0;
+    if (allocator_->FindMemoryTypeIndexForBufferInfo(buffer_info, allocation_info, memory_type_index) != VK_SUCCESS) {
+        return 0;
+    }
+    return memoryTypeHeaps_[memory_type_index];
+}
+
+uint32_t MemoryBudgetManager::GetImageHeap(const VkImageCreateInfo& image_info,
+                                           const VmaAllocationCreateInfo& allocation_info) const
+{
+    uint32_t memory_type_index = 0;
+    if (allocator_->FindMemoryTypeIndexForImageInfo(image_info, allocation_info, memory_type_index) != VK_SUCCESS) {
+        return 0;
+    }
+    return memoryTypeHeaps_[memory_type_index];
+}
+
+} // namespace VulkanEngine::RAII
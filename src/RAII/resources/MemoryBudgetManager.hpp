@@ -0,0 +1,117 @@
+#ifndef VULKAN_RAII_RESOURCES_MEMORY_BUDGET_MANAGER_HPP
+#define VULKAN_RAII_RESOURCES_MEMORY_BUDGET_MANAGER_HPP
+
+#include <volk.h>
+#include <vk_mem_alloc.h>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "../rendering/FrameBeginSubscription.hpp"
+#include "Buffer.hpp"
+#include "Image.hpp"
+
+namespace VulkanEngine::RAII {
+
+class VmaAllocator; // Forward declaration
+class Renderer; // Forward declaration
+
+// Tracks per-heap usage against the VK_EXT_memory_budget numbers reported by
+// VMA and evicts application resources before a heap overflows. Evictable
+// allocations carry a priority (forwarded to VK_EXT_memory_priority); the lowest
+// priority, least recently used ones are dropped first through their callbacks.
+// The allocator should be created with VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT
+// and VMA_ALLOCATOR_CREATE_EXT_MEMORY_PRIORITY_BIT for accurate numbers and priorities.
+// Not thread-safe: allocate and evict from one thread or guard externally.
+class MemoryBudgetManager {
+public:
+    // Invoked when a resource is chosen for eviction. It must release the resource
+    // (immediately or once the GPU is done with it); the registration is already removed
+    using EvictionCallback = std::function<void()>;
+
+    struct HeapStatus {
+        VkDeviceSize budget{0};
+        VkDeviceSize usage{0};
+        VkDeviceSize evictableBytes{0};
+        bool deviceLocal{false};
+    };
+
+    // Constructor. budget_fraction is the share of each heap budget allocations may fill
+    explicit MemoryBudgetManager(const VmaAllocator& allocator, float budget_fraction = 0.9f);
+
+    // Destructor
+    ~MemoryBudgetManager();
+
+    // Delete copy and move. the attached renderer holds a callback referencing this object.
+    MemoryBudgetManager(const MemoryBudgetManager&) = delete;
+    MemoryBudgetManager& operator=(const MemoryBudgetManager&) = delete;
+    MemoryBudgetManager(MemoryBudgetManager&&) = delete;
+    MemoryBudgetManager& operator=(MemoryBudgetManager&&) = delete;
+
+    // Register an allocation that may be dropped under memory pressure; returns an id for removal
+    uint32_t RegisterEvictable(VmaAllocation allocation, float priority, EvictionCallback on_evict);
+    void Unregister(uint32_t id);
+
+    // Mark an evictable allocation as used in the current frame (it won't be evicted this frame)
+    void Touch(uint32_t id);
+
+    // Evict until bytes more fit inside the heap budget. Returns false if not enough could be freed
+    bool MakeRoom(uint32_t heap_index, VkDeviceSize bytes);
+
+    // Budget-aware creation: frees room first, evicts lower priorities and retries on
+    // VK_ERROR_OUT_OF_DEVICE_MEMORY and finally falls back to host memory before failing
+    Buffer CreateBuffer(VkDeviceSize size,
+                        VkBufferUsageFlags usage,
+                        float priority = 0.5f,
+                        VmaAllocationCreateFlags flags = 0,
+                        const char* name = nullptr);
+    Image CreateImage(const VkImageCreateInfo& image_info, float priority = 0.5f);
+
+    // Advance the frame and trim heaps that went over budget (automatic when attached)
+    void Update(uint64_t frame_number);
+
+    // Update from Renderer::BeginFrame. The renderer must outlive
+    // this manager or Detach() must be called first
+    void AttachToRenderer(Renderer& renderer);
+    void Detach();
+
+    [[nodiscard]] uint32_t GetHeapCount() const { return heapCount_; }
+    [[nodiscard]] HeapStatus GetHeapStatus(uint32_t heap_index) const;
+    [[nodiscard]] uint64_t GetEvictionCount() const { return evictionCount_; }
+
+private:
+    struct Evictable {
+        uint32_t id{0};
+        VmaAllocation allocation{VK_NULL_HANDLE};
+        uint32_t heapIndex{0};
+        VkDeviceSize size{0};
+        float priority{0.5f};
+        uint64_t lastUsedFrame{0};
+        EvictionCallback onEvict;
+    };
+
+    const VmaAllocator* allocator_{nullptr};
+    float budgetFraction_{0.9f};
+    uint32_t heapCount_{0};
+    std::vector<uint32_t> memoryTypeHeaps_;
+    std::vector<bool> heapDeviceLocal_;
+
+    std::vector<Evictable> evictables_;
+    uint32_t nextId_{1};
+    uint64_t frameNumber_{0};
+    uint64_t evictionCount_{0};
+
+    Renderer* renderer_{nullptr};
+    FrameBeginSubscription frameBeginSubscription_;
+
+    [[nodiscard]] VkDeviceSize GetHeapLimit(const ::VmaBudget& budget) const;
+    // Evict on heap_index until bytes fit; only entries below max_priority are considered
+    VkDeviceSize Evict(uint32_t heap_index, VkDeviceSize bytes, float max_priority);
+    [[nodiscard]] uint32_t GetBufferHeap(const VkBufferCreateInfo& buffer_info, const VmaAllocationCreateInfo& allocation_info) const;
+    [[nodiscard]] uint32_t GetImageHeap(const VkImageCreateInfo& image_info, const VmaAllocationCreateInfo& allocation_info) const;
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RESOURCES_MEMORY_BUDGET_MANAGER_HPP
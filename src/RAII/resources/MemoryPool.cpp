@@ -0,0 +1,116 @@
+#include "MemoryPool.hpp"
+
+#include "VmaAllocator.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+
+
+namespace VulkanEngine::RAII {
+
+MemoryPool::MemoryPool(const VmaAllocator& allocator, const ::VmaPoolCreateInfo& create_info)
+    : allocator_(&allocator),
+    memoryTypeIndex_(create_info.memoryTypeIndex),
+    linear_((create_info.flags & VMA_POOL_CREATE_LINEAR_ALGORITHM_BIT) != 0)
+{
+    if (allocator.CreatePool(create_info, pool_) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create VMA pool");
+    }
+}
+
+MemoryPool::~MemoryPool() {
+    Cleanup();
+}
+
+MemoryPool::MemoryPool(MemoryPool&& other) noexcept
+    : pool_(other.pool_),
+    allocator_(other.allocator_),
+    memoryTypeIndex_(other.memoryTypeIndex_),
+    linear_(other.linear_)
+{
+    other.pool_ = VK_NULL_HANDLE;
+    other.allocator_ = nullptr;
+}
+
+MemoryPool& MemoryPool::operator=(MemoryPool&& other) noexcept {
+    if (this != &other) {
+        Cleanup();
+        pool_ = other.pool_;
+        allocator_ = other.allocator_;
+        memoryTypeIndex_ = other.memoryTypeIndex_;
+        linear_ = other.linear_;
+        other.pool_ = VK_NULL_HANDLE;
+        other.allocator_ = nullptr;
+    }
+    return *this;
+}
+
+::VmaStatistics MemoryPool::GetStatistics() const {
+    ::VmaStatistics stats{};
+    if (pool_ != VK_NULL_HANDLE) {
+        vmaGetPoolStatistics(allocator_->GetHandle(), pool_, &stats);
+    }
+    return stats;
+}
+
+MemoryPool MemoryPool::CreateLinearForBuffers(const VmaAllocator& allocator,
+                                              VkBufferUsageFlags usage,
+                                              VkDeviceSize block_size,
+                                              VmaMemoryUsage memory_usage,
+                                              VmaAllocationCreateFlags allocation_flags,
+                                              uint32_t max_block_count) {
+    // Size is irrelevant for memory type selection, only usage matters
+    VkBufferCreateInfo sample_info{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    sample_info.size = 1024;
+    sample_info.usage = usage;
+    sample_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo alloc_info{};
+    alloc_info.usage = memory_usage;
+    alloc_info.flags = allocation_flags;
+
+    uint32_t memory_type_index = 0;
+    if (allocator.FindMemoryTypeIndexForBufferInfo(sample_info, alloc_info, memory_type_index) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to find memory type for linear buffer pool");
+    }
+
+    ::VmaPoolCreateInfo pool_info{};
+    pool_info.memoryTypeIndex = memory_type_index;
+    pool_info.flags = VMA_POOL_CREATE_LINEAR_ALGORITHM_BIT;
+    pool_info.blockSize = block_size;
+    pool_info.minBlockCount = 1;
+    pool_info.maxBlockCount = max_block_count;
+    return MemoryPool(allocator, pool_info);
+}
+
+MemoryPool MemoryPool::CreateLinearForImages(const VmaAllocator& allocator,
+                                             const VkImageCreateInfo& sample_info,
+                                             VkDeviceSize block_size,
+                                             VmaMemoryUsage memory_usage,
+                                             uint32_t max_block_count) {
+    VmaAllocationCreateInfo alloc_info{};
+    alloc_info.usage = memory_usage;
+
+    uint32_t memory_type_index = 0;
+    if (allocator.FindMemoryTypeIndexForImageInfo(sample_info, alloc_info, memory_type_index) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to find memory type for linear image pool");
+    }
+
+    ::VmaPoolCreateInfo pool_info{};
+    pool_info.memoryTypeIndex = memory_type_index;
+    pool_info.flags = VMA_POOL_CREATE_LINEAR_ALGORITHM_BIT;
+    pool_info.blockSize = block_size;
+    pool_info.minBlockCount = 1;
+    pool_info.maxBlockCount = max_block_count;
+    return MemoryPool(allocator, pool_info);
+}
+
+void MemoryPool::Cleanup()
+{
+    if (pool_ != VK_NULL_HANDLE && allocator_) {
+        allocator_->DestroyPool(pool_);
+    }
+    pool_ = VK_NULL_HANDLE;
+}
+
+} // namespace VulkanEngine::RAII
@@ -0,0 +1,76 @@
+#ifndef VULKAN_RAII_RESOURCES_MEMORY_POOL_HPP
+#define VULKAN_RAII_RESOURCES_MEMORY_POOL_HPP
+
+#include <volk.h>
+#include <vk_mem_alloc.h>
+
+#include <cstdint>
+
+namespace VulkanEngine::RAII {
+
+class VmaAllocator; // Forward declaration
+
+// RAII wrapper around a custom VMA pool. Buffers and images can be allocated
+// from it through their pool constructors.
+class MemoryPool {
+public:
+    // Constructor that creates a pool from a fully specified create info
+    MemoryPool(const VmaAllocator& allocator, const ::VmaPoolCreateInfo& create_info);
+
+    // Destructor (all allocations from the pool must have been freed)
+    ~MemoryPool();
+
+    // Move constructor and assignment
+    MemoryPool(MemoryPool&& other) noexcept;
+    MemoryPool& operator=(MemoryPool&& other) noexcept;
+
+    // Delete copy constructor and assignment. this ensures unique ownership of the VmaPool by only allowing moving.
+    MemoryPool(const MemoryPool&) = delete;
+    MemoryPool& operator=(const MemoryPool&) = delete;
+
+    [[nodiscard]] ::VmaPool GetHandle() const { return pool_; }
+
+    // Implicit conversion to VmaPool
+    operator ::VmaPool() const { return pool_; }
+
+    // Check if the pool is valid
+    [[nodiscard]] bool IsValid() const { return pool_ != VK_NULL_HANDLE; }
+
+    // Allocator the pool belongs to
+    [[nodiscard]] const VmaAllocator& GetAllocator() const { return *allocator_; }
+
+    [[nodiscard]] uint32_t GetMemoryTypeIndex() const { return memoryTypeIndex_; }
+
+    // Check if the pool uses the linear (stack/ring) algorithm
+    [[nodiscard]] bool IsLinear() const { return linear_; }
+
+    // Current pool statistics
+    [[nodiscard]] ::VmaStatistics GetStatistics() const;
+
+    // Create a linear pool whose memory type fits buffers with the given usage
+    static MemoryPool CreateLinearForBuffers(const VmaAllocator& allocator,
+                                             VkBufferUsageFlags usage,
+                                             VkDeviceSize block_size,
+                                             VmaMemoryUsage memory_usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+                                             VmaAllocationCreateFlags allocation_flags = 0,
+                                             uint32_t max_block_count = 1);
+
+    // Create a linear pool whose memory type fits images like sample_info
+    static MemoryPool CreateLinearForImages(const VmaAllocator& allocator,
+                                            const VkImageCreateInfo& sample_info,
+                                            VkDeviceSize block_size,
+                                            VmaMemoryUsage memory_usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+                                            uint32_t max_block_count = 1);
+
+private:
+    ::VmaPool pool_{VK_NULL_HANDLE};
+    const VmaAllocator* allocator_{nullptr};
+    uint32_t memoryTypeIndex_{0};
+    bool linear_{false};
+
+    void Cleanup();
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RESOURCES_MEMORY_POOL_HPP
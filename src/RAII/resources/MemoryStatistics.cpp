@@ -0,0 +1,179 @@
+#include "MemoryStatistics.hpp"
+
+#include "VmaAllocator.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <string_view>
+#include <unordered_map>
+
+
+namespace VulkanEngine::RAII {
+
+namespace {
+// Position just past "key": in json at or after pos, or npos. A string value equal
+// to the key is followed by ',' or '}' rather than ':' and is skipped
+size_t FindKey(std::string_view json, std::string_view key, size_t pos, size_t end)
+{
+    for (pos = json.find(key, pos); pos < end; pos = json.find(key, pos + 1)) {
+        size_t value = json.find_first_not_of(" \t\r\n", pos + key.size());
+        if (value < end && json[value] == ':') {
+            return json.find_first_not_of(" \t\r\n", value + 1);
+        }
+    }
+    return std::string_view::npos;
+}
+
+// JSON string starting at pos (the opening quote); VmaJsonWriter escapes only quotes,
+// backslashes, slashes and the common control characters
+bool ReadString(std::string_view json, size_t pos, std::string& out)
+{
+    out.clear();
+    if (pos >= json.size() || json[pos] != '"') {
+        return false;
+    }
+    for (++pos; pos < json.size(); ++pos) {
+        char c = json[pos];
+        if (c == '"') {
+            return true;
+        }
+        if (c == '\\' && ++pos < json.size()) {
+            switch (json[pos]) {
+            case 'b': c = '\b'; break;
+            case 'f': c = '\f'; break;
+            case 'n': c = '\n'; break;
+            case 'r': c = '\r'; break;
+            case 't': c = '\t'; break;
+            default: c = json[pos]; break;
+            }
+        }
+        out.push_back(c);
+    }
+    return false;
+}
+
+// Every allocation object in a detailed dump lists "Size" before its optional "Name"
+template<typename Visit>
+void ForEachNamedAllocation(std::string_view json, Visit&& visit)
+{
+    constexpr std::string_view NAME_KEY = "\"Name\"";
+    constexpr std::string_view SIZE_KEY = "\"Size\"";
+    std::string name;
+    for (size_t pos = FindKey(json, NAME_KEY, 0, json.size()); pos != std::string_view::npos;
+         pos = FindKey(json, NAME_KEY, pos, json.size())) {
+        const size_t object_begin = json.rfind('{', pos);
+        const size_t size_pos = object_begin == std::string_view::npos ? object_begin : FindKey(json, SIZE_KEY, object_begin, pos);
+        if (size_pos == std::string_view::npos || !ReadString(json, pos, name)) {
+            continue;
+        }
+        visit(name, static_cast<VkDeviceSize>(std::strtoull(json.data() + size_pos, nullptr, 10)));
+    }
+}
+
+float UnusedShare(VkDeviceSize block_bytes, VkDeviceSize allocation_bytes)
+{
+    if (block_bytes == 0) {
+        return 0.0f;
+    }
+    return 1.0f - static_cast<float>(static_cast<double>(allocation_bytes) / static_cast<double>(block_bytes));
+}
+} // namespace
+
+MemoryStatistics::MemoryStatistics(const VmaAllocator& allocator)
+    : allocator_(&allocator) {}
+
+void MemoryStatistics::QueryHeaps(std::vector<HeapMemoryStats>& out) const
+{
+    const VkPhysicalDeviceMemoryProperties* properties = nullptr;
+    vmaGetMemoryProperties(allocator_->GetHandle(), &properties);
+
+    ::VmaBudget budgets[VK_MAX_MEMORY_HEAPS]{};
+    allocator_->GetHeapBudgets(budgets);
+
+    out.resize(properties->memoryHeapCount);
+    for (uint32_t i = 0; i < properties->memoryHeapCount; ++i) {
+        HeapMemoryStats& heap = out[i];
+        heap.heapIndex = i;
+        heap.deviceLocal = (properties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+        heap.budget = budgets[i].budget;
+        heap.usage = budgets[i].usage;
+        heap.blockBytes = budgets[i].statistics.blockBytes;
+        heap.allocationBytes = budgets[i].statistics.allocationBytes;
+        heap.blockCount = budgets[i].statistics.blockCount;
+        heap.allocationCount = budgets[i].statistics.allocationCount;
+        heap.fragmentation = UnusedShare(heap.blockBytes, heap.allocationBytes);
+    }
+}
+
+void MemoryStatistics::QueryMemoryTypes(std::vector<MemoryTypeStats>& out) const
+{
+    const VkPhysicalDeviceMemoryProperties* properties = nullptr;
+    vmaGetMemoryProperties(allocator_->GetHandle(), &properties);
+
+    ::VmaTotalStatistics stats{};
+    allocator_->CalculateStatistics(stats);
+
+    out.resize(properties->memoryTypeCount);
+    for (uint32_t i = 0; i < properties->memoryTypeCount; ++i) {
+        const ::VmaDetailedStatistics& detailed = stats.memoryType[i];
+        MemoryTypeStats& type = out[i];
+        type.memoryTypeIndex = i;
+        type.heapIndex = properties->memoryTypes[i].heapIndex;
+        type.propertyFlags = properties->memoryTypes[i].propertyFlags;
+        type.blockBytes = detailed.statistics.blockBytes;
+        type.allocationBytes = detailed.statistics.allocationBytes;
+        type.blockCount = detailed.statistics.blockCount;
+        type.allocationCount = detailed.statistics.allocationCount;
+        type.unusedRangeCount = detailed.unusedRangeCount;
+        type.largestUnusedRange = detailed.unusedRangeCount > 0 ? detailed.unusedRangeSizeMax : 0;
+
+        const VkDeviceSize unused_bytes = type.blockBytes - type.allocationBytes;
+        type.fragmentation = unused_bytes > 0
+            ? 1.0f - static_cast<float>(static_cast<double>(type.largestUnusedRange) / static_cast<double>(unused_bytes))
+            : 0.0f;
+    }
+}
+
+void MemoryStatistics::QueryNamedUsage(std::vector<NamedMemoryUsage>& out) const
+{
+    out.clear();
+    const std::string json = BuildJson(true);
+
+    std::unordered_map<std::string, size_t> index_by_name;
+    ForEachNamedAllocation(json, [&](const std::string& name, VkDeviceSize size) {
+        auto it = index_by_name.find(name);
+        if (it == index_by_name.end()) {
+            it = index_by_name.emplace(name, out.size()).first;
+            out.push_back(NamedMemoryUsage{name, 0, 0});
+        }
+        out[it->second].bytes += size;
+        ++out[it->second].allocationCount;
+    });
+
+    std::sort(out.begin(), out.end(), [](const NamedMemoryUsage& a, const NamedMemoryUsage& b) {
+        return a.bytes > b.bytes;
+    });
+}
+
+std::string MemoryStatistics::BuildJson(bool detailed) const
+{
+    char* stats_string = nullptr;
+    vmaBuildStatsString(allocator_->GetHandle(), &stats_string, detailed ? VK_TRUE : VK_FALSE);
+    std::string json = stats_string ? stats_string : "{}";
+    vmaFreeStatsString(allocator_->GetHandle(), stats_string);
+    return json;
+}
+
+bool MemoryStatistics::WriteJson(const std::string& path, bool detailed) const
+{
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    file << BuildJson(detailed);
+    return static_cast<bool>(file);
+}
+
+} // namespace VulkanEngine::RAII
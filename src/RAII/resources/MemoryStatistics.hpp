@@ -0,0 +1,80 @@
+#ifndef VULKAN_RAII_RESOURCES_MEMORY_STATISTICS_HPP
+#define VULKAN_RAII_RESOURCES_MEMORY_STATISTICS_HPP
+
+#include <volk.h>
+#include <vk_mem_alloc.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace VulkanEngine::RAII {
+
+class VmaAllocator; // Forward declaration
+
+// Per-heap numbers; fragmentation is the unused share of the heap's blocks
+struct HeapMemoryStats {
+    uint32_t heapIndex{0};
+    bool deviceLocal{false};
+    VkDeviceSize budget{0};
+    VkDeviceSize usage{0};
+    VkDeviceSize blockBytes{0};
+    VkDeviceSize allocationBytes{0};
+    uint32_t blockCount{0};
+    uint32_t allocationCount{0};
+    float fragmentation{0.0f};
+};
+
+// Per-memory-type numbers; fragmentation is 1 - largest free range / total free bytes
+struct MemoryTypeStats {
+    uint32_t memoryTypeIndex{0};
+    uint32_t heapIndex{0};
+    VkMemoryPropertyFlags propertyFlags{0};
+    VkDeviceSize blockBytes{0};
+    VkDeviceSize allocationBytes{0};
+    uint32_t blockCount{0};
+    uint32_t allocationCount{0};
+    uint32_t unusedRangeCount{0};
+    VkDeviceSize largestUnusedRange{0};
+    float fragmentation{0.0f};
+};
+
+// Memory of all live allocations sharing a debug name (Buffer/Image::SetDebugName
+// store it on the VMA allocation)
+struct NamedMemoryUsage {
+    std::string name;
+    VkDeviceSize bytes{0};
+    uint32_t allocationCount{0};
+};
+
+// Read-only view of an allocator's memory. QueryHeaps only reads the cached
+// budget and is cheap enough for a per-frame overlay; QueryMemoryTypes and
+// QueryNamedUsage walk every block and are meant for occasional inspection.
+class MemoryStatistics {
+public:
+    // Constructor
+    explicit MemoryStatistics(const VmaAllocator& allocator);
+
+    // Per-heap usage (fills out, reusing its storage)
+    void QueryHeaps(std::vector<HeapMemoryStats>& out) const;
+
+    // Per-memory-type usage from vmaCalculateStatistics
+    void QueryMemoryTypes(std::vector<MemoryTypeStats>& out) const;
+
+    // Usage grouped by debug name, largest first. Read back from the detailed stats
+    // string, the only place VMA lists allocations with their names
+    void QueryNamedUsage(std::vector<NamedMemoryUsage>& out) const;
+
+    // JSON snapshot from vmaBuildStatsString (detailed lists every allocation with its name)
+    [[nodiscard]] std::string BuildJson(bool detailed = true) const;
+
+    // Write the JSON snapshot to a file; returns false if the file could not be written
+    bool WriteJson(const std::string& path, bool detailed = true) const;
+
+private:
+    const VmaAllocator* allocator_{nullptr};
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RESOURCES_MEMORY_STATISTICS_HPP
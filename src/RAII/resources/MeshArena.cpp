@@ -0,0 +1,223 @@
+#include "MeshArena.hpp"
+
+#include "VmaAllocator.hpp"
+#include "../rendering/CommandBuffer.hpp"
+
+#include <array>
+#include <stdexcept>
+#include <string>
+
+namespace VulkanEngine::RAII {
+
+namespace {
+uint32_t IndexSize(VkIndexType index_type) {
+    switch (index_type) {
+        case VK_INDEX_TYPE_UINT16:
+            return 2;
+        case VK_INDEX_TYPE_UINT32:
+            return 4;
+        case VK_INDEX_TYPE_UINT8_EXT:
+            return 1;
+        default:
+            throw std::invalid_argument("MeshArena requires a UINT8, UINT16 or UINT32 index type");
+    }
+}
+} // namespace
+
+MeshArena::MeshArena(const VmaAllocator& allocator, const MeshArenaConfig& config)
+    : allocator_(&allocator),
+    config_(config),
+    indexSize_(IndexSize(config.indexType))
+{
+    if (config_.vertexStride == 0 || config_.verticesPerBlock == 0 || config_.indicesPerBlock == 0) {
+        throw std::invalid_argument("MeshArena requires a vertex stride and non-zero block sizes");
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    CreateBlock();
+}
+
+MeshArena::~MeshArena() {
+    for (const auto& block : blocks_) {
+        // Meshes still allocated go away with the arena
+        vmaClearVirtualBlock(block->vertexRanges);
+        vmaClearVirtualBlock(block->indexRanges);
+        vmaDestroyVirtualBlock(block->vertexRanges);
+        vmaDestroyVirtualBlock(block->indexRanges);
+    }
+}
+
+MeshAllocation MeshArena::Allocate(uint32_t vertex_count, uint32_t index_count) {
+    if (vertex_count == 0 || index_count == 0) {
+        throw std::invalid_argument("MeshArena::Allocate requires vertices and indices");
+    }
+    if (vertex_count > config_.verticesPerBlock || index_count > config_.indicesPerBlock) {
+        throw std::invalid_argument("Mesh of " + std::to_string(vertex_count) + " vertices and " +
+                                    std::to_string(index_count) + " indices exceeds the MeshArena block size");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    MeshAllocation mesh;
+    for (uint32_t block = 0; block < blocks_.size(); ++block) {
+        if (TryAllocate(block, vertex_count, index_count, mesh)) {
+            return mesh;
+        }
+    }
+    CreateBlock();
+    if (!TryAllocate(static_cast<uint32_t>(blocks_.size() - 1), vertex_count, index_count, mesh)) {
+        throw std::runtime_error("Failed to allocate mesh in a new MeshArena block");
+    }
+    return mesh;
+}
+
+UploadTicket MeshArena::Upload(UploadManager& upload_manager, const MeshAllocation& mesh,
+                               const void* vertices, const void* indices) {
+    if (!mesh.IsValid()) {
+        throw std::invalid_argument("MeshArena::Upload requires an allocated mesh");
+    }
+    Block* block = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        block = blocks_.at(mesh.block).get();
+    }
+    Buffer& vertex_buffer = block->vertexBuffer;
+    Buffer& index_buffer = block->indexBuffer;
+    // Both copies land in the recording batch; the later ticket covers the earlier one.
+    // Only the mesh's ranges are released, so meshes already in the block keep drawing
+    upload_manager.UploadBuffer(vertex_buffer, vertices,
+                                static_cast<VkDeviceSize>(mesh.vertexCount) * config_.vertexStride,
+                                static_cast<VkDeviceSize>(mesh.vertexOffset) * config_.vertexStride,
+                                ResourceAccess{VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT_KHR,
+                                               VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT_KHR});
+    return upload_manager.UploadBuffer(index_buffer, indices,
+                                       static_cast<VkDeviceSize>(mesh.indexCount) * indexSize_,
+                                       static_cast<VkDeviceSize>(mesh.firstIndex) * indexSize_,
+                                       ResourceAccess{VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT_KHR,
+                                                      VK_ACCESS_2_INDEX_READ_BIT_KHR});
+}
+
+void MeshArena::Free(MeshAllocation& mesh) {
+    if (!mesh.IsValid()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Block& block = *blocks_.at(mesh.block);
+    vmaVirtualFree(block.vertexRanges, mesh.vertexAllocation);
+    vmaVirtualFree(block.indexRanges, mesh.indexAllocation);
+    block.usedVertices -= mesh.vertexCount;
+    block.usedIndices -= mesh.indexCount;
+    mesh = MeshAllocation{};
+}
+
+void MeshArena::Bind(const CommandBuffer& command_buffer, uint32_t block) const {
+    const VkBuffer vertex_buffer = GetVertexBuffer(block).GetHandle();
+    const std::array<VkDeviceSize, 1> offsets{0};
+    command_buffer.BindVertexBuffers(0, std::span<const VkBuffer>(&vertex_buffer, 1), offsets);
+    command_buffer.BindIndexBuffer(GetIndexBuffer(block).GetHandle(), 0, config_.indexType);
+}
+
+VkDrawIndexedIndirectCommand MeshArena::GetDrawCommand(const MeshAllocation& mesh,
+                                                       uint32_t instance_count,
+                                                       uint32_t first_instance) const {
+    VkDrawIndexedIndirectCommand command{};
+    command.indexCount = mesh.indexCount;
+    command.instanceCount = instance_count;
+    command.firstIndex = mesh.firstIndex;
+    command.vertexOffset = mesh.vertexOffset;
+    command.firstInstance = first_instance;
+    return command;
+}
+
+uint32_t MeshArena::GetBlockCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<uint32_t>(blocks_.size());
+}
+
+const Buffer& MeshArena::GetVertexBuffer(uint32_t block) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return blocks_.at(block)->vertexBuffer;
+}
+
+const Buffer& MeshArena::GetIndexBuffer(uint32_t block) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return blocks_.at(block)->indexBuffer;
+}
+
+uint64_t MeshArena::GetUsedVertexCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t used = 0;
+    for (const auto& block : blocks_) {
+        used += block->usedVertices;
+    }
+    return used;
+}
+
+uint64_t MeshArena::GetUsedIndexCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t used = 0;
+    for (const auto& block : blocks_) {
+        used += block->usedIndices;
+    }
+    return used;
+}
+
+bool MeshArena::TryAllocate(uint32_t block_index, uint32_t vertex_count, uint32_t index_count, MeshAllocation& mesh) {
+    Block& block = *blocks_[block_index];
+
+    VmaVirtualAllocationCreateInfo vertex_info{};
+    vertex_info.size = vertex_count;
+    VmaVirtualAllocation vertex_allocation{VK_NULL_HANDLE};
+    VkDeviceSize vertex_offset = 0;
+    if (vmaVirtualAllocate(block.vertexRanges, &vertex_info, &vertex_allocation, &vertex_offset) != VK_SUCCESS) {
+        return false;
+    }
+
+    VmaVirtualAllocationCreateInfo index_info{};
+    index_info.size = index_count;
+    VmaVirtualAllocation index_allocation{VK_NULL_HANDLE};
+    VkDeviceSize index_offset = 0;
+    if (vmaVirtualAllocate(block.indexRanges, &index_info, &index_allocation, &index_offset) != VK_SUCCESS) {
+        vmaVirtualFree(block.vertexRanges, vertex_allocation);
+        return false;
+    }
+
+    block.usedVertices += vertex_count;
+    block.usedIndices += index_count;
+    mesh.block = block_index;
+    mesh.vertexBuffer = block.vertexBuffer.GetHandle();
+    mesh.indexBuffer = block.indexBuffer.GetHandle();
+    mesh.firstIndex = static_cast<uint32_t>(index_offset);
+    mesh.vertexOffset = static_cast<int32_t>(vertex_offset);
+    mesh.indexCount = index_count;
+    mesh.vertexCount = vertex_count;
+    mesh.vertexAllocation = vertex_allocation;
+    mesh.indexAllocation = index_allocation;
+    return true;
+}
+
+void MeshArena::CreateBlock() {
+    const std::string suffix = std::to_string(blocks_.size());
+    const VkBufferUsageFlags usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | config_.extraUsage;
+    auto block = std::make_unique<Block>(Block{
+        Buffer(*allocator_, static_cast<VkDeviceSize>(config_.verticesPerBlock) * config_.vertexStride,
+               usage | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, 0,
+               ("MeshArena vertices " + suffix).c_str()),
+        Buffer(*allocator_, static_cast<VkDeviceSize>(config_.indicesPerBlock) * indexSize_,
+               usage | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, 0,
+               ("MeshArena indices " + suffix).c_str())});
+
+    // Offsets count vertices and indices, so the virtual blocks need no alignment
+    VmaVirtualBlockCreateInfo vertex_info{};
+    vertex_info.size = config_.verticesPerBlock;
+    if (vmaCreateVirtualBlock(&vertex_info, &block->vertexRanges) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create MeshArena vertex range allocator");
+    }
+    VmaVirtualBlockCreateInfo index_info{};
+    index_info.size = config_.indicesPerBlock;
+    if (vmaCreateVirtualBlock(&index_info, &block->indexRanges) != VK_SUCCESS) {
+        vmaDestroyVirtualBlock(block->vertexRanges);
+        throw std::runtime_error("Failed to create MeshArena index range allocator");
+    }
+    blocks_.push_back(std::move(block));
+}
+
+} // namespace VulkanEngine::RAII
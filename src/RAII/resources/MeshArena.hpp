@@ -0,0 +1,118 @@
+#ifndef VULKAN_RAII_RESOURCES_MESH_ARENA_HPP
+#define VULKAN_RAII_RESOURCES_MESH_ARENA_HPP
+
+#include <volk.h>
+#include <vk_mem_alloc.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Buffer.hpp"
+#include "UploadManager.hpp"
+
+namespace VulkanEngine::RAII {
+
+class CommandBuffer; // Forward declaration
+class VmaAllocator; // Forward declaration
+
+struct MeshArenaConfig {
+    uint32_t vertexStride{32}; // Shared by every mesh, so vertexOffset counts whole vertices
+    VkIndexType indexType{VK_INDEX_TYPE_UINT32};
+    uint32_t verticesPerBlock{4u * 1024 * 1024};
+    uint32_t indicesPerBlock{16u * 1024 * 1024};
+    // Added to VERTEX_BUFFER / INDEX_BUFFER and TRANSFER_DST, e.g. STORAGE_BUFFER for GPU culling
+    VkBufferUsageFlags extraUsage{0};
+};
+
+// Where a mesh lives in the arena. Every mesh of a block draws after one Bind(block)
+// with vkCmdDrawIndexed(indexCount, 1, firstIndex, vertexOffset, 0) or an indirect
+// command from MeshArena::GetDrawCommand
+struct MeshAllocation {
+    uint32_t block{0};
+    VkBuffer vertexBuffer{VK_NULL_HANDLE};
+    VkBuffer indexBuffer{VK_NULL_HANDLE};
+    uint32_t firstIndex{0};
+    int32_t vertexOffset{0};
+    uint32_t indexCount{0};
+    uint32_t vertexCount{0};
+    VmaVirtualAllocation vertexAllocation{VK_NULL_HANDLE};
+    VmaVirtualAllocation indexAllocation{VK_NULL_HANDLE};
+
+    [[nodiscard]] bool IsValid() const { return vertexBuffer != VK_NULL_HANDLE; }
+};
+
+// Geometry megabuffer: a few large device-local vertex and index buffers whose ranges are
+// sub-allocated with VMA virtual blocks, instead of one VMA allocation and one bind per
+// mesh. A new block pair is created when no existing block fits a mesh, so the number of
+// binds per frame is the number of blocks. Thread-safe
+class MeshArena {
+public:
+    MeshArena(const VmaAllocator& allocator, const MeshArenaConfig& config = {});
+
+    // Destructor; the GPU must be done with every block
+    ~MeshArena();
+
+    // Delete copy and move. handed-out allocations reference the blocks.
+    MeshArena(const MeshArena&) = delete;
+    MeshArena& operator=(const MeshArena&) = delete;
+    MeshArena(MeshArena&&) = delete;
+    MeshArena& operator=(MeshArena&&) = delete;
+
+    // Reserve ranges for a mesh. Throws std::invalid_argument when the mesh is larger
+    // than a block
+    [[nodiscard]] MeshAllocation Allocate(uint32_t vertex_count, uint32_t index_count);
+
+    // Queue the mesh's vertex and index data through upload_manager; the mesh is drawable
+    // once the returned ticket completes and, when the manager uses a dedicated transfer
+    // family, its RecordAcquireBarriers ran on the graphics command buffer that draws it.
+    // Sizes follow the config's stride and index type
+    UploadTicket Upload(UploadManager& upload_manager, const MeshAllocation& mesh,
+                        const void* vertices, const void* indices);
+
+    // Return the ranges; the GPU must no longer read them (e.g. defer until the frame
+    // that last drew the mesh has retired)
+    void Free(MeshAllocation& mesh);
+
+    // Bind the vertex buffer at binding 0 and the index buffer of block
+    void Bind(const CommandBuffer& command_buffer, uint32_t block = 0) const;
+
+    [[nodiscard]] VkDrawIndexedIndirectCommand GetDrawCommand(const MeshAllocation& mesh,
+                                                              uint32_t instance_count = 1,
+                                                              uint32_t first_instance = 0) const;
+
+    [[nodiscard]] uint32_t GetBlockCount() const;
+    [[nodiscard]] const Buffer& GetVertexBuffer(uint32_t block) const;
+    [[nodiscard]] const Buffer& GetIndexBuffer(uint32_t block) const;
+
+    // Vertices and indices in use across all blocks
+    [[nodiscard]] uint64_t GetUsedVertexCount() const;
+    [[nodiscard]] uint64_t GetUsedIndexCount() const;
+
+    [[nodiscard]] const MeshArenaConfig& GetConfig() const { return config_; }
+    [[nodiscard]] uint32_t GetIndexSize() const { return indexSize_; }
+
+private:
+    struct Block {
+        Buffer vertexBuffer;
+        Buffer indexBuffer;
+        VmaVirtualBlock vertexRanges{VK_NULL_HANDLE}; // In vertices
+        VmaVirtualBlock indexRanges{VK_NULL_HANDLE}; // In indices
+        uint64_t usedVertices{0};
+        uint64_t usedIndices{0};
+    };
+
+    const VmaAllocator* allocator_{nullptr};
+    MeshArenaConfig config_;
+    uint32_t indexSize_{4};
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Block>> blocks_; // Stable addresses for the handed-out VkBuffers
+
+    bool TryAllocate(uint32_t block_index, uint32_t vertex_count, uint32_t index_count, MeshAllocation& mesh); // mutex_ held
+    void CreateBlock(); // mutex_ held
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RESOURCES_MESH_ARENA_HPP
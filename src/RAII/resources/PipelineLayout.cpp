@@ -1,6 +1,7 @@
 #include "PipelineLayout.hpp"
 
 #include "../core/Device.hpp"
+#include "../utils/HostAllocator.hpp"
 
 #include <cstdint>
 #include <stdexcept>
@@ -72,7 +73,7 @@ void PipelineLayout::CreatePipelineLayout()
     layout_info.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges_.size());
     layout_info.pPushConstantRanges = pushConstantRanges_.empty() ? nullptr : pushConstantRanges_.data();
 
-    if (vkCreatePipelineLayout(device_, &layout_info, nullptr, &pipelineLayout_) != VK_SUCCESS) {
+    if (vkCreatePipelineLayout(device_, &layout_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_PIPELINE_LAYOUT), &pipelineLayout_) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create pipeline layout");
     }
 }
@@ -80,7 +81,7 @@ void PipelineLayout::CreatePipelineLayout()
 void PipelineLayout::Cleanup()
 {
     if (pipelineLayout_ != VK_NULL_HANDLE) {
-        vkDestroyPipelineLayout(device_, pipelineLayout_, nullptr);
+        vkDestroyPipelineLayout(device_, pipelineLayout_, Utils::HostAllocator::For(VK_OBJECT_TYPE_PIPELINE_LAYOUT));
         pipelineLayout_ = VK_NULL_HANDLE;
     }
     device_ = VK_NULL_HANDLE;
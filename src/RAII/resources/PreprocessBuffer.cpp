@@ -0,0 +1,99 @@
+#include "PreprocessBuffer.hpp"
+
+#include "VmaAllocator.hpp"
+
+#include <stdexcept>
+
+
+namespace VulkanEngine::RAII {
+
+PreprocessBuffer::PreprocessBuffer(const VmaAllocator& allocator, const VkMemoryRequirements& requirements)
+    : allocator_(allocator.GetHandle()),
+    size_(requirements.size)
+{
+    if (allocator_ == VK_NULL_HANDLE || requirements.size == 0) {
+        throw std::invalid_argument("PreprocessBuffer requires a valid allocator and non-zero size");
+    }
+
+    VkBufferUsageFlags2CreateInfoKHR usage_info{VK_STRUCTURE_TYPE_BUFFER_USAGE_FLAGS_2_CREATE_INFO_KHR};
+    usage_info.usage = VK_BUFFER_USAGE_2_PREPROCESS_BUFFER_BIT_EXT | VK_BUFFER_USAGE_2_SHADER_DEVICE_ADDRESS_BIT_KHR;
+
+    VkBufferCreateInfo buffer_info{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    buffer_info.pNext = &usage_info;
+    buffer_info.size = requirements.size;
+    buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    // Only the memory types the generated commands requirements allow
+    VmaAllocationCreateInfo alloc_info{};
+    alloc_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+    alloc_info.memoryTypeBits = requirements.memoryTypeBits;
+
+    VmaAllocationInfo allocation_info{};
+    if (allocator.CreateBufferWithAlignment(buffer_info, alloc_info, requirements.alignment, buffer_, allocation_, &allocation_info) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create preprocess buffer");
+    }
+    memoryTypeIndex_ = allocation_info.memoryType;
+
+    VkBufferDeviceAddressInfo address_info{VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO};
+    address_info.buffer = buffer_;
+    address_ = vkGetBufferDeviceAddress(allocator.GetDevice(), &address_info);
+}
+
+PreprocessBuffer::~PreprocessBuffer() {
+    Cleanup();
+}
+
+PreprocessBuffer::PreprocessBuffer(PreprocessBuffer&& other) noexcept
+    : allocator_(other.allocator_),
+    buffer_(other.buffer_),
+    allocation_(other.allocation_),
+    address_(other.address_),
+    size_(other.size_),
+    memoryTypeIndex_(other.memoryTypeIndex_)
+{
+    other.allocator_ = VK_NULL_HANDLE;
+    other.buffer_ = VK_NULL_HANDLE;
+    other.allocation_ = VK_NULL_HANDLE;
+    other.address_ = 0;
+    other.size_ = 0;
+}
+
+PreprocessBuffer& PreprocessBuffer::operator=(PreprocessBuffer&& other) noexcept {
+    if (this != &other) {
+        Cleanup();
+        allocator_ = other.allocator_;
+        buffer_ = other.buffer_;
+        allocation_ = other.allocation_;
+        address_ = other.address_;
+        size_ = other.size_;
+        memoryTypeIndex_ = other.memoryTypeIndex_;
+        other.allocator_ = VK_NULL_HANDLE;
+        other.buffer_ = VK_NULL_HANDLE;
+        other.allocation_ = VK_NULL_HANDLE;
+        other.address_ = 0;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+bool PreprocessBuffer::Fits(const VkMemoryRequirements& requirements) const
+{
+    return IsValid() &&
+           requirements.size <= size_ &&
+           (requirements.alignment == 0 || address_ % requirements.alignment == 0) &&
+           (requirements.memoryTypeBits & (1U << memoryTypeIndex_)) != 0;
+}
+
+void PreprocessBuffer::Cleanup()
+{
+    if (buffer_ != VK_NULL_HANDLE) {
+        vmaDestroyBuffer(allocator_, buffer_, allocation_);
+        buffer_ = VK_NULL_HANDLE;
+        allocation_ = VK_NULL_HANDLE;
+    }
+    allocator_ = VK_NULL_HANDLE;
+    address_ = 0;
+    size_ = 0;
+}
+
+} // namespace VulkanEngine::RAII
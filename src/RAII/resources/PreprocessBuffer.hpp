@@ -0,0 +1,60 @@
+#ifndef VULKAN_RAII_RESOURCES_PREPROCESS_BUFFER_HPP
+#define VULKAN_RAII_RESOURCES_PREPROCESS_BUFFER_HPP
+
+#include <volk.h>
+#include <vk_mem_alloc.h>
+
+#include <cstdint>
+
+
+namespace VulkanEngine::RAII {
+
+class VmaAllocator; // Forward declaration
+
+// Scratch memory the driver expands a device-generated command stream into
+// (VK_EXT_device_generated_commands). Sized and typed from
+// IndirectCommandsLayout::GetPreprocessRequirements; the PREPROCESS_BUFFER usage
+// only exists as a 64-bit flag, so this is created apart from Buffer. The allocator
+// must have been created with VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT.
+class PreprocessBuffer {
+public:
+    PreprocessBuffer(const VmaAllocator& allocator, const VkMemoryRequirements& requirements);
+
+    // Destructor
+    ~PreprocessBuffer();
+
+    // Move constructor and assignment
+    PreprocessBuffer(PreprocessBuffer&& other) noexcept;
+    PreprocessBuffer& operator=(PreprocessBuffer&& other) noexcept;
+
+    // Delete copy constructor and assignment. this ensures unique ownership of the VkBuffer by only allowing moving.
+    PreprocessBuffer(const PreprocessBuffer&) = delete;
+    PreprocessBuffer& operator=(const PreprocessBuffer&) = delete;
+
+    [[nodiscard]] VkBuffer GetHandle() const { return buffer_; }
+
+    // Implicit conversion to VkBuffer
+    operator VkBuffer() const { return buffer_; }
+
+    [[nodiscard]] bool IsValid() const { return buffer_ != VK_NULL_HANDLE; }
+
+    [[nodiscard]] VkDeviceAddress GetDeviceAddress() const { return address_; }
+    [[nodiscard]] VkDeviceSize GetSize() const { return size_; }
+
+    // Check whether requirements fit in this buffer (reuse across layouts and sequence counts)
+    [[nodiscard]] bool Fits(const VkMemoryRequirements& requirements) const;
+
+private:
+    ::VmaAllocator allocator_{VK_NULL_HANDLE};
+    VkBuffer buffer_{VK_NULL_HANDLE};
+    VmaAllocation allocation_{VK_NULL_HANDLE};
+    VkDeviceAddress address_{0};
+    VkDeviceSize size_{0};
+    uint32_t memoryTypeIndex_{0};
+
+    void Cleanup();
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RESOURCES_PREPROCESS_BUFFER_HPP
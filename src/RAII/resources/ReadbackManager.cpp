@@ -0,0 +1,248 @@
+#include "ReadbackManager.hpp"
+
+#include "Image.hpp"
+#include "VmaAllocator.hpp"
+#include "../rendering/CommandBuffer.hpp"
+#include "../rendering/Renderer.hpp"
+#include "../sync/Fence.hpp"
+#include "../sync/Semaphore.hpp"
+#include "../utils/FormatUtils.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+
+namespace VulkanEngine::RAII {
+
+void ReadbackHandle::State::Complete()
+{
+    // Host-cached memory may be non-coherent; make the GPU writes visible once
+    buffer.Invalidate(size, 0);
+    ready = true;
+}
+
+bool ReadbackHandle::IsReady() const
+{
+    if (!state_) {
+        return false;
+    }
+    if (state_->ready) {
+        return true;
+    }
+
+    switch (state_->tracking) {
+        case Tracking::FENCE:
+            if (vkGetFenceStatus(state_->device, state_->fence) == VK_SUCCESS) {
+                state_->Complete();
+            }
+            break;
+        case Tracking::TIMELINE: {
+            uint64_t value = 0;
+            if (vkGetSemaphoreCounterValue(state_->device, state_->timeline, &value) == VK_SUCCESS &&
+                value >= state_->timelineValue) {
+                state_->Complete();
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return state_->ready;
+}
+
+bool ReadbackHandle::Wait(uint64_t timeout) const
+{
+    if (!state_) {
+        return false;
+    }
+    if (state_->ready) {
+        return true;
+    }
+
+    if (state_->tracking == Tracking::FENCE) {
+        if (vkWaitForFences(state_->device, 1, &state_->fence, VK_TRUE, timeout) == VK_SUCCESS) {
+            state_->Complete();
+        }
+    } else if (state_->tracking == Tracking::TIMELINE) {
+        VkSemaphoreWaitInfo wait_info{VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO};
+        wait_info.semaphoreCount = 1;
+        wait_info.pSemaphores = &state_->timeline;
+        wait_info.pValues = &state_->timelineValue;
+        if (vkWaitSemaphores(state_->device, &wait_info, timeout) == VK_SUCCESS) {
+            state_->Complete();
+        }
+    }
+    return IsReady();
+}
+
+std::span<const std::byte> ReadbackHandle::GetData() const
+{
+    if (!IsReady()) {
+        throw std::runtime_error("Readback is not ready");
+    }
+    const auto* data = static_cast<const std::byte*>(state_->buffer.GetMappedData());
+    return {data, static_cast<size_t>(state_->size)};
+}
+
+VkDeviceSize ReadbackHandle::GetSize() const
+{
+    return state_ ? state_->size : 0;
+}
+
+ReadbackManager::ReadbackManager(const VmaAllocator& allocator)
+    : allocator_(&allocator) {}
+
+ReadbackManager::~ReadbackManager()
+{
+    Detach();
+}
+
+ReadbackHandle ReadbackManager::ReadBuffer(const CommandBuffer& command_buffer,
+                                           const Buffer& src_buffer,
+                                           VkDeviceSize size,
+                                           VkDeviceSize src_offset)
+{
+    if (src_offset >= src_buffer.GetSize()) {
+        throw std::out_of_range("Readback offset exceeds buffer size");
+    }
+    const VkDeviceSize copy_size = (size == VK_WHOLE_SIZE) ? src_buffer.GetSize() - src_offset : size;
+    if (copy_size == 0 || src_offset + copy_size > src_buffer.GetSize()) {
+        throw std::out_of_range("Readback range exceeds buffer size");
+    }
+
+    std::shared_ptr<ReadbackHandle::State> state = CreateState(copy_size);
+
+    VkBufferCopy region{};
+    region.srcOffset = src_offset;
+    region.dstOffset = 0;
+    region.size = copy_size;
+    vkCmdCopyBuffer(command_buffer.GetHandle(), src_buffer.GetHandle(), state->buffer.GetHandle(), 1, &region);
+    MakeHostVisible(command_buffer);
+
+    return ReadbackHandle(std::move(state));
+}
+
+ReadbackHandle ReadbackManager::ReadImage(const CommandBuffer& command_buffer,
+                                          const Image& src_image,
+                                          const VkBufferImageCopy& region)
+{
+    if (Utils::FormatUtils::IsCompressedFormat(src_image.GetFormat())) {
+        throw std::invalid_argument("Image readback does not support compressed formats");
+    }
+    const VkImageAspectFlags aspect = region.imageSubresource.aspectMask;
+    if (aspect == (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT)) {
+        throw std::invalid_argument("Image readback copies one aspect at a time");
+    }
+
+    // Pack rows tightly unless the caller asked for a specific row pitch
+    const VkDeviceSize row_length = region.bufferRowLength != 0 ? region.bufferRowLength : region.imageExtent.width;
+    const VkDeviceSize image_height = region.bufferImageHeight != 0 ? region.bufferImageHeight : region.imageExtent.height;
+    const VkDeviceSize size = row_length * image_height * std::max(1u, region.imageExtent.depth) *
+                              std::max(1u, region.imageSubresource.layerCount) *
+                              Utils::FormatUtils::GetAspectCopySize(src_image.GetFormat(), aspect);
+    if (size == 0) {
+        throw std::invalid_argument("Image readback region is empty");
+    }
+
+    std::shared_ptr<ReadbackHandle::State> state = CreateState(size);
+
+    VkBufferImageCopy staged_region = region;
+    staged_region.bufferOffset = 0;
+    src_image.CopyToBuffer(command_buffer, state->buffer.GetHandle(), {staged_region});
+    MakeHostVisible(command_buffer);
+
+    return ReadbackHandle(std::move(state));
+}
+
+void ReadbackManager::MarkSubmitted(const Fence& fence)
+{
+    for (auto& state : outstanding_) {
+        if (state->tracking == ReadbackHandle::Tracking::PENDING) {
+            state->tracking = ReadbackHandle::Tracking::FENCE;
+            state->fence = fence.GetHandle();
+        }
+    }
+}
+
+void ReadbackManager::MarkSubmitted(const Semaphore& timeline, uint64_t value)
+{
+    if (!timeline.IsTimelineSemaphore()) {
+        throw std::invalid_argument("Readback tracking requires a timeline semaphore");
+    }
+    for (auto& state : outstanding_) {
+        if (state->tracking == ReadbackHandle::Tracking::PENDING) {
+            state->tracking = ReadbackHandle::Tracking::TIMELINE;
+            state->timeline = timeline.GetHandle();
+            state->timelineValue = value;
+        }
+    }
+}
+
+void ReadbackManager::AttachToRenderer(Renderer& renderer)
+{
+    Detach();
+    renderer_ = &renderer;
+    frameBeginSubscription_ = renderer.SubscribeFrameBegin([this](uint32_t frame_index) {
+        OnFrameBegin(frame_index);
+    });
+}
+
+void ReadbackManager::Detach()
+{
+    frameBeginSubscription_.Reset();
+    renderer_ = nullptr;
+}
+
+void ReadbackManager::Collect()
+{
+    // Completed readbacks live on in their handles; released ones in flight stay until the GPU is done
+    std::erase_if(outstanding_, [](const std::shared_ptr<ReadbackHandle::State>& state) {
+        return ReadbackHandle(state).IsReady();
+    });
+}
+
+std::shared_ptr<ReadbackHandle::State> ReadbackManager::CreateState(VkDeviceSize size)
+{
+    auto state = std::make_shared<ReadbackHandle::State>(ReadbackHandle::State{
+        Buffer(*allocator_,
+               size,
+               VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+               VMA_MEMORY_USAGE_AUTO_PREFER_HOST,
+               VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+               "Readback"),
+        size});
+    state->device = allocator_->GetDevice();
+
+    if (renderer_ && renderer_->IsFrameInProgress()) {
+        state->tracking = ReadbackHandle::Tracking::FRAME;
+        state->frameIndex = renderer_->GetCurrentFrameIndex();
+    }
+    outstanding_.push_back(state);
+    return state;
+}
+
+void ReadbackManager::MakeHostVisible(const CommandBuffer& command_buffer)
+{
+    VkMemoryBarrier2KHR barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER_2_KHR};
+    barrier.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR;
+    barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR;
+    barrier.dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT_KHR;
+    barrier.dstAccessMask = VK_ACCESS_2_HOST_READ_BIT_KHR;
+    command_buffer.PipelineBarrier2(std::span<const VkMemoryBarrier2KHR>(&barrier, 1));
+}
+
+void ReadbackManager::OnFrameBegin(uint32_t frame_index)
+{
+    // The frame's fence has been waited on, so its earlier submission is complete
+    for (auto& state : outstanding_) {
+        if (state->tracking == ReadbackHandle::Tracking::FRAME && state->frameIndex == frame_index && !state->ready) {
+            state->Complete();
+        }
+    }
+    Collect();
+}
+
+} // namespace VulkanEngine::RAII
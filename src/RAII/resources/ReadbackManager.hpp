@@ -0,0 +1,135 @@
+#ifndef VULKAN_RAII_RESOURCES_READBACK_MANAGER_HPP
+#define VULKAN_RAII_RESOURCES_READBACK_MANAGER_HPP
+
+#include <volk.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "../rendering/FrameBeginSubscription.hpp"
+#include "Buffer.hpp"
+
+namespace VulkanEngine::RAII {
+
+class VmaAllocator; // Forward declaration
+class Image; // Forward declaration
+class CommandBuffer; // Forward declaration
+class Fence; // Forward declaration
+class Semaphore; // Forward declaration
+class Renderer; // Forward declaration
+
+// Future-like handle to a GPU -> CPU copy. Once ready the host-cached readback
+// memory is invalidated and exposed in place through GetData().
+class ReadbackHandle {
+public:
+    ReadbackHandle() = default;
+
+    [[nodiscard]] bool IsValid() const { return state_ != nullptr; }
+
+    // Non-blocking completion check (invalidates the memory on first success)
+    [[nodiscard]] bool IsReady() const;
+
+    // Block until ready. Renderer-tracked readbacks cannot block and only re-check
+    [[nodiscard]] bool Wait(uint64_t timeout = UINT64_MAX) const;
+
+    // Read bytes in place; throws if the readback is not ready yet
+    [[nodiscard]] std::span<const std::byte> GetData() const;
+
+    [[nodiscard]] VkDeviceSize GetSize() const;
+
+private:
+    friend class ReadbackManager;
+
+    enum class Tracking {
+        PENDING,
+        FENCE,
+        TIMELINE,
+        FRAME
+    };
+
+    struct State {
+        Buffer buffer;
+        VkDeviceSize size{0};
+        Tracking tracking{Tracking::PENDING};
+        VkDevice device{VK_NULL_HANDLE};
+        VkFence fence{VK_NULL_HANDLE};
+        VkSemaphore timeline{VK_NULL_HANDLE};
+        uint64_t timelineValue{0};
+        uint32_t frameIndex{0};
+        bool ready{false};
+
+        void Complete();
+    };
+
+    explicit ReadbackHandle(std::shared_ptr<State> state) : state_(std::move(state)) {}
+
+    std::shared_ptr<State> state_;
+};
+
+// Records GPU -> CPU copies into host-cached buffers without stalling the
+// requesting frame. Readbacks are recorded into the caller's command buffer and
+// complete a few frames later, tracked either by the fence or timeline value of
+// the submission (MarkSubmitted) or, when attached, by the renderer's frame pacing.
+// Not thread-safe: record readbacks from one thread or guard externally.
+class ReadbackManager {
+public:
+    // Constructor
+    explicit ReadbackManager(const VmaAllocator& allocator);
+
+    // Destructor (outstanding readbacks must no longer be in flight)
+    ~ReadbackManager();
+
+    // Delete copy and move. the attached renderer holds a callback referencing this object.
+    ReadbackManager(const ReadbackManager&) = delete;
+    ReadbackManager& operator=(const ReadbackManager&) = delete;
+    ReadbackManager(ReadbackManager&&) = delete;
+    ReadbackManager& operator=(ReadbackManager&&) = delete;
+
+    // Record a buffer -> host copy. The source must be readable by transfer when the command executes
+    ReadbackHandle ReadBuffer(const CommandBuffer& command_buffer,
+                              const Buffer& src_buffer,
+                              VkDeviceSize size = VK_WHOLE_SIZE,
+                              VkDeviceSize src_offset = 0);
+
+    // Record an image -> host copy of a tightly packed region.
+    // The image must be in VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL when the command executes
+    ReadbackHandle ReadImage(const CommandBuffer& command_buffer,
+                             const Image& src_image,
+                             const VkBufferImageCopy& region);
+
+    // Tie every readback recorded since the last call to a submission.
+    // The fence must not be reset before the readbacks have been collected
+    void MarkSubmitted(const Fence& fence);
+    void MarkSubmitted(const Semaphore& timeline, uint64_t value);
+
+    // Track readbacks recorded during a renderer frame by its frame-in-flight index;
+    // they complete when that index begins again. The renderer must outlive
+    // this manager or Detach() must be called first
+    void AttachToRenderer(Renderer& renderer);
+    void Detach();
+
+    // Poll tracked readbacks and stop tracking the completed ones
+    void Collect();
+
+    [[nodiscard]] size_t GetOutstandingCount() const { return outstanding_.size(); }
+
+private:
+    const VmaAllocator* allocator_{nullptr};
+    std::vector<std::shared_ptr<ReadbackHandle::State>> outstanding_;
+
+    Renderer* renderer_{nullptr};
+    FrameBeginSubscription frameBeginSubscription_;
+
+    std::shared_ptr<ReadbackHandle::State> CreateState(VkDeviceSize size);
+    // Make the recorded copies available to host reads once the submission completes
+    static void MakeHostVisible(const CommandBuffer& command_buffer);
+    void OnFrameBegin(uint32_t frame_index);
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RESOURCES_READBACK_MANAGER_HPP
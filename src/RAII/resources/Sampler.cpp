@@ -1,6 +1,8 @@
 #include "Sampler.hpp"
 
 #include "../core/Device.hpp"
+#include "../utils/HostAllocator.hpp"
+#include <cstdint>
 #include <stdexcept>
 
 
@@ -160,7 +162,7 @@ Sampler Sampler::CreateClampToBorder(const Device& device, VkBorderColor border_
 }
 
 void Sampler::CreateSampler(const VkSamplerCreateInfo& create_info) {
-    if (vkCreateSampler(device_, &create_info, nullptr, &sampler_) != VK_SUCCESS) {
+    if (vkCreateSampler(device_, &create_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_SAMPLER), &sampler_) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create sampler");
     }
 }
@@ -168,7 +170,7 @@ void Sampler::CreateSampler(const VkSamplerCreateInfo& create_info) {
 void Sampler::Cleanup()
 {
     if (sampler_ != VK_NULL_HANDLE) {
-        vkDestroySampler(device_, sampler_, nullptr);
+        vkDestroySampler(device_, sampler_, Utils::HostAllocator::For(VK_OBJECT_TYPE_SAMPLER));
         sampler_ = VK_NULL_HANDLE;
     }
 }
@@ -0,0 +1,145 @@
+#include "SamplerCache.hpp"
+
+#include "../core/Device.hpp"
+#include "../core/PhysicalDevice.hpp"
+#include "../utils/HashUtils.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+
+namespace VulkanEngine::RAII {
+
+namespace {
+bool UsesBorderColor(const VkSamplerCreateInfo& create_info)
+{
+    return create_info.addressModeU == VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER ||
+           create_info.addressModeV == VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER ||
+           create_info.addressModeW == VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+}
+} // namespace
+
+SamplerCache::SamplerCache(const Device& device)
+    : device_(&device)
+{
+    const VkPhysicalDeviceProperties& properties = device.GetPhysicalDevice().GetProperties();
+    maxAnisotropy_ = properties.limits.maxSamplerAnisotropy;
+    maxSamplerAllocationCount_ = properties.limits.maxSamplerAllocationCount;
+}
+
+std::shared_ptr<const Sampler> SamplerCache::GetSampler(const VkSamplerCreateInfo& create_info)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return GetSamplerLocked(create_info);
+}
+
+const VkSampler* SamplerCache::GetImmutableSamplers(const VkSamplerCreateInfo& create_info, uint32_t count)
+{
+    if (count == 0) {
+        throw std::invalid_argument("Immutable sampler arrays require at least one sampler");
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    const VkSampler sampler = GetSamplerLocked(create_info)->GetHandle();
+    for (const std::vector<VkSampler>& samplers : immutableSamplers_) {
+        if (samplers.size() == count && samplers.front() == sampler) {
+            return samplers.data();
+        }
+    }
+    immutableSamplers_.emplace_back(count, sampler);
+    return immutableSamplers_.back().data();
+}
+
+VkDescriptorSetLayoutBinding SamplerCache::MakeImmutableSamplerBinding(uint32_t binding,
+                                                                       VkDescriptorType descriptor_type,
+                                                                       VkShaderStageFlags stage_flags,
+                                                                       const VkSamplerCreateInfo& create_info,
+                                                                       uint32_t descriptor_count)
+{
+    if (descriptor_type != VK_DESCRIPTOR_TYPE_SAMPLER && descriptor_type != VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER) {
+        throw std::invalid_argument("Immutable samplers require a SAMPLER or COMBINED_IMAGE_SAMPLER binding");
+    }
+    VkDescriptorSetLayoutBinding layout_binding{};
+    layout_binding.binding = binding;
+    layout_binding.descriptorType = descriptor_type;
+    layout_binding.descriptorCount = descriptor_count;
+    layout_binding.stageFlags = stage_flags;
+    layout_binding.pImmutableSamplers = GetImmutableSamplers(create_info, descriptor_count);
+    return layout_binding;
+}
+
+size_t SamplerCache::GetSamplerCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return samplers_.size();
+}
+
+VkSamplerCreateInfo SamplerCache::Normalize(const VkSamplerCreateInfo& create_info) const
+{
+    VkSamplerCreateInfo normalized = create_info;
+    if (normalized.anisotropyEnable == VK_FALSE) {
+        normalized.maxAnisotropy = 1.0f;
+    } else {
+        normalized.maxAnisotropy = std::clamp(normalized.maxAnisotropy, 1.0f, maxAnisotropy_);
+    }
+    if (normalized.compareEnable == VK_FALSE) {
+        normalized.compareOp = VK_COMPARE_OP_NEVER;
+    }
+    if (!UsesBorderColor(normalized)) {
+        normalized.borderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+    }
+    return normalized;
+}
+
+std::shared_ptr<const Sampler> SamplerCache::GetSamplerLocked(const VkSamplerCreateInfo& create_info)
+{
+    if (create_info.pNext != nullptr) {
+        throw std::invalid_argument("SamplerCache does not support chained sampler create info");
+    }
+    const VkSamplerCreateInfo normalized = Normalize(create_info);
+    const SamplerKey key = MakeKey(normalized);
+
+    auto it = samplers_.find(key);
+    if (it == samplers_.end()) {
+        it = samplers_.emplace(key, std::make_shared<const Sampler>(*device_, normalized)).first;
+        if (!warnedAllocationLimit_ && samplers_.size() > maxSamplerAllocationCount_ / 2) {
+            warnedAllocationLimit_ = true;
+            std::cerr << "[SamplerCache] " << samplers_.size() << " distinct samplers, over half of maxSamplerAllocationCount ("
+                      << maxSamplerAllocationCount_ << ")" << '\n';
+        }
+    }
+    return it->second;
+}
+
+SamplerCache::SamplerKey SamplerCache::MakeKey(const VkSamplerCreateInfo& create_info)
+{
+    return SamplerKey{
+        create_info.flags,
+        static_cast<uint32_t>(create_info.magFilter),
+        static_cast<uint32_t>(create_info.minFilter),
+        static_cast<uint32_t>(create_info.mipmapMode),
+        static_cast<uint32_t>(create_info.addressModeU),
+        static_cast<uint32_t>(create_info.addressModeV),
+        static_cast<uint32_t>(create_info.addressModeW),
+        std::bit_cast<uint32_t>(create_info.mipLodBias),
+        create_info.anisotropyEnable,
+        std::bit_cast<uint32_t>(create_info.maxAnisotropy),
+        create_info.compareEnable,
+        static_cast<uint32_t>(create_info.compareOp),
+        std::bit_cast<uint32_t>(create_info.minLod),
+        std::bit_cast<uint32_t>(create_info.maxLod),
+        static_cast<uint32_t>(create_info.borderColor),
+        create_info.unnormalizedCoordinates
+    };
+}
+
+size_t SamplerCache::SamplerKeyHash::operator()(const SamplerKey& key) const
+{
+    return static_cast<size_t>(Utils::HashFnv1a(key.data(), key.size()));
+}
+
+} // namespace VulkanEngine::RAII
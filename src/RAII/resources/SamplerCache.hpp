@@ -0,0 +1,82 @@
+#ifndef VULKAN_RAII_RESOURCES_SAMPLER_CACHE_HPP
+#define VULKAN_RAII_RESOURCES_SAMPLER_CACHE_HPP
+
+#include <volk.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "Sampler.hpp"
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+
+// Shares one Sampler per distinct VkSamplerCreateInfo, so materials asking for
+// the same filtering do not each create a sampler (drivers cap the live count
+// at maxSamplerAllocationCount). Fields that Vulkan ignores for a given info
+// (maxAnisotropy without anisotropy, compareOp without compare, borderColor
+// without a border address mode) are normalized before hashing, and
+// maxAnisotropy is clamped to the device limit.
+// Samplers live as long as the cache, so their handles can be baked into set
+// layouts as immutable samplers (see MakeImmutableSamplerBinding). Thread-safe.
+class SamplerCache {
+public:
+    // Constructor
+    explicit SamplerCache(const Device& device);
+
+    // Delete copy and move. returned samplers and immutable sampler arrays are owned by this object.
+    SamplerCache(const SamplerCache&) = delete;
+    SamplerCache& operator=(const SamplerCache&) = delete;
+    SamplerCache(SamplerCache&&) = delete;
+    SamplerCache& operator=(SamplerCache&&) = delete;
+
+    // Shared sampler for create_info; chained structures (pNext) are not supported
+    std::shared_ptr<const Sampler> GetSampler(const VkSamplerCreateInfo& create_info);
+
+    // Stable array of count copies of the sampler's handle, valid for the lifetime of the cache
+    const VkSampler* GetImmutableSamplers(const VkSamplerCreateInfo& create_info, uint32_t count = 1);
+
+    // Binding with the sampler baked in as immutable: descriptor writes for it
+    // then skip the sampler (SAMPLER bindings need no writes at all).
+    // descriptor_type must be SAMPLER or COMBINED_IMAGE_SAMPLER
+    VkDescriptorSetLayoutBinding MakeImmutableSamplerBinding(uint32_t binding,
+                                                             VkDescriptorType descriptor_type,
+                                                             VkShaderStageFlags stage_flags,
+                                                             const VkSamplerCreateInfo& create_info,
+                                                             uint32_t descriptor_count = 1);
+
+    // Number of distinct samplers created
+    [[nodiscard]] size_t GetSamplerCount() const;
+
+    // Normalized copy of create_info as used for lookup and creation
+    [[nodiscard]] VkSamplerCreateInfo Normalize(const VkSamplerCreateInfo& create_info) const;
+
+private:
+    static constexpr size_t KEY_SIZE = 16;
+    using SamplerKey = std::array<uint32_t, KEY_SIZE>;
+
+    struct SamplerKeyHash {
+        size_t operator()(const SamplerKey& key) const;
+    };
+
+    const Device* device_{nullptr};
+    float maxAnisotropy_{1.0f};
+    uint32_t maxSamplerAllocationCount_{0};
+    mutable std::mutex mutex_;
+    std::unordered_map<SamplerKey, std::shared_ptr<const Sampler>, SamplerKeyHash> samplers_;
+    std::deque<std::vector<VkSampler>> immutableSamplers_; // Deque keeps earlier arrays in place
+    bool warnedAllocationLimit_{false};
+
+    std::shared_ptr<const Sampler> GetSamplerLocked(const VkSamplerCreateInfo& create_info);
+    static SamplerKey MakeKey(const VkSamplerCreateInfo& create_info);
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RESOURCES_SAMPLER_CACHE_HPP
@@ -1,6 +1,7 @@
 #include "Shader.hpp"
 
 #include "../core/Device.hpp"
+#include "../utils/HostAllocator.hpp"
 
 #include <algorithm>
 #include <cctype>
@@ -8,8 +9,11 @@
 #include <cstdint>
 #include <fstream>
 #include <ios>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <filesystem>
@@ -17,6 +21,43 @@
 
 namespace VulkanEngine::RAII {
 
+namespace {
+std::mutex& ReflectionCacheMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+// Reflections shared by Shaders built from the same code; an entry lives while one of them does
+struct ReflectionCacheEntry {
+    std::vector<uint32_t> code;
+    std::weak_ptr<const Shader::ReflectionInfo> reflection;
+};
+
+std::unordered_map<uint64_t, std::vector<ReflectionCacheEntry>>& ReflectionCache()
+{
+    static std::unordered_map<uint64_t, std::vector<ReflectionCacheEntry>> cache;
+    return cache;
+}
+
+// A hash hit only counts when the code matches word for word. ReflectionCacheMutex held
+std::shared_ptr<const Shader::ReflectionInfo> FindOrReflectLocked(uint64_t hash, const uint32_t* code, size_t word_count)
+{
+    std::vector<ReflectionCacheEntry>& bucket = ReflectionCache()[hash];
+    std::erase_if(bucket, [](const ReflectionCacheEntry& entry) { return entry.reflection.expired(); });
+    for (const ReflectionCacheEntry& entry : bucket) {
+        if (entry.code.size() == word_count && std::equal(entry.code.begin(), entry.code.end(), code)) {
+            if (std::shared_ptr<const Shader::ReflectionInfo> reflection = entry.reflection.lock()) {
+                return reflection;
+            }
+        }
+    }
+    auto reflection = std::make_shared<const Shader::ReflectionInfo>(Utils::SpirvUtils::Reflect(code, word_count));
+    bucket.push_back(ReflectionCacheEntry{std::vector<uint32_t>(code, code + word_count), reflection});
+    return reflection;
+}
+} // namespace
+
 Shader::Shader(const Device& device, const std::vector<uint32_t>& spirv_code)
     : device_(device.GetHandle()),
     spirvCode_(spirv_code)
@@ -24,10 +65,11 @@ Shader::Shader(const Device& device, const std::vector<uint32_t>& spirv_code)
     if (device == VK_NULL_HANDLE) {
         throw std::invalid_argument("Shader requires a valid device");
     }
-    if (!ValidateSpirV(spirvCode_)) {
+    if (!ValidateSpirV(spirvCode_.data(), spirvCode_.size())) {
         throw std::invalid_argument("Invalid SPIR-V code");
     }
-    CreateShaderModule(spirvCode_);
+    codeHash_ = Utils::SpirvUtils::HashCode(spirvCode_.data(), spirvCode_.size());
+    CreateShaderModule(spirvCode_.data(), spirvCode_.size());
 }
 
 Shader::Shader(const Device& device, const std::string& filename)
@@ -37,10 +79,31 @@ Shader::Shader(const Device& device, const std::string& filename)
     if (device == VK_NULL_HANDLE) {
         throw std::invalid_argument("Shader requires a valid device");
     }
-    if (!ValidateSpirV(spirvCode_)) {
+    if (!ValidateSpirV(spirvCode_.data(), spirvCode_.size())) {
         throw std::invalid_argument("Invalid SPIR-V file");
     }
-    CreateShaderModule(spirvCode_);
+    codeHash_ = Utils::SpirvUtils::HashCode(spirvCode_.data(), spirvCode_.size());
+    CreateShaderModule(spirvCode_.data(), spirvCode_.size());
+}
+
+Shader::Shader(const Device& device, const uint32_t* code, size_t word_count, bool keep_code)
+    : device_(device.GetHandle())
+{
+    if (device == VK_NULL_HANDLE) {
+        throw std::invalid_argument("Shader requires a valid device");
+    }
+    if (!ValidateSpirV(code, word_count)) {
+        throw std::invalid_argument("Invalid SPIR-V code");
+    }
+    codeHash_ = Utils::SpirvUtils::HashCode(code, word_count);
+    if (keep_code) {
+        spirvCode_.assign(code, code + word_count);
+    } else {
+        // Reflect while the code is still reachable
+        std::lock_guard<std::mutex> lock(ReflectionCacheMutex());
+        reflection_ = FindOrReflectLocked(codeHash_, code, word_count);
+    }
+    CreateShaderModule(code, word_count);
 }
 
 Shader::~Shader() {
@@ -50,7 +113,9 @@ Shader::~Shader() {
 Shader::Shader(Shader&& other) noexcept
     : shaderModule_(other.shaderModule_),
     device_(other.device_),
-    spirvCode_(std::move(other.spirvCode_))
+    spirvCode_(std::move(other.spirvCode_)),
+    codeHash_(other.codeHash_),
+    reflection_(std::move(other.reflection_))
 {
     other.shaderModule_ = VK_NULL_HANDLE;
     other.device_ = VK_NULL_HANDLE;
@@ -62,6 +127,8 @@ Shader& Shader::operator=(Shader&& other) noexcept {
         shaderModule_ = other.shaderModule_;
         device_ = other.device_;
         spirvCode_ = std::move(other.spirvCode_);
+        codeHash_ = other.codeHash_;
+        reflection_ = std::move(other.reflection_);
 
         other.shaderModule_ = VK_NULL_HANDLE;
         other.device_ = VK_NULL_HANDLE;
@@ -107,19 +174,33 @@ std::vector<uint32_t> Shader::CompileGlslToSpirV(const std::string& /*source*/,
     throw std::runtime_error("GLSL to SPIR-V compilation is not available. Provide precompiled SPIR-V (" + filename + ")");
 }
 
-Shader::ReflectionInfo Shader::Reflect() const {
-    // Reflection requires additional dependencies (e.g., SPIRV-Reflect).
-    // For now, return empty reflection info.
-    return {};
+const Shader::ReflectionInfo& Shader::Reflect() const {
+    std::lock_guard<std::mutex> lock(ReflectionCacheMutex());
+    if (!reflection_) {
+        if (spirvCode_.empty()) {
+            throw std::runtime_error("Shader code was released before reflection");
+        }
+        reflection_ = FindOrReflectLocked(codeHash_, spirvCode_.data(), spirvCode_.size());
+    }
+    return *reflection_;
+}
+
+void Shader::ReleaseCode()
+{
+    if (spirvCode_.empty()) {
+        return;
+    }
+    (void)Reflect();
+    std::vector<uint32_t>().swap(spirvCode_);
 }
 
-void Shader::CreateShaderModule(const std::vector<uint32_t>& code)
+void Shader::CreateShaderModule(const uint32_t* code, size_t word_count)
 {
     VkShaderModuleCreateInfo create_info{VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
-    create_info.codeSize = code.size() * sizeof(uint32_t);
-    create_info.pCode = code.data();
+    create_info.codeSize = word_count * sizeof(uint32_t);
+    create_info.pCode = code;
 
-    if (vkCreateShaderModule(device_, &create_info, nullptr, &shaderModule_) != VK_SUCCESS) {
+    if (vkCreateShaderModule(device_, &create_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_SHADER_MODULE), &shaderModule_) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create shader module");
     }
 }
@@ -127,15 +208,15 @@ void Shader::CreateShaderModule(const std::vector<uint32_t>& code)
 void Shader::Cleanup()
 {
     if (shaderModule_ != VK_NULL_HANDLE) {
-        vkDestroyShaderModule(device_, shaderModule_, nullptr);
+        vkDestroyShaderModule(device_, shaderModule_, Utils::HostAllocator::For(VK_OBJECT_TYPE_SHADER_MODULE));
         shaderModule_ = VK_NULL_HANDLE;
     }
     device_ = VK_NULL_HANDLE;
 }
 
-bool Shader::ValidateSpirV(const std::vector<uint32_t>& spirv_code)
+bool Shader::ValidateSpirV(const uint32_t* code, size_t word_count)
 {
-    return !spirv_code.empty();
+    return code != nullptr && word_count >= 5 && code[0] == 0x07230203;
 }
 VkShaderStageFlagBits Shader::InferStageFromFilename(const std::string& filename)
 {
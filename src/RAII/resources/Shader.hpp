@@ -2,9 +2,13 @@
 #define VULKAN_RAII_RESOURCES_SHADER_HPP
 
 #include <volk.h>
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <string>
 
+#include "../utils/SpirvUtils.hpp"
+
 
 namespace VulkanEngine::RAII {
 
@@ -20,6 +24,13 @@ public:
     Shader(const Device& device, 
            const std::string& filename);
 
+    // Constructor that creates a shader module from SPIR-V in caller-owned memory (e.g. a mapped file).
+    // The code is copied only when keep_code is set
+    Shader(const Device& device,
+           const uint32_t* code,
+           size_t word_count,
+           bool keep_code = true);
+
     // Destructor
     ~Shader();
 
@@ -42,9 +53,15 @@ public:
     // Get SPIR-V code
     [[nodiscard]] const std::vector<uint32_t>& GetSpirVCode() const { return spirvCode_; }
 
-    // Get code size in bytes
+    // Get code size in bytes (0 once the code has been released)
     [[nodiscard]] size_t GetCodeSize() const { return spirvCode_.size() * sizeof(uint32_t); }
 
+    // Check if the CPU-side copy of the code is still held
+    [[nodiscard]] bool HasCode() const { return !spirvCode_.empty(); }
+
+    // Drop the CPU-side copy of the code. Reflection is cached first, so Reflect() keeps working
+    void ReleaseCode();
+
     // Create pipeline shader stage info
     VkPipelineShaderStageCreateInfo CreateStageInfo(VkShaderStageFlagBits stage,
                                                     const char* entry_point = "main",
@@ -56,27 +73,30 @@ public:
                                                     VkShaderStageFlagBits stage,
                                                     const std::string& filename = "shader");
 
-    // Reflect shader information (requires SPIRV-Reflect or similar)
-    struct ReflectionInfo {
-        std::vector<VkDescriptorSetLayoutBinding> descriptorSetBindings;
-        std::vector<VkPushConstantRange> pushConstantRanges;
-        std::vector<VkVertexInputAttributeDescription> inputAttributes;
-        std::vector<VkVertexInputBindingDescription> inputBindings;
-    };
+    // Reflected descriptor bindings, push constants, vertex inputs and workgroup size
+    using ReflectionInfo = Utils::SpirvReflection;
+
+    // Reflect the module's first entry point. Results are shared by content, so
+    // reflecting the same SPIR-V again (from any live Shader) is a lookup; the
+    // reference stays valid as long as this Shader
+    [[nodiscard]] const ReflectionInfo& Reflect() const;
 
-    [[nodiscard]] ReflectionInfo Reflect() const;
+    // Hash of the SPIR-V code
+    [[nodiscard]] uint64_t GetCodeHash() const { return codeHash_; }
 
 private:
     VkShaderModule shaderModule_{VK_NULL_HANDLE};
     VkDevice device_{VK_NULL_HANDLE}; // Reference to device
     std::vector<uint32_t> spirvCode_;
+    uint64_t codeHash_{0};
+    mutable std::shared_ptr<const ReflectionInfo> reflection_; // Set on first Reflect(), under the cache mutex
 
     // Helper methods
-    void CreateShaderModule(const std::vector<uint32_t>& code);
+    void CreateShaderModule(const uint32_t* code, size_t word_count);
     void Cleanup();
     
     // Validation helpers
-    static bool ValidateSpirV(const std::vector<uint32_t>& spirv_code);
+    static bool ValidateSpirV(const uint32_t* code, size_t word_count);
     static VkShaderStageFlagBits InferStageFromFilename(const std::string& filename);
 };
 
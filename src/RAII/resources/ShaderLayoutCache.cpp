@@ -0,0 +1,252 @@
+#include "ShaderLayoutCache.hpp"
+
+#include "../core/Device.hpp"
+#include "../utils/HashUtils.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+namespace VulkanEngine::RAII {
+
+ShaderLayoutCache::ShaderLayoutCache(const Device& device, uint32_t runtime_array_count)
+    : device_(&device),
+    runtimeArrayCount_(runtime_array_count)
+{
+    if (runtime_array_count == 0) {
+        throw std::invalid_argument("Runtime descriptor arrays need a non-zero descriptor count");
+    }
+}
+
+ReflectedLayout ShaderLayoutCache::GetLayout(const std::vector<const Shader*>& stages)
+{
+    std::vector<const Shader::ReflectionInfo*> reflections;
+    reflections.reserve(stages.size());
+    for (const Shader* stage : stages) {
+        if (stage == nullptr) {
+            throw std::invalid_argument("Layout reflection requires valid shaders");
+        }
+        reflections.push_back(&stage->Reflect());
+    }
+
+    ReflectedLayout layout{};
+    layout.reflection = Utils::SpirvUtils::Merge(reflections);
+
+    uint32_t set_count = 0;
+    for (const auto& binding : layout.reflection.descriptorBindings) {
+        set_count = std::max(set_count, binding.set + 1);
+    }
+    std::vector<std::vector<VkDescriptorSetLayoutBinding>> set_bindings(set_count);
+    std::vector<std::vector<VkDescriptorBindingFlags>> set_binding_flags(set_count);
+    std::vector<bool> set_has_flags(set_count, false);
+    for (auto& binding : layout.reflection.descriptorBindings) {
+        if (binding.IsRuntimeArray()) {
+            binding.layoutBinding.descriptorCount = runtimeArrayCount_;
+            set_has_flags[binding.set] = true;
+        }
+        set_bindings[binding.set].push_back(binding.layoutBinding);
+        set_binding_flags[binding.set].push_back(binding.bindingFlags);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (uint32_t set = 0; set < set_count; ++set) {
+        if (!set_has_flags[set]) {
+            layout.setLayouts.push_back(GetSetLayoutLocked(set_bindings[set], 0, {}));
+            continue;
+        }
+        // Only the highest binding of a set may have a variable count (bindings are sorted)
+        std::vector<VkDescriptorBindingFlags>& flags = set_binding_flags[set];
+        for (size_t i = 0; i + 1 < flags.size(); ++i) {
+            flags[i] &= ~VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT;
+        }
+        layout.setLayouts.push_back(GetSetLayoutLocked(set_bindings[set], 0, flags));
+    }
+    layout.pipelineLayout = GetPipelineLayoutLocked(layout.setLayouts, layout.reflection.pushConstantRanges);
+    layout.layoutHash = HashLayout(layout.setLayouts, layout.reflection.pushConstantRanges);
+    return layout;
+}
+
+std::shared_ptr<const DescriptorSetLayout> ShaderLayoutCache::GetSetLayout(const std::vector<VkDescriptorSetLayoutBinding>& bindings,
+                                                                       VkDescriptorSetLayoutCreateFlags flags,
+                                                                       const std::vector<VkDescriptorBindingFlags>& binding_flags)
+{
+    if (!binding_flags.empty() && binding_flags.size() != bindings.size()) {
+        throw std::invalid_argument("Cached set layouts require one binding flags entry per binding");
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return GetSetLayoutLocked(bindings, flags, binding_flags);
+}
+
+std::shared_ptr<const PipelineLayout> ShaderLayoutCache::GetPipelineLayout(const std::vector<std::shared_ptr<const DescriptorSetLayout>>& set_layouts,
+                                                                      const std::vector<VkPushConstantRange>& push_constant_ranges)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return GetPipelineLayoutLocked(set_layouts, push_constant_ranges);
+}
+
+size_t ShaderLayoutCache::GetSetLayoutCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return setLayouts_.size();
+}
+
+size_t ShaderLayoutCache::GetPipelineLayoutCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pipelineLayouts_.size();
+}
+
+uint64_t ShaderLayoutCache::HashLayout(const std::vector<std::shared_ptr<const DescriptorSetLayout>>& set_layouts,
+                                       const std::vector<VkPushConstantRange>& push_constant_ranges)
+{
+    std::vector<uint32_t> words;
+    words.push_back(static_cast<uint32_t>(set_layouts.size()));
+    for (const std::shared_ptr<const DescriptorSetLayout>& set_layout : set_layouts) {
+        if (!set_layout) {
+            throw std::invalid_argument("Layout hashing requires valid set layouts");
+        }
+        const std::vector<VkDescriptorSetLayoutBinding>& bindings = set_layout->GetBindings();
+        const std::vector<VkDescriptorBindingFlags>& binding_flags = set_layout->GetBindingFlags();
+        std::vector<size_t> order(bindings.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [&bindings](size_t a, size_t b) {
+            return bindings[a].binding < bindings[b].binding;
+        });
+
+        words.push_back(set_layout->GetFlags());
+        words.push_back(static_cast<uint32_t>(bindings.size()));
+        for (size_t index : order) {
+            const VkDescriptorSetLayoutBinding& binding = bindings[index];
+            words.push_back(binding.binding);
+            words.push_back(static_cast<uint32_t>(binding.descriptorType));
+            words.push_back(binding.descriptorCount);
+            words.push_back(binding.stageFlags);
+            words.push_back(binding_flags.empty() ? 0 : binding_flags[index]);
+            // Immutable samplers have no contents to compare; their handles stand in
+            words.push_back(binding.pImmutableSamplers != nullptr ? binding.descriptorCount : 0);
+            if (binding.pImmutableSamplers != nullptr) {
+                for (uint32_t i = 0; i < binding.descriptorCount; ++i) {
+                    const uint64_t sampler = (uint64_t)binding.pImmutableSamplers[i];
+                    words.push_back(static_cast<uint32_t>(sampler));
+                    words.push_back(static_cast<uint32_t>(sampler >> 32));
+                }
+            }
+        }
+    }
+
+    std::vector<VkPushConstantRange> ranges = push_constant_ranges;
+    std::sort(ranges.begin(), ranges.end(), [](const VkPushConstantRange& a, const VkPushConstantRange& b) {
+        if (a.offset != b.offset) {
+            return a.offset < b.offset;
+        }
+        if (a.size != b.size) {
+            return a.size < b.size;
+        }
+        return a.stageFlags < b.stageFlags;
+    });
+    words.push_back(static_cast<uint32_t>(ranges.size()));
+    for (const VkPushConstantRange& range : ranges) {
+        words.push_back(range.stageFlags);
+        words.push_back(range.offset);
+        words.push_back(range.size);
+    }
+    return Utils::HashFnv1a(words.data(), words.size());
+}
+
+std::shared_ptr<const DescriptorSetLayout> ShaderLayoutCache::GetSetLayoutLocked(const std::vector<VkDescriptorSetLayoutBinding>& bindings,
+                                                                             VkDescriptorSetLayoutCreateFlags flags,
+                                                                             const std::vector<VkDescriptorBindingFlags>& binding_flags)
+{
+    // Sort through an index so binding flags stay paired with their binding
+    std::vector<size_t> order(bindings.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&bindings](size_t a, size_t b) {
+        return bindings[a].binding < bindings[b].binding;
+    });
+
+    std::vector<VkDescriptorSetLayoutBinding> sorted_bindings;
+    std::vector<VkDescriptorBindingFlags> sorted_flags;
+    sorted_bindings.reserve(bindings.size());
+    sorted_flags.reserve(binding_flags.size());
+
+    SetLayoutKey key;
+    key.reserve(1 + bindings.size() * 5);
+    key.push_back(flags);
+    for (size_t index : order) {
+        const VkDescriptorSetLayoutBinding& binding = bindings[index];
+        sorted_bindings.push_back(binding);
+        key.push_back(binding.binding);
+        key.push_back(static_cast<uint64_t>(binding.descriptorType));
+        key.push_back(binding.descriptorCount);
+        key.push_back(binding.stageFlags);
+        key.push_back(binding_flags.empty() ? 0 : binding_flags[index]);
+        if (!binding_flags.empty()) {
+            sorted_flags.push_back(binding_flags[index]);
+        }
+        // Immutable samplers are part of the layout; handles identify them
+        key.push_back(binding.pImmutableSamplers != nullptr ? binding.descriptorCount : 0);
+        if (binding.pImmutableSamplers != nullptr) {
+            for (uint32_t i = 0; i < binding.descriptorCount; ++i) {
+                key.push_back(Utils::HandleToUint64(binding.pImmutableSamplers[i]));
+            }
+        }
+    }
+
+    auto it = setLayouts_.find(key);
+    if (it == setLayouts_.end()) {
+        std::shared_ptr<const DescriptorSetLayout> layout = sorted_flags.empty()
+            ? std::make_shared<const DescriptorSetLayout>(*device_, sorted_bindings, flags)
+            : std::make_shared<const DescriptorSetLayout>(*device_, sorted_bindings, sorted_flags, flags);
+        it = setLayouts_.emplace(std::move(key), std::move(layout)).first;
+    }
+    return it->second;
+}
+
+std::shared_ptr<const PipelineLayout> ShaderLayoutCache::GetPipelineLayoutLocked(const std::vector<std::shared_ptr<const DescriptorSetLayout>>& set_layouts,
+                                                                            std::vector<VkPushConstantRange> push_constant_ranges)
+{
+    std::sort(push_constant_ranges.begin(), push_constant_ranges.end(), [](const VkPushConstantRange& a, const VkPushConstantRange& b) {
+        if (a.offset != b.offset) {
+            return a.offset < b.offset;
+        }
+        if (a.size != b.size) {
+            return a.size < b.size;
+        }
+        return a.stageFlags < b.stageFlags;
+    });
+
+    PipelineLayoutKey key;
+    std::vector<VkDescriptorSetLayout> set_handles;
+    key.reserve(1 + set_layouts.size() + push_constant_ranges.size() * 3);
+    set_handles.reserve(set_layouts.size());
+    key.push_back(set_layouts.size());
+    for (const std::shared_ptr<const DescriptorSetLayout>& set_layout : set_layouts) {
+        if (!set_layout || !set_layout->IsValid()) {
+            throw std::invalid_argument("Cached pipeline layouts require valid set layouts");
+        }
+        set_handles.push_back(set_layout->GetHandle());
+        // Pointer identity of a cached layout is its identity
+        key.push_back(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(set_layout.get())));
+    }
+    for (const VkPushConstantRange& range : push_constant_ranges) {
+        key.push_back(range.stageFlags);
+        key.push_back(range.offset);
+        key.push_back(range.size);
+    }
+
+    auto it = pipelineLayouts_.find(key);
+    if (it == pipelineLayouts_.end()) {
+        it = pipelineLayouts_.emplace(std::move(key), std::make_shared<const PipelineLayout>(
+            *device_, set_handles, push_constant_ranges)).first;
+    }
+    return it->second;
+}
+
+} // namespace VulkanEngine::RAII
@@ -0,0 +1,93 @@
+#ifndef VULKAN_RAII_RESOURCES_SHADER_LAYOUT_CACHE_HPP
+#define VULKAN_RAII_RESOURCES_SHADER_LAYOUT_CACHE_HPP
+
+#include <volk.h>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "DescriptorSetLayout.hpp"
+#include "PipelineLayout.hpp"
+#include "Shader.hpp"
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+
+// Layouts derived from the merged reflection of a set of stages
+struct ReflectedLayout {
+    std::vector<std::shared_ptr<const DescriptorSetLayout>> setLayouts; // Indexed by set number
+    std::shared_ptr<const PipelineLayout> pipelineLayout;
+    Shader::ReflectionInfo reflection;
+    uint64_t layoutHash{0}; // ShaderLayoutCache::HashLayout of the layouts, for pipeline descriptions
+};
+
+// Builds descriptor set and pipeline layouts from shader reflection and shares
+// them: two programs declaring the same bindings in a set get the same
+// VkDescriptorSetLayout, and the same sets plus push constants the same
+// VkPipelineLayout, so descriptor sets stay bound across pipeline switches.
+// Hand-written layouts go through GetSetLayout()/GetPipelineLayout() to be
+// canonicalized the same way; bindings and push constant ranges are compared
+// sorted, so declaration order does not split layouts.
+// Reflected runtime arrays (bindless tables) hold runtime_array_count descriptors
+// and are PARTIALLY_BOUND; the highest binding of a set is also
+// VARIABLE_DESCRIPTOR_COUNT, so sets can be allocated smaller.
+// Layouts live as long as the cache. Thread-safe.
+class ShaderLayoutCache {
+public:
+    // Constructor
+    explicit ShaderLayoutCache(const Device& device,
+                               uint32_t runtime_array_count = Utils::SpirvUtils::DEFAULT_RUNTIME_ARRAY_COUNT);
+
+    // Delete copy and move. returned layouts are owned by this object.
+    ShaderLayoutCache(const ShaderLayoutCache&) = delete;
+    ShaderLayoutCache& operator=(const ShaderLayoutCache&) = delete;
+    ShaderLayoutCache(ShaderLayoutCache&&) = delete;
+    ShaderLayoutCache& operator=(ShaderLayoutCache&&) = delete;
+
+    // Layouts for a program made of the given stages (gaps in set numbers get empty layouts)
+    ReflectedLayout GetLayout(const std::vector<const Shader*>& stages);
+
+    // Shared set layout for the given bindings (order does not matter).
+    // binding_flags is empty or holds one entry per binding; immutable samplers
+    // are matched by handle, so they must outlive the cache (see SamplerCache)
+    std::shared_ptr<const DescriptorSetLayout> GetSetLayout(const std::vector<VkDescriptorSetLayoutBinding>& bindings,
+                                                            VkDescriptorSetLayoutCreateFlags flags = 0,
+                                                            const std::vector<VkDescriptorBindingFlags>& binding_flags = {});
+
+    // Shared pipeline layout for set layouts obtained from this cache (order of
+    // push constant ranges does not matter)
+    std::shared_ptr<const PipelineLayout> GetPipelineLayout(const std::vector<std::shared_ptr<const DescriptorSetLayout>>& set_layouts,
+                                                            const std::vector<VkPushConstantRange>& push_constant_ranges = {});
+
+    // Stable hash of a pipeline layout's contents: the bindings, binding flags and create
+    // flags of each set and the push constant ranges (in any order). PipelineRegistry
+    // identifies layouts by it (GraphicsPipelineDescription::layoutHash)
+    [[nodiscard]] static uint64_t HashLayout(const std::vector<std::shared_ptr<const DescriptorSetLayout>>& set_layouts,
+                                             const std::vector<VkPushConstantRange>& push_constant_ranges = {});
+
+    [[nodiscard]] size_t GetSetLayoutCount() const;
+    [[nodiscard]] size_t GetPipelineLayoutCount() const;
+
+private:
+    using SetLayoutKey = std::vector<uint64_t>;
+    using PipelineLayoutKey = std::vector<uint64_t>;
+
+    const Device* device_{nullptr};
+    uint32_t runtimeArrayCount_{Utils::SpirvUtils::DEFAULT_RUNTIME_ARRAY_COUNT};
+    mutable std::mutex mutex_;
+    std::map<SetLayoutKey, std::shared_ptr<const DescriptorSetLayout>> setLayouts_;
+    std::map<PipelineLayoutKey, std::shared_ptr<const PipelineLayout>> pipelineLayouts_;
+
+    std::shared_ptr<const DescriptorSetLayout> GetSetLayoutLocked(const std::vector<VkDescriptorSetLayoutBinding>& bindings,
+                                                                  VkDescriptorSetLayoutCreateFlags flags,
+                                                                  const std::vector<VkDescriptorBindingFlags>& binding_flags);
+    std::shared_ptr<const PipelineLayout> GetPipelineLayoutLocked(const std::vector<std::shared_ptr<const DescriptorSetLayout>>& set_layouts,
+                                                                  std::vector<VkPushConstantRange> push_constant_ranges);
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RESOURCES_SHADER_LAYOUT_CACHE_HPP
@@ -0,0 +1,296 @@
+#include "ShaderLibrary.hpp"
+
+#include "../core/Device.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace VulkanEngine::RAII {
+
+namespace {
+constexpr char ARCHIVE_MAGIC[4] = {'S', 'P', 'V', 'A'};
+constexpr uint32_t ARCHIVE_VERSION = 1;
+
+template<typename T>
+T ReadValue(const uint8_t* data, size_t size, size_t& offset)
+{
+    if (offset > size || sizeof(T) > size - offset) {
+        throw std::runtime_error("Truncated shader archive");
+    }
+    T value{};
+    std::memcpy(&value, data + offset, sizeof(T));
+    offset += sizeof(T);
+    return value;
+}
+
+template<typename T>
+void WriteValue(std::ofstream& file, T value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+} // namespace
+
+class ShaderLibrary::MappedFile {
+public:
+    explicit MappedFile(const std::string& path)
+    {
+#if defined(_WIN32)
+        file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Failed to open file: " + path);
+        }
+        LARGE_INTEGER file_size{};
+        GetFileSizeEx(file_, &file_size);
+        size_ = static_cast<size_t>(file_size.QuadPart);
+        if (size_ > 0) {
+            mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            data_ = mapping_ ? MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0) : nullptr;
+            if (data_ == nullptr) {
+                Close();
+                throw std::runtime_error("Failed to map file: " + path);
+            }
+        }
+#else
+        fd_ = open(path.c_str(), O_RDONLY);
+        if (fd_ < 0) {
+            throw std::runtime_error("Failed to open file: " + path);
+        }
+        struct stat info{};
+        if (fstat(fd_, &info) != 0) {
+            Close();
+            throw std::runtime_error("Failed to stat file: " + path);
+        }
+        size_ = static_cast<size_t>(info.st_size);
+        if (size_ > 0) {
+            void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+            if (data == MAP_FAILED) {
+                Close();
+                throw std::runtime_error("Failed to map file: " + path);
+            }
+            data_ = data;
+        }
+#endif
+    }
+
+    ~MappedFile() { Close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&&) = delete;
+    MappedFile& operator=(MappedFile&&) = delete;
+
+    [[nodiscard]] const uint8_t* GetData() const { return static_cast<const uint8_t*>(data_); }
+    [[nodiscard]] size_t GetSize() const { return size_; }
+
+private:
+    const void* data_{nullptr};
+    size_t size_{0};
+#if defined(_WIN32)
+    HANDLE file_{INVALID_HANDLE_VALUE};
+    HANDLE mapping_{nullptr};
+#else
+    int fd_{-1};
+#endif
+
+    void Close()
+    {
+#if defined(_WIN32)
+        if (data_) {
+            UnmapViewOfFile(data_);
+        }
+        if (mapping_) {
+            CloseHandle(mapping_);
+        }
+        if (file_ != INVALID_HANDLE_VALUE) {
+            CloseHandle(file_);
+        }
+        mapping_ = nullptr;
+        file_ = INVALID_HANDLE_VALUE;
+#else
+        if (data_) {
+            munmap(const_cast<void*>(data_), size_);
+        }
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+        fd_ = -1;
+#endif
+        data_ = nullptr;
+    }
+};
+
+ShaderLibrary::ShaderLibrary(const Device& device, const Options& options)
+    : device_(&device),
+    options_(options) {}
+
+ShaderLibrary::ShaderLibrary(const Device& device)
+    : ShaderLibrary(device, Options{}) {}
+
+ShaderLibrary::~ShaderLibrary() = default;
+
+void ShaderLibrary::OpenArchive(const std::string& path)
+{
+    auto archive = std::make_unique<MappedFile>(path);
+    const uint8_t* data = archive->GetData();
+    const size_t size = archive->GetSize();
+
+    if (size < sizeof(ARCHIVE_MAGIC) || std::memcmp(data, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0) {
+        throw std::runtime_error("Not a shader archive: " + path);
+    }
+    size_t offset = sizeof(ARCHIVE_MAGIC);
+    if (ReadValue<uint32_t>(data, size, offset) != ARCHIVE_VERSION) {
+        throw std::runtime_error("Unsupported shader archive version: " + path);
+    }
+    const uint32_t entry_count = ReadValue<uint32_t>(data, size, offset);
+    // Name length, offset and size per entry: reject counts the file cannot hold before reserving
+    constexpr size_t MIN_ENTRY_RECORD_SIZE = sizeof(uint32_t) + 2 * sizeof(uint64_t);
+    if (entry_count > (size - offset) / MIN_ENTRY_RECORD_SIZE) {
+        throw std::runtime_error("Truncated shader archive: " + path);
+    }
+
+    std::vector<std::pair<std::string, ArchiveEntry>> entries;
+    entries.reserve(entry_count);
+    for (uint32_t i = 0; i < entry_count; ++i) {
+        const uint32_t name_length = ReadValue<uint32_t>(data, size, offset);
+        if (name_length > size - offset) {
+            throw std::runtime_error("Truncated shader archive: " + path);
+        }
+        std::string name(reinterpret_cast<const char*>(data + offset), name_length);
+        offset += name_length;
+
+        ArchiveEntry entry{};
+        entry.archive = archive.get();
+        entry.offset = ReadValue<uint64_t>(data, size, offset);
+        entry.size = ReadValue<uint64_t>(data, size, offset);
+        if (entry.offset % sizeof(uint32_t) != 0 || entry.size % sizeof(uint32_t) != 0 ||
+            entry.offset > size || entry.size > size - entry.offset) {
+            throw std::runtime_error("Corrupt shader archive entry '" + name + "' in " + path);
+        }
+        entries.emplace_back(std::move(name), entry);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : entries) {
+        nameToHash_.erase(entry.first);
+        archiveEntries_[std::move(entry.first)] = entry.second;
+    }
+    archives_.push_back(std::move(archive));
+}
+
+std::shared_ptr<const Shader> ShaderLibrary::Load(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Already resolved: no I/O at all
+    auto known = nameToHash_.find(name);
+    if (known != nameToHash_.end()) {
+        auto it = shaders_.find(known->second);
+        if (it != shaders_.end()) {
+            return it->second;
+        }
+    }
+
+    std::shared_ptr<const Shader> shader;
+    auto entry = archiveEntries_.find(name);
+    if (entry != archiveEntries_.end()) {
+        const auto* code = reinterpret_cast<const uint32_t*>(entry->second.archive->GetData() + entry->second.offset);
+        shader = LoadLocked(code, static_cast<size_t>(entry->second.size / sizeof(uint32_t)));
+    } else {
+        const MappedFile file(name);
+        if (file.GetSize() % sizeof(uint32_t) != 0) {
+            throw std::runtime_error("Invalid SPIR-V file size: " + name);
+        }
+        shader = LoadLocked(reinterpret_cast<const uint32_t*>(file.GetData()), file.GetSize() / sizeof(uint32_t));
+    }
+    nameToHash_[name] = shader->GetCodeHash();
+    return shader;
+}
+
+std::shared_ptr<const Shader> ShaderLibrary::Load(const uint32_t* code, size_t word_count)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return LoadLocked(code, word_count);
+}
+
+void ShaderLibrary::Trim()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::erase_if(shaders_, [](const auto& entry) { return entry.second.use_count() == 1; });
+}
+
+size_t ShaderLibrary::GetModuleCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return shaders_.size();
+}
+
+void ShaderLibrary::WriteArchive(const std::string& path,
+                                 const std::vector<std::pair<std::string, std::vector<uint32_t>>>& shaders)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("Failed to create shader archive: " + path);
+    }
+
+    uint64_t header_size = sizeof(ARCHIVE_MAGIC) + 2 * sizeof(uint32_t);
+    for (const auto& shader : shaders) {
+        header_size += sizeof(uint32_t) + shader.first.size() + 2 * sizeof(uint64_t);
+    }
+    // Blobs start 4-byte aligned so they can be used in place
+    const uint64_t data_start = (header_size + 3) & ~uint64_t{3};
+
+    file.write(ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+    WriteValue<uint32_t>(file, ARCHIVE_VERSION);
+    WriteValue<uint32_t>(file, static_cast<uint32_t>(shaders.size()));
+    uint64_t offset = data_start;
+    for (const auto& shader : shaders) {
+        const uint64_t size = shader.second.size() * sizeof(uint32_t);
+        WriteValue<uint32_t>(file, static_cast<uint32_t>(shader.first.size()));
+        file.write(shader.first.data(), static_cast<std::streamsize>(shader.first.size()));
+        WriteValue<uint64_t>(file, offset);
+        WriteValue<uint64_t>(file, size);
+        offset += size;
+    }
+    for (uint64_t i = header_size; i < data_start; ++i) {
+        file.put('\0');
+    }
+    for (const auto& shader : shaders) {
+        file.write(reinterpret_cast<const char*>(shader.second.data()),
+                   static_cast<std::streamsize>(shader.second.size() * sizeof(uint32_t)));
+    }
+    if (!file) {
+        throw std::runtime_error("Failed to write shader archive: " + path);
+    }
+}
+
+std::shared_ptr<const Shader> ShaderLibrary::LoadLocked(const uint32_t* code, size_t word_count)
+{
+    const uint64_t hash = Utils::SpirvUtils::HashCode(code, word_count);
+    auto it = shaders_.find(hash);
+    if (it != shaders_.end()) {
+        return it->second;
+    }
+    auto shader = std::make_shared<const Shader>(*device_, code, word_count, options_.keepCode);
+    shaders_.emplace(hash, shader);
+    return shader;
+}
+
+} // namespace VulkanEngine::RAII
@@ -0,0 +1,90 @@
+#ifndef VULKAN_RAII_RESOURCES_SHADER_LIBRARY_HPP
+#define VULKAN_RAII_RESOURCES_SHADER_LIBRARY_HPP
+
+#include <volk.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Shader.hpp"
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+
+// Loads shader modules from memory-mapped .spv files or from one packed
+// archive, and deduplicates them by content hash: every path or archive entry
+// holding the same SPIR-V resolves to a single VkShaderModule. With keepCode
+// off the CPU-side copy is never made (the code is read from the mapping and
+// reflected once), so thousands of variants cost only their driver objects.
+// Thread-safe.
+//
+// Archive layout (little endian): "SPVA" magic, uint32 version (1), uint32
+// entry count; per entry uint32 name length, name bytes, uint64 offset and
+// uint64 size in bytes; then the 4-byte aligned SPIR-V blobs.
+class ShaderLibrary {
+public:
+    struct Options {
+        bool keepCode{false}; // Keep Shader::GetSpirVCode() available after module creation
+    };
+
+    // Constructor
+    ShaderLibrary(const Device& device, const Options& options);
+    explicit ShaderLibrary(const Device& device);
+
+    // Destructor
+    ~ShaderLibrary();
+
+    // Delete copy and move. shared shaders and mappings are owned by this object.
+    ShaderLibrary(const ShaderLibrary&) = delete;
+    ShaderLibrary& operator=(const ShaderLibrary&) = delete;
+    ShaderLibrary(ShaderLibrary&&) = delete;
+    ShaderLibrary& operator=(ShaderLibrary&&) = delete;
+
+    // Map a packed archive; its entries are found by Load() before the file system
+    void OpenArchive(const std::string& path);
+
+    // Get the shader for an archive entry name or .spv path
+    std::shared_ptr<const Shader> Load(const std::string& name);
+
+    // Get the shader for SPIR-V in memory
+    std::shared_ptr<const Shader> Load(const uint32_t* code, size_t word_count);
+
+    // Drop shaders nobody else references
+    void Trim();
+
+    [[nodiscard]] size_t GetModuleCount() const;
+
+    // Pack shaders into an archive readable by OpenArchive()
+    static void WriteArchive(const std::string& path,
+                             const std::vector<std::pair<std::string, std::vector<uint32_t>>>& shaders);
+
+private:
+    class MappedFile; // Read-only file mapping
+
+    struct ArchiveEntry {
+        const MappedFile* archive{nullptr};
+        uint64_t offset{0};
+        uint64_t size{0};
+    };
+
+    const Device* device_{nullptr};
+    Options options_;
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<MappedFile>> archives_;
+    std::unordered_map<std::string, ArchiveEntry> archiveEntries_;
+    std::unordered_map<std::string, uint64_t> nameToHash_;
+    std::unordered_map<uint64_t, std::shared_ptr<const Shader>> shaders_;
+
+    std::shared_ptr<const Shader> LoadLocked(const uint32_t* code, size_t word_count);
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RESOURCES_SHADER_LIBRARY_HPP
@@ -0,0 +1,208 @@
+#include "ShaderObject.hpp"
+
+#include "Shader.hpp"
+#include "../core/Device.hpp"
+#include "../rendering/CommandBuffer.hpp"
+#include "../utils/HostAllocator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+namespace VulkanEngine::RAII {
+
+namespace {
+// Graphics stages in the order they execute
+constexpr std::array<VkShaderStageFlagBits, 5> GRAPHICS_STAGE_ORDER = {
+    VK_SHADER_STAGE_VERTEX_BIT,
+    VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT,
+    VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT,
+    VK_SHADER_STAGE_GEOMETRY_BIT,
+    VK_SHADER_STAGE_FRAGMENT_BIT
+};
+
+size_t StageOrder(VkShaderStageFlagBits stage)
+{
+    auto it = std::find(GRAPHICS_STAGE_ORDER.begin(), GRAPHICS_STAGE_ORDER.end(), stage);
+    return static_cast<size_t>(it - GRAPHICS_STAGE_ORDER.begin());
+}
+} // namespace
+
+ShaderObject::ShaderObject(const Device& device,
+                           const std::vector<ShaderObjectStage>& stages,
+                           const std::vector<VkDescriptorSetLayout>& set_layouts,
+                           const std::vector<VkPushConstantRange>& push_constant_ranges,
+                           bool link)
+    : device_(device.GetHandle())
+{
+    if (!IsSupported(device)) {
+        throw std::runtime_error("Shader objects require VK_EXT_shader_object");
+    }
+    if (stages.empty()) {
+        throw std::invalid_argument("Shader object requires at least one stage");
+    }
+
+    std::vector<const ShaderObjectStage*> ordered;
+    ordered.reserve(stages.size());
+    for (const ShaderObjectStage& stage : stages) {
+        if (stage.shader == nullptr || !stage.shader->HasCode()) {
+            throw std::invalid_argument("Shader object stage requires a shader that still holds its SPIR-V code");
+        }
+        ordered.push_back(&stage);
+    }
+    std::stable_sort(ordered.begin(), ordered.end(), [](const ShaderObjectStage* a, const ShaderObjectStage* b) {
+        return StageOrder(a->stage) < StageOrder(b->stage);
+    });
+    linked_ = link && ordered.size() > 1;
+
+    std::vector<VkShaderCreateInfoEXT> create_infos;
+    create_infos.reserve(ordered.size());
+    for (size_t i = 0; i < ordered.size(); ++i) {
+        const ShaderObjectStage& stage = *ordered[i];
+        const std::vector<uint32_t>& code = stage.shader->GetSpirVCode();
+
+        VkShaderStageFlags next_stage = 0;
+        if (linked_) {
+            next_stage = i + 1 < ordered.size() ? ordered[i + 1]->stage : 0;
+        } else if (stage.stage != VK_SHADER_STAGE_FRAGMENT_BIT && stage.stage != VK_SHADER_STAGE_COMPUTE_BIT) {
+            // Unlinked stages may be followed by any later stage of this object, or a fragment shader
+            next_stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+            for (size_t j = i + 1; j < ordered.size(); ++j) {
+                next_stage |= ordered[j]->stage;
+            }
+        }
+
+        VkShaderCreateInfoEXT info{VK_STRUCTURE_TYPE_SHADER_CREATE_INFO_EXT};
+        info.flags = linked_ ? VK_SHADER_CREATE_LINK_STAGE_BIT_EXT : 0;
+        info.stage = stage.stage;
+        info.nextStage = next_stage;
+        info.codeType = VK_SHADER_CODE_TYPE_SPIRV_EXT;
+        info.codeSize = code.size() * sizeof(uint32_t);
+        info.pCode = code.data();
+        info.pName = stage.entryPoint.empty() ? "main" : stage.entryPoint.c_str();
+        info.setLayoutCount = static_cast<uint32_t>(set_layouts.size());
+        info.pSetLayouts = set_layouts.empty() ? nullptr : set_layouts.data();
+        info.pushConstantRangeCount = static_cast<uint32_t>(push_constant_ranges.size());
+        info.pPushConstantRanges = push_constant_ranges.empty() ? nullptr : push_constant_ranges.data();
+        info.pSpecializationInfo = stage.specialization.GetInfo();
+        create_infos.push_back(info);
+        stages_.push_back(stage.stage);
+    }
+
+    shaders_.assign(create_infos.size(), VK_NULL_HANDLE);
+    const VkResult result = vkCreateShadersEXT(device_, static_cast<uint32_t>(create_infos.size()),
+                                               create_infos.data(), Utils::HostAllocator::For(VK_OBJECT_TYPE_SHADER_EXT), shaders_.data());
+    if (result != VK_SUCCESS) {
+        // Stages that did get created still have to be released
+        Cleanup();
+        throw std::runtime_error("Failed to create shader objects");
+    }
+}
+
+ShaderObject::~ShaderObject() {
+    Cleanup();
+}
+
+ShaderObject::ShaderObject(ShaderObject&& other) noexcept
+    : device_(other.device_),
+    stages_(std::move(other.stages_)),
+    shaders_(std::move(other.shaders_)),
+    linked_(other.linked_)
+{
+    other.device_ = VK_NULL_HANDLE;
+    other.stages_.clear();
+    other.shaders_.clear();
+}
+
+ShaderObject& ShaderObject::operator=(ShaderObject&& other) noexcept {
+    if (this != &other) {
+        Cleanup();
+        device_ = other.device_;
+        stages_ = std::move(other.stages_);
+        shaders_ = std::move(other.shaders_);
+        linked_ = other.linked_;
+
+        other.device_ = VK_NULL_HANDLE;
+        other.stages_.clear();
+        other.shaders_.clear();
+    }
+    return *this;
+}
+
+bool ShaderObject::IsSupported(const Device& device)
+{
+    return device.SupportsShaderObject();
+}
+
+VkShaderEXT ShaderObject::GetHandle(VkShaderStageFlagBits stage) const
+{
+    for (size_t i = 0; i < stages_.size(); ++i) {
+        if (stages_[i] == stage) {
+            return shaders_[i];
+        }
+    }
+    return VK_NULL_HANDLE;
+}
+
+void ShaderObject::SetDefaultState(const CommandBuffer& command_buffer,
+                                   VkExtent2D extent,
+                                   uint32_t color_attachment_count)
+{
+    const VkViewport viewport{0.0f, 0.0f, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f};
+    const VkRect2D scissor{{0, 0}, extent};
+    command_buffer.SetViewportWithCount(std::span<const VkViewport>(&viewport, 1));
+    command_buffer.SetScissorWithCount(std::span<const VkRect2D>(&scissor, 1));
+
+    command_buffer.SetVertexInput({}, {});
+    command_buffer.SetPrimitiveTopology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+    command_buffer.SetPrimitiveRestartEnable(false);
+
+    command_buffer.SetRasterizerDiscardEnable(false);
+    command_buffer.SetPolygonMode(VK_POLYGON_MODE_FILL);
+    command_buffer.SetCullMode(VK_CULL_MODE_NONE);
+    command_buffer.SetFrontFace(VK_FRONT_FACE_COUNTER_CLOCKWISE);
+    command_buffer.SetDepthClampEnable(false);
+    command_buffer.SetDepthBiasEnable(false);
+    command_buffer.SetLineWidth(1.0f);
+
+    const VkSampleMask sample_mask = ~VkSampleMask{0};
+    command_buffer.SetRasterizationSamples(VK_SAMPLE_COUNT_1_BIT);
+    command_buffer.SetSampleMask(VK_SAMPLE_COUNT_1_BIT, std::span<const VkSampleMask>(&sample_mask, 1));
+    command_buffer.SetAlphaToCoverageEnable(false);
+
+    command_buffer.SetDepthTestEnable(false);
+    command_buffer.SetDepthWriteEnable(false);
+    command_buffer.SetDepthCompareOp(VK_COMPARE_OP_LESS_OR_EQUAL);
+    command_buffer.SetDepthBoundsTestEnable(false);
+    command_buffer.SetStencilTestEnable(false);
+
+    command_buffer.SetLogicOpEnable(false);
+    if (color_attachment_count > 0) {
+        const std::vector<VkBool32> blend_enables(color_attachment_count, VK_FALSE);
+        const std::vector<VkColorComponentFlags> write_masks(color_attachment_count,
+            VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT);
+        command_buffer.SetColorBlendEnable(0, blend_enables);
+        command_buffer.SetColorWriteMask(0, write_masks);
+    }
+}
+
+void ShaderObject::Cleanup()
+{
+    if (device_ != VK_NULL_HANDLE) {
+        for (VkShaderEXT shader : shaders_) {
+            if (shader != VK_NULL_HANDLE) {
+                vkDestroyShaderEXT(device_, shader, Utils::HostAllocator::For(VK_OBJECT_TYPE_SHADER_EXT));
+            }
+        }
+    }
+    shaders_.clear();
+    stages_.clear();
+    device_ = VK_NULL_HANDLE;
+}
+
+} // namespace VulkanEngine::RAII
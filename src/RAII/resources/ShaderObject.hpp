@@ -0,0 +1,82 @@
+#ifndef VULKAN_RAII_RESOURCES_SHADER_OBJECT_HPP
+#define VULKAN_RAII_RESOURCES_SHADER_OBJECT_HPP
+
+#include <volk.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../rendering/PipelineStructs.hpp"
+
+
+namespace VulkanEngine::RAII {
+
+class CommandBuffer; // Forward declaration
+class Device; // Forward declaration
+class Shader; // Forward declaration
+
+struct ShaderObjectStage {
+    VkShaderStageFlagBits stage;
+    const Shader* shader{nullptr}; // Must still hold its SPIR-V code (Shader::HasCode())
+    std::string entryPoint = "main";
+    SpecializationConstants specialization;
+};
+
+// VK_EXT_shader_object shaders: bound directly with CommandBuffer::BindShaders and
+// drawn with every piece of state set at record time, so no pipeline is ever
+// compiled. Multiple graphics stages are created as one linked set, which lets
+// the driver optimize across the stage interfaces like a monolithic pipeline.
+// Shader objects require dynamic rendering; use Pipeline when IsSupported() is false.
+class ShaderObject {
+public:
+    // Constructor. Stages are created linked when link is set and there is more than one
+    ShaderObject(const Device& device,
+                 const std::vector<ShaderObjectStage>& stages,
+                 const std::vector<VkDescriptorSetLayout>& set_layouts = {},
+                 const std::vector<VkPushConstantRange>& push_constant_ranges = {},
+                 bool link = true);
+
+    // Destructor
+    ~ShaderObject();
+
+    // Move constructor and assignment
+    ShaderObject(ShaderObject&& other) noexcept;
+    ShaderObject& operator=(ShaderObject&& other) noexcept;
+
+    // Delete copy constructor and assignment. this ensures unique ownership of the VkShaderEXT handles by only allowing moving.
+    ShaderObject(const ShaderObject&) = delete;
+    ShaderObject& operator=(const ShaderObject&) = delete;
+
+    // Check whether the device enabled VK_EXT_shader_object
+    static bool IsSupported(const Device& device);
+
+    // Handle of one stage (VK_NULL_HANDLE when the stage is not part of this object)
+    [[nodiscard]] VkShaderEXT GetHandle(VkShaderStageFlagBits stage) const;
+
+    // Stages and handles in matching order, ready for vkCmdBindShadersEXT
+    [[nodiscard]] const std::vector<VkShaderStageFlagBits>& GetStages() const { return stages_; }
+    [[nodiscard]] const std::vector<VkShaderEXT>& GetHandles() const { return shaders_; }
+
+    [[nodiscard]] bool IsValid() const { return !shaders_.empty(); }
+    [[nodiscard]] bool IsLinked() const { return linked_; }
+
+    // Set every state a shader object draw requires to plain defaults: full-extent
+    // viewport and scissor, triangle lists, no culling, no depth/stencil, opaque
+    // color writes and no vertex input. Callers override what they need afterwards
+    static void SetDefaultState(const CommandBuffer& command_buffer,
+                                VkExtent2D extent,
+                                uint32_t color_attachment_count = 1);
+
+private:
+    VkDevice device_{VK_NULL_HANDLE}; // Reference to device
+    std::vector<VkShaderStageFlagBits> stages_;
+    std::vector<VkShaderEXT> shaders_;
+    bool linked_{false};
+
+    void Cleanup();
+};
+
+} // namespace VulkanEngine::RAII
+
+
+#endif // VULKAN_RAII_RESOURCES_SHADER_OBJECT_HPP
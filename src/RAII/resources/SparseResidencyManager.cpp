@@ -0,0 +1,395 @@
+#include "SparseResidencyManager.hpp"
+
+#include "Image.hpp"
+#include "VmaAllocator.hpp"
+#include "../core/Device.hpp"
+#include "../rendering/Renderer.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+
+namespace VulkanEngine::RAII {
+
+namespace {
+uint32_t DivideRoundUp(uint32_t value, uint32_t divisor)
+{
+    return (value + divisor - 1) / divisor;
+}
+
+uint32_t MipDimension(uint32_t base, uint32_t mip)
+{
+    return std::max(1u, base >> mip);
+}
+} // namespace
+
+SparseResidencyManager::SparseResidencyManager(const VmaAllocator& allocator,
+                                               const Image& image,
+                                               const Queue& sparse_queue,
+                                               uint32_t max_resident_pages)
+    : allocator_(&allocator),
+    image_(&image),
+    queue_(sparse_queue),
+    maxResidentPages_(max_resident_pages)
+{
+    if (!image.IsSparse()) {
+        throw std::invalid_argument("Residency management requires an image created with VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT");
+    }
+    const Device* device = allocator.GetDeviceRef();
+    if ((Queue::GetQueueCapabilities(*device, sparse_queue.GetFamilyIndex()) & VK_QUEUE_SPARSE_BINDING_BIT) == 0) {
+        throw std::invalid_argument("Queue family does not support sparse binding");
+    }
+
+    const std::vector<VkSparseImageMemoryRequirements> requirements = image.GetSparseMemoryRequirements();
+    auto color = std::find_if(requirements.begin(), requirements.end(), [](const VkSparseImageMemoryRequirements& r) {
+        return (r.formatProperties.aspectMask & VK_IMAGE_ASPECT_METADATA_BIT) == 0;
+    });
+    if (color == requirements.end()) {
+        throw std::runtime_error("Failed to query sparse image memory requirements");
+    }
+    aspect_ = color->formatProperties.aspectMask;
+    granularity_ = color->formatProperties.imageGranularity;
+    mipTailFirstLod_ = std::min(color->imageMipTailFirstLod, image.GetMipLevels());
+
+    // For sparse images the alignment is the size of one sparse block
+    memoryRequirements_ = image.GetMemoryRequirements();
+    pageSize_ = memoryRequirements_.alignment;
+
+    VmaAllocationCreateInfo alloc_info{};
+    alloc_info.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    ::VmaPoolCreateInfo pool_info{};
+    if (vmaFindMemoryTypeIndex(allocator.GetHandle(), memoryRequirements_.memoryTypeBits,
+                               &alloc_info, &pool_info.memoryTypeIndex) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to find memory type for sparse image pages");
+    }
+    pool_info.flags = VMA_POOL_CREATE_IGNORE_BUFFER_IMAGE_GRANULARITY_BIT;
+    pool_ = std::make_unique<MemoryPool>(allocator, pool_info);
+
+    // Linear page index of the first page of each (layer, mip) outside the mip tail
+    levelPageOffsets_.resize(static_cast<size_t>(image.GetArrayLayers()) * mipTailFirstLod_);
+    uint64_t page_count = 0;
+    for (uint32_t layer = 0; layer < image.GetArrayLayers(); ++layer) {
+        for (uint32_t mip = 0; mip < mipTailFirstLod_; ++mip) {
+            levelPageOffsets_[static_cast<size_t>(layer) * mipTailFirstLod_ + mip] = page_count;
+            const VkExtent3D pages = GetPageCount(mip);
+            page_count += static_cast<uint64_t>(pages.width) * pages.height * pages.depth;
+        }
+    }
+
+    SetupMipTail(requirements);
+}
+
+SparseResidencyManager::~SparseResidencyManager()
+{
+    Detach();
+    Collect(true);
+
+    for (auto& entry : resident_) {
+        FreeAllocation(entry.second.allocation);
+    }
+    for (VmaAllocation allocation : pendingFrees_) {
+        FreeAllocation(allocation);
+    }
+    for (VmaAllocation allocation : mipTailAllocations_) {
+        FreeAllocation(allocation);
+    }
+}
+
+bool SparseResidencyManager::RequestPage(const SparsePage& page)
+{
+    if (IsInMipTail(page.mip)) {
+        return true;
+    }
+    const uint64_t key = GetPageKey(page);
+    auto it = resident_.find(key);
+    if (it != resident_.end()) {
+        it->second.lastUsedFrame = frameNumber_;
+        return true;
+    }
+
+    if (resident_.size() >= maxResidentPages_ && !EvictLeastRecentlyUsed()) {
+        return false;
+    }
+
+    VmaAllocationCreateInfo alloc_info{};
+    alloc_info.pool = pool_->GetHandle();
+    VmaAllocation allocation = VK_NULL_HANDLE;
+    VkMemoryRequirements page_requirements = memoryRequirements_;
+    page_requirements.size = pageSize_;
+    if (vmaAllocateMemory(allocator_->GetHandle(), &page_requirements, &alloc_info, &allocation, nullptr) != VK_SUCCESS) {
+        // Out of device memory; give up a page that was not needed this frame and retry once
+        if (!EvictLeastRecentlyUsed() ||
+            vmaAllocateMemory(allocator_->GetHandle(), &page_requirements, &alloc_info, &allocation, nullptr) != VK_SUCCESS) {
+            return false;
+        }
+    }
+
+    // A queued unbind of the same page is superseded by the new bind
+    (void)ErasePendingBind(page);
+    pendingBinds_.push_back(CreateBind(page, allocation));
+    resident_[key] = ResidentPage{page, allocation, frameNumber_};
+    return true;
+}
+
+void SparseResidencyManager::EvictPage(const SparsePage& page)
+{
+    if (IsInMipTail(page.mip)) {
+        return;
+    }
+    auto it = resident_.find(GetPageKey(page));
+    if (it == resident_.end()) {
+        return;
+    }
+    const VmaAllocation allocation = it->second.allocation;
+    resident_.erase(it);
+
+    if (ErasePendingBind(page)) {
+        // Never reached the queue, nothing to unbind
+        FreeAllocation(allocation);
+        return;
+    }
+    pendingBinds_.push_back(CreateBind(page, VK_NULL_HANDLE));
+    pendingFrees_.push_back(allocation);
+}
+
+void SparseResidencyManager::Touch(const SparsePage& page)
+{
+    if (IsInMipTail(page.mip)) {
+        return;
+    }
+    auto it = resident_.find(GetPageKey(page));
+    if (it != resident_.end()) {
+        it->second.lastUsedFrame = frameNumber_;
+    }
+}
+
+VkResult SparseResidencyManager::Submit(const std::vector<VkSemaphore>& wait_semaphores,
+                                        const std::vector<VkSemaphore>& signal_semaphores)
+{
+    Collect(false);
+    if (pendingBinds_.empty() && pendingOpaqueBinds_.empty()) {
+        return VK_SUCCESS;
+    }
+
+    VkSparseImageMemoryBindInfo image_bind{};
+    image_bind.image = image_->GetHandle();
+    image_bind.bindCount = static_cast<uint32_t>(pendingBinds_.size());
+    image_bind.pBinds = pendingBinds_.data();
+
+    VkSparseImageOpaqueMemoryBindInfo opaque_bind{};
+    opaque_bind.image = image_->GetHandle();
+    opaque_bind.bindCount = static_cast<uint32_t>(pendingOpaqueBinds_.size());
+    opaque_bind.pBinds = pendingOpaqueBinds_.data();
+
+    VkBindSparseInfo bind_info{VK_STRUCTURE_TYPE_BIND_SPARSE_INFO};
+    bind_info.waitSemaphoreCount = static_cast<uint32_t>(wait_semaphores.size());
+    bind_info.pWaitSemaphores = wait_semaphores.data();
+    bind_info.signalSemaphoreCount = static_cast<uint32_t>(signal_semaphores.size());
+    bind_info.pSignalSemaphores = signal_semaphores.data();
+    if (!pendingBinds_.empty()) {
+        bind_info.imageBindCount = 1;
+        bind_info.pImageBinds = &image_bind;
+    }
+    if (!pendingOpaqueBinds_.empty()) {
+        bind_info.imageOpaqueBindCount = 1;
+        bind_info.pImageOpaqueBinds = &opaque_bind;
+    }
+
+    InFlightBind in_flight{
+        freeFences_.empty() ? Fence(*allocator_->GetDeviceRef()) : std::move(freeFences_.back()),
+        {}
+    };
+    if (!freeFences_.empty()) {
+        freeFences_.pop_back();
+    }
+
+    const VkResult result = queue_.BindSparse(bind_info, in_flight.fence.GetHandle());
+    if (result != VK_SUCCESS) {
+        // Keep everything queued so the caller can retry
+        freeFences_.push_back(std::move(in_flight.fence));
+        return result;
+    }
+
+    in_flight.freeAfter = std::move(pendingFrees_);
+    inFlight_.push_back(std::move(in_flight));
+    pendingFrees_.clear();
+    pendingBinds_.clear();
+    pendingOpaqueBinds_.clear();
+    return VK_SUCCESS;
+}
+
+void SparseResidencyManager::Update(uint64_t frame_number)
+{
+    frameNumber_ = frame_number;
+    Collect(false);
+}
+
+void SparseResidencyManager::AttachToRenderer(Renderer& renderer)
+{
+    Detach();
+    renderer_ = &renderer;
+    frameBeginSubscription_ = renderer.SubscribeFrameBegin([this](uint32_t /*frame_index*/) {
+        Update(renderer_->GetTotalFrameCount());
+    });
+}
+
+void SparseResidencyManager::Detach()
+{
+    frameBeginSubscription_.Reset();
+    renderer_ = nullptr;
+}
+
+bool SparseResidencyManager::IsResident(const SparsePage& page) const
+{
+    return IsInMipTail(page.mip) || resident_.find(GetPageKey(page)) != resident_.end();
+}
+
+VkExtent3D SparseResidencyManager::GetPageCount(uint32_t mip) const
+{
+    return VkExtent3D{
+        DivideRoundUp(MipDimension(image_->GetWidth(), mip), granularity_.width),
+        DivideRoundUp(MipDimension(image_->GetHeight(), mip), granularity_.height),
+        DivideRoundUp(MipDimension(image_->GetDepth(), mip), granularity_.depth)
+    };
+}
+
+uint64_t SparseResidencyManager::GetPageKey(const SparsePage& page) const
+{
+    if (page.layer >= image_->GetArrayLayers() || page.mip >= mipTailFirstLod_) {
+        throw std::out_of_range("Sparse page layer or mip level out of range");
+    }
+    const VkExtent3D pages = GetPageCount(page.mip);
+    if (page.x >= pages.width || page.y >= pages.height || page.z >= pages.depth) {
+        throw std::out_of_range("Sparse page coordinates out of range");
+    }
+    return levelPageOffsets_[static_cast<size_t>(page.layer) * mipTailFirstLod_ + page.mip] +
+        (static_cast<uint64_t>(page.z) * pages.height + page.y) * pages.width + page.x;
+}
+
+VkSparseImageMemoryBind SparseResidencyManager::CreateBind(const SparsePage& page, VmaAllocation allocation) const
+{
+    VkSparseImageMemoryBind bind{};
+    bind.subresource.aspectMask = aspect_;
+    bind.subresource.mipLevel = page.mip;
+    bind.subresource.arrayLayer = page.layer;
+    bind.offset.x = static_cast<int32_t>(page.x * granularity_.width);
+    bind.offset.y = static_cast<int32_t>(page.y * granularity_.height);
+    bind.offset.z = static_cast<int32_t>(page.z * granularity_.depth);
+
+    // Edge pages are clipped to the mip level
+    bind.extent.width = std::min(granularity_.width, MipDimension(image_->GetWidth(), page.mip) - page.x * granularity_.width);
+    bind.extent.height = std::min(granularity_.height, MipDimension(image_->GetHeight(), page.mip) - page.y * granularity_.height);
+    bind.extent.depth = std::min(granularity_.depth, MipDimension(image_->GetDepth(), page.mip) - page.z * granularity_.depth);
+
+    if (allocation != VK_NULL_HANDLE) {
+        VmaAllocationInfo info{};
+        allocator_->GetAllocationInfo(allocation, info);
+        bind.memory = info.deviceMemory;
+        bind.memoryOffset = info.offset;
+    }
+    return bind;
+}
+
+void SparseResidencyManager::SetupMipTail(const std::vector<VkSparseImageMemoryRequirements>& requirements)
+{
+    VmaAllocationCreateInfo alloc_info{};
+    alloc_info.pool = pool_->GetHandle();
+
+    for (const VkSparseImageMemoryRequirements& requirement : requirements) {
+        const bool metadata = (requirement.formatProperties.aspectMask & VK_IMAGE_ASPECT_METADATA_BIT) != 0;
+        if (requirement.imageMipTailSize == 0 || (!metadata && requirement.imageMipTailFirstLod >= image_->GetMipLevels())) {
+            continue;
+        }
+        const bool single_tail = (requirement.formatProperties.flags & VK_SPARSE_IMAGE_FORMAT_SINGLE_MIPTAIL_BIT) != 0;
+        const uint32_t tail_count = single_tail ? 1 : image_->GetArrayLayers();
+
+        VkMemoryRequirements tail_requirements = memoryRequirements_;
+        tail_requirements.size = requirement.imageMipTailSize;
+        for (uint32_t layer = 0; layer < tail_count; ++layer) {
+            VmaAllocation allocation = VK_NULL_HANDLE;
+            VmaAllocationInfo info{};
+            if (vmaAllocateMemory(allocator_->GetHandle(), &tail_requirements, &alloc_info, &allocation, &info) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to allocate sparse image mip tail memory");
+            }
+            mipTailAllocations_.push_back(allocation);
+
+            VkSparseMemoryBind bind{};
+            bind.resourceOffset = requirement.imageMipTailOffset + layer * requirement.imageMipTailStride;
+            bind.size = requirement.imageMipTailSize;
+            bind.memory = info.deviceMemory;
+            bind.memoryOffset = info.offset;
+            bind.flags = metadata ? VK_SPARSE_MEMORY_BIND_METADATA_BIT : 0;
+            pendingOpaqueBinds_.push_back(bind);
+        }
+    }
+}
+
+bool SparseResidencyManager::ErasePendingBind(const SparsePage& page)
+{
+    const int32_t x = static_cast<int32_t>(page.x * granularity_.width);
+    const int32_t y = static_cast<int32_t>(page.y * granularity_.height);
+    const int32_t z = static_cast<int32_t>(page.z * granularity_.depth);
+
+    bool erased_bind = false;
+    std::erase_if(pendingBinds_, [&](const VkSparseImageMemoryBind& bind) {
+        const bool same_page = bind.subresource.mipLevel == page.mip && bind.subresource.arrayLayer == page.layer &&
+            bind.offset.x == x && bind.offset.y == y && bind.offset.z == z;
+        if (same_page && bind.memory != VK_NULL_HANDLE) {
+            erased_bind = true;
+        }
+        return same_page;
+    });
+    return erased_bind;
+}
+
+bool SparseResidencyManager::EvictLeastRecentlyUsed()
+{
+    // Never evict what this frame touched
+    auto victim = resident_.end();
+    uint64_t oldest = std::numeric_limits<uint64_t>::max();
+    for (auto it = resident_.begin(); it != resident_.end(); ++it) {
+        if (it->second.lastUsedFrame != frameNumber_ && it->second.lastUsedFrame < oldest) {
+            oldest = it->second.lastUsedFrame;
+            victim = it;
+        }
+    }
+    if (victim == resident_.end()) {
+        return false;
+    }
+    EvictPage(victim->second.page);
+    return true;
+}
+
+void SparseResidencyManager::FreeAllocation(VmaAllocation allocation)
+{
+    vmaFreeMemory(allocator_->GetHandle(), allocation);
+}
+
+void SparseResidencyManager::Collect(bool wait)
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < inFlight_.size(); ++i) {
+        InFlightBind& in_flight = inFlight_[i];
+        if (wait) {
+            (void)in_flight.fence.Wait();
+        } else if (in_flight.fence.GetStatus() != VK_SUCCESS) {
+            if (kept != i) {
+                inFlight_[kept] = std::move(in_flight);
+            }
+            ++kept;
+            continue;
+        }
+        for (VmaAllocation allocation : in_flight.freeAfter) {
+            FreeAllocation(allocation);
+        }
+        (void)in_flight.fence.Reset();
+        freeFences_.push_back(std::move(in_flight.fence));
+    }
+    inFlight_.erase(inFlight_.begin() + static_cast<std::ptrdiff_t>(kept), inFlight_.end());
+}
+
+} // namespace VulkanEngine::RAII
@@ -0,0 +1,142 @@
+#ifndef VULKAN_RAII_RESOURCES_SPARSE_RESIDENCY_MANAGER_HPP
+#define VULKAN_RAII_RESOURCES_SPARSE_RESIDENCY_MANAGER_HPP
+
+#include <volk.h>
+#include <vk_mem_alloc.h>
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "../core/Queue.hpp"
+#include "../rendering/FrameBeginSubscription.hpp"
+#include "../sync/Fence.hpp"
+#include "MemoryPool.hpp"
+
+namespace VulkanEngine::RAII {
+
+class VmaAllocator; // Forward declaration
+class Image; // Forward declaration
+class Renderer; // Forward declaration
+
+// Page of a sparse image, addressed in units of the sparse block granularity
+struct SparsePage {
+    uint32_t layer{0};
+    uint32_t mip{0};
+    uint32_t x{0};
+    uint32_t y{0};
+    uint32_t z{0};
+};
+
+// Streams memory in and out of a sparse resident image (see Image::CreateSparse).
+// Pages are backed by block-sized allocations from a dedicated VMA pool; requests
+// and evictions are collected and handed to a sparse binding queue in one
+// vkQueueBindSparse call per Submit(). The mip tail is bound once on the first
+// submit and stays resident. Once max_resident_pages is reached the least
+// recently touched page is evicted to make room.
+// Not thread-safe: request, touch and submit from one thread.
+class SparseResidencyManager {
+public:
+    // Constructor. The queue's family must support VK_QUEUE_SPARSE_BINDING_BIT
+    SparseResidencyManager(const VmaAllocator& allocator,
+                           const Image& image,
+                           const Queue& sparse_queue,
+                           uint32_t max_resident_pages);
+
+    // Destructor (waits for outstanding binds and frees all page memory; the image must be idle)
+    ~SparseResidencyManager();
+
+    // Delete copy and move. the attached renderer holds a callback referencing this object.
+    SparseResidencyManager(const SparseResidencyManager&) = delete;
+    SparseResidencyManager& operator=(const SparseResidencyManager&) = delete;
+    SparseResidencyManager(SparseResidencyManager&&) = delete;
+    SparseResidencyManager& operator=(SparseResidencyManager&&) = delete;
+
+    // Queue a page for binding; returns false if it could not be made resident.
+    // Pages inside the mip tail are always resident
+    bool RequestPage(const SparsePage& page);
+
+    // Queue a page for unbinding; its memory is freed once the unbind has executed
+    void EvictPage(const SparsePage& page);
+
+    // Mark a page as used this frame so it is not chosen for eviction
+    void Touch(const SparsePage& page);
+
+    // Submit all queued binds and unbinds in a single batch. Returns VK_SUCCESS when nothing was queued
+    VkResult Submit(const std::vector<VkSemaphore>& wait_semaphores = {},
+                    const std::vector<VkSemaphore>& signal_semaphores = {});
+
+    // Advance the LRU clock and free memory of completed unbinds (automatic when attached)
+    void Update(uint64_t frame_number);
+
+    // Call Update() from Renderer::BeginFrame.
+    // The renderer must outlive this manager or Detach() must be called first
+    void AttachToRenderer(Renderer& renderer);
+    void Detach();
+
+    [[nodiscard]] bool IsResident(const SparsePage& page) const;
+    [[nodiscard]] uint32_t GetResidentPageCount() const { return static_cast<uint32_t>(resident_.size()); }
+    [[nodiscard]] uint32_t GetPendingBindCount() const { return static_cast<uint32_t>(pendingBinds_.size()); }
+
+    // Size of a page in texels and bytes
+    [[nodiscard]] VkExtent3D GetPageExtent() const { return granularity_; }
+    [[nodiscard]] VkDeviceSize GetPageSize() const { return pageSize_; }
+
+    // Number of pages along each axis of a mip level
+    [[nodiscard]] VkExtent3D GetPageCount(uint32_t mip) const;
+
+    // First mip level packed into the mip tail
+    [[nodiscard]] uint32_t GetMipTailFirstLod() const { return mipTailFirstLod_; }
+
+private:
+    struct ResidentPage {
+        SparsePage page;
+        VmaAllocation allocation{VK_NULL_HANDLE};
+        uint64_t lastUsedFrame{0};
+    };
+
+    struct InFlightBind {
+        Fence fence;
+        std::vector<VmaAllocation> freeAfter;
+    };
+
+    const VmaAllocator* allocator_{nullptr};
+    const Image* image_{nullptr};
+    Queue queue_;
+    uint32_t maxResidentPages_{0};
+
+    VkImageAspectFlags aspect_{VK_IMAGE_ASPECT_COLOR_BIT};
+    VkExtent3D granularity_{};
+    VkDeviceSize pageSize_{0};
+    VkMemoryRequirements memoryRequirements_{};
+    uint32_t mipTailFirstLod_{0};
+
+    std::unique_ptr<MemoryPool> pool_;
+    std::vector<VmaAllocation> mipTailAllocations_;
+    std::vector<uint64_t> levelPageOffsets_; // First linear page index of each (layer, mip)
+
+    std::unordered_map<uint64_t, ResidentPage> resident_;
+    std::vector<VkSparseImageMemoryBind> pendingBinds_;
+    std::vector<VkSparseMemoryBind> pendingOpaqueBinds_;
+    std::vector<VmaAllocation> pendingFrees_;
+    std::vector<InFlightBind> inFlight_;
+    std::vector<Fence> freeFences_;
+    uint64_t frameNumber_{0};
+
+    Renderer* renderer_{nullptr};
+    FrameBeginSubscription frameBeginSubscription_;
+
+    [[nodiscard]] bool IsInMipTail(uint32_t mip) const { return mip >= mipTailFirstLod_; }
+    [[nodiscard]] uint64_t GetPageKey(const SparsePage& page) const;
+    [[nodiscard]] VkSparseImageMemoryBind CreateBind(const SparsePage& page, VmaAllocation allocation) const;
+    void SetupMipTail(const std::vector<VkSparseImageMemoryRequirements>& requirements);
+    bool ErasePendingBind(const SparsePage& page);
+    bool EvictLeastRecentlyUsed();
+    void FreeAllocation(VmaAllocation allocation);
+    void Collect(bool wait);
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RESOURCES_SPARSE_RESIDENCY_MANAGER_HPP
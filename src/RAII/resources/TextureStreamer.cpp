@@ -0,0 +1,594 @@
+#include "TextureStreamer.hpp"
+
+#include "VmaAllocator.hpp"
+#include "../core/Device.hpp"
+#include "../core/PhysicalDevice.hpp"
+#include "../utils/FormatUtils.hpp"
+#include "../utils/MemoryUtils.hpp"
+#include "../utils/PerfCounters.hpp"
+#include "../utils/SyncUtils.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace VulkanEngine::RAII {
+
+namespace {
+// Staging offsets stay valid copy sources for any texel block size
+constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+std::unique_ptr<Buffer> CreateMappedStaging(const VmaAllocator& allocator, VkDeviceSize size) {
+    return std::make_unique<Buffer>(allocator,
+                                    size,
+                                    VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                    VMA_MEMORY_USAGE_AUTO_PREFER_HOST,
+                                    VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+}
+} // namespace
+
+bool TextureStreamer::Task::operator<(const Task& other) const {
+    // priority_queue pops the largest: opens first, then coarse levels, then older textures
+    return std::make_tuple(!open, rank, id, level) > std::make_tuple(!other.open, other.rank, other.id, other.level);
+}
+
+TextureStreamer::TextureStreamer(const Device& device,
+                                 const VmaAllocator& allocator,
+                                 const QueueManager& queues,
+                                 const TextureStreamerConfig& config,
+                                 std::shared_ptr<const TextureTranscoder> transcoder)
+    : device_(&device),
+    allocator_(&allocator),
+    transcoder_(std::move(transcoder)),
+    config_(config),
+    queue_(queues.HasTransferQueue() ? queues.GetTransferQueue() : queues.GetGraphicsQueue()),
+    graphicsFamily_(queues.GetGraphicsQueue().GetFamilyIndex())
+{
+    if (!queue_.IsValid()) {
+        throw std::runtime_error("TextureStreamer requires a transfer or graphics queue");
+    }
+    if (!device.SupportsTimelineSemaphores()) {
+        throw std::runtime_error("TextureStreamer requires timeline semaphore support");
+    }
+
+    const Utils::FormatTable& formats = device.GetPhysicalDevice().GetFormatTable();
+    transcodeTargetsSrgb_ = Utils::FormatUtils::GetTranscodeTargets(formats, true);
+    transcodeTargetsLinear_ = Utils::FormatUtils::GetTranscodeTargets(formats, false);
+
+    commandPool_ = std::make_unique<CommandPool>(device,
+                                                 queue_.GetFamilyIndex(),
+                                                 VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+    timeline_ = std::make_unique<Semaphore>(device, uint64_t{0});
+    ring_ = CreateMappedStaging(allocator, Utils::MemoryUtils::AlignedSize(std::max<VkDeviceSize>(config_.stagingRingSize, STAGING_ALIGNMENT), STAGING_ALIGNMENT));
+    ringData_ = static_cast<std::byte*>(ring_->GetMappedData());
+    if (ringData_ == nullptr) {
+        throw std::runtime_error("TextureStreamer failed to map its staging ring");
+    }
+
+    uint32_t worker_count = config_.workerCount;
+    if (worker_count == 0) {
+        worker_count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+    workers_.reserve(worker_count);
+    for (uint32_t i = 0; i < worker_count; ++i) {
+        workers_.emplace_back(&TextureStreamer::WorkerLoop, this);
+    }
+}
+
+TextureStreamer::~TextureStreamer()
+{
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    taskAvailable_.notify_all();
+    ringSpace_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+
+    if (submittedValue_ != 0 && timeline_->Wait(submittedValue_) != VK_SUCCESS) {
+        std::cerr << "[TextureStreamer] Failed to wait for uploads on destruction" << '\n';
+    }
+}
+
+TextureId TextureStreamer::Load(const std::string& path, ResidencyCallback on_resident)
+{
+    auto texture = std::make_unique<Texture>();
+    texture->path = path;
+    texture->onResident = std::move(on_resident);
+
+    TextureId id = INVALID_TEXTURE_ID;
+    {
+        std::lock_guard lock(mutex_);
+        id = nextId_++;
+        textures_.emplace(id, std::move(texture));
+        tasks_.push(Task{id, true, 0, 0});
+    }
+    taskAvailable_.notify_one();
+    return id;
+}
+
+void TextureStreamer::Update()
+{
+    std::vector<Notification> notifications;
+    Reclaim(notifications);
+
+    std::vector<TextureId> opened;
+    std::vector<StagedLevel> staged;
+    {
+        std::lock_guard lock(mutex_);
+        opened.swap(opened_);
+        staged.swap(staged_);
+    }
+
+    for (TextureId id : opened) {
+        Texture* texture = nullptr;
+        {
+            std::lock_guard lock(mutex_);
+            texture = textures_.at(id).get();
+        }
+        VkImageCreateInfo image_info{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+        image_info.flags = texture->cube ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT : 0;
+        image_info.imageType = texture->depth > 1 ? VK_IMAGE_TYPE_3D : VK_IMAGE_TYPE_2D;
+        image_info.format = texture->format;
+        image_info.extent = {texture->width, texture->height, texture->depth};
+        image_info.mipLevels = static_cast<uint32_t>(texture->levelSizes.size());
+        image_info.arrayLayers = texture->layerCount;
+        image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+        image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+        image_info.usage = config_.usage | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        VmaAllocationCreateInfo allocation_info{};
+        allocation_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+        auto image = std::make_unique<Image>(*allocator_, image_info, allocation_info);
+        image->SetDebugName(texture->path.c_str());
+        std::lock_guard lock(mutex_);
+        texture->image = std::move(image);
+        texture->levelResident.assign(texture->levelSizes.size(), false);
+        texture->residentMip = static_cast<uint32_t>(texture->levelSizes.size());
+    }
+
+    if (!staged.empty()) {
+        Batch batch{freeCommandBuffers_.empty() ? CommandBuffer(*commandPool_) : std::move(freeCommandBuffers_.back())};
+        if (!freeCommandBuffers_.empty()) {
+            freeCommandBuffers_.pop_back();
+        }
+        batch.value = submittedValue_ + 1;
+        batch.commandBuffer.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+        std::vector<VkImageMemoryBarrier2KHR> to_transfer;
+        std::vector<VkImageMemoryBarrier2KHR> to_shader_read;
+        to_transfer.reserve(staged.size());
+        to_shader_read.reserve(staged.size());
+
+        OwnershipTransfer transfer{};
+        transfer.srcFamily = queue_.GetFamilyIndex();
+        transfer.dstFamily = graphicsFamily_;
+        transfer.sourceAccess = {VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL};
+        transfer.destinationAccess = {config_.consumerStages, VK_ACCESS_2_SHADER_READ_BIT_KHR, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+
+        std::vector<const Texture*> targets;
+        targets.reserve(staged.size());
+        {
+            std::lock_guard lock(mutex_);
+            for (const StagedLevel& level : staged) {
+                targets.push_back(textures_.at(level.id).get());
+            }
+        }
+
+        for (size_t i = 0; i < staged.size(); ++i) {
+            const VkImageSubresourceRange range = LevelRange(*targets[i], staged[i].level);
+            const VkImage image = targets[i]->image->GetHandle();
+
+            VkImageMemoryBarrier2KHR barrier = Utils::SyncUtils::CreateImageBarrier2(
+                image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, range);
+            barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE_KHR;
+            barrier.srcAccessMask = VK_ACCESS_2_NONE_KHR;
+            to_transfer.push_back(barrier);
+
+            if (UsesOwnershipTransfer()) {
+                to_shader_read.push_back(Utils::SyncUtils::CreateOwnershipBarrier(image, range, transfer, true));
+            } else {
+                // The transfer queue may not support the consumer stages; they wait on the timeline semaphore
+                VkImageMemoryBarrier2KHR to_final = Utils::SyncUtils::CreateImageBarrier2(
+                    image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, range);
+                to_final.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR;
+                to_final.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR;
+                to_final.dstStageMask = VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT_KHR;
+                to_final.dstAccessMask = VK_ACCESS_2_NONE_KHR;
+                to_shader_read.push_back(to_final);
+            }
+        }
+
+        batch.commandBuffer.PipelineBarrier2({}, {}, to_transfer);
+        for (size_t i = 0; i < staged.size(); ++i) {
+            const Texture& texture = *targets[i];
+            const uint32_t level = staged[i].level;
+            VkBufferImageCopy region{};
+            region.bufferOffset = staged[i].offset;
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel = level;
+            region.imageSubresource.baseArrayLayer = 0;
+            region.imageSubresource.layerCount = texture.layerCount;
+            region.imageExtent = {std::max(texture.width >> level, 1u),
+                                  std::max(texture.height >> level, 1u),
+                                  std::max(texture.depth >> level, 1u)};
+            const VkBuffer source = staged[i].dedicated ? staged[i].dedicated->GetHandle() : ring_->GetHandle();
+            batch.commandBuffer.CopyBufferToImage(source,
+                                                  texture.image->GetHandle(),
+                                                  VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                  std::span<const VkBufferImageCopy>(&region, 1));
+            Utils::PerfCounters::AddBytesUploaded(staged[i].size);
+        }
+        batch.commandBuffer.PipelineBarrier2({}, {}, to_shader_read);
+        batch.commandBuffer.End();
+
+        VkCommandBufferSubmitInfoKHR command_buffer_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO_KHR};
+        command_buffer_info.commandBuffer = batch.commandBuffer.GetHandle();
+        const VkSemaphoreSubmitInfoKHR signal_info = Utils::SyncUtils::CreateSemaphoreSubmitInfo(
+            timeline_->GetHandle(), VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR, batch.value);
+        VkSubmitInfo2KHR submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO_2_KHR};
+        submit_info.commandBufferInfoCount = 1;
+        submit_info.pCommandBufferInfos = &command_buffer_info;
+        submit_info.signalSemaphoreInfoCount = 1;
+        submit_info.pSignalSemaphoreInfos = &signal_info;
+        if (queue_.Submit2(submit_info) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to submit texture uploads");
+        }
+        submittedValue_ = batch.value;
+
+        {
+            std::lock_guard lock(mutex_);
+            for (StagedLevel& level : staged) {
+                if (level.dedicated) {
+                    batch.dedicated.push_back(std::move(level.dedicated));
+                } else {
+                    ReleaseSpan(level.spanSerial, true, batch.value);
+                }
+                pendingLevels_.push_back(PendingLevel{batch.value, level.id, level.level});
+            }
+        }
+        inFlight_.push_back(std::move(batch));
+    }
+
+    for (Notification& notification : notifications) {
+        notification.callback(notification.id, notification.residentMip);
+    }
+}
+
+void TextureStreamer::RecordAcquireBarriers(const CommandBuffer& command_buffer)
+{
+    if (!UsesOwnershipTransfer() || acquireReady_.empty()) {
+        return;
+    }
+
+    OwnershipTransfer transfer{};
+    transfer.srcFamily = queue_.GetFamilyIndex();
+    transfer.dstFamily = graphicsFamily_;
+    transfer.sourceAccess = {VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL};
+    transfer.destinationAccess = {config_.consumerStages, VK_ACCESS_2_SHADER_READ_BIT_KHR, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+
+    std::vector<VkImageMemoryBarrier2KHR> barriers;
+    barriers.reserve(acquireReady_.size());
+    {
+        std::lock_guard lock(mutex_);
+        for (const PendingLevel& pending : acquireReady_) {
+            const Texture& texture = *textures_.at(pending.id);
+            barriers.push_back(Utils::SyncUtils::CreateOwnershipBarrier(
+                texture.image->GetHandle(), LevelRange(texture, pending.level), transfer, false));
+        }
+    }
+    command_buffer.FlushBarriers();
+    command_buffer.PipelineBarrier2({}, {}, barriers);
+
+    std::vector<Notification> notifications;
+    for (const PendingLevel& pending : acquireReady_) {
+        MarkResident(pending.id, pending.level, notifications);
+    }
+    acquireReady_.clear();
+    for (Notification& notification : notifications) {
+        notification.callback(notification.id, notification.residentMip);
+    }
+}
+
+const Image* TextureStreamer::GetImage(TextureId id) const
+{
+    std::lock_guard lock(mutex_);
+    const auto it = textures_.find(id);
+    return it != textures_.end() ? it->second->image.get() : nullptr;
+}
+
+uint32_t TextureStreamer::GetResidentMip(TextureId id) const
+{
+    std::lock_guard lock(mutex_);
+    const auto it = textures_.find(id);
+    if (it == textures_.end() || !it->second->image || it->second->residentMip == it->second->levelSizes.size()) {
+        return UINT32_MAX;
+    }
+    return it->second->residentMip;
+}
+
+std::string TextureStreamer::GetError(TextureId id) const
+{
+    std::lock_guard lock(mutex_);
+    const auto it = textures_.find(id);
+    return it != textures_.end() ? it->second->error : std::string("Unknown texture");
+}
+
+void TextureStreamer::WorkerLoop()
+{
+    while (true) {
+        Task task;
+        Texture* texture = nullptr;
+        {
+            std::unique_lock lock(mutex_);
+            taskAvailable_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            task = tasks_.top();
+            tasks_.pop();
+            texture = textures_.at(task.id).get();
+            if (!texture->error.empty()) {
+                continue;
+            }
+        }
+
+        try {
+            if (task.open) {
+                OpenTexture(task.id, *texture);
+            } else {
+                StageLevel(task.id, *texture, task.level);
+            }
+        } catch (const std::exception& e) {
+            Fail(task.id, e.what());
+        }
+    }
+}
+
+void TextureStreamer::OpenTexture(TextureId id, Texture& texture)
+{
+    auto file = std::make_unique<Ktx2File>(texture.path);
+
+    const bool supercompressed = file->IsBasisUniversal() || file->GetSupercompression() != Ktx2File::Supercompression::NONE;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    if (supercompressed) {
+        if (!transcoder_) {
+            throw std::runtime_error("Supercompressed KTX2 file needs a TextureTranscoder: " + texture.path);
+        }
+        const std::vector<VkFormat>& candidates = file->IsBasisUniversal()
+            ? (file->IsSrgb() ? transcodeTargetsSrgb_ : transcodeTargetsLinear_)
+            : std::vector<VkFormat>{file->GetFormat()};
+        for (VkFormat candidate : candidates) {
+            if (transcoder_->SupportsTarget(*file, candidate)) {
+                format = candidate;
+                break;
+            }
+        }
+    } else {
+        format = file->GetFormat();
+    }
+    if (format == VK_FORMAT_UNDEFINED ||
+        !device_->GetPhysicalDevice().GetFormatTable().Supports(format, VK_IMAGE_TILING_OPTIMAL,
+                                                                VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT)) {
+        throw std::runtime_error("No supported format to stream " + texture.path);
+    }
+
+    uint32_t block_width = 1;
+    uint32_t block_height = 1;
+    uint32_t block_size = 0;
+    Utils::FormatUtils::GetBlockSize(format, block_width, block_height, block_size);
+
+    const uint32_t layer_count = file->GetLayerCount() * file->GetFaceCount();
+    const uint32_t level_count = file->GetLevelCount();
+    std::vector<VkDeviceSize> level_sizes(level_count);
+    for (uint32_t level = 0; level < level_count; ++level) {
+        const VkDeviceSize blocks_x = (std::max(file->GetWidth() >> level, 1u) + block_width - 1) / block_width;
+        const VkDeviceSize blocks_y = (std::max(file->GetHeight() >> level, 1u) + block_height - 1) / block_height;
+        const VkDeviceSize depth = std::max(file->GetDepth() >> level, 1u);
+        level_sizes[level] = blocks_x * blocks_y * depth * block_size * layer_count;
+        if (!supercompressed && file->GetLevel(level).byteLength < level_sizes[level]) {
+            throw std::runtime_error("KTX2 level data is smaller than its format requires: " + texture.path);
+        }
+    }
+
+    texture.transcode = supercompressed;
+    texture.format = format;
+    texture.width = file->GetWidth();
+    texture.height = file->GetHeight();
+    texture.depth = file->GetDepth();
+    texture.layerCount = layer_count;
+    texture.cube = file->GetFaceCount() == 6;
+    texture.levelSizes = std::move(level_sizes);
+    texture.levelsToStage = level_count;
+    texture.file = std::move(file);
+
+    {
+        std::lock_guard lock(mutex_);
+        opened_.push_back(id);
+        for (uint32_t level = 0; level < level_count; ++level) {
+            tasks_.push(Task{id, false, level, level_count - 1 - level});
+        }
+    }
+    taskAvailable_.notify_all();
+}
+
+void TextureStreamer::StageLevel(TextureId id, Texture& texture, uint32_t level)
+{
+    const VkDeviceSize size = texture.levelSizes[level];
+    const VkDeviceSize aligned = Utils::MemoryUtils::AlignedSize(size, STAGING_ALIGNMENT);
+
+    StagedLevel staged{};
+    staged.id = id;
+    staged.level = level;
+    staged.size = size;
+    std::byte* destination = nullptr;
+    if (aligned > ring_->GetSize()) {
+        staged.dedicated = CreateMappedStaging(*allocator_, size);
+        destination = static_cast<std::byte*>(staged.dedicated->GetMappedData());
+    } else {
+        std::unique_lock lock(mutex_);
+        VkDeviceSize offset = 0;
+        ringSpace_.wait(lock, [&] { return stopping_ || TryAllocateRing(aligned, offset); });
+        if (stopping_) {
+            return;
+        }
+        staged.offset = offset;
+        staged.spanSerial = firstSpanSerial_ + spans_.size();
+        spans_.push_back(RingSpan{offset, offset + aligned});
+        destination = ringData_ + offset;
+    }
+
+    try {
+        if (texture.transcode) {
+            transcoder_->Transcode(*texture.file, level, texture.format, std::span<std::byte>(destination, static_cast<size_t>(size)));
+        } else {
+            std::memcpy(destination, texture.file->GetLevelData(level).data(), static_cast<size_t>(size));
+        }
+        if (staged.dedicated) {
+            staged.dedicated->Flush(size, 0);
+        } else {
+            ring_->Flush(size, staged.offset);
+        }
+    } catch (...) {
+        if (!staged.dedicated) {
+            std::lock_guard lock(mutex_);
+            ReleaseSpan(staged.spanSerial, true, 0);
+        }
+        throw;
+    }
+
+    std::lock_guard lock(mutex_);
+    staged_.push_back(std::move(staged));
+    if (--texture.levelsToStage == 0) {
+        texture.file.reset();
+    }
+}
+
+void TextureStreamer::Fail(TextureId id, const std::string& error)
+{
+    std::lock_guard lock(mutex_);
+    Texture& texture = *textures_.at(id);
+    if (texture.error.empty()) {
+        texture.error = error;
+    }
+    std::cerr << "[TextureStreamer] " << error << '\n';
+}
+
+bool TextureStreamer::TryAllocateRing(VkDeviceSize size, VkDeviceSize& offset)
+{
+    const VkDeviceSize ring_size = ring_->GetSize();
+    if (spans_.empty()) {
+        offset = 0;
+        ringHead_ = size;
+        return true;
+    }
+
+    // Head and tail never meet while spans are live, so equal means empty
+    const VkDeviceSize tail = spans_.front().begin;
+    if (ringHead_ >= tail) {
+        if (ringHead_ + size <= ring_size) {
+            offset = ringHead_;
+            ringHead_ += size;
+            return true;
+        }
+        if (size < tail) {
+            offset = 0;
+            ringHead_ = size;
+            return true;
+        }
+        return false;
+    }
+    if (ringHead_ + size < tail) {
+        offset = ringHead_;
+        ringHead_ += size;
+        return true;
+    }
+    return false;
+}
+
+void TextureStreamer::ReleaseSpan(uint64_t serial, bool submitted, uint64_t value)
+{
+    RingSpan& span = spans_[static_cast<size_t>(serial - firstSpanSerial_)];
+    span.submitted = submitted;
+    span.value = value;
+}
+
+void TextureStreamer::Reclaim(std::vector<Notification>& notifications)
+{
+    const uint64_t completed = timeline_->GetCounterValue();
+
+    while (!inFlight_.empty() && inFlight_.front().value <= completed) {
+        Batch batch = std::move(inFlight_.front());
+        inFlight_.pop_front();
+        batch.commandBuffer.Reset();
+        freeCommandBuffers_.push_back(std::move(batch.commandBuffer));
+    }
+
+    bool freed = false;
+    {
+        std::lock_guard lock(mutex_);
+        while (!spans_.empty() && spans_.front().submitted && spans_.front().value <= completed) {
+            spans_.pop_front();
+            ++firstSpanSerial_;
+            freed = true;
+        }
+    }
+    if (freed) {
+        ringSpace_.notify_all();
+    }
+
+    while (!pendingLevels_.empty() && pendingLevels_.front().value <= completed) {
+        const PendingLevel pending = pendingLevels_.front();
+        pendingLevels_.pop_front();
+        if (UsesOwnershipTransfer()) {
+            acquireReady_.push_back(pending);
+        } else {
+            MarkResident(pending.id, pending.level, notifications);
+        }
+    }
+}
+
+void TextureStreamer::MarkResident(TextureId id, uint32_t level, std::vector<Notification>& notifications)
+{
+    std::lock_guard lock(mutex_);
+    Texture& texture = *textures_.at(id);
+    texture.levelResident[level] = true;
+
+    ResourceState state{};
+    state.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    state.readStages = config_.consumerStages;
+    state.readAccess = VK_ACCESS_2_SHADER_READ_BIT_KHR;
+    texture.image->SetTrackedState(state, level, 1);
+
+    uint32_t resident = texture.residentMip;
+    while (resident > 0 && texture.levelResident[resident - 1]) {
+        --resident;
+    }
+    if (resident != texture.residentMip) {
+        texture.residentMip = resident;
+        if (texture.onResident) {
+            notifications.push_back(Notification{texture.onResident, id, resident});
+        }
+    }
+}
+
+VkImageSubresourceRange TextureStreamer::LevelRange(const Texture& texture, uint32_t level) const
+{
+    VkImageSubresourceRange range{};
+    range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    range.baseMipLevel = level;
+    range.levelCount = 1;
+    range.baseArrayLayer = 0;
+    range.layerCount = texture.layerCount;
+    return range;
+}
+
+} // namespace VulkanEngine::RAII
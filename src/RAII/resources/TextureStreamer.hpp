@@ -0,0 +1,230 @@
+#ifndef VULKAN_RAII_RESOURCES_TEXTURE_STREAMER_HPP
+#define VULKAN_RAII_RESOURCES_TEXTURE_STREAMER_HPP
+
+#include <volk.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Buffer.hpp"
+#include "Image.hpp"
+#include "Ktx2File.hpp"
+#include "../core/Queue.hpp"
+#include "../rendering/CommandBuffer.hpp"
+#include "../rendering/CommandPool.hpp"
+#include "../sync/Semaphore.hpp"
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+class VmaAllocator; // Forward declaration
+
+using TextureId = uint32_t;
+inline constexpr TextureId INVALID_TEXTURE_ID = 0;
+
+// Decodes supercompressed KTX2 payloads (Basis Universal ETC1S/UASTC, zstd) into a GPU
+// format. The library carries no Basis Universal decoder; wrap one such as basisu's
+// ktx2_transcoder in this interface. Called concurrently from the streamer's workers
+class TextureTranscoder {
+public:
+    virtual ~TextureTranscoder() = default;
+
+    // Whether the levels of file can be decoded into format
+    [[nodiscard]] virtual bool SupportsTarget(const Ktx2File& file, VkFormat format) const = 0;
+
+    // Decode every layer, face and slice of level into destination, tightly packed in the
+    // order vkCmdCopyBufferToImage reads them. destination is exactly the level's size
+    virtual void Transcode(const Ktx2File& file, uint32_t level, VkFormat format, std::span<std::byte> destination) const = 0;
+};
+
+struct TextureStreamerConfig {
+    uint32_t workerCount{0}; // 0 uses one worker per hardware thread but one
+    VkDeviceSize stagingRingSize{64ull * 1024 * 1024}; // Larger levels get a dedicated staging buffer
+    VkImageUsageFlags usage{VK_IMAGE_USAGE_SAMPLED_BIT}; // TRANSFER_DST is always added
+    // Stages that sample the textures; acquires on the graphics queue make them wait
+    VkPipelineStageFlags2KHR consumerStages{VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR};
+};
+
+// Streams KTX2 textures into device-local images. Worker threads memory-map each file,
+// then copy or transcode its levels straight into a persistently mapped staging ring,
+// coarsest level first across all pending textures. Update() records the staged levels
+// on the transfer queue in one batch and signals a timeline semaphore. Images stay
+// VK_SHARING_MODE_EXCLUSIVE; with a dedicated transfer family the levels are released
+// there and acquired by RecordAcquireBarriers on the graphics queue.
+// Each level is left in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL. The residency callback
+// reports the most detailed level from which every coarser level is readable, so a
+// view with that baseMipLevel (or a sampler minLod) can sample while the rest streams in.
+// Load may be called from any thread; Update and RecordAcquireBarriers from one thread.
+class TextureStreamer {
+public:
+    using ResidencyCallback = std::function<void(TextureId id, uint32_t resident_mip)>;
+
+    TextureStreamer(const Device& device,
+                    const VmaAllocator& allocator,
+                    const QueueManager& queues,
+                    const TextureStreamerConfig& config = {},
+                    std::shared_ptr<const TextureTranscoder> transcoder = nullptr);
+
+    // Destructor stops the workers and waits for submitted uploads
+    ~TextureStreamer();
+
+    // Delete copy and move. the workers hold a pointer to this object.
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+    TextureStreamer(TextureStreamer&&) = delete;
+    TextureStreamer& operator=(TextureStreamer&&) = delete;
+
+    // Queue a texture; on_resident runs on the thread calling Update (or
+    // RecordAcquireBarriers) whenever a more detailed level becomes readable.
+    // Failures are reported by GetError
+    TextureId Load(const std::string& path, ResidencyCallback on_resident = {});
+
+    // Create images for opened files, submit the staged levels, recycle staging memory
+    // and report finished uploads. Call once per frame
+    void Update();
+
+    // Record the acquires of levels the transfer queue finished into a graphics queue
+    // command buffer; their callbacks run here. No-op without a dedicated transfer family
+    void RecordAcquireBarriers(const CommandBuffer& command_buffer);
+
+    // Null until the file has been opened and Update created the image
+    [[nodiscard]] const Image* GetImage(TextureId id) const;
+
+    // Most detailed readable level, UINT32_MAX while none is
+    [[nodiscard]] uint32_t GetResidentMip(TextureId id) const;
+
+    [[nodiscard]] bool IsComplete(TextureId id) const { return GetResidentMip(id) == 0; }
+
+    // Why the texture failed to load; empty while it has not
+    [[nodiscard]] std::string GetError(TextureId id) const;
+
+    // Signalled with increasing values by the upload batches
+    [[nodiscard]] VkSemaphore GetTimelineSemaphore() const { return timeline_->GetHandle(); }
+    [[nodiscard]] uint64_t GetSubmittedValue() const { return submittedValue_; }
+
+private:
+    struct Texture {
+        std::string path;
+        ResidencyCallback onResident;
+        std::unique_ptr<Ktx2File> file; // Released once every level is staged
+        bool transcode{false};
+        VkFormat format{VK_FORMAT_UNDEFINED};
+        uint32_t width{0};
+        uint32_t height{0};
+        uint32_t depth{1};
+        uint32_t layerCount{1}; // Array layers times faces
+        bool cube{false};
+        std::vector<VkDeviceSize> levelSizes;
+        uint32_t levelsToStage{0};
+        std::string error;
+
+        // Update thread only
+        std::unique_ptr<Image> image;
+        std::vector<bool> levelResident;
+        uint32_t residentMip{0}; // levelSizes.size() while none
+    };
+
+    struct Task {
+        TextureId id{INVALID_TEXTURE_ID};
+        bool open{false};
+        uint32_t level{0};
+        uint32_t rank{0}; // Distance from the coarsest level; lower runs first
+
+        bool operator<(const Task& other) const; // priority_queue order
+    };
+
+    struct RingSpan {
+        VkDeviceSize begin{0};
+        VkDeviceSize end{0};
+        bool submitted{false};
+        uint64_t value{0}; // Timeline value after which the span is free again
+    };
+
+    struct StagedLevel {
+        TextureId id{INVALID_TEXTURE_ID};
+        uint32_t level{0};
+        VkDeviceSize offset{0};
+        VkDeviceSize size{0};
+        uint64_t spanSerial{0}; // 0 with a dedicated buffer
+        std::unique_ptr<Buffer> dedicated;
+    };
+
+    struct Batch {
+        CommandBuffer commandBuffer;
+        uint64_t value{0};
+        std::vector<std::unique_ptr<Buffer>> dedicated;
+    };
+
+    struct Notification {
+        ResidencyCallback callback;
+        TextureId id{INVALID_TEXTURE_ID};
+        uint32_t residentMip{0};
+    };
+
+    struct PendingLevel {
+        uint64_t value{0};
+        TextureId id{INVALID_TEXTURE_ID};
+        uint32_t level{0};
+    };
+
+    const Device* device_{nullptr};
+    const VmaAllocator* allocator_{nullptr};
+    std::shared_ptr<const TextureTranscoder> transcoder_;
+    TextureStreamerConfig config_;
+    Queue queue_;
+    uint32_t graphicsFamily_{0};
+    std::vector<VkFormat> transcodeTargetsSrgb_;
+    std::vector<VkFormat> transcodeTargetsLinear_;
+    std::unique_ptr<CommandPool> commandPool_;
+    std::unique_ptr<Semaphore> timeline_;
+    std::unique_ptr<Buffer> ring_;
+    std::byte* ringData_{nullptr};
+
+    mutable std::mutex mutex_;
+    std::condition_variable taskAvailable_;
+    std::condition_variable ringSpace_;
+    bool stopping_{false};
+    std::unordered_map<TextureId, std::unique_ptr<Texture>> textures_;
+    TextureId nextId_{1};
+    std::priority_queue<Task> tasks_;
+    std::vector<TextureId> opened_;
+    std::vector<StagedLevel> staged_;
+    std::deque<RingSpan> spans_;
+    uint64_t firstSpanSerial_{1}; // Serial of spans_.front()
+    VkDeviceSize ringHead_{0};
+    std::vector<std::thread> workers_;
+
+    // Update thread only
+    uint64_t submittedValue_{0};
+    std::deque<Batch> inFlight_;
+    std::vector<CommandBuffer> freeCommandBuffers_;
+    std::deque<PendingLevel> pendingLevels_;
+    std::vector<PendingLevel> acquireReady_;
+
+    [[nodiscard]] bool UsesOwnershipTransfer() const { return queue_.GetFamilyIndex() != graphicsFamily_; }
+
+    void WorkerLoop();
+    void OpenTexture(TextureId id, Texture& texture);
+    void StageLevel(TextureId id, Texture& texture, uint32_t level);
+    void Fail(TextureId id, const std::string& error);
+    bool TryAllocateRing(VkDeviceSize size, VkDeviceSize& offset); // mutex_ held
+    void ReleaseSpan(uint64_t serial, bool submitted, uint64_t value); // mutex_ held
+    void Reclaim(std::vector<Notification>& notifications);
+    void MarkResident(TextureId id, uint32_t level, std::vector<Notification>& notifications);
+    VkImageSubresourceRange LevelRange(const Texture& texture, uint32_t level) const;
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RESOURCES_TEXTURE_STREAMER_HPP
@@ -0,0 +1,96 @@
+#include "TransientAllocator.hpp"
+
+#include "VmaAllocator.hpp"
+#include "../rendering/Renderer.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+
+namespace VulkanEngine::RAII {
+
+TransientAllocator::TransientAllocator(const VmaAllocator& allocator,
+                                       uint32_t frame_count,
+                                       VkDeviceSize bytes_per_frame,
+                                       VkBufferUsageFlags usage,
+                                       VmaMemoryUsage memory_usage,
+                                       VmaAllocationCreateFlags allocation_flags)
+    : usage_(usage),
+    allocationFlags_(allocation_flags)
+{
+    if (bytes_per_frame == 0 || usage == 0) {
+        throw std::invalid_argument("TransientAllocator requires a frame size and buffer usage");
+    }
+
+    const uint32_t count = std::max(1u, frame_count);
+    frames_.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        frames_.push_back(Frame{MemoryPool::CreateLinearForBuffers(allocator,
+                                                                   usage,
+                                                                   bytes_per_frame,
+                                                                   memory_usage,
+                                                                   allocation_flags),
+                                {}});
+    }
+}
+
+TransientAllocator::~TransientAllocator()
+{
+    Detach();
+    // Buffers must be destroyed before their pools
+    for (Frame& frame : frames_) {
+        ReleaseFrame(frame);
+    }
+}
+
+void TransientAllocator::AttachToRenderer(Renderer& renderer)
+{
+    Detach();
+    if (renderer.GetMaxFramesInFlight() > frames_.size()) {
+        throw std::invalid_argument("TransientAllocator has fewer frames than the renderer has frames in flight");
+    }
+    frameBeginSubscription_ = renderer.SubscribeFrameBegin([this](uint32_t frame_index) {
+        BeginFrame(frame_index);
+    });
+}
+
+void TransientAllocator::Detach()
+{
+    frameBeginSubscription_.Reset();
+}
+
+void TransientAllocator::BeginFrame(uint32_t frame_index)
+{
+    currentFrame_ = frame_index % static_cast<uint32_t>(frames_.size());
+    ReleaseFrame(frames_[currentFrame_]);
+}
+
+Buffer& TransientAllocator::Allocate(VkDeviceSize size, VkBufferUsageFlags usage, const char* name)
+{
+    if (size == 0) {
+        throw std::invalid_argument("TransientAllocator allocation size must be non-zero");
+    }
+    if (usage != 0 && (usage & ~usage_) != 0) {
+        throw std::invalid_argument("TransientAllocator usage exceeds the pool's usage mask");
+    }
+
+    Frame& frame = frames_[currentFrame_];
+    return frame.buffers.emplace_back(frame.pool, size, usage != 0 ? usage : usage_, allocationFlags_, name);
+}
+
+VkDeviceSize TransientAllocator::GetUsedBytes() const
+{
+    return frames_[currentFrame_].pool.GetStatistics().allocationBytes;
+}
+
+void TransientAllocator::ReleaseFrame(Frame& frame)
+{
+    // No pool-wide reset in VMA and each buffer owns a VkBuffer, so free one by one,
+    // newest first so the linear pool unwinds like a stack
+    while (!frame.buffers.empty()) {
+        frame.buffers.pop_back();
+    }
+}
+
+} // namespace VulkanEngine::RAII
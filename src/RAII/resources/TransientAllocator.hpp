@@ -0,0 +1,83 @@
+#ifndef VULKAN_RAII_RESOURCES_TRANSIENT_ALLOCATOR_HPP
+#define VULKAN_RAII_RESOURCES_TRANSIENT_ALLOCATOR_HPP
+
+#include <volk.h>
+#include <vk_mem_alloc.h>
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "../rendering/FrameBeginSubscription.hpp"
+#include "Buffer.hpp"
+#include "MemoryPool.hpp"
+
+namespace VulkanEngine::RAII {
+
+class VmaAllocator; // Forward declaration
+class Renderer; // Forward declaration
+
+// Frame-scoped scratch buffer allocator. Each frame in flight owns a linear VMA
+// pool; buffers handed out during a frame live until that frame index comes
+// around again, at which point they are all released. VMA cannot reset a pool in
+// one call and every scratch buffer is its own VkBuffer, so each one is still
+// destroyed individually. Newest first, which keeps the linear pool's frees
+// O(1) and never fragments it. For one-call resets of host-visible data use
+// FrameRingBuffer, which bump-allocates ranges of a single buffer.
+class TransientAllocator {
+public:
+    // Constructor that creates one linear pool of bytes_per_frame per frame in flight.
+    // usage is the union of usages the scratch buffers may request
+    TransientAllocator(const VmaAllocator& allocator,
+                       uint32_t frame_count,
+                       VkDeviceSize bytes_per_frame,
+                       VkBufferUsageFlags usage,
+                       VmaMemoryUsage memory_usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+                       VmaAllocationCreateFlags allocation_flags = 0);
+
+    // Destructor
+    ~TransientAllocator();
+
+    // Delete copy and move. the attached renderer holds a callback referencing this object.
+    TransientAllocator(const TransientAllocator&) = delete;
+    TransientAllocator& operator=(const TransientAllocator&) = delete;
+    TransientAllocator(TransientAllocator&&) = delete;
+    TransientAllocator& operator=(TransientAllocator&&) = delete;
+
+    // Release frames automatically from Renderer::BeginFrame. The renderer must outlive
+    // this allocator or Detach() must be called first
+    void AttachToRenderer(Renderer& renderer);
+    void Detach();
+
+    // Release every buffer of frame_index and make it current (called by the attached renderer)
+    void BeginFrame(uint32_t frame_index);
+
+    // Allocate a scratch buffer valid until the current frame index is reused.
+    // usage defaults to the allocator's usage mask when 0
+    Buffer& Allocate(VkDeviceSize size, VkBufferUsageFlags usage = 0, const char* name = nullptr);
+
+    // Bytes used in the current frame's pool
+    [[nodiscard]] VkDeviceSize GetUsedBytes() const;
+
+    [[nodiscard]] uint32_t GetFrameCount() const { return static_cast<uint32_t>(frames_.size()); }
+    [[nodiscard]] uint32_t GetCurrentFrame() const { return currentFrame_; }
+
+private:
+    struct Frame {
+        MemoryPool pool;
+        std::deque<Buffer> buffers;
+    };
+
+    std::vector<Frame> frames_;
+    VkBufferUsageFlags usage_{0};
+    VmaAllocationCreateFlags allocationFlags_{0};
+    uint32_t currentFrame_{0};
+
+    FrameBeginSubscription frameBeginSubscription_;
+
+    void ReleaseFrame(Frame& frame);
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RESOURCES_TRANSIENT_ALLOCATOR_HPP
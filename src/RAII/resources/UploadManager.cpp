@@ -0,0 +1,411 @@
+#include "UploadManager.hpp"
+
+#include "Image.hpp"
+#include "VmaAllocator.hpp"
+#include "../core/Device.hpp"
+#include "../core/PhysicalDevice.hpp"
+#include "../utils/FormatUtils.hpp"
+#include "../utils/MemoryUtils.hpp"
+#include "../utils/PerfCounters.hpp"
+#include "../utils/SyncUtils.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+namespace VulkanEngine::RAII {
+
+namespace {
+// Base alignment of staging offsets, a multiple of the 4 bytes buffer->image copies
+// need. Image copies also need a multiple of the texel block size, which 16 misses for
+// 3, 6, 12 and 24-byte blocks, so UploadImage aligns to the lcm of both
+constexpr VkDeviceSize STAGING_OFFSET_ALIGNMENT = 16;
+
+// Whether a copy along one axis, in texel blocks, meets a transfer granularity: the offset
+// must be a multiple of it and the size too unless it reaches the level's edge
+bool FitsGranularity(uint32_t granularity, int32_t offset, uint32_t size, uint32_t level_size)
+{
+    const uint64_t end = static_cast<uint64_t>(offset) + size;
+    if (granularity == 0) {
+        return offset == 0 && end == level_size;
+    }
+    return static_cast<uint32_t>(offset) % granularity == 0 && (size % granularity == 0 || end == level_size);
+}
+
+// Bytes per texel block a copy of aspect moves
+VkDeviceSize GetCopyBlockSize(VkFormat format, VkImageAspectFlags aspect)
+{
+    if (Utils::FormatUtils::IsCompressedFormat(format)) {
+        uint32_t block_width = 1;
+        uint32_t block_height = 1;
+        uint32_t block_size = 0;
+        Utils::FormatUtils::GetBlockSize(format, block_width, block_height, block_size);
+        return std::max(block_size, 1u);
+    }
+    return std::max(Utils::FormatUtils::GetAspectCopySize(format, aspect), 1u);
+}
+} // namespace
+
+UploadManager::UploadManager(const Device& device,
+                             const VmaAllocator& allocator,
+                             const QueueManager& queues,
+                             VkDeviceSize staging_chunk_size,
+                             VkDeviceSize batch_budget)
+    : device_(&device),
+    allocator_(&allocator),
+    queue_(queues.HasTransferQueue() ? queues.GetTransferQueue() : queues.GetGraphicsQueue()),
+    graphicsFamily_(queues.HasGraphicsQueue() ? queues.GetGraphicsQueue().GetFamilyIndex() : queue_.GetFamilyIndex()),
+    stagingChunkSize_(std::max<VkDeviceSize>(staging_chunk_size, STAGING_OFFSET_ALIGNMENT)),
+    batchBudget_(batch_budget),
+    copyOffsetAlignment_(STAGING_OFFSET_ALIGNMENT)
+{
+    if (!queue_.IsValid()) {
+        throw std::runtime_error("UploadManager requires a transfer or graphics queue");
+    }
+    if (!device.SupportsTimelineSemaphores()) {
+        throw std::runtime_error("UploadManager requires timeline semaphore support");
+    }
+    const auto& families = device.GetPhysicalDevice().GetQueueFamilyProperties();
+    if (queue_.GetFamilyIndex() < families.size()) {
+        transferGranularity_ = families[queue_.GetFamilyIndex()].minImageTransferGranularity;
+    }
+
+    commandPool_ = std::make_unique<CommandPool>(device,
+                                                 queue_.GetFamilyIndex(),
+                                                 VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+    timeline_ = std::make_unique<Semaphore>(device, uint64_t{0});
+}
+
+UploadManager::~UploadManager()
+{
+    try {
+        Submit();
+        (void)WaitIdle();
+    } catch (const std::exception& e) {
+        std::cerr << "[UploadManager] Failed to drain uploads on destruction: " << e.what() << '\n';
+    }
+}
+
+UploadTicket UploadManager::UploadBuffer(Buffer& dst_buffer,
+                                         const void* data,
+                                         VkDeviceSize size,
+                                         VkDeviceSize dst_offset,
+                                         const ResourceAccess& consumer)
+{
+    if (!data || size == 0) {
+        throw std::invalid_argument("UploadBuffer requires data and a non-zero size");
+    }
+    if (dst_offset > dst_buffer.GetSize() || size > dst_buffer.GetSize() - dst_offset) {
+        throw std::out_of_range("UploadBuffer range exceeds destination buffer size");
+    }
+
+    Batch& batch = GetRecordingBatch();
+    auto [staging_buffer, staging_offset] = StageData(batch, data, size, copyOffsetAlignment_);
+
+    VkBufferCopy region{};
+    region.srcOffset = staging_offset;
+    region.dstOffset = dst_offset;
+    region.size = size;
+    batch.commandBuffer.CopyBuffer(staging_buffer, dst_buffer.GetHandle(), std::span<const VkBufferCopy>(&region, 1));
+
+    OwnershipTransfer transfer{};
+    transfer.srcFamily = queue_.GetFamilyIndex();
+    transfer.dstFamily = graphicsFamily_;
+    transfer.sourceAccess = {VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR};
+    transfer.destinationAccess = consumer;
+    if (UsesOwnershipTransfer()) {
+        // Only the uploaded range changes hands; the rest of the buffer stays with graphics
+        dst_buffer.ReleaseOwnership(batch.commandBuffer, transfer, dst_offset, size);
+        batch.acquires.push_back(PendingAcquire{&dst_buffer, nullptr, dst_offset, size, {}, transfer});
+    } else {
+        // Within the family the acquire is the barrier to the consumer
+        dst_buffer.AcquireOwnership(batch.commandBuffer, transfer, dst_offset, size);
+    }
+
+    return FinishRecord();
+}
+
+UploadTicket UploadManager::UploadImage(Image& dst_image,
+                                        const void* data,
+                                        VkDeviceSize size,
+                                        const VkBufferImageCopy& region,
+                                        const ResourceAccess& consumer)
+{
+    if (dst_image.GetHandle() == VK_NULL_HANDLE || !data || size == 0) {
+        throw std::invalid_argument("UploadImage requires an image, data and a non-zero size");
+    }
+    if (consumer.layout == VK_IMAGE_LAYOUT_UNDEFINED) {
+        throw std::invalid_argument("UploadImage requires the layout the consumer reads the image in");
+    }
+    const VkImageSubresourceLayers& layers = region.imageSubresource;
+    if (layers.mipLevel >= dst_image.GetMipLevels() || layers.layerCount == 0 ||
+        layers.baseArrayLayer + layers.layerCount > dst_image.GetArrayLayers()) {
+        throw std::out_of_range("UploadImage region exceeds the image's levels or layers");
+    }
+
+    const uint32_t mip_level = layers.mipLevel;
+    // Granularities are in texel blocks; the graphics family always reports (1, 1, 1)
+    uint32_t block_width = 1;
+    uint32_t block_height = 1;
+    if (Utils::FormatUtils::IsCompressedFormat(dst_image.GetFormat())) {
+        uint32_t block_size = 0;
+        Utils::FormatUtils::GetBlockSize(dst_image.GetFormat(), block_width, block_height, block_size);
+    }
+    const auto blocks = [](uint32_t texels, uint32_t block) { return (texels + block - 1) / block; };
+    if (region.imageOffset.x < 0 || region.imageOffset.y < 0 || region.imageOffset.z < 0 ||
+        !FitsGranularity(transferGranularity_.width, region.imageOffset.x / static_cast<int32_t>(block_width),
+                         blocks(region.imageExtent.width, block_width),
+                         blocks(std::max(dst_image.GetWidth() >> mip_level, 1u), block_width)) ||
+        !FitsGranularity(transferGranularity_.height, region.imageOffset.y / static_cast<int32_t>(block_height),
+                         blocks(region.imageExtent.height, block_height),
+                         blocks(std::max(dst_image.GetHeight() >> mip_level, 1u), block_height)) ||
+        !FitsGranularity(transferGranularity_.depth, region.imageOffset.z, region.imageExtent.depth,
+                         std::max(dst_image.GetDepth() >> mip_level, 1u))) {
+        throw std::invalid_argument("UploadImage region does not meet the upload queue's image transfer granularity; "
+                                    "align it or upload whole levels");
+    }
+
+    const VkImageSubresourceRange range{layers.aspectMask, mip_level, 1, layers.baseArrayLayer, layers.layerCount};
+    const bool whole_level = region.imageOffset.x == 0 && region.imageOffset.y == 0 && region.imageOffset.z == 0 &&
+                             region.imageExtent.width >= std::max(dst_image.GetWidth() >> mip_level, 1u) &&
+                             region.imageExtent.height >= std::max(dst_image.GetHeight() >> mip_level, 1u) &&
+                             region.imageExtent.depth >= std::max(dst_image.GetDepth() >> mip_level, 1u);
+
+    // A region covering the level overwrites every texel, so earlier contents are discarded;
+    // a partial one transitions from the tracked layout, one run of equal layers at a time
+    std::vector<VkImageMemoryBarrier2KHR> to_transfer;
+    for (uint32_t layer = range.baseArrayLayer; layer < range.baseArrayLayer + range.layerCount; ++layer) {
+        const ResourceState& state = dst_image.GetTrackedState(mip_level, layer);
+        const VkImageLayout old_layout = whole_level ? VK_IMAGE_LAYOUT_UNDEFINED : state.layout;
+        if (old_layout != VK_IMAGE_LAYOUT_UNDEFINED && UsesOwnershipTransfer()) {
+            throw std::invalid_argument("UploadImage cannot partially update a level the graphics queue owns; "
+                                        "upload whole levels or record the copy on the graphics queue");
+        }
+        if (!to_transfer.empty() && to_transfer.back().oldLayout == old_layout) {
+            ++to_transfer.back().subresourceRange.layerCount;
+            continue;
+        }
+        VkImageMemoryBarrier2KHR barrier = Utils::SyncUtils::CreateImageBarrier2(
+            dst_image.GetHandle(), old_layout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VkImageSubresourceRange{range.aspectMask, mip_level, 1, layer, 1});
+        // Earlier uses are on this family (or discarded), so they can be waited for here
+        barrier.srcStageMask = UsesOwnershipTransfer() ? VK_PIPELINE_STAGE_2_NONE_KHR : state.writeStages | state.readStages;
+        barrier.srcAccessMask = UsesOwnershipTransfer() ? VK_ACCESS_2_NONE_KHR : state.writeAccess;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR;
+        barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR;
+        to_transfer.push_back(barrier);
+    }
+
+    const VkDeviceSize staging_alignment = std::lcm(copyOffsetAlignment_,
+                                                    GetCopyBlockSize(dst_image.GetFormat(), layers.aspectMask));
+    Batch& batch = GetRecordingBatch();
+    auto [staging_buffer, staging_offset] = StageData(batch, data, size, staging_alignment);
+
+    batch.commandBuffer.PipelineBarrier2({}, {}, to_transfer);
+    VkBufferImageCopy staged_region = region;
+    staged_region.bufferOffset = staging_offset;
+    batch.commandBuffer.CopyBufferToImage(staging_buffer, dst_image.GetHandle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                          std::span<const VkBufferImageCopy>(&staged_region, 1));
+
+    OwnershipTransfer transfer{};
+    transfer.srcFamily = queue_.GetFamilyIndex();
+    transfer.dstFamily = graphicsFamily_;
+    transfer.sourceAccess = {VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL};
+    transfer.destinationAccess = consumer;
+    if (UsesOwnershipTransfer()) {
+        dst_image.ReleaseOwnership(batch.commandBuffer, transfer, range);
+        batch.acquires.push_back(PendingAcquire{nullptr, &dst_image, 0, 0, range, transfer});
+
+        // The level now has contents, so later partial uploads into it are refused
+        ResourceState released{};
+        released.layout = consumer.layout;
+        dst_image.SetTrackedState(released, mip_level, 1, range.baseArrayLayer, range.layerCount);
+    } else {
+        // Within the family the acquire is the transition to the consumer
+        dst_image.AcquireOwnership(batch.commandBuffer, transfer, range);
+    }
+
+    return FinishRecord();
+}
+
+void UploadManager::RecordAcquireBarriers(const CommandBuffer& command_buffer)
+{
+    Collect();
+    for (const PendingAcquire& acquire : acquireReady_) {
+        if (acquire.buffer != nullptr) {
+            acquire.buffer->AcquireOwnership(command_buffer, acquire.transfer, acquire.offset, acquire.size);
+        } else {
+            acquire.image->AcquireOwnership(command_buffer, acquire.transfer, acquire.range);
+        }
+    }
+    acquireReady_.clear();
+}
+
+UploadTicket UploadManager::Submit()
+{
+    if (!recording_) {
+        return UploadTicket{submittedValue_};
+    }
+
+    std::unique_ptr<Batch> batch = std::move(recording_);
+    batch->commandBuffer.End();
+    const VkCommandBuffer command_buffer = batch->commandBuffer.GetHandle();
+
+    VkSemaphore signal_semaphore = timeline_->GetHandle();
+    VkTimelineSemaphoreSubmitInfo timeline_info{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+    timeline_info.signalSemaphoreValueCount = 1;
+    timeline_info.pSignalSemaphoreValues = &batch->signalValue;
+
+    VkSubmitInfo submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    submit_info.pNext = &timeline_info;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &command_buffer;
+    submit_info.signalSemaphoreCount = 1;
+    submit_info.pSignalSemaphores = &signal_semaphore;
+
+    {
+        const std::unique_lock<std::mutex> lock = queue_.LockSubmission();
+        Utils::PerfCounters::AddSubmits();
+        if (vkQueueSubmit(queue_.GetHandle(), 1, &submit_info, VK_NULL_HANDLE) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to submit upload batch");
+        }
+    }
+
+    submittedValue_ = batch->signalValue;
+    inFlight_.push_back(std::move(batch));
+
+    Collect();
+    return UploadTicket{submittedValue_};
+}
+
+bool UploadManager::IsComplete(UploadTicket ticket) const
+{
+    if (!ticket.IsValid()) {
+        return true;
+    }
+    if (ticket.value > submittedValue_) {
+        return false;
+    }
+    return GetCompletedValue() >= ticket.value;
+}
+
+VkResult UploadManager::Wait(UploadTicket ticket, uint64_t timeout)
+{
+    if (!ticket.IsValid()) {
+        return VK_SUCCESS;
+    }
+    if (ticket.value > submittedValue_) {
+        Submit();
+    }
+    VkResult result = timeline_->Wait(ticket.value, timeout);
+    if (result == VK_SUCCESS) {
+        Collect();
+    }
+    return result;
+}
+
+VkResult UploadManager::WaitIdle(uint64_t timeout)
+{
+    if (submittedValue_ == 0) {
+        return VK_SUCCESS;
+    }
+    VkResult result = timeline_->Wait(submittedValue_, timeout);
+    if (result == VK_SUCCESS) {
+        Collect();
+    }
+    return result;
+}
+
+void UploadManager::Collect()
+{
+    if (inFlight_.empty()) {
+        return;
+    }
+
+    const uint64_t completed = GetCompletedValue();
+    while (!inFlight_.empty() && inFlight_.front()->signalValue <= completed) {
+        std::unique_ptr<Batch> batch = std::move(inFlight_.front());
+        inFlight_.pop_front();
+
+        // Keep standard-sized chunks for reuse, drop oversized dedicated ones
+        std::erase_if(batch->staging, [this](const StagingChunk& chunk) {
+            return chunk.buffer.GetSize() != stagingChunkSize_;
+        });
+        for (StagingChunk& chunk : batch->staging) {
+            chunk.used = 0;
+        }
+        batch->stagedBytes = 0;
+        acquireReady_.insert(acquireReady_.end(), batch->acquires.begin(), batch->acquires.end());
+        batch->acquires.clear();
+        batch->commandBuffer.Reset();
+        freeBatches_.push_back(std::move(batch));
+    }
+}
+
+uint64_t UploadManager::GetCompletedValue() const
+{
+    return timeline_->GetCounterValue();
+}
+
+UploadManager::Batch& UploadManager::GetRecordingBatch()
+{
+    if (recording_) {
+        return *recording_;
+    }
+
+    if (!freeBatches_.empty()) {
+        recording_ = std::move(freeBatches_.back());
+        freeBatches_.pop_back();
+    } else {
+        recording_ = std::make_unique<Batch>(Batch{CommandBuffer(*commandPool_)});
+    }
+    recording_->signalValue = submittedValue_ + 1;
+    recording_->commandBuffer.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    return *recording_;
+}
+
+std::pair<VkBuffer, VkDeviceSize> UploadManager::StageData(Batch& batch, const void* data, VkDeviceSize size, VkDeviceSize alignment)
+{
+    Utils::PerfCounters::AddBytesUploaded(size);
+    StagingChunk* target = nullptr;
+    VkDeviceSize offset = 0;
+    for (StagingChunk& chunk : batch.staging) {
+        VkDeviceSize aligned = Utils::MemoryUtils::AlignedSize(chunk.used, alignment);
+        if (aligned + size <= chunk.buffer.GetSize()) {
+            target = &chunk;
+            offset = aligned;
+            break;
+        }
+    }
+
+    if (!target) {
+        const VkDeviceSize chunk_size = std::max(size, stagingChunkSize_);
+        batch.staging.push_back(StagingChunk{Buffer::CreateStaging(*allocator_, chunk_size), 0});
+        target = &batch.staging.back();
+        offset = 0;
+    }
+
+    target->buffer.WriteData(data, size, offset);
+    target->used = offset + size;
+    batch.stagedBytes += size;
+    return {target->buffer.GetHandle(), offset};
+}
+
+UploadTicket UploadManager::FinishRecord()
+{
+    UploadTicket ticket{recording_->signalValue};
+    if (batchBudget_ != 0 && recording_->stagedBytes >= batchBudget_) {
+        Submit();
+    }
+    return ticket;
+}
+
+} // namespace VulkanEngine::RAII
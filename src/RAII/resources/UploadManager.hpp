@@ -0,0 +1,167 @@
+#ifndef VULKAN_RAII_RESOURCES_UPLOAD_MANAGER_HPP
+#define VULKAN_RAII_RESOURCES_UPLOAD_MANAGER_HPP
+
+#include <volk.h>
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "Buffer.hpp"
+#include "../core/Queue.hpp"
+#include "../rendering/CommandBuffer.hpp"
+#include "../rendering/CommandPool.hpp"
+#include "../sync/ResourceState.hpp"
+#include "../sync/Semaphore.hpp"
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+class VmaAllocator; // Forward declaration
+class Image; // Forward declaration
+
+// Handle returned for every queued upload. The upload is complete once the
+// manager's timeline semaphore reaches the ticket value.
+struct UploadTicket {
+    uint64_t value{0};
+
+    [[nodiscard]] bool IsValid() const { return value != 0; }
+};
+
+// Batches staging -> device-local buffer copies on the transfer queue.
+// Uploads are recorded into the current batch until Submit() is called (or the
+// batch exceeds its staging budget); completion is tracked with a timeline
+// semaphore, so neither the CPU nor the graphics queue has to idle.
+// Resources stay VK_SHARING_MODE_EXCLUSIVE. With a dedicated transfer family each upload
+// is released there and must be acquired on the graphics queue: an upload is usable
+// once its ticket completed and RecordAcquireBarriers recorded its acquire. Without
+// one the upload ends in a barrier to the consumer's stages, so the ticket suffices.
+// Destinations must outlive their acquire.
+// Not thread-safe: record uploads from one thread or guard externally.
+class UploadManager {
+public:
+    // Constructor that creates the transfer command pool and timeline semaphore
+    UploadManager(const Device& device,
+                  const VmaAllocator& allocator,
+                  const QueueManager& queues,
+                  VkDeviceSize staging_chunk_size = 8ull * 1024 * 1024,
+                  VkDeviceSize batch_budget = 64ull * 1024 * 1024);
+
+    // Destructor waits for outstanding uploads before releasing staging memory
+    ~UploadManager();
+
+    // Delete copy and move. in-flight batches reference the manager's pool and semaphore.
+    UploadManager(const UploadManager&) = delete;
+    UploadManager& operator=(const UploadManager&) = delete;
+    UploadManager(UploadManager&&) = delete;
+    UploadManager& operator=(UploadManager&&) = delete;
+
+    // Queue a host -> buffer upload; data is copied into staging memory immediately.
+    // consumer is the first use of the range on the graphics queue
+    UploadTicket UploadBuffer(Buffer& dst_buffer,
+                              const void* data,
+                              VkDeviceSize size,
+                              VkDeviceSize dst_offset = 0,
+                              const ResourceAccess& consumer = {VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR,
+                                                                VK_ACCESS_2_MEMORY_READ_BIT_KHR});
+
+    // Queue a host -> image upload; the region is left in consumer.layout. A region covering
+    // its whole mip level discards the level's previous texels, a partial one keeps them
+    // (which with a dedicated transfer family requires the level to hold no contents yet)
+    UploadTicket UploadImage(Image& dst_image,
+                             const void* data,
+                             VkDeviceSize size,
+                             const VkBufferImageCopy& region,
+                             const ResourceAccess& consumer = {VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR,
+                                                               VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR,
+                                                               VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL});
+
+    // Record the graphics queue acquires of uploads whose tickets completed. No-op without
+    // a dedicated transfer family
+    void RecordAcquireBarriers(const CommandBuffer& command_buffer);
+
+    // Submit the batch currently being recorded (no-op when empty). Returns the ticket of the batch
+    UploadTicket Submit();
+
+    // Poll a ticket without blocking
+    [[nodiscard]] bool IsComplete(UploadTicket ticket) const;
+
+    // Block until the ticket completes (submits the open batch first if needed)
+    VkResult Wait(UploadTicket ticket, uint64_t timeout = UINT64_MAX);
+
+    // Block until every queued upload completes
+    VkResult WaitIdle(uint64_t timeout = UINT64_MAX);
+
+    // Release staging memory and command buffers of retired batches
+    void Collect();
+
+    // Timeline semaphore signalled by upload batches; GPU consumers can wait on it
+    // with the ticket value instead of blocking on the CPU
+    [[nodiscard]] VkSemaphore GetTimelineSemaphore() const { return timeline_->GetHandle(); }
+
+    // Last completed and last submitted timeline values
+    [[nodiscard]] uint64_t GetCompletedValue() const;
+    [[nodiscard]] uint64_t GetSubmittedValue() const { return submittedValue_; }
+
+    // Queue family the uploads execute on
+    [[nodiscard]] uint32_t GetQueueFamilyIndex() const { return queue_.GetFamilyIndex(); }
+
+    // True when uploads are released by the transfer family and acquired by RecordAcquireBarriers
+    [[nodiscard]] bool UsesOwnershipTransfer() const { return queue_.GetFamilyIndex() != graphicsFamily_; }
+
+private:
+    struct StagingChunk {
+        Buffer buffer;
+        VkDeviceSize used{0};
+    };
+
+    // Upload released by the transfer family, acquired once its batch completed
+    struct PendingAcquire {
+        Buffer* buffer{nullptr};
+        Image* image{nullptr};
+        VkDeviceSize offset{0};
+        VkDeviceSize size{0};
+        VkImageSubresourceRange range{};
+        OwnershipTransfer transfer{};
+    };
+
+    struct Batch {
+        CommandBuffer commandBuffer;
+        std::vector<StagingChunk> staging;
+        std::vector<PendingAcquire> acquires;
+        VkDeviceSize stagedBytes{0};
+        uint64_t signalValue{0};
+    };
+
+    const Device* device_{nullptr};
+    const VmaAllocator* allocator_{nullptr};
+    Queue queue_;
+    uint32_t graphicsFamily_{0};
+    std::unique_ptr<CommandPool> commandPool_;
+    std::unique_ptr<Semaphore> timeline_;
+
+    VkDeviceSize stagingChunkSize_{0};
+    VkDeviceSize batchBudget_{0};
+    VkDeviceSize copyOffsetAlignment_{4};
+    // minImageTransferGranularity of the upload queue's family; zero allows whole levels only
+    VkExtent3D transferGranularity_{1, 1, 1};
+
+    std::unique_ptr<Batch> recording_;
+    std::deque<std::unique_ptr<Batch>> inFlight_;
+    std::vector<std::unique_ptr<Batch>> freeBatches_;
+    std::vector<PendingAcquire> acquireReady_;
+    uint64_t submittedValue_{0};
+
+    // Helper methods
+    Batch& GetRecordingBatch();
+    // Reserve staging space at an offset that is a multiple of alignment in the recording
+    // batch; returns the staging buffer and offset
+    std::pair<VkBuffer, VkDeviceSize> StageData(Batch& batch, const void* data, VkDeviceSize size, VkDeviceSize alignment);
+    UploadTicket FinishRecord();
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_RESOURCES_UPLOAD_MANAGER_HPP
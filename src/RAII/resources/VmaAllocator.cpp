@@ -3,6 +3,8 @@
 #include "../core/instance.hpp"
 #include "../core/PhysicalDevice.hpp"
 #include "../core/Device.hpp"
+#include "../utils/HostAllocator.hpp"
+#include "../utils/TracyUtils.hpp"
 #include <volk.h>
 #include <cstdint>
 #include <stdexcept>
@@ -10,6 +12,14 @@
 
 namespace VulkanEngine::RAII {
 
+#ifdef VULKAN_RAII_TRACY
+namespace {
+
+constexpr const char* TRACY_MEMORY_POOL = "Vulkan device memory";
+
+} // namespace
+#endif
+
 VmaAllocator::VmaAllocator(const Instance& instance,
                            const PhysicalDevice& physical_device,
                            const Device& device,
@@ -71,6 +81,21 @@ VkResult VmaAllocator::CreateBuffer(const VkBufferCreateInfo& buffer_create_info
                            allocation_info);
 }
 
+VkResult VmaAllocator::CreateBufferWithAlignment(const VkBufferCreateInfo& buffer_create_info,
+                                                 const VmaAllocationCreateInfo& allocation_create_info,
+                                                 VkDeviceSize min_alignment,
+                                                 VkBuffer& buffer,
+                                                 VmaAllocation& allocation,
+                                                 VmaAllocationInfo* allocation_info) const {
+    return vmaCreateBufferWithAlignment(allocator_,
+                                        &buffer_create_info,
+                                        &allocation_create_info,
+                                        min_alignment,
+                                        &buffer,
+                                        &allocation,
+                                        allocation_info);
+}
+
 void VmaAllocator::DestroyBuffer(VkBuffer buffer, VmaAllocation allocation) const {
     vmaDestroyBuffer(allocator_, buffer, allocation);
 }
@@ -161,10 +186,16 @@ void VmaAllocator::CreateAllocator(VmaAllocatorCreateFlags flags, uint32_t vulka
 {
     VmaAllocatorCreateInfo create_info{};
     create_info.flags = flags;
+    if (deviceRef_ && deviceRef_->SupportsBufferDeviceAddress()) {
+        // Lets buffers created with SHADER_DEVICE_ADDRESS usage be allocated like any other
+        create_info.flags |= VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+    }
     create_info.physicalDevice = physicalDevice_;
     create_info.device = device_;
     create_info.instance = instance_;
     create_info.vulkanApiVersion = vulkan_api_version;
+    // VMA uses these for its own bookkeeping and for the buffers, images and memory it creates
+    create_info.pAllocationCallbacks = Utils::HostAllocator::For(VK_OBJECT_TYPE_DEVICE_MEMORY);
 
     if (!vkGetInstanceProcAddr || !vkGetDeviceProcAddr) {
         throw std::runtime_error("Volk global function pointers are not initialised");
@@ -176,6 +207,18 @@ void VmaAllocator::CreateAllocator(VmaAllocatorCreateFlags flags, uint32_t vulka
     vulkan_functions.vkGetDeviceProcAddr = vkGetDeviceProcAddr;
     create_info.pVulkanFunctions = &vulkan_functions;
 
+#ifdef VULKAN_RAII_TRACY
+    // Device memory blocks show up in Tracy's memory view
+    VmaDeviceMemoryCallbacks memory_callbacks{};
+    memory_callbacks.pfnAllocate = [](::VmaAllocator, uint32_t, VkDeviceMemory memory, VkDeviceSize size, void*) {
+        VULKAN_RAII_TRACY_ALLOC(reinterpret_cast<void*>(memory), size, TRACY_MEMORY_POOL);
+    };
+    memory_callbacks.pfnFree = [](::VmaAllocator, uint32_t, VkDeviceMemory memory, VkDeviceSize, void*) {
+        VULKAN_RAII_TRACY_FREE(reinterpret_cast<void*>(memory), TRACY_MEMORY_POOL);
+    };
+    create_info.pDeviceMemoryCallbacks = &memory_callbacks;
+#endif
+
     if (vmaCreateAllocator(&create_info, &allocator_) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create VMA allocator");
     }
@@ -49,6 +49,14 @@ public:
                          VmaAllocation& allocation,
                          VmaAllocationInfo* allocation_info = nullptr) const;
 
+    // Buffer allocation with a minimum alignment beyond the buffer's own requirements
+    VkResult CreateBufferWithAlignment(const VkBufferCreateInfo& buffer_create_info,
+                                       const VmaAllocationCreateInfo& allocation_create_info,
+                                       VkDeviceSize min_alignment,
+                                       VkBuffer& buffer,
+                                       VmaAllocation& allocation,
+                                       VmaAllocationInfo* allocation_info = nullptr) const;
+
     void DestroyBuffer(VkBuffer buffer, VmaAllocation allocation) const;
 
     // Image allocation
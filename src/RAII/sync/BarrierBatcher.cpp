@@ -0,0 +1,301 @@
+#include "BarrierBatcher.hpp"
+
+#include "../resources/Buffer.hpp"
+#include "../resources/Image.hpp"
+#include "../utils/ImageUtils.hpp"
+#include "../utils/SyncUtils.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+namespace VulkanEngine::RAII {
+
+namespace {
+constexpr VkAccessFlags2KHR WRITE_ACCESS = VK_ACCESS_2_SHADER_WRITE_BIT_KHR |
+                                           VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR |
+                                           VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR |
+                                           VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR |
+                                           VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR |
+                                           VK_ACCESS_2_HOST_WRITE_BIT_KHR |
+                                           VK_ACCESS_2_MEMORY_WRITE_BIT_KHR |
+                                           VK_ACCESS_2_TRANSFORM_FEEDBACK_WRITE_BIT_EXT |
+                                           VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+
+bool RangesOverlap(const VkImageSubresourceRange& a, const VkImageSubresourceRange& b)
+{
+    return a.baseMipLevel < b.baseMipLevel + b.levelCount && b.baseMipLevel < a.baseMipLevel + a.levelCount &&
+           a.baseArrayLayer < b.baseArrayLayer + b.layerCount && b.baseArrayLayer < a.baseArrayLayer + a.layerCount;
+}
+
+bool SameRange(const VkImageSubresourceRange& a, const VkImageSubresourceRange& b)
+{
+    return a.aspectMask == b.aspectMask && a.baseMipLevel == b.baseMipLevel && a.levelCount == b.levelCount &&
+           a.baseArrayLayer == b.baseArrayLayer && a.layerCount == b.layerCount;
+}
+} // namespace
+
+BarrierBatcher::BarrierBatcher(VkCommandBuffer command_buffer, bool synchronization2, const VolkDeviceTable* dispatch)
+    : commandBuffer_(command_buffer),
+    synchronization2_(synchronization2),
+    dispatch_(dispatch) {}
+
+bool BarrierBatcher::IsWriteAccess(VkAccessFlags2KHR access)
+{
+    return (access & WRITE_ACCESS) != 0;
+}
+
+ResourceState BarrierBatcher::GetStateAfter(const ResourceAccess& access)
+{
+    ResourceState state{};
+    state.layout = access.layout;
+    VkPipelineStageFlags2KHR src_stages = VK_PIPELINE_STAGE_2_NONE_KHR;
+    VkAccessFlags2KHR src_access = VK_ACCESS_2_NONE_KHR;
+    (void)Transition(state, access, src_stages, src_access);
+    return state;
+}
+
+bool BarrierBatcher::Transition(ResourceState& state, const ResourceAccess& access,
+                                VkPipelineStageFlags2KHR& src_stages, VkAccessFlags2KHR& src_access)
+{
+    const bool layout_change = access.layout != state.layout;
+    if (!layout_change && !IsWriteAccess(access.access)) {
+        // Read after read: only stages that have not yet waited for the last write need a barrier
+        const bool covered = (access.stages & ~state.readStages) == 0 && (access.access & ~state.readAccess) == 0;
+        const bool unwritten = state.writeStages == VK_PIPELINE_STAGE_2_NONE_KHR && state.writeAccess == VK_ACCESS_2_NONE_KHR;
+        src_stages = state.writeStages;
+        src_access = state.writeAccess;
+        state.readStages |= access.stages;
+        state.readAccess |= access.access;
+        return !covered && !unwritten;
+    }
+
+    // Writes and layout transitions wait for the last write and every read since
+    src_stages = state.writeStages | state.readStages;
+    src_access = state.writeAccess;
+    const bool needs_barrier = layout_change || src_stages != VK_PIPELINE_STAGE_2_NONE_KHR;
+
+    state.layout = access.layout;
+    state.writeStages = access.stages;
+    if (IsWriteAccess(access.access)) {
+        state.writeAccess = access.access & WRITE_ACCESS;
+        state.readStages = VK_PIPELINE_STAGE_2_NONE_KHR;
+        state.readAccess = VK_ACCESS_2_NONE_KHR;
+    } else {
+        // A read-only transition: later readers only have to wait for the transition itself
+        state.writeAccess = VK_ACCESS_2_NONE_KHR;
+        state.readStages = access.stages;
+        state.readAccess = access.access;
+    }
+    return needs_barrier;
+}
+
+void BarrierBatcher::Require(Image& image, const ResourceAccess& access, const VkImageSubresourceRange& range)
+{
+    const uint32_t level_count = range.levelCount == VK_REMAINING_MIP_LEVELS ? image.GetMipLevels() - range.baseMipLevel : range.levelCount;
+    const uint32_t layer_count = range.layerCount == VK_REMAINING_ARRAY_LAYERS ? image.GetArrayLayers() - range.baseArrayLayer : range.layerCount;
+    const uint32_t end_mip = range.baseMipLevel + level_count;
+
+    for (uint32_t layer = range.baseArrayLayer; layer < range.baseArrayLayer + layer_count; ++layer) {
+        uint32_t mip = range.baseMipLevel;
+        while (mip < end_mip) {
+            // Mips sharing a state transition together
+            const ResourceState before = image.GetTrackedState(mip, layer);
+            uint32_t run_end = mip + 1;
+            while (run_end < end_mip && image.GetTrackedState(run_end, layer) == before) {
+                ++run_end;
+            }
+
+            ResourceState after = before;
+            VkPipelineStageFlags2KHR src_stages = VK_PIPELINE_STAGE_2_NONE_KHR;
+            VkAccessFlags2KHR src_access = VK_ACCESS_2_NONE_KHR;
+            if (Transition(after, access, src_stages, src_access)) {
+                VkImageMemoryBarrier2KHR barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR};
+                barrier.srcStageMask = src_stages;
+                barrier.srcAccessMask = src_access;
+                barrier.dstStageMask = access.stages;
+                barrier.dstAccessMask = access.access;
+                barrier.oldLayout = before.layout;
+                barrier.newLayout = after.layout;
+                barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.image = image.GetHandle();
+                barrier.subresourceRange = {range.aspectMask, mip, run_end - mip, layer, 1};
+                AddImageBarrier(barrier);
+            } else {
+                ++droppedCount_;
+            }
+            image.SetTrackedState(after, mip, run_end - mip, layer, 1);
+            mip = run_end;
+        }
+    }
+}
+
+void BarrierBatcher::Require(Image& image, const ResourceAccess& access)
+{
+    Require(image, access, Utils::ImageUtils::CreateSubresourceRange(Utils::ImageUtils::GetImageAspectFlags(image.GetFormat())));
+}
+
+void BarrierBatcher::Require(Buffer& buffer, VkPipelineStageFlags2KHR stages, VkAccessFlags2KHR access)
+{
+    ResourceState state = buffer.GetTrackedState();
+    VkPipelineStageFlags2KHR src_stages = VK_PIPELINE_STAGE_2_NONE_KHR;
+    VkAccessFlags2KHR src_access = VK_ACCESS_2_NONE_KHR;
+    const bool needs_barrier = Transition(state, ResourceAccess{stages, access, VK_IMAGE_LAYOUT_UNDEFINED}, src_stages, src_access);
+    buffer.SetTrackedState(state);
+    if (!needs_barrier) {
+        ++droppedCount_;
+        return;
+    }
+
+    VkBufferMemoryBarrier2KHR barrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR};
+    barrier.srcStageMask = src_stages;
+    barrier.srcAccessMask = src_access;
+    barrier.dstStageMask = stages;
+    barrier.dstAccessMask = access;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = buffer.GetHandle();
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+
+    for (VkBufferMemoryBarrier2KHR& pending : bufferBarriers_) {
+        if (pending.buffer != barrier.buffer) {
+            continue;
+        }
+        // Two reads of the same write share one barrier; anything else must be ordered
+        if (!IsWriteAccess(pending.dstAccessMask) && !IsWriteAccess(access)) {
+            pending.dstStageMask |= stages;
+            pending.dstAccessMask |= access;
+            return;
+        }
+        Flush();
+        break;
+    }
+    bufferBarriers_.push_back(barrier);
+}
+
+void BarrierBatcher::AddImageBarrier(const VkImageMemoryBarrier2KHR& barrier)
+{
+    for (VkImageMemoryBarrier2KHR& pending : imageBarriers_) {
+        if (pending.image != barrier.image || !RangesOverlap(pending.subresourceRange, barrier.subresourceRange)) {
+            continue;
+        }
+        // A later read in the layout the pending barrier transitions to joins its destination scope
+        if (SameRange(pending.subresourceRange, barrier.subresourceRange) &&
+            barrier.oldLayout == pending.newLayout && barrier.newLayout == pending.newLayout &&
+            !IsWriteAccess(pending.dstAccessMask) && !IsWriteAccess(barrier.dstAccessMask)) {
+            pending.dstStageMask |= barrier.dstStageMask;
+            pending.dstAccessMask |= barrier.dstAccessMask;
+            return;
+        }
+        Flush();
+        break;
+    }
+
+    // Consecutive layers with the same transition share one barrier
+    if (!imageBarriers_.empty()) {
+        VkImageMemoryBarrier2KHR& last = imageBarriers_.back();
+        if (last.image == barrier.image && last.oldLayout == barrier.oldLayout && last.newLayout == barrier.newLayout &&
+            last.srcStageMask == barrier.srcStageMask && last.srcAccessMask == barrier.srcAccessMask &&
+            last.dstStageMask == barrier.dstStageMask && last.dstAccessMask == barrier.dstAccessMask &&
+            last.subresourceRange.aspectMask == barrier.subresourceRange.aspectMask &&
+            last.subresourceRange.baseMipLevel == barrier.subresourceRange.baseMipLevel &&
+            last.subresourceRange.levelCount == barrier.subresourceRange.levelCount &&
+            last.subresourceRange.baseArrayLayer + last.subresourceRange.layerCount == barrier.subresourceRange.baseArrayLayer) {
+            last.subresourceRange.layerCount += barrier.subresourceRange.layerCount;
+            return;
+        }
+    }
+    imageBarriers_.push_back(barrier);
+}
+
+void BarrierBatcher::Flush()
+{
+    if (!HasPending()) {
+        return;
+    }
+    VkDependencyInfoKHR dependency_info{VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR};
+    dependency_info.bufferMemoryBarrierCount = static_cast<uint32_t>(bufferBarriers_.size());
+    dependency_info.pBufferMemoryBarriers = bufferBarriers_.empty() ? nullptr : bufferBarriers_.data();
+    dependency_info.imageMemoryBarrierCount = static_cast<uint32_t>(imageBarriers_.size());
+    dependency_info.pImageMemoryBarriers = imageBarriers_.empty() ? nullptr : imageBarriers_.data();
+    Utils::SyncUtils::CmdPipelineBarrier2(commandBuffer_, dependency_info, synchronization2_, dispatch_);
+
+    barrierCount_ += bufferBarriers_.size() + imageBarriers_.size();
+    imageBarriers_.clear();
+    bufferBarriers_.clear();
+}
+
+void BarrierBatcher::FlushSplit(VkEvent event)
+{
+    if (event == VK_NULL_HANDLE) {
+        throw std::invalid_argument("Split barrier requires a valid event");
+    }
+    for (const SplitBarrier& split : splits_) {
+        if (split.event == event) {
+            throw std::logic_error("Event already carries a split barrier that was not waited on");
+        }
+    }
+
+    // An empty split is kept too, so the matching WaitSplit knows there is nothing to wait for
+    SplitBarrier split;
+    split.event = event;
+    split.imageBarriers = std::move(imageBarriers_);
+    split.bufferBarriers = std::move(bufferBarriers_);
+    imageBarriers_.clear();
+    bufferBarriers_.clear();
+    if (!split.imageBarriers.empty() || !split.bufferBarriers.empty()) {
+        Utils::SyncUtils::CmdSetEvent2(commandBuffer_, event, split.GetDependencyInfo(), synchronization2_, dispatch_);
+    }
+    splits_.push_back(std::move(split));
+}
+
+void BarrierBatcher::WaitSplit(std::span<const VkEvent> events)
+{
+    std::vector<VkEvent> wait_events;
+    std::vector<VkDependencyInfoKHR> dependency_infos;
+    std::vector<SplitBarrier> waited;
+    for (VkEvent event : events) {
+        auto it = std::find_if(splits_.begin(), splits_.end(), [event](const SplitBarrier& split) { return split.event == event; });
+        if (it == splits_.end()) {
+            throw std::logic_error("No split barrier was signalled on the event");
+        }
+        waited.push_back(std::move(*it));
+        splits_.erase(it);
+    }
+
+    // Dependency infos point into waited, which no longer grows
+    for (const SplitBarrier& split : waited) {
+        if (split.imageBarriers.empty() && split.bufferBarriers.empty()) {
+            continue;
+        }
+        wait_events.push_back(split.event);
+        dependency_infos.push_back(split.GetDependencyInfo());
+        barrierCount_ += split.imageBarriers.size() + split.bufferBarriers.size();
+    }
+    Utils::SyncUtils::CmdWaitEvents2(commandBuffer_, wait_events, dependency_infos, synchronization2_, dispatch_);
+}
+
+VkDependencyInfoKHR BarrierBatcher::SplitBarrier::GetDependencyInfo() const
+{
+    VkDependencyInfoKHR dependency_info{VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR};
+    dependency_info.bufferMemoryBarrierCount = static_cast<uint32_t>(bufferBarriers.size());
+    dependency_info.pBufferMemoryBarriers = bufferBarriers.empty() ? nullptr : bufferBarriers.data();
+    dependency_info.imageMemoryBarrierCount = static_cast<uint32_t>(imageBarriers.size());
+    dependency_info.pImageMemoryBarriers = imageBarriers.empty() ? nullptr : imageBarriers.data();
+    return dependency_info;
+}
+
+void BarrierBatcher::Clear()
+{
+    imageBarriers_.clear();
+    bufferBarriers_.clear();
+    splits_.clear();
+}
+
+} // namespace VulkanEngine::RAII
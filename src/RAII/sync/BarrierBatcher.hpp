@@ -0,0 +1,106 @@
+#ifndef VULKAN_RAII_SYNC_BARRIER_BATCHER_HPP
+#define VULKAN_RAII_SYNC_BARRIER_BATCHER_HPP
+
+#include <volk.h>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "ResourceState.hpp"
+
+namespace VulkanEngine::RAII {
+
+class Image; // Forward declaration
+class Buffer; // Forward declaration
+
+// Collects the barriers the next command needs from the state tracked on each
+// Image (per mip level and array layer) and Buffer, and records them as one
+// pipeline barrier on Flush. Requirements that the tracked state already
+// satisfies (a repeated read in the same layout by stages that already waited
+// for the last write) produce no barrier. CommandBuffer owns one and flushes it
+// before every draw, dispatch, copy and render pass begin; requirements for
+// anything used inside a render pass must therefore be made before it begins.
+// Tracked state follows recording order, so resources shared between command
+// buffers must be recorded in submission order (or re-seeded with SetTrackedState).
+//
+// FlushSplit/WaitSplit record the pending barriers as a split barrier instead: an
+// event set right after the producer and waited on just before the consumer, so
+// independent work recorded in between (e.g. shadow maps between the depth prepass
+// and the pass sampling it) is not stalled by the dependency.
+class BarrierBatcher {
+public:
+    BarrierBatcher(VkCommandBuffer command_buffer, bool synchronization2, const VolkDeviceTable* dispatch = nullptr);
+
+    // Delete copy and move. CommandBuffer owns the batcher behind a pointer.
+    BarrierBatcher(const BarrierBatcher&) = delete;
+    BarrierBatcher& operator=(const BarrierBatcher&) = delete;
+    BarrierBatcher(BarrierBatcher&&) = delete;
+    BarrierBatcher& operator=(BarrierBatcher&&) = delete;
+
+    // Require range of image (all aspects in range are tracked together) to be in access.layout
+    void Require(Image& image, const ResourceAccess& access, const VkImageSubresourceRange& range);
+
+    // Require the whole image (aspects derived from the format)
+    void Require(Image& image, const ResourceAccess& access);
+
+    // Require buffer (tracked as a whole)
+    void Require(Buffer& buffer, VkPipelineStageFlags2KHR stages, VkAccessFlags2KHR access);
+
+    [[nodiscard]] bool HasPending() const { return !imageBarriers_.empty() || !bufferBarriers_.empty(); }
+
+    // Record the pending barriers as one barrier command
+    void Flush();
+
+    // Record the pending barriers as the signal half of a split barrier, setting event
+    // once the producing stages finish. Work recorded before WaitSplit(event) must not
+    // touch the resources involved; their tracked state already is the consumer's
+    void FlushSplit(VkEvent event);
+
+    // Record the wait halves of the split barriers signalled on events
+    void WaitSplit(std::span<const VkEvent> events);
+
+    // Check whether a split barrier was signalled and not yet waited on
+    [[nodiscard]] bool HasOpenSplits() const { return !splits_.empty(); }
+
+    // Drop the pending barriers and open split barriers (the command buffer was reset)
+    void Clear();
+
+    // Barriers recorded and requirements dropped as already satisfied
+    [[nodiscard]] uint64_t GetBarrierCount() const { return barrierCount_; }
+    [[nodiscard]] uint64_t GetDroppedCount() const { return droppedCount_; }
+
+    // Whether access writes the resource
+    static bool IsWriteAccess(VkAccessFlags2KHR access);
+
+    // State right after a barrier whose destination scope is access (e.g. an ownership
+    // acquire): writes become the last write, reads have already waited
+    [[nodiscard]] static ResourceState GetStateAfter(const ResourceAccess& access);
+
+private:
+    // Barriers between the set and the wait of one event; both must see the same dependency
+    struct SplitBarrier {
+        VkEvent event{VK_NULL_HANDLE};
+        std::vector<VkImageMemoryBarrier2KHR> imageBarriers;
+        std::vector<VkBufferMemoryBarrier2KHR> bufferBarriers;
+
+        [[nodiscard]] VkDependencyInfoKHR GetDependencyInfo() const;
+    };
+
+    VkCommandBuffer commandBuffer_{VK_NULL_HANDLE};
+    bool synchronization2_{false};
+    const VolkDeviceTable* dispatch_{nullptr};
+    std::vector<VkImageMemoryBarrier2KHR> imageBarriers_;
+    std::vector<VkBufferMemoryBarrier2KHR> bufferBarriers_;
+    std::vector<SplitBarrier> splits_;
+    uint64_t barrierCount_{0};
+    uint64_t droppedCount_{0};
+
+    // Next state of a subresource in state after access; false when no barrier is needed
+    static bool Transition(ResourceState& state, const ResourceAccess& access,
+                           VkPipelineStageFlags2KHR& src_stages, VkAccessFlags2KHR& src_access);
+    void AddImageBarrier(const VkImageMemoryBarrier2KHR& barrier);
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_SYNC_BARRIER_BATCHER_HPP
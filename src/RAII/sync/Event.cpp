@@ -1,6 +1,7 @@
 #include "Event.hpp"
 
 #include "../core/Device.hpp"
+#include "../utils/HostAllocator.hpp"
 #include <stdexcept>
 
 
@@ -59,7 +60,7 @@ void Event::CreateEvent(VkEventCreateFlags flags)
     VkEventCreateInfo event_info{VK_STRUCTURE_TYPE_EVENT_CREATE_INFO};
     event_info.flags = flags;
 
-    if (vkCreateEvent(device_, &event_info, nullptr, &event_) != VK_SUCCESS) {
+    if (vkCreateEvent(device_, &event_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_EVENT), &event_) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create event");
     }
 }
@@ -67,7 +68,7 @@ void Event::CreateEvent(VkEventCreateFlags flags)
 void Event::Cleanup()
 {
     if (event_ != VK_NULL_HANDLE) {
-        vkDestroyEvent(device_, event_, nullptr);
+        vkDestroyEvent(device_, event_, Utils::HostAllocator::For(VK_OBJECT_TYPE_EVENT));
         event_ = VK_NULL_HANDLE;
     }
     device_ = VK_NULL_HANDLE;
@@ -0,0 +1,50 @@
+#include "EventPool.hpp"
+
+#include "../core/Device.hpp"
+
+#include <stdexcept>
+
+
+namespace VulkanEngine::RAII {
+
+EventPool::EventPool(const Device& device, uint32_t frames_in_flight)
+    : device_(&device),
+    frameEvents_(frames_in_flight)
+{
+    if (frames_in_flight == 0) {
+        throw std::invalid_argument("EventPool requires at least one frame in flight");
+    }
+}
+
+void EventPool::BeginFrame(uint32_t frame_index)
+{
+    if (frame_index >= frameEvents_.size()) {
+        throw std::out_of_range("EventPool frame index out of range");
+    }
+    currentFrame_ = frame_index;
+
+    // The GPU is done with the frame's previous submission, so the host may reset its events
+    for (VkEvent event : frameEvents_[frame_index]) {
+        if (device_->GetDispatch().vkResetEvent(device_->GetHandle(), event) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to reset pooled event");
+        }
+        free_.push_back(event);
+    }
+    frameEvents_[frame_index].clear();
+}
+
+VkEvent EventPool::Acquire()
+{
+    VkEvent event{VK_NULL_HANDLE};
+    if (free_.empty()) {
+        events_.emplace_back(*device_);
+        event = events_.back().GetHandle();
+    } else {
+        event = free_.back();
+        free_.pop_back();
+    }
+    frameEvents_[currentFrame_].push_back(event);
+    return event;
+}
+
+} // namespace VulkanEngine::RAII
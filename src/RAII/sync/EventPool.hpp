@@ -0,0 +1,48 @@
+#ifndef VULKAN_RAII_SYNC_EVENT_POOL_HPP
+#define VULKAN_RAII_SYNC_EVENT_POOL_HPP
+
+#include <volk.h>
+#include <cstdint>
+#include <vector>
+
+#include "Event.hpp"
+
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+
+// Events for split barriers (CommandBuffer::SignalSplitBarrier), recycled per frame
+// in flight. Acquire() hands out an unsignaled event for the current frame;
+// BeginFrame(frame) must be called once that frame slot's previous submission has
+// finished (after its fence wait), and resets the events it used for reuse.
+class EventPool {
+public:
+    EventPool(const Device& device, uint32_t frames_in_flight);
+
+    // Delete copy and move. recorded command buffers reference the pooled events.
+    EventPool(const EventPool&) = delete;
+    EventPool& operator=(const EventPool&) = delete;
+    EventPool(EventPool&&) = delete;
+    EventPool& operator=(EventPool&&) = delete;
+
+    // Recycle the events frame_index used last time around
+    void BeginFrame(uint32_t frame_index);
+
+    // Unsignaled event owned by the current frame
+    [[nodiscard]] VkEvent Acquire();
+
+    [[nodiscard]] uint32_t GetEventCount() const { return static_cast<uint32_t>(events_.size()); }
+    [[nodiscard]] uint32_t GetFreeCount() const { return static_cast<uint32_t>(free_.size()); }
+
+private:
+    const Device* device_{nullptr};
+    std::vector<Event> events_;
+    std::vector<VkEvent> free_;
+    std::vector<std::vector<VkEvent>> frameEvents_; // Handed out per frame slot
+    uint32_t currentFrame_{0};
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_SYNC_EVENT_POOL_HPP
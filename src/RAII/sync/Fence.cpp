@@ -1,6 +1,9 @@
 #include "Fence.hpp"
 
 #include "../core/Device.hpp"
+#include "../utils/Profiler.hpp"
+#include "../utils/HostAllocator.hpp"
+
 #include <cstdint>
 #include <stdexcept>
 #include <vector>
@@ -37,6 +40,7 @@ Fence& Fence::operator=(Fence&& other) noexcept {
 }
 
 VkResult Fence::Wait(uint64_t timeout) const {
+    VULKAN_RAII_PROFILE_SCOPE("Fence::Wait");
     return vkWaitForFences(device_, 1, &fence_, VK_TRUE, timeout);
 }
 
@@ -56,6 +60,7 @@ VkResult Fence::WaitForFences(const Device& device,
                               const std::vector<VkFence>& fences,
                               bool wait_all,
                               uint64_t timeout) {
+    VULKAN_RAII_PROFILE_SCOPE("Fence::Wait");
     return vkWaitForFences(device.GetHandle(),
                            static_cast<uint32_t>(fences.size()),
                            fences.data(),
@@ -87,7 +92,7 @@ void Fence::CreateFence(VkFenceCreateFlags flags)
     VkFenceCreateInfo fence_info{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
     fence_info.flags = flags;
 
-    if (vkCreateFence(device_, &fence_info, nullptr, &fence_) != VK_SUCCESS) {
+    if (vkCreateFence(device_, &fence_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_FENCE), &fence_) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create fence");
     }
 }
@@ -95,7 +100,7 @@ void Fence::CreateFence(VkFenceCreateFlags flags)
 void Fence::Cleanup()
 {
     if (fence_ != VK_NULL_HANDLE) {
-        vkDestroyFence(device_, fence_, nullptr);
+        vkDestroyFence(device_, fence_, Utils::HostAllocator::For(VK_OBJECT_TYPE_FENCE));
         fence_ = VK_NULL_HANDLE;
     }
     device_ = VK_NULL_HANDLE;
@@ -0,0 +1,46 @@
+#ifndef VULKAN_RAII_SYNC_RESOURCE_STATE_HPP
+#define VULKAN_RAII_SYNC_RESOURCE_STATE_HPP
+
+#include <volk.h>
+
+
+namespace VulkanEngine::RAII {
+
+// Synchronization state of a buffer or image subresource as seen by the commands
+// recorded so far (see BarrierBatcher). The write* fields describe the last
+// write (or layout transition); the read* fields the stages and accesses that
+// have already been made to wait for it.
+struct ResourceState {
+    VkImageLayout layout{VK_IMAGE_LAYOUT_UNDEFINED}; // Images only
+    VkPipelineStageFlags2KHR writeStages{VK_PIPELINE_STAGE_2_NONE_KHR};
+    VkAccessFlags2KHR writeAccess{VK_ACCESS_2_NONE_KHR};
+    VkPipelineStageFlags2KHR readStages{VK_PIPELINE_STAGE_2_NONE_KHR};
+    VkAccessFlags2KHR readAccess{VK_ACCESS_2_NONE_KHR};
+
+    bool operator==(const ResourceState& other) const = default;
+};
+
+// How the next command uses a resource
+struct ResourceAccess {
+    VkPipelineStageFlags2KHR stages{VK_PIPELINE_STAGE_2_NONE_KHR};
+    VkAccessFlags2KHR access{VK_ACCESS_2_NONE_KHR};
+    VkImageLayout layout{VK_IMAGE_LAYOUT_UNDEFINED}; // Images only
+};
+
+// Queue family ownership transfer of a VK_SHARING_MODE_EXCLUSIVE resource (see
+// Buffer/Image::ReleaseOwnership and AcquireOwnership). The release is recorded on a
+// queue of srcFamily, the acquire on one of dstFamily, and a semaphore must order the
+// two submits. Building both halves from one description keeps the family indices,
+// layouts and ranges identical, as Vulkan requires
+struct OwnershipTransfer {
+    uint32_t srcFamily{VK_QUEUE_FAMILY_IGNORED};
+    uint32_t dstFamily{VK_QUEUE_FAMILY_IGNORED};
+    ResourceAccess sourceAccess{}; // Last use on the source queue; layout is the image's layout there
+    ResourceAccess destinationAccess{}; // First use on the destination queue; layout is the one it gets
+
+    [[nodiscard]] bool ChangesFamily() const { return srcFamily != dstFamily; }
+};
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_SYNC_RESOURCE_STATE_HPP
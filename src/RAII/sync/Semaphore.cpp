@@ -1,6 +1,7 @@
 #include "Semaphore.hpp"
 
 #include "../core/Device.hpp"
+#include "../utils/HostAllocator.hpp"
 #include <cstddef>
 #include <cstdint>
 #include <stdexcept>
@@ -128,7 +129,7 @@ void Semaphore::CreateSemaphore(VkSemaphoreCreateFlags flags, uint64_t* initial_
         semaphore_info.pNext = &timeline_info;
     }
 
-    if (vkCreateSemaphore(device_, &semaphore_info, nullptr, &semaphore_) != VK_SUCCESS) {
+    if (vkCreateSemaphore(device_, &semaphore_info, Utils::HostAllocator::For(VK_OBJECT_TYPE_SEMAPHORE), &semaphore_) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create semaphore");
     }
 }
@@ -136,7 +137,7 @@ void Semaphore::CreateSemaphore(VkSemaphoreCreateFlags flags, uint64_t* initial_
 void Semaphore::Cleanup()
 {
     if (semaphore_ != VK_NULL_HANDLE) {
-        vkDestroySemaphore(device_, semaphore_, nullptr);
+        vkDestroySemaphore(device_, semaphore_, Utils::HostAllocator::For(VK_OBJECT_TYPE_SEMAPHORE));
         semaphore_ = VK_NULL_HANDLE;
     }
     device_ = VK_NULL_HANDLE;
@@ -0,0 +1,77 @@
+#include "SyncObjectPool.hpp"
+
+#include "../core/Device.hpp"
+
+
+namespace VulkanEngine::RAII {
+
+namespace {
+// Put a returned object back in its initial state; false drops it instead
+bool PrepareForReuse(const Fence& fence) { return fence.Reset() == VK_SUCCESS; }
+// The pool contract guarantees no signal or wait is pending; nothing to reset
+bool PrepareForReuse(const Semaphore& /*semaphore*/) { return true; }
+} // namespace
+
+template <typename T>
+typename SyncObjectPool<T>::Lease SyncObjectPool<T>::Acquire()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_.empty()) {
+            std::unique_ptr<T> object = std::move(free_.back());
+            free_.pop_back();
+            return Lease(this, std::move(object));
+        }
+        ++objectCount_;
+    }
+    // Create outside the lock; only the miss path reaches the driver
+    try {
+        return Lease(this, std::make_unique<T>(*device_));
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --objectCount_;
+        throw;
+    }
+}
+
+template <typename T>
+void SyncObjectPool<T>::Return(std::unique_ptr<T> object)
+{
+    const bool reusable = PrepareForReuse(*object);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (reusable) {
+        free_.push_back(std::move(object));
+    } else {
+        --objectCount_;
+    }
+}
+
+template <typename T>
+void SyncObjectPool<T>::Trim()
+{
+    std::vector<std::unique_ptr<T>> released;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        released.swap(free_);
+        objectCount_ -= released.size();
+    }
+}
+
+template <typename T>
+size_t SyncObjectPool<T>::GetObjectCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return objectCount_;
+}
+
+template <typename T>
+size_t SyncObjectPool<T>::GetFreeCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return free_.size();
+}
+
+template class SyncObjectPool<Fence>;
+template class SyncObjectPool<Semaphore>;
+
+} // namespace VulkanEngine::RAII
@@ -0,0 +1,113 @@
+#ifndef VULKAN_RAII_SYNC_SYNC_OBJECT_POOL_HPP
+#define VULKAN_RAII_SYNC_SYNC_OBJECT_POOL_HPP
+
+#include <volk.h>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "Fence.hpp"
+#include "Semaphore.hpp"
+
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+
+// Thread-safe recycling pool for Fence and binary Semaphore objects, so steady state
+// frames and swapchain recreation stop creating and destroying them (events are
+// recycled per frame slot by EventPool). Acquire() hands out a Lease that returns the
+// object to the pool when destroyed.
+// Returned fences are reset, so their last use must have completed (waited on or seen
+// signaled).
+// A binary semaphore may only be returned once the wait consuming its last signal is
+// known to have completed, e.g. after the frame that waited on it has retired.
+// The pool must outlive its leases
+template <typename T>
+class SyncObjectPool {
+public:
+    class Lease {
+    public:
+        Lease() = default;
+        ~Lease() { Release(); }
+
+        Lease(Lease&& other) noexcept
+            : pool_(std::exchange(other.pool_, nullptr)),
+            object_(std::move(other.object_)) {}
+
+        Lease& operator=(Lease&& other) noexcept {
+            if (this != &other) {
+                Release();
+                pool_ = std::exchange(other.pool_, nullptr);
+                object_ = std::move(other.object_);
+            }
+            return *this;
+        }
+
+        // Delete copy constructor and assignment. the object goes back to the pool once.
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        [[nodiscard]] T& Get() const { return *object_; }
+        T& operator*() const { return *object_; }
+        T* operator->() const { return object_.get(); }
+
+        [[nodiscard]] bool IsValid() const { return object_ != nullptr; }
+
+        // Hand the object back before the lease goes away
+        void Release() {
+            if (object_) {
+                pool_->Return(std::move(object_));
+            }
+            pool_ = nullptr;
+        }
+
+    private:
+        friend class SyncObjectPool;
+
+        Lease(SyncObjectPool* pool, std::unique_ptr<T> object)
+            : pool_(pool),
+            object_(std::move(object)) {}
+
+        SyncObjectPool* pool_{nullptr};
+        std::unique_ptr<T> object_;
+    };
+
+    explicit SyncObjectPool(const Device& device) : device_(&device) {}
+
+    // Delete copy and move. leases point back at the pool.
+    SyncObjectPool(const SyncObjectPool&) = delete;
+    SyncObjectPool& operator=(const SyncObjectPool&) = delete;
+    SyncObjectPool(SyncObjectPool&&) = delete;
+    SyncObjectPool& operator=(SyncObjectPool&&) = delete;
+
+    // Unsignaled object, recycled when one is free and created otherwise
+    [[nodiscard]] Lease Acquire();
+
+    // Destroy the free objects, e.g. after a burst of acquires
+    void Trim();
+
+    // Objects alive in the pool and its leases
+    [[nodiscard]] size_t GetObjectCount() const;
+    [[nodiscard]] size_t GetFreeCount() const;
+
+private:
+    const Device* device_{nullptr};
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<T>> free_;
+    size_t objectCount_{0};
+
+    void Return(std::unique_ptr<T> object);
+};
+
+extern template class SyncObjectPool<Fence>;
+extern template class SyncObjectPool<Semaphore>;
+
+using FencePool = SyncObjectPool<Fence>;
+using SemaphorePool = SyncObjectPool<Semaphore>; // Binary semaphores
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_SYNC_SYNC_OBJECT_POOL_HPP
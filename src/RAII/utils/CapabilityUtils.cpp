@@ -112,6 +112,16 @@ std::unordered_set<std::string> MakeAvailableSet(const std::vector<std::string>&
     return available_set;
 }
 
+// Link a feature structure into a pNext chain when its extension is enabled
+template<typename T>
+void AppendFeatureIf(bool condition, void**& next, T& features)
+{
+    if (condition) {
+        *next = &features;
+        next = &features.pNext;
+    }
+}
+
 void EnsureVolkInitialized()
 {
     const VkResult result = volkInitialize();
@@ -185,6 +195,138 @@ FeatureResolution ResolveDeviceFeatures(const VkPhysicalDeviceFeatures& supporte
     return resolution;
 }
 
+void MergeDeviceFeatures(VkPhysicalDeviceFeatures& target, const VkPhysicalDeviceFeatures& source)
+{
+    for (const FeatureFlagEntry& entry : kFeatureFlagTable) {
+        if (source.*(entry.member) == VK_TRUE) {
+            target.*(entry.member) = VK_TRUE;
+        }
+    }
+}
+
+DeviceExtensionFeatures ResolveDeviceExtensionFeatures(VkPhysicalDevice physical_device,
+                                                       const std::vector<std::string>& enabled_extensions)
+{
+    DeviceExtensionFeatures resolution{};
+    if (physical_device == VK_NULL_HANDLE || vkGetPhysicalDeviceFeatures2 == nullptr) {
+        return resolution;
+    }
+
+    auto enabled_set = MakeAvailableSet(enabled_extensions);
+    const bool has_pipeline_library = enabled_set.contains(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+                                      enabled_set.contains(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+
+    const bool has_dynamic_rendering = enabled_set.contains(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+    const bool has_extended_dynamic_state = enabled_set.contains(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME);
+    const bool has_extended_dynamic_state2 = enabled_set.contains(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME);
+    const bool has_extended_dynamic_state3 = enabled_set.contains(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME);
+    const bool has_shader_object = enabled_set.contains(VK_EXT_SHADER_OBJECT_EXTENSION_NAME);
+    const bool has_executable_properties = enabled_set.contains(VK_KHR_PIPELINE_EXECUTABLE_PROPERTIES_EXTENSION_NAME);
+    const bool has_descriptor_buffer = enabled_set.contains(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+    const bool has_synchronization2 = enabled_set.contains(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+    const bool has_multi_draw = enabled_set.contains(VK_EXT_MULTI_DRAW_EXTENSION_NAME);
+    const bool has_maintenance5 = enabled_set.contains(VK_KHR_MAINTENANCE_5_EXTENSION_NAME);
+    const bool has_generated_commands = enabled_set.contains(VK_EXT_DEVICE_GENERATED_COMMANDS_EXTENSION_NAME);
+    const bool has_present_id = enabled_set.contains(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+    const bool has_present_wait = enabled_set.contains(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+    const bool has_swapchain_maintenance1 = enabled_set.contains(VK_EXT_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME);
+    const bool has_host_image_copy = enabled_set.contains(VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME);
+    const bool has_conditional_rendering = enabled_set.contains(VK_EXT_CONDITIONAL_RENDERING_EXTENSION_NAME);
+    const bool has_fragment_shading_rate = enabled_set.contains(VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME);
+
+    // Only structures of enabled extensions are chained
+    VkPhysicalDeviceFeatures2 features2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+    void** next = &features2.pNext;
+    VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT library_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT};
+    AppendFeatureIf(has_pipeline_library, next, library_features);
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamic_rendering_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR};
+    AppendFeatureIf(has_dynamic_rendering, next, dynamic_rendering_features);
+    VkPhysicalDeviceExtendedDynamicStateFeaturesEXT dynamic_state_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT};
+    AppendFeatureIf(has_extended_dynamic_state, next, dynamic_state_features);
+    VkPhysicalDeviceExtendedDynamicState2FeaturesEXT dynamic_state2_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_2_FEATURES_EXT};
+    AppendFeatureIf(has_extended_dynamic_state2, next, dynamic_state2_features);
+    VkPhysicalDeviceExtendedDynamicState3FeaturesEXT dynamic_state3_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT};
+    AppendFeatureIf(has_extended_dynamic_state3, next, dynamic_state3_features);
+    VkPhysicalDeviceShaderObjectFeaturesEXT shader_object_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_FEATURES_EXT};
+    AppendFeatureIf(has_shader_object, next, shader_object_features);
+    VkPhysicalDevicePipelineExecutablePropertiesFeaturesKHR executable_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_EXECUTABLE_PROPERTIES_FEATURES_KHR};
+    AppendFeatureIf(has_executable_properties, next, executable_features);
+    VkPhysicalDeviceDescriptorBufferFeaturesEXT descriptor_buffer_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT};
+    AppendFeatureIf(has_descriptor_buffer, next, descriptor_buffer_features);
+    VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR};
+    AppendFeatureIf(has_synchronization2, next, synchronization2_features);
+    VkPhysicalDeviceMultiDrawFeaturesEXT multi_draw_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTI_DRAW_FEATURES_EXT};
+    AppendFeatureIf(has_multi_draw, next, multi_draw_features);
+    VkPhysicalDeviceMaintenance5FeaturesKHR maintenance5_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MAINTENANCE_5_FEATURES_KHR};
+    AppendFeatureIf(has_maintenance5, next, maintenance5_features);
+    VkPhysicalDeviceDeviceGeneratedCommandsFeaturesEXT generated_commands_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DEVICE_GENERATED_COMMANDS_FEATURES_EXT};
+    AppendFeatureIf(has_generated_commands, next, generated_commands_features);
+    VkPhysicalDevicePresentIdFeaturesKHR present_id_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR};
+    AppendFeatureIf(has_present_id, next, present_id_features);
+    VkPhysicalDevicePresentWaitFeaturesKHR present_wait_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR};
+    AppendFeatureIf(has_present_wait, next, present_wait_features);
+    VkPhysicalDeviceSwapchainMaintenance1FeaturesEXT swapchain_maintenance1_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SWAPCHAIN_MAINTENANCE_1_FEATURES_EXT};
+    AppendFeatureIf(has_swapchain_maintenance1, next, swapchain_maintenance1_features);
+    VkPhysicalDeviceHostImageCopyFeaturesEXT host_image_copy_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT};
+    AppendFeatureIf(has_host_image_copy, next, host_image_copy_features);
+    VkPhysicalDeviceConditionalRenderingFeaturesEXT conditional_rendering_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_CONDITIONAL_RENDERING_FEATURES_EXT};
+    AppendFeatureIf(has_conditional_rendering, next, conditional_rendering_features);
+    VkPhysicalDeviceFragmentShadingRateFeaturesKHR fragment_shading_rate_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_FEATURES_KHR};
+    AppendFeatureIf(has_fragment_shading_rate, next, fragment_shading_rate_features);
+    vkGetPhysicalDeviceFeatures2(physical_device, &features2);
+
+    resolution.graphicsPipelineLibrary = library_features.graphicsPipelineLibrary == VK_TRUE;
+    resolution.dynamicRendering = dynamic_rendering_features.dynamicRendering == VK_TRUE;
+    resolution.extendedDynamicState = dynamic_state_features.extendedDynamicState == VK_TRUE;
+    resolution.extendedDynamicState2 = dynamic_state2_features.extendedDynamicState2 == VK_TRUE;
+    resolution.extendedDynamicState2LogicOp = dynamic_state2_features.extendedDynamicState2LogicOp == VK_TRUE;
+    resolution.extendedDynamicState2PatchControlPoints = dynamic_state2_features.extendedDynamicState2PatchControlPoints == VK_TRUE;
+    resolution.extendedDynamicState3PolygonMode = dynamic_state3_features.extendedDynamicState3PolygonMode == VK_TRUE;
+    resolution.extendedDynamicState3DepthClampEnable = dynamic_state3_features.extendedDynamicState3DepthClampEnable == VK_TRUE;
+    resolution.extendedDynamicState3RasterizationSamples = dynamic_state3_features.extendedDynamicState3RasterizationSamples == VK_TRUE;
+    resolution.extendedDynamicState3AlphaToCoverageEnable = dynamic_state3_features.extendedDynamicState3AlphaToCoverageEnable == VK_TRUE;
+    resolution.extendedDynamicState3LogicOpEnable = dynamic_state3_features.extendedDynamicState3LogicOpEnable == VK_TRUE;
+    resolution.extendedDynamicState3ColorBlendEnable = dynamic_state3_features.extendedDynamicState3ColorBlendEnable == VK_TRUE;
+    resolution.extendedDynamicState3ColorBlendEquation = dynamic_state3_features.extendedDynamicState3ColorBlendEquation == VK_TRUE;
+    resolution.extendedDynamicState3ColorWriteMask = dynamic_state3_features.extendedDynamicState3ColorWriteMask == VK_TRUE;
+    // Shader objects are drawn with dynamic rendering only
+    resolution.shaderObject = shader_object_features.shaderObject == VK_TRUE && resolution.dynamicRendering;
+    resolution.pipelineExecutableInfo = executable_features.pipelineExecutableInfo == VK_TRUE;
+    resolution.descriptorBuffer = descriptor_buffer_features.descriptorBuffer == VK_TRUE;
+    resolution.synchronization2 = synchronization2_features.synchronization2 == VK_TRUE;
+    resolution.multiDraw = multi_draw_features.multiDraw == VK_TRUE;
+    resolution.maintenance5 = maintenance5_features.maintenance5 == VK_TRUE;
+    // Indirect-bindable pipelines and preprocess buffers are only expressible with 64-bit flags
+    resolution.deviceGeneratedCommands = generated_commands_features.deviceGeneratedCommands == VK_TRUE && resolution.maintenance5;
+    resolution.dynamicGeneratedPipelineLayout = generated_commands_features.dynamicGeneratedPipelineLayout == VK_TRUE &&
+                                                resolution.deviceGeneratedCommands;
+    resolution.presentId = present_id_features.presentId == VK_TRUE;
+    // Presents are waited on by the id they were given
+    resolution.presentWait = present_wait_features.presentWait == VK_TRUE && resolution.presentId;
+    resolution.swapchainMaintenance1 = swapchain_maintenance1_features.swapchainMaintenance1 == VK_TRUE;
+    resolution.hostImageCopy = host_image_copy_features.hostImageCopy == VK_TRUE;
+    resolution.conditionalRendering = conditional_rendering_features.conditionalRendering == VK_TRUE;
+    resolution.pipelineFragmentShadingRate = fragment_shading_rate_features.pipelineFragmentShadingRate == VK_TRUE;
+    resolution.primitiveFragmentShadingRate = fragment_shading_rate_features.primitiveFragmentShadingRate == VK_TRUE;
+    resolution.attachmentFragmentShadingRate = fragment_shading_rate_features.attachmentFragmentShadingRate == VK_TRUE;
+    // No feature bit; the extension is needed as instances target Vulkan 1.2
+    resolution.pipelineCreationFeedback = enabled_set.contains(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+    resolution.pushDescriptor = enabled_set.contains(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+    resolution.drawIndirectCount = enabled_set.contains(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+    resolution.incrementalPresent = enabled_set.contains(VK_KHR_INCREMENTAL_PRESENT_EXTENSION_NAME);
+    resolution.displayTiming = enabled_set.contains(VK_GOOGLE_DISPLAY_TIMING_EXTENSION_NAME);
+
+    if (resolution.graphicsPipelineLibrary && vkGetPhysicalDeviceProperties2 != nullptr) {
+        VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT library_properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_PROPERTIES_EXT};
+        VkPhysicalDeviceProperties2 properties2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2};
+        properties2.pNext = &library_properties;
+        vkGetPhysicalDeviceProperties2(physical_device, &properties2);
+        resolution.graphicsPipelineLibraryFastLinking = library_properties.graphicsPipelineLibraryFastLinking == VK_TRUE;
+    }
+
+    return resolution;
+}
+
 std::vector<std::string> EnumerateInstanceExtensionNames()
 {
     EnsureVolkInitialized();
@@ -237,4 +379,28 @@ std::vector<std::string> EnumerateInstanceLayerNames()
     return names;
 }
 
+std::vector<std::string> EnumerateDeviceExtensionNames(VkPhysicalDevice physical_device)
+{
+    uint32_t count = 0;
+    VkResult result = vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &count, nullptr);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to enumerate device extensions");
+    }
+
+    std::vector<VkExtensionProperties> properties(count);
+    if (count > 0) {
+        result = vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &count, properties.data());
+        if (result != VK_SUCCESS) {
+            throw std::runtime_error("Failed to enumerate device extensions");
+        }
+    }
+
+    std::vector<std::string> names;
+    names.reserve(properties.size());
+    for (const VkExtensionProperties& prop : properties) {
+        names.emplace_back(prop.extensionName);
+    }
+    return names;
+}
+
 } // namespace VulkanEngine::RAII::Utils
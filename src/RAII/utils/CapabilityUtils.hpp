@@ -31,6 +31,47 @@ struct FeatureResolution {
     std::vector<std::string> missingOptional;
 };
 
+// Extension features the wrapper can use. A flag is only set when its extension
+// is in the enabled list and the device reports the feature.
+struct DeviceExtensionFeatures {
+    bool graphicsPipelineLibrary{false};
+    bool graphicsPipelineLibraryFastLinking{false}; // Linking libraries is cheap enough to do at draw time
+    bool dynamicRendering{false};
+    bool extendedDynamicState{false};
+    bool extendedDynamicState2{false};
+    bool extendedDynamicState2LogicOp{false};
+    bool extendedDynamicState2PatchControlPoints{false};
+    bool extendedDynamicState3PolygonMode{false};
+    bool extendedDynamicState3DepthClampEnable{false};
+    bool extendedDynamicState3RasterizationSamples{false};
+    bool extendedDynamicState3AlphaToCoverageEnable{false};
+    bool extendedDynamicState3LogicOpEnable{false};
+    bool extendedDynamicState3ColorBlendEnable{false};
+    bool extendedDynamicState3ColorBlendEquation{false};
+    bool extendedDynamicState3ColorWriteMask{false};
+    bool shaderObject{false};
+    bool pipelineCreationFeedback{false};
+    bool pipelineExecutableInfo{false};
+    bool descriptorBuffer{false}; // Also needs bufferDeviceAddress; Device clears it otherwise
+    bool pushDescriptor{false};
+    bool synchronization2{false};
+    bool drawIndirectCount{false};
+    bool multiDraw{false};
+    bool maintenance5{false};
+    bool deviceGeneratedCommands{false}; // Also needs maintenance5 (64-bit pipeline and buffer usage flags)
+    bool dynamicGeneratedPipelineLayout{false};
+    bool presentId{false};
+    bool presentWait{false}; // Also needs presentId
+    bool swapchainMaintenance1{false};
+    bool incrementalPresent{false};
+    bool displayTiming{false};
+    bool hostImageCopy{false};
+    bool conditionalRendering{false};
+    bool pipelineFragmentShadingRate{false};
+    bool primitiveFragmentShadingRate{false};
+    bool attachmentFragmentShadingRate{false};
+};
+
 NamedCapabilityResolution ResolveNamedCapabilities(const std::vector<NamedCapabilityRequest>& requests,
                                                      const std::vector<std::string>& available);
 
@@ -38,8 +79,15 @@ FeatureResolution ResolveDeviceFeatures(const VkPhysicalDeviceFeatures& supporte
                                           const VkPhysicalDeviceFeatures& required,
                                           const VkPhysicalDeviceFeatures& optional);
 
+// Set every feature of source in target as well
+void MergeDeviceFeatures(VkPhysicalDeviceFeatures& target, const VkPhysicalDeviceFeatures& source);
+
+DeviceExtensionFeatures ResolveDeviceExtensionFeatures(VkPhysicalDevice physical_device,
+                                                       const std::vector<std::string>& enabled_extensions);
+
 std::vector<std::string> EnumerateInstanceExtensionNames();
 std::vector<std::string> EnumerateInstanceLayerNames();
+std::vector<std::string> EnumerateDeviceExtensionNames(VkPhysicalDevice physical_device);
 
 } // namespace VulkanEngine::RAII::Utils
 
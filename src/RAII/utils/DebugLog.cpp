@@ -0,0 +1,185 @@
+#include "DebugLog.hpp"
+
+#include <iostream>
+#include <string>
+#include <utility>
+
+namespace VulkanEngine::RAII::Utils {
+
+namespace {
+void PrintToStderr(const DebugMessage& message) {
+    std::cerr << "[Vulkan Validation] " << message.text << '\n';
+}
+} // namespace
+
+DebugLog& DebugLog::Instance() {
+    static DebugLog log;
+    return log;
+}
+
+DebugLog::DebugLog()
+    : head_(new Node()),
+    tail_(head_.load(std::memory_order_relaxed)),
+    sink_(PrintToStderr) {}
+
+DebugLog::~DebugLog() {
+    stopping_.store(true, std::memory_order_release);
+    generation_.fetch_add(1, std::memory_order_release);
+    generation_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    // Everything was drained by the thread; only the stub node is left
+    while (Node* next = tail_->next.load(std::memory_order_acquire)) {
+        delete tail_;
+        tail_ = next;
+    }
+    delete tail_;
+}
+
+void DebugLog::Post(VkDebugUtilsMessageSeverityFlagBitsEXT severity,
+                    VkDebugUtilsMessageTypeFlagsEXT type,
+                    const VkDebugUtilsMessengerCallbackDataEXT& data) {
+    if (queued_.fetch_add(1, std::memory_order_relaxed) >= maxQueued_.load(std::memory_order_relaxed)) {
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    EnsureStarted();
+
+    auto* node = new Node();
+    node->message.severity = severity;
+    node->message.type = type;
+    node->message.messageId = data.messageIdNumber;
+    if (data.pMessageIdName != nullptr) {
+        node->message.messageIdName = data.pMessageIdName;
+    }
+    node->message.text = data.pMessage != nullptr ? data.pMessage : "<null>";
+
+    posted_.fetch_add(1, std::memory_order_relaxed);
+    Node* previous = head_.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+
+    generation_.fetch_add(1, std::memory_order_release);
+    generation_.notify_one();
+}
+
+void DebugLog::Flush() {
+    const uint64_t target = posted_.load(std::memory_order_acquire);
+    uint64_t done = processed_.load(std::memory_order_acquire);
+    while (done < target) {
+        processed_.wait(done, std::memory_order_acquire);
+        done = processed_.load(std::memory_order_acquire);
+    }
+}
+
+void DebugLog::Configure(const DebugLogConfig& config) {
+    std::lock_guard lock(configMutex_);
+    config_ = config;
+    maxQueued_.store(config.maxQueued, std::memory_order_relaxed);
+}
+
+void DebugLog::SetSink(Sink sink) {
+    std::lock_guard lock(configMutex_);
+    sink_ = sink ? std::move(sink) : Sink(PrintToStderr);
+}
+
+void DebugLog::EnsureStarted() {
+    std::call_once(started_, [this] { thread_ = std::thread(&DebugLog::Run, this); });
+}
+
+void DebugLog::Run() {
+    while (true) {
+        const uint64_t seen = generation_.load(std::memory_order_acquire);
+        const bool stopping = stopping_.load(std::memory_order_acquire);
+        Drain();
+        if (stopping) {
+            break;
+        }
+        generation_.wait(seen, std::memory_order_acquire);
+    }
+
+    Sink sink;
+    {
+        std::lock_guard lock(configMutex_);
+        sink = sink_;
+    }
+    for (const auto& [message_id, state] : idStates_) {
+        ReportSuppressed(message_id, state, sink);
+    }
+}
+
+bool DebugLog::Drain() {
+    DebugLogConfig config;
+    Sink sink;
+    {
+        std::lock_guard lock(configMutex_);
+        config = config_;
+        sink = sink_;
+    }
+
+    uint64_t count = 0;
+    while (Node* next = tail_->next.load(std::memory_order_acquire)) {
+        DebugMessage message = std::move(next->message);
+        delete tail_;
+        tail_ = next;
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        Deliver(message, config, sink);
+        ++count;
+    }
+
+    const uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != reportedDropped_) {
+        DebugMessage report;
+        report.severity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT;
+        report.text = "Dropped " + std::to_string(dropped - reportedDropped_) + " messages; the log queue was full";
+        sink(report);
+        reportedDropped_ = dropped;
+    }
+
+    if (count > 0) {
+        processed_.fetch_add(count, std::memory_order_release);
+        processed_.notify_all();
+    }
+    return count > 0;
+}
+
+void DebugLog::Deliver(DebugMessage& message, const DebugLogConfig& config, const Sink& sink) {
+    IdState& state = idStates_[message.messageId];
+    const Clock::time_point now = Clock::now();
+    if (now - state.windowStart >= std::chrono::seconds(1)) {
+        ReportSuppressed(message.messageId, state, sink);
+        state.suppressed = 0;
+        state.windowCount = 0;
+        state.windowStart = now;
+    }
+
+    if (config.deduplicate && message.text == state.lastText) {
+        ++state.suppressed;
+        return;
+    }
+    if (message.messageId != 0 && config.maxPerIdPerSecond != 0 && state.windowCount >= config.maxPerIdPerSecond) {
+        ++state.suppressed;
+        return;
+    }
+
+    ++state.windowCount;
+    state.idName = message.messageIdName;
+    state.lastText = message.text;
+    sink(message);
+}
+
+void DebugLog::ReportSuppressed(int32_t message_id, const IdState& state, const Sink& sink) const {
+    if (state.suppressed == 0) {
+        return;
+    }
+    DebugMessage report;
+    report.severity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT;
+    report.messageId = message_id;
+    report.messageIdName = state.idName;
+    report.text = "Suppressed " + std::to_string(state.suppressed) + " repeats of " +
+                  (state.idName.empty() ? std::string("an unnamed message") : state.idName);
+    sink(report);
+}
+
+} // namespace VulkanEngine::RAII::Utils
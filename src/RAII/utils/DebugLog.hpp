@@ -0,0 +1,116 @@
+#ifndef VULKAN_RAII_UTILS_DEBUG_LOG_HPP
+#define VULKAN_RAII_UTILS_DEBUG_LOG_HPP
+
+#include <volk.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace VulkanEngine::RAII::Utils {
+
+// A validation or loader message copied out of VkDebugUtilsMessengerCallbackDataEXT
+struct DebugMessage {
+    VkDebugUtilsMessageSeverityFlagBitsEXT severity{VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT};
+    VkDebugUtilsMessageTypeFlagsEXT type{0};
+    int32_t messageId{0};
+    std::string messageIdName;
+    std::string text;
+};
+
+struct DebugLogConfig {
+    // Messages printed per message ID and second; 0 disables the limit. Messages without
+    // an ID (0) are only deduplicated
+    uint32_t maxPerIdPerSecond{10};
+    // Messages waiting for the logger thread; further ones are dropped and counted
+    uint32_t maxQueued{4096};
+    // Drop a message identical to the previous one printed for its ID
+    bool deduplicate{true};
+};
+
+// Process-wide asynchronous sink of the debug messenger callbacks. Post only copies the
+// message into a lock-free multi-producer queue, so the driver call that raised it
+// returns in microseconds; a background thread formats and prints, deduplicating and
+// rate limiting by message ID. Suppressed and dropped counts are reported as the
+// limits reset and on shutdown. The thread starts with the first Post
+class DebugLog {
+public:
+    using Sink = std::function<void(const DebugMessage&)>;
+
+    static DebugLog& Instance();
+
+    ~DebugLog();
+
+    DebugLog(const DebugLog&) = delete;
+    DebugLog& operator=(const DebugLog&) = delete;
+
+    // Callable from any thread, including from inside driver calls
+    void Post(VkDebugUtilsMessageSeverityFlagBitsEXT severity,
+              VkDebugUtilsMessageTypeFlagsEXT type,
+              const VkDebugUtilsMessengerCallbackDataEXT& data);
+
+    // Block until every message posted so far has been handed to the sink, e.g. before
+    // aborting on a validation error
+    void Flush();
+
+    void Configure(const DebugLogConfig& config);
+
+    // Replace the default std::cerr output; called on the logger thread only
+    void SetSink(Sink sink);
+
+    [[nodiscard]] uint64_t GetDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        DebugMessage message;
+    };
+
+    struct IdState {
+        std::string idName;
+        std::string lastText;
+        Clock::time_point windowStart{};
+        uint32_t windowCount{0};
+        uint64_t suppressed{0};
+    };
+
+    DebugLog();
+
+    void EnsureStarted();
+    void Run();
+    bool Drain(); // Consumer side; false when the queue was empty
+    void Deliver(DebugMessage& message, const DebugLogConfig& config, const Sink& sink);
+    void ReportSuppressed(int32_t message_id, const IdState& state, const Sink& sink) const;
+
+    // Vyukov intrusive MPSC queue: producers exchange head_, the logger thread owns tail_
+    std::atomic<Node*> head_;
+    Node* tail_;
+
+    std::atomic<uint32_t> queued_{0};
+    std::atomic<uint64_t> posted_{0};
+    std::atomic<uint64_t> processed_{0};
+    std::atomic<uint64_t> generation_{0}; // Bumped per post; the logger thread waits on it
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint32_t> maxQueued_{DebugLogConfig{}.maxQueued};
+    std::atomic<bool> stopping_{false};
+    std::once_flag started_;
+    std::thread thread_;
+
+    std::mutex configMutex_;
+    DebugLogConfig config_{};
+    Sink sink_;
+
+    // Logger thread only
+    std::unordered_map<int32_t, IdState> idStates_;
+    uint64_t reportedDropped_{0};
+};
+
+} // namespace VulkanEngine::RAII::Utils
+
+#endif // VULKAN_RAII_UTILS_DEBUG_LOG_HPP
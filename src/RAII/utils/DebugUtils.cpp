@@ -1,5 +1,7 @@
 #include "DebugUtils.hpp"
 
+#include "DebugLog.hpp"
+
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
@@ -142,10 +144,9 @@ VKAPI_ATTR VkBool32 VKAPI_CALL ValidationUtils::DebugCallback(
     const VkDebugUtilsMessengerCallbackDataEXT* p_callback_data,
     void* /*pUserData*/)
 {
-    std::cerr << "Validation Layer [Severity: " << message_severity
-              << ", Type: " << message_type
-              << "]: " << (p_callback_data ? p_callback_data->pMessage : "<null>")
-              << '\n';
+    if (p_callback_data != nullptr) {
+        DebugLog::Instance().Post(message_severity, message_type, *p_callback_data);
+    }
     return VK_FALSE;
 }
 
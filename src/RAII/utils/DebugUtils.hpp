@@ -2,13 +2,109 @@
 #define VULKAN_RAII_UTILS_DEBUG_UTILS_HPP
 
 #include <volk.h>
+#include <array>
+#include <cstdint>
 #include <string>
 #include <vector>
 
+#include "HashUtils.hpp"
+
+// Object names and command buffer labels (VK_EXT_debug_utils) are compiled in when
+// VULKAN_RAII_DEBUG_NAMES is 1. The build sets it for every configuration except
+// Release and MinSizeRel; headers used without the build default to !NDEBUG
+#ifndef VULKAN_RAII_DEBUG_NAMES
+#ifdef NDEBUG
+#define VULKAN_RAII_DEBUG_NAMES 0
+#else
+#define VULKAN_RAII_DEBUG_NAMES 1
+#endif
+#endif
 
 
 namespace VulkanEngine::RAII::Utils {
 
+inline constexpr bool DEBUG_NAMES_ENABLED = VULKAN_RAII_DEBUG_NAMES != 0;
+
+// Debug name storage of a wrapper object. The disabled policy is empty, so a
+// [[no_unique_address]] member of it takes no space and every call compiles away
+template <bool Enabled>
+class BasicDebugName {
+public:
+    void Set(const char* name) { name_ = name ? name : ""; }
+    [[nodiscard]] const char* Get() const { return name_.c_str(); }
+    [[nodiscard]] bool IsEmpty() const { return name_.empty(); }
+
+private:
+    std::string name_;
+};
+
+template <>
+class BasicDebugName<false> {
+public:
+    void Set(const char*) {}
+    [[nodiscard]] const char* Get() const { return ""; }
+    [[nodiscard]] bool IsEmpty() const { return true; }
+};
+
+using DebugName = BasicDebugName<DEBUG_NAMES_ENABLED>;
+
+// Name a Vulkan object for validation messages and capture tools; a no-op when names
+// are compiled out, the name is empty or VK_EXT_debug_utils is not loaded
+template <typename Handle>
+inline void SetObjectName(VkDevice device, VkObjectType type, Handle handle, const char* name)
+{
+    if constexpr (DEBUG_NAMES_ENABLED) {
+        if (device == VK_NULL_HANDLE || handle == VK_NULL_HANDLE || name == nullptr || *name == '\0' || !vkSetDebugUtilsObjectNameEXT) {
+            return;
+        }
+        VkDebugUtilsObjectNameInfoEXT info{VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT};
+        info.objectType = type;
+        info.objectHandle = HandleToUint64(handle);
+        info.pObjectName = name;
+        vkSetDebugUtilsObjectNameEXT(device, &info);
+    }
+}
+
+// Command buffer label helpers with the same compile-time switch (see CommandBuffer::ScopedLabel)
+inline void BeginCommandLabel(VkCommandBuffer command_buffer, const char* name, const std::array<float, 4>& color = {})
+{
+    if constexpr (DEBUG_NAMES_ENABLED) {
+        if (command_buffer == VK_NULL_HANDLE || name == nullptr || !vkCmdBeginDebugUtilsLabelEXT) {
+            return;
+        }
+        VkDebugUtilsLabelEXT label{VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT};
+        label.pLabelName = name;
+        for (size_t i = 0; i < color.size(); ++i) {
+            label.color[i] = color[i];
+        }
+        vkCmdBeginDebugUtilsLabelEXT(command_buffer, &label);
+    }
+}
+
+inline void EndCommandLabel(VkCommandBuffer command_buffer)
+{
+    if constexpr (DEBUG_NAMES_ENABLED) {
+        if (command_buffer != VK_NULL_HANDLE && vkCmdEndDebugUtilsLabelEXT) {
+            vkCmdEndDebugUtilsLabelEXT(command_buffer);
+        }
+    }
+}
+
+inline void InsertCommandLabel(VkCommandBuffer command_buffer, const char* name, const std::array<float, 4>& color = {})
+{
+    if constexpr (DEBUG_NAMES_ENABLED) {
+        if (command_buffer == VK_NULL_HANDLE || name == nullptr || !vkCmdInsertDebugUtilsLabelEXT) {
+            return;
+        }
+        VkDebugUtilsLabelEXT label{VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT};
+        label.pLabelName = name;
+        for (size_t i = 0; i < color.size(); ++i) {
+            label.color[i] = color[i];
+        }
+        vkCmdInsertDebugUtilsLabelEXT(command_buffer, &label);
+    }
+}
+
 // String conversion utilities for debugging
 class StringUtils {
 public:
@@ -51,7 +147,7 @@ public:
     static bool CheckDeviceExtensionSupport(VkPhysicalDevice device,
                                            const std::vector<const char*>& required_extensions);
     
-    // Validation layer debug callback
+    // Validation layer debug callback (queued to DebugLog, see DebugMessenger::DebugCallback)
     static VKAPI_ATTR VkBool32 VKAPI_CALL DebugCallback(
         VkDebugUtilsMessageSeverityFlagBitsEXT message_severity,
         VkDebugUtilsMessageTypeFlagsEXT message_type,
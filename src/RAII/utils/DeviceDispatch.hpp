@@ -0,0 +1,12 @@
+#ifndef VULKAN_RAII_UTILS_DEVICE_DISPATCH_HPP
+#define VULKAN_RAII_UTILS_DEVICE_DISPATCH_HPP
+
+#include <volk.h>
+
+// Device-level entry point `name` from a VolkDeviceTable (Device::GetDispatch), which
+// calls straight into the driver of that device, or the global volk pointer when table
+// is null:
+//     VULKAN_RAII_DEVICE_FN(dispatch_, vkCmdPipelineBarrier)(cmd, ...);
+#define VULKAN_RAII_DEVICE_FN(table, name) ((table) != nullptr ? (table)->name : name)
+
+#endif // VULKAN_RAII_UTILS_DEVICE_DISPATCH_HPP
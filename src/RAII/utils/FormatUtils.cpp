@@ -1,7 +1,10 @@
 #include "FormatUtils.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <iterator>
 #include <stdexcept>
+#include <string_view>
 #include <vector>
 
 
@@ -133,8 +136,83 @@ uint32_t ComponentCount(VkFormat format) {
             return 4;
     }
 }
+
+bool HasExtension(const std::vector<VkExtensionProperties>& extensions, std::string_view name) {
+    return std::any_of(extensions.begin(), extensions.end(), [name](const VkExtensionProperties& extension) {
+        return std::string_view(extension.extensionName) == name;
+    });
+}
 } // namespace
 
+const FormatTable::Features FormatTable::NO_FEATURES{};
+
+FormatTable::FormatTable(VkPhysicalDevice physical_device,
+                         uint32_t api_version,
+                         const std::vector<VkExtensionProperties>& extensions) {
+    // Formats of extensions the device lacks are not valid to query; their entries stay zero
+    const bool range_available[] = {
+        true,
+        api_version >= VK_API_VERSION_1_1 || HasExtension(extensions, VK_KHR_SAMPLER_YCBCR_CONVERSION_EXTENSION_NAME),
+        HasExtension(extensions, VK_IMG_FORMAT_PVRTC_EXTENSION_NAME),
+        api_version >= VK_API_VERSION_1_3 || HasExtension(extensions, VK_EXT_TEXTURE_COMPRESSION_ASTC_HDR_EXTENSION_NAME),
+        api_version >= VK_API_VERSION_1_3 || HasExtension(extensions, VK_EXT_YCBCR_2PLANE_444_FORMATS_EXTENSION_NAME),
+        api_version >= VK_API_VERSION_1_3 || HasExtension(extensions, VK_EXT_4444_FORMATS_EXTENSION_NAME),
+        HasExtension(extensions, VK_KHR_MAINTENANCE_5_EXTENSION_NAME),
+    };
+    static_assert(std::size(range_available) == std::size(FORMAT_RANGES));
+
+    featureFlags2_ = api_version >= VK_API_VERSION_1_1 && vkGetPhysicalDeviceFormatProperties2 != nullptr &&
+        (api_version >= VK_API_VERSION_1_3 || HasExtension(extensions, VK_KHR_FORMAT_FEATURE_FLAGS_2_EXTENSION_NAME));
+
+    uint32_t index = 0;
+    for (size_t range = 0; range < std::size(FORMAT_RANGES); ++range) {
+        for (uint32_t i = 0; i < FORMAT_RANGES[range].count; ++i, ++index) {
+            if (!range_available[range]) {
+                continue;
+            }
+            const auto format = static_cast<VkFormat>(FORMAT_RANGES[range].first + i);
+            Features& features = features_[index];
+            if (featureFlags2_) {
+                VkFormatProperties3KHR properties3{VK_STRUCTURE_TYPE_FORMAT_PROPERTIES_3_KHR};
+                VkFormatProperties2 properties2{VK_STRUCTURE_TYPE_FORMAT_PROPERTIES_2};
+                properties2.pNext = &properties3;
+                vkGetPhysicalDeviceFormatProperties2(physical_device, format, &properties2);
+                features.linear = properties3.linearTilingFeatures;
+                features.optimal = properties3.optimalTilingFeatures;
+                features.buffer = properties3.bufferFeatures;
+            } else {
+                VkFormatProperties properties{};
+                vkGetPhysicalDeviceFormatProperties(physical_device, format, &properties);
+                features.linear = properties.linearTilingFeatures;
+                features.optimal = properties.optimalTilingFeatures;
+                features.buffer = properties.bufferFeatures;
+            }
+        }
+    }
+}
+
+VkFormatFeatureFlags2KHR FormatTable::GetImageFeatures(VkFormat format, VkImageTiling tiling) const {
+    const Features& features = Get(format);
+    if (tiling == VK_IMAGE_TILING_LINEAR) {
+        return features.linear;
+    }
+    if (tiling == VK_IMAGE_TILING_OPTIMAL) {
+        return features.optimal;
+    }
+    return 0;
+}
+
+VkFormat FormatTable::ChooseBest(std::span<const VkFormat> candidates,
+                                 VkFormatFeatureFlags2KHR features,
+                                 VkImageTiling tiling) const {
+    for (VkFormat format : candidates) {
+        if (Supports(format, tiling, features)) {
+            return format;
+        }
+    }
+    return VK_FORMAT_UNDEFINED;
+}
+
 bool FormatUtils::IsDepthFormat(VkFormat format) {
     switch (format) {
         case VK_FORMAT_D16_UNORM:
@@ -197,6 +275,10 @@ bool FormatUtils::IsCompressedFormat(VkFormat format) {
         case VK_FORMAT_BC7_SRGB_BLOCK:
         case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
         case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+        case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
             return true;
         default:
             return false;
@@ -291,6 +373,8 @@ bool FormatUtils::IsSrgbFormat(VkFormat format) {
         case VK_FORMAT_BC3_SRGB_BLOCK:
         case VK_FORMAT_BC7_SRGB_BLOCK:
         case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+        case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
             return true;
         default:
             return false;
@@ -317,6 +401,17 @@ VkFormat FormatUtils::FindSupportedFormat(VkPhysicalDevice physical_device,
     throw std::runtime_error("Failed to find supported format");
 }
 
+VkFormat FormatUtils::FindSupportedFormat(const FormatTable& table,
+                                          const std::vector<VkFormat>& candidates,
+                                          VkImageTiling tiling,
+                                          VkFormatFeatureFlags features) {
+    const VkFormat format = table.ChooseBest(candidates, features, tiling);
+    if (format == VK_FORMAT_UNDEFINED) {
+        throw std::runtime_error("Failed to find supported format");
+    }
+    return format;
+}
+
 VkFormat FormatUtils::FindDepthFormat(VkPhysicalDevice physical_device) {
     return FindSupportedFormat(physical_device,
                                {VK_FORMAT_D32_SFLOAT,
@@ -327,6 +422,16 @@ VkFormat FormatUtils::FindDepthFormat(VkPhysicalDevice physical_device) {
                                VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
 }
 
+VkFormat FormatUtils::FindDepthFormat(const FormatTable& table) {
+    return FindSupportedFormat(table,
+                               {VK_FORMAT_D32_SFLOAT,
+                                VK_FORMAT_D32_SFLOAT_S8_UINT,
+                                VK_FORMAT_D24_UNORM_S8_UINT,
+                                VK_FORMAT_D16_UNORM},
+                               VK_IMAGE_TILING_OPTIMAL,
+                               VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
+}
+
 VkFormat FormatUtils::FindDepthStencilFormat(VkPhysicalDevice physical_device) {
     return FindSupportedFormat(physical_device,
                                {VK_FORMAT_D32_SFLOAT_S8_UINT,
@@ -336,6 +441,15 @@ VkFormat FormatUtils::FindDepthStencilFormat(VkPhysicalDevice physical_device) {
                                VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
 }
 
+VkFormat FormatUtils::FindDepthStencilFormat(const FormatTable& table) {
+    return FindSupportedFormat(table,
+                               {VK_FORMAT_D32_SFLOAT_S8_UINT,
+                                VK_FORMAT_D24_UNORM_S8_UINT,
+                                VK_FORMAT_D16_UNORM_S8_UINT},
+                               VK_IMAGE_TILING_OPTIMAL,
+                               VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
+}
+
 VkFormatProperties FormatUtils::GetFormatProperties(VkPhysicalDevice physical_device, VkFormat format) {
     VkFormatProperties properties{};
     vkGetPhysicalDeviceFormatProperties(physical_device, format, &properties);
@@ -356,10 +470,59 @@ bool FormatUtils::SupportsFormatFeature(VkPhysicalDevice physical_device,
     return false;
 }
 
+bool FormatUtils::SupportsLinearBlit(VkPhysicalDevice physical_device,
+                                     VkFormat format,
+                                     VkImageTiling tiling) {
+    return SupportsFormatFeature(physical_device,
+                                 format,
+                                 tiling,
+                                 VK_FORMAT_FEATURE_BLIT_SRC_BIT |
+                                 VK_FORMAT_FEATURE_BLIT_DST_BIT |
+                                 VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT);
+}
+
+bool FormatUtils::SupportsFormatFeature(const FormatTable& table,
+                                        VkFormat format,
+                                        VkImageTiling tiling,
+                                        VkFormatFeatureFlags feature) {
+    return table.Supports(format, tiling, feature);
+}
+
+bool FormatUtils::SupportsLinearBlit(const FormatTable& table,
+                                     VkFormat format,
+                                     VkImageTiling tiling) {
+    return table.Supports(format,
+                          tiling,
+                          VK_FORMAT_FEATURE_BLIT_SRC_BIT |
+                          VK_FORMAT_FEATURE_BLIT_DST_BIT |
+                          VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT);
+}
+
 uint32_t FormatUtils::GetBytesPerPixel(VkFormat format) {
     return FormatSize(format);
 }
 
+uint32_t FormatUtils::GetAspectCopySize(VkFormat format, VkImageAspectFlags aspect) {
+    if (aspect == VK_IMAGE_ASPECT_STENCIL_BIT) {
+        return 1;
+    }
+    if (aspect != VK_IMAGE_ASPECT_DEPTH_BIT) {
+        return GetBytesPerPixel(format);
+    }
+    switch (format) {
+        case VK_FORMAT_D16_UNORM:
+        case VK_FORMAT_D16_UNORM_S8_UINT:
+            return 2;
+        case VK_FORMAT_X8_D24_UNORM_PACK32:
+        case VK_FORMAT_D24_UNORM_S8_UINT:
+        case VK_FORMAT_D32_SFLOAT:
+        case VK_FORMAT_D32_SFLOAT_S8_UINT:
+            return 4;
+        default:
+            return GetBytesPerPixel(format);
+    }
+}
+
 void FormatUtils::GetBlockSize(VkFormat format,
                                uint32_t& block_width,
                                uint32_t& block_height,
@@ -371,6 +534,8 @@ void FormatUtils::GetBlockSize(VkFormat format,
         case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
         case VK_FORMAT_BC4_UNORM_BLOCK:
         case VK_FORMAT_BC4_SNORM_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
             block_width = block_height = 4;
             block_size = 8;
             break;
@@ -384,6 +549,10 @@ void FormatUtils::GetBlockSize(VkFormat format,
         case VK_FORMAT_BC6H_SFLOAT_BLOCK:
         case VK_FORMAT_BC7_UNORM_BLOCK:
         case VK_FORMAT_BC7_SRGB_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+        case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
             block_width = block_height = 4;
             block_size = 16;
             break;
@@ -394,6 +563,39 @@ void FormatUtils::GetBlockSize(VkFormat format,
     }
 }
 
+namespace {
+std::array<VkFormat, 4> TranscodeCandidates(bool srgb) {
+    return {
+        srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK,
+        srgb ? VK_FORMAT_ASTC_4x4_SRGB_BLOCK : VK_FORMAT_ASTC_4x4_UNORM_BLOCK,
+        srgb ? VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK : VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK,
+        srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM,
+    };
+}
+
+constexpr VkFormatFeatureFlags TRANSCODE_TARGET_FEATURES = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+} // namespace
+
+std::vector<VkFormat> FormatUtils::GetTranscodeTargets(VkPhysicalDevice physical_device, bool srgb) {
+    std::vector<VkFormat> supported;
+    for (VkFormat format : TranscodeCandidates(srgb)) {
+        if (SupportsFormatFeature(physical_device, format, VK_IMAGE_TILING_OPTIMAL, TRANSCODE_TARGET_FEATURES)) {
+            supported.push_back(format);
+        }
+    }
+    return supported;
+}
+
+std::vector<VkFormat> FormatUtils::GetTranscodeTargets(const FormatTable& table, bool srgb) {
+    std::vector<VkFormat> supported;
+    for (VkFormat format : TranscodeCandidates(srgb)) {
+        if (table.Supports(format, VK_IMAGE_TILING_OPTIMAL, TRANSCODE_TARGET_FEATURES)) {
+            supported.push_back(format);
+        }
+    }
+    return supported;
+}
+
 } // namespace VulkanEngine::RAII::Utils
 
 
@@ -2,13 +2,108 @@
 #define VULKAN_RAII_UTILS_FORMAT_UTILS_HPP
 
 #include <volk.h>
+#include <array>
+#include <cstdint>
+#include <span>
 #include <vector>
 
 
 
 namespace VulkanEngine::RAII::Utils {
 
-// Format utilities
+// Linear, optimal and buffer features of every format a device can report, precomputed
+// once (PhysicalDevice builds one at construction), so capability checks are an array
+// read instead of a driver query. Features are VkFormatFeatureFlags2; they come from
+// VkFormatProperties3 on Vulkan 1.3 or VK_KHR_format_feature_flags2 devices and are the
+// widened 32-bit flags otherwise. Extension formats are covered when the device exposes
+// them and read as unsupported when it does not
+class FormatTable {
+public:
+    struct Features {
+        VkFormatFeatureFlags2KHR linear{0};
+        VkFormatFeatureFlags2KHR optimal{0};
+        VkFormatFeatureFlags2KHR buffer{0};
+    };
+
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+    FormatTable() = default;
+    FormatTable(VkPhysicalDevice physical_device,
+                uint32_t api_version,
+                const std::vector<VkExtensionProperties>& extensions);
+
+    // Dense table index of format; INVALID_INDEX for formats the table does not cover
+    [[nodiscard]] static constexpr uint32_t IndexOf(VkFormat format) {
+        uint32_t base = 0;
+        for (const FormatRange& range : FORMAT_RANGES) {
+            const auto value = static_cast<uint32_t>(format);
+            if (value >= range.first && value - range.first < range.count) {
+                return base + value - range.first;
+            }
+            base += range.count;
+        }
+        return INVALID_INDEX;
+    }
+
+    // Zero features for formats the table does not cover
+    [[nodiscard]] const Features& Get(VkFormat format) const {
+        const uint32_t index = IndexOf(format);
+        return index != INVALID_INDEX ? features_[index] : NO_FEATURES;
+    }
+
+    // Image features for tiling; zero for tilings other than linear and optimal
+    [[nodiscard]] VkFormatFeatureFlags2KHR GetImageFeatures(VkFormat format, VkImageTiling tiling) const;
+
+    [[nodiscard]] bool Supports(VkFormat format, VkImageTiling tiling, VkFormatFeatureFlags2KHR features) const {
+        return (GetImageFeatures(format, tiling) & features) == features;
+    }
+
+    [[nodiscard]] bool SupportsBuffer(VkFormat format, VkFormatFeatureFlags2KHR features) const {
+        return (Get(format).buffer & features) == features;
+    }
+
+    // First of candidates (ordered best first) with every feature for tiling;
+    // VK_FORMAT_UNDEFINED when none has them
+    [[nodiscard]] VkFormat ChooseBest(std::span<const VkFormat> candidates,
+                                      VkFormatFeatureFlags2KHR features,
+                                      VkImageTiling tiling = VK_IMAGE_TILING_OPTIMAL) const;
+
+    // Whether the features came from VkFormatProperties3
+    [[nodiscard]] bool HasFormatFeatureFlags2() const { return featureFlags2_; }
+
+private:
+    struct FormatRange {
+        uint32_t first;
+        uint32_t count;
+    };
+
+    // Core 1.0 formats, then the 1.1/1.3 promoted and extension blocks
+    static constexpr FormatRange FORMAT_RANGES[] = {
+        {VK_FORMAT_UNDEFINED, VK_FORMAT_ASTC_12x12_SRGB_BLOCK + 1},
+        {1000156000, 34}, // VK_FORMAT_G8B8G8R8_422_UNORM .. VK_FORMAT_G16_B16_R16_3PLANE_444_UNORM
+        {1000054000, 8}, // VK_IMG_format_pvrtc
+        {1000066000, 14}, // ASTC HDR (VK_EXT_texture_compression_astc_hdr)
+        {1000330000, 4}, // VK_EXT_ycbcr_2plane_444_formats
+        {1000340000, 2}, // VK_EXT_4444_formats
+        {1000470000, 2}, // VK_FORMAT_A1B5G5R5_UNORM_PACK16_KHR, VK_FORMAT_A8_UNORM_KHR
+    };
+
+    static constexpr uint32_t FORMAT_COUNT = [] {
+        uint32_t count = 0;
+        for (const FormatRange& range : FORMAT_RANGES) {
+            count += range.count;
+        }
+        return count;
+    }();
+
+    static const Features NO_FEATURES;
+
+    std::array<Features, FORMAT_COUNT> features_{};
+    bool featureFlags2_{false};
+};
+
+// Format utilities. The VkPhysicalDevice overloads query the driver on every call; format
+// selection uses the FormatTable overloads (PhysicalDevice::GetFormatTable)
 class FormatUtils {
 public:
     // Check if format is depth format
@@ -50,11 +145,18 @@ public:
                                        VkImageTiling tiling,
                                        VkFormatFeatureFlags features);
 
+    static VkFormat FindSupportedFormat(const FormatTable& table,
+                                       const std::vector<VkFormat>& candidates,
+                                       VkImageTiling tiling,
+                                       VkFormatFeatureFlags features);
+
     // Find depth format
     static VkFormat FindDepthFormat(VkPhysicalDevice physical_device);
+    static VkFormat FindDepthFormat(const FormatTable& table);
 
     // Find depth stencil format
     static VkFormat FindDepthStencilFormat(VkPhysicalDevice physical_device);
+    static VkFormat FindDepthStencilFormat(const FormatTable& table);
 
     // Get format features
     static VkFormatProperties GetFormatProperties(VkPhysicalDevice physical_device, VkFormat format);
@@ -65,11 +167,34 @@ public:
                                      VkImageTiling tiling,
                                      VkFormatFeatureFlags feature);
 
+    static bool SupportsFormatFeature(const FormatTable& table,
+                                     VkFormat format,
+                                     VkImageTiling tiling,
+                                     VkFormatFeatureFlags feature);
+
+    // Check if format can be blitted with linear filtering (GPU mipmap generation)
+    static bool SupportsLinearBlit(VkPhysicalDevice physical_device,
+                                   VkFormat format,
+                                   VkImageTiling tiling = VK_IMAGE_TILING_OPTIMAL);
+
+    static bool SupportsLinearBlit(const FormatTable& table,
+                                   VkFormat format,
+                                   VkImageTiling tiling = VK_IMAGE_TILING_OPTIMAL);
+
     // Get bytes per pixel for uncompressed formats
     static uint32_t GetBytesPerPixel(VkFormat format);
 
+    // Bytes per texel a buffer<->image copy of aspect uses; depth and stencil aspects of
+    // packed formats are copied separately (e.g. D24S8 depth is 4 bytes, its stencil 1)
+    static uint32_t GetAspectCopySize(VkFormat format, VkImageAspectFlags aspect);
+
     // Get block size for compressed formats
     static void GetBlockSize(VkFormat format, uint32_t& block_width, uint32_t& block_height, uint32_t& block_size);
+
+    // Formats a Basis Universal texture can be transcoded to that the device samples from
+    // and copies into, best first: BC7, ASTC 4x4, ETC2 RGBA8, then uncompressed RGBA8
+    static std::vector<VkFormat> GetTranscodeTargets(VkPhysicalDevice physical_device, bool srgb);
+    static std::vector<VkFormat> GetTranscodeTargets(const FormatTable& table, bool srgb);
 };
 
 } // namespace VulkanEngine::RAII::Utils
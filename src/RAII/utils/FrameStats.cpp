@@ -0,0 +1,108 @@
+#include "FrameStats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+
+namespace VulkanEngine::RAII::Utils {
+
+namespace {
+
+constexpr double FIRST_BUCKET_MS = 0.25;
+
+// Nearest-rank percentile of an ascending range
+double Percentile(const std::vector<double>& sorted, double fraction)
+{
+    const auto rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+} // namespace
+
+FrameStats::FrameStats(uint32_t capacity)
+    : samples_(std::max(1U, capacity), 0.0)
+{
+    sorted_.reserve(samples_.size());
+}
+
+void FrameStats::Add(double ms)
+{
+    ms = std::max(0.0, ms);
+    if (count_ == samples_.size()) {
+        const double oldest = samples_[next_];
+        sum_ -= oldest;
+        histogram_[GetBucket(oldest)]--;
+    } else {
+        count_++;
+    }
+    samples_[next_] = ms;
+    sum_ += ms;
+    histogram_[GetBucket(ms)]++;
+    next_ = (next_ + 1) % static_cast<uint32_t>(samples_.size());
+}
+
+void FrameStats::Reset()
+{
+    next_ = 0;
+    count_ = 0;
+    sum_ = 0.0;
+    histogram_.fill(0);
+}
+
+double FrameStats::GetLastMs() const
+{
+    if (count_ == 0) {
+        return 0.0;
+    }
+    const auto capacity = static_cast<uint32_t>(samples_.size());
+    return samples_[(next_ + capacity - 1) % capacity];
+}
+
+FrameStats::Summary FrameStats::GetSummary() const
+{
+    Summary summary{};
+    if (count_ == 0) {
+        return summary;
+    }
+    // Before the window fills the samples are the first count_ entries
+    sorted_.assign(samples_.begin(), samples_.begin() + count_);
+    std::sort(sorted_.begin(), sorted_.end());
+
+    summary.count = count_;
+    summary.minMs = sorted_.front();
+    summary.maxMs = sorted_.back();
+    summary.averageMs = GetAverageMs();
+    summary.p50Ms = Percentile(sorted_, 0.50);
+    summary.p95Ms = Percentile(sorted_, 0.95);
+    summary.p99Ms = Percentile(sorted_, 0.99);
+
+    const size_t slowest = std::max<size_t>(1, sorted_.size() / 100);
+    double slowest_sum = 0.0;
+    for (size_t i = sorted_.size() - slowest; i < sorted_.size(); ++i) {
+        slowest_sum += sorted_[i];
+    }
+    const double slowest_average = slowest_sum / static_cast<double>(slowest);
+    summary.low1PercentFps = slowest_average > 0.0 ? 1'000.0 / slowest_average : 0.0;
+    return summary;
+}
+
+size_t FrameStats::GetBucket(double ms)
+{
+    if (!(ms >= FIRST_BUCKET_MS)) {
+        return 0;
+    }
+    const double bucket = std::floor(std::log2(ms / FIRST_BUCKET_MS)) + 1.0;
+    return std::min(HISTOGRAM_BUCKETS - 1, static_cast<size_t>(bucket));
+}
+
+double FrameStats::GetBucketUpperMs(size_t bucket)
+{
+    if (bucket >= HISTOGRAM_BUCKETS - 1) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return std::ldexp(FIRST_BUCKET_MS, static_cast<int>(bucket));
+}
+
+} // namespace VulkanEngine::RAII::Utils
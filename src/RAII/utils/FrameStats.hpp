@@ -0,0 +1,67 @@
+#ifndef VULKAN_RAII_UTILS_FRAME_STATS_HPP
+#define VULKAN_RAII_UTILS_FRAME_STATS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace VulkanEngine::RAII::Utils {
+
+// Rolling window of per-frame durations in milliseconds. Storage is sized once at
+// construction, so Add never allocates; percentiles are computed on demand by
+// GetSummary. The histogram has log2 buckets: bucket 0 holds frames under 0.25 ms,
+// bucket i frames in [0.25 * 2^(i-1), 0.25 * 2^i) ms, the last one everything longer.
+// Not synchronized; guard it when several threads use one instance.
+class FrameStats {
+public:
+    static constexpr size_t HISTOGRAM_BUCKETS = 16;
+    using Histogram = std::array<uint32_t, HISTOGRAM_BUCKETS>;
+
+    struct Summary {
+        uint32_t count{0};
+        double minMs{0.0};
+        double maxMs{0.0};
+        double averageMs{0.0};
+        double p50Ms{0.0};
+        double p95Ms{0.0};
+        double p99Ms{0.0};
+        double low1PercentFps{0.0}; // Average FPS over the slowest 1% of frames (at least one)
+    };
+
+    // capacity frames are kept
+    explicit FrameStats(uint32_t capacity = 120);
+
+    // Record one frame; the oldest drops out once the window is full
+    void Add(double ms);
+
+    // Forget every frame (capacity stays)
+    void Reset();
+
+    [[nodiscard]] uint32_t GetCount() const { return count_; }
+    [[nodiscard]] uint32_t GetCapacity() const { return static_cast<uint32_t>(samples_.size()); }
+    [[nodiscard]] double GetAverageMs() const { return count_ > 0 ? sum_ / count_ : 0.0; }
+    [[nodiscard]] double GetLastMs() const;
+
+    [[nodiscard]] Summary GetSummary() const;
+
+    // Frames per bucket over the window
+    [[nodiscard]] const Histogram& GetHistogram() const { return histogram_; }
+
+    // Bucket a duration falls into, and the exclusive upper bound of a bucket in
+    // milliseconds (infinity for the last one)
+    [[nodiscard]] static size_t GetBucket(double ms);
+    [[nodiscard]] static double GetBucketUpperMs(size_t bucket);
+
+private:
+    std::vector<double> samples_; // Ring buffer
+    mutable std::vector<double> sorted_; // Scratch for GetSummary, same capacity
+    uint32_t next_{0};
+    uint32_t count_{0};
+    double sum_{0.0};
+    Histogram histogram_{};
+};
+
+} // namespace VulkanEngine::RAII::Utils
+
+#endif // VULKAN_RAII_UTILS_FRAME_STATS_HPP
@@ -0,0 +1,43 @@
+#ifndef VULKAN_RAII_UTILS_HASH_UTILS_HPP
+#define VULKAN_RAII_UTILS_HASH_UTILS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+
+namespace VulkanEngine::RAII::Utils {
+
+inline constexpr uint64_t FNV1A_OFFSET_BASIS = 14695981039346656037ull;
+inline constexpr uint64_t FNV1A_PRIME = 1099511628211ull;
+
+// 64-bit FNV-1a, one value at a time: bytes give the textbook hash, words hash
+// word keys without splitting them. Stable across runs, so results may key caches
+// on disk. Pass a previous result as hash to continue it
+template <typename T>
+[[nodiscard]] constexpr uint64_t HashFnv1a(const T* values, size_t count, uint64_t hash = FNV1A_OFFSET_BASIS)
+{
+    static_assert(std::is_integral_v<T> && std::is_unsigned_v<T>);
+    for (size_t i = 0; i < count; ++i) {
+        hash ^= values[i];
+        hash *= FNV1A_PRIME;
+    }
+    return hash;
+}
+
+// Vulkan handle as an integer key. Dispatchable handles are pointers; non-dispatchable
+// ones are pointers on 64-bit builds and uint64_t typedefs on 32-bit builds
+template <typename Handle>
+[[nodiscard]] inline uint64_t HandleToUint64(Handle handle)
+{
+    if constexpr (std::is_pointer_v<Handle>) {
+        return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(handle));
+    } else {
+        return static_cast<uint64_t>(handle);
+    }
+}
+
+} // namespace VulkanEngine::RAII::Utils
+
+
+#endif // VULKAN_RAII_UTILS_HASH_UTILS_HPP
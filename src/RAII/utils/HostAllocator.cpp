@@ -0,0 +1,362 @@
+#include "HostAllocator.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <new>
+#include <ostream>
+
+
+namespace VulkanEngine::RAII::Utils {
+
+namespace {
+
+struct SlotInfo {
+    VkObjectType type;
+    const char* name;
+};
+
+// Slot i < 26 holds core object type i; the extension types the wrapper creates follow
+constexpr uint32_t CORE_SLOT_COUNT = 26;
+constexpr std::array<SlotInfo, 41> SLOT_INFOS{{
+    {VK_OBJECT_TYPE_UNKNOWN, "Unknown"},
+    {VK_OBJECT_TYPE_INSTANCE, "Instance"},
+    {VK_OBJECT_TYPE_PHYSICAL_DEVICE, "PhysicalDevice"},
+    {VK_OBJECT_TYPE_DEVICE, "Device"},
+    {VK_OBJECT_TYPE_QUEUE, "Queue"},
+    {VK_OBJECT_TYPE_SEMAPHORE, "Semaphore"},
+    {VK_OBJECT_TYPE_COMMAND_BUFFER, "CommandBuffer"},
+    {VK_OBJECT_TYPE_FENCE, "Fence"},
+    {VK_OBJECT_TYPE_DEVICE_MEMORY, "DeviceMemory"},
+    {VK_OBJECT_TYPE_BUFFER, "Buffer"},
+    {VK_OBJECT_TYPE_IMAGE, "Image"},
+    {VK_OBJECT_TYPE_EVENT, "Event"},
+    {VK_OBJECT_TYPE_QUERY_POOL, "QueryPool"},
+    {VK_OBJECT_TYPE_BUFFER_VIEW, "BufferView"},
+    {VK_OBJECT_TYPE_IMAGE_VIEW, "ImageView"},
+    {VK_OBJECT_TYPE_SHADER_MODULE, "ShaderModule"},
+    {VK_OBJECT_TYPE_PIPELINE_CACHE, "PipelineCache"},
+    {VK_OBJECT_TYPE_PIPELINE_LAYOUT, "PipelineLayout"},
+    {VK_OBJECT_TYPE_RENDER_PASS, "RenderPass"},
+    {VK_OBJECT_TYPE_PIPELINE, "Pipeline"},
+    {VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, "DescriptorSetLayout"},
+    {VK_OBJECT_TYPE_SAMPLER, "Sampler"},
+    {VK_OBJECT_TYPE_DESCRIPTOR_POOL, "DescriptorPool"},
+    {VK_OBJECT_TYPE_DESCRIPTOR_SET, "DescriptorSet"},
+    {VK_OBJECT_TYPE_FRAMEBUFFER, "Framebuffer"},
+    {VK_OBJECT_TYPE_COMMAND_POOL, "CommandPool"},
+    {VK_OBJECT_TYPE_SAMPLER_YCBCR_CONVERSION, "SamplerYcbcrConversion"},
+    {VK_OBJECT_TYPE_DESCRIPTOR_UPDATE_TEMPLATE, "DescriptorUpdateTemplate"},
+    {VK_OBJECT_TYPE_PRIVATE_DATA_SLOT, "PrivateDataSlot"},
+    {VK_OBJECT_TYPE_SURFACE_KHR, "SurfaceKHR"},
+    {VK_OBJECT_TYPE_SWAPCHAIN_KHR, "SwapchainKHR"},
+    {VK_OBJECT_TYPE_DISPLAY_KHR, "DisplayKHR"},
+    {VK_OBJECT_TYPE_DISPLAY_MODE_KHR, "DisplayModeKHR"},
+    {VK_OBJECT_TYPE_DEBUG_REPORT_CALLBACK_EXT, "DebugReportCallbackEXT"},
+    {VK_OBJECT_TYPE_DEBUG_UTILS_MESSENGER_EXT, "DebugUtilsMessengerEXT"},
+    {VK_OBJECT_TYPE_ACCELERATION_STRUCTURE_KHR, "AccelerationStructureKHR"},
+    {VK_OBJECT_TYPE_VALIDATION_CACHE_EXT, "ValidationCacheEXT"},
+    {VK_OBJECT_TYPE_DEFERRED_OPERATION_KHR, "DeferredOperationKHR"},
+    {VK_OBJECT_TYPE_SHADER_EXT, "ShaderEXT"},
+    {VK_OBJECT_TYPE_INDIRECT_COMMANDS_LAYOUT_EXT, "IndirectCommandsLayoutEXT"},
+    {VK_OBJECT_TYPE_INDIRECT_EXECUTION_SET_EXT, "IndirectExecutionSetEXT"},
+}};
+
+constexpr std::array<const char*, TrackingAllocator::SCOPE_COUNT> SCOPE_NAMES{
+    "command", "object", "cache", "device", "instance"};
+
+uint32_t ScopeIndex(VkSystemAllocationScope scope)
+{
+    const auto index = static_cast<uint32_t>(scope);
+    return index < TrackingAllocator::SCOPE_COUNT ? index : 0;
+}
+
+void UpdatePeak(std::atomic<uint64_t>& peak, uint64_t value)
+{
+    uint64_t current = peak.load(std::memory_order_relaxed);
+    while (current < value && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+std::byte* AlignUp(std::byte* pointer, size_t alignment)
+{
+    const auto address = reinterpret_cast<uintptr_t>(pointer);
+    return reinterpret_cast<std::byte*>((address + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1));
+}
+
+} // namespace
+
+// Sits right before every pointer handed to the driver
+struct TrackingAllocator::Header {
+    void* base{nullptr}; // Start of the heap block, null for arena allocations
+    size_t size{0};
+    Arena* arena{nullptr};
+    uint32_t slot{0};
+    uint32_t scope{0};
+};
+
+// Bump arena of one thread. Only the owning thread allocates and rewinds it; frees may
+// come from anywhere. The thread and every live block each hold a reference, so a block
+// freed after its thread exited still finds the arena, and the last release deletes it
+struct TrackingAllocator::Arena {
+    std::unique_ptr<std::byte[]> buffer;
+    size_t capacity{0};
+    size_t offset{0};
+    std::atomic<uint32_t> references{1};
+
+    // Only the owning thread's reference left, i.e. no live blocks
+    [[nodiscard]] bool Unused() const { return references.load(std::memory_order_acquire) == 1; }
+
+    static void Release(Arena* arena)
+    {
+        if (arena && arena->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete arena;
+        }
+    }
+};
+
+TrackingAllocator::TrackingAllocator(size_t command_arena_size)
+    : commandArenaSize_(command_arena_size)
+{
+    static_assert(SLOT_COUNT == SLOT_INFOS.size());
+    for (uint32_t i = 0; i < SLOT_COUNT; ++i) {
+        Slot& slot = slots_[i];
+        slot.owner = this;
+        slot.index = i;
+        slot.callbacks.pUserData = &slot;
+        slot.callbacks.pfnAllocation = &TrackingAllocator::AllocateCallback;
+        slot.callbacks.pfnReallocation = &TrackingAllocator::ReallocateCallback;
+        slot.callbacks.pfnFree = &TrackingAllocator::FreeCallback;
+        slot.callbacks.pfnInternalAllocation = &TrackingAllocator::InternalAllocationCallback;
+        slot.callbacks.pfnInternalFree = &TrackingAllocator::InternalFreeCallback;
+    }
+}
+
+const VkAllocationCallbacks* TrackingAllocator::GetCallbacks(VkObjectType object_type) const
+{
+    return &slots_[SlotIndex(object_type)].callbacks;
+}
+
+uint32_t TrackingAllocator::SlotIndex(VkObjectType object_type)
+{
+    if (static_cast<uint32_t>(object_type) < CORE_SLOT_COUNT) {
+        return static_cast<uint32_t>(object_type);
+    }
+    for (uint32_t i = CORE_SLOT_COUNT; i < SLOT_COUNT; ++i) {
+        if (SLOT_INFOS[i].type == object_type) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+VkObjectType TrackingAllocator::SlotObjectType(uint32_t index)
+{
+    return index < SLOT_COUNT ? SLOT_INFOS[index].type : VK_OBJECT_TYPE_UNKNOWN;
+}
+
+void* TrackingAllocator::Allocate(uint32_t slot, size_t size, size_t alignment, VkSystemAllocationScope scope)
+{
+    if (size == 0) {
+        return nullptr;
+    }
+    alignment = std::max(alignment, alignof(Header));
+
+    std::byte* user = nullptr;
+    Header header{};
+    header.size = size;
+    header.slot = slot;
+    header.scope = ScopeIndex(scope);
+
+    if (commandArenaSize_ > 0 && scope == VK_SYSTEM_ALLOCATION_SCOPE_COMMAND) {
+        // Drops the thread's reference on exit; blocks still live keep the arena
+        struct ThreadArena {
+            Arena* arena{nullptr};
+            ~ThreadArena() { Arena::Release(arena); }
+        };
+        thread_local ThreadArena thread_arena;
+        if (!thread_arena.arena || (thread_arena.arena->capacity < commandArenaSize_ && thread_arena.arena->Unused())) {
+            auto arena = std::make_unique<Arena>();
+            arena->buffer.reset(new (std::nothrow) std::byte[commandArenaSize_]);
+            arena->capacity = arena->buffer ? commandArenaSize_ : 0;
+            Arena::Release(thread_arena.arena);
+            thread_arena.arena = arena.release();
+        }
+
+        Arena& arena = *thread_arena.arena;
+        // Everything handed out since the last rewind is back, start over
+        if (arena.Unused()) {
+            arena.offset = 0;
+        }
+        if (arena.buffer) {
+            std::byte* begin = arena.buffer.get();
+            const auto start = static_cast<size_t>(AlignUp(begin + arena.offset + sizeof(Header), alignment) - begin);
+            if (start <= arena.capacity && size <= arena.capacity - start) {
+                arena.offset = start + size;
+                arena.references.fetch_add(1, std::memory_order_relaxed);
+                header.arena = &arena;
+                user = begin + start;
+                arenaAllocations_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    if (!user) {
+        auto* base = static_cast<std::byte*>(std::malloc(sizeof(Header) + alignment - 1 + size));
+        if (!base) {
+            return nullptr;
+        }
+        header.base = base;
+        user = AlignUp(base + sizeof(Header), alignment);
+    }
+
+    std::memcpy(user - sizeof(Header), &header, sizeof(Header));
+    Track(slot, scope, static_cast<int64_t>(size));
+    return user;
+}
+
+void* TrackingAllocator::Reallocate(uint32_t slot, void* original, size_t size, size_t alignment, VkSystemAllocationScope scope)
+{
+    if (!original) {
+        return Allocate(slot, size, alignment, scope);
+    }
+    if (size == 0) {
+        Free(original);
+        return nullptr;
+    }
+
+    Header header{};
+    std::memcpy(&header, static_cast<std::byte*>(original) - sizeof(Header), sizeof(Header));
+    void* memory = Allocate(slot, size, alignment, scope);
+    if (!memory) {
+        return nullptr; // The original allocation stays valid
+    }
+    std::memcpy(memory, original, std::min(size, header.size));
+    Free(original);
+    return memory;
+}
+
+void TrackingAllocator::Free(void* memory)
+{
+    if (!memory) {
+        return;
+    }
+    Header header{};
+    std::memcpy(&header, static_cast<std::byte*>(memory) - sizeof(Header), sizeof(Header));
+    Track(header.slot, static_cast<VkSystemAllocationScope>(header.scope), -static_cast<int64_t>(header.size));
+    if (header.arena) {
+        Arena::Release(header.arena);
+    } else {
+        std::free(header.base);
+    }
+}
+
+void TrackingAllocator::Track(uint32_t slot, VkSystemAllocationScope scope, int64_t bytes)
+{
+    auto update = [bytes](Counter& counter) {
+        if (bytes > 0) {
+            const uint64_t live = counter.liveBytes.fetch_add(static_cast<uint64_t>(bytes), std::memory_order_relaxed)
+                                  + static_cast<uint64_t>(bytes);
+            UpdatePeak(counter.peakBytes, live);
+            counter.allocationCount.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            counter.liveBytes.fetch_sub(static_cast<uint64_t>(-bytes), std::memory_order_relaxed);
+        }
+    };
+    update(typeCounters_[slot]);
+    update(total_);
+    if (bytes > 0) {
+        scopeBytes_[ScopeIndex(scope)].fetch_add(static_cast<uint64_t>(bytes), std::memory_order_relaxed);
+    } else {
+        scopeBytes_[ScopeIndex(scope)].fetch_sub(static_cast<uint64_t>(-bytes), std::memory_order_relaxed);
+    }
+}
+
+TrackingAllocator::Stats TrackingAllocator::GetStats() const
+{
+    Stats stats{};
+    stats.liveBytes = total_.liveBytes.load(std::memory_order_relaxed);
+    stats.peakBytes = total_.peakBytes.load(std::memory_order_relaxed);
+    stats.allocationCount = total_.allocationCount.load(std::memory_order_relaxed);
+    stats.internalBytes = total_.internalBytes.load(std::memory_order_relaxed);
+    stats.arenaAllocationCount = arenaAllocations_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < SCOPE_COUNT; ++i) {
+        stats.liveBytesByScope[i] = scopeBytes_[i].load(std::memory_order_relaxed);
+    }
+
+    for (uint32_t i = 0; i < SLOT_COUNT; ++i) {
+        const Counter& counter = typeCounters_[i];
+        TypeStats type{};
+        type.objectType = SlotObjectType(i);
+        type.liveBytes = counter.liveBytes.load(std::memory_order_relaxed);
+        type.peakBytes = counter.peakBytes.load(std::memory_order_relaxed);
+        type.allocationCount = counter.allocationCount.load(std::memory_order_relaxed);
+        type.internalBytes = counter.internalBytes.load(std::memory_order_relaxed);
+        if (type.allocationCount > 0 || type.internalBytes > 0) {
+            stats.types.push_back(type);
+        }
+    }
+    std::sort(stats.types.begin(), stats.types.end(),
+              [](const TypeStats& a, const TypeStats& b) { return a.liveBytes > b.liveBytes; });
+    return stats;
+}
+
+void TrackingAllocator::WriteReport(std::ostream& out) const
+{
+    const Stats stats = GetStats();
+    out << "Host allocations: " << stats.liveBytes << " bytes live, " << stats.peakBytes << " bytes peak, "
+        << stats.allocationCount << " allocations (" << stats.arenaAllocationCount << " from command arenas), "
+        << stats.internalBytes << " bytes driver-internal\n";
+    out << "  live by scope:";
+    for (size_t i = 0; i < SCOPE_COUNT; ++i) {
+        out << ' ' << SCOPE_NAMES[i] << '=' << stats.liveBytesByScope[i];
+    }
+    out << '\n';
+
+    out << "  " << std::left << std::setw(28) << "object type" << std::right
+        << std::setw(14) << "live" << std::setw(14) << "peak" << std::setw(12) << "allocs" << std::setw(14) << "internal" << '\n';
+    for (const TypeStats& type : stats.types) {
+        out << "  " << std::left << std::setw(28) << SLOT_INFOS[SlotIndex(type.objectType)].name << std::right
+            << std::setw(14) << type.liveBytes << std::setw(14) << type.peakBytes
+            << std::setw(12) << type.allocationCount << std::setw(14) << type.internalBytes << '\n';
+    }
+}
+
+VKAPI_ATTR void* VKAPI_CALL TrackingAllocator::AllocateCallback(void* user_data, size_t size, size_t alignment,
+                                                                VkSystemAllocationScope scope)
+{
+    auto* slot = static_cast<Slot*>(user_data);
+    return slot->owner->Allocate(slot->index, size, alignment, scope);
+}
+
+VKAPI_ATTR void* VKAPI_CALL TrackingAllocator::ReallocateCallback(void* user_data, void* original, size_t size, size_t alignment,
+                                                                  VkSystemAllocationScope scope)
+{
+    auto* slot = static_cast<Slot*>(user_data);
+    return slot->owner->Reallocate(slot->index, original, size, alignment, scope);
+}
+
+VKAPI_ATTR void VKAPI_CALL TrackingAllocator::FreeCallback(void* user_data, void* memory)
+{
+    static_cast<Slot*>(user_data)->owner->Free(memory);
+}
+
+VKAPI_ATTR void VKAPI_CALL TrackingAllocator::InternalAllocationCallback(void* user_data, size_t size, VkInternalAllocationType,
+                                                                         VkSystemAllocationScope)
+{
+    auto* slot = static_cast<Slot*>(user_data);
+    slot->owner->typeCounters_[slot->index].internalBytes.fetch_add(size, std::memory_order_relaxed);
+    slot->owner->total_.internalBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+VKAPI_ATTR void VKAPI_CALL TrackingAllocator::InternalFreeCallback(void* user_data, size_t size, VkInternalAllocationType,
+                                                                   VkSystemAllocationScope)
+{
+    auto* slot = static_cast<Slot*>(user_data);
+    slot->owner->typeCounters_[slot->index].internalBytes.fetch_sub(size, std::memory_order_relaxed);
+    slot->owner->total_.internalBytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+} // namespace VulkanEngine::RAII::Utils
@@ -0,0 +1,136 @@
+#ifndef VULKAN_RAII_UTILS_HOST_ALLOCATOR_HPP
+#define VULKAN_RAII_UTILS_HOST_ALLOCATOR_HPP
+
+#include <volk.h>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace VulkanEngine::RAII::Utils {
+
+// Source of the VkAllocationCallbacks the wrapper passes as pAllocator. The object type
+// lets a policy tell driver host memory apart per kind of object; it must return the
+// same callbacks for a type every time, since Vulkan requires destruction to use
+// callbacks compatible with those of the creation
+class HostAllocationPolicy {
+public:
+    virtual ~HostAllocationPolicy() = default;
+    [[nodiscard]] virtual const VkAllocationCallbacks* GetCallbacks(VkObjectType object_type) const = 0;
+};
+
+// Process-wide host allocation policy used by every vkCreate*/vkDestroy* of the wrapper,
+// VMA and the SDL surface. Without a policy (the default) the driver uses its own
+// allocator. Install it before creating the Instance and keep it, unchanged and alive,
+// until the last object is destroyed
+class HostAllocator {
+public:
+    static void SetPolicy(const HostAllocationPolicy* policy) noexcept { policy_.store(policy, std::memory_order_release); }
+    [[nodiscard]] static const HostAllocationPolicy* GetPolicy() noexcept { return policy_.load(std::memory_order_acquire); }
+
+    // pAllocator for an object of object_type; null without a policy
+    [[nodiscard]] static const VkAllocationCallbacks* For(VkObjectType object_type) noexcept
+    {
+        const HostAllocationPolicy* policy = GetPolicy();
+        return policy ? policy->GetCallbacks(object_type) : nullptr;
+    }
+
+private:
+    static inline std::atomic<const HostAllocationPolicy*> policy_{nullptr};
+};
+
+// Policy that forwards to the C heap and counts live and peak bytes per object type and
+// allocation scope, including the driver's internal allocations it reports. With a
+// command arena, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND allocations (freed before the
+// vkCreate* call returns, e.g. copies of create infos during pipeline compilation)
+// come from a bump arena owned by the calling thread, which keeps parallel pipeline
+// creation off the global malloc lock; they fall back to the heap once it is full
+class TrackingAllocator : public HostAllocationPolicy {
+public:
+    static constexpr size_t SCOPE_COUNT = 5; // VK_SYSTEM_ALLOCATION_SCOPE_COMMAND .. INSTANCE
+
+    struct TypeStats {
+        VkObjectType objectType{VK_OBJECT_TYPE_UNKNOWN};
+        uint64_t liveBytes{0};
+        uint64_t peakBytes{0};
+        uint64_t allocationCount{0}; // Allocations and reallocations since construction
+        uint64_t internalBytes{0}; // Live driver-internal (executable) memory it reported
+    };
+
+    struct Stats {
+        uint64_t liveBytes{0};
+        uint64_t peakBytes{0};
+        uint64_t allocationCount{0};
+        uint64_t internalBytes{0};
+        uint64_t arenaAllocationCount{0}; // Served by a command arena
+        std::array<uint64_t, SCOPE_COUNT> liveBytesByScope{};
+        std::vector<TypeStats> types; // Types with any allocation, largest live first
+    };
+
+    // command_arena_size 0 disables the arenas; otherwise each thread allocating
+    // command-scope memory keeps one buffer of this size
+    explicit TrackingAllocator(size_t command_arena_size = 0);
+
+    // Delete copy and move. the callbacks handed to the driver point at this instance.
+    TrackingAllocator(const TrackingAllocator&) = delete;
+    TrackingAllocator& operator=(const TrackingAllocator&) = delete;
+    TrackingAllocator(TrackingAllocator&&) = delete;
+    TrackingAllocator& operator=(TrackingAllocator&&) = delete;
+
+    [[nodiscard]] const VkAllocationCallbacks* GetCallbacks(VkObjectType object_type) const override;
+
+    [[nodiscard]] Stats GetStats() const;
+
+    // Human-readable table of GetStats()
+    void WriteReport(std::ostream& out) const;
+
+private:
+    struct Header;
+    struct Arena;
+
+    struct Counter {
+        std::atomic<uint64_t> liveBytes{0};
+        std::atomic<uint64_t> peakBytes{0};
+        std::atomic<uint64_t> allocationCount{0};
+        std::atomic<uint64_t> internalBytes{0};
+    };
+
+    // pUserData of one slot's callbacks
+    struct Slot {
+        TrackingAllocator* owner{nullptr};
+        uint32_t index{0};
+        VkAllocationCallbacks callbacks{};
+    };
+
+    static constexpr uint32_t SLOT_COUNT = 41; // Core types, then those listed in SlotObjectType
+
+    size_t commandArenaSize_;
+    std::array<Slot, SLOT_COUNT> slots_{};
+    std::array<Counter, SLOT_COUNT> typeCounters_{};
+    std::array<std::atomic<uint64_t>, SCOPE_COUNT> scopeBytes_{};
+    Counter total_{};
+    std::atomic<uint64_t> arenaAllocations_{0};
+
+    static uint32_t SlotIndex(VkObjectType object_type);
+    static VkObjectType SlotObjectType(uint32_t index);
+
+    void* Allocate(uint32_t slot, size_t size, size_t alignment, VkSystemAllocationScope scope);
+    void* Reallocate(uint32_t slot, void* original, size_t size, size_t alignment, VkSystemAllocationScope scope);
+    void Free(void* memory);
+    void Track(uint32_t slot, VkSystemAllocationScope scope, int64_t bytes);
+
+    static VKAPI_ATTR void* VKAPI_CALL AllocateCallback(void* user_data, size_t size, size_t alignment, VkSystemAllocationScope scope);
+    static VKAPI_ATTR void* VKAPI_CALL ReallocateCallback(void* user_data, void* original, size_t size, size_t alignment,
+                                                          VkSystemAllocationScope scope);
+    static VKAPI_ATTR void VKAPI_CALL FreeCallback(void* user_data, void* memory);
+    static VKAPI_ATTR void VKAPI_CALL InternalAllocationCallback(void* user_data, size_t size, VkInternalAllocationType type,
+                                                                 VkSystemAllocationScope scope);
+    static VKAPI_ATTR void VKAPI_CALL InternalFreeCallback(void* user_data, size_t size, VkInternalAllocationType type,
+                                                           VkSystemAllocationScope scope);
+};
+
+} // namespace VulkanEngine::RAII::Utils
+
+#endif // VULKAN_RAII_UTILS_HOST_ALLOCATOR_HPP
@@ -88,6 +88,13 @@ public:
     // Get access flags for image layout
     static VkAccessFlags GetLayoutAccessFlags(VkImageLayout layout);
 
+    // Synchronization2 stage flags for image layout; narrower than the legacy mapping
+    // (COPY instead of TRANSFER, NONE as the source of UNDEFINED)
+    static VkPipelineStageFlags2KHR GetLayoutPipelineStageFlags2(VkImageLayout layout, bool is_source);
+
+    // Synchronization2 access flags for image layout
+    static VkAccessFlags2KHR GetLayoutAccessFlags2(VkImageLayout layout);
+
     // Record a layout transition barrier on a command buffer using sensible src/dst stages
     static void CmdTransitionImageLayout(VkCommandBuffer cmd,
                                             VkImage image,
@@ -0,0 +1,120 @@
+#include "LatencyTracker.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+
+namespace VulkanEngine::RAII::Utils {
+
+namespace {
+
+using Marker = LatencyTracker::Marker;
+
+template <typename Record>
+void Accumulate(LatencyTracker::Metric& metric, const Record& record, Marker from, Marker to)
+{
+    if (!record.Has(from) || !record.Has(to)) {
+        return;
+    }
+    const std::chrono::duration<double, std::milli> latency =
+        record.times[static_cast<size_t>(to)] - record.times[static_cast<size_t>(from)];
+    metric.samples++;
+    metric.averageMs += latency.count(); // Sum until GetStats divides
+    metric.maxMs = metric.samples == 1 ? latency.count() : std::max(metric.maxMs, latency.count());
+}
+
+void Finish(LatencyTracker::Metric& metric)
+{
+    if (metric.samples > 0) {
+        metric.averageMs /= metric.samples;
+    }
+}
+
+} // namespace
+
+LatencyTracker::LatencyTracker(uint32_t sample_count)
+    : sampleCount_(std::max(1U, sample_count)) {}
+
+void LatencyTracker::Mark(uint64_t frame_id, Marker marker, Clock::time_point time)
+{
+    if (marker == Marker::COUNT) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (frame_id <= lastCompletedFrame_ && completedFrameCount_ > 0) {
+        return;
+    }
+
+    auto it = std::lower_bound(pending_.begin(), pending_.end(), frame_id,
+                               [](const FrameRecord& record, uint64_t id) { return record.frameId < id; });
+    if (it == pending_.end() || it->frameId != frame_id) {
+        FrameRecord record;
+        record.frameId = frame_id;
+        it = pending_.insert(it, record);
+    }
+    it->times[static_cast<size_t>(marker)] = time;
+    it->markedMask |= 1U << static_cast<uint32_t>(marker);
+
+    if (marker == Marker::DISPLAY) {
+        // Presents complete in order: everything older without a display time was skipped
+        while (!pending_.empty() && pending_.front().frameId <= frame_id) {
+            Complete(pending_.front());
+            pending_.pop_front();
+        }
+        return;
+    }
+    const uint64_t newest = pending_.back().frameId;
+    while (!pending_.empty() && pending_.front().frameId + MAX_PENDING_FRAMES < newest) {
+        Complete(pending_.front());
+        pending_.pop_front();
+    }
+}
+
+LatencyTracker::Stats LatencyTracker::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats{};
+    for (const FrameRecord& record : completed_) {
+        Accumulate(stats.inputToSubmit, record, Marker::INPUT_SAMPLED, Marker::RENDER_SUBMIT);
+        Accumulate(stats.simulationToSubmit, record, Marker::SIMULATION_START, Marker::RENDER_SUBMIT);
+        Accumulate(stats.submitToPresent, record, Marker::RENDER_SUBMIT, Marker::PRESENT);
+        Accumulate(stats.inputToPresent, record, Marker::INPUT_SAMPLED, Marker::PRESENT);
+        Accumulate(stats.presentToDisplay, record, Marker::PRESENT, Marker::DISPLAY);
+        Accumulate(stats.inputToDisplay, record, Marker::INPUT_SAMPLED, Marker::DISPLAY);
+    }
+    Finish(stats.inputToSubmit);
+    Finish(stats.simulationToSubmit);
+    Finish(stats.submitToPresent);
+    Finish(stats.inputToPresent);
+    Finish(stats.presentToDisplay);
+    Finish(stats.inputToDisplay);
+    return stats;
+}
+
+uint64_t LatencyTracker::GetCompletedFrameCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return completedFrameCount_;
+}
+
+void LatencyTracker::Reset()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.clear();
+    completed_.clear();
+    lastCompletedFrame_ = 0;
+    completedFrameCount_ = 0;
+}
+
+void LatencyTracker::Complete(const FrameRecord& record)
+{
+    completed_.push_back(record);
+    if (completed_.size() > sampleCount_) {
+        completed_.pop_front();
+    }
+    lastCompletedFrame_ = record.frameId;
+    completedFrameCount_++;
+}
+
+} // namespace VulkanEngine::RAII::Utils
@@ -0,0 +1,93 @@
+#ifndef VULKAN_RAII_UTILS_LATENCY_TRACKER_HPP
+#define VULKAN_RAII_UTILS_LATENCY_TRACKER_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+namespace VulkanEngine::RAII::Utils {
+
+// Per-frame latency markers, keyed by frame id (Renderer::GetFrameTimelineValue()).
+// The application stamps when input was sampled and the simulation started, the
+// Renderer stamps submission, present and, where a display time source exists
+// (VK_GOOGLE_display_timing, or VK_KHR_present_wait as an upper bound), display. A
+// frame counts towards the stats once it is displayed, or once it falls
+// MAX_PENDING_FRAMES behind the newest marked frame without a display time.
+// Safe to mark from several threads.
+class LatencyTracker {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Marker : uint32_t {
+        INPUT_SAMPLED,
+        SIMULATION_START,
+        RENDER_SUBMIT,
+        PRESENT,
+        DISPLAY,
+        COUNT
+    };
+
+    // Average and worst latency between two markers over the sample window
+    struct Metric {
+        double averageMs{0.0};
+        double maxMs{0.0};
+        uint32_t samples{0}; // Frames in the window that carried both markers
+    };
+
+    struct Stats {
+        Metric inputToSubmit;
+        Metric simulationToSubmit;
+        Metric submitToPresent;
+        Metric inputToPresent;
+        Metric presentToDisplay;
+        Metric inputToDisplay; // End to end; empty without a display time source
+    };
+
+    static constexpr uint64_t MAX_PENDING_FRAMES = 16;
+
+    // sample_count completed frames are kept for the stats
+    explicit LatencyTracker(uint32_t sample_count = 120);
+
+    // Delete copy and move. markers come in from the main and render threads through the same instance.
+    LatencyTracker(const LatencyTracker&) = delete;
+    LatencyTracker& operator=(const LatencyTracker&) = delete;
+    LatencyTracker(LatencyTracker&&) = delete;
+    LatencyTracker& operator=(LatencyTracker&&) = delete;
+
+    // Stamp marker for frame_id; marking again overwrites. Markers for frames that
+    // already completed are dropped
+    void Mark(uint64_t frame_id, Marker marker, Clock::time_point time = Clock::now());
+
+    // Stats over the completed frames in the window
+    [[nodiscard]] Stats GetStats() const;
+
+    [[nodiscard]] uint32_t GetSampleCount() const { return sampleCount_; }
+    [[nodiscard]] uint64_t GetCompletedFrameCount() const;
+
+    // Drop pending and completed frames
+    void Reset();
+
+private:
+    struct FrameRecord {
+        uint64_t frameId{0};
+        std::array<Clock::time_point, static_cast<size_t>(Marker::COUNT)> times{};
+        uint32_t markedMask{0};
+
+        [[nodiscard]] bool Has(Marker marker) const { return (markedMask & (1U << static_cast<uint32_t>(marker))) != 0; }
+    };
+
+    uint32_t sampleCount_;
+    mutable std::mutex mutex_;
+    std::deque<FrameRecord> pending_; // Ordered by frame id
+    std::deque<FrameRecord> completed_; // Oldest first, at most sampleCount_
+    uint64_t lastCompletedFrame_{0};
+    uint64_t completedFrameCount_{0};
+
+    void Complete(const FrameRecord& record);
+};
+
+} // namespace VulkanEngine::RAII::Utils
+
+#endif // VULKAN_RAII_UTILS_LATENCY_TRACKER_HPP
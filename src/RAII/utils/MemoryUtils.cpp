@@ -1,6 +1,7 @@
 #include "MemoryUtils.hpp"
 
 #include <algorithm>
+#include <bit>
 #include <cstdint>
 #include <optional>
 #include <stdexcept>
@@ -47,8 +48,63 @@ std::optional<uint32_t> TryFindMemoryType(VkPhysicalDevice physical_device,
     return std::nullopt;
 }
 
+// Same fallback order as above: required | preferred, then required alone
+std::optional<uint32_t> TryFindMemoryType(const MemoryTypeTable& table,
+                                          uint32_t type_filter,
+                                          VkMemoryPropertyFlags required,
+                                          VkMemoryPropertyFlags preferred) {
+    if (auto index = table.Find(type_filter, required | preferred)) {
+        return index;
+    }
+    return table.Find(type_filter, required);
+}
+
 } // namespace
 
+MemoryTypeTable::MemoryTypeTable(const VkPhysicalDeviceMemoryProperties& memory_properties)
+    : typeCount_(std::min(memory_properties.memoryTypeCount, static_cast<uint32_t>(VK_MAX_MEMORY_TYPES))) {
+    for (uint32_t i = 0; i < typeCount_; ++i) {
+        typeFlags_[i] = memory_properties.memoryTypes[i].propertyFlags;
+    }
+    for (uint32_t flags = 0; flags < matchingTypes_.size(); ++flags) {
+        uint32_t matching = 0;
+        for (uint32_t i = 0; i < typeCount_; ++i) {
+            if ((typeFlags_[i] & flags) == flags) {
+                matching |= 1u << i;
+            }
+        }
+        matchingTypes_[flags] = matching;
+    }
+}
+
+uint32_t MemoryTypeTable::GetMatchingTypes(VkMemoryPropertyFlags properties) const {
+    if (properties < matchingTypes_.size()) {
+        return matchingTypes_[properties];
+    }
+    uint32_t matching = 0;
+    for (uint32_t i = 0; i < typeCount_; ++i) {
+        if ((typeFlags_[i] & properties) == properties) {
+            matching |= 1u << i;
+        }
+    }
+    return matching;
+}
+
+std::optional<uint32_t> MemoryTypeTable::Find(uint32_t type_filter, VkMemoryPropertyFlags properties) const {
+    const uint32_t candidates = type_filter & GetMatchingTypes(properties);
+    if (candidates == 0) {
+        return std::nullopt;
+    }
+    return static_cast<uint32_t>(std::countr_zero(candidates));
+}
+
+VkMemoryPropertyFlags MemoryTypeTable::GetFlags(uint32_t memory_type_index) const {
+    if (memory_type_index >= typeCount_) {
+        throw std::out_of_range("Memory type index out of range");
+    }
+    return typeFlags_[memory_type_index];
+}
+
 uint32_t MemoryUtils::FindMemoryType(VkPhysicalDevice physical_device,
                                      uint32_t type_filter,
                                      VkMemoryPropertyFlags properties) {
@@ -58,6 +114,15 @@ uint32_t MemoryUtils::FindMemoryType(VkPhysicalDevice physical_device,
     throw std::runtime_error("Failed to find suitable memory type");
 }
 
+uint32_t MemoryUtils::FindMemoryType(const MemoryTypeTable& table,
+                                     uint32_t type_filter,
+                                     VkMemoryPropertyFlags properties) {
+    if (auto index = table.Find(type_filter, properties)) {
+        return *index;
+    }
+    throw std::runtime_error("Failed to find suitable memory type");
+}
+
 bool MemoryUtils::GetMemoryBudget(VkPhysicalDevice physical_device,
                                   std::vector<VkDeviceSize>& heap_budgets,
                                   std::vector<VkDeviceSize>& heap_usages) {
@@ -108,6 +173,10 @@ VkMemoryPropertyFlags MemoryUtils::GetMemoryTypeProperties(VkPhysicalDevice phys
     return mem_properties.memoryTypes[memory_type_index].propertyFlags;
 }
 
+VkMemoryPropertyFlags MemoryUtils::GetMemoryTypeProperties(const MemoryTypeTable& table, uint32_t memory_type_index) {
+    return table.GetFlags(memory_type_index);
+}
+
 bool MemoryUtils::IsMemoryTypeHostVisible(VkPhysicalDevice physical_device, uint32_t memory_type_index) {
     VkMemoryPropertyFlags flags = GetMemoryTypeProperties(physical_device, memory_type_index);
     return (flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
@@ -123,6 +192,18 @@ bool MemoryUtils::IsMemoryTypeHostCoherent(VkPhysicalDevice physical_device, uin
     return (flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
 }
 
+bool MemoryUtils::IsMemoryTypeHostVisible(const MemoryTypeTable& table, uint32_t memory_type_index) {
+    return (table.GetFlags(memory_type_index) & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+}
+
+bool MemoryUtils::IsMemoryTypeDeviceLocal(const MemoryTypeTable& table, uint32_t memory_type_index) {
+    return (table.GetFlags(memory_type_index) & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) != 0;
+}
+
+bool MemoryUtils::IsMemoryTypeHostCoherent(const MemoryTypeTable& table, uint32_t memory_type_index) {
+    return (table.GetFlags(memory_type_index) & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+}
+
 uint32_t MemoryUtils::GetOptimalBufferMemoryType(VkPhysicalDevice physical_device,
                                                  VkDevice device,
                                                  VkBuffer buffer,
@@ -141,6 +222,21 @@ uint32_t MemoryUtils::GetOptimalBufferMemoryType(VkPhysicalDevice physical_devic
     throw std::runtime_error("Failed to find suitable memory type for buffer");
 }
 
+uint32_t MemoryUtils::GetOptimalBufferMemoryType(const MemoryTypeTable& table,
+                                                 VkDevice device,
+                                                 VkBuffer buffer,
+                                                 VkMemoryPropertyFlags preferred_properties,
+                                                 VkMemoryPropertyFlags required_properties) {
+    VkMemoryRequirements requirements{};
+    vkGetBufferMemoryRequirements(device, buffer, &requirements);
+
+    if (auto index = TryFindMemoryType(table, requirements.memoryTypeBits, required_properties, preferred_properties)) {
+        return *index;
+    }
+
+    throw std::runtime_error("Failed to find suitable memory type for buffer");
+}
+
 uint32_t MemoryUtils::GetOptimalImageMemoryType(VkPhysicalDevice physical_device,
                                                 VkDevice device,
                                                 VkImage image,
@@ -159,6 +255,21 @@ uint32_t MemoryUtils::GetOptimalImageMemoryType(VkPhysicalDevice physical_device
     throw std::runtime_error("Failed to find suitable memory type for image");
 }
 
+uint32_t MemoryUtils::GetOptimalImageMemoryType(const MemoryTypeTable& table,
+                                                VkDevice device,
+                                                VkImage image,
+                                                VkMemoryPropertyFlags preferred_properties,
+                                                VkMemoryPropertyFlags required_properties) {
+    VkMemoryRequirements requirements{};
+    vkGetImageMemoryRequirements(device, image, &requirements);
+
+    if (auto index = TryFindMemoryType(table, requirements.memoryTypeBits, required_properties, preferred_properties)) {
+        return *index;
+    }
+
+    throw std::runtime_error("Failed to find suitable memory type for image");
+}
+
 VkDeviceSize MemoryUtils::CalculateAlignedBufferSize(VkDeviceSize size, VkDeviceSize min_alignment) {
     return AlignedSize(size, min_alignment);
 }
@@ -2,13 +2,45 @@
 #define VULKAN_RAII_UTILS_MEMORY_UTILS_HPP
 
 #include <volk.h>
+#include <array>
+#include <cstdint>
+#include <optional>
 #include <vector>
 
 
 
 namespace VulkanEngine::RAII::Utils {
 
-// Memory utilities
+// Memory types of a device indexed by property flags, precomputed from its
+// VkPhysicalDeviceMemoryProperties (PhysicalDevice builds one at construction), so a
+// lookup is a table read and a bit scan instead of a driver query and a loop
+class MemoryTypeTable {
+public:
+    MemoryTypeTable() = default;
+    explicit MemoryTypeTable(const VkPhysicalDeviceMemoryProperties& memory_properties);
+
+    // Bit i is set when memory type i has every flag in properties
+    [[nodiscard]] uint32_t GetMatchingTypes(VkMemoryPropertyFlags properties) const;
+
+    // Lowest memory type in type_filter that has every flag in properties
+    [[nodiscard]] std::optional<uint32_t> Find(uint32_t type_filter, VkMemoryPropertyFlags properties) const;
+
+    // Throws std::out_of_range for an index past GetTypeCount()
+    [[nodiscard]] VkMemoryPropertyFlags GetFlags(uint32_t memory_type_index) const;
+
+    [[nodiscard]] uint32_t GetTypeCount() const { return typeCount_; }
+
+private:
+    // VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT .. VK_MEMORY_PROPERTY_RDMA_CAPABLE_BIT_NV; rarer bits are matched by a scan
+    static constexpr uint32_t INDEXED_FLAG_BITS = 9;
+
+    std::array<uint32_t, 1u << INDEXED_FLAG_BITS> matchingTypes_{};
+    std::array<VkMemoryPropertyFlags, VK_MAX_MEMORY_TYPES> typeFlags_{};
+    uint32_t typeCount_{0};
+};
+
+// Memory utilities. The VkPhysicalDevice overloads query the driver on every call; hot
+// paths use the MemoryTypeTable overloads (PhysicalDevice::GetMemoryTypeTable)
 class MemoryUtils {
 public:
     // Find suitable memory type for given requirements
@@ -16,6 +48,10 @@ public:
                                   uint32_t type_filter,
                                   VkMemoryPropertyFlags properties);
 
+    static uint32_t FindMemoryType(const MemoryTypeTable& table,
+                                  uint32_t type_filter,
+                                  VkMemoryPropertyFlags properties);
+
     // Get memory budget information (if available)
     static bool GetMemoryBudget(VkPhysicalDevice physical_device,
                                std::vector<VkDeviceSize>& heap_budgets,
@@ -28,14 +64,19 @@ public:
     static VkMemoryPropertyFlags GetMemoryTypeProperties(VkPhysicalDevice physical_device,
                                                          uint32_t memory_type_index);
 
+    static VkMemoryPropertyFlags GetMemoryTypeProperties(const MemoryTypeTable& table, uint32_t memory_type_index);
+
     // Check if memory type is host visible
     static bool IsMemoryTypeHostVisible(VkPhysicalDevice physical_device, uint32_t memory_type_index);
+    static bool IsMemoryTypeHostVisible(const MemoryTypeTable& table, uint32_t memory_type_index);
 
     // Check if memory type is device local
     static bool IsMemoryTypeDeviceLocal(VkPhysicalDevice physical_device, uint32_t memory_type_index);
+    static bool IsMemoryTypeDeviceLocal(const MemoryTypeTable& table, uint32_t memory_type_index);
 
     // Check if memory type is host coherent
     static bool IsMemoryTypeHostCoherent(VkPhysicalDevice physical_device, uint32_t memory_type_index);
+    static bool IsMemoryTypeHostCoherent(const MemoryTypeTable& table, uint32_t memory_type_index);
 
     // Get optimal memory type for buffer
     static uint32_t GetOptimalBufferMemoryType(VkPhysicalDevice physical_device,
@@ -43,6 +84,11 @@ public:
                                               VkBuffer buffer,
                                               VkMemoryPropertyFlags preferred_properties,
                                               VkMemoryPropertyFlags required_properties = 0);
+    static uint32_t GetOptimalBufferMemoryType(const MemoryTypeTable& table,
+                                              VkDevice device,
+                                              VkBuffer buffer,
+                                              VkMemoryPropertyFlags preferred_properties,
+                                              VkMemoryPropertyFlags required_properties = 0);
 
     // Get optimal memory type for image
     static uint32_t GetOptimalImageMemoryType(VkPhysicalDevice physical_device,
@@ -50,6 +96,11 @@ public:
                                              VkImage image,
                                              VkMemoryPropertyFlags preferred_properties,
                                              VkMemoryPropertyFlags required_properties = 0);
+    static uint32_t GetOptimalImageMemoryType(const MemoryTypeTable& table,
+                                             VkDevice device,
+                                             VkImage image,
+                                             VkMemoryPropertyFlags preferred_properties,
+                                             VkMemoryPropertyFlags required_properties = 0);
 
     // Calculate buffer size with alignment
     static VkDeviceSize CalculateAlignedBufferSize(VkDeviceSize size, VkDeviceSize min_alignment);
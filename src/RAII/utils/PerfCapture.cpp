@@ -0,0 +1,90 @@
+#include "PerfCapture.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <ostream>
+#include <utility>
+
+
+namespace VulkanEngine::RAII::Utils {
+
+PerfCapture::PerfCapture(std::string path, uint32_t frame_count, Format format)
+    : path_(std::move(path)),
+    frameCount_(std::max(1U, frame_count)),
+    format_(format)
+{
+    frames_.reserve(frameCount_);
+}
+
+bool PerfCapture::Record(const Frame& frame)
+{
+    if (!IsComplete()) {
+        frames_.push_back(frame);
+    }
+    return IsComplete();
+}
+
+void PerfCapture::Write(std::ostream& out) const
+{
+    if (format_ == Format::JSON) {
+        WriteJson(out);
+    } else {
+        WriteCsv(out);
+    }
+}
+
+bool PerfCapture::Save() const
+{
+    std::ofstream file(path_, std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    Write(file);
+    return static_cast<bool>(file);
+}
+
+PerfCapture::Format PerfCapture::FormatFromPath(std::string_view path)
+{
+    constexpr std::string_view JSON_EXTENSION = ".json";
+    const bool json = path.size() >= JSON_EXTENSION.size() &&
+                      path.substr(path.size() - JSON_EXTENSION.size()) == JSON_EXTENSION;
+    return json ? Format::JSON : Format::CSV;
+}
+
+void PerfCapture::WriteCsv(std::ostream& out) const
+{
+    out << "frame,frame_ms,cpu_ms,gpu_ms,draws,dispatches,pipeline_binds,descriptor_updates,bytes_uploaded,submits,"
+           "vma_usage_bytes,vma_budget_bytes\n";
+    for (const Frame& frame : frames_) {
+        const PerfCounters::Snapshot& counters = frame.counters;
+        out << frame.frameIndex << ',' << frame.frameMs << ',' << frame.cpuMs << ',' << frame.gpuMs << ','
+            << counters.draws << ',' << counters.dispatches << ',' << counters.pipelineBinds << ','
+            << counters.descriptorUpdates << ',' << counters.bytesUploaded << ',' << counters.submits << ','
+            << frame.vmaUsageBytes << ',' << frame.vmaBudgetBytes << '\n';
+    }
+}
+
+void PerfCapture::WriteJson(std::ostream& out) const
+{
+    out << "{\n  \"frameCount\": " << frames_.size() << ",\n  \"frames\": [\n";
+    for (size_t i = 0; i < frames_.size(); ++i) {
+        const Frame& frame = frames_[i];
+        const PerfCounters::Snapshot& counters = frame.counters;
+        out << "    {\"frame\": " << frame.frameIndex
+            << ", \"frameMs\": " << frame.frameMs
+            << ", \"cpuMs\": " << frame.cpuMs
+            << ", \"gpuMs\": " << frame.gpuMs
+            << ", \"draws\": " << counters.draws
+            << ", \"dispatches\": " << counters.dispatches
+            << ", \"pipelineBinds\": " << counters.pipelineBinds
+            << ", \"descriptorUpdates\": " << counters.descriptorUpdates
+            << ", \"bytesUploaded\": " << counters.bytesUploaded
+            << ", \"submits\": " << counters.submits
+            << ", \"vmaUsageBytes\": " << frame.vmaUsageBytes
+            << ", \"vmaBudgetBytes\": " << frame.vmaBudgetBytes << '}'
+            << (i + 1 < frames_.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+}
+
+} // namespace VulkanEngine::RAII::Utils
@@ -0,0 +1,64 @@
+#ifndef VULKAN_RAII_UTILS_PERF_CAPTURE_HPP
+#define VULKAN_RAII_UTILS_PERF_CAPTURE_HPP
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "PerfCounters.hpp"
+
+namespace VulkanEngine::RAII::Utils {
+
+// Fixed-length recording of per-frame metrics written to CSV or JSON, meant to be
+// diffed between builds (SDLApplication drives one through StartPerfCapture). Storage
+// for every frame is reserved up front; the file is only written by Save.
+class PerfCapture {
+public:
+    enum class Format {
+        CSV,
+        JSON
+    };
+
+    struct Frame {
+        uint64_t frameIndex{0};
+        double frameMs{0.0};
+        double cpuMs{0.0};
+        double gpuMs{0.0}; // Latest resolved GPU frame time, 0 without a GpuProfiler
+        PerfCounters::Snapshot counters{};
+        uint64_t vmaUsageBytes{0}; // Summed over heaps, 0 without an allocator
+        uint64_t vmaBudgetBytes{0};
+    };
+
+    PerfCapture(std::string path, uint32_t frame_count, Format format = Format::CSV);
+
+    // Append a frame; returns true once frame_count frames are recorded (later frames are ignored)
+    bool Record(const Frame& frame);
+
+    [[nodiscard]] bool IsComplete() const { return frames_.size() >= frameCount_; }
+    [[nodiscard]] uint32_t GetRecordedCount() const { return static_cast<uint32_t>(frames_.size()); }
+    [[nodiscard]] uint32_t GetFrameCount() const { return frameCount_; }
+    [[nodiscard]] const std::string& GetPath() const { return path_; }
+    [[nodiscard]] const std::vector<Frame>& GetFrames() const { return frames_; }
+
+    // Write the recorded frames, complete or not
+    void Write(std::ostream& out) const;
+    bool Save() const;
+
+    // JSON for a .json extension, CSV otherwise
+    [[nodiscard]] static Format FormatFromPath(std::string_view path);
+
+private:
+    std::string path_;
+    uint32_t frameCount_;
+    Format format_;
+    std::vector<Frame> frames_;
+
+    void WriteCsv(std::ostream& out) const;
+    void WriteJson(std::ostream& out) const;
+};
+
+} // namespace VulkanEngine::RAII::Utils
+
+#endif // VULKAN_RAII_UTILS_PERF_CAPTURE_HPP
@@ -0,0 +1,85 @@
+#ifndef VULKAN_RAII_UTILS_PERF_COUNTERS_HPP
+#define VULKAN_RAII_UTILS_PERF_COUNTERS_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace VulkanEngine::RAII::Utils {
+
+// Process-wide work counters for performance captures (see PerfCapture), incremented
+// by CommandBuffer (draws, dispatches, pipeline binds, push descriptors), DescriptorPool
+// (descriptor writes), UploadManager (staged bytes) and Queue (submits). Off by default;
+// a disabled counter costs one relaxed load, an enabled one a relaxed add on its own
+// cache line, so recording threads do not contend on a shared line.
+class PerfCounters {
+public:
+    struct Snapshot {
+        uint64_t draws{0}; // Draw commands; indirect and multi draws add their draw count, indirect-count draws one
+        uint64_t dispatches{0};
+        uint64_t pipelineBinds{0}; // Pipelines and shader object binds
+        uint64_t descriptorUpdates{0}; // Descriptors written or copied, including push descriptors
+        uint64_t bytesUploaded{0}; // Bytes staged for upload
+        uint64_t submits{0}; // Queue submissions (batches, not vkQueueSubmit calls)
+    };
+
+    static void SetEnabled(bool enabled) noexcept { enabled_.store(enabled, std::memory_order_relaxed); }
+    [[nodiscard]] static bool IsEnabled() noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+    static void AddDraws(uint64_t count = 1) noexcept { Add(DRAWS, count); }
+    static void AddDispatches(uint64_t count = 1) noexcept { Add(DISPATCHES, count); }
+    static void AddPipelineBinds(uint64_t count = 1) noexcept { Add(PIPELINE_BINDS, count); }
+    static void AddDescriptorUpdates(uint64_t count) noexcept { Add(DESCRIPTOR_UPDATES, count); }
+    static void AddBytesUploaded(uint64_t bytes) noexcept { Add(BYTES_UPLOADED, bytes); }
+    static void AddSubmits(uint64_t count = 1) noexcept { Add(SUBMITS, count); }
+
+    // Current totals, and the same while zeroing them for the next frame
+    [[nodiscard]] static Snapshot Read() noexcept { return Collect(false); }
+    static Snapshot ReadAndReset() noexcept { return Collect(true); }
+
+private:
+    enum Counter : size_t {
+        DRAWS,
+        DISPATCHES,
+        PIPELINE_BINDS,
+        DESCRIPTOR_UPDATES,
+        BYTES_UPLOADED,
+        SUBMITS,
+        COUNTER_COUNT
+    };
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> value{0};
+    };
+
+    static void Add(Counter counter, uint64_t amount) noexcept
+    {
+        if (IsEnabled()) {
+            counters_[counter].value.fetch_add(amount, std::memory_order_relaxed);
+        }
+    }
+
+    static Snapshot Collect(bool reset) noexcept
+    {
+        auto read = [reset](Counter counter) {
+            std::atomic<uint64_t>& value = counters_[counter].value;
+            return reset ? value.exchange(0, std::memory_order_relaxed) : value.load(std::memory_order_relaxed);
+        };
+        Snapshot snapshot{};
+        snapshot.draws = read(DRAWS);
+        snapshot.dispatches = read(DISPATCHES);
+        snapshot.pipelineBinds = read(PIPELINE_BINDS);
+        snapshot.descriptorUpdates = read(DESCRIPTOR_UPDATES);
+        snapshot.bytesUploaded = read(BYTES_UPLOADED);
+        snapshot.submits = read(SUBMITS);
+        return snapshot;
+    }
+
+    static inline std::atomic<bool> enabled_{false};
+    static inline std::array<Slot, COUNTER_COUNT> counters_{};
+};
+
+} // namespace VulkanEngine::RAII::Utils
+
+#endif // VULKAN_RAII_UTILS_PERF_COUNTERS_HPP
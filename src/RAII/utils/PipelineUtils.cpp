@@ -1,4 +1,7 @@
 #include "PipelineUtils.hpp"
+
+#include "CapabilityUtils.hpp"
+
 #include <cstdint>
 #include <vector>
 
@@ -227,6 +230,63 @@ std::vector<VkDynamicState> PipelineUtils::GetExtendedDynamicStates() {
             VK_DYNAMIC_STATE_BLEND_CONSTANTS};
 }
 
+std::vector<VkDynamicState> PipelineUtils::GetAllDynamicStates(const DeviceExtensionFeatures& features) {
+    std::vector<VkDynamicState> states = GetExtendedDynamicStates();
+    states.insert(states.end(), {VK_DYNAMIC_STATE_DEPTH_BOUNDS,
+                                 VK_DYNAMIC_STATE_STENCIL_COMPARE_MASK,
+                                 VK_DYNAMIC_STATE_STENCIL_WRITE_MASK,
+                                 VK_DYNAMIC_STATE_STENCIL_REFERENCE});
+
+    if (features.extendedDynamicState) {
+        states.insert(states.end(), {VK_DYNAMIC_STATE_CULL_MODE_EXT,
+                                     VK_DYNAMIC_STATE_FRONT_FACE_EXT,
+                                     VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY_EXT,
+                                     VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT,
+                                     VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT,
+                                     VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT,
+                                     VK_DYNAMIC_STATE_DEPTH_BOUNDS_TEST_ENABLE_EXT,
+                                     VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE_EXT,
+                                     VK_DYNAMIC_STATE_STENCIL_OP_EXT});
+    }
+    if (features.extendedDynamicState2) {
+        states.insert(states.end(), {VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE_EXT,
+                                     VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE_EXT,
+                                     VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE_EXT});
+    }
+    if (features.extendedDynamicState2LogicOp) {
+        states.push_back(VK_DYNAMIC_STATE_LOGIC_OP_EXT);
+    }
+    if (features.extendedDynamicState2PatchControlPoints) {
+        states.push_back(VK_DYNAMIC_STATE_PATCH_CONTROL_POINTS_EXT);
+    }
+
+    if (features.extendedDynamicState3PolygonMode) {
+        states.push_back(VK_DYNAMIC_STATE_POLYGON_MODE_EXT);
+    }
+    if (features.extendedDynamicState3DepthClampEnable) {
+        states.push_back(VK_DYNAMIC_STATE_DEPTH_CLAMP_ENABLE_EXT);
+    }
+    if (features.extendedDynamicState3RasterizationSamples) {
+        states.push_back(VK_DYNAMIC_STATE_RASTERIZATION_SAMPLES_EXT);
+    }
+    if (features.extendedDynamicState3AlphaToCoverageEnable) {
+        states.push_back(VK_DYNAMIC_STATE_ALPHA_TO_COVERAGE_ENABLE_EXT);
+    }
+    if (features.extendedDynamicState3LogicOpEnable) {
+        states.push_back(VK_DYNAMIC_STATE_LOGIC_OP_ENABLE_EXT);
+    }
+    if (features.extendedDynamicState3ColorBlendEnable) {
+        states.push_back(VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT);
+    }
+    if (features.extendedDynamicState3ColorBlendEquation) {
+        states.push_back(VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT);
+    }
+    if (features.extendedDynamicState3ColorWriteMask) {
+        states.push_back(VK_DYNAMIC_STATE_COLOR_WRITE_MASK_EXT);
+    }
+    return states;
+}
+
 } // namespace VulkanEngine::RAII::Utils
 
 
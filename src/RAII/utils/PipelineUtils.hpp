@@ -10,6 +10,8 @@
 
 namespace VulkanEngine::RAII::Utils {
 
+struct DeviceExtensionFeatures; // Forward declaration
+
 // Pipeline utilities
 class PipelineUtils {
 public:
@@ -101,6 +103,11 @@ public:
     // Common dynamic states
     static std::vector<VkDynamicState> GetBasicDynamicStates();
     static std::vector<VkDynamicState> GetExtendedDynamicStates();
+
+    // Every state the device can set at record time: the core extended states plus
+    // whatever VK_EXT_extended_dynamic_state 1/2/3 enabled. Viewport and scissor
+    // counts stay baked into the pipeline
+    static std::vector<VkDynamicState> GetAllDynamicStates(const DeviceExtensionFeatures& features);
 };
 
 } // namespace VulkanEngine::RAII::Utils
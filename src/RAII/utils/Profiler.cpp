@@ -0,0 +1,292 @@
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <string_view>
+#include <utility>
+
+
+namespace VulkanEngine::RAII::Utils {
+
+namespace {
+
+void WriteJsonString(std::ostream& out, std::string_view text)
+{
+    out << '"';
+    for (const char c : text) {
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec << std::setfill(' ');
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
+
+// Trace timestamps are microseconds
+double ToMicroseconds(uint64_t ns)
+{
+    return static_cast<double>(ns) / 1'000.0;
+}
+
+void WriteMetadata(std::ostream& out, const char* kind, uint32_t pid, uint32_t tid, std::string_view name)
+{
+    out << ",\n{\"ph\":\"M\",\"name\":\"" << kind << "\",\"pid\":" << pid << ",\"tid\":" << tid << ",\"args\":{\"name\":";
+    WriteJsonString(out, name);
+    out << "}}";
+}
+
+} // namespace
+
+// Written by its thread (head, depth, zones), drained by CollectFrame (tail). head and
+// tail sit on separate cache lines so the two sides do not share one
+struct Profiler::ThreadBuffer {
+    std::array<CpuZone, THREAD_BUFFER_CAPACITY> zones{};
+    alignas(64) std::atomic<uint64_t> head{0};
+    uint32_t depth{0};
+    alignas(64) std::atomic<uint64_t> tail{0};
+    std::atomic<uint64_t> dropped{0};
+    uint32_t threadId{0};
+    std::string name; // Guarded by Profiler::mutex_
+};
+
+Profiler::Profiler() = default;
+
+Profiler::~Profiler() = default;
+
+Profiler& Profiler::Instance()
+{
+    static Profiler instance;
+    return instance;
+}
+
+void Profiler::SetThreadName(std::string name)
+{
+    ThreadBuffer* buffer = GetThreadBuffer();
+    if (buffer) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffer->name = std::move(name);
+    }
+}
+
+void Profiler::SetHistorySize(uint32_t frame_count)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    historySize_ = std::max(1U, frame_count);
+    while (frames_.size() > historySize_) {
+        frames_.pop_front();
+    }
+}
+
+uint32_t Profiler::GetHistorySize() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return historySize_;
+}
+
+void Profiler::CollectFrame(uint64_t frame_id, std::span<const GpuZone> gpu_zones)
+{
+    const uint64_t now = Timer::NowNanoseconds();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Frame frame;
+    frame.frameId = frame_id;
+    frame.startNs = lastCollectNs_ != 0 ? lastCollectNs_ : now;
+    frame.endNs = now;
+    for (const auto& buffer : threads_) {
+        const uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+        const uint64_t head = buffer->head.load(std::memory_order_acquire);
+        for (uint64_t i = tail; i < head; ++i) {
+            CpuZone zone = buffer->zones[i & (THREAD_BUFFER_CAPACITY - 1)];
+            zone.threadId = buffer->threadId;
+            frame.cpuZones.push_back(zone);
+        }
+        // Hand the slots back to the thread only after they were copied
+        buffer->tail.store(head, std::memory_order_release);
+    }
+    // Zones are written when they end; order them by start for nesting-aware consumers
+    std::sort(frame.cpuZones.begin(), frame.cpuZones.end(), [](const CpuZone& a, const CpuZone& b) {
+        return a.startNs != b.startNs ? a.startNs < b.startNs : a.depth < b.depth;
+    });
+    frame.gpuZones.assign(gpu_zones.begin(), gpu_zones.end());
+
+    frames_.push_back(std::move(frame));
+    while (frames_.size() > historySize_) {
+        frames_.pop_front();
+    }
+    lastCollectNs_ = now;
+}
+
+std::vector<Profiler::Frame> Profiler::GetFrames() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {frames_.begin(), frames_.end()};
+}
+
+std::vector<Profiler::ZoneStats> Profiler::GetZoneStats(uint32_t frame_count) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Names compare by content; the same literal may live at several addresses
+    std::map<std::string_view, ZoneStats> by_name;
+    const size_t first = frames_.size() - std::min<size_t>(frames_.size(), frame_count);
+    for (size_t i = first; i < frames_.size(); ++i) {
+        for (const CpuZone& zone : frames_[i].cpuZones) {
+            ZoneStats& stats = by_name[zone.name];
+            const double ms = static_cast<double>(zone.endNs - zone.startNs) / 1'000'000.0;
+            stats.calls++;
+            stats.totalMs += ms;
+            stats.maxMs = std::max(stats.maxMs, ms);
+        }
+    }
+
+    std::vector<ZoneStats> result;
+    result.reserve(by_name.size());
+    for (auto& [name, stats] : by_name) {
+        stats.name = std::string(name);
+        result.push_back(std::move(stats));
+    }
+    std::sort(result.begin(), result.end(), [](const ZoneStats& a, const ZoneStats& b) { return a.totalMs > b.totalMs; });
+    return result;
+}
+
+uint64_t Profiler::GetDroppedZoneCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t dropped = 0;
+    for (const auto& buffer : threads_) {
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+void Profiler::WriteChromeTrace(std::ostream& out) const
+{
+    constexpr uint32_t CPU_PID = 1;
+    constexpr uint32_t GPU_PID = 2;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint64_t origin = frames_.empty() ? 0 : frames_.front().startNs;
+    auto timestamp = [origin](uint64_t ns) { return ToMicroseconds(ns > origin ? ns - origin : 0); };
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" << CPU_PID << ",\"tid\":0,\"args\":{\"name\":\"CPU\"}}";
+    WriteMetadata(out, "process_name", GPU_PID, 0, "GPU");
+    for (const auto& buffer : threads_) {
+        const std::string name = buffer->name.empty() ? "Thread " + std::to_string(buffer->threadId) : buffer->name;
+        WriteMetadata(out, "thread_name", CPU_PID, buffer->threadId, name);
+    }
+
+    // GPU tracks get a tid each, in order of first use
+    std::vector<std::string_view> tracks;
+    auto track_id = [&tracks, &out](const char* track) {
+        const std::string_view name = track ? track : "GPU";
+        auto it = std::find(tracks.begin(), tracks.end(), name);
+        if (it != tracks.end()) {
+            return static_cast<uint32_t>(it - tracks.begin());
+        }
+        tracks.push_back(name);
+        const auto id = static_cast<uint32_t>(tracks.size() - 1);
+        WriteMetadata(out, "thread_name", GPU_PID, id, name);
+        return id;
+    };
+
+    for (const Frame& frame : frames_) {
+        out << ",\n{\"ph\":\"i\",\"s\":\"g\",\"name\":\"Frame " << frame.frameId << "\",\"pid\":" << CPU_PID
+            << ",\"tid\":0,\"ts\":" << timestamp(frame.startNs) << '}';
+        for (const CpuZone& zone : frame.cpuZones) {
+            out << ",\n{\"ph\":\"X\",\"name\":";
+            WriteJsonString(out, zone.name ? zone.name : "(unnamed)");
+            out << ",\"pid\":" << CPU_PID << ",\"tid\":" << zone.threadId << ",\"ts\":" << timestamp(zone.startNs)
+                << ",\"dur\":" << ToMicroseconds(zone.endNs - zone.startNs) << '}';
+        }
+        for (const GpuZone& zone : frame.gpuZones) {
+            const uint32_t tid = track_id(zone.track);
+            out << ",\n{\"ph\":\"X\",\"name\":";
+            WriteJsonString(out, zone.name);
+            out << ",\"pid\":" << GPU_PID << ",\"tid\":" << tid << ",\"ts\":" << timestamp(zone.startNs)
+                << ",\"dur\":" << ToMicroseconds(zone.durationNs) << '}';
+        }
+    }
+    out << "\n]}\n";
+}
+
+bool Profiler::SaveChromeTrace(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    WriteChromeTrace(file);
+    return static_cast<bool>(file);
+}
+
+void Profiler::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    frames_.clear();
+    lastCollectNs_ = 0;
+}
+
+Profiler::ThreadBuffer* Profiler::EnterScope() noexcept
+{
+    ThreadBuffer* buffer = GetThreadBuffer();
+    if (buffer) {
+        buffer->depth++;
+    }
+    return buffer;
+}
+
+void Profiler::LeaveScope(ThreadBuffer* buffer, const char* name, uint64_t start_ns) noexcept
+{
+    const uint64_t end_ns = Timer::NowNanoseconds();
+    buffer->depth--;
+    const uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    if (head - buffer->tail.load(std::memory_order_acquire) >= THREAD_BUFFER_CAPACITY) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    CpuZone& zone = buffer->zones[head & (THREAD_BUFFER_CAPACITY - 1)];
+    zone.name = name;
+    zone.startNs = start_ns;
+    zone.endNs = end_ns;
+    zone.depth = buffer->depth;
+    // Publish the zone to the collector
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+Profiler::ThreadBuffer* Profiler::GetThreadBuffer() noexcept
+{
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        try {
+            buffer = Instance().RegisterThread();
+        } catch (...) {
+            return nullptr; // Out of memory: this thread records nothing
+        }
+    }
+    return buffer;
+}
+
+Profiler::ThreadBuffer* Profiler::RegisterThread()
+{
+    auto buffer = std::make_unique<ThreadBuffer>();
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffer->threadId = static_cast<uint32_t>(threads_.size());
+    threads_.push_back(std::move(buffer));
+    return threads_.back().get();
+}
+
+} // namespace VulkanEngine::RAII::Utils
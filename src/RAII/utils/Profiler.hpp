@@ -0,0 +1,171 @@
+#ifndef VULKAN_RAII_UTILS_PROFILER_HPP
+#define VULKAN_RAII_UTILS_PROFILER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Timer.hpp"
+#include "TracyUtils.hpp"
+
+namespace VulkanEngine::RAII::Utils {
+
+// Hierarchical CPU profiler. VULKAN_RAII_PROFILE_SCOPE zones are written into a ring
+// buffer owned by the calling thread (single producer, no locks, one release store
+// per zone) and drained by CollectFrame (Renderer::EndFrame does this while the
+// profiler is enabled) into a frame history that can be aggregated or exported as
+// Chrome trace JSON, which Perfetto opens as well. GPU zones handed to CollectFrame
+// share the timeline. Zone names are not copied and must outlive the profiler
+// (string literals, __func__). Zones recorded while a thread's ring is full are
+// dropped and counted.
+class Profiler {
+public:
+    struct CpuZone {
+        const char* name{nullptr};
+        uint64_t startNs{0}; // Timer::NowNanoseconds()
+        uint64_t endNs{0};
+        uint32_t depth{0}; // Nesting level on its thread, 0 for top-level zones
+        uint32_t threadId{0}; // Order in which threads recorded their first zone
+    };
+
+    struct GpuZone {
+        std::string name;
+        const char* track{"GPU"}; // Timeline row, e.g. the queue name
+        uint32_t depth{0};
+        uint64_t startNs{0}; // On the CPU timeline
+        uint64_t durationNs{0};
+    };
+
+    struct Frame {
+        uint64_t frameId{0};
+        uint64_t startNs{0}; // Previous collection
+        uint64_t endNs{0};
+        std::vector<CpuZone> cpuZones; // Sorted by start
+        std::vector<GpuZone> gpuZones;
+    };
+
+    // Aggregate of the zones sharing a name
+    struct ZoneStats {
+        std::string name;
+        uint32_t calls{0};
+        double totalMs{0.0};
+        double maxMs{0.0};
+    };
+
+    // Zones a thread can record between two collections; a power of two
+    static constexpr uint64_t THREAD_BUFFER_CAPACITY = 8192;
+
+    static Profiler& Instance();
+
+    // Delete copy and move. zones from every thread are recorded through the single instance.
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+    Profiler(Profiler&&) = delete;
+    Profiler& operator=(Profiler&&) = delete;
+
+    // Disabled scopes cost one relaxed load; off by default
+    void SetEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    [[nodiscard]] static bool IsEnabled() noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+    // Name the calling thread in exported traces
+    void SetThreadName(std::string name);
+
+    // Frames kept for GetFrames, GetZoneStats and export
+    void SetHistorySize(uint32_t frame_count);
+    [[nodiscard]] uint32_t GetHistorySize() const;
+
+    // Drain every thread's zones into a new frame. Zones still open stay on their
+    // threads and land in a later frame
+    void CollectFrame(uint64_t frame_id, std::span<const GpuZone> gpu_zones = {});
+
+    // Collected frames, oldest first
+    [[nodiscard]] std::vector<Frame> GetFrames() const;
+
+    // CPU zones of the last frame_count frames by name, largest total first
+    [[nodiscard]] std::vector<ZoneStats> GetZoneStats(uint32_t frame_count = 1) const;
+
+    [[nodiscard]] uint64_t GetDroppedZoneCount() const;
+
+    // Chrome trace event JSON of the frame history (chrome://tracing, ui.perfetto.dev)
+    void WriteChromeTrace(std::ostream& out) const;
+    bool SaveChromeTrace(const std::string& path) const;
+
+    // Forget the frame history (zones not yet collected are kept)
+    void Clear();
+
+private:
+    friend class ProfileScope;
+    struct ThreadBuffer;
+
+    Profiler();
+    ~Profiler();
+
+    static ThreadBuffer* EnterScope() noexcept;
+    static void LeaveScope(ThreadBuffer* buffer, const char* name, uint64_t start_ns) noexcept;
+    static ThreadBuffer* GetThreadBuffer() noexcept;
+    ThreadBuffer* RegisterThread();
+
+    static inline std::atomic<bool> enabled_{false};
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadBuffer>> threads_; // Kept after their thread exits
+    std::deque<Frame> frames_;
+    uint32_t historySize_{120};
+    uint64_t lastCollectNs_{0};
+};
+
+// RAII zone on the calling thread; use through VULKAN_RAII_PROFILE_SCOPE
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) noexcept
+    {
+        if (Profiler::IsEnabled()) {
+            name_ = name;
+            buffer_ = Profiler::EnterScope();
+            startNs_ = Timer::NowNanoseconds();
+        }
+    }
+
+    ~ProfileScope()
+    {
+        if (buffer_) {
+            Profiler::LeaveScope(buffer_, name_, startNs_);
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+    ProfileScope(ProfileScope&&) = delete;
+    ProfileScope& operator=(ProfileScope&&) = delete;
+
+private:
+    Profiler::ThreadBuffer* buffer_{nullptr};
+    const char* name_{nullptr};
+    uint64_t startNs_{0};
+};
+
+} // namespace VulkanEngine::RAII::Utils
+
+// Scopes also open a Tracy zone when Tracy is compiled in (name must then be a string
+// literal). Define VULKAN_RAII_DISABLE_PROFILER to compile the Profiler side out
+#ifndef VULKAN_RAII_DISABLE_PROFILER
+#define VULKAN_RAII_PROFILE_CONCAT_INNER(a, b) a##b
+#define VULKAN_RAII_PROFILE_CONCAT(a, b) VULKAN_RAII_PROFILE_CONCAT_INNER(a, b)
+#define VULKAN_RAII_PROFILE_SCOPE(name) \
+    VULKAN_RAII_TRACY_ZONE(name); \
+    ::VulkanEngine::RAII::Utils::ProfileScope VULKAN_RAII_PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+#define VULKAN_RAII_PROFILE_FUNCTION() \
+    VULKAN_RAII_TRACY_FUNCTION(); \
+    ::VulkanEngine::RAII::Utils::ProfileScope VULKAN_RAII_PROFILE_CONCAT(profile_scope_, __LINE__)(__func__)
+#else
+#define VULKAN_RAII_PROFILE_SCOPE(name) VULKAN_RAII_TRACY_ZONE(name)
+#define VULKAN_RAII_PROFILE_FUNCTION() VULKAN_RAII_TRACY_FUNCTION()
+#endif
+
+#endif // VULKAN_RAII_UTILS_PROFILER_HPP
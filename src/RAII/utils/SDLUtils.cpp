@@ -289,6 +289,10 @@ double SDLUtils::GetElapsedTime(uint64_t start, uint64_t end) {
     return static_cast<double>(end - start) / static_cast<double>(freq);
 }
 
+void SDLUtils::DelayNanoseconds(uint64_t nanoseconds) {
+    SDL_DelayNS(nanoseconds);
+}
+
 bool SDLUtils::HasClipboardText() {
     return SDL_HasClipboardText();
 }
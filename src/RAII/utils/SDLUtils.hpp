@@ -88,6 +88,8 @@ public:
     static uint64_t GetPerformanceCounter();
     static uint64_t GetPerformanceFrequency();
     static double GetElapsedTime(uint64_t start, uint64_t end);
+    // Sleep the calling thread; the OS may overshoot by up to its timer granularity
+    static void DelayNanoseconds(uint64_t nanoseconds);
 
     // Clipboard support
     static bool HasClipboardText();
@@ -0,0 +1,109 @@
+#ifndef VULKAN_RAII_UTILS_SMALL_VECTOR_HPP
+#define VULKAN_RAII_UTILS_SMALL_VECTOR_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace VulkanEngine::RAII::Utils {
+
+// Contiguous storage for trivially copyable Vulkan structures that keeps the first
+// N elements inline and only spills to the heap past that. Used on submission
+// paths, where a handful of structures per call should not allocate. Pointers
+// into the elements are invalidated when it grows past N (or past the heap
+// capacity), so size it with resize() before taking addresses.
+template <typename T, std::size_t N>
+class SmallVector {
+    static_assert(std::is_trivially_copyable_v<T>, "SmallVector holds trivially copyable types only");
+
+public:
+    SmallVector() = default;
+    SmallVector(const SmallVector&) = default;
+    SmallVector& operator=(const SmallVector&) = default;
+
+    // The source is left empty; a defaulted move would keep its size over a moved-out heap
+    SmallVector(SmallVector&& other) noexcept
+        : inline_(other.inline_),
+        heap_(std::move(other.heap_)),
+        size_(std::exchange(other.size_, 0)) {}
+
+    SmallVector& operator=(SmallVector&& other) noexcept
+    {
+        if (this != &other) {
+            inline_ = other.inline_;
+            heap_ = std::move(other.heap_);
+            size_ = std::exchange(other.size_, 0);
+            other.heap_.clear();
+        }
+        return *this;
+    }
+
+    void push_back(const T& value)
+    {
+        if (size_ < N) {
+            inline_[size_] = value;
+        } else {
+            if (size_ == N) {
+                heap_.assign(inline_.begin(), inline_.end());
+            }
+            heap_.push_back(value);
+        }
+        ++size_;
+    }
+
+    // Grow or shrink to count elements; new elements are value-initialized
+    void resize(std::size_t count)
+    {
+        if (count > N) {
+            if (size_ <= N) {
+                heap_.assign(inline_.begin(), inline_.begin() + static_cast<std::ptrdiff_t>(size_));
+            }
+            heap_.resize(count);
+        } else {
+            if (size_ > N) {
+                std::copy(heap_.begin(), heap_.begin() + static_cast<std::ptrdiff_t>(count), inline_.begin());
+                heap_.clear();
+            }
+            for (std::size_t i = size_; i < count; ++i) {
+                inline_[i] = T{};
+            }
+        }
+        size_ = count;
+    }
+
+    // Keeps the heap capacity, so a reused SmallVector stops allocating after warm-up
+    void clear()
+    {
+        size_ = 0;
+        heap_.clear();
+    }
+
+    [[nodiscard]] T* data() { return size_ > N ? heap_.data() : inline_.data(); }
+    [[nodiscard]] const T* data() const { return size_ > N ? heap_.data() : inline_.data(); }
+    [[nodiscard]] std::size_t size() const { return size_; }
+    [[nodiscard]] bool empty() const { return size_ == 0; }
+
+    T& operator[](std::size_t index) { return data()[index]; }
+    const T& operator[](std::size_t index) const { return data()[index]; }
+
+    T* begin() { return data(); }
+    T* end() { return data() + size_; }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + size_; }
+
+    [[nodiscard]] std::span<const T> AsSpan() const { return {data(), size_}; }
+
+private:
+    std::array<T, N> inline_{};
+    std::vector<T> heap_;
+    std::size_t size_{0};
+};
+
+} // namespace VulkanEngine::RAII::Utils
+
+#endif // VULKAN_RAII_UTILS_SMALL_VECTOR_HPP
@@ -0,0 +1,606 @@
+#include "SpirvUtils.hpp"
+
+#include "HashUtils.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace VulkanEngine::RAII::Utils {
+
+namespace {
+constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+constexpr size_t SPIRV_HEADER_WORDS = 5;
+
+// Opcodes
+constexpr uint32_t OP_NAME = 5;
+constexpr uint32_t OP_ENTRY_POINT = 15;
+constexpr uint32_t OP_EXECUTION_MODE = 16;
+constexpr uint32_t OP_TYPE_INT = 21;
+constexpr uint32_t OP_TYPE_FLOAT = 22;
+constexpr uint32_t OP_TYPE_VECTOR = 23;
+constexpr uint32_t OP_TYPE_MATRIX = 24;
+constexpr uint32_t OP_TYPE_IMAGE = 25;
+constexpr uint32_t OP_TYPE_SAMPLER = 26;
+constexpr uint32_t OP_TYPE_SAMPLED_IMAGE = 27;
+constexpr uint32_t OP_TYPE_ARRAY = 28;
+constexpr uint32_t OP_TYPE_RUNTIME_ARRAY = 29;
+constexpr uint32_t OP_TYPE_STRUCT = 30;
+constexpr uint32_t OP_TYPE_POINTER = 32;
+constexpr uint32_t OP_CONSTANT = 43;
+constexpr uint32_t OP_SPEC_CONSTANT = 50;
+constexpr uint32_t OP_VARIABLE = 59;
+constexpr uint32_t OP_DECORATE = 71;
+constexpr uint32_t OP_MEMBER_DECORATE = 72;
+constexpr uint32_t OP_EXECUTION_MODE_ID = 331;
+constexpr uint32_t OP_TYPE_ACCELERATION_STRUCTURE_KHR = 5341;
+
+// Decorations
+constexpr uint32_t DECORATION_BLOCK = 2;
+constexpr uint32_t DECORATION_BUFFER_BLOCK = 3;
+constexpr uint32_t DECORATION_ARRAY_STRIDE = 6;
+constexpr uint32_t DECORATION_MATRIX_STRIDE = 7;
+constexpr uint32_t DECORATION_BUILT_IN = 11;
+constexpr uint32_t DECORATION_LOCATION = 30;
+constexpr uint32_t DECORATION_BINDING = 33;
+constexpr uint32_t DECORATION_DESCRIPTOR_SET = 34;
+constexpr uint32_t DECORATION_OFFSET = 35;
+
+// Storage classes
+constexpr uint32_t STORAGE_UNIFORM_CONSTANT = 0;
+constexpr uint32_t STORAGE_INPUT = 1;
+constexpr uint32_t STORAGE_UNIFORM = 2;
+constexpr uint32_t STORAGE_PUSH_CONSTANT = 9;
+constexpr uint32_t STORAGE_STORAGE_BUFFER = 12;
+
+// Execution modes and image dimensions
+constexpr uint32_t EXECUTION_MODE_LOCAL_SIZE = 17;
+constexpr uint32_t EXECUTION_MODE_LOCAL_SIZE_ID = 38;
+constexpr uint32_t DIM_BUFFER = 5;
+constexpr uint32_t DIM_SUBPASS_DATA = 6;
+
+constexpr uint32_t NOT_SET = UINT32_MAX;
+
+struct IdInfo {
+    uint32_t opcode{0};
+    size_t offset{0}; // Word offset of the defining instruction
+    uint32_t set{NOT_SET};
+    uint32_t binding{NOT_SET};
+    uint32_t location{NOT_SET};
+    uint32_t arrayStride{0};
+    bool builtIn{false};
+    bool block{false};
+    bool bufferBlock{false};
+    std::string name;
+};
+
+struct MemberInfo {
+    uint32_t offset{NOT_SET};
+    uint32_t matrixStride{0};
+};
+
+class Parser {
+public:
+    Parser(const uint32_t* code, size_t word_count, uint32_t runtime_array_count)
+        : code_(code), wordCount_(word_count), runtimeArrayCount_(runtime_array_count)
+    {
+        if (code == nullptr || word_count < SPIRV_HEADER_WORDS || code[0] != SPIRV_MAGIC) {
+            throw std::invalid_argument("Not a SPIR-V module");
+        }
+        ids_.resize(code[3]);
+    }
+
+    SpirvReflection Run()
+    {
+        ParseInstructions();
+        if (!hasEntryPoint_) {
+            throw std::invalid_argument("SPIR-V module has no entry point");
+        }
+
+        for (uint32_t i = 0; i < 3; ++i) {
+            if (workgroupSizeIds_[i] != 0) {
+                result_.workgroupSize[i] = GetConstant(workgroupSizeIds_[i]);
+            }
+        }
+
+        for (uint32_t id = 0; id < ids_.size(); ++id) {
+            if (ids_[id].opcode == OP_VARIABLE) {
+                ReflectVariable(id);
+            }
+        }
+
+        std::sort(result_.descriptorBindings.begin(), result_.descriptorBindings.end(),
+                  [](const SpirvReflection::DescriptorBinding& a, const SpirvReflection::DescriptorBinding& b) {
+                      return a.set != b.set ? a.set < b.set : a.layoutBinding.binding < b.layoutBinding.binding;
+                  });
+        PackVertexInputs();
+        return result_;
+    }
+
+private:
+    const uint32_t* code_;
+    size_t wordCount_;
+    uint32_t runtimeArrayCount_;
+    std::vector<IdInfo> ids_;
+    std::unordered_map<uint32_t, std::vector<MemberInfo>> members_;
+    SpirvReflection result_;
+    bool hasEntryPoint_{false};
+    uint32_t entryPointId_{0};
+    uint32_t workgroupSizeIds_[3]{0, 0, 0};
+
+    IdInfo& Id(uint32_t id)
+    {
+        if (id >= ids_.size()) {
+            throw std::invalid_argument("SPIR-V id out of bounds");
+        }
+        return ids_[id];
+    }
+
+    uint32_t Word(size_t offset) const
+    {
+        if (offset >= wordCount_) {
+            throw std::invalid_argument("SPIR-V instruction out of bounds");
+        }
+        return code_[offset];
+    }
+
+    std::string ReadString(size_t offset, size_t end) const
+    {
+        std::string text;
+        for (size_t i = offset; i < end; ++i) {
+            const uint32_t word = code_[i];
+            for (uint32_t byte = 0; byte < 4; ++byte) {
+                const char c = static_cast<char>((word >> (byte * 8)) & 0xFF);
+                if (c == '\0') {
+                    return text;
+                }
+                text.push_back(c);
+            }
+        }
+        return text;
+    }
+
+    MemberInfo& Member(uint32_t struct_id, uint32_t member)
+    {
+        std::vector<MemberInfo>& members = members_[struct_id];
+        if (members.size() <= member) {
+            members.resize(member + 1);
+        }
+        return members[member];
+    }
+
+    void ParseInstructions()
+    {
+        size_t i = SPIRV_HEADER_WORDS;
+        while (i < wordCount_) {
+            const uint32_t opcode = code_[i] & 0xFFFF;
+            const uint32_t length = code_[i] >> 16;
+            if (length == 0 || i + length > wordCount_) {
+                throw std::invalid_argument("Malformed SPIR-V instruction stream");
+            }
+            const size_t end = i + length;
+
+            switch (opcode) {
+                case OP_NAME:
+                    Id(Word(i + 1)).name = ReadString(i + 2, end);
+                    break;
+                case OP_ENTRY_POINT:
+                    if (!hasEntryPoint_) {
+                        hasEntryPoint_ = true;
+                        result_.stage = SpirvUtils::GetStageForExecutionModel(Word(i + 1));
+                        entryPointId_ = Word(i + 2);
+                        result_.entryPoint = ReadString(i + 3, end);
+                    }
+                    break;
+                case OP_EXECUTION_MODE:
+                    if (hasEntryPoint_ && Word(i + 1) == entryPointId_ && Word(i + 2) == EXECUTION_MODE_LOCAL_SIZE) {
+                        result_.workgroupSize = {Word(i + 3), Word(i + 4), Word(i + 5)};
+                    }
+                    break;
+                case OP_EXECUTION_MODE_ID:
+                    if (hasEntryPoint_ && Word(i + 1) == entryPointId_ && Word(i + 2) == EXECUTION_MODE_LOCAL_SIZE_ID) {
+                        workgroupSizeIds_[0] = Word(i + 3);
+                        workgroupSizeIds_[1] = Word(i + 4);
+                        workgroupSizeIds_[2] = Word(i + 5);
+                    }
+                    break;
+                case OP_DECORATE:
+                    ParseDecoration(Id(Word(i + 1)), Word(i + 2), length > 3 ? Word(i + 3) : 0);
+                    break;
+                case OP_MEMBER_DECORATE:
+                    if (Word(i + 3) == DECORATION_OFFSET) {
+                        Member(Word(i + 1), Word(i + 2)).offset = Word(i + 4);
+                    } else if (Word(i + 3) == DECORATION_MATRIX_STRIDE) {
+                        Member(Word(i + 1), Word(i + 2)).matrixStride = Word(i + 4);
+                    }
+                    break;
+                case OP_TYPE_INT:
+                case OP_TYPE_FLOAT:
+                case OP_TYPE_VECTOR:
+                case OP_TYPE_MATRIX:
+                case OP_TYPE_IMAGE:
+                case OP_TYPE_SAMPLER:
+                case OP_TYPE_SAMPLED_IMAGE:
+                case OP_TYPE_ARRAY:
+                case OP_TYPE_RUNTIME_ARRAY:
+                case OP_TYPE_STRUCT:
+                case OP_TYPE_POINTER:
+                case OP_TYPE_ACCELERATION_STRUCTURE_KHR: {
+                    IdInfo& info = Id(Word(i + 1));
+                    info.opcode = opcode;
+                    info.offset = i;
+                    break;
+                }
+                case OP_CONSTANT:
+                case OP_SPEC_CONSTANT:
+                case OP_VARIABLE: {
+                    IdInfo& info = Id(Word(i + 2));
+                    info.opcode = opcode;
+                    info.offset = i;
+                    break;
+                }
+                default:
+                    break;
+            }
+            i = end;
+        }
+    }
+
+    static void ParseDecoration(IdInfo& info, uint32_t decoration, uint32_t value)
+    {
+        switch (decoration) {
+            case DECORATION_BLOCK: info.block = true; break;
+            case DECORATION_BUFFER_BLOCK: info.bufferBlock = true; break;
+            case DECORATION_ARRAY_STRIDE: info.arrayStride = value; break;
+            case DECORATION_BUILT_IN: info.builtIn = true; break;
+            case DECORATION_LOCATION: info.location = value; break;
+            case DECORATION_BINDING: info.binding = value; break;
+            case DECORATION_DESCRIPTOR_SET: info.set = value; break;
+            default: break;
+        }
+    }
+
+    uint32_t GetConstant(uint32_t id)
+    {
+        const IdInfo& info = Id(id);
+        if (info.opcode != OP_CONSTANT && info.opcode != OP_SPEC_CONSTANT) {
+            throw std::invalid_argument("SPIR-V array length or size is not a constant");
+        }
+        return Word(info.offset + 3); // Low word; default value for spec constants
+    }
+
+    // Size in bytes of a type in an explicitly laid out block
+    uint32_t GetTypeSize(uint32_t type_id, uint32_t matrix_stride = 0)
+    {
+        const IdInfo& info = Id(type_id);
+        const size_t offset = info.offset;
+        switch (info.opcode) {
+            case OP_TYPE_INT:
+            case OP_TYPE_FLOAT:
+                return Word(offset + 2) / 8;
+            case OP_TYPE_VECTOR:
+                return Word(offset + 3) * GetTypeSize(Word(offset + 2));
+            case OP_TYPE_MATRIX: {
+                const uint32_t column_size = matrix_stride != 0 ? matrix_stride : GetTypeSize(Word(offset + 2));
+                return Word(offset + 3) * column_size;
+            }
+            case OP_TYPE_ARRAY: {
+                const uint32_t element_size = info.arrayStride != 0 ? info.arrayStride : GetTypeSize(Word(offset + 2), matrix_stride);
+                return GetConstant(Word(offset + 3)) * element_size;
+            }
+            case OP_TYPE_STRUCT: {
+                const uint32_t member_count = static_cast<uint32_t>((code_[offset] >> 16) - 2);
+                uint32_t size = 0;
+                for (uint32_t member = 0; member < member_count; ++member) {
+                    const MemberInfo member_info = Member(type_id, member);
+                    const uint32_t member_size = GetTypeSize(Word(offset + 2 + member), member_info.matrixStride);
+                    const uint32_t member_offset = member_info.offset != NOT_SET ? member_info.offset : size;
+                    size = std::max(size, member_offset + member_size);
+                }
+                return size;
+            }
+            default:
+                return 0; // Runtime arrays and opaque types have no static size
+        }
+    }
+
+    void ReflectVariable(uint32_t variable_id)
+    {
+        const IdInfo& variable = Id(variable_id);
+        const uint32_t storage_class = Word(variable.offset + 3);
+        const IdInfo& pointer = Id(Word(variable.offset + 1));
+        if (pointer.opcode != OP_TYPE_POINTER) {
+            return;
+        }
+        const uint32_t pointee_id = Word(pointer.offset + 3);
+
+        switch (storage_class) {
+            case STORAGE_UNIFORM_CONSTANT:
+            case STORAGE_UNIFORM:
+            case STORAGE_STORAGE_BUFFER:
+                ReflectDescriptor(variable_id, storage_class, pointee_id);
+                break;
+            case STORAGE_PUSH_CONSTANT:
+                ReflectPushConstant(pointee_id);
+                break;
+            case STORAGE_INPUT:
+                if (result_.stage == VK_SHADER_STAGE_VERTEX_BIT && !variable.builtIn && variable.location != NOT_SET) {
+                    ReflectVertexInput(variable.location, pointee_id);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    void ReflectDescriptor(uint32_t variable_id, uint32_t storage_class, uint32_t type_id)
+    {
+        const IdInfo& variable = Id(variable_id);
+        if (variable.binding == NOT_SET) {
+            return;
+        }
+
+        uint32_t count = 1;
+        bool runtime_array = false;
+        while (Id(type_id).opcode == OP_TYPE_ARRAY || Id(type_id).opcode == OP_TYPE_RUNTIME_ARRAY) {
+            const IdInfo& array = Id(type_id);
+            if (array.opcode == OP_TYPE_ARRAY) {
+                count *= GetConstant(Word(array.offset + 3));
+            } else {
+                runtime_array = true;
+            }
+            type_id = Word(array.offset + 2);
+        }
+
+        const IdInfo& type = Id(type_id);
+        VkDescriptorType descriptor_type = VK_DESCRIPTOR_TYPE_MAX_ENUM;
+        switch (type.opcode) {
+            case OP_TYPE_SAMPLER:
+                descriptor_type = VK_DESCRIPTOR_TYPE_SAMPLER;
+                break;
+            case OP_TYPE_SAMPLED_IMAGE:
+                descriptor_type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                break;
+            case OP_TYPE_IMAGE: {
+                const uint32_t dim = Word(type.offset + 3);
+                const uint32_t sampled = Word(type.offset + 7);
+                if (dim == DIM_BUFFER) {
+                    descriptor_type = sampled == 2 ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+                } else if (dim == DIM_SUBPASS_DATA) {
+                    descriptor_type = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+                } else {
+                    descriptor_type = sampled == 2 ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+                }
+                break;
+            }
+            case OP_TYPE_ACCELERATION_STRUCTURE_KHR:
+                descriptor_type = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+                break;
+            case OP_TYPE_STRUCT:
+                if (storage_class == STORAGE_STORAGE_BUFFER || type.bufferBlock) {
+                    descriptor_type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                } else if (storage_class == STORAGE_UNIFORM && type.block) {
+                    descriptor_type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                }
+                break;
+            default:
+                break;
+        }
+        if (descriptor_type == VK_DESCRIPTOR_TYPE_MAX_ENUM) {
+            return;
+        }
+
+        SpirvReflection::DescriptorBinding binding{};
+        binding.set = variable.set != NOT_SET ? variable.set : 0;
+        binding.layoutBinding.binding = variable.binding;
+        binding.layoutBinding.descriptorType = descriptor_type;
+        binding.layoutBinding.descriptorCount = runtime_array ? runtimeArrayCount_ : count;
+        binding.layoutBinding.stageFlags = result_.stage;
+        if (runtime_array) {
+            binding.bindingFlags = VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+        }
+        binding.name = !variable.name.empty() ? variable.name : type.name;
+        result_.descriptorBindings.push_back(std::move(binding));
+    }
+
+    void ReflectPushConstant(uint32_t type_id)
+    {
+        const IdInfo& type = Id(type_id);
+        if (type.opcode != OP_TYPE_STRUCT) {
+            return;
+        }
+        const uint32_t member_count = static_cast<uint32_t>((code_[type.offset] >> 16) - 2);
+        uint32_t begin = UINT32_MAX;
+        for (uint32_t member = 0; member < member_count; ++member) {
+            const uint32_t member_offset = Member(type_id, member).offset;
+            begin = std::min(begin, member_offset != NOT_SET ? member_offset : 0u);
+        }
+        const uint32_t end = GetTypeSize(type_id);
+        if (member_count == 0 || end <= begin) {
+            return;
+        }
+
+        VkPushConstantRange range{};
+        range.stageFlags = result_.stage;
+        range.offset = begin;
+        range.size = end - begin;
+        result_.pushConstantRanges.push_back(range);
+    }
+
+    VkFormat GetVertexFormat(uint32_t type_id)
+    {
+        const IdInfo& type = Id(type_id);
+        uint32_t components = 1;
+        uint32_t scalar_id = type_id;
+        if (type.opcode == OP_TYPE_VECTOR) {
+            components = Word(type.offset + 3);
+            scalar_id = Word(type.offset + 2);
+        }
+        const IdInfo& scalar = Id(scalar_id);
+        if (components < 1 || components > 4) {
+            return VK_FORMAT_UNDEFINED;
+        }
+        const uint32_t width = Word(scalar.offset + 2);
+        const uint32_t index = components - 1;
+
+        if (scalar.opcode == OP_TYPE_FLOAT) {
+            static constexpr VkFormat FLOAT16[] = {VK_FORMAT_R16_SFLOAT, VK_FORMAT_R16G16_SFLOAT, VK_FORMAT_R16G16B16_SFLOAT, VK_FORMAT_R16G16B16A16_SFLOAT};
+            static constexpr VkFormat FLOAT32[] = {VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT};
+            static constexpr VkFormat FLOAT64[] = {VK_FORMAT_R64_SFLOAT, VK_FORMAT_R64G64_SFLOAT, VK_FORMAT_R64G64B64_SFLOAT, VK_FORMAT_R64G64B64A64_SFLOAT};
+            return width == 16 ? FLOAT16[index] : width == 64 ? FLOAT64[index] : FLOAT32[index];
+        }
+        if (scalar.opcode == OP_TYPE_INT) {
+            const bool is_signed = Word(scalar.offset + 3) != 0;
+            static constexpr VkFormat SINT32[] = {VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT};
+            static constexpr VkFormat UINT32[] = {VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT};
+            static constexpr VkFormat SINT16[] = {VK_FORMAT_R16_SINT, VK_FORMAT_R16G16_SINT, VK_FORMAT_R16G16B16_SINT, VK_FORMAT_R16G16B16A16_SINT};
+            static constexpr VkFormat UINT16[] = {VK_FORMAT_R16_UINT, VK_FORMAT_R16G16_UINT, VK_FORMAT_R16G16B16_UINT, VK_FORMAT_R16G16B16A16_UINT};
+            if (width == 16) {
+                return is_signed ? SINT16[index] : UINT16[index];
+            }
+            return is_signed ? SINT32[index] : UINT32[index];
+        }
+        return VK_FORMAT_UNDEFINED;
+    }
+
+    void ReflectVertexInput(uint32_t location, uint32_t type_id)
+    {
+        const IdInfo& type = Id(type_id);
+        // Matrices take one location per column
+        const uint32_t columns = type.opcode == OP_TYPE_MATRIX ? Word(type.offset + 3) : 1;
+        const uint32_t column_type = type.opcode == OP_TYPE_MATRIX ? Word(type.offset + 2) : type_id;
+        const VkFormat format = GetVertexFormat(column_type);
+        if (format == VK_FORMAT_UNDEFINED) {
+            return;
+        }
+        for (uint32_t column = 0; column < columns; ++column) {
+            VkVertexInputAttributeDescription attribute{};
+            attribute.location = location + column;
+            attribute.binding = 0;
+            attribute.format = format;
+            attribute.offset = GetTypeSize(column_type); // Size for now; turned into offsets when packing
+            result_.inputAttributes.push_back(attribute);
+        }
+    }
+
+    void PackVertexInputs()
+    {
+        if (result_.inputAttributes.empty()) {
+            return;
+        }
+        std::sort(result_.inputAttributes.begin(), result_.inputAttributes.end(),
+                  [](const VkVertexInputAttributeDescription& a, const VkVertexInputAttributeDescription& b) {
+                      return a.location < b.location;
+                  });
+        uint32_t stride = 0;
+        for (VkVertexInputAttributeDescription& attribute : result_.inputAttributes) {
+            const uint32_t size = attribute.offset;
+            attribute.offset = stride;
+            stride += size;
+        }
+        result_.inputBindings.push_back(VkVertexInputBindingDescription{0, stride, VK_VERTEX_INPUT_RATE_VERTEX});
+    }
+};
+} // namespace
+
+SpirvReflection SpirvUtils::Reflect(const uint32_t* code, size_t word_count, uint32_t runtime_array_count)
+{
+    if (runtime_array_count == 0) {
+        throw std::invalid_argument("Runtime descriptor arrays need a non-zero descriptor count");
+    }
+    return Parser(code, word_count, runtime_array_count).Run();
+}
+
+uint64_t SpirvUtils::HashCode(const uint32_t* code, size_t word_count)
+{
+    return HashFnv1a(code, word_count);
+}
+
+SpirvReflection SpirvUtils::Merge(const std::vector<const SpirvReflection*>& stages)
+{
+    SpirvReflection merged{};
+    bool first = true;
+    VkPushConstantRange push_constants{0, UINT32_MAX, 0};
+    uint32_t push_constant_end = 0;
+
+    for (const SpirvReflection* stage : stages) {
+        if (stage == nullptr) {
+            continue;
+        }
+        if (first) {
+            merged.stage = stage->stage;
+            merged.entryPoint = stage->entryPoint;
+            first = false;
+        }
+
+        for (const SpirvReflection::DescriptorBinding& binding : stage->descriptorBindings) {
+            auto it = std::find_if(merged.descriptorBindings.begin(), merged.descriptorBindings.end(),
+                                   [&binding](const SpirvReflection::DescriptorBinding& existing) {
+                                       return existing.set == binding.set &&
+                                           existing.layoutBinding.binding == binding.layoutBinding.binding;
+                                   });
+            if (it == merged.descriptorBindings.end()) {
+                merged.descriptorBindings.push_back(binding);
+                continue;
+            }
+            if (it->layoutBinding.descriptorType != binding.layoutBinding.descriptorType) {
+                throw std::invalid_argument("Stages disagree on the descriptor type of set " + std::to_string(binding.set) +
+                                            " binding " + std::to_string(binding.layoutBinding.binding));
+            }
+            it->layoutBinding.stageFlags |= binding.layoutBinding.stageFlags;
+            it->bindingFlags |= binding.bindingFlags;
+            it->layoutBinding.descriptorCount = std::max(it->layoutBinding.descriptorCount, binding.layoutBinding.descriptorCount);
+        }
+
+        for (const VkPushConstantRange& range : stage->pushConstantRanges) {
+            push_constants.stageFlags |= range.stageFlags;
+            push_constants.offset = std::min(push_constants.offset, range.offset);
+            push_constant_end = std::max(push_constant_end, range.offset + range.size);
+        }
+
+        if (stage->stage == VK_SHADER_STAGE_VERTEX_BIT) {
+            merged.inputAttributes = stage->inputAttributes;
+            merged.inputBindings = stage->inputBindings;
+        }
+        if (stage->workgroupSize[0] != 0) {
+            merged.workgroupSize = stage->workgroupSize;
+        }
+    }
+
+    if (push_constants.stageFlags != 0) {
+        push_constants.size = push_constant_end - push_constants.offset;
+        merged.pushConstantRanges.push_back(push_constants);
+    }
+    std::sort(merged.descriptorBindings.begin(), merged.descriptorBindings.end(),
+              [](const SpirvReflection::DescriptorBinding& a, const SpirvReflection::DescriptorBinding& b) {
+                  return a.set != b.set ? a.set < b.set : a.layoutBinding.binding < b.layoutBinding.binding;
+              });
+    return merged;
+}
+
+VkShaderStageFlagBits SpirvUtils::GetStageForExecutionModel(uint32_t execution_model)
+{
+    switch (execution_model) {
+        case 0: return VK_SHADER_STAGE_VERTEX_BIT;
+        case 1: return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+        case 2: return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+        case 3: return VK_SHADER_STAGE_GEOMETRY_BIT;
+        case 4: return VK_SHADER_STAGE_FRAGMENT_BIT;
+        case 5: return VK_SHADER_STAGE_COMPUTE_BIT;
+        case 5364: return VK_SHADER_STAGE_TASK_BIT_EXT;
+        case 5365: return VK_SHADER_STAGE_MESH_BIT_EXT;
+        case 5313: return VK_SHADER_STAGE_RAYGEN_BIT_KHR;
+        case 5314: return VK_SHADER_STAGE_INTERSECTION_BIT_KHR;
+        case 5315: return VK_SHADER_STAGE_ANY_HIT_BIT_KHR;
+        case 5316: return VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR;
+        case 5317: return VK_SHADER_STAGE_MISS_BIT_KHR;
+        case 5318: return VK_SHADER_STAGE_CALLABLE_BIT_KHR;
+        default: return static_cast<VkShaderStageFlagBits>(0);
+    }
+}
+
+} // namespace VulkanEngine::RAII::Utils
@@ -0,0 +1,66 @@
+#ifndef VULKAN_RAII_UTILS_SPIRV_UTILS_HPP
+#define VULKAN_RAII_UTILS_SPIRV_UTILS_HPP
+
+#include <volk.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace VulkanEngine::RAII::Utils {
+
+// Resource interface of one SPIR-V entry point
+struct SpirvReflection {
+    struct DescriptorBinding {
+        uint32_t set{0};
+        VkDescriptorSetLayoutBinding layoutBinding{}; // Runtime arrays get the count passed to Reflect
+        // VARIABLE_DESCRIPTOR_COUNT | PARTIALLY_BOUND for runtime arrays, 0 otherwise
+        VkDescriptorBindingFlags bindingFlags{0};
+        std::string name;
+
+        [[nodiscard]] bool IsRuntimeArray() const { return bindingFlags != 0; }
+    };
+
+    VkShaderStageFlagBits stage{VK_SHADER_STAGE_VERTEX_BIT};
+    std::string entryPoint;
+    std::vector<DescriptorBinding> descriptorBindings;
+    std::vector<VkPushConstantRange> pushConstantRanges;
+    std::vector<VkVertexInputAttributeDescription> inputAttributes; // Vertex stage only, packed into binding 0
+    std::vector<VkVertexInputBindingDescription> inputBindings;
+    std::array<uint32_t, 3> workgroupSize{0, 0, 0}; // Compute, task and mesh stages
+};
+
+// Minimal SPIR-V parser, enough to derive layouts without external dependencies
+class SpirvUtils {
+public:
+    // Descriptor count given to runtime arrays (bindless tables) unless the caller picks one
+    static constexpr uint32_t DEFAULT_RUNTIME_ARRAY_COUNT = 1024;
+
+    // Reflect the first entry point of a module. Runtime arrays are sized to
+    // runtime_array_count, the upper bound of their variable descriptor count.
+    // Throws std::invalid_argument on malformed code
+    static SpirvReflection Reflect(const uint32_t* code,
+                                   size_t word_count,
+                                   uint32_t runtime_array_count = DEFAULT_RUNTIME_ARRAY_COUNT);
+    static SpirvReflection Reflect(const std::vector<uint32_t>& code,
+                                   uint32_t runtime_array_count = DEFAULT_RUNTIME_ARRAY_COUNT) {
+        return Reflect(code.data(), code.size(), runtime_array_count);
+    }
+
+    // FNV-1a hash of the code words, used to key reflection caches
+    static uint64_t HashCode(const uint32_t* code, size_t word_count);
+
+    // Merge several stages into one interface: bindings are unioned with their
+    // stage and binding flags OR-ed, push constants become one range covering all stages
+    static SpirvReflection Merge(const std::vector<const SpirvReflection*>& stages);
+
+    // Vulkan stage for a SPIR-V execution model (0 if unknown)
+    static VkShaderStageFlagBits GetStageForExecutionModel(uint32_t execution_model);
+};
+
+} // namespace VulkanEngine::RAII::Utils
+
+
+#endif // VULKAN_RAII_UTILS_SPIRV_UTILS_HPP
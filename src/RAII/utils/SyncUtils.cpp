@@ -0,0 +1,368 @@
+#include "SyncUtils.hpp"
+
+#include "DeviceDispatch.hpp"
+#include "ImageUtils.hpp"
+#include "PerfCounters.hpp"
+#include "Profiler.hpp"
+#include "SmallVector.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+
+
+namespace VulkanEngine::RAII::Utils {
+
+namespace {
+constexpr uint64_t LEGACY_BITS = 0xFFFFFFFFull;
+
+constexpr VkPipelineStageFlags2KHR TRANSFER_STAGES = VK_PIPELINE_STAGE_2_COPY_BIT_KHR |
+                                                     VK_PIPELINE_STAGE_2_RESOLVE_BIT_KHR |
+                                                     VK_PIPELINE_STAGE_2_BLIT_BIT_KHR |
+                                                     VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR;
+constexpr VkPipelineStageFlags2KHR VERTEX_INPUT_STAGES = VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT_KHR |
+                                                         VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT_KHR;
+constexpr VkAccessFlags2KHR SHADER_READ_ACCESS = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR |
+                                                 VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR;
+
+// Inline capacity of the legacy submit translation; larger batches spill to the heap
+constexpr size_t LEGACY_SUBMIT_CAPACITY = 8;
+constexpr size_t LEGACY_SEMAPHORE_CAPACITY = 16;
+
+// Barriers of one or more dependency infos translated for a single legacy command,
+// which takes one pair of stage masks for all of them
+struct LegacyDependency {
+    VkPipelineStageFlags2KHR srcStages{0};
+    VkPipelineStageFlags2KHR dstStages{0};
+    std::vector<VkMemoryBarrier> memoryBarriers;
+    std::vector<VkBufferMemoryBarrier> bufferBarriers;
+    std::vector<VkImageMemoryBarrier> imageBarriers;
+};
+
+void AppendLegacyDependency(const VkDependencyInfoKHR& dependency_info, LegacyDependency& legacy)
+{
+    for (uint32_t i = 0; i < dependency_info.memoryBarrierCount; ++i) {
+        const VkMemoryBarrier2KHR& barrier = dependency_info.pMemoryBarriers[i];
+        legacy.srcStages |= barrier.srcStageMask;
+        legacy.dstStages |= barrier.dstStageMask;
+        VkMemoryBarrier memory_barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+        memory_barrier.srcAccessMask = SyncUtils::ToLegacyAccessFlags(barrier.srcAccessMask);
+        memory_barrier.dstAccessMask = SyncUtils::ToLegacyAccessFlags(barrier.dstAccessMask);
+        legacy.memoryBarriers.push_back(memory_barrier);
+    }
+
+    for (uint32_t i = 0; i < dependency_info.bufferMemoryBarrierCount; ++i) {
+        const VkBufferMemoryBarrier2KHR& barrier = dependency_info.pBufferMemoryBarriers[i];
+        legacy.srcStages |= barrier.srcStageMask;
+        legacy.dstStages |= barrier.dstStageMask;
+        VkBufferMemoryBarrier buffer_barrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+        buffer_barrier.srcAccessMask = SyncUtils::ToLegacyAccessFlags(barrier.srcAccessMask);
+        buffer_barrier.dstAccessMask = SyncUtils::ToLegacyAccessFlags(barrier.dstAccessMask);
+        buffer_barrier.srcQueueFamilyIndex = barrier.srcQueueFamilyIndex;
+        buffer_barrier.dstQueueFamilyIndex = barrier.dstQueueFamilyIndex;
+        buffer_barrier.buffer = barrier.buffer;
+        buffer_barrier.offset = barrier.offset;
+        buffer_barrier.size = barrier.size;
+        legacy.bufferBarriers.push_back(buffer_barrier);
+    }
+
+    for (uint32_t i = 0; i < dependency_info.imageMemoryBarrierCount; ++i) {
+        const VkImageMemoryBarrier2KHR& barrier = dependency_info.pImageMemoryBarriers[i];
+        legacy.srcStages |= barrier.srcStageMask;
+        legacy.dstStages |= barrier.dstStageMask;
+        VkImageMemoryBarrier image_barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+        image_barrier.srcAccessMask = SyncUtils::ToLegacyAccessFlags(barrier.srcAccessMask);
+        image_barrier.dstAccessMask = SyncUtils::ToLegacyAccessFlags(barrier.dstAccessMask);
+        image_barrier.oldLayout = barrier.oldLayout;
+        image_barrier.newLayout = barrier.newLayout;
+        image_barrier.srcQueueFamilyIndex = barrier.srcQueueFamilyIndex;
+        image_barrier.dstQueueFamilyIndex = barrier.dstQueueFamilyIndex;
+        image_barrier.image = barrier.image;
+        image_barrier.subresourceRange = barrier.subresourceRange;
+        legacy.imageBarriers.push_back(image_barrier);
+    }
+}
+} // namespace
+
+VkPipelineStageFlags SyncUtils::ToLegacyStageFlags(VkPipelineStageFlags2KHR stages, bool is_source) {
+    auto legacy = static_cast<VkPipelineStageFlags>(stages & LEGACY_BITS);
+    if ((stages & TRANSFER_STAGES) != 0) {
+        legacy |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+    }
+    if ((stages & VERTEX_INPUT_STAGES) != 0) {
+        legacy |= VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+    }
+    if ((stages & VK_PIPELINE_STAGE_2_PRE_RASTERIZATION_SHADERS_BIT_KHR) != 0) {
+        // Naming the tessellation and geometry stages needs their features; all graphics is always valid
+        legacy |= VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT;
+    }
+    if (legacy == 0) {
+        legacy = is_source ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+    }
+    return legacy;
+}
+
+VkAccessFlags SyncUtils::ToLegacyAccessFlags(VkAccessFlags2KHR access) {
+    auto legacy = static_cast<VkAccessFlags>(access & LEGACY_BITS);
+    if ((access & SHADER_READ_ACCESS) != 0) {
+        legacy |= VK_ACCESS_SHADER_READ_BIT;
+    }
+    if ((access & VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR) != 0) {
+        legacy |= VK_ACCESS_SHADER_WRITE_BIT;
+    }
+    return legacy;
+}
+
+void SyncUtils::CmdPipelineBarrier2(VkCommandBuffer cmd,
+                                    const VkDependencyInfoKHR& dependency_info,
+                                    bool synchronization2,
+                                    const VolkDeviceTable* dispatch) {
+    if (synchronization2) {
+        VULKAN_RAII_DEVICE_FN(dispatch, vkCmdPipelineBarrier2KHR)(cmd, &dependency_info);
+        return;
+    }
+
+    LegacyDependency legacy;
+    AppendLegacyDependency(dependency_info, legacy);
+    VULKAN_RAII_DEVICE_FN(dispatch, vkCmdPipelineBarrier)(cmd,
+                                                          ToLegacyStageFlags(legacy.srcStages, true),
+                                                          ToLegacyStageFlags(legacy.dstStages, false),
+                                                          dependency_info.dependencyFlags,
+                                                          static_cast<uint32_t>(legacy.memoryBarriers.size()),
+                                                          legacy.memoryBarriers.empty() ? nullptr : legacy.memoryBarriers.data(),
+                                                          static_cast<uint32_t>(legacy.bufferBarriers.size()),
+                                                          legacy.bufferBarriers.empty() ? nullptr : legacy.bufferBarriers.data(),
+                                                          static_cast<uint32_t>(legacy.imageBarriers.size()),
+                                                          legacy.imageBarriers.empty() ? nullptr : legacy.imageBarriers.data());
+}
+
+void SyncUtils::CmdSetEvent2(VkCommandBuffer cmd,
+                             VkEvent event,
+                             const VkDependencyInfoKHR& dependency_info,
+                             bool synchronization2,
+                             const VolkDeviceTable* dispatch) {
+    if (synchronization2) {
+        VULKAN_RAII_DEVICE_FN(dispatch, vkCmdSetEvent2KHR)(cmd, event, &dependency_info);
+        return;
+    }
+
+    // The legacy set only takes the source scope; the barriers are recorded by the wait
+    LegacyDependency legacy;
+    AppendLegacyDependency(dependency_info, legacy);
+    VULKAN_RAII_DEVICE_FN(dispatch, vkCmdSetEvent)(cmd, event, ToLegacyStageFlags(legacy.srcStages, true));
+}
+
+void SyncUtils::CmdResetEvent2(VkCommandBuffer cmd,
+                               VkEvent event,
+                               VkPipelineStageFlags2KHR stages,
+                               bool synchronization2,
+                               const VolkDeviceTable* dispatch) {
+    if (synchronization2) {
+        VULKAN_RAII_DEVICE_FN(dispatch, vkCmdResetEvent2KHR)(cmd, event, stages);
+        return;
+    }
+    VULKAN_RAII_DEVICE_FN(dispatch, vkCmdResetEvent)(cmd, event, ToLegacyStageFlags(stages, true));
+}
+
+void SyncUtils::CmdWaitEvents2(VkCommandBuffer cmd,
+                               std::span<const VkEvent> events,
+                               std::span<const VkDependencyInfoKHR> dependency_infos,
+                               bool synchronization2,
+                               const VolkDeviceTable* dispatch) {
+    if (events.empty()) {
+        return;
+    }
+    if (synchronization2) {
+        VULKAN_RAII_DEVICE_FN(dispatch, vkCmdWaitEvents2KHR)(cmd, static_cast<uint32_t>(events.size()), events.data(), dependency_infos.data());
+        return;
+    }
+
+    // One legacy wait takes the union of every event's scopes and barriers; its source
+    // mask must be exactly the union of the masks CmdSetEvent2 translated per event
+    LegacyDependency legacy;
+    VkPipelineStageFlags src_stages = 0;
+    for (const VkDependencyInfoKHR& dependency_info : dependency_infos) {
+        legacy.srcStages = 0;
+        AppendLegacyDependency(dependency_info, legacy);
+        src_stages |= ToLegacyStageFlags(legacy.srcStages, true);
+    }
+    VULKAN_RAII_DEVICE_FN(dispatch, vkCmdWaitEvents)(cmd,
+                                                     static_cast<uint32_t>(events.size()),
+                                                     events.data(),
+                                                     src_stages,
+                                                     ToLegacyStageFlags(legacy.dstStages, false),
+                                                     static_cast<uint32_t>(legacy.memoryBarriers.size()),
+                                                     legacy.memoryBarriers.empty() ? nullptr : legacy.memoryBarriers.data(),
+                                                     static_cast<uint32_t>(legacy.bufferBarriers.size()),
+                                                     legacy.bufferBarriers.empty() ? nullptr : legacy.bufferBarriers.data(),
+                                                     static_cast<uint32_t>(legacy.imageBarriers.size()),
+                                                     legacy.imageBarriers.empty() ? nullptr : legacy.imageBarriers.data());
+}
+
+VkResult SyncUtils::QueueSubmit2(VkQueue queue,
+                                 std::span<const VkSubmitInfo2KHR> submits,
+                                 VkFence fence,
+                                 bool synchronization2,
+                                 const VolkDeviceTable* dispatch) {
+    VULKAN_RAII_PROFILE_SCOPE("Queue::Submit");
+    PerfCounters::AddSubmits(submits.size());
+    if (synchronization2) {
+        return VULKAN_RAII_DEVICE_FN(dispatch, vkQueueSubmit2KHR)(queue, static_cast<uint32_t>(submits.size()), submits.empty() ? nullptr : submits.data(), fence);
+    }
+
+    // Size the flat arrays up front so the pointers taken below stay valid
+    size_t wait_count = 0;
+    size_t command_buffer_count = 0;
+    size_t signal_count = 0;
+    for (const VkSubmitInfo2KHR& submit : submits) {
+        wait_count += submit.waitSemaphoreInfoCount;
+        command_buffer_count += submit.commandBufferInfoCount;
+        signal_count += submit.signalSemaphoreInfoCount;
+    }
+
+    SmallVector<VkSemaphore, LEGACY_SEMAPHORE_CAPACITY> wait_semaphores;
+    SmallVector<uint64_t, LEGACY_SEMAPHORE_CAPACITY> wait_values;
+    SmallVector<VkPipelineStageFlags, LEGACY_SEMAPHORE_CAPACITY> wait_stages;
+    SmallVector<VkCommandBuffer, LEGACY_SEMAPHORE_CAPACITY> command_buffers;
+    SmallVector<VkSemaphore, LEGACY_SEMAPHORE_CAPACITY> signal_semaphores;
+    SmallVector<uint64_t, LEGACY_SEMAPHORE_CAPACITY> signal_values;
+    SmallVector<VkTimelineSemaphoreSubmitInfo, LEGACY_SUBMIT_CAPACITY> timeline_infos;
+    SmallVector<VkSubmitInfo, LEGACY_SUBMIT_CAPACITY> legacy_submits;
+    wait_semaphores.resize(wait_count);
+    wait_values.resize(wait_count);
+    wait_stages.resize(wait_count);
+    command_buffers.resize(command_buffer_count);
+    signal_semaphores.resize(signal_count);
+    signal_values.resize(signal_count);
+    timeline_infos.resize(submits.size());
+    legacy_submits.resize(submits.size());
+
+    size_t wait_offset = 0;
+    size_t command_buffer_offset = 0;
+    size_t signal_offset = 0;
+    for (size_t i = 0; i < submits.size(); ++i) {
+        const VkSubmitInfo2KHR& submit = submits[i];
+        bool has_timeline_values = false;
+        for (uint32_t j = 0; j < submit.waitSemaphoreInfoCount; ++j) {
+            const VkSemaphoreSubmitInfoKHR& wait = submit.pWaitSemaphoreInfos[j];
+            wait_semaphores[wait_offset + j] = wait.semaphore;
+            wait_values[wait_offset + j] = wait.value;
+            wait_stages[wait_offset + j] = ToLegacyStageFlags(wait.stageMask, false);
+            has_timeline_values = has_timeline_values || wait.value != 0;
+        }
+        for (uint32_t j = 0; j < submit.commandBufferInfoCount; ++j) {
+            command_buffers[command_buffer_offset + j] = submit.pCommandBufferInfos[j].commandBuffer;
+        }
+        for (uint32_t j = 0; j < submit.signalSemaphoreInfoCount; ++j) {
+            const VkSemaphoreSubmitInfoKHR& signal = submit.pSignalSemaphoreInfos[j];
+            signal_semaphores[signal_offset + j] = signal.semaphore;
+            signal_values[signal_offset + j] = signal.value;
+            has_timeline_values = has_timeline_values || signal.value != 0;
+        }
+
+        VkSubmitInfo& submit_info = legacy_submits[i];
+        submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.waitSemaphoreCount = submit.waitSemaphoreInfoCount;
+        submit_info.pWaitSemaphores = wait_semaphores.data() + wait_offset;
+        submit_info.pWaitDstStageMask = wait_stages.data() + wait_offset;
+        submit_info.commandBufferCount = submit.commandBufferInfoCount;
+        submit_info.pCommandBuffers = command_buffers.data() + command_buffer_offset;
+        submit_info.signalSemaphoreCount = submit.signalSemaphoreInfoCount;
+        submit_info.pSignalSemaphores = signal_semaphores.data() + signal_offset;
+        if (has_timeline_values) {
+            VkTimelineSemaphoreSubmitInfo& timeline_info = timeline_infos[i];
+            timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+            timeline_info.waitSemaphoreValueCount = submit.waitSemaphoreInfoCount;
+            timeline_info.pWaitSemaphoreValues = wait_values.data() + wait_offset;
+            timeline_info.signalSemaphoreValueCount = submit.signalSemaphoreInfoCount;
+            timeline_info.pSignalSemaphoreValues = signal_values.data() + signal_offset;
+            submit_info.pNext = &timeline_info;
+        }
+
+        wait_offset += submit.waitSemaphoreInfoCount;
+        command_buffer_offset += submit.commandBufferInfoCount;
+        signal_offset += submit.signalSemaphoreInfoCount;
+    }
+
+    return VULKAN_RAII_DEVICE_FN(dispatch, vkQueueSubmit)(queue,
+                                                          static_cast<uint32_t>(legacy_submits.size()),
+                                                          legacy_submits.empty() ? nullptr : legacy_submits.data(),
+                                                          fence);
+}
+
+VkImageMemoryBarrier2KHR SyncUtils::CreateImageBarrier2(VkImage image,
+                                                        VkImageLayout old_layout,
+                                                        VkImageLayout new_layout,
+                                                        const VkImageSubresourceRange& subresource_range) {
+    VkImageMemoryBarrier2KHR barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR};
+    barrier.srcStageMask = ImageUtils::GetLayoutPipelineStageFlags2(old_layout, true);
+    barrier.srcAccessMask = ImageUtils::GetLayoutAccessFlags2(old_layout);
+    barrier.dstStageMask = ImageUtils::GetLayoutPipelineStageFlags2(new_layout, false);
+    barrier.dstAccessMask = ImageUtils::GetLayoutAccessFlags2(new_layout);
+    barrier.oldLayout = old_layout;
+    barrier.newLayout = new_layout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange = subresource_range;
+    return barrier;
+}
+
+VkBufferMemoryBarrier2KHR SyncUtils::CreateOwnershipBarrier(VkBuffer buffer,
+                                                            const OwnershipTransfer& transfer,
+                                                            bool release,
+                                                            VkDeviceSize offset,
+                                                            VkDeviceSize size) {
+    VkBufferMemoryBarrier2KHR barrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR};
+    const bool changes_family = transfer.ChangesFamily();
+    if (!changes_family || release) {
+        barrier.srcStageMask = transfer.sourceAccess.stages;
+        barrier.srcAccessMask = transfer.sourceAccess.access;
+    }
+    if (!changes_family || !release) {
+        barrier.dstStageMask = transfer.destinationAccess.stages;
+        barrier.dstAccessMask = transfer.destinationAccess.access;
+    }
+    barrier.srcQueueFamilyIndex = changes_family ? transfer.srcFamily : VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = changes_family ? transfer.dstFamily : VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = buffer;
+    barrier.offset = offset;
+    barrier.size = size;
+    return barrier;
+}
+
+VkImageMemoryBarrier2KHR SyncUtils::CreateOwnershipBarrier(VkImage image,
+                                                           const VkImageSubresourceRange& subresource_range,
+                                                           const OwnershipTransfer& transfer,
+                                                           bool release) {
+    VkImageMemoryBarrier2KHR barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR};
+    const bool changes_family = transfer.ChangesFamily();
+    if (!changes_family || release) {
+        barrier.srcStageMask = transfer.sourceAccess.stages;
+        barrier.srcAccessMask = transfer.sourceAccess.access;
+    }
+    if (!changes_family || !release) {
+        barrier.dstStageMask = transfer.destinationAccess.stages;
+        barrier.dstAccessMask = transfer.destinationAccess.access;
+    }
+    barrier.oldLayout = transfer.sourceAccess.layout;
+    barrier.newLayout = transfer.destinationAccess.layout;
+    barrier.srcQueueFamilyIndex = changes_family ? transfer.srcFamily : VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = changes_family ? transfer.dstFamily : VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange = subresource_range;
+    return barrier;
+}
+
+VkSemaphoreSubmitInfoKHR SyncUtils::CreateSemaphoreSubmitInfo(VkSemaphore semaphore,
+                                                              VkPipelineStageFlags2KHR stage_mask,
+                                                              uint64_t value) {
+    VkSemaphoreSubmitInfoKHR info{VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO_KHR};
+    info.semaphore = semaphore;
+    info.value = value;
+    info.stageMask = stage_mask;
+    return info;
+}
+
+} // namespace VulkanEngine::RAII::Utils
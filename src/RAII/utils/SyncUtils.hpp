@@ -0,0 +1,90 @@
+#ifndef VULKAN_RAII_UTILS_SYNC_UTILS_HPP
+#define VULKAN_RAII_UTILS_SYNC_UTILS_HPP
+
+#include <volk.h>
+#include <span>
+
+#include "../sync/ResourceState.hpp"
+
+
+
+namespace VulkanEngine::RAII::Utils {
+
+// Synchronization2 helpers. Barriers and submits are described with the 64-bit
+// VK_KHR_synchronization2 structures everywhere; when the device lacks the
+// extension (Device::SupportsSynchronization2) they are translated to
+// vkCmdPipelineBarrier/vkQueueSubmit. The translation widens stages and access
+// masks that have no legacy bit (e.g. COPY becomes TRANSFER), and cannot express
+// the sync2-only image layouts (READ_ONLY_OPTIMAL, ATTACHMENT_OPTIMAL).
+// Commands and submits go through dispatch (Device::GetDispatch) when one is given.
+class SyncUtils {
+public:
+    // Legacy stage mask covering stages; an empty mask becomes TOP_OF_PIPE or BOTTOM_OF_PIPE
+    static VkPipelineStageFlags ToLegacyStageFlags(VkPipelineStageFlags2KHR stages, bool is_source);
+
+    // Legacy access mask covering access
+    static VkAccessFlags ToLegacyAccessFlags(VkAccessFlags2KHR access);
+
+    // Record dependency_info with vkCmdPipelineBarrier2KHR, or as one vkCmdPipelineBarrier
+    static void CmdPipelineBarrier2(VkCommandBuffer cmd,
+                                    const VkDependencyInfoKHR& dependency_info,
+                                    bool synchronization2,
+                                    const VolkDeviceTable* dispatch = nullptr);
+
+    // Event commands (split barriers). dependency_info must be the same one later given to
+    // the wait; the legacy set only takes its source stages and the wait records the barriers
+    static void CmdSetEvent2(VkCommandBuffer cmd,
+                             VkEvent event,
+                             const VkDependencyInfoKHR& dependency_info,
+                             bool synchronization2,
+                             const VolkDeviceTable* dispatch = nullptr);
+
+    static void CmdResetEvent2(VkCommandBuffer cmd,
+                               VkEvent event,
+                               VkPipelineStageFlags2KHR stages,
+                               bool synchronization2,
+                               const VolkDeviceTable* dispatch = nullptr);
+
+    // Wait for events, dependency_infos holding one entry per event
+    static void CmdWaitEvents2(VkCommandBuffer cmd,
+                               std::span<const VkEvent> events,
+                               std::span<const VkDependencyInfoKHR> dependency_infos,
+                               bool synchronization2,
+                               const VolkDeviceTable* dispatch = nullptr);
+
+    // Submit with vkQueueSubmit2KHR, or vkQueueSubmit with timeline values chained
+    static VkResult QueueSubmit2(VkQueue queue,
+                                 std::span<const VkSubmitInfo2KHR> submits,
+                                 VkFence fence,
+                                 bool synchronization2,
+                                 const VolkDeviceTable* dispatch = nullptr);
+
+    // Image barrier with stages and access derived from the layouts (see ImageUtils::GetLayoutPipelineStageFlags2)
+    static VkImageMemoryBarrier2KHR CreateImageBarrier2(VkImage image,
+                                                        VkImageLayout old_layout,
+                                                        VkImageLayout new_layout,
+                                                        const VkImageSubresourceRange& subresource_range);
+
+    // One half of an ownership transfer: the release keeps only the source scope and the
+    // acquire only the destination scope, since the semaphore between the submits orders
+    // them. Without a family change the barrier carries both scopes and IGNORED families
+    static VkBufferMemoryBarrier2KHR CreateOwnershipBarrier(VkBuffer buffer,
+                                                            const OwnershipTransfer& transfer,
+                                                            bool release,
+                                                            VkDeviceSize offset = 0,
+                                                            VkDeviceSize size = VK_WHOLE_SIZE);
+
+    static VkImageMemoryBarrier2KHR CreateOwnershipBarrier(VkImage image,
+                                                           const VkImageSubresourceRange& subresource_range,
+                                                           const OwnershipTransfer& transfer,
+                                                           bool release);
+
+    // Binary (value 0) or timeline semaphore operation for VkSubmitInfo2KHR
+    static VkSemaphoreSubmitInfoKHR CreateSemaphoreSubmitInfo(VkSemaphore semaphore,
+                                                              VkPipelineStageFlags2KHR stage_mask,
+                                                              uint64_t value = 0);
+};
+
+} // namespace VulkanEngine::RAII::Utils
+
+#endif // VULKAN_RAII_UTILS_SYNC_UTILS_HPP
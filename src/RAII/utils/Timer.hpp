@@ -28,6 +28,11 @@ public:
     [[nodiscard]] double ElapsedMicroseconds() const noexcept { return ElapsedSeconds() * 1'000'000.0; }
     [[nodiscard]] std::uint64_t ElapsedNanoseconds() const noexcept;
 
+    // Monotonic timestamp in nanoseconds on the timer's clock (the Profiler time base)
+    [[nodiscard]] static std::uint64_t NowNanoseconds() noexcept {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count());
+    }
+
 private:
     using clock = std::chrono::steady_clock;
     clock::time_point start_point_{};
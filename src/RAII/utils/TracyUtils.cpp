@@ -0,0 +1,112 @@
+#include "TracyUtils.hpp"
+
+#include "../core/Device.hpp"
+#include "../core/PhysicalDevice.hpp"
+#include "HostAllocator.hpp"
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+
+namespace VulkanEngine::RAII::Utils {
+
+std::unique_ptr<TracyGpuContext> TracyGpuContext::Create(const Device& device, VkQueue queue, uint32_t queue_family, std::string_view name)
+{
+    if constexpr (!TRACY_ENABLED) {
+        return nullptr;
+    }
+    return std::unique_ptr<TracyGpuContext>(new TracyGpuContext(device, queue, queue_family, name));
+}
+
+#ifdef VULKAN_RAII_TRACY
+
+TracyGpuContext::TracyGpuContext(const Device& device, VkQueue queue, uint32_t queue_family, std::string_view name)
+    : device_(device.GetHandle())
+{
+    VkCommandPoolCreateInfo pool_info{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+    pool_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    pool_info.queueFamilyIndex = queue_family;
+    if (vkCreateCommandPool(device_, &pool_info, HostAllocator::For(VK_OBJECT_TYPE_COMMAND_POOL), &commandPool_) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create the Tracy calibration command pool");
+    }
+
+    VkCommandBufferAllocateInfo alloc_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+    alloc_info.commandPool = commandPool_;
+    alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    alloc_info.commandBufferCount = 1;
+    VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+    if (vkAllocateCommandBuffers(device_, &alloc_info, &command_buffer) != VK_SUCCESS) {
+        vkDestroyCommandPool(device_, commandPool_, HostAllocator::For(VK_OBJECT_TYPE_COMMAND_POOL));
+        throw std::runtime_error("Failed to allocate the Tracy calibration command buffer");
+    }
+
+    // Null calibration entry points (extension not enabled) fall back to uncalibrated timestamps
+    const bool calibrated = device.IsExtensionEnabled(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME);
+    context_ = TracyVkContextCalibrated(device.GetPhysicalDevice().GetHandle(), device_, queue, command_buffer,
+                                        calibrated ? vkGetPhysicalDeviceCalibrateableTimeDomainsEXT : nullptr,
+                                        calibrated ? vkGetCalibratedTimestampsEXT : nullptr);
+    if (!name.empty()) {
+        TracyVkContextName(context_, name.data(), static_cast<uint16_t>(name.size()));
+    }
+}
+
+TracyGpuContext::~TracyGpuContext() {
+    zones_.clear();
+    if (context_) {
+        TracyVkDestroy(context_);
+    }
+    if (commandPool_ != VK_NULL_HANDLE) {
+        vkDestroyCommandPool(device_, commandPool_, HostAllocator::For(VK_OBJECT_TYPE_COMMAND_POOL));
+    }
+}
+
+void TracyGpuContext::Collect(VkCommandBuffer command_buffer) const
+{
+    TracyVkCollect(context_, command_buffer);
+}
+
+void TracyGpuContext::BeginZone(VkCommandBuffer command_buffer, std::string_view name)
+{
+    static constexpr const char* SOURCE = __FILE__;
+    static constexpr const char* FUNCTION = "TracyGpuContext::BeginZone";
+    zones_.push_back(std::make_unique<tracy::VkCtxScope>(context_, static_cast<uint32_t>(__LINE__),
+                                                         SOURCE, std::strlen(SOURCE),
+                                                         FUNCTION, std::strlen(FUNCTION),
+                                                         name.data(), name.size(),
+                                                         command_buffer, true));
+}
+
+void TracyGpuContext::EndZone()
+{
+    // The scope writes its end timestamp into the command buffer it began in
+    if (!zones_.empty()) {
+        zones_.pop_back();
+    }
+}
+
+bool TracyGpuContext::HasOpenZone() const
+{
+    return !zones_.empty();
+}
+
+#else
+
+TracyGpuContext::TracyGpuContext(const Device&, VkQueue, uint32_t, std::string_view) {}
+
+TracyGpuContext::~TracyGpuContext() = default;
+
+void TracyGpuContext::Collect(VkCommandBuffer) const {}
+
+void TracyGpuContext::BeginZone(VkCommandBuffer, std::string_view) {}
+
+void TracyGpuContext::EndZone() {}
+
+bool TracyGpuContext::HasOpenZone() const
+{
+    return false;
+}
+
+#endif
+
+} // namespace VulkanEngine::RAII::Utils
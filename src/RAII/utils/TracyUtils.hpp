@@ -0,0 +1,82 @@
+#ifndef VULKAN_RAII_UTILS_TRACY_UTILS_HPP
+#define VULKAN_RAII_UTILS_TRACY_UTILS_HPP
+
+#include <volk.h>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Tracy instrumentation of the RAII layer, enabled with the VULKAN_RAII_ENABLE_TRACY
+// CMake option (which defines VULKAN_RAII_TRACY). Without it every macro expands to
+// nothing and TracyGpuContext::Create returns null.
+#ifdef VULKAN_RAII_TRACY
+#include <tracy/Tracy.hpp>
+#include <tracy/TracyVulkan.hpp>
+
+#define VULKAN_RAII_TRACY_ZONE(name) ZoneScopedN(name)
+#define VULKAN_RAII_TRACY_FUNCTION() ZoneScoped
+#define VULKAN_RAII_TRACY_FRAME_MARK() FrameMark
+#define VULKAN_RAII_TRACY_ALLOC(pointer, size, pool) TracyAllocN(pointer, size, pool)
+#define VULKAN_RAII_TRACY_FREE(pointer, pool) TracyFreeN(pointer, pool)
+#else
+#define VULKAN_RAII_TRACY_ZONE(name) static_cast<void>(0)
+#define VULKAN_RAII_TRACY_FUNCTION() static_cast<void>(0)
+#define VULKAN_RAII_TRACY_FRAME_MARK() static_cast<void>(0)
+#define VULKAN_RAII_TRACY_ALLOC(pointer, size, pool) static_cast<void>(0)
+#define VULKAN_RAII_TRACY_FREE(pointer, pool) static_cast<void>(0)
+#endif
+
+namespace VulkanEngine::RAII {
+
+class Device; // Forward declaration
+
+namespace Utils {
+
+#ifdef VULKAN_RAII_TRACY
+inline constexpr bool TRACY_ENABLED = true;
+#else
+inline constexpr bool TRACY_ENABLED = false;
+#endif
+
+// Tracy Vulkan GPU context for one queue. Zones are timestamp pairs written into the
+// command buffer they begin in, and end in that same command buffer; Collect must be
+// recorded into a command buffer submitted to the queue once per frame to reset and
+// read back the queries. Uses VK_EXT_calibrated_timestamps when the device has it.
+class TracyGpuContext {
+public:
+    // Null unless Tracy is compiled in
+    static std::unique_ptr<TracyGpuContext> Create(const Device& device, VkQueue queue, uint32_t queue_family, std::string_view name);
+
+    // Destructor
+    ~TracyGpuContext();
+
+    // Delete copy and move. open zones reference the Tracy context owned here.
+    TracyGpuContext(const TracyGpuContext&) = delete;
+    TracyGpuContext& operator=(const TracyGpuContext&) = delete;
+    TracyGpuContext(TracyGpuContext&&) = delete;
+    TracyGpuContext& operator=(TracyGpuContext&&) = delete;
+
+    void Collect(VkCommandBuffer command_buffer) const;
+
+    // Zones nest; EndZone closes the innermost one and does nothing when none is open
+    void BeginZone(VkCommandBuffer command_buffer, std::string_view name);
+    void EndZone();
+    [[nodiscard]] bool HasOpenZone() const;
+
+private:
+    TracyGpuContext(const Device& device, VkQueue queue, uint32_t queue_family, std::string_view name);
+
+#ifdef VULKAN_RAII_TRACY
+    VkDevice device_{VK_NULL_HANDLE};
+    VkCommandPool commandPool_{VK_NULL_HANDLE}; // Holds the calibration command buffer
+    TracyVkCtx context_{nullptr};
+    std::vector<std::unique_ptr<tracy::VkCtxScope>> zones_;
+#endif
+};
+
+} // namespace Utils
+
+} // namespace VulkanEngine::RAII
+
+#endif // VULKAN_RAII_UTILS_TRACY_UTILS_HPP
@@ -0,0 +1,70 @@
+#include <catch2/catch_test_macros.hpp>
+#include "utils/FrameStats.hpp"
+#include <cmath>
+#include <cstdint>
+
+using namespace VulkanEngine::RAII::Utils;
+
+TEST_CASE("FrameStats reports nearest-rank percentiles") {
+    FrameStats stats(100);
+    REQUIRE(stats.GetSummary().count == 0);
+
+    // Out of order, so the summary has to sort
+    for (uint32_t i = 0; i < 100; ++i) {
+        stats.Add(static_cast<double>((i * 37) % 100 + 1));
+    }
+    const FrameStats::Summary summary = stats.GetSummary();
+    REQUIRE(summary.count == 100);
+    REQUIRE(summary.minMs == 1.0);
+    REQUIRE(summary.maxMs == 100.0);
+    REQUIRE(summary.averageMs == 50.5);
+    REQUIRE(summary.p50Ms == 50.0);
+    REQUIRE(summary.p95Ms == 95.0);
+    REQUIRE(summary.p99Ms == 99.0);
+    REQUIRE(summary.low1PercentFps == 10.0); // Slowest frame alone: 100 ms
+}
+
+TEST_CASE("FrameStats percentiles of a partial window") {
+    FrameStats stats(120);
+    stats.Add(4.0);
+    stats.Add(2.0);
+    stats.Add(8.0);
+    const FrameStats::Summary summary = stats.GetSummary();
+    REQUIRE(summary.count == 3);
+    REQUIRE(summary.p50Ms == 4.0);
+    REQUIRE(summary.p95Ms == 8.0);
+    REQUIRE(summary.p99Ms == 8.0);
+    REQUIRE(stats.GetLastMs() == 8.0);
+}
+
+TEST_CASE("FrameStats drops the oldest frame once the window is full") {
+    FrameStats stats(4);
+    for (double ms : {100.0, 1.0, 2.0, 3.0, 4.0}) {
+        stats.Add(ms);
+    }
+    REQUIRE(stats.GetCount() == 4);
+    REQUIRE(stats.GetAverageMs() == 2.5);
+    REQUIRE(stats.GetSummary().maxMs == 4.0);
+
+    uint32_t histogram_total = 0;
+    for (uint32_t frames : stats.GetHistogram()) {
+        histogram_total += frames;
+    }
+    REQUIRE(histogram_total == 4);
+    REQUIRE(stats.GetHistogram()[FrameStats::GetBucket(100.0)] == 0);
+
+    stats.Reset();
+    REQUIRE(stats.GetCount() == 0);
+    REQUIRE(stats.GetSummary().count == 0);
+}
+
+TEST_CASE("FrameStats histogram buckets double from 0.25 ms") {
+    REQUIRE(FrameStats::GetBucket(0.1) == 0);
+    REQUIRE(FrameStats::GetBucket(0.25) == 1);
+    REQUIRE(FrameStats::GetBucket(0.49) == 1);
+    REQUIRE(FrameStats::GetBucket(0.5) == 2);
+    REQUIRE(FrameStats::GetBucket(1.0e9) == FrameStats::HISTOGRAM_BUCKETS - 1);
+    REQUIRE(FrameStats::GetBucketUpperMs(0) == 0.25);
+    REQUIRE(FrameStats::GetBucketUpperMs(2) == 1.0);
+    REQUIRE(std::isinf(FrameStats::GetBucketUpperMs(FrameStats::HISTOGRAM_BUCKETS - 1)));
+}
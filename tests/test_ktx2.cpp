@@ -0,0 +1,98 @@
+#include <catch2/catch_test_macros.hpp>
+#include "resources/Ktx2File.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace VulkanEngine::RAII;
+
+namespace {
+
+constexpr size_t HEADER_SIZE = 80;
+constexpr size_t LEVEL_ENTRY_SIZE = 24;
+
+template <typename T>
+void Write(std::vector<std::byte>& bytes, size_t offset, T value) {
+    std::memcpy(bytes.data() + offset, &value, sizeof(T));
+}
+
+// 4x4 RGBA8 image with one level of 64 bytes right after the level index
+std::vector<std::byte> MakeFile() {
+    std::vector<std::byte> bytes(HEADER_SIZE + LEVEL_ENTRY_SIZE + 64);
+    const uint8_t identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+    std::memcpy(bytes.data(), identifier, sizeof(identifier));
+    Write<uint32_t>(bytes, 12, 37); // VK_FORMAT_R8G8B8A8_UNORM
+    Write<uint32_t>(bytes, 16, 1);  // typeSize
+    Write<uint32_t>(bytes, 20, 4);  // width
+    Write<uint32_t>(bytes, 24, 4);  // height
+    Write<uint32_t>(bytes, 36, 1);  // faceCount
+    Write<uint32_t>(bytes, 40, 1);  // levelCount
+    Write<uint64_t>(bytes, HEADER_SIZE, HEADER_SIZE + LEVEL_ENTRY_SIZE);
+    Write<uint64_t>(bytes, HEADER_SIZE + 8, 64);
+    Write<uint64_t>(bytes, HEADER_SIZE + 16, 64);
+    return bytes;
+}
+
+std::string WriteTemp(const std::vector<std::byte>& bytes, const char* name) {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return path.string();
+}
+
+} // namespace
+
+TEST_CASE("Ktx2File parses a valid header") {
+    const std::string path = WriteTemp(MakeFile(), "ktx2_valid.ktx2");
+    Ktx2File file(path);
+    REQUIRE(file.GetWidth() == 4);
+    REQUIRE(file.GetHeight() == 4);
+    REQUIRE(file.GetDepth() == 1);
+    REQUIRE(file.GetLevelCount() == 1);
+    REQUIRE(file.GetLevelData(0).size() == 64);
+    REQUIRE(file.GetSupercompressionGlobalData().empty());
+}
+
+TEST_CASE("Ktx2File rejects truncated headers") {
+    std::vector<std::byte> bytes = MakeFile();
+    bytes.resize(HEADER_SIZE - 1);
+    REQUIRE_THROWS_AS(Ktx2File(WriteTemp(bytes, "ktx2_short.ktx2")), std::runtime_error);
+
+    bytes = MakeFile();
+    bytes[0] = std::byte{0};
+    REQUIRE_THROWS_AS(Ktx2File(WriteTemp(bytes, "ktx2_identifier.ktx2")), std::runtime_error);
+}
+
+TEST_CASE("Ktx2File rejects a level index past the end of the file") {
+    std::vector<std::byte> bytes = MakeFile();
+    Write<uint32_t>(bytes, 40, 8);
+    REQUIRE_THROWS_AS(Ktx2File(WriteTemp(bytes, "ktx2_levels.ktx2")), std::runtime_error);
+
+    Write<uint32_t>(bytes, 40, std::numeric_limits<uint32_t>::max());
+    REQUIRE_THROWS_AS(Ktx2File(WriteTemp(bytes, "ktx2_level_count.ktx2")), std::runtime_error);
+}
+
+TEST_CASE("Ktx2File rejects level ranges that overflow") {
+    std::vector<std::byte> bytes = MakeFile();
+    Write<uint64_t>(bytes, HEADER_SIZE + 8, 65);
+    REQUIRE_THROWS_AS(Ktx2File(WriteTemp(bytes, "ktx2_level_long.ktx2")), std::runtime_error);
+
+    // offset + length wraps around to a small value
+    bytes = MakeFile();
+    Write<uint64_t>(bytes, HEADER_SIZE, std::numeric_limits<uint64_t>::max() - 7);
+    Write<uint64_t>(bytes, HEADER_SIZE + 8, 16);
+    REQUIRE_THROWS_AS(Ktx2File(WriteTemp(bytes, "ktx2_level_wrap.ktx2")), std::runtime_error);
+}
+
+TEST_CASE("Ktx2File rejects supercompression data that overflows") {
+    std::vector<std::byte> bytes = MakeFile();
+    Write<uint64_t>(bytes, 64, 8);
+    Write<uint64_t>(bytes, 72, std::numeric_limits<uint64_t>::max());
+    REQUIRE_THROWS_AS(Ktx2File(WriteTemp(bytes, "ktx2_sgd_wrap.ktx2")), std::runtime_error);
+}
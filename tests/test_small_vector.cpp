@@ -0,0 +1,87 @@
+#include <catch2/catch_test_macros.hpp>
+#include "utils/SmallVector.hpp"
+#include <cstdint>
+#include <utility>
+
+using namespace VulkanEngine::RAII::Utils;
+
+namespace {
+
+SmallVector<uint32_t, 4> MakeSequence(uint32_t count) {
+    SmallVector<uint32_t, 4> values;
+    for (uint32_t i = 0; i < count; ++i) {
+        values.push_back(i);
+    }
+    return values;
+}
+
+bool IsSequence(const SmallVector<uint32_t, 4>& values, uint32_t count) {
+    if (values.size() != count) {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        if (values[i] != i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE("SmallVector keeps elements across the inline boundary") {
+    SmallVector<uint32_t, 4> values;
+    REQUIRE(values.empty());
+
+    values = MakeSequence(4);
+    const uint32_t* inline_data = values.data();
+    REQUIRE(IsSequence(values, 4));
+
+    values.push_back(4);
+    REQUIRE(IsSequence(values, 5));
+    REQUIRE(values.data() != inline_data);
+
+    values.resize(8);
+    REQUIRE(values.size() == 8);
+    REQUIRE(values[7] == 0);
+    REQUIRE(values.end() - values.begin() == 8);
+    REQUIRE(values.AsSpan().size() == 8);
+}
+
+TEST_CASE("SmallVector shrinks back into inline storage") {
+    SmallVector<uint32_t, 4> values = MakeSequence(6);
+    values.resize(3);
+    REQUIRE(IsSequence(values, 3));
+
+    // Regrowing within N value-initializes the reused slots
+    values.resize(4);
+    REQUIRE(values[3] == 0);
+
+    values = MakeSequence(6);
+    values.clear();
+    REQUIRE(values.empty());
+    values.push_back(7);
+    REQUIRE(values.size() == 1);
+    REQUIRE(values[0] == 7);
+}
+
+TEST_CASE("SmallVector moves leave the source empty") {
+    SmallVector<uint32_t, 4> inline_source = MakeSequence(3);
+    SmallVector<uint32_t, 4> inline_moved(std::move(inline_source));
+    REQUIRE(IsSequence(inline_moved, 3));
+    REQUIRE(inline_source.empty());
+
+    SmallVector<uint32_t, 4> heap_source = MakeSequence(9);
+    SmallVector<uint32_t, 4> heap_moved;
+    heap_moved = std::move(heap_source);
+    REQUIRE(IsSequence(heap_moved, 9));
+    REQUIRE(heap_source.empty());
+
+    // The moved-from vector is usable again
+    heap_source.push_back(0);
+    REQUIRE(IsSequence(heap_source, 1));
+
+    const SmallVector<uint32_t, 4> copy = heap_moved;
+    REQUIRE(IsSequence(copy, 9));
+    REQUIRE(IsSequence(heap_moved, 9));
+}
@@ -0,0 +1,102 @@
+#include <catch2/catch_test_macros.hpp>
+#include "utils/SpirvUtils.hpp"
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+using namespace VulkanEngine::RAII::Utils;
+
+namespace {
+
+constexpr uint32_t Op(uint32_t opcode, uint32_t length) {
+    return (length << 16) | opcode;
+}
+
+// Hand-assembled compute shader, equivalent to:
+//   layout(local_size_x = 8, local_size_y = 4) in;
+//   layout(set = 0, binding = 0) uniform Params { vec4 color; };
+//   layout(set = 0, binding = 1) uniform sampler2D tex[];
+//   layout(push_constant) uniform Push { uint index; };
+const std::vector<uint32_t> COMPUTE_SHADER = {
+    0x07230203, 0x00010300, 0, 19, 0,
+    Op(17, 2), 1,                                  // OpCapability Shader
+    Op(14, 3), 0, 1,                               // OpMemoryModel Logical GLSL450
+    Op(15, 5), 5, 1, 0x6E69616D, 0,                // OpEntryPoint GLCompute %1 "main"
+    Op(16, 6), 1, 17, 8, 4, 1,                     // OpExecutionMode %1 LocalSize 8 4 1
+    Op(5, 3), 10, 0x00786574,                      // OpName %10 "tex"
+    Op(71, 4), 10, 34, 0,                          // OpDecorate %10 DescriptorSet 0
+    Op(71, 4), 10, 33, 1,                          // OpDecorate %10 Binding 1
+    Op(71, 3), 13, 2,                              // OpDecorate %13 Block
+    Op(72, 5), 13, 0, 35, 0,                       // OpMemberDecorate %13 0 Offset 0
+    Op(71, 4), 12, 34, 0,                          // OpDecorate %12 DescriptorSet 0
+    Op(71, 4), 12, 33, 0,                          // OpDecorate %12 Binding 0
+    Op(71, 3), 15, 2,                              // OpDecorate %15 Block
+    Op(72, 5), 15, 0, 35, 0,                       // OpMemberDecorate %15 0 Offset 0
+    Op(22, 3), 3, 32,                              // %3 = OpTypeFloat 32
+    Op(23, 4), 4, 3, 4,                            // %4 = OpTypeVector %3 4
+    Op(25, 9), 5, 3, 1, 0, 0, 0, 1, 0,             // %5 = OpTypeImage %3 2D sampled
+    Op(27, 3), 6, 5,                               // %6 = OpTypeSampledImage %5
+    Op(29, 3), 7, 6,                               // %7 = OpTypeRuntimeArray %6
+    Op(32, 4), 8, 0, 7,                            // %8 = OpTypePointer UniformConstant %7
+    Op(59, 4), 8, 10, 0,                           // %10 = OpVariable %8 UniformConstant
+    Op(30, 3), 13, 4,                              // %13 = OpTypeStruct %4
+    Op(32, 4), 14, 2, 13,                          // %14 = OpTypePointer Uniform %13
+    Op(59, 4), 14, 12, 2,                          // %12 = OpVariable %14 Uniform
+    Op(21, 4), 16, 32, 0,                          // %16 = OpTypeInt 32 0
+    Op(30, 3), 15, 16,                             // %15 = OpTypeStruct %16
+    Op(32, 4), 17, 9, 15,                          // %17 = OpTypePointer PushConstant %15
+    Op(59, 4), 17, 18, 9,                          // %18 = OpVariable %17 PushConstant
+};
+
+} // namespace
+
+TEST_CASE("SpirvUtils reflects a compute shader") {
+    const SpirvReflection reflection = SpirvUtils::Reflect(COMPUTE_SHADER);
+    REQUIRE(reflection.stage == VK_SHADER_STAGE_COMPUTE_BIT);
+    REQUIRE(reflection.entryPoint == "main");
+    REQUIRE(reflection.workgroupSize[0] == 8);
+    REQUIRE(reflection.workgroupSize[1] == 4);
+    REQUIRE(reflection.workgroupSize[2] == 1);
+
+    REQUIRE(reflection.descriptorBindings.size() == 2);
+    const SpirvReflection::DescriptorBinding& params = reflection.descriptorBindings[0];
+    REQUIRE(params.layoutBinding.binding == 0);
+    REQUIRE(params.layoutBinding.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+    REQUIRE(params.layoutBinding.descriptorCount == 1);
+    REQUIRE_FALSE(params.IsRuntimeArray());
+
+    REQUIRE(reflection.pushConstantRanges.size() == 1);
+    REQUIRE(reflection.pushConstantRanges[0].offset == 0);
+    REQUIRE(reflection.pushConstantRanges[0].size == 4);
+}
+
+TEST_CASE("SpirvUtils sizes runtime arrays to the requested count") {
+    const SpirvReflection reflection = SpirvUtils::Reflect(COMPUTE_SHADER, 256);
+    const SpirvReflection::DescriptorBinding& textures = reflection.descriptorBindings[1];
+    REQUIRE(textures.name == "tex");
+    REQUIRE(textures.layoutBinding.binding == 1);
+    REQUIRE(textures.layoutBinding.descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+    REQUIRE(textures.layoutBinding.descriptorCount == 256);
+    REQUIRE(textures.IsRuntimeArray());
+    REQUIRE(textures.bindingFlags == (VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT));
+
+    REQUIRE(SpirvUtils::Reflect(COMPUTE_SHADER).descriptorBindings[1].layoutBinding.descriptorCount ==
+            SpirvUtils::DEFAULT_RUNTIME_ARRAY_COUNT);
+    REQUIRE_THROWS_AS(SpirvUtils::Reflect(COMPUTE_SHADER, 0), std::invalid_argument);
+}
+
+TEST_CASE("SpirvUtils rejects malformed code") {
+    std::vector<uint32_t> code = COMPUTE_SHADER;
+    code[0] = 0;
+    REQUIRE_THROWS_AS(SpirvUtils::Reflect(code), std::invalid_argument);
+
+    // Last instruction claims more words than the module has
+    code = COMPUTE_SHADER;
+    code[code.size() - 4] = Op(59, 5);
+    REQUIRE_THROWS_AS(SpirvUtils::Reflect(code), std::invalid_argument);
+
+    // Ids past the declared bound
+    code = COMPUTE_SHADER;
+    code[3] = 10;
+    REQUIRE_THROWS_AS(SpirvUtils::Reflect(code), std::invalid_argument);
+}